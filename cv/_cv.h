@@ -116,6 +116,35 @@ typedef struct CvPyramid
     int level;
 } CvPyramid;
 
+/* a stump (single-node classifier) of a Haar cascade scaled for the built-in
+   evaluator. p[k] are the offsets of the corners of the rectangle k from the
+   window origin in the integral image (the tilted one if tilted != 0); the
+   unused third rectangle has zero weight and offsets */
+typedef struct CvHaarStump
+{
+    int p[3][4];
+    float weight[3];
+    float threshold;
+    float alpha[2];
+    int tilted;
+} CvHaarStump;
+
+typedef struct CvHaarStumpStage
+{
+    int first; /* index of the first stump of the stage */
+    int count;
+    int rects; /* 3 if any stump of the stage has the third rectangle */
+    float threshold;
+} CvHaarStumpStage;
+
+typedef struct CvHaarStumpCascade
+{
+    const int* sum;
+    const int* tilted;
+    const CvHaarStump* stumps;
+    const CvHaarStumpStage* stages;
+} CvHaarStumpCascade;
+
 #include "_cvipp.h"
 #include "_cvmatrix.h"
 #include "_cvgeom.h"
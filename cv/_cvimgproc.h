@@ -117,6 +117,36 @@ extern float icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE + 1) * 2];
 
 void icvInitCubicCoeffTab();
 
+/* the fractional bits of the horizontal weights of the filtered 8-bit
+   resize (CV_INTER_LANCZOS3, CV_INTER_MITCHELL) */
+#define ICV_RESIZE_FILTER_BITS 14
+
+/* the resize of cvResize, prepared once for the given sizes and type and
+   then run on the bands of destination rows; icvResizeSourceRows tells which
+   source rows a band reads, and icvResizeRows gets just those rows, the
+   first of which is src_y0 */
+struct CvResizeState;
+
+CvResizeState* icvCreateResizeState(CvSize ssize, CvSize dsize, int type,
+                                    int srcstep, int method);
+void icvReleaseResizeState(CvResizeState** state);
+CvSlice icvResizeSourceRows(const CvResizeState* state, CvSlice rows);
+CvStatus icvResizeRows(CvResizeState* state, const uchar* src, int srcstep,
+                       int src_y0, uchar* dst, int dststep, CvSlice rows);
+
+/* The fixed-point maps of cvConvertMaps keep ICV_REMAP_BITS fractional bits
+   of each coordinate; the bilinear weights of the 8-bit remap are the exact
+   products of the fractions, scaled by 2^ICV_REMAP_COEF_BITS */
+#define ICV_REMAP_BITS 5
+#define ICV_REMAP_TAB_SIZE (1 << ICV_REMAP_BITS)
+#define ICV_REMAP_MASK (ICV_REMAP_TAB_SIZE - 1)
+#define ICV_REMAP_COEF_BITS (ICV_REMAP_BITS * 2)
+
+/* converts a row of floating-point maps to the fixed-point form; the
+   coordinates are rounded to the nearest pixel when mapalpha is 0 */
+void icvConvertMapsRow(const float* mapx, const float* mapy, short* mapxy,
+                       ushort* mapalpha, int width);
+
 CvStatus CV_STDCALL icvGetRectSubPix_8u_C1R(const uchar* src, int src_step,
                                             CvSize src_size, uchar* dst,
                                             int dst_step, CvSize win_size,
@@ -216,6 +216,38 @@ ICV_PYRUP(32f, 3)
 #undef ICV_PYRDOWN
 #undef ICV_PYRUP
 
+/* the interior passes of the built-in 5x5 gaussian pyramid. The row passes
+   of PyrDown compute dst[x] = [1 4 6 4 1]*src[2x-2..2x+2] and those of PyrUp
+   dst[2x] = [1 6 1]*src[x-1..x+1], dst[2x+1] = [4 4]*src[x..x+1], x < len.
+   The column passes take the buffer rows (5 for PyrDown, 3 for PyrUp) and
+   write the scaled sums of any number of channels; PyrUp writes two
+   destination rows. There are only built-in versions of these */
+#define ICV_PYRROW(name, srctype, worktype)                                \
+    IPCVAPI_EX(CvStatus, name, #name, 0,                                   \
+               (const srctype* src, worktype* dst, int len))
+
+#define ICV_PYRDOWNCOL(name, worktype, dsttype)                            \
+    IPCVAPI_EX(CvStatus, name, #name, 0,                                   \
+               (const worktype** rows, dsttype* dst, int len))
+
+#define ICV_PYRUPCOL(name, worktype, dsttype)                              \
+    IPCVAPI_EX(CvStatus, name, #name, 0,                                   \
+               (const worktype** rows, dsttype* dst0, dsttype* dst1, int len))
+
+ICV_PYRROW(icvPyrDownRow_8u32s_C1R, uchar, int)
+ICV_PYRROW(icvPyrDownRow_32f_C1R, float, float)
+ICV_PYRDOWNCOL(icvPyrDownCol_32s8u, int, uchar)
+ICV_PYRDOWNCOL(icvPyrDownCol_32f, float, float)
+
+ICV_PYRROW(icvPyrUpRow_8u32s_C1R, uchar, int)
+ICV_PYRROW(icvPyrUpRow_32f_C1R, float, float)
+ICV_PYRUPCOL(icvPyrUpCol_32s8u, int, uchar)
+ICV_PYRUPCOL(icvPyrUpCol_32f, float, float)
+
+#undef ICV_PYRROW
+#undef ICV_PYRDOWNCOL
+#undef ICV_PYRUPCOL
+
 /****************************************************************************************\
 *                                Geometric Transformations *
 \****************************************************************************************/
@@ -242,6 +274,52 @@ IPCV_RESIZE(32f, 4)
 
 #undef IPCV_RESIZE
 
+/* the vertical pass of the bilinear resize of a band of rows, as
+   ICV_DEF_RESIZE_BILINEAR_FUNC in cvimgwarp.cpp does it; there are only
+   built-in versions of these */
+IPCVAPI_EX(CvStatus, icvResizeBilinearVLine_8u_C1R,
+           "icvResizeBilinearVLine_8u_C1R", 0,
+           (const int* buf0, const int* buf1, int fy, uchar* dst, int width))
+
+IPCVAPI_EX(CvStatus, icvResizeBilinearVLine_32f_C1R,
+           "icvResizeBilinearVLine_32f_C1R", 0,
+           (const float* buf0, const float* buf1, float fy, float* dst,
+            int width))
+
+/* the row functions of the filtered resize (CV_INTER_LANCZOS3,
+   CV_INTER_MITCHELL); there are only built-in versions of them */
+#define IPCV_RESIZE_FILTER_HLINE(flavor, cn)                       \
+    IPCVAPI_EX(CvStatus, icvResizeFilterHLine_##flavor##_C##cn##R, \
+               "icvResizeFilterHLine_" #flavor "_C" #cn "R", 0,    \
+               (const void* src, float* dst, int width, int xmax,  \
+                const int* xofs, const void* alpha, int ksize,     \
+                int channels))
+
+#define IPCV_RESIZE_FILTER_VLINE(flavor)                                    \
+    IPCVAPI_EX(CvStatus, icvResizeFilterVLine_##flavor##_C1R,               \
+               "icvResizeFilterVLine_" #flavor "_C1R", 0,                   \
+               (const float** src, const float* beta, int ksize, void* dst, \
+                int width))
+
+IPCV_RESIZE_FILTER_HLINE(8u, 1)
+IPCV_RESIZE_FILTER_HLINE(8u, 3)
+IPCV_RESIZE_FILTER_HLINE(8u, 4)
+
+IPCV_RESIZE_FILTER_HLINE(16u, 1)
+IPCV_RESIZE_FILTER_HLINE(16u, 3)
+IPCV_RESIZE_FILTER_HLINE(16u, 4)
+
+IPCV_RESIZE_FILTER_HLINE(32f, 1)
+IPCV_RESIZE_FILTER_HLINE(32f, 3)
+IPCV_RESIZE_FILTER_HLINE(32f, 4)
+
+IPCV_RESIZE_FILTER_VLINE(8u)
+IPCV_RESIZE_FILTER_VLINE(16u)
+IPCV_RESIZE_FILTER_VLINE(32f)
+
+#undef IPCV_RESIZE_FILTER_HLINE
+#undef IPCV_RESIZE_FILTER_VLINE
+
 #define IPCV_WARPAFFINE_BACK(flavor, cn)                                     \
     IPCVAPI_EX(CvStatus, icvWarpAffineBack_##flavor##_C##cn##R,              \
                "ippiWarpAffineBack_" #flavor "_C" #cn "R",                   \
@@ -314,6 +392,25 @@ IPCV_REMAP(32f, 4)
 
 #undef IPCV_REMAP
 
+/* a row of cvRemap with the fixed-point maps of cvConvertMaps; there are no
+   IPP counterparts, only the built-in SIMD versions (cvsimd.cpp) */
+#define IPCV_REMAP_FIXED(flavor, cn)                                   \
+    IPCVAPI_EX(CvStatus, icvRemapFixed_##flavor##_C##cn##R,            \
+               "icvRemapFixed_" #flavor "_C" #cn "R", 0,               \
+               (const void* src, int srcstep, CvSize ssize, void* dst, \
+                const short* mapxy, const ushort* mapalpha, int width, \
+                int channels, const void* fillval))
+
+IPCV_REMAP_FIXED(8u, 1)
+IPCV_REMAP_FIXED(8u, 3)
+IPCV_REMAP_FIXED(8u, 4)
+
+IPCV_REMAP_FIXED(32f, 1)
+IPCV_REMAP_FIXED(32f, 3)
+IPCV_REMAP_FIXED(32f, 4)
+
+#undef IPCV_REMAP_FIXED
+
 /****************************************************************************************\
 *                                      Morphology *
 \****************************************************************************************/
@@ -401,6 +498,25 @@ IPCV_FILTER_BOX(32f, 4)
 
 #undef IPCV_FILTER_BOX
 
+/* one step of the recursive gaussian along n independent lines: for both
+   parts k of the kernel y = c[k*2]*xa + c[k*2+1]*xb - a[k*2]*y1 - a[k*2+1]*y2,
+   where state holds the previous rows y1 and y2 of the parts (4 rows of n
+   floats: y1 and y2 of the first part, then of the second one) and is
+   shifted by the step; the sum of the parts is stored to dst or added to it */
+IPCVAPI_EX(CvStatus, icvRecursiveGaussianStep_32f,
+           "icvRecursiveGaussianStep_32f", 0,
+           (const float* xa, const float* xb, const float* c, const float* a,
+            float* state, float* dst, int n, int add))
+
+/* the 8u rows of the recursive gaussian to 32f and back, rounded and
+   saturated as cvRound and CV_CAST_8U do */
+IPCVAPI_EX(CvStatus, icvRecursiveGaussianLoad_8u32f,
+           "icvRecursiveGaussianLoad_8u32f", 0,
+           (const uchar* src, float* dst, int len))
+IPCVAPI_EX(CvStatus, icvRecursiveGaussianStore_32f8u,
+           "icvRecursiveGaussianStore_32f8u", 0,
+           (const float* src, uchar* dst, int len))
+
 /****************************************************************************************\
 *                                 Derivative Filters *
 \****************************************************************************************/
@@ -553,6 +669,19 @@ IPCV_FILTER(Row_32f, Row_32f, 4, int, int)
 
 #undef IPCV_FILTER
 
+/* the fixed-point passes of CvSepFilter for the symmetrical kernels of the
+   8u->8u filters; kx and ky point to the central tap, the sums are scaled
+   by 2^16. There are only built-in versions of these */
+IPCVAPI_EX(CvStatus, icvFilterRowSymm_8u32s_C1R, "icvFilterRowSymm_8u32s_C1R",
+           0,
+           (const uchar* src, int* dst, int width, int cn, const int* kx,
+            int ksize2))
+
+IPCVAPI_EX(CvStatus, icvFilterColSymm_32s8u_C1R, "icvFilterColSymm_32s8u_C1R",
+           0,
+           (const int** src, uchar* dst, int dststep, int count, int width,
+            const int* ky, int ksize2))
+
 /****************************************************************************************\
 *                                  Color Transformations *
 \****************************************************************************************/
@@ -588,6 +717,11 @@ IPCV_COLOR(RGB2Luv, RGBToLUV, 8u)
 IPCV_COLOR(Luv2RGB, LUVToRGB, 8u)
 /*IPCV_COLOR( Luv2RGB, LUVToRGB, 32f )*/
 
+/* there is no IPP counterpart, only the built-in SIMD version (cvsimd.cpp) */
+IPCVAPI_EX(CvStatus, icvBGRx2Gray_8u_CnC1R, "icvBGRx2Gray_8u_CnC1R", 0,
+           (const uchar* src, int srcstep, uchar* dst, int dststep,
+            CvSize size, int src_cn, int blue_idx))
+
 /****************************************************************************************\
 *                                  Motion Templates *
 \****************************************************************************************/
@@ -624,6 +758,13 @@ IPCVAPI_EX(CvStatus, icvUpdateMotionHistory_8u32f_C1IR,
 ICV_MATCHTEMPLATE(8u32f, uchar)
 ICV_MATCHTEMPLATE(32f, float)
 
+/* the correlation of a template row with the image row at len positions:
+   dst[x] = sum(templ[j]*src[x+j]); there is no IPP counterpart, only the
+   built-in SIMD version (cvsimd.cpp) */
+IPCVAPI_EX(CvStatus, icvCrossCorrRow_32f_C1R, "icvCrossCorrRow_32f_C1R", 0,
+           (const float* src, const float* templ, int templ_len, float* dst,
+            int len))
+
 /****************************************************************************************/
 /*                                Distance Transform */
 /****************************************************************************************/
@@ -746,6 +887,23 @@ IPCVAPI_EX(CvStatus, icvOpticalFlowPyrLK_8u_C1R, "ippiOpticalFlowPyrLK_8u_C1R",
             float* pNext, char* pStatus, float* pError, int numFeat,
             int winSize, int maxLev, int maxIter, float threshold, void* state))
 
+/****************************************************************************************\
+*                                  DIS Optical Flow *
+\****************************************************************************************/
+
+/* the sums of d, d^2, Ix*d and Iy*d over the 8x8 patch, where d is the
+   difference of the bilinearly warped src and prev */
+IPCVAPI_EX(CvStatus, icvDISPatch_32f_C1R, "icvDISPatch_32f_C1R", 0,
+           (const float* src, int srcstep, const float* prev, int prevstep,
+            const float* gx, const float* gy, int gradstep, const float* w,
+            float* sums))
+
+/* accumulates the weighted flow of the 8-pixel wide patch rows */
+IPCVAPI_EX(CvStatus, icvDISDensify_32f_C1R, "icvDISDensify_32f_C1R", 0,
+           (const float* src, int srcstep, const float* prev, int prevstep,
+            const float* w, float u, float v, float* wsum, float* usum,
+            float* vsum, int accstep, int rows))
+
 /****************************************************************************************\
 *                                 Haar Object Detector *
 \****************************************************************************************/
@@ -780,4 +938,14 @@ IPCVAPI_EX(CvStatus, icvApplyHaarClassifier_32s32f_C1R,
             uchar* pMask, int maskStep, CvSize roi, int* pPositive,
             float threshold, void* pState))
 
+/* runs the stages [start_stage,end_stage) of a stump based cascade on the
+   windows at the offsets ofs[i] of the integral images, which have the
+   variance normalization factors norm[i]. result[i] is set to 1 if the window
+   passed all the stages and to -k if the stage k rejected it, as
+   cvRunHaarClassifierCascade does */
+IPCVAPI_EX(CvStatus, icvHaarStumpCascade_32s64f, "icvHaarStumpCascade_32s64f",
+           0,
+           (const CvHaarStumpCascade* cascade, int start_stage, int end_stage,
+            const int* ofs, const double* norm, int* result, int count))
+
 #endif /*_CV_IPP_H_*/
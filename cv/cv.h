@@ -85,6 +85,22 @@ extern "C"
 #define CV_GAUSSIAN 2
 #define CV_MEDIAN 3
 #define CV_BILATERAL 4
+/* Deriche recursive approximation of CV_GAUSSIAN, the cost per pixel does
+   not depend on sigma (param3 and param4). 8u, 16u, 16f and 32f, any number
+   of channels. Against the exact 32f CV_GAUSSIAN with the kernel size
+   2*ceil(4*sigma)+1 on 3840x2160 8UC3 noise (cv/tests/test-gaussian.cpp),
+   in gray levels, and the time on one core:
+
+       sigma   max diff   mean diff   exact 8u / 32f   recursive 8u / 32f
+       2       0.029      0.0043      0.09 / 0.13 s    0.23 / 0.20 s
+       5       0.016      0.0017      0.21 / 0.26 s    0.22 / 0.21 s
+       20      0.009      0.0005      1.8 / 2.1 s      0.22 / 0.21 s
+       50      0.008      0.0005      5.1 / 5.4 s      0.25 / 0.21 s
+       100     0.010      0.0013      9.3 / 10.1 s     0.19 / 0.21 s
+
+   The 8u result is within 1 level of the rounded exact one. It pays off
+   from sigma ~5 */
+#define CV_GAUSSIAN_RECURSIVE 5
 
     /* Smoothes array (removes noise) */
     CVAPI(void)
@@ -128,6 +144,35 @@ extern "C"
                                   CvMat* levels, int level_count,
                                   int filter CV_DEFAULT(CV_GAUSSIAN_5x5) );*/
 
+    /* Gaussian pyramid of an image that is built on demand and shared by
+       its consumers: level i+1 is cvPyrDown of level i, its size is
+       ((width_i+1)/2, (height_i+1)/2), and the levels go down while both
+       sides are 2 or more. The level buffers are kept between the images of
+       the same size and type and are recycled through a library-wide pool
+       otherwise. The lazy computation is not thread-safe: request the
+       deepest level needed before sharing the pyramid between threads */
+    typedef struct CvImagePyramid CvImagePyramid;
+
+    /* Creates the pyramid of at most max_levels levels, the image included;
+       0 means all the levels */
+    CVAPI(CvImagePyramid*) cvCreateImagePyramid(int max_levels CV_DEFAULT(0));
+
+    /* Starts a new image (frame). If copy is 0, level 0 refers to the image
+       data, which must stay unchanged while the pyramid is used */
+    CVAPI(void)
+    cvSetPyramidImage(CvImagePyramid* pyramid, const CvArr* image,
+                      int copy CV_DEFAULT(0));
+
+    /* Returns the number of levels of the current image */
+    CVAPI(int) cvGetPyramidLevelCount(const CvImagePyramid* pyramid);
+
+    /* Returns the level, computing it and the missing levels above it first */
+    CVAPI(const CvMat*)
+    cvGetPyramidLevel(CvImagePyramid* pyramid, int level);
+
+    /* Releases the pyramid; its buffers go back to the pool */
+    CVAPI(void) cvReleaseImagePyramid(CvImagePyramid** pyramid);
+
     /* Splits color or grayscale image into multiple connected components
        of nearly the same color/brightness using modification of Burt algorithm.
        comp with contain a pointer to sequence (CvSeq)
@@ -271,6 +316,11 @@ extern "C"
 #define CV_INTER_LINEAR 1
 #define CV_INTER_CUBIC 2
 #define CV_INTER_AREA 3
+/* Separable Lanczos (a=3) and Mitchell-Netravali (B=C=1/3) filters; their
+   support grows with the downscaling factor, so large reductions do not
+   alias. Supported by cvResize only */
+#define CV_INTER_LANCZOS3 4
+#define CV_INTER_MITCHELL 5
 
 #define CV_WARP_FILL_OUTLIERS 8
 #define CV_WARP_INVERSE_MAP 16
@@ -311,12 +361,25 @@ extern "C"
                               CvMat* map_matrix);
 
     /* Performs generic geometric transformation using the specified coordinate
-     * maps */
+     * maps. The maps are either two 32fC1 arrays or the output of
+     * cvConvertMaps: a 16sC2 mapx and a 16uC1 mapy (bilinear interpolation)
+     * or NULL (nearest neighbor) */
     CVAPI(void)
     cvRemap(const CvArr* src, CvArr* dst, const CvArr* mapx, const CvArr* mapy,
             int flags CV_DEFAULT(CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS),
             CvScalar fillval CV_DEFAULT(cvScalarAll(0)));
 
+    /* Converts the floating-point maps of cvRemap to the faster fixed-point
+     * form: integer coordinates (16sC2 mapxy) and the index of the bilinear
+     * weights (16uC1 mapalpha). The integer coordinates, and so the
+     * outliers, are the ones of the floating-point remap; the fractions are
+     * rounded to 1/32 pixel but never up to the next pixel, so they are
+     * within 1/32 pixel of the float maps. When mapalpha is NULL, the
+     * coordinates are rounded for nearest-neighbor remapping */
+    CVAPI(void)
+    cvConvertMaps(const CvArr* mapx, const CvArr* mapy, CvArr* mapxy,
+                  CvArr* mapalpha CV_DEFAULT(NULL));
+
     /* Performs forward or inverse log-polar image transform */
     CVAPI(void)
     cvLogPolar(const CvArr* src, CvArr* dst, CvPoint2D32f center, double M,
@@ -416,6 +479,19 @@ extern "C"
     cvMatchTemplate(const CvArr* image, const CvArr* templ, CvArr* result,
                     int method);
 
+    /* Searches the image for the template scaled by min_scale,
+       min_scale*scale_step, ... up to max_scale and returns the best match.
+       Only the normed methods are supported. The template is matched on
+       a coarse level of the image pyramid and the best peaks are refined
+       on the finer levels. When stop_score > 0, the search stops at the
+       first match that is at least as good (for CV_TM_SQDIFF_NORMED: at
+       most as large) */
+    CVAPI(CvTemplMatch)
+    cvMatchTemplateMultiScale(const CvArr* image, const CvArr* templ,
+                              int method, double min_scale, double max_scale,
+                              double scale_step CV_DEFAULT(1.1),
+                              double stop_score CV_DEFAULT(0));
+
     /* Computes earth mover distance between
        two weighted point sets (called signatures) */
     CVAPI(float)
@@ -465,6 +541,29 @@ extern "C"
      */
     CVAPI(CvSeq*) cvEndFindContours(CvContourScanner* scanner);
 
+    /* Labels the 4- or 8-connected components of the non-zero pixels of the
+       8uC1 image. The 32sC1 labels are 1..n in the raster order of the first
+       pixels of the components and 0 for the background. Optionally, the
+       sequence of CvComponentStats of the components (the element i is for
+       the label i+1) is stored to the storage. The image is labeled in
+       horizontal bands in parallel. Returns the number of components */
+    CVAPI(int)
+    cvConnectedComponents(const CvArr* image, CvArr* labels,
+                          int connectivity CV_DEFAULT(8),
+                          CvMemStorage* storage CV_DEFAULT(NULL),
+                          CvSeq** stats CV_DEFAULT(NULL));
+
+    /* Retrieves the outer boundaries of the components labeled by
+       cvConnectedComponents in the order of the labels (the components are
+       traced in parallel). method is CV_CHAIN_CODE, CV_CHAIN_APPROX_NONE or
+       CV_CHAIN_APPROX_SIMPLE. Returns the number of contours */
+    CVAPI(int)
+    cvFindComponentContours(const CvArr* labels, const CvSeq* stats,
+                            CvMemStorage* storage, CvSeq** first_contour,
+                            int header_size CV_DEFAULT(sizeof(CvContour)),
+                            int method CV_DEFAULT(CV_CHAIN_APPROX_SIMPLE),
+                            CvPoint offset CV_DEFAULT(cvPoint(0, 0)));
+
     /* Approximates a single Freeman chain or a tree of chains to polygonal
      * curves */
     CVAPI(CvSeq*)
@@ -527,6 +626,29 @@ extern "C"
                            float* track_error, CvTermCriteria criteria,
                            int flags);
 
+    /* Dense optical flow by the inverse search of patches on the image
+       pyramids (DIS), optionally refined by a few variational iterations.
+       The presets trade the accuracy for the speed */
+#define CV_DISFLOW_ULTRAFAST 0
+#define CV_DISFLOW_FAST 1
+#define CV_DISFLOW_MEDIUM 2
+
+    typedef struct CvDISOpticalFlow CvDISOpticalFlow;
+
+    CVAPI(CvDISOpticalFlow*)
+    cvCreateDISOpticalFlow(int preset CV_DEFAULT(CV_DISFLOW_FAST));
+    CVAPI(void) cvReleaseDISOpticalFlow(CvDISOpticalFlow** dis);
+
+    /* Calculates the flow from prev to curr (8uC1) into velx and vely
+       (32fC1). The pyramids and buffers are kept in the object between
+       the calls; with CV_LKFLOW_PYR_A_READY prev must be curr of the
+       previous call and its pyramid is reused. With
+       CV_LKFLOW_INITIAL_GUESSES velx and vely hold the initial flow */
+    CVAPI(void)
+    cvCalcOpticalFlowDIS(CvDISOpticalFlow* dis, const CvArr* prev,
+                         const CvArr* curr, CvArr* velx, CvArr* vely,
+                         int flags CV_DEFAULT(0));
+
     /* Modification of a previous sparse optical flow algorithm to calculate
        affine flow */
     /*CVAPI  void  cvCalcAffineFlowPyrLK( const CvArr*  prev, const CvArr* curr,
@@ -1125,6 +1247,10 @@ extern "C"
 #define CV_HAAR_DO_CANNY_PRUNING 1
 #define CV_HAAR_SCALE_IMAGE 2
 
+    /* Finds the objects at all the scales; the windows are run on
+       cvGetNumThreads() threads. The cascade keeps the integral images and
+       the other buffers for the next calls, so a cascade may not be used by
+       several threads at once */
     CVAPI(CvSeq*)
     cvHaarDetectObjects(const CvArr* image, CvHaarClassifierCascade* cascade,
                         CvMemStorage* storage,
@@ -1154,7 +1280,8 @@ extern "C"
                  const CvMat* distortion_coeffs);
 
     /* computes transformation map from intrinsic camera parameters
-       that can used by cvRemap */
+       that can used by cvRemap; the maps are either two 32fC1 arrays or
+       the fixed-point maps of cvConvertMaps */
     CVAPI(void)
     cvInitUndistortMap(const CvMat* intrinsic_matrix,
                        const CvMat* distortion_coeffs, CvArr* mapx,
@@ -568,10 +568,10 @@ static CvStatus CV_STDCALL icvGray2BGR5x5_8u_C1C2R(const uchar* src,
     return CV_OK;
 }
 
-static CvStatus CV_STDCALL icvBGRx2Gray_8u_CnC1R(const uchar* src, int srcstep,
-                                                 uchar* dst, int dststep,
-                                                 CvSize size, int src_cn,
-                                                 int blue_idx)
+IPCVAPI_IMPL(CvStatus, icvBGRx2Gray_8u_CnC1R,
+             (const uchar* src, int srcstep, uchar* dst, int dststep,
+              CvSize size, int src_cn, int blue_idx),
+             (src, srcstep, dst, dststep, size, src_cn, blue_idx))
 {
     int i;
     srcstep -= size.width * src_cn;
@@ -2295,6 +2295,55 @@ static CvStatus CV_STDCALL icvBayer2BGR_8u_C1C3R(const uchar* bayer0,
     return CV_OK;
 }
 
+/* The conversion shared by the bands of rows (or, for continuous arrays
+   that are processed as a single row, of pixels) that cvParallelFor hands
+   out */
+typedef struct CvCvtColorBand
+{
+    const uchar* src;
+    int src_step, src_pix_size;
+    uchar* dst;
+    int dst_step, dst_pix_size;
+    CvSize size;
+    CvColorCvtFunc0 func0;
+    CvColorCvtFunc1 func1;
+    CvColorCvtFunc2 func2;
+    CvColorCvtFunc3 func3;
+    const int* param;
+} CvCvtColorBand;
+
+static int CV_CDECL icvCvtColorBand(int start, int end, void* arg)
+{
+    const CvCvtColorBand* p = (const CvCvtColorBand*)arg;
+    const uchar* src = p->src;
+    uchar* dst = p->dst;
+    CvSize size = p->size;
+
+    if (size.height == 1)
+    {
+        src += start * p->src_pix_size;
+        dst += start * p->dst_pix_size;
+        size.width = end - start;
+    }
+    else
+    {
+        src += start * p->src_step;
+        dst += start * p->dst_step;
+        size.height = end - start;
+    }
+
+    if (p->func0)
+        return p->func0(src, p->src_step, dst, p->dst_step, size);
+    if (p->func1)
+        return p->func1(src, p->src_step, dst, p->dst_step, size,
+                        p->param[0]);
+    if (p->func2)
+        return p->func2(src, p->src_step, dst, p->dst_step, size,
+                        p->param[0], p->param[1]);
+    return p->func3(src, p->src_step, dst, p->dst_step, size, p->param[0],
+                    p->param[1], p->param[2]);
+}
+
 /****************************************************************************************\
 *                                   The main function *
 \****************************************************************************************/
@@ -2315,6 +2364,9 @@ CV_IMPL void cvCvtColor(const CvArr* srcarr, CvArr* dstarr, int code)
     CvColorCvtFunc2 func2 = 0;
     CvColorCvtFunc3 func3 = 0;
     int param[] = {0, 0, 0, 0};
+    CvCvtColorBand band;
+    CvSlice range;
+    int grain;
 
     CV_CALL(src = cvGetMat(srcarr, &srcstub));
     CV_CALL(dst = cvGetMat(dstarr, &dststub));
@@ -2642,28 +2694,39 @@ CV_IMPL void cvCvtColor(const CvArr* srcarr, CvArr* dstarr, int code)
         CV_ERROR(CV_StsBadFlag, "Unknown/unsupported color conversion code");
     }
 
-    if (func0)
-    {
-        IPPI_CALL(
-            func0(src->data.ptr, src_step, dst->data.ptr, dst_step, size));
-    }
-    else if (func1)
-    {
-        IPPI_CALL(func1(src->data.ptr, src_step, dst->data.ptr, dst_step, size,
-                        param[0]));
-    }
-    else if (func2)
+    if (!func0 && !func1 && !func2 && !func3)
+        CV_ERROR(CV_StsUnsupportedFormat, "The image format is not supported");
+
+    band.src = src->data.ptr;
+    band.src_step = src_step;
+    band.src_pix_size = CV_ELEM_SIZE(src->type);
+    band.dst = dst->data.ptr;
+    band.dst_step = dst_step;
+    band.dst_pix_size = CV_ELEM_SIZE(dst->type);
+    band.size = size;
+    band.func0 = func0;
+    band.func1 = func1;
+    band.func2 = func2;
+    band.func3 = func3;
+    band.param = param;
+
+    if (size.height == 1)
     {
-        IPPI_CALL(func2(src->data.ptr, src_step, dst->data.ptr, dst_step, size,
-                        param[0], param[1]));
+        range = cvSlice(0, size.width);
+        grain = CV_PARALLEL_MIN_PIXELS;
     }
-    else if (func3)
+    else
     {
-        IPPI_CALL(func3(src->data.ptr, src_step, dst->data.ptr, dst_step, size,
-                        param[0], param[1], param[2]));
+        range = cvSlice(0, size.height);
+        grain = CV_PARALLEL_GRAIN(size.width);
     }
-    else
-        CV_ERROR(CV_StsUnsupportedFormat, "The image format is not supported");
+
+    // the Bayer demosaicing reads the neighbour rows and fills the border
+    // rows of the whole image
+    if (func1 == (CvColorCvtFunc1)icvBayer2BGR_8u_C1C3R)
+        grain = range.end_index;
+
+    IPPI_CALL((CvStatus)cvParallelFor(range, icvCvtColorBand, &band, grain));
 
     __END__;
 }
@@ -97,9 +97,15 @@ void CvBaseImageFilter::get_work_params()
 
     if (is_separable)
     {
-        int max_depth = MAX(CV_MAT_DEPTH(src_type), CV_MAT_DEPTH(dst_type));
-        int max_cn = MAX(CV_MAT_CN(src_type), CV_MAT_CN(dst_type));
-        max_depth = MAX(max_depth, min_depth);
+        int src_depth = CV_MAT_DEPTH(src_type);
+        int dst_depth = CV_MAT_DEPTH(dst_type);
+        int max_depth, max_cn = MAX(CV_MAT_CN(src_type), CV_MAT_CN(dst_type));
+        // half-precision rows are filtered in single precision
+        if (src_depth == CV_16F)
+            src_depth = CV_32F;
+        if (dst_depth == CV_16F)
+            dst_depth = CV_32F;
+        max_depth = MAX(MAX(src_depth, dst_depth), min_depth);
         work_type = CV_MAKETYPE(max_depth, max_cn);
         trow_sz = cvAlign(
             (max_width + ksize.width - 1) * CV_ELEM_SIZE(src_type), ALIGN);
@@ -301,8 +307,10 @@ void CvBaseImageFilter::make_y_border(int row_count, int top_rows,
     if (border_mode == IPL_BORDER_CONSTANT
         || border_mode == IPL_BORDER_REPLICATE)
     {
+        // rows[top_rows] is the first source row; it is rows[max_ky] only
+        // when the processed roi starts at the top of the image
         uchar* row1 =
-            border_mode == IPL_BORDER_CONSTANT ? const_row : rows[max_ky];
+            border_mode == IPL_BORDER_CONSTANT ? const_row : rows[top_rows];
 
         for (i = 0; i < top_rows && rows[i] == 0; i++)
             rows[i] = row1;
@@ -444,6 +452,7 @@ int CvBaseImageFilter::process(const CvMat* src, CvMat* dst, CvRect src_roi,
     uchar *sptr = 0, *dptr;
     int phase = flags & (CV_START | CV_END | CV_MIDDLE);
     bool isolated_roi = (flags & CV_ISOLATED_ROI) != 0;
+    bool shared_src = (flags & CV_SHARED_SRC) != 0;
 
     if (!CV_IS_MAT(src))
         CV_ERROR(CV_StsBadArg, "");
@@ -543,7 +552,10 @@ int CvBaseImageFilter::process(const CvMat* src, CvMat* dst, CvRect src_roi,
         uchar* bptr;
         int row_count, delta;
 
-        delta = fill_cyclic_buffer(sptr, src->step, src_y, src_y1, src_y2);
+        // the rows of a shared source can not be used as temporary rows, so
+        // the range is passed as having no inner rows
+        delta = fill_cyclic_buffer(sptr, src->step, src_y,
+                                   shared_src ? src_y2 : src_y1, src_y2);
 
         src_y += delta;
         sptr += src->step * delta;
@@ -612,6 +624,9 @@ static void icvFilterRow_16s32f(const short* src, float* dst, void* params);
 static void icvFilterRowSymm_16u32f(const ushort* src, float* dst,
                                     void* params);
 static void icvFilterRow_16u32f(const ushort* src, float* dst, void* params);
+static void icvFilterRowSymm_16f32f(const ushort* src, float* dst,
+                                    void* params);
+static void icvFilterRow_16f32f(const ushort* src, float* dst, void* params);
 static void icvFilterRowSymm_32f(const float* src, float* dst, void* params);
 static void icvFilterRow_32f(const float* src, float* dst, void* params);
 
@@ -627,6 +642,10 @@ static void icvFilterColSymm_32f16u(const float** src, ushort* dst,
                                     int dst_step, int count, void* params);
 static void icvFilterCol_32f16u(const float** src, ushort* dst, int dst_step,
                                 int count, void* params);
+static void icvFilterColSymm_32f16f(const float** src, ushort* dst,
+                                    int dst_step, int count, void* params);
+static void icvFilterCol_32f16f(const float** src, ushort* dst, int dst_step,
+                                int count, void* params);
 static void icvFilterColSymm_32f(const float** src, float* dst, int dst_step,
                                  int count, void* params);
 static void icvFilterCol_32f(const float** src, float* dst, int dst_step,
@@ -801,6 +820,19 @@ void CvSepFilter::init(int _max_width, int _src_type, int _dst_type,
         else
             x_func = (CvRowFilterFunc)icvFilterRow_16u32f;
     }
+    else if (CV_MAT_DEPTH(src_type) == CV_16F)
+    {
+        if (CV_MAT_DEPTH(dst_type) != CV_16F
+            && CV_MAT_DEPTH(dst_type) != CV_32F)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "When the input has 16f data type, the output must have "
+                     "16f or 32f type");
+
+        if (kx_flags & (SYMMETRICAL + ASYMMETRICAL))
+            x_func = (CvRowFilterFunc)icvFilterRowSymm_16f32f;
+        else
+            x_func = (CvRowFilterFunc)icvFilterRow_16f32f;
+    }
     else if (CV_MAT_DEPTH(src_type) == CV_16S)
     {
         if (CV_MAT_DEPTH(dst_type) > CV_32F)
@@ -814,10 +846,11 @@ void CvSepFilter::init(int _max_width, int _src_type, int _dst_type,
     }
     else if (CV_MAT_DEPTH(src_type) == CV_32F)
     {
-        if (CV_MAT_DEPTH(dst_type) != CV_32F)
+        if (CV_MAT_DEPTH(dst_type) != CV_32F
+            && CV_MAT_DEPTH(dst_type) != CV_16F)
             CV_ERROR(CV_StsUnsupportedFormat,
-                     "When the input has 32f data type, the output must also "
-                     "have 32f type");
+                     "When the input has 32f data type, the output must have "
+                     "32f or 16f type");
 
         if (kx_flags & (SYMMETRICAL + ASYMMETRICAL))
             x_func = (CvRowFilterFunc)icvFilterRowSymm_32f;
@@ -858,6 +891,13 @@ void CvSepFilter::init(int _max_width, int _src_type, int _dst_type,
             else
                 y_func = (CvColumnFilterFunc)icvFilterCol_32f;
         }
+        else if (CV_MAT_DEPTH(dst_type) == CV_16F)
+        {
+            if (ky_flags & (SYMMETRICAL + ASYMMETRICAL))
+                y_func = (CvColumnFilterFunc)icvFilterColSymm_32f16f;
+            else
+                y_func = (CvColumnFilterFunc)icvFilterCol_32f16f;
+        }
         else
             CV_ERROR(CV_StsUnsupportedFormat,
                      "Unknown or unsupported input data type");
@@ -900,6 +940,9 @@ void CvSepFilter::init(int _max_width, int _src_type, int _dst_type,
                             _ksize, _anchor, _border_mode, _border_value);
 }
 
+icvFilterRowSymm_8u32s_C1R_t icvFilterRowSymm_8u32s_C1R_p = 0;
+icvFilterColSymm_32s8u_C1R_t icvFilterColSymm_32s8u_C1R_p = 0;
+
 static void icvFilterRowSymm_8u32s(const uchar* src, int* dst, void* params)
 {
     const CvSepFilter* state = (const CvSepFilter*)params;
@@ -915,6 +958,12 @@ static void icvFilterRowSymm_8u32s(const uchar* src, int* dst, void* params)
     kx += ksize2;
     width *= cn;
 
+    if (is_symm && ksize > 1 && icvFilterRowSymm_8u32s_C1R_p)
+    {
+        icvFilterRowSymm_8u32s_C1R_p(s, dst, width, cn, kx, ksize2);
+        return;
+    }
+
     if (is_symm)
     {
         if (ksize == 1 && kx[0] == 1)
@@ -1104,6 +1153,7 @@ static void icvFilterRowSymm_8u32s(const uchar* src, int* dst, void* params)
 ICV_FILTER_ROW(8u32f, uchar, float, CV_8TO32F)
 ICV_FILTER_ROW(16s32f, short, float, CV_NOP)
 ICV_FILTER_ROW(16u32f, ushort, float, CV_NOP)
+ICV_FILTER_ROW(16f32f, ushort, float, CV_16FTO32F)
 ICV_FILTER_ROW(32f, float, float, CV_NOP)
 
 #define ICV_FILTER_ROW_SYMM(flavor, srctype, dsttype, load_macro)             \
@@ -1133,10 +1183,13 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
                 for (k = 1, j = cn; k <= ksize2; k++, j += cn)                \
                 {                                                             \
                     f = kx[k];                                                \
-                    s0 += f * load_macro(s[j] + s[-j]);                       \
-                    s1 += f * load_macro(s[j + 1] + s[-j + 1]);               \
-                    s2 += f * load_macro(s[j + 2] + s[-j + 2]);               \
-                    s3 += f * load_macro(s[j + 3] + s[-j + 3]);               \
+                    s0 += f * (load_macro(s[j]) + load_macro(s[-j]));         \
+                    s1 += f * (load_macro(s[j + 1])                           \
+                               + load_macro(s[-j + 1]));                      \
+                    s2 += f * (load_macro(s[j + 2])                           \
+                               + load_macro(s[-j + 2]));                      \
+                    s3 += f * (load_macro(s[j + 3])                           \
+                               + load_macro(s[-j + 3]));                      \
                 }                                                             \
                                                                               \
                 dst[i] = (dsttype)s0;                                         \
@@ -1149,7 +1202,8 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
             {                                                                 \
                 double s0 = (double)kx[0] * load_macro(s[0]);                 \
                 for (k = 1, j = cn; k <= ksize2; k++, j += cn)                \
-                    s0 += (double)kx[k] * load_macro(s[j] + s[-j]);           \
+                    s0 += (double)kx[k] * (load_macro(s[j])                   \
+                                           + load_macro(s[-j]));              \
                 dst[i] = (dsttype)s0;                                         \
             }                                                                 \
         }                                                                     \
@@ -1161,10 +1215,13 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
                 for (k = 1, j = cn; k <= ksize2; k++, j += cn)                \
                 {                                                             \
                     double f = kx[k];                                         \
-                    s0 += f * load_macro(s[j] - s[-j]);                       \
-                    s1 += f * load_macro(s[j + 1] - s[-j + 1]);               \
-                    s2 += f * load_macro(s[j + 2] - s[-j + 2]);               \
-                    s3 += f * load_macro(s[j + 3] - s[-j + 3]);               \
+                    s0 += f * (load_macro(s[j]) - load_macro(s[-j]));         \
+                    s1 += f * (load_macro(s[j + 1])                           \
+                               - load_macro(s[-j + 1]));                      \
+                    s2 += f * (load_macro(s[j + 2])                           \
+                               - load_macro(s[-j + 2]));                      \
+                    s3 += f * (load_macro(s[j + 3])                           \
+                               - load_macro(s[-j + 3]));                      \
                 }                                                             \
                                                                               \
                 dst[i] = (dsttype)s0;                                         \
@@ -1177,7 +1234,8 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
             {                                                                 \
                 double s0 = 0;                                                \
                 for (k = 1, j = cn; k <= ksize2; k++, j += cn)                \
-                    s0 += (double)kx[k] * load_macro(s[j] - s[-j]);           \
+                    s0 += (double)kx[k] * (load_macro(s[j])                   \
+                                           - load_macro(s[-j]));              \
                 dst[i] = (dsttype)s0;                                         \
             }                                                                 \
         }                                                                     \
@@ -1186,6 +1244,7 @@ ICV_FILTER_ROW(32f, float, float, CV_NOP)
 ICV_FILTER_ROW_SYMM(8u32f, uchar, float, CV_8TO32F)
 ICV_FILTER_ROW_SYMM(16s32f, short, float, CV_NOP)
 ICV_FILTER_ROW_SYMM(16u32f, ushort, float, CV_NOP)
+ICV_FILTER_ROW_SYMM(16f32f, ushort, float, CV_16FTO32F)
 
 static void icvFilterRowSymm_32f(const float* src, float* dst, void* params)
 {
@@ -1304,6 +1363,13 @@ static void icvFilterColSymm_32s8u(const int** src, uchar* dst, int dst_step,
     src += ksize2;
     ky += ksize2;
 
+    if (icvFilterColSymm_32s8u_C1R_p)
+    {
+        icvFilterColSymm_32s8u_C1R_p(src, dst, dst_step, count, width, ky,
+                                     ksize2);
+        return;
+    }
+
     for (; count--; dst += dst_step, src++)
     {
         if (ksize == 3)
@@ -1569,6 +1635,7 @@ static void icvFilterColSymm_32s16s(const int** src, short* dst, int dst_step,
 ICV_FILTER_COL(32f8u, float, uchar, int, cvRound, CV_CAST_8U)
 ICV_FILTER_COL(32f16s, float, short, int, cvRound, CV_CAST_16S)
 ICV_FILTER_COL(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
+ICV_FILTER_COL(32f16f, float, ushort, float, CV_NOP, CV_CAST_16F)
 
 #define ICV_FILTER_COL_SYMM(flavor, srctype, dsttype, worktype, cast_macro1,  \
                             cast_macro2)                                      \
@@ -1679,6 +1746,7 @@ ICV_FILTER_COL(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
 ICV_FILTER_COL_SYMM(32f8u, float, uchar, int, cvRound, CV_CAST_8U)
 ICV_FILTER_COL_SYMM(32f16s, float, short, int, cvRound, CV_CAST_16S)
 ICV_FILTER_COL_SYMM(32f16u, float, ushort, int, cvRound, CV_CAST_16U)
+ICV_FILTER_COL_SYMM(32f16f, float, ushort, float, CV_NOP, CV_CAST_16F)
 
 static void icvFilterCol_32f(const float** src, float* dst, int dst_step,
                              int count, void* params)
@@ -2500,9 +2568,6 @@ int icvIPPSepFilter(const CvMat* src, CvMat* dst, const CvMat* kernelX,
     float *kx, *ky;
     int align, stripe_size;
 
-    if (!icvFilterRow_8u_C1R_p)
-        EXIT;
-
     if (!CV_ARE_TYPES_EQ(src, dst) || !CV_ARE_SIZES_EQ(src, dst)
         || !CV_IS_MAT_CONT(kernelX->type & kernelY->type)
         || CV_MAT_TYPE(kernelX->type) != CV_32FC1
@@ -2550,7 +2615,9 @@ int icvIPPSepFilter(const CvMat* src, CvMat* dst, const CvMat* kernelX,
         x_func = icvFilterRow_32f_C3R_p, y_func = icvFilterColumn_32f_C3R_p;
     else if (type == CV_32FC4)
         x_func = icvFilterRow_32f_C4R_p, y_func = icvFilterColumn_32f_C4R_p;
-    else
+
+    // the built-in functions cover only some of the types
+    if (!x_func || !y_func)
         EXIT;
 
     size = cvGetMatSize(src);
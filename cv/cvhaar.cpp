@@ -108,6 +108,9 @@ struct CvHidHaarClassifierCascade
     sumtype *p0, *p1, *p2, *p3;
 
     void** ipp_stages;
+
+    int size; /* of the whole block, for icvCopyHidHaarClassifierCascade */
+    struct CvHaarDetectBuffers* buffers;
 };
 
 /* IPP functions for object detection */
@@ -119,6 +122,8 @@ icvRectStdDev_32s32f_C1R_t icvRectStdDev_32s32f_C1R_p = 0;
 const int icv_object_win_border = 1;
 const float icv_stage_threshold_bias = 0.0001f;
 
+static void icvReleaseHaarDetectBuffers(struct CvHaarDetectBuffers** buffers);
+
 static CvHaarClassifierCascade* icvCreateHaarClassifierCascade(int stage_count)
 {
     CvHaarClassifierCascade* cascade = 0;
@@ -161,10 +166,55 @@ icvReleaseHidHaarClassifierCascade(CvHidHaarClassifierCascade** _cascade)
             }
         }
         cvFree(&cascade->ipp_stages);
+        icvReleaseHaarDetectBuffers(&cascade->buffers);
         cvFree(_cascade);
     }
 }
 
+/* copies the cascade to the block of cascade->size bytes at dst and moves the
+   internal pointers to the copy. The feature pointers are kept, they are set
+   by icvSetHidHaarImages() */
+static CvHidHaarClassifierCascade*
+icvCopyHidHaarClassifierCascade(const CvHidHaarClassifierCascade* src,
+                                void* dst)
+{
+    CvHidHaarClassifierCascade* cascade = (CvHidHaarClassifierCascade*)dst;
+    int i, j;
+
+#define ICV_HAAR_REBASE(type, ptr)                                         \
+    ((ptr) ? (type*)((char*)dst + ((const char*)(ptr) - (const char*)src)) \
+           : (type*)0)
+
+    memcpy(dst, src, src->size);
+    cascade->stage_classifier =
+        ICV_HAAR_REBASE(CvHidHaarStageClassifier, src->stage_classifier);
+    cascade->ipp_stages = 0;
+    cascade->buffers = 0;
+
+    for (i = 0; i < cascade->count; i++)
+    {
+        CvHidHaarStageClassifier* stage = cascade->stage_classifier + i;
+        stage->classifier =
+            ICV_HAAR_REBASE(CvHidHaarClassifier, stage->classifier);
+        stage->next = ICV_HAAR_REBASE(CvHidHaarStageClassifier, stage->next);
+        stage->child = ICV_HAAR_REBASE(CvHidHaarStageClassifier, stage->child);
+        stage->parent =
+            ICV_HAAR_REBASE(CvHidHaarStageClassifier, stage->parent);
+
+        for (j = 0; j < stage->count; j++)
+        {
+            stage->classifier[j].node = ICV_HAAR_REBASE(
+                CvHidHaarTreeNode, stage->classifier[j].node);
+            stage->classifier[j].alpha =
+                ICV_HAAR_REBASE(float, stage->classifier[j].alpha);
+        }
+    }
+
+#undef ICV_HAAR_REBASE
+
+    return cascade;
+}
+
 /* create more efficient internal representation of haar classifier cascade */
 static CvHidHaarClassifierCascade*
 icvCreateHidHaarClassifierCascade(CvHaarClassifierCascade* cascade)
@@ -435,7 +485,8 @@ icvCreateHidHaarClassifierCascade(CvHaarClassifierCascade* cascade)
 #endif
 
     cascade->hid_cascade = out;
-    assert((char*)haar_node_ptr - (char*)out <= datasize);
+    out->size = (int)((char*)haar_node_ptr - (char*)out);
+    assert(out->size <= datasize);
 
     __END__;
 
@@ -462,77 +513,20 @@ icvCreateHidHaarClassifierCascade(CvHaarClassifierCascade* cascade)
     ((rect).p0[offset] - (rect).p1[offset] - (rect).p2[offset] \
      + (rect).p3[offset])
 
-CV_IMPL void
-cvSetImagesForHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
-                                    const CvArr* _sum, const CvArr* _sqsum,
-                                    const CvArr* _tilted_sum, double scale)
+/* sets the integral images and the scale of the hidden cascade, which is
+   either the one of _cascade or a copy of it. The images are checked by the
+   caller; tilted may be 0 if the cascade has no tilted features */
+static void icvSetHidHaarImages(const CvHaarClassifierCascade* _cascade,
+                                CvHidHaarClassifierCascade* cascade,
+                                const CvMat* sum, const CvMat* sqsum,
+                                const CvMat* tilted, double scale)
 {
-    CV_FUNCNAME("cvSetImagesForHaarClassifierCascade");
-
-    __BEGIN__;
-
-    CvMat sum_stub, *sum = (CvMat*)_sum;
-    CvMat sqsum_stub, *sqsum = (CvMat*)_sqsum;
-    CvMat tilted_stub, *tilted = (CvMat*)_tilted_sum;
-    CvHidHaarClassifierCascade* cascade;
-    int coi0 = 0, coi1 = 0;
     int i;
     CvRect equ_rect;
     double weight_scale;
 
-    if (!CV_IS_HAAR_CLASSIFIER(_cascade))
-        CV_ERROR(!_cascade ? CV_StsNullPtr : CV_StsBadArg,
-                 "Invalid classifier pointer");
-
-    if (scale <= 0)
-        CV_ERROR(CV_StsOutOfRange, "Scale must be positive");
-
-    CV_CALL(sum = cvGetMat(sum, &sum_stub, &coi0));
-    CV_CALL(sqsum = cvGetMat(sqsum, &sqsum_stub, &coi1));
-
-    if (coi0 || coi1)
-        CV_ERROR(CV_BadCOI, "COI is not supported");
-
-    if (!CV_ARE_SIZES_EQ(sum, sqsum))
-        CV_ERROR(CV_StsUnmatchedSizes,
-                 "All integral images must have the same size");
-
-    if (CV_MAT_TYPE(sqsum->type) != CV_64FC1
-        || CV_MAT_TYPE(sum->type) != CV_32SC1)
-        CV_ERROR(CV_StsUnsupportedFormat,
-                 "Only (32s, 64f, 32s) combination of (sum,sqsum,tilted_sum) "
-                 "formats is allowed");
-
-    if (!_cascade->hid_cascade)
-        CV_CALL(icvCreateHidHaarClassifierCascade(_cascade));
-
-    cascade = _cascade->hid_cascade;
-
-    if (cascade->has_tilted_features)
-    {
-        CV_CALL(tilted = cvGetMat(tilted, &tilted_stub, &coi1));
-
-        if (CV_MAT_TYPE(tilted->type) != CV_32SC1)
-            CV_ERROR(CV_StsUnsupportedFormat,
-                     "Only (32s, 64f, 32s) combination of "
-                     "(sum,sqsum,tilted_sum) formats is allowed");
-
-        if (sum->step != tilted->step)
-            CV_ERROR(CV_StsUnmatchedSizes, "Sum and tilted_sum must have the "
-                                           "same stride (step, widthStep)");
-
-        if (!CV_ARE_SIZES_EQ(sum, tilted))
-            CV_ERROR(CV_StsUnmatchedSizes,
-                     "All integral images must have the same size");
+    if (tilted)
         cascade->tilted = *tilted;
-    }
-
-    _cascade->scale = scale;
-    _cascade->real_window_size.width =
-        cvRound(_cascade->orig_window_size.width * scale);
-    _cascade->real_window_size.height =
-        cvRound(_cascade->orig_window_size.height * scale);
-
     cascade->sum = *sum;
     cascade->sqsum = *sqsum;
 
@@ -728,18 +722,89 @@ cvSetImagesForHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
             } /* j */
         }
     }
+}
+
+CV_IMPL void
+cvSetImagesForHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
+                                    const CvArr* _sum, const CvArr* _sqsum,
+                                    const CvArr* _tilted_sum, double scale)
+{
+    CV_FUNCNAME("cvSetImagesForHaarClassifierCascade");
+
+    __BEGIN__;
+
+    CvMat sum_stub, *sum = (CvMat*)_sum;
+    CvMat sqsum_stub, *sqsum = (CvMat*)_sqsum;
+    CvMat tilted_stub, *tilted = (CvMat*)_tilted_sum;
+    CvHidHaarClassifierCascade* cascade;
+    int coi0 = 0, coi1 = 0;
+
+    if (!CV_IS_HAAR_CLASSIFIER(_cascade))
+        CV_ERROR(!_cascade ? CV_StsNullPtr : CV_StsBadArg,
+                 "Invalid classifier pointer");
+
+    if (scale <= 0)
+        CV_ERROR(CV_StsOutOfRange, "Scale must be positive");
+
+    CV_CALL(sum = cvGetMat(sum, &sum_stub, &coi0));
+    CV_CALL(sqsum = cvGetMat(sqsum, &sqsum_stub, &coi1));
+
+    if (coi0 || coi1)
+        CV_ERROR(CV_BadCOI, "COI is not supported");
+
+    if (!CV_ARE_SIZES_EQ(sum, sqsum))
+        CV_ERROR(CV_StsUnmatchedSizes,
+                 "All integral images must have the same size");
+
+    if (CV_MAT_TYPE(sqsum->type) != CV_64FC1
+        || CV_MAT_TYPE(sum->type) != CV_32SC1)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "Only (32s, 64f, 32s) combination of (sum,sqsum,tilted_sum) "
+                 "formats is allowed");
+
+    if (!_cascade->hid_cascade)
+        CV_CALL(icvCreateHidHaarClassifierCascade(_cascade));
+
+    cascade = _cascade->hid_cascade;
+
+    if (cascade->has_tilted_features)
+    {
+        CV_CALL(tilted = cvGetMat(tilted, &tilted_stub, &coi1));
+
+        if (CV_MAT_TYPE(tilted->type) != CV_32SC1)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Only (32s, 64f, 32s) combination of "
+                     "(sum,sqsum,tilted_sum) formats is allowed");
+
+        if (sum->step != tilted->step)
+            CV_ERROR(CV_StsUnmatchedSizes, "Sum and tilted_sum must have the "
+                                           "same stride (step, widthStep)");
+
+        if (!CV_ARE_SIZES_EQ(sum, tilted))
+            CV_ERROR(CV_StsUnmatchedSizes,
+                     "All integral images must have the same size");
+    }
+
+    _cascade->scale = scale;
+    _cascade->real_window_size.width =
+        cvRound(_cascade->orig_window_size.width * scale);
+    _cascade->real_window_size.height =
+        cvRound(_cascade->orig_window_size.height * scale);
+
+    icvSetHidHaarImages(_cascade, cascade, sum, sqsum,
+                        cascade->has_tilted_features ? tilted : 0, scale);
 
     __END__;
 }
 
 CV_INLINE
-double icvEvalHidHaarClassifier(CvHidHaarClassifier* classifier,
+double icvEvalHidHaarClassifier(const CvHidHaarClassifier* classifier,
                                 double variance_norm_factor, size_t p_offset)
 {
     int idx = 0;
     do
     {
-        CvHidHaarTreeNode* node = classifier->node + idx;
+        const CvHidHaarTreeNode* node = classifier->node + idx;
         double t = node->threshold * variance_norm_factor;
 
         double sum = calc_sum(node->feature.rect[0], p_offset)
@@ -756,35 +821,14 @@ double icvEvalHidHaarClassifier(CvHidHaarClassifier* classifier,
     return classifier->alpha[-idx];
 }
 
-CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
-                                       CvPoint pt, int start_stage)
+/* the variance normalization factor of the window at the offsets p_offset
+   and pq_offset of the integral images */
+CV_INLINE double
+icvHaarVarianceNormFactor(const CvHidHaarClassifierCascade* cascade,
+                          int p_offset, int pq_offset)
 {
-    int result = -1;
-    CV_FUNCNAME("cvRunHaarClassifierCascade");
-
-    __BEGIN__;
-
-    int p_offset, pq_offset;
-    int i, j;
     double mean, variance_norm_factor;
-    CvHidHaarClassifierCascade* cascade;
-
-    if (!CV_IS_HAAR_CLASSIFIER(_cascade))
-        CV_ERROR(!_cascade ? CV_StsNullPtr : CV_StsBadArg,
-                 "Invalid cascade pointer");
-
-    cascade = _cascade->hid_cascade;
-    if (!cascade)
-        CV_ERROR(CV_StsNullPtr, "Hidden cascade has not been created.\n"
-                                "Use cvSetImagesForHaarClassifierCascade");
-
-    if (pt.x < 0 || pt.y < 0
-        || pt.x + _cascade->real_window_size.width >= cascade->sum.width - 2
-        || pt.y + _cascade->real_window_size.height >= cascade->sum.height - 2)
-        EXIT;
 
-    p_offset = pt.y * (cascade->sum.step / sizeof(sumtype)) + pt.x;
-    pq_offset = pt.y * (cascade->sqsum.step / sizeof(sqsumtype)) + pt.x;
     mean = calc_sum(*cascade, p_offset) * cascade->inv_window_area;
     variance_norm_factor = cascade->pq0[pq_offset] - cascade->pq1[pq_offset]
                            - cascade->pq2[pq_offset] + cascade->pq3[pq_offset];
@@ -795,12 +839,23 @@ CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
     else
         variance_norm_factor = 1.;
 
+    return variance_norm_factor;
+}
+
+/* runs the stages [start_stage,end_stage) of the cascade on the window at the
+   offset p_offset; the result is the one of cvRunHaarClassifierCascade */
+static int
+icvRunHidHaarClassifierCascade(const CvHidHaarClassifierCascade* cascade,
+                               int p_offset, double variance_norm_factor,
+                               int start_stage, int end_stage)
+{
+    int i, j;
+
     if (cascade->is_tree)
     {
         CvHidHaarStageClassifier* ptr;
         assert(start_stage == 0);
 
-        result = 1;
         ptr = cascade->stage_classifier;
 
         while (ptr)
@@ -822,17 +877,14 @@ CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
                 while (ptr && ptr->next == NULL)
                     ptr = ptr->parent;
                 if (ptr == NULL)
-                {
-                    result = 0;
-                    EXIT;
-                }
+                    return 0;
                 ptr = ptr->next;
             }
         }
     }
     else if (cascade->is_stump_based)
     {
-        for (i = start_stage; i < cascade->count; i++)
+        for (i = start_stage; i < end_stage; i++)
         {
             double stage_sum = 0;
 
@@ -882,15 +934,12 @@ CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
             }
 
             if (stage_sum < cascade->stage_classifier[i].threshold)
-            {
-                result = -i;
-                EXIT;
-            }
+                return -i;
         }
     }
     else
     {
-        for (i = start_stage; i < cascade->count; i++)
+        for (i = start_stage; i < end_stage; i++)
         {
             double stage_sum = 0;
 
@@ -902,18 +951,643 @@ CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
             }
 
             if (stage_sum < cascade->stage_classifier[i].threshold)
+                return -i;
+        }
+    }
+
+    return 1;
+}
+
+CV_IMPL int cvRunHaarClassifierCascade(CvHaarClassifierCascade* _cascade,
+                                       CvPoint pt, int start_stage)
+{
+    int result = -1;
+    CV_FUNCNAME("cvRunHaarClassifierCascade");
+
+    __BEGIN__;
+
+    int p_offset, pq_offset;
+    CvHidHaarClassifierCascade* cascade;
+
+    if (!CV_IS_HAAR_CLASSIFIER(_cascade))
+        CV_ERROR(!_cascade ? CV_StsNullPtr : CV_StsBadArg,
+                 "Invalid cascade pointer");
+
+    cascade = _cascade->hid_cascade;
+    if (!cascade)
+        CV_ERROR(CV_StsNullPtr, "Hidden cascade has not been created.\n"
+                                "Use cvSetImagesForHaarClassifierCascade");
+
+    if (pt.x < 0 || pt.y < 0
+        || pt.x + _cascade->real_window_size.width >= cascade->sum.width - 2
+        || pt.y + _cascade->real_window_size.height >= cascade->sum.height - 2)
+        EXIT;
+
+    p_offset = pt.y * (cascade->sum.step / sizeof(sumtype)) + pt.x;
+    pq_offset = pt.y * (cascade->sqsum.step / sizeof(sqsumtype)) + pt.x;
+
+    result = icvRunHidHaarClassifierCascade(
+        cascade, p_offset,
+        icvHaarVarianceNormFactor(cascade, p_offset, pq_offset), start_stage,
+        cascade->count);
+
+    __END__;
+
+    return result;
+}
+
+/****************************************************************************************\
+*                                  Multi-scale detection *
+\****************************************************************************************/
+
+#define ICV_HAAR_STUMP_RECT(p, stump, k)                                  \
+    ((p)[(stump)->p[k][0]] - (p)[(stump)->p[k][1]] - (p)[(stump)->p[k][2]] \
+     + (p)[(stump)->p[k][3]])
+
+IPCVAPI_IMPL(CvStatus, icvHaarStumpCascade_32s64f,
+             (const CvHaarStumpCascade* cascade, int start_stage,
+              int end_stage, const int* ofs, const double* norm, int* result,
+              int count),
+             (cascade, start_stage, end_stage, ofs, norm, result, count))
+{
+    int i, j, k;
+
+    for (i = 0; i < count; i++)
+    {
+        const int* sum = cascade->sum + ofs[i];
+        const int* tilted = cascade->tilted ? cascade->tilted + ofs[i] : sum;
+        double variance_norm_factor = norm[i];
+        int r = 1;
+
+        for (k = start_stage; k < end_stage && r > 0; k++)
+        {
+            const CvHaarStumpStage* stage = cascade->stages + k;
+            const CvHaarStump* stump = cascade->stumps + stage->first;
+            double stage_sum = 0;
+
+            if (stage->rects == 2)
             {
-                result = -i;
-                EXIT;
+                for (j = 0; j < stage->count; j++, stump++)
+                {
+                    const int* p = stump->tilted ? tilted : sum;
+                    double t = stump->threshold * variance_norm_factor;
+                    double v = ICV_HAAR_STUMP_RECT(p, stump, 0)
+                               * stump->weight[0];
+                    v += ICV_HAAR_STUMP_RECT(p, stump, 1) * stump->weight[1];
+                    stage_sum += v < t ? stump->alpha[0] : stump->alpha[1];
+                }
             }
+            else
+            {
+                for (j = 0; j < stage->count; j++, stump++)
+                {
+                    const int* p = stump->tilted ? tilted : sum;
+                    double t = stump->threshold * variance_norm_factor;
+                    double v = ICV_HAAR_STUMP_RECT(p, stump, 0)
+                               * stump->weight[0];
+                    v += ICV_HAAR_STUMP_RECT(p, stump, 1) * stump->weight[1];
+                    v += ICV_HAAR_STUMP_RECT(p, stump, 2) * stump->weight[2];
+                    stage_sum += v < t ? stump->alpha[0] : stump->alpha[1];
+                }
+            }
+
+            if (stage_sum < stage->threshold)
+                r = -k;
         }
+
+        result[i] = r;
+    }
+
+    return CV_OK;
+}
+
+#undef ICV_HAAR_STUMP_RECT
+
+/* the approximate number of windows in a band of cvHaarDetectObjects */
+#define ICV_HAAR_BAND_WINDOWS 8192
+
+/* one scale of cvHaarDetectObjects: the window grid and the cascade scaled for
+   it. For the stump based cascades hid is the header only (it is used for the
+   variance normalization) and the stumps are run by
+   icvHaarStumpCascade_32s64f */
+typedef struct CvHaarScale
+{
+    double factor;
+    double ystep;
+    CvSize win_size;  /* of the found objects */
+    CvSize real_size; /* of the window in the integral images */
+    int rows, cols;   /* of the window grid */
+    int canny_ofs[4]; /* the corners of the canny pruning rectangle */
+    CvHidHaarClassifierCascade* hid;
+    CvHidHaarClassifierCascade header;
+    CvHaarStump* stumps;
+    CvHaarStumpCascade stump_cascade;
+} CvHaarScale;
+
+/* the rows [y0,y1) of the window grid of a scale */
+typedef struct CvHaarBand
+{
+    int scale;
+    int y0, y1;
+    CvSeq* seq; /* the objects found in the band or 0 */
+} CvHaarBand;
+
+typedef struct CvHaarThreadBuffers
+{
+    CvMemStorage* storage; /* of the band sequences */
+    CvHidHaarClassifierCascade* hid; /* for scaling the stumps */
+    double* norm;
+    int *ofs, *idx, *state, *result;
+} CvHaarThreadBuffers;
+
+/* the buffers kept with the cascade by cvHaarDetectObjects between the calls */
+typedef struct CvHaarDetectBuffers
+{
+    CvMat *sum, *sqsum, *tilted, *temp, *mask, *sumcanny, *img_small,
+        *norm_img;
+    CvHaarScale* scales;
+    int max_scales;
+    CvHaarBand* bands;
+    int max_bands;
+    char* scale_data; /* the stumps or the cascade copies of the scales */
+    int max_scale_data;
+    CvHaarStumpStage* stages;
+    int stump_count;
+    CvHaarThreadBuffers* threads;
+    int thread_count;
+    int row_len;
+} CvHaarDetectBuffers;
+
+typedef struct CvHaarDetectJob
+{
+    CvHaarClassifierCascade* cascade;
+    CvHaarDetectBuffers* buffers;
+    const CvMat *sum, *sqsum, *tilted, *sumcanny;
+    int scale_image;
+    int use_stumps;
+    int split_stage, npass;
+    int lazy; /* run the first pass on the visited windows only */
+    int elem_size; /* of the found objects sequence */
+} CvHaarDetectJob;
+
+static void icvReleaseHaarDetectBuffers(CvHaarDetectBuffers** _buffers)
+{
+    if (_buffers && *_buffers)
+    {
+        CvHaarDetectBuffers* buffers = *_buffers;
+        int i;
+
+        for (i = 0; i < buffers->thread_count; i++)
+        {
+            CvHaarThreadBuffers* tb = buffers->threads + i;
+            cvReleaseMemStorage(&tb->storage);
+            cvFree(&tb->hid);
+            cvFree(&tb->norm);
+        }
+
+        cvReleaseMat(&buffers->sum);
+        cvReleaseMat(&buffers->sqsum);
+        cvReleaseMat(&buffers->tilted);
+        cvReleaseMat(&buffers->temp);
+        cvReleaseMat(&buffers->mask);
+        cvReleaseMat(&buffers->sumcanny);
+        cvReleaseMat(&buffers->img_small);
+        cvReleaseMat(&buffers->norm_img);
+        cvFree(&buffers->scales);
+        cvFree(&buffers->bands);
+        cvFree(&buffers->scale_data);
+        cvFree(&buffers->stages);
+        cvFree(&buffers->threads);
+        cvFree(_buffers);
+    }
+}
+
+/* reallocates the matrix unless it already has the size and type */
+static CvMat* icvReserveHaarMat(CvMat** mat, int rows, int cols, int type)
+{
+    if (!*mat || (*mat)->rows != rows || (*mat)->cols != cols
+        || CV_MAT_TYPE((*mat)->type) != type)
+    {
+        cvReleaseMat(mat);
+        *mat = cvCreateMat(rows, cols, type);
+    }
+
+    return *mat;
+}
+
+/* reallocates the array unless it already has count elements or more */
+static void* icvReserveHaarArray(void** ptr, int* max_count, int count,
+                                 int elem_size)
+{
+    if (*max_count < count)
+    {
+        cvFree(ptr);
+        *max_count = 0;
+        *ptr = cvAlloc((size_t)count * elem_size);
+        if (*ptr)
+            *max_count = count;
+    }
+
+    return *ptr;
+}
+
+/* returns the buffers of the cascade with the thread buffers for the rows
+   of up to row_len windows */
+static CvHaarDetectBuffers*
+icvGetHaarDetectBuffers(CvHidHaarClassifierCascade* cascade, int row_len)
+{
+    CvHaarDetectBuffers* buffers = 0;
+    CvHaarThreadBuffers* threads = 0;
+    int i, j, thread_count = cvGetNumThreads();
+
+    CV_FUNCNAME("icvGetHaarDetectBuffers");
+
+    __BEGIN__;
+
+    if (!cascade->buffers)
+    {
+        CV_CALL(cascade->buffers =
+                    (CvHaarDetectBuffers*)cvAlloc(sizeof(*cascade->buffers)));
+        memset(cascade->buffers, 0, sizeof(*cascade->buffers));
+    }
+
+    buffers = cascade->buffers;
+
+    if (!buffers->stages)
+    {
+        CV_CALL(buffers->stages = (CvHaarStumpStage*)cvAlloc(
+                    cascade->count * sizeof(buffers->stages[0])));
+        for (i = 0, j = 0; i < cascade->count; i++)
+        {
+            const CvHidHaarStageClassifier* stage =
+                cascade->stage_classifier + i;
+            buffers->stages[i].first = j;
+            buffers->stages[i].count = stage->count;
+            buffers->stages[i].rects = stage->two_rects ? 2 : 3;
+            buffers->stages[i].threshold = stage->threshold;
+            j += stage->count;
+        }
+        buffers->stump_count = j;
+    }
+
+    if (buffers->thread_count < thread_count || buffers->row_len < row_len)
+    {
+        thread_count = MAX(thread_count, buffers->thread_count);
+        row_len = MAX(row_len, buffers->row_len);
+
+        CV_CALL(threads = (CvHaarThreadBuffers*)cvAlloc(
+                    thread_count * sizeof(threads[0])));
+        memset(threads, 0, thread_count * sizeof(threads[0]));
+        for (i = 0; i < buffers->thread_count; i++)
+        {
+            threads[i].storage = buffers->threads[i].storage;
+            threads[i].hid = buffers->threads[i].hid;
+            buffers->threads[i].storage = 0;
+            buffers->threads[i].hid = 0;
+        }
+
+        for (i = 0; i < thread_count; i++)
+        {
+            CvHaarThreadBuffers* tb = threads + i;
+
+            if (!tb->storage)
+                CV_CALL(tb->storage = cvCreateMemStorage(0));
+            if (!tb->hid)
+            {
+                CV_CALL(tb->hid = (CvHidHaarClassifierCascade*)cvAlloc(
+                            cascade->size));
+                icvCopyHidHaarClassifierCascade(cascade, tb->hid);
+            }
+
+            CV_CALL(tb->norm = (double*)cvAlloc(
+                        row_len * (sizeof(tb->norm[0]) + sizeof(int) * 4)));
+            tb->ofs = (int*)(tb->norm + row_len);
+            tb->idx = tb->ofs + row_len;
+            tb->state = tb->idx + row_len;
+            tb->result = tb->state + row_len;
+        }
+
+        for (i = 0; i < buffers->thread_count; i++)
+            cvFree(&buffers->threads[i].norm);
+        cvFree(&buffers->threads);
+        buffers->threads = threads;
+        buffers->thread_count = thread_count;
+        buffers->row_len = row_len;
+        threads = 0;
     }
 
-    result = 1;
+    for (i = 0; i < buffers->thread_count; i++)
+        cvClearMemStorage(buffers->threads[i].storage);
 
     __END__;
 
-    return result;
+    if (threads)
+    {
+        for (i = 0; i < thread_count; i++)
+        {
+            cvReleaseMemStorage(&threads[i].storage);
+            cvFree(&threads[i].hid);
+            cvFree(&threads[i].norm);
+        }
+        cvFree(&threads);
+    }
+
+    return buffers;
+}
+
+/* scales the cascade for the scale. temp is a copy of the cascade the stumps
+   are scaled in */
+static void icvSetHaarScale(const CvHaarDetectJob* job, CvHaarScale* scale,
+                            CvHidHaarClassifierCascade* temp)
+{
+    CvHaarClassifierCascade* cascade = job->cascade;
+    const CvHaarDetectBuffers* buffers = job->buffers;
+    double factor = job->scale_image ? 1. : scale->factor;
+    const int* sum_base = job->sum->data.i;
+    const int* tilted_base = job->tilted ? job->tilted->data.i : 0;
+    int i, j, k, n;
+
+    if (!job->use_stumps)
+    {
+        icvCopyHidHaarClassifierCascade(cascade->hid_cascade, scale->hid);
+        icvSetHidHaarImages(cascade, scale->hid, job->sum, job->sqsum,
+                            job->tilted, factor);
+        return;
+    }
+
+    icvSetHidHaarImages(cascade, temp, job->sum, job->sqsum, job->tilted,
+                        factor);
+    scale->header = *temp;
+    scale->header.stage_classifier = 0;
+    scale->hid = &scale->header;
+
+    for (i = 0, n = 0; i < temp->count; i++)
+    {
+        const CvHidHaarStageClassifier* stage = temp->stage_classifier + i;
+
+        for (j = 0; j < stage->count; j++, n++)
+        {
+            const CvHidHaarClassifier* classifier = stage->classifier + j;
+            const CvHidHaarFeature* feature = &classifier->node->feature;
+            CvHaarStump* stump = scale->stumps + n;
+            const int* base;
+
+            stump->tilted =
+                cascade->stage_classifier[i].classifier[j].haar_feature->tilted
+                != 0;
+            base = stump->tilted ? tilted_base : sum_base;
+
+            for (k = 0; k < 3; k++)
+            {
+                if (feature->rect[k].p0)
+                {
+                    stump->p[k][0] = (int)(feature->rect[k].p0 - base);
+                    stump->p[k][1] = (int)(feature->rect[k].p1 - base);
+                    stump->p[k][2] = (int)(feature->rect[k].p2 - base);
+                    stump->p[k][3] = (int)(feature->rect[k].p3 - base);
+                    stump->weight[k] = feature->rect[k].weight;
+                }
+                else
+                {
+                    stump->p[k][0] = stump->p[k][1] = 0;
+                    stump->p[k][2] = stump->p[k][3] = 0;
+                    stump->weight[k] = 0.f;
+                }
+            }
+
+            stump->threshold = classifier->node->threshold;
+            stump->alpha[0] = classifier->alpha[0];
+            stump->alpha[1] = classifier->alpha[1];
+        }
+    }
+
+    assert(n == buffers->stump_count);
+    scale->stump_cascade.sum = sum_base;
+    scale->stump_cascade.tilted = tilted_base;
+    scale->stump_cascade.stumps = scale->stumps;
+    scale->stump_cascade.stages = buffers->stages;
+}
+
+static int CV_CDECL icvSetHaarScales(int start, int end, void* arg)
+{
+    const CvHaarDetectJob* job = (const CvHaarDetectJob*)arg;
+    CvHaarThreadBuffers* tb = job->buffers->threads + cvGetThreadNum();
+    int i;
+
+    for (i = start; i < end; i++)
+        icvSetHaarScale(job, job->buffers->scales + i, tb->hid);
+
+    return CV_StsOk;
+}
+
+/* runs the stages [start_stage,end_stage) of the scaled cascade on the
+   windows; result[i] is the one of cvRunHaarClassifierCascade */
+static void icvRunHaarScale(const CvHaarScale* scale, int start_stage,
+                            int end_stage, const int* ofs, const double* norm,
+                            int* result, int count)
+{
+    int i;
+
+    if (scale->stumps)
+        icvHaarStumpCascade_32s64f_p(&scale->stump_cascade, start_stage,
+                                     end_stage, ofs, norm, result, count);
+    else
+        for (i = 0; i < count; i++)
+            result[i] = icvRunHidHaarClassifierCascade(
+                scale->hid, ofs[i], norm[i], start_stage, end_stage);
+}
+
+/* finds the objects in the row _iy of the window grid of the scale. The first
+   pass runs the stages [0,split_stage) on all the windows of the row and then
+   keeps the results of the windows the scan with the steps of 1 and 2 visits;
+   the second pass runs the other stages on the windows that passed. In the
+   lazy mode the scan runs the first pass on the visited windows only */
+static CvSeq* icvHaarDetectRow(const CvHaarDetectJob* job,
+                               const CvHaarScale* scale, int _iy,
+                               CvHaarThreadBuffers* tb, CvSeq* seq)
+{
+    const CvHidHaarClassifierCascade* hid = scale->hid;
+    int sum_step = job->sum->step / sizeof(sumtype);
+    int sqsum_step = job->sqsum->step / sizeof(sqsumtype);
+    const int* canny = job->sumcanny ? job->sumcanny->data.i : 0;
+    const int* sum = job->sum->data.i;
+    int *ofs = tb->ofs, *idx = tb->idx, *state = tb->state;
+    double* norm = tb->norm;
+    int iy, ix, _ix, i, n, xstep;
+
+    iy = job->scale_image ? _iy : cvRound(_iy * scale->ystep);
+
+    for (_ix = 0, n = 0; _ix < scale->cols; _ix++)
+    {
+        int offset;
+
+        ix = job->scale_image ? _ix : cvRound(_ix * scale->ystep);
+        offset = iy * sum_step + ix;
+
+        if (canny)
+        {
+            const int* c = scale->canny_ofs;
+            int s = canny[offset + c[0]] - canny[offset + c[1]]
+                    - canny[offset + c[2]] + canny[offset + c[3]];
+            int sq = sum[offset + c[0]] - sum[offset + c[1]]
+                     - sum[offset + c[2]] + sum[offset + c[3]];
+            if (s < 100 || sq < 20)
+            {
+                state[_ix] = -2;
+                continue;
+            }
+        }
+
+        if (ix + scale->real_size.width >= hid->sum.width - 2
+            || iy + scale->real_size.height >= hid->sum.height - 2)
+        {
+            state[_ix] = -1;
+            continue;
+        }
+
+        state[_ix] = n;
+        idx[n] = _ix;
+        ofs[n] = offset;
+        if (!job->lazy)
+            norm[n] =
+                icvHaarVarianceNormFactor(hid, offset, iy * sqsum_step + ix);
+        n++;
+    }
+
+    if (n == 0)
+        return seq;
+
+    if (!job->lazy)
+        icvRunHaarScale(scale, 0, job->split_stage, ofs, norm, tb->result,
+                        n);
+
+    for (_ix = 0, n = 0; _ix < scale->cols; _ix += xstep)
+    {
+        int result;
+
+        if (state[_ix] == -2)
+        {
+            xstep = 2;
+            continue;
+        }
+
+        i = state[_ix];
+        if (i >= 0 && job->lazy)
+        {
+            ix = cvRound(_ix * scale->ystep);
+            norm[i] = icvHaarVarianceNormFactor(hid, ofs[i],
+                                                iy * sqsum_step + ix);
+            icvRunHaarScale(scale, 0, job->split_stage, ofs + i, norm + i,
+                            tb->result + i, 1);
+        }
+
+        result = i >= 0 ? tb->result[i] : -1;
+        xstep = job->scale_image || result < 0 ? 1 : 2;
+
+        if (result > 0)
+        {
+            idx[n] = idx[i];
+            ofs[n] = ofs[i];
+            norm[n] = norm[i];
+            n++;
+        }
+    }
+
+    if (job->npass > 1 && n > 0)
+        icvRunHaarScale(scale, job->split_stage, hid->count, ofs, norm,
+                        tb->result, n);
+
+    for (i = 0; i < n; i++)
+    {
+        CvAvgComp comp;
+
+        if (job->npass > 1 && tb->result[i] <= 0)
+            continue;
+
+        ix = job->scale_image ? idx[i] : cvRound(idx[i] * scale->ystep);
+        if (job->scale_image)
+            comp.rect = cvRect(cvRound(ix * scale->factor),
+                               cvRound(iy * scale->factor),
+                               scale->win_size.width, scale->win_size.height);
+        else
+            comp.rect = cvRect(ix, iy, scale->win_size.width,
+                               scale->win_size.height);
+        comp.neighbors = 0;
+
+        if (!seq)
+        {
+            seq = cvCreateSeq(0, sizeof(CvSeq), job->elem_size, tb->storage);
+            if (!seq)
+                break;
+        }
+        cvSeqPush(seq, &comp);
+    }
+
+    return seq;
+}
+
+static int CV_CDECL icvHaarDetectBands(int start, int end, void* arg)
+{
+    const CvHaarDetectJob* job = (const CvHaarDetectJob*)arg;
+    CvHaarThreadBuffers* tb = job->buffers->threads + cvGetThreadNum();
+    int i, y;
+
+    for (i = start; i < end; i++)
+    {
+        CvHaarBand* band = job->buffers->bands + i;
+        const CvHaarScale* scale = job->buffers->scales + band->scale;
+
+        band->seq = 0;
+        for (y = band->y0; y < band->y1; y++)
+        {
+            band->seq = icvHaarDetectRow(job, scale, y, tb, band->seq);
+            if (cvGetErrStatus() < 0)
+                return cvGetErrStatus();
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/* splits the window grid of the scale into bands; returns the new band
+   count */
+static int icvAddHaarBands(CvHaarBand* bands, int count, int scale_idx,
+                           const CvHaarScale* scale)
+{
+    int y, band_rows = MAX(ICV_HAAR_BAND_WINDOWS / MAX(scale->cols, 1), 1);
+
+    for (y = 0; y < scale->rows; y += band_rows)
+    {
+        if (bands)
+        {
+            bands[count].scale = scale_idx;
+            bands[count].y0 = y;
+            bands[count].y1 = MIN(y + band_rows, scale->rows);
+            bands[count].seq = 0;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+/* appends the objects found in the bands to seq in the band order */
+static void icvGatherHaarBands(const CvHaarBand* bands, int count, CvSeq* seq)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        CvSeq* s = bands[i].seq;
+        CvSeqBlock* b;
+        int j;
+
+        if (!s)
+            continue;
+
+        for (j = 0, b = s->first; j < s->total; j += b->count, b = b->next)
+            cvSeqPushMulti(seq, b->data, b->count);
+    }
 }
 
 static int is_equal(const void* _r1, const void* _r2, void*)
@@ -937,8 +1611,6 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
     int split_stage = 2;
 
     CvMat stub, *img = (CvMat*)_img;
-    CvMat *temp = 0, *sum = 0, *tilted = 0, *sqsum = 0, *norm_img = 0,
-          *sumcanny = 0, *img_small = 0;
     CvSeq* seq = 0;
     CvSeq* seq2 = 0;
     CvSeq* idx_seq = 0;
@@ -947,11 +1619,6 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
     CvAvgComp* comps = 0;
     int i;
 
-#ifdef _OPENMP
-    CvSeq* seq_thread[CV_MAX_THREADS] = {0};
-    int max_threads = 0;
-#endif
-
     CV_FUNCNAME("cvHaarDetectObjects");
 
     __BEGIN__;
@@ -959,6 +1626,11 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
     double factor;
     int npass = 2, coi;
     int do_canny_pruning = flags & CV_HAAR_DO_CANNY_PRUNING;
+    CvHidHaarClassifierCascade* hid;
+    CvHaarDetectBuffers* buffers;
+    CvMat *temp, *sum, *sqsum, *tilted = 0;
+    CvHaarDetectJob job;
+    int scale_size, nscales, nbands;
 
     if (!CV_IS_HAAR_CLASSIFIER(cascade))
         CV_ERROR(!cascade ? CV_StsNullPtr : CV_StsBadArg,
@@ -974,27 +1646,22 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
     if (CV_MAT_DEPTH(img->type) != CV_8U)
         CV_ERROR(CV_StsUnsupportedFormat, "Only 8-bit images are supported");
 
-    CV_CALL(temp = cvCreateMat(img->rows, img->cols, CV_8UC1));
-    CV_CALL(sum = cvCreateMat(img->rows + 1, img->cols + 1, CV_32SC1));
-    CV_CALL(sqsum = cvCreateMat(img->rows + 1, img->cols + 1, CV_64FC1));
-    CV_CALL(temp_storage = cvCreateChildMemStorage(storage));
-
-#ifdef _OPENMP
-    max_threads = cvGetNumThreads();
-    for (i = 0; i < max_threads; i++)
-    {
-        CvMemStorage* temp_storage_thread;
-        CV_CALL(temp_storage_thread = cvCreateMemStorage(0));
-        CV_CALL(seq_thread[i] = cvCreateSeq(0, sizeof(CvSeq), sizeof(CvRect),
-                                            temp_storage_thread));
-    }
-#endif
-
     if (!cascade->hid_cascade)
         CV_CALL(icvCreateHidHaarClassifierCascade(cascade));
 
-    if (cascade->hid_cascade->has_tilted_features)
-        tilted = cvCreateMat(img->rows + 1, img->cols + 1, CV_32SC1);
+    hid = cascade->hid_cascade;
+
+    CV_CALL(buffers = icvGetHaarDetectBuffers(hid, img->cols + 1));
+    CV_CALL(temp = icvReserveHaarMat(&buffers->temp, img->rows, img->cols,
+                                     CV_8UC1));
+    CV_CALL(sum = icvReserveHaarMat(&buffers->sum, img->rows + 1,
+                                    img->cols + 1, CV_32SC1));
+    CV_CALL(sqsum = icvReserveHaarMat(&buffers->sqsum, img->rows + 1,
+                                      img->cols + 1, CV_64FC1));
+    if (hid->has_tilted_features)
+        CV_CALL(tilted = icvReserveHaarMat(&buffers->tilted, img->rows + 1,
+                                           img->cols + 1, CV_32SC1));
+    CV_CALL(temp_storage = cvCreateChildMemStorage(storage));
 
     seq = cvCreateSeq(0, sizeof(CvSeq), sizeof(CvRect), temp_storage);
     seq2 = cvCreateSeq(0, sizeof(CvSeq), sizeof(CvAvgComp), temp_storage);
@@ -1009,15 +1676,50 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
         img = temp;
     }
 
+    memset(&job, 0, sizeof(job));
+    job.cascade = cascade;
+    job.buffers = buffers;
+    job.use_stumps = hid->is_stump_based && !hid->is_tree;
+    job.elem_size = seq->elem_size;
+    scale_size = job.use_stumps
+                     ? buffers->stump_count * (int)sizeof(CvHaarStump)
+                     : cvAlign(hid->size, 16);
+
     if (flags & CV_HAAR_SCALE_IMAGE)
     {
         CvSize win_size0 = cascade->orig_window_size;
-        int use_ipp = cascade->hid_cascade->ipp_stages != 0
+        CvMat *img_small, *norm_img = 0, *mask = 0;
+        CvHaarScale* scale;
+        int use_ipp = hid->ipp_stages != 0
                       && icvApplyHaarClassifier_32s32f_C1R_p != 0;
 
         if (use_ipp)
-            CV_CALL(norm_img = cvCreateMat(img->rows, img->cols, CV_32FC1));
-        CV_CALL(img_small = cvCreateMat(img->rows + 1, img->cols + 1, CV_8UC1));
+        {
+            CV_CALL(norm_img = icvReserveHaarMat(&buffers->norm_img, img->rows,
+                                                 img->cols, CV_32FC1));
+            CV_CALL(mask = icvReserveHaarMat(&buffers->mask, img->rows,
+                                             img->cols, CV_8UC1));
+        }
+        CV_CALL(img_small = icvReserveHaarMat(&buffers->img_small,
+                                              img->rows + 1, img->cols + 1,
+                                              CV_8UC1));
+        CV_CALL(scale = (CvHaarScale*)icvReserveHaarArray(
+                    (void**)&buffers->scales, &buffers->max_scales, 1,
+                    sizeof(CvHaarScale)));
+        CV_CALL(icvReserveHaarArray((void**)&buffers->scale_data,
+                                    &buffers->max_scale_data, scale_size, 1));
+
+        memset(scale, 0, sizeof(*scale));
+        if (job.use_stumps)
+            scale->stumps = (CvHaarStump*)buffers->scale_data;
+        else
+            scale->hid = (CvHidHaarClassifierCascade*)buffers->scale_data;
+        scale->real_size = win_size0;
+        scale->ystep = 1;
+
+        job.scale_image = 1;
+        job.split_stage = cascade->count;
+        job.npass = 1;
 
         for (factor = 1;; factor *= scale_factor)
         {
@@ -1053,7 +1755,8 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
             }
             norm1 = cvMat(sz1.height, sz1.width, CV_32FC1,
                           norm_img ? norm_img->data.ptr : 0);
-            mask1 = cvMat(sz1.height, sz1.width, CV_8UC1, temp->data.ptr);
+            mask1 = cvMat(sz1.height, sz1.width, CV_8UC1,
+                          mask ? mask->data.ptr : 0);
 
             cvResize(img, &img1, CV_INTER_LINEAR);
             cvIntegral(&img1, &sum1, &sqsum1, _tilted);
@@ -1074,8 +1777,8 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
                     if (icvApplyHaarClassifier_32s32f_C1R_p(
                             sum1.data.i, sum1.step, norm1.data.fl, norm1.step,
                             mask1.data.ptr, mask1.step, sz1, &positive,
-                            cascade->hid_cascade->stage_classifier[i].threshold,
-                            cascade->hid_cascade->ipp_stages[i])
+                            hid->stage_classifier[i].threshold,
+                            hid->ipp_stages[i])
                         < 0)
                     {
                         use_ipp = 0;
@@ -1086,206 +1789,157 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
                 }
             }
 
-            if (!use_ipp)
+            if (use_ipp)
             {
-                cvSetImagesForHaarClassifierCascade(cascade, &sum1, &sqsum1, 0,
-                                                    1.);
-                for (y = 0, positive = 0; y < sz1.height; y++)
-                    for (x = 0; x < sz1.width; x++)
-                    {
-                        mask1.data.ptr[mask1.step * y + x] =
-                            cvRunHaarClassifierCascade(cascade, cvPoint(x, y),
-                                                       0)
-                            > 0;
-                        positive += mask1.data.ptr[mask1.step * y + x];
-                    }
+                if (positive > 0)
+                {
+                    for (y = 0; y < sz1.height; y++)
+                        for (x = 0; x < sz1.width; x++)
+                            if (mask1.data.ptr[mask1.step * y + x] != 0)
+                            {
+                                CvAvgComp comp;
+                                comp.rect = cvRect(cvRound(x * factor),
+                                                   cvRound(y * factor),
+                                                   win_size.width,
+                                                   win_size.height);
+                                comp.neighbors = 0;
+                                cvSeqPush(seq, &comp);
+                            }
+                }
             }
-
-            if (positive > 0)
+            else
             {
-                for (y = 0; y < sz1.height; y++)
-                    for (x = 0; x < sz1.width; x++)
-                        if (mask1.data.ptr[mask1.step * y + x] != 0)
-                        {
-                            CvRect obj_rect = {cvRound(y * factor),
-                                               cvRound(x * factor),
-                                               win_size.width, win_size.height};
-                            cvSeqPush(seq, &obj_rect);
-                        }
+                scale->factor = factor;
+                scale->win_size = win_size;
+                scale->rows = sz1.height;
+                scale->cols = sz1.width;
+
+                job.sum = &sum1;
+                job.sqsum = &sqsum1;
+                job.tilted = _tilted;
+                icvSetHaarScale(&job, scale, buffers->threads[0].hid);
+
+                nbands = icvAddHaarBands(0, 0, 0, scale);
+                CV_CALL(icvReserveHaarArray((void**)&buffers->bands,
+                                            &buffers->max_bands, nbands,
+                                            sizeof(CvHaarBand)));
+                icvAddHaarBands(buffers->bands, 0, 0, scale);
+
+                IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nbands),
+                                                  icvHaarDetectBands, &job,
+                                                  1));
+                CV_CALL(icvGatherHaarBands(buffers->bands, nbands, seq));
             }
         }
     }
     else
     {
+        CvMat* sumcanny = 0;
+        int sum_step = sum->step / sizeof(sumtype);
+
         cvIntegral(img, sum, sqsum, tilted);
 
         if (do_canny_pruning)
         {
-            sumcanny = cvCreateMat(img->rows + 1, img->cols + 1, CV_32SC1);
-            cvCanny(img, temp, 0, 50, 3);
-            cvIntegral(temp, sumcanny);
+            CvMat* edges;
+            CV_CALL(edges = icvReserveHaarMat(&buffers->mask, img->rows,
+                                              img->cols, CV_8UC1));
+            CV_CALL(sumcanny = icvReserveHaarMat(&buffers->sumcanny,
+                                                 img->rows + 1, img->cols + 1,
+                                                 CV_32SC1));
+            cvCanny(img, edges, 0, 50, 3);
+            cvIntegral(edges, sumcanny);
         }
 
-        if ((unsigned)split_stage >= (unsigned)cascade->count
-            || cascade->hid_cascade->is_tree)
+        if ((unsigned)split_stage >= (unsigned)cascade->count || hid->is_tree)
         {
             split_stage = cascade->count;
             npass = 1;
         }
 
-        for (factor = 1;
+        for (factor = 1, nscales = 0;
+             factor * cascade->orig_window_size.width < img->cols - 10
+             && factor * cascade->orig_window_size.height < img->rows - 10;
+             factor *= scale_factor)
+            nscales++;
+
+        CV_CALL(icvReserveHaarArray((void**)&buffers->scales,
+                                    &buffers->max_scales, MAX(nscales, 1),
+                                    sizeof(CvHaarScale)));
+        CV_CALL(icvReserveHaarArray((void**)&buffers->scale_data,
+                                    &buffers->max_scale_data,
+                                    MAX(nscales, 1) * scale_size, 1));
+
+        for (factor = 1, nscales = 0, nbands = 0;
              factor * cascade->orig_window_size.width < img->cols - 10
              && factor * cascade->orig_window_size.height < img->rows - 10;
              factor *= scale_factor)
         {
+            CvHaarScale* scale = buffers->scales + nscales;
+            char* data = buffers->scale_data + nscales * scale_size;
             const double ystep = MAX(2, factor);
             CvSize win_size = {
                 cvRound(cascade->orig_window_size.width * factor),
                 cvRound(cascade->orig_window_size.height * factor)};
-            CvRect equ_rect = {0, 0, 0, 0};
-            int *p0 = 0, *p1 = 0, *p2 = 0, *p3 = 0;
-            int *pq0 = 0, *pq1 = 0, *pq2 = 0, *pq3 = 0;
-            int pass, stage_offset = 0;
-            int stop_height = cvRound((img->rows - win_size.height) / ystep);
 
             if (win_size.width < min_size.width
                 || win_size.height < min_size.height)
                 continue;
 
-            cvSetImagesForHaarClassifierCascade(cascade, sum, sqsum, tilted,
-                                                factor);
-            cvZero(temp);
+            scale->factor = factor;
+            scale->ystep = ystep;
+            scale->win_size = scale->real_size = win_size;
+            scale->rows = cvRound((img->rows - win_size.height) / ystep);
+            scale->cols = cvRound((img->cols - win_size.width) / ystep);
+            scale->stumps = job.use_stumps ? (CvHaarStump*)data : 0;
+            scale->hid =
+                job.use_stumps ? 0 : (CvHidHaarClassifierCascade*)data;
 
             if (do_canny_pruning)
             {
+                CvRect equ_rect;
                 equ_rect.x = cvRound(win_size.width * 0.15);
                 equ_rect.y = cvRound(win_size.height * 0.15);
                 equ_rect.width = cvRound(win_size.width * 0.7);
                 equ_rect.height = cvRound(win_size.height * 0.7);
 
-                p0 = (int*)(sumcanny->data.ptr + equ_rect.y * sumcanny->step)
-                     + equ_rect.x;
-                p1 = (int*)(sumcanny->data.ptr + equ_rect.y * sumcanny->step)
-                     + equ_rect.x + equ_rect.width;
-                p2 = (int*)(sumcanny->data.ptr
-                            + (equ_rect.y + equ_rect.height) * sumcanny->step)
-                     + equ_rect.x;
-                p3 = (int*)(sumcanny->data.ptr
-                            + (equ_rect.y + equ_rect.height) * sumcanny->step)
-                     + equ_rect.x + equ_rect.width;
-
-                pq0 =
-                    (int*)(sum->data.ptr + equ_rect.y * sum->step) + equ_rect.x;
-                pq1 = (int*)(sum->data.ptr + equ_rect.y * sum->step)
-                      + equ_rect.x + equ_rect.width;
-                pq2 = (int*)(sum->data.ptr
-                             + (equ_rect.y + equ_rect.height) * sum->step)
-                      + equ_rect.x;
-                pq3 = (int*)(sum->data.ptr
-                             + (equ_rect.y + equ_rect.height) * sum->step)
-                      + equ_rect.x + equ_rect.width;
+                scale->canny_ofs[0] = equ_rect.y * sum_step + equ_rect.x;
+                scale->canny_ofs[1] = scale->canny_ofs[0] + equ_rect.width;
+                scale->canny_ofs[2] =
+                    (equ_rect.y + equ_rect.height) * sum_step + equ_rect.x;
+                scale->canny_ofs[3] = scale->canny_ofs[2] + equ_rect.width;
             }
 
-            cascade->hid_cascade->count = split_stage;
-
-            for (pass = 0; pass < npass; pass++)
-            {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(max_threads), schedule(dynamic)
-#endif
-                for (int _iy = 0; _iy < stop_height; _iy++)
-                {
-                    int iy = cvRound(_iy * ystep);
-                    int _ix, _xstep = 1;
-                    int stop_width =
-                        cvRound((img->cols - win_size.width) / ystep);
-                    uchar* mask_row = temp->data.ptr + temp->step * iy;
-
-                    for (_ix = 0; _ix < stop_width; _ix += _xstep)
-                    {
-                        int ix =
-                            cvRound(_ix * ystep); // it really should be ystep
-
-                        if (pass == 0)
-                        {
-                            int result;
-                            _xstep = 2;
-
-                            if (do_canny_pruning)
-                            {
-                                int offset;
-                                int s, sq;
-
-                                offset = iy * (sum->step / sizeof(p0[0])) + ix;
-                                s = p0[offset] - p1[offset] - p2[offset]
-                                    + p3[offset];
-                                sq = pq0[offset] - pq1[offset] - pq2[offset]
-                                     + pq3[offset];
-                                if (s < 100 || sq < 20)
-                                    continue;
-                            }
-
-                            result = cvRunHaarClassifierCascade(
-                                cascade, cvPoint(ix, iy), 0);
-                            if (result > 0)
-                            {
-                                if (pass < npass - 1)
-                                    mask_row[ix] = 1;
-                                else
-                                {
-                                    CvRect rect = cvRect(ix, iy, win_size.width,
-                                                         win_size.height);
-#ifndef _OPENMP
-                                    cvSeqPush(seq, &rect);
-#else
-                                    cvSeqPush(seq_thread[omp_get_thread_num()],
-                                              &rect);
-#endif
-                                }
-                            }
-                            if (result < 0)
-                                _xstep = 1;
-                        }
-                        else if (mask_row[ix])
-                        {
-                            int result = cvRunHaarClassifierCascade(
-                                cascade, cvPoint(ix, iy), stage_offset);
-                            if (result > 0)
-                            {
-                                if (pass == npass - 1)
-                                {
-                                    CvRect rect = cvRect(ix, iy, win_size.width,
-                                                         win_size.height);
-#ifndef _OPENMP
-                                    cvSeqPush(seq, &rect);
-#else
-                                    cvSeqPush(seq_thread[omp_get_thread_num()],
-                                              &rect);
-#endif
-                                }
-                            }
-                            else
-                                mask_row[ix] = 0;
-                        }
-                    }
-                }
-                stage_offset = cascade->hid_cascade->count;
-                cascade->hid_cascade->count = cascade->count;
-            }
+            nbands = icvAddHaarBands(0, nbands, nscales, scale);
+            nscales++;
         }
-    }
 
-#ifdef _OPENMP
-    // gather the results
-    for (i = 0; i < max_threads; i++)
-    {
-        CvSeq* s = seq_thread[i];
-        int j, total = s->total;
-        CvSeqBlock* b = s->first;
-        for (j = 0; j < total; j += b->count, b = b->next)
-            cvSeqPushMulti(seq, b->data, b->count);
+        job.sum = sum;
+        job.sqsum = sqsum;
+        job.tilted = tilted;
+        job.sumcanny = sumcanny;
+        job.split_stage = split_stage;
+        job.npass = npass;
+        /* the first pass on all the windows pays off with the SIMD kernel
+           only; the scan skips a third of them or more */
+        job.lazy = npass == 1 || !job.use_stumps
+                   || icvHaarStumpCascade_32s64f_p
+                          == icvHaarStumpCascade_32s64f_f;
+
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nscales),
+                                          icvSetHaarScales, &job, 1));
+
+        CV_CALL(icvReserveHaarArray((void**)&buffers->bands,
+                                    &buffers->max_bands, MAX(nbands, 1),
+                                    sizeof(CvHaarBand)));
+        for (i = 0, nbands = 0; i < nscales; i++)
+            nbands = icvAddHaarBands(buffers->bands, nbands, i,
+                                     buffers->scales + i);
+
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nbands),
+                                          icvHaarDetectBands, &job, 1));
+        CV_CALL(icvGatherHaarBands(buffers->bands, nbands, seq));
     }
-#endif
 
     if (min_neighbors != 0)
     {
@@ -1361,22 +2015,7 @@ CV_IMPL CvSeq* cvHaarDetectObjects(const CvArr* _img,
 
     __END__;
 
-#ifdef _OPENMP
-    for (i = 0; i < max_threads; i++)
-    {
-        if (seq_thread[i])
-            cvReleaseMemStorage(&seq_thread[i]->storage);
-    }
-#endif
-
     cvReleaseMemStorage(&temp_storage);
-    cvReleaseMat(&sum);
-    cvReleaseMat(&sqsum);
-    cvReleaseMat(&tilted);
-    cvReleaseMat(&temp);
-    cvReleaseMat(&sumcanny);
-    cvReleaseMat(&norm_img);
-    cvReleaseMat(&img_small);
     cvFree(&comps);
 
     return result_seq;
@@ -131,7 +131,7 @@ void icvInitCubicCoeffTab()
 static CvStatus CV_STDCALL icvResize_NN_8u_C1R(const uchar* src, int srcstep,
                                                CvSize ssize, uchar* dst,
                                                int dststep, CvSize dsize,
-                                               int pix_size)
+                                               int pix_size, CvSlice rows)
 {
     int* x_ofs = (int*)cvStackAlloc(dsize.width * sizeof(x_ofs[0]));
     int pix_size4 = pix_size / sizeof(int);
@@ -145,7 +145,8 @@ static CvStatus CV_STDCALL icvResize_NN_8u_C1R(const uchar* src, int srcstep,
         x_ofs[x] = t * pix_size;
     }
 
-    for (y = 0; y < dsize.height; y++, dst += dststep)
+    dst += rows.start_index * dststep;
+    for (y = rows.start_index; y < rows.end_index; y++, dst += dststep)
     {
         const uchar* tsrc;
         t = (ssize.height * y * 2 + MIN(ssize.height, dsize.height) - 1)
@@ -216,13 +217,16 @@ typedef struct CvResizeAlpha
 } CvResizeAlpha;
 
 #define ICV_DEF_RESIZE_BILINEAR_FUNC(flavor, arrtype, worktype, alpha_field,   \
-                                     mul_one_macro, descale_macro)             \
+                                     load_macro, mul_one_macro, descale_macro) \
     static CvStatus CV_STDCALL icvResize_Bilinear_##flavor##_CnR(              \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
         int dststep, CvSize dsize, int cn, int xmax,                           \
         const CvResizeAlpha* xofs, const CvResizeAlpha* yofs, worktype* buf0,  \
-        worktype* buf1)                                                        \
+        worktype* buf1, CvSlice rows, const void* _vline)                      \
     {                                                                          \
+        typedef CvStatus(CV_STDCALL * CvVLineFunc)(                            \
+            const worktype*, const worktype*, worktype, arrtype*, int);        \
+        CvVLineFunc vline = (CvVLineFunc)_vline;                               \
         int prev_sy0 = -1, prev_sy1 = -1;                                      \
         int k, dx, dy;                                                         \
                                                                                \
@@ -230,8 +234,9 @@ typedef struct CvResizeAlpha
         dststep /= sizeof(dst[0]);                                             \
         dsize.width *= cn;                                                     \
         xmax *= cn;                                                            \
+        dst += rows.start_index * dststep;                                     \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = rows.start_index; dy < rows.end_index; dy++, dst += dststep) \
         {                                                                      \
             worktype fy = yofs[dy].alpha_field, *swap_t;                       \
             int sy0 = yofs[dy].idx,                                            \
@@ -263,12 +268,13 @@ typedef struct CvResizeAlpha
                 {                                                              \
                     int sx = xofs[dx].idx;                                     \
                     worktype fx = xofs[dx].alpha_field;                        \
-                    worktype t = _src[sx];                                     \
-                    _buf[dx] = mul_one_macro(t) + fx * (_src[sx + cn] - t);    \
+                    worktype t = load_macro(_src[sx]);                         \
+                    _buf[dx] = mul_one_macro(t)                                \
+                               + fx * (load_macro(_src[sx + cn]) - t);         \
                 }                                                              \
                                                                                \
                 for (; dx < dsize.width; dx++)                                 \
-                    _buf[dx] = mul_one_macro(_src[xofs[dx].idx]);              \
+                    _buf[dx] = mul_one_macro(load_macro(_src[xofs[dx].idx]));  \
             }                                                                  \
                                                                                \
             prev_sy0 = sy0;                                                    \
@@ -277,6 +283,8 @@ typedef struct CvResizeAlpha
             if (sy0 == sy1)                                                    \
                 for (dx = 0; dx < dsize.width; dx++)                           \
                     dst[dx] = (arrtype)descale_macro(mul_one_macro(buf0[dx])); \
+            else if (vline)                                                    \
+                vline(buf0, buf1, fy, dst, dsize.width);                       \
             else                                                               \
                 for (dx = 0; dx < dsize.width; dx++)                           \
                     dst[dx] = (arrtype)descale_macro(                          \
@@ -292,10 +300,12 @@ typedef struct CvDecimateAlpha
     float alpha;
 } CvDecimateAlpha;
 
-#define ICV_DEF_RESIZE_AREA_FAST_FUNC(flavor, arrtype, worktype, cast_macro)   \
+#define ICV_DEF_RESIZE_AREA_FAST_FUNC(flavor, arrtype, worktype, load_macro,   \
+                                      cast_macro)                              \
     static CvStatus CV_STDCALL icvResize_AreaFast_##flavor##_CnR(              \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
-        int dststep, CvSize dsize, int cn, const int* ofs, const int* xofs)    \
+        int dststep, CvSize dsize, int cn, const int* ofs, const int* xofs,    \
+        CvSlice rows)                                                          \
     {                                                                          \
         int dy, dx, k = 0;                                                     \
         int scale_x = ssize.width / dsize.width;                               \
@@ -306,19 +316,22 @@ typedef struct CvDecimateAlpha
         srcstep /= sizeof(src[0]);                                             \
         dststep /= sizeof(dst[0]);                                             \
         dsize.width *= cn;                                                     \
+        dst += rows.start_index * dststep;                                     \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = rows.start_index; dy < rows.end_index; dy++, dst += dststep) \
             for (dx = 0; dx < dsize.width; dx++)                               \
             {                                                                  \
                 const arrtype* _src = src + dy * scale_y * srcstep + xofs[dx]; \
                 worktype sum = 0;                                              \
                                                                                \
                 for (k = 0; k <= area - 4; k += 4)                             \
-                    sum += _src[ofs[k]] + _src[ofs[k + 1]] + _src[ofs[k + 2]]  \
-                           + _src[ofs[k + 3]];                                 \
+                    sum += load_macro(_src[ofs[k]])                            \
+                           + load_macro(_src[ofs[k + 1]])                      \
+                           + load_macro(_src[ofs[k + 2]])                      \
+                           + load_macro(_src[ofs[k + 3]]);                     \
                                                                                \
                 for (; k < area; k++)                                          \
-                    sum += _src[ofs[k]];                                       \
+                    sum += load_macro(_src[ofs[k]]);                           \
                                                                                \
                 dst[dx] = (arrtype)cast_macro(sum * scale);                    \
             }                                                                  \
@@ -433,7 +446,7 @@ typedef struct CvDecimateAlpha
     static CvStatus CV_STDCALL icvResize_Bicubic_##flavor##_CnR(               \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,           \
         int dststep, CvSize dsize, int cn, int xmin, int xmax,                 \
-        const CvResizeAlpha* xofs, float** buf)                                \
+        const CvResizeAlpha* xofs, float** buf, CvSlice rows)                  \
     {                                                                          \
         float scale_y = (float)ssize.height / dsize.height;                    \
         int dx, dy, sx, sy, sy2, ify;                                          \
@@ -445,8 +458,9 @@ typedef struct CvDecimateAlpha
         ssize.width *= cn;                                                     \
         srcstep /= sizeof(src[0]);                                             \
         dststep /= sizeof(dst[0]);                                             \
+        dst += rows.start_index * dststep;                                     \
                                                                                \
-        for (dy = 0; dy < dsize.height; dy++, dst += dststep)                  \
+        for (dy = rows.start_index; dy < rows.end_index; dy++, dst += dststep) \
         {                                                                      \
             float w0, w1, w2, w3;                                              \
             float fy, x, sum;                                                  \
@@ -506,11 +520,12 @@ typedef struct CvDecimateAlpha
                     int ifx = xofs[dx].ialpha;                                 \
                     int sx0 = xofs[dx].idx;                                    \
                     row[dx] =                                                  \
-                        _src[sx0 - cn] * icvCubicCoeffs[ifx * 2 + 1]           \
-                        + _src[sx0] * icvCubicCoeffs[ifx * 2]                  \
-                        + _src[sx0 + cn]                                       \
+                        load_macro(_src[sx0 - cn])                             \
+                            * icvCubicCoeffs[ifx * 2 + 1]                      \
+                        + load_macro(_src[sx0]) * icvCubicCoeffs[ifx * 2]      \
+                        + load_macro(_src[sx0 + cn])                           \
                               * icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE - ifx) * 2] \
-                        + _src[sx0 + cn * 2]                                   \
+                        + load_macro(_src[sx0 + cn * 2])                       \
                               * icvCubicCoeffs[(ICV_CUBIC_TAB_SIZE - ifx) * 2  \
                                                + 1];                           \
                 }                                                              \
@@ -563,60 +578,268 @@ typedef struct CvDecimateAlpha
         return CV_OK;                                                          \
     }
 
-ICV_DEF_RESIZE_BILINEAR_FUNC(8u, uchar, int, ialpha, ICV_WARP_MUL_ONE_8U,
-                             ICV_WARP_DESCALE_8U)
-ICV_DEF_RESIZE_BILINEAR_FUNC(16u, ushort, float, alpha, CV_NOP, cvRound)
-ICV_DEF_RESIZE_BILINEAR_FUNC(32f, float, float, alpha, CV_NOP, CV_NOP)
+ICV_DEF_RESIZE_BILINEAR_FUNC(8u, uchar, int, ialpha, CV_NOP,
+                             ICV_WARP_MUL_ONE_8U, ICV_WARP_DESCALE_8U)
+ICV_DEF_RESIZE_BILINEAR_FUNC(16u, ushort, float, alpha, CV_NOP, CV_NOP,
+                             cvRound)
+ICV_DEF_RESIZE_BILINEAR_FUNC(16f, ushort, float, alpha, CV_16FTO32F, CV_NOP,
+                             CV_CAST_16F)
+ICV_DEF_RESIZE_BILINEAR_FUNC(32f, float, float, alpha, CV_NOP, CV_NOP, CV_NOP)
 
 ICV_DEF_RESIZE_BICUBIC_FUNC(8u, uchar, int, CV_8TO32F, cvRound, CV_CAST_8U)
 ICV_DEF_RESIZE_BICUBIC_FUNC(16u, ushort, int, CV_NOP, cvRound, CV_CAST_16U)
+ICV_DEF_RESIZE_BICUBIC_FUNC(16f, ushort, float, CV_16FTO32F, CV_NOP,
+                            CV_CAST_16F)
 ICV_DEF_RESIZE_BICUBIC_FUNC(32f, float, float, CV_NOP, CV_NOP, CV_NOP)
 
-ICV_DEF_RESIZE_AREA_FAST_FUNC(8u, uchar, int, cvRound)
-ICV_DEF_RESIZE_AREA_FAST_FUNC(16u, ushort, int, cvRound)
-ICV_DEF_RESIZE_AREA_FAST_FUNC(32f, float, float, CV_NOP)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(8u, uchar, int, CV_NOP, cvRound)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(16u, ushort, int, CV_NOP, cvRound)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(16f, ushort, float, CV_16FTO32F, CV_CAST_16F)
+ICV_DEF_RESIZE_AREA_FAST_FUNC(32f, float, float, CV_NOP, CV_NOP)
 
 ICV_DEF_RESIZE_AREA_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_RESIZE_AREA_FUNC(16u, ushort, CV_NOP, cvRound)
+ICV_DEF_RESIZE_AREA_FUNC(16f, ushort, CV_16FTO32F, CV_CAST_16F)
 ICV_DEF_RESIZE_AREA_FUNC(32f, float, CV_NOP, CV_NOP)
 
+/* The filtered resize (CV_INTER_LANCZOS3, CV_INTER_MITCHELL) filters the
+   source rows horizontally into a ring buffer of float rows and combines
+   ksize of them into every destination row. The horizontal functions compute
+   dst[dx*cn + c] as the weighted sum of the ksize pixels that start at the
+   source pixel xofs[dx]; 8u images use the fixed-point weights, so the
+   result does not depend on the order of the sums. xmax is used by the SIMD
+   versions only */
+static CvStatus CV_STDCALL icvResizeFilterHLine_8u_CnR(
+    const void* _src, float* dst, int width, int, const int* xofs,
+    const void* _alpha, int ksize, int cn)
+{
+    const uchar* src = (const uchar*)_src;
+    const short* alpha = (const short*)_alpha;
+    int dx, k, c;
+
+    for (dx = 0; dx < width; dx++, dst += cn, alpha += ksize)
+    {
+        const uchar* s = src + xofs[dx] * cn;
+
+        for (c = 0; c < cn; c++)
+        {
+            int sum = 0;
+            for (k = 0; k < ksize; k++)
+                sum += s[k * cn + c] * alpha[k];
+            dst[c] = sum * (1.f / (1 << ICV_RESIZE_FILTER_BITS));
+        }
+    }
+
+    return CV_OK;
+}
+
+#define ICV_DEF_RESIZE_FILTER_HLINE_FUNC(flavor, arrtype, load_macro)  \
+    static CvStatus CV_STDCALL icvResizeFilterHLine_##flavor##_CnR(    \
+        const void* _src, float* dst, int width, int, const int* xofs, \
+        const void* _alpha, int ksize, int cn)                         \
+    {                                                                  \
+        const arrtype* src = (const arrtype*)_src;                     \
+        const float* alpha = (const float*)_alpha;                     \
+        int dx, k, c;                                                  \
+                                                                       \
+        for (dx = 0; dx < width; dx++, dst += cn, alpha += ksize)      \
+        {                                                              \
+            const arrtype* s = src + xofs[dx] * cn;                    \
+                                                                       \
+            for (c = 0; c < cn; c++)                                   \
+            {                                                          \
+                float sum = 0;                                         \
+                for (k = 0; k < ksize; k++)                            \
+                    sum += load_macro(s[k * cn + c]) * alpha[k];       \
+                dst[c] = sum;                                          \
+            }                                                          \
+        }                                                              \
+                                                                       \
+        return CV_OK;                                                  \
+    }
+
+#define ICV_DEF_RESIZE_FILTER_VLINE_FUNC(flavor, arrtype, cast_macro1, \
+                                         cast_macro2)                  \
+    static CvStatus CV_STDCALL icvResizeFilterVLine_##flavor##_CnR(    \
+        const float** src, const float* beta, int ksize, void* _dst,   \
+        int width)                                                     \
+    {                                                                  \
+        arrtype* dst = (arrtype*)_dst;                                 \
+        int x, k;                                                      \
+                                                                       \
+        for (x = 0; x < width; x++)                                    \
+        {                                                              \
+            float sum = src[0][x] * beta[0];                           \
+            for (k = 1; k < ksize; k++)                                \
+                sum += src[k][x] * beta[k];                            \
+            dst[x] = (arrtype)cast_macro2(cast_macro1(sum));           \
+        }                                                              \
+                                                                       \
+        return CV_OK;                                                  \
+    }
+
+ICV_DEF_RESIZE_FILTER_HLINE_FUNC(16u, ushort, CV_NOP)
+ICV_DEF_RESIZE_FILTER_HLINE_FUNC(16f, ushort, CV_16FTO32F)
+ICV_DEF_RESIZE_FILTER_HLINE_FUNC(32f, float, CV_NOP)
+
+ICV_DEF_RESIZE_FILTER_VLINE_FUNC(8u, uchar, cvRound, CV_CAST_8U)
+ICV_DEF_RESIZE_FILTER_VLINE_FUNC(16u, ushort, cvRound, CV_CAST_16U)
+ICV_DEF_RESIZE_FILTER_VLINE_FUNC(16f, ushort, CV_NOP, CV_CAST_16F)
+ICV_DEF_RESIZE_FILTER_VLINE_FUNC(32f, float, CV_NOP, CV_NOP)
+
+typedef CvStatus(CV_STDCALL* CvResizeFilterHLineFunc)(
+    const void* src, float* dst, int width, int xmax, const int* xofs,
+    const void* alpha, int ksize, int channels);
+
+typedef CvStatus(CV_STDCALL* CvResizeFilterVLineFunc)(const float** src,
+                                                      const float* beta,
+                                                      int ksize, void* dst,
+                                                      int width);
+
+static double icvResizeFilterKernel(int method, double x)
+{
+    x = fabs(x);
+
+    if (method == CV_INTER_LANCZOS3)
+    {
+        if (x < DBL_EPSILON)
+            return 1.;
+        if (x >= 3)
+            return 0.;
+        x *= CV_PI;
+        return 3 * sin(x) * sin(x / 3) / (x * x);
+    }
+
+    // Mitchell-Netravali filter, B = C = 1/3
+    if (x < 1)
+        return ((7 * x - 12) * x * x + 16. / 3) / 6;
+    if (x < 2)
+        return (((-7. / 3 * x + 12) * x - 20) * x + 32. / 3) / 6;
+    return 0.;
+}
+
+/* The number of source pixels under the filter; the filter is stretched by
+   the downscaling factor */
+static int icvResizeFilterTaps(int ssize, int dsize, int method)
+{
+    double scale = (double)ssize / dsize;
+    int radius = method == CV_INTER_LANCZOS3 ? 3 : 2;
+
+    return cvCeil(radius * MAX(scale, 1.)) * 2;
+}
+
+/* Computes the first source pixel and the normalized weights of every
+   destination pixel along one axis, and their fixed-point form if ialpha is
+   not 0. The windows of ksize pixels are shifted inside the source and the
+   weights of the taps beyond the border go to the border pixel. Returns the
+   number of leading destination pixels whose windows end two pixels before
+   the last source pixel or earlier: the SIMD versions may read that far and
+   take the taps in pairs, so it is 0 for odd ksize */
+static int icvResizeFilterInitTab(int ssize, int dsize, int method,
+                                  int ksize, int* ofs, float* alpha,
+                                  short* ialpha)
+{
+    double scale = (double)ssize / dsize, fscale = MAX(scale, 1.);
+    int taps = icvResizeFilterTaps(ssize, dsize, method);
+    int d, i, xmax = 0;
+
+    for (d = 0; d < dsize; d++, alpha += ksize)
+    {
+        double center = (d + 0.5) * scale - 0.5, sum = 0;
+        int left = cvFloor(center) - taps / 2 + 1;
+        int start = MIN(MAX(left, 0), ssize - ksize);
+
+        for (i = 0; i < ksize; i++)
+            alpha[i] = 0;
+
+        for (i = 0; i < taps; i++)
+        {
+            int x = left + i;
+            double w = icvResizeFilterKernel(method, (x - center) / fscale);
+            x = x < 0 ? 0 : x >= ssize ? ssize - 1 : x;
+            alpha[x - start] += (float)w;
+            sum += w;
+        }
+
+        for (i = 0; i < ksize; i++)
+            alpha[i] = (float)(alpha[i] / sum);
+
+        if (ialpha)
+        {
+            // the fixed-point weights must add up to one exactly;
+            // the rounding error goes to the largest of them
+            int isum = 0, imax = 0;
+            for (i = 0; i < ksize; i++)
+            {
+                ialpha[i] = (short)cvRound(alpha[i]
+                                           * (1 << ICV_RESIZE_FILTER_BITS));
+                isum += ialpha[i];
+                if (ialpha[i] > ialpha[imax])
+                    imax = i;
+            }
+            ialpha[imax] =
+                (short)(ialpha[imax] + (1 << ICV_RESIZE_FILTER_BITS) - isum);
+            ialpha += ksize;
+        }
+
+        ofs[d] = start;
+        if (start + ksize + 1 < ssize)
+            xmax = d + 1;
+    }
+
+    return ksize % 2 == 0 ? xmax : 0;
+}
+
 static void icvInitResizeTab(CvFuncTable* bilin_tab, CvFuncTable* bicube_tab,
-                             CvFuncTable* areafast_tab, CvFuncTable* area_tab)
+                             CvFuncTable* areafast_tab, CvFuncTable* area_tab,
+                             CvFuncTable* filter_hline_tab,
+                             CvFuncTable* filter_vline_tab)
 {
     bilin_tab->fn_2d[CV_8U] = (void*)icvResize_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvResize_Bilinear_16u_CnR;
+    bilin_tab->fn_2d[CV_16F] = (void*)icvResize_Bilinear_16f_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvResize_Bilinear_32f_CnR;
 
     bicube_tab->fn_2d[CV_8U] = (void*)icvResize_Bicubic_8u_CnR;
     bicube_tab->fn_2d[CV_16U] = (void*)icvResize_Bicubic_16u_CnR;
+    bicube_tab->fn_2d[CV_16F] = (void*)icvResize_Bicubic_16f_CnR;
     bicube_tab->fn_2d[CV_32F] = (void*)icvResize_Bicubic_32f_CnR;
 
     areafast_tab->fn_2d[CV_8U] = (void*)icvResize_AreaFast_8u_CnR;
     areafast_tab->fn_2d[CV_16U] = (void*)icvResize_AreaFast_16u_CnR;
+    areafast_tab->fn_2d[CV_16F] = (void*)icvResize_AreaFast_16f_CnR;
     areafast_tab->fn_2d[CV_32F] = (void*)icvResize_AreaFast_32f_CnR;
 
     area_tab->fn_2d[CV_8U] = (void*)icvResize_Area_8u_CnR;
     area_tab->fn_2d[CV_16U] = (void*)icvResize_Area_16u_CnR;
+    area_tab->fn_2d[CV_16F] = (void*)icvResize_Area_16f_CnR;
     area_tab->fn_2d[CV_32F] = (void*)icvResize_Area_32f_CnR;
+
+    filter_hline_tab->fn_2d[CV_8U] = (void*)icvResizeFilterHLine_8u_CnR;
+    filter_hline_tab->fn_2d[CV_16U] = (void*)icvResizeFilterHLine_16u_CnR;
+    filter_hline_tab->fn_2d[CV_16F] = (void*)icvResizeFilterHLine_16f_CnR;
+    filter_hline_tab->fn_2d[CV_32F] = (void*)icvResizeFilterHLine_32f_CnR;
+
+    filter_vline_tab->fn_2d[CV_8U] = (void*)icvResizeFilterVLine_8u_CnR;
+    filter_vline_tab->fn_2d[CV_16U] = (void*)icvResizeFilterVLine_16u_CnR;
+    filter_vline_tab->fn_2d[CV_16F] = (void*)icvResizeFilterVLine_16f_CnR;
+    filter_vline_tab->fn_2d[CV_32F] = (void*)icvResizeFilterVLine_32f_CnR;
 }
 
 typedef CvStatus(CV_STDCALL* CvResizeBilinearFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
     CvSize dsize, int cn, int xmax, const CvResizeAlpha* xofs,
-    const CvResizeAlpha* yofs, float* buf0, float* buf1);
+    const CvResizeAlpha* yofs, float* buf0, float* buf1, CvSlice rows,
+    const void* vline);
 
-typedef CvStatus(CV_STDCALL* CvResizeBicubicFunc)(const void* src, int srcstep,
-                                                  CvSize ssize, void* dst,
-                                                  int dststep, CvSize dsize,
-                                                  int cn, int xmin, int xmax,
-                                                  const CvResizeAlpha* xofs,
-                                                  float** buf);
+typedef CvStatus(CV_STDCALL* CvResizeBicubicFunc)(
+    const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
+    CvSize dsize, int cn, int xmin, int xmax, const CvResizeAlpha* xofs,
+    float** buf, CvSlice rows);
 
-typedef CvStatus(CV_STDCALL* CvResizeAreaFastFunc)(const void* src, int srcstep,
-                                                   CvSize ssize, void* dst,
-                                                   int dststep, CvSize dsize,
-                                                   int cn, const int* ofs,
-                                                   const int* xofs);
+typedef CvStatus(CV_STDCALL* CvResizeAreaFastFunc)(
+    const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
+    CvSize dsize, int cn, const int* ofs, const int* xofs, CvSlice rows);
 
 typedef CvStatus(CV_STDCALL* CvResizeAreaFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
@@ -636,6 +859,23 @@ icvResize_32f_C1R_t icvResize_32f_C1R_p = 0;
 icvResize_32f_C3R_t icvResize_32f_C3R_p = 0;
 icvResize_32f_C4R_t icvResize_32f_C4R_p = 0;
 
+icvResizeFilterHLine_8u_C1R_t icvResizeFilterHLine_8u_C1R_p = 0;
+icvResizeFilterHLine_8u_C3R_t icvResizeFilterHLine_8u_C3R_p = 0;
+icvResizeFilterHLine_8u_C4R_t icvResizeFilterHLine_8u_C4R_p = 0;
+icvResizeFilterHLine_16u_C1R_t icvResizeFilterHLine_16u_C1R_p = 0;
+icvResizeFilterHLine_16u_C3R_t icvResizeFilterHLine_16u_C3R_p = 0;
+icvResizeFilterHLine_16u_C4R_t icvResizeFilterHLine_16u_C4R_p = 0;
+icvResizeFilterHLine_32f_C1R_t icvResizeFilterHLine_32f_C1R_p = 0;
+icvResizeFilterHLine_32f_C3R_t icvResizeFilterHLine_32f_C3R_p = 0;
+icvResizeFilterHLine_32f_C4R_t icvResizeFilterHLine_32f_C4R_p = 0;
+
+icvResizeFilterVLine_8u_C1R_t icvResizeFilterVLine_8u_C1R_p = 0;
+icvResizeFilterVLine_16u_C1R_t icvResizeFilterVLine_16u_C1R_p = 0;
+icvResizeFilterVLine_32f_C1R_t icvResizeFilterVLine_32f_C1R_p = 0;
+
+icvResizeBilinearVLine_8u_C1R_t icvResizeBilinearVLine_8u_C1R_p = 0;
+icvResizeBilinearVLine_32f_C1R_t icvResizeBilinearVLine_32f_C1R_p = 0;
+
 typedef CvStatus(CV_STDCALL* CvResizeIPPFunc)(const void* src, CvSize srcsize,
                                               int srcstep, CvRect srcroi,
                                               void* dst, int dststep,
@@ -643,84 +883,254 @@ typedef CvStatus(CV_STDCALL* CvResizeIPPFunc)(const void* src, CvSize srcsize,
                                               double yfactor,
                                               int interpolation);
 
-//////////////////////////////////////////////////////////////////////////////////////////
+/* The arguments of the resize functions shared by the bands of destination
+   rows that cvParallelFor hands out */
+typedef struct CvResizeBand
+{
+    const uchar* src;
+    int srcstep;
+    CvSize ssize;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    int cn, width, pix_size;
+    int xmin, xmax;
+    const CvResizeAlpha* xofs;
+    const CvResizeAlpha* yofs;
+    const int* ofs;
+    const int* iofs;
+    const CvDecimateAlpha* area_ofs;
+    int area_count;
+    void* func;
+    const void* vline;
+} CvResizeBand;
+
+static int CV_CDECL icvResizeNNBand(int y0, int y1, void* arg)
+{
+    const CvResizeBand* p = (const CvResizeBand*)arg;
 
-CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
+    return icvResize_NN_8u_C1R(p->src, p->srcstep, p->ssize, p->dst,
+                               p->dststep, p->dsize, p->pix_size,
+                               cvSlice(y0, y1));
+}
+
+static int CV_CDECL icvResizeAreaFastBand(int y0, int y1, void* arg)
+{
+    const CvResizeBand* p = (const CvResizeBand*)arg;
+
+    return ((CvResizeAreaFastFunc)p->func)(p->src, p->srcstep, p->ssize,
+                                           p->dst, p->dststep, p->dsize, p->cn,
+                                           p->ofs, p->iofs, cvSlice(y0, y1));
+}
+
+/* the general "area" method accumulates all the source rows in one pass,
+   so it always gets the whole image */
+static int CV_CDECL icvResizeAreaBand(int y0, int y1, void* arg)
+{
+    const CvResizeBand* p = (const CvResizeBand*)arg;
+    int buf_len = p->width + 4;
+    float* buf = (float*)cvAlloc(buf_len * 2 * sizeof(buf[0]));
+    CvStatus status;
+
+    assert(y0 == 0 && y1 == p->dsize.height);
+
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+    memset(buf, 0, buf_len * 2 * sizeof(buf[0]));
+
+    status = ((CvResizeAreaFunc)p->func)(p->src, p->srcstep, p->ssize, p->dst,
+                                         p->dststep, p->dsize, p->cn,
+                                         p->area_ofs, p->area_count, buf,
+                                         buf + buf_len);
+
+    cvFree(&buf);
+    return status;
+}
+
+static int CV_CDECL icvResizeBilinearBand(int y0, int y1, void* arg)
+{
+    const CvResizeBand* p = (const CvResizeBand*)arg;
+    float* buf = (float*)cvAlloc(p->width * 2 * sizeof(buf[0]));
+    CvStatus status;
+
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+
+    status = ((CvResizeBilinearFunc)p->func)(
+        p->src, p->srcstep, p->ssize, p->dst, p->dststep, p->dsize, p->cn,
+        p->xmax, p->xofs, p->yofs, buf, buf + p->width, cvSlice(y0, y1),
+        p->vline);
+
+    cvFree(&buf);
+    return status;
+}
+
+static int CV_CDECL icvResizeBicubicBand(int y0, int y1, void* arg)
+{
+    const CvResizeBand* p = (const CvResizeBand*)arg;
+    float* rows = (float*)cvAlloc(p->width * 4 * sizeof(rows[0]));
+    float* buf[4];
+    CvStatus status;
+    int k;
+
+    if (!rows)
+        return CV_OUTOFMEM_ERR;
+    for (k = 0; k < 4; k++)
+        buf[k] = rows + k * p->width;
+
+    // the function rotates buf[] as it moves down the source rows
+    status = ((CvResizeBicubicFunc)p->func)(
+        p->src, p->srcstep, p->ssize, p->dst, p->dststep, p->dsize, p->cn,
+        p->xmin, p->xmax, p->xofs, buf, cvSlice(y0, y1));
+
+    cvFree(&rows);
+    return status;
+}
+
+/* The bands of the filtered resize keep their own ring of yksize
+   horizontally filtered source rows */
+typedef struct CvResizeFilterBand
+{
+    const uchar* src;
+    int srcstep;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    int cn;
+    int xksize, yksize, xmax;
+    const int* xofs;
+    const int* yofs;
+    const void* alpha;
+    const float* beta;
+    CvResizeFilterHLineFunc hline;
+    CvResizeFilterVLineFunc vline;
+} CvResizeFilterBand;
+
+static int CV_CDECL icvResizeFilterBand(int y0, int y1, void* arg)
+{
+    const CvResizeFilterBand* p = (const CvResizeFilterBand*)arg;
+    int width = p->dsize.width * p->cn, ksize = p->yksize;
+    int dy, k, sy, next_sy = 0;
+    const float** rows;
+    float* ring;
+
+    rows = (const float**)cvAlloc(ksize * sizeof(rows[0])
+                                  + width * ksize * sizeof(ring[0]));
+    if (!rows)
+        return CV_OUTOFMEM_ERR;
+    ring = (float*)(rows + ksize);
+
+    for (dy = y0; dy < y1; dy++)
+    {
+        int sy0 = p->yofs[dy];
+
+        // the ring holds the source rows next_sy - ksize ... next_sy - 1;
+        // the windows of the successive destination rows only move down
+        for (sy = MAX(sy0, next_sy); sy < sy0 + ksize; sy++)
+            p->hline(p->src + sy * p->srcstep, ring + (sy % ksize) * width,
+                     p->dsize.width, p->xmax, p->xofs, p->alpha, p->xksize,
+                     p->cn);
+        next_sy = sy0 + ksize;
+
+        for (k = 0; k < ksize; k++)
+            rows[k] = ring + ((sy0 + k) % ksize) * width;
+
+        p->vline(rows, p->beta + dy * ksize, ksize,
+                 p->dst + dy * p->dststep, width);
+    }
+
+    cvFree(&rows);
+    return CV_OK;
+}
+
+/* The prepared resize of one image size and type: the tables of the method
+   and the band function that cvParallelFor runs over the destination rows.
+   src_rows keeps the source rows [lo, hi) that every destination row reads,
+   so the resize may also be run on the bands of a streamed image */
+struct CvResizeState
+{
+    CvResizeBand band;
+    CvResizeFilterBand fband;
+    CvParallelLoopBody func;
+    void* arg;
+    int whole;
+    int srcstep;
+    int* src_rows;
+    void* buf;
+};
+
+void icvReleaseResizeState(CvResizeState** state)
+{
+    if (state && *state)
+    {
+        cvFree(&(*state)->buf);
+        cvFree(state);
+    }
+}
+
+CvResizeState* icvCreateResizeState(CvSize ssize, CvSize dsize, int type,
+                                    int srcstep, int method)
 {
     static CvFuncTable bilin_tab, bicube_tab, areafast_tab, area_tab;
+    static CvFuncTable filter_hline_tab, filter_vline_tab;
     static int inittab = 0;
-    void* temp_buf = 0;
+    CvResizeState* state = 0;
 
-    CV_FUNCNAME("cvResize");
+    CV_FUNCNAME("icvCreateResizeState");
 
     __BEGIN__;
 
-    CvMat srcstub, *src = (CvMat*)srcarr;
-    CvMat dststub, *dst = (CvMat*)dstarr;
-    CvSize ssize, dsize;
+    CvResizeBand* band;
+    int* src_rows;
     float scale_x, scale_y;
     int k, sx, sy, dx, dy;
-    int type, depth, cn;
+    int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
 
-    CV_CALL(src = cvGetMat(srcarr, &srcstub));
-    CV_CALL(dst = cvGetMat(dstarr, &dststub));
-
-    if (CV_ARE_SIZES_EQ(src, dst))
-        CV_CALL(cvCopy(src, dst));
-
-    if (!CV_ARE_TYPES_EQ(src, dst))
-        CV_ERROR(CV_StsUnmatchedFormats, "");
+    if (ssize.width <= 0 || ssize.height <= 0 || dsize.width <= 0
+        || dsize.height <= 0)
+        CV_ERROR(CV_StsBadSize, "");
 
     if (!inittab)
     {
-        icvInitResizeTab(&bilin_tab, &bicube_tab, &areafast_tab, &area_tab);
+        icvInitResizeTab(&bilin_tab, &bicube_tab, &areafast_tab, &area_tab,
+                         &filter_hline_tab, &filter_vline_tab);
         inittab = 1;
     }
 
-    ssize = cvGetMatSize(src);
-    dsize = cvGetMatSize(dst);
-    type = CV_MAT_TYPE(src->type);
-    depth = CV_MAT_DEPTH(type);
-    cn = CV_MAT_CN(type);
+    CV_CALL(state = (CvResizeState*)cvAlloc(
+                sizeof(*state) + dsize.height * 2 * sizeof(src_rows[0])));
+    memset(state, 0, sizeof(*state));
+    state->src_rows = src_rows = (int*)(state + 1);
+    state->srcstep = srcstep;
+
     scale_x = (float)ssize.width / dsize.width;
     scale_y = (float)ssize.height / dsize.height;
 
+    band = &state->band;
+    band->ssize = ssize;
+    band->dsize = dsize;
+    band->cn = cn;
+    band->width = dsize.width * cn;
+    band->pix_size = CV_ELEM_SIZE(type);
+    state->arg = band;
+
     if (method == CV_INTER_CUBIC
         && (MIN(ssize.width, dsize.width) <= 4
             || MIN(ssize.height, dsize.height) <= 4))
         method = CV_INTER_LINEAR;
 
-    if (icvResize_8u_C1R_p && MIN(ssize.width, dsize.width) > 4
-        && MIN(ssize.height, dsize.height) > 4)
+    if (method == CV_INTER_NN)
     {
-        CvResizeIPPFunc ipp_func = type == CV_8UC1    ? icvResize_8u_C1R_p
-                                   : type == CV_8UC3  ? icvResize_8u_C3R_p
-                                   : type == CV_8UC4  ? icvResize_8u_C4R_p
-                                   : type == CV_16UC1 ? icvResize_16u_C1R_p
-                                   : type == CV_16UC3 ? icvResize_16u_C3R_p
-                                   : type == CV_16UC4 ? icvResize_16u_C4R_p
-                                   : type == CV_32FC1 ? icvResize_32f_C1R_p
-                                   : type == CV_32FC3 ? icvResize_32f_C3R_p
-                                   : type == CV_32FC4 ? icvResize_32f_C4R_p
-                                                      : 0;
-        if (ipp_func && (CV_INTER_NN < method && method < CV_INTER_AREA))
+        for (dy = 0; dy < dsize.height; dy++)
         {
-            int srcstep = src->step ? src->step : CV_STUB_STEP;
-            int dststep = dst->step ? dst->step : CV_STUB_STEP;
-            IPPI_CALL(
-                ipp_func(src->data.ptr, ssize, srcstep,
-                         cvRect(0, 0, ssize.width, ssize.height), dst->data.ptr,
-                         dststep, dsize, (double)dsize.width / ssize.width,
-                         (double)dsize.height / ssize.height, 1 << method));
-            EXIT;
+            sy = (ssize.height * dy * 2 + MIN(ssize.height, dsize.height) - 1)
+                 / (dsize.height * 2);
+            sy -= sy >= ssize.height;
+            src_rows[dy * 2] = sy;
+            src_rows[dy * 2 + 1] = sy + 1;
         }
-    }
 
-    if (method == CV_INTER_NN)
-    {
-        IPPI_CALL(icvResize_NN_8u_C1R(src->data.ptr, src->step, ssize,
-                                      dst->data.ptr, dst->step, dsize,
-                                      CV_ELEM_SIZE(src->type)));
+        state->func = icvResizeNNBand;
     }
     else if (method == CV_INTER_LINEAR || method == CV_INTER_AREA)
     {
@@ -735,16 +1145,19 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                 && fabs(scale_y - iscale_y) < DBL_EPSILON)
             {
                 int area = iscale_x * iscale_y;
-                int srcstep = src->step / CV_ELEM_SIZE(depth);
-                int* ofs =
-                    (int*)cvStackAlloc((area + dsize.width * cn) * sizeof(int));
-                int* xofs = ofs + area;
+                int* ofs;
+                int* xofs;
                 CvResizeAreaFastFunc func =
                     (CvResizeAreaFastFunc)areafast_tab.fn_2d[depth];
 
                 if (!func)
                     CV_ERROR(CV_StsUnsupportedFormat, "");
 
+                CV_CALL(state->buf = ofs = (int*)cvAlloc(
+                            (area + dsize.width * cn) * sizeof(int)));
+                xofs = ofs + area;
+
+                srcstep /= CV_ELEM_SIZE(depth);
                 for (sy = 0, k = 0; sy < iscale_y; sy++)
                     for (sx = 0; sx < iscale_x; sx++)
                         ofs[k++] = sy * srcstep + sx * cn;
@@ -756,28 +1169,28 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                         xofs[dx * cn + k] = sx + k;
                 }
 
-                IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                               dst->step, dsize, cn, ofs, xofs));
+                for (dy = 0; dy < dsize.height; dy++)
+                {
+                    src_rows[dy * 2] = dy * iscale_y;
+                    src_rows[dy * 2 + 1] = (dy + 1) * iscale_y;
+                }
+
+                band->ofs = ofs;
+                band->iofs = xofs;
+                band->func = (void*)func;
+                state->func = icvResizeAreaFastBand;
             }
             else
             {
-                int buf_len = dsize.width * cn + 4, buf_size, xofs_count = 0;
                 float scale = 1.f / (scale_x * scale_y);
-                float *buf, *sum;
                 CvDecimateAlpha* xofs;
                 CvResizeAreaFunc func = (CvResizeAreaFunc)area_tab.fn_2d[depth];
 
                 if (!func || cn > 4)
                     CV_ERROR(CV_StsUnsupportedFormat, "");
 
-                buf_size = buf_len * 2 * sizeof(float)
-                           + ssize.width * 2 * sizeof(CvDecimateAlpha);
-                if (buf_size < CV_MAX_LOCAL_SIZE)
-                    buf = (float*)cvStackAlloc(buf_size);
-                else
-                    CV_CALL(temp_buf = buf = (float*)cvAlloc(buf_size));
-                sum = buf + buf_len;
-                xofs = (CvDecimateAlpha*)(sum + buf_len);
+                CV_CALL(state->buf = xofs = (CvDecimateAlpha*)cvAlloc(
+                            ssize.width * 2 * sizeof(CvDecimateAlpha)));
 
                 for (dx = 0, k = 0; dx < dsize.width; dx++)
                 {
@@ -812,13 +1225,19 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                     }
                 }
 
-                xofs_count = k;
-                memset(sum, 0, buf_len * sizeof(float));
-                memset(buf, 0, buf_len * sizeof(float));
+                // the source rows are shared by the neighbor destination
+                // rows; the function needs them all in one call
+                for (dy = 0; dy < dsize.height; dy++)
+                {
+                    src_rows[dy * 2] = 0;
+                    src_rows[dy * 2 + 1] = ssize.height;
+                }
 
-                IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                               dst->step, dsize, cn, xofs, xofs_count, buf,
-                               sum));
+                band->area_ofs = xofs;
+                band->area_count = k;
+                band->func = (void*)func;
+                state->func = icvResizeAreaBand;
+                state->whole = 1;
             }
         }
         else // true "area" method for the cases (scale_x > 1 & scale_y < 1) and
@@ -828,8 +1247,7 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
         {
             float inv_scale_x = (float)dsize.width / ssize.width;
             float inv_scale_y = (float)dsize.height / ssize.height;
-            int xmax = dsize.width, width = dsize.width * cn, buf_size;
-            float *buf0, *buf1;
+            int xmax = dsize.width, width = dsize.width * cn;
             CvResizeAlpha *xofs, *yofs;
             int area_mode = method == CV_INTER_AREA;
             float fx, fy;
@@ -839,14 +1257,8 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
             if (!func)
                 CV_ERROR(CV_StsUnsupportedFormat, "");
 
-            buf_size = width * 2 * sizeof(float)
-                       + (width + dsize.height) * sizeof(CvResizeAlpha);
-            if (buf_size < CV_MAX_LOCAL_SIZE)
-                buf0 = (float*)cvStackAlloc(buf_size);
-            else
-                CV_CALL(temp_buf = buf0 = (float*)cvAlloc(buf_size));
-            buf1 = buf0 + width;
-            xofs = (CvResizeAlpha*)(buf1 + width);
+            CV_CALL(state->buf = xofs = (CvResizeAlpha*)cvAlloc(
+                        (width + dsize.height) * sizeof(CvResizeAlpha)));
             yofs = xofs + width;
 
             for (dx = 0; dx < dsize.width; dx++)
@@ -907,32 +1319,34 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                     yofs[dy].alpha = fy;
                 else
                     yofs[dy].ialpha = CV_FLT_TO_FIX(fy, ICV_WARP_SHIFT);
+
+                src_rows[dy * 2] = sy;
+                src_rows[dy * 2 + 1] = MIN(sy + 2, ssize.height);
             }
 
-            IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                           dst->step, dsize, cn, xmax, xofs, yofs, buf0, buf1));
+            band->xmax = xmax;
+            band->xofs = xofs;
+            band->yofs = yofs;
+            band->func = (void*)func;
+            if (depth == CV_8U)
+                band->vline = (const void*)icvResizeBilinearVLine_8u_C1R_p;
+            else if (depth == CV_32F)
+                band->vline = (const void*)icvResizeBilinearVLine_32f_C1R_p;
+            state->func = icvResizeBilinearBand;
         }
     }
     else if (method == CV_INTER_CUBIC)
     {
-        int width = dsize.width * cn, buf_size;
+        int width = dsize.width * cn;
         int xmin = dsize.width, xmax = -1;
         CvResizeAlpha* xofs;
-        float* buf[4];
         CvResizeBicubicFunc func = (CvResizeBicubicFunc)bicube_tab.fn_2d[depth];
 
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        buf_size = width * (4 * sizeof(float) + sizeof(xofs[0]));
-        if (buf_size < CV_MAX_LOCAL_SIZE)
-            buf[0] = (float*)cvStackAlloc(buf_size);
-        else
-            CV_CALL(temp_buf = buf[0] = (float*)cvAlloc(buf_size));
-
-        for (k = 1; k < 4; k++)
-            buf[k] = buf[k - 1] + width;
-        xofs = (CvResizeAlpha*)(buf[3] + width);
+        CV_CALL(state->buf = xofs =
+                    (CvResizeAlpha*)cvAlloc(width * sizeof(xofs[0])));
 
         icvInitCubicCoeffTab();
 
@@ -963,15 +1377,212 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
             }
         }
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, cn, xmin, xmax, xofs, buf));
+        for (dy = 0; dy < dsize.height; dy++)
+        {
+            sy = cvFloor(dy * scale_y);
+            src_rows[dy * 2] = MAX(sy - 1, 0);
+            src_rows[dy * 2 + 1] = MIN(sy + 3, ssize.height);
+        }
+
+        band->xmin = xmin;
+        band->xmax = xmax;
+        band->xofs = xofs;
+        band->func = (void*)func;
+        state->func = icvResizeBicubicBand;
+    }
+    else if (method == CV_INTER_LANCZOS3 || method == CV_INTER_MITCHELL)
+    {
+        CvResizeFilterBand* fband = &state->fband;
+        int xksize = icvResizeFilterTaps(ssize.width, dsize.width, method);
+        int yksize = icvResizeFilterTaps(ssize.height, dsize.height, method);
+        CvResizeFilterHLineFunc hline =
+            type == CV_8UC1    ? icvResizeFilterHLine_8u_C1R_p
+            : type == CV_8UC3  ? icvResizeFilterHLine_8u_C3R_p
+            : type == CV_8UC4  ? icvResizeFilterHLine_8u_C4R_p
+            : type == CV_16UC1 ? icvResizeFilterHLine_16u_C1R_p
+            : type == CV_16UC3 ? icvResizeFilterHLine_16u_C3R_p
+            : type == CV_16UC4 ? icvResizeFilterHLine_16u_C4R_p
+            : type == CV_32FC1 ? icvResizeFilterHLine_32f_C1R_p
+            : type == CV_32FC3 ? icvResizeFilterHLine_32f_C3R_p
+            : type == CV_32FC4 ? icvResizeFilterHLine_32f_C4R_p
+                               : 0;
+        CvResizeFilterVLineFunc vline =
+            depth == CV_8U    ? icvResizeFilterVLine_8u_C1R_p
+            : depth == CV_16U ? icvResizeFilterVLine_16u_C1R_p
+            : depth == CV_32F ? icvResizeFilterVLine_32f_C1R_p
+                              : 0;
+        int* xofs;
+        float *alpha, *beta;
+        short* ialpha = 0;
+
+        if (!hline)
+            hline = (CvResizeFilterHLineFunc)filter_hline_tab.fn_2d[depth];
+        if (!vline)
+            vline = (CvResizeFilterVLineFunc)filter_vline_tab.fn_2d[depth];
+        if (!hline || !vline)
+            CV_ERROR(CV_StsUnsupportedFormat, "");
+
+        xksize = MIN(xksize, ssize.width);
+        yksize = MIN(yksize, ssize.height);
+
+        CV_CALL(state->buf = xofs = (int*)cvAlloc(
+                    (dsize.width + dsize.height) * sizeof(xofs[0])
+                    + (dsize.width * xksize + dsize.height * yksize)
+                          * sizeof(alpha[0])
+                    + dsize.width * xksize * sizeof(ialpha[0])));
+        alpha = (float*)(xofs + dsize.width + dsize.height);
+        beta = alpha + dsize.width * xksize;
+        if (depth == CV_8U)
+            ialpha = (short*)(beta + dsize.height * yksize);
+
+        fband->dsize = dsize;
+        fband->cn = cn;
+        fband->xksize = xksize;
+        fband->yksize = yksize;
+        fband->xofs = xofs;
+        fband->yofs = xofs + dsize.width;
+        fband->alpha = ialpha ? (const void*)ialpha : (const void*)alpha;
+        fband->beta = beta;
+        fband->hline = hline;
+        fband->vline = vline;
+        fband->xmax = icvResizeFilterInitTab(ssize.width, dsize.width, method,
+                                             xksize, xofs, alpha, ialpha);
+        icvResizeFilterInitTab(ssize.height, dsize.height, method, yksize,
+                               xofs + dsize.width, beta, 0);
+
+        for (dy = 0; dy < dsize.height; dy++)
+        {
+            src_rows[dy * 2] = fband->yofs[dy];
+            src_rows[dy * 2 + 1] = fband->yofs[dy] + yksize;
+        }
+
+        state->func = icvResizeFilterBand;
+        state->arg = fband;
     }
     else
         CV_ERROR(CV_StsBadFlag, "Unknown/unsupported interpolation method");
 
     __END__;
 
-    cvFree(&temp_buf);
+    if (cvGetErrStatus() < 0)
+        icvReleaseResizeState(&state);
+
+    return state;
+}
+
+CvSlice icvResizeSourceRows(const CvResizeState* state, CvSlice rows)
+{
+    CvSlice src_rows = cvSlice(INT_MAX, 0);
+    int dy;
+
+    for (dy = rows.start_index; dy < rows.end_index; dy++)
+    {
+        src_rows.start_index = MIN(src_rows.start_index,
+                                   state->src_rows[dy * 2]);
+        src_rows.end_index = MAX(src_rows.end_index,
+                                 state->src_rows[dy * 2 + 1]);
+    }
+
+    return src_rows;
+}
+
+CvStatus icvResizeRows(CvResizeState* state, const uchar* src, int srcstep,
+                       int src_y0, uchar* dst, int dststep, CvSlice rows)
+{
+    CvResizeBand* band = &state->band;
+    CvResizeFilterBand* fband = &state->fband;
+    CvSize dsize = band->dsize;
+
+    // the band functions address the rows by their indices in the whole
+    // images, so the buffers are passed via the (virtual) pointers to their
+    // row 0
+    src -= src_y0 * srcstep;
+    dst -= rows.start_index * dststep;
+
+    // the offsets of the fast "area" method include the source step
+    assert(state->func != icvResizeAreaFastBand || srcstep == state->srcstep);
+
+    band->src = fband->src = src;
+    band->srcstep = fband->srcstep = srcstep;
+    band->dst = fband->dst = dst;
+    band->dststep = fband->dststep = dststep;
+
+    if (state->whole)
+        return (CvStatus)state->func(0, dsize.height, state->arg);
+
+    return (CvStatus)cvParallelFor(rows, state->func, state->arg,
+                                   CV_PARALLEL_GRAIN(dsize.width));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
+{
+    CvResizeState* state = 0;
+
+    CV_FUNCNAME("cvResize");
+
+    __BEGIN__;
+
+    CvMat srcstub, *src = (CvMat*)srcarr;
+    CvMat dststub, *dst = (CvMat*)dstarr;
+    CvSize ssize, dsize;
+    int type;
+
+    CV_CALL(src = cvGetMat(srcarr, &srcstub));
+    CV_CALL(dst = cvGetMat(dstarr, &dststub));
+
+    if (CV_ARE_SIZES_EQ(src, dst))
+        CV_CALL(cvCopy(src, dst));
+
+    if (!CV_ARE_TYPES_EQ(src, dst))
+        CV_ERROR(CV_StsUnmatchedFormats, "");
+
+    ssize = cvGetMatSize(src);
+    dsize = cvGetMatSize(dst);
+    type = CV_MAT_TYPE(src->type);
+
+    if (method == CV_INTER_CUBIC
+        && (MIN(ssize.width, dsize.width) <= 4
+            || MIN(ssize.height, dsize.height) <= 4))
+        method = CV_INTER_LINEAR;
+
+    if (icvResize_8u_C1R_p && MIN(ssize.width, dsize.width) > 4
+        && MIN(ssize.height, dsize.height) > 4)
+    {
+        CvResizeIPPFunc ipp_func = type == CV_8UC1    ? icvResize_8u_C1R_p
+                                   : type == CV_8UC3  ? icvResize_8u_C3R_p
+                                   : type == CV_8UC4  ? icvResize_8u_C4R_p
+                                   : type == CV_16UC1 ? icvResize_16u_C1R_p
+                                   : type == CV_16UC3 ? icvResize_16u_C3R_p
+                                   : type == CV_16UC4 ? icvResize_16u_C4R_p
+                                   : type == CV_32FC1 ? icvResize_32f_C1R_p
+                                   : type == CV_32FC3 ? icvResize_32f_C3R_p
+                                   : type == CV_32FC4 ? icvResize_32f_C4R_p
+                                                      : 0;
+        if (ipp_func && (CV_INTER_NN < method && method < CV_INTER_AREA))
+        {
+            int srcstep = src->step ? src->step : CV_STUB_STEP;
+            int dststep = dst->step ? dst->step : CV_STUB_STEP;
+            CvStatus status =
+                ipp_func(src->data.ptr, ssize, srcstep,
+                         cvRect(0, 0, ssize.width, ssize.height), dst->data.ptr,
+                         dststep, dsize, (double)dsize.width / ssize.width,
+                         (double)dsize.height / ssize.height, 1 << method);
+            // the built-in functions do not implement all the methods
+            if (status >= 0)
+                EXIT;
+        }
+    }
+
+    CV_CALL(state = icvCreateResizeState(ssize, dsize, type, src->step,
+                                         method));
+    IPPI_CALL(icvResizeRows(state, src->data.ptr, src->step, 0, dst->data.ptr,
+                            dst->step, cvSlice(0, dsize.height)));
+
+    __END__;
+
+    icvReleaseResizeState(&state);
 }
 
 /****************************************************************************************\
@@ -979,12 +1590,13 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
 \****************************************************************************************/
 
 #define ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(flavor, arrtype, worktype,           \
-                                          scale_alpha_macro, mul_one_macro,    \
-                                          descale_macro, cast_macro)           \
+                                          load_macro, scale_alpha_macro,       \
+                                          mul_one_macro, descale_macro,        \
+                                          cast_macro)                          \
     static CvStatus CV_STDCALL icvWarpAffine_Bilinear_##flavor##_CnR(          \
         const arrtype* src, int step, CvSize ssize, arrtype* dst, int dststep, \
         CvSize dsize, const double* matrix, int cn, const arrtype* fillval,    \
-        const int* ofs)                                                        \
+        const int* ofs, CvSlice rows)                                          \
     {                                                                          \
         int x, y, k;                                                           \
         double A12 = matrix[1], b1 = matrix[2];                                \
@@ -992,8 +1604,9 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                                                                                \
         step /= sizeof(src[0]);                                                \
         dststep /= sizeof(dst[0]);                                             \
+        dst += rows.start_index * dststep;                                     \
                                                                                \
-        for (y = 0; y < dsize.height; y++, dst += dststep)                     \
+        for (y = rows.start_index; y < rows.end_index; y++, dst += dststep)    \
         {                                                                      \
             int xs = CV_FLT_TO_FIX(A12 * y + b1, ICV_WARP_SHIFT);              \
             int ys = CV_FLT_TO_FIX(A22 * y + b2, ICV_WARP_SHIFT);              \
@@ -1015,10 +1628,12 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                                                                                \
                     for (k = 0; k < cn; k++)                                   \
                     {                                                          \
-                        p0 = mul_one_macro(ptr[k])                             \
-                             + a * (ptr[k + cn] - ptr[k]);                     \
-                        p1 = mul_one_macro(ptr[k + step])                      \
-                             + a * (ptr[k + cn + step] - ptr[k + step]);       \
+                        p0 = mul_one_macro(load_macro(ptr[k]))                 \
+                             + a * (load_macro(ptr[k + cn])                    \
+                                    - load_macro(ptr[k]));                     \
+                        p1 = mul_one_macro(load_macro(ptr[k + step]))          \
+                             + a * (load_macro(ptr[k + cn + step])             \
+                                    - load_macro(ptr[k + step]));              \
                         p0 = descale_macro(mul_one_macro(p0) + b * (p1 - p0)); \
                         dst[x * cn + k] = (arrtype)cast_macro(p0);             \
                     }                                                          \
@@ -1040,8 +1655,12 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
                                                                                \
                     for (k = 0; k < cn; k++)                                   \
                     {                                                          \
-                        p0 = mul_one_macro(ptr0[k]) + a * (ptr1[k] - ptr0[k]); \
-                        p1 = mul_one_macro(ptr2[k]) + a * (ptr3[k] - ptr2[k]); \
+                        p0 = mul_one_macro(load_macro(ptr0[k]))                \
+                             + a * (load_macro(ptr1[k])                        \
+                                    - load_macro(ptr0[k]));                    \
+                        p1 = mul_one_macro(load_macro(ptr2[k]))                \
+                             + a * (load_macro(ptr3[k])                        \
+                                    - load_macro(ptr2[k]));                    \
                         p0 = descale_macro(mul_one_macro(p0) + b * (p1 - p0)); \
                         dst[x * cn + k] = (arrtype)cast_macro(p0);             \
                     }                                                          \
@@ -1057,27 +1676,60 @@ CV_IMPL void cvResize(const CvArr* srcarr, CvArr* dstarr, int method)
 
 #define ICV_WARP_SCALE_ALPHA(x) ((x) * (1. / (ICV_WARP_MASK + 1)))
 
-ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(8u, uchar, int, CV_NOP, ICV_WARP_MUL_ONE_8U,
-                                  ICV_WARP_DESCALE_8U, CV_NOP)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(8u, uchar, int, CV_NOP, CV_NOP,
+                                  ICV_WARP_MUL_ONE_8U, ICV_WARP_DESCALE_8U,
+                                  CV_NOP)
 // ICV_DEF_WARP_AFFINE_BILINEAR_FUNC( 8u, uchar, double, ICV_WARP_SCALE_ALPHA,
 // CV_NOP,
 //                                    CV_NOP, ICV_WARP_CAST_8U )
-ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(16u, ushort, double, ICV_WARP_SCALE_ALPHA,
-                                  CV_NOP, CV_NOP, cvRound)
-ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(32f, float, double, ICV_WARP_SCALE_ALPHA,
-                                  CV_NOP, CV_NOP, CV_NOP)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(16u, ushort, double, CV_NOP,
+                                  ICV_WARP_SCALE_ALPHA, CV_NOP, CV_NOP,
+                                  cvRound)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(16f, ushort, double, CV_16FTO32F,
+                                  ICV_WARP_SCALE_ALPHA, CV_NOP, CV_NOP,
+                                  CV_CAST_16F)
+ICV_DEF_WARP_AFFINE_BILINEAR_FUNC(32f, float, double, CV_NOP,
+                                  ICV_WARP_SCALE_ALPHA, CV_NOP, CV_NOP,
+                                  CV_NOP)
 
 typedef CvStatus(CV_STDCALL* CvWarpAffineFunc)(const void* src, int srcstep,
                                                CvSize ssize, void* dst,
                                                int dststep, CvSize dsize,
                                                const double* matrix, int cn,
                                                const void* fillval,
-                                               const int* ofs);
+                                               const int* ofs, CvSlice rows);
+
+/* The arguments of cvWarpAffine and cvWarpPerspective shared by the bands
+   of destination rows */
+typedef struct CvWarpBand
+{
+    const uchar* src;
+    int srcstep;
+    CvSize ssize;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    const double* matrix;
+    int cn;
+    const void* fillval;
+    const int* ofs;
+    void* func;
+} CvWarpBand;
+
+static int CV_CDECL icvWarpAffineBand(int y0, int y1, void* arg)
+{
+    const CvWarpBand* p = (const CvWarpBand*)arg;
+
+    return ((CvWarpAffineFunc)p->func)(p->src, p->srcstep, p->ssize, p->dst,
+                                       p->dststep, p->dsize, p->matrix, p->cn,
+                                       p->fillval, p->ofs, cvSlice(y0, y1));
+}
 
 static void icvInitWarpAffineTab(CvFuncTable* bilin_tab)
 {
     bilin_tab->fn_2d[CV_8U] = (void*)icvWarpAffine_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvWarpAffine_Bilinear_16u_CnR;
+    bilin_tab->fn_2d[CV_16F] = (void*)icvWarpAffine_Bilinear_16f_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvWarpAffine_Bilinear_32f_CnR;
 }
 
@@ -1116,6 +1768,7 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
     CvMat srcAb = cvMat(2, 3, CV_64F, src_matrix),
           dstAb = cvMat(2, 3, CV_64F, dst_matrix), A, b, invA, invAb;
     CvWarpAffineFunc func;
+    CvWarpBand band;
     CvSize ssize, dsize;
 
     if (!inittab)
@@ -1203,9 +1856,20 @@ CV_IMPL void cvWarpAffine(const CvArr* srcarr, CvArr* dstarr,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, dst_matrix, cn,
-                       flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0, ofs));
+        band.src = src->data.ptr;
+        band.srcstep = src->step;
+        band.ssize = ssize;
+        band.dst = dst->data.ptr;
+        band.dststep = dst->step;
+        band.dsize = dsize;
+        band.matrix = dst_matrix;
+        band.cn = cn;
+        band.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        band.ofs = ofs;
+        band.func = (void*)func;
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, dsize.height),
+                                          icvWarpAffineBand, &band,
+                                          CV_PARALLEL_GRAIN(dsize.width)));
     }
 
     __END__;
@@ -1251,7 +1915,8 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
                                                cast_macro)                     \
     static CvStatus CV_STDCALL icvWarpPerspective_Bilinear_##flavor##_CnR(     \
         const arrtype* src, int step, CvSize ssize, arrtype* dst, int dststep, \
-        CvSize dsize, const double* matrix, int cn, const arrtype* fillval)    \
+        CvSize dsize, const double* matrix, int cn, const arrtype* fillval,    \
+        CvSlice rows)                                                          \
     {                                                                          \
         int x, y, k;                                                           \
         float A11 = (float)matrix[0], A12 = (float)matrix[1],                  \
@@ -1263,8 +1928,9 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
                                                                                \
         step /= sizeof(src[0]);                                                \
         dststep /= sizeof(dst[0]);                                             \
+        dst += rows.start_index * dststep;                                     \
                                                                                \
-        for (y = 0; y < dsize.height; y++, dst += dststep)                     \
+        for (y = rows.start_index; y < rows.end_index; y++, dst += dststep)    \
         {                                                                      \
             float xs0 = A12 * y + A13;                                         \
             float ys0 = A22 * y + A23;                                         \
@@ -1341,16 +2007,28 @@ CV_IMPL CvMat* cv2DRotationMatrix(CvPoint2D32f center, double angle,
 
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(16u, ushort, CV_NOP, cvRound)
+ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(16f, ushort, CV_16FTO32F, CV_CAST_16F)
 ICV_DEF_WARP_PERSPECTIVE_BILINEAR_FUNC(32f, float, CV_NOP, CV_NOP)
 
 typedef CvStatus(CV_STDCALL* CvWarpPerspectiveFunc)(
     const void* src, int srcstep, CvSize ssize, void* dst, int dststep,
-    CvSize dsize, const double* matrix, int cn, const void* fillval);
+    CvSize dsize, const double* matrix, int cn, const void* fillval,
+    CvSlice rows);
+
+static int CV_CDECL icvWarpPerspectiveBand(int y0, int y1, void* arg)
+{
+    const CvWarpBand* p = (const CvWarpBand*)arg;
+
+    return ((CvWarpPerspectiveFunc)p->func)(
+        p->src, p->srcstep, p->ssize, p->dst, p->dststep, p->dsize, p->matrix,
+        p->cn, p->fillval, cvSlice(y0, y1));
+}
 
 static void icvInitWarpPerspectiveTab(CvFuncTable* bilin_tab)
 {
     bilin_tab->fn_2d[CV_8U] = (void*)icvWarpPerspective_Bilinear_8u_CnR;
     bilin_tab->fn_2d[CV_16U] = (void*)icvWarpPerspective_Bilinear_16u_CnR;
+    bilin_tab->fn_2d[CV_16F] = (void*)icvWarpPerspective_Bilinear_16f_CnR;
     bilin_tab->fn_2d[CV_32F] = (void*)icvWarpPerspective_Bilinear_32f_CnR;
 }
 
@@ -1396,6 +2074,7 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
     CvMat A = cvMat(3, 3, CV_64F, src_matrix),
           invA = cvMat(3, 3, CV_64F, dst_matrix);
     CvWarpPerspectiveFunc func;
+    CvWarpBand band;
     CvSize ssize, dsize;
 
     if (method == CV_INTER_NN || method == CV_INTER_AREA)
@@ -1497,9 +2176,20 @@ CV_IMPL void cvWarpPerspective(const CvArr* srcarr, CvArr* dstarr,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        IPPI_CALL(func(src->data.ptr, src->step, ssize, dst->data.ptr,
-                       dst->step, dsize, dst_matrix, cn,
-                       flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0));
+        band.src = src->data.ptr;
+        band.srcstep = src->step;
+        band.ssize = ssize;
+        band.dst = dst->data.ptr;
+        band.dststep = dst->step;
+        band.dsize = dsize;
+        band.matrix = dst_matrix;
+        band.cn = cn;
+        band.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        band.ofs = 0;
+        band.func = (void*)func;
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, dsize.height),
+                                          icvWarpPerspectiveBand, &band,
+                                          CV_PARALLEL_GRAIN(dsize.width)));
     }
 
     __END__;
@@ -1641,7 +2331,8 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
     static CvStatus CV_STDCALL icvRemap_Bilinear_##flavor##_CnR(             \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,         \
         int dststep, CvSize dsize, const float* mapx, int mxstep,            \
-        const float* mapy, int mystep, int cn, const arrtype* fillval)       \
+        const float* mapy, int mystep, int cn, const arrtype* fillval,       \
+        CvSlice rows)                                                        \
     {                                                                        \
         int i, j, k;                                                         \
         ssize.width--;                                                       \
@@ -1651,8 +2342,11 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
         dststep /= sizeof(dst[0]);                                           \
         mxstep /= sizeof(mapx[0]);                                           \
         mystep /= sizeof(mapy[0]);                                           \
+        dst += rows.start_index * dststep;                                   \
+        mapx += rows.start_index * mxstep;                                   \
+        mapy += rows.start_index * mystep;                                   \
                                                                              \
-        for (i = 0; i < dsize.height;                                        \
+        for (i = rows.start_index; i < rows.end_index;                       \
              i++, dst += dststep, mapx += mxstep, mapy += mystep)            \
         {                                                                    \
             for (j = 0; j < dsize.width; j++)                                \
@@ -1697,7 +2391,8 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
     static CvStatus CV_STDCALL icvRemap_Bicubic_##flavor##_CnR(               \
         const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,          \
         int dststep, CvSize dsize, const float* mapx, int mxstep,             \
-        const float* mapy, int mystep, int cn, const arrtype* fillval)        \
+        const float* mapy, int mystep, int cn, const arrtype* fillval,        \
+        CvSlice rows)                                                         \
     {                                                                         \
         int i, j, k;                                                          \
         ssize.width = MAX(ssize.width - 3, 0);                                \
@@ -1707,8 +2402,11 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
         dststep /= sizeof(dst[0]);                                            \
         mxstep /= sizeof(mapx[0]);                                            \
         mystep /= sizeof(mapy[0]);                                            \
+        dst += rows.start_index * dststep;                                    \
+        mapx += rows.start_index * mxstep;                                    \
+        mapy += rows.start_index * mystep;                                    \
                                                                               \
-        for (i = 0; i < dsize.height;                                         \
+        for (i = rows.start_index; i < rows.end_index;                        \
              i++, dst += dststep, mapx += mxstep, mapy += mystep)             \
         {                                                                     \
             for (j = 0; j < dsize.width; j++)                                 \
@@ -1803,28 +2501,282 @@ CV_IMPL CvMat* cvGetAffineTransform(const CvPoint2D32f* src,
 
 ICV_DEF_REMAP_BILINEAR_FUNC(8u, uchar, CV_8TO32F, cvRound)
 ICV_DEF_REMAP_BILINEAR_FUNC(16u, ushort, CV_NOP, cvRound)
+ICV_DEF_REMAP_BILINEAR_FUNC(16f, ushort, CV_16FTO32F, CV_CAST_16F)
 ICV_DEF_REMAP_BILINEAR_FUNC(32f, float, CV_NOP, CV_NOP)
 
 ICV_DEF_REMAP_BICUBIC_FUNC(8u, uchar, int, CV_8TO32F, cvRound, CV_FAST_CAST_8U)
 ICV_DEF_REMAP_BICUBIC_FUNC(16u, ushort, int, CV_NOP, cvRound, CV_CAST_16U)
+ICV_DEF_REMAP_BICUBIC_FUNC(16f, ushort, float, CV_16FTO32F, CV_NOP,
+                           CV_CAST_16F)
 ICV_DEF_REMAP_BICUBIC_FUNC(32f, float, float, CV_NOP, CV_NOP, CV_NOP)
 
+/* The remap of fixed-point maps (see cvConvertMaps). The row functions
+   process a segment of a destination row; icvRemapFixedBand walks the
+   destination in tiles so that the source area they read stays in cache
+   when the maps rotate or scale the image */
+#define ICV_REMAP_TILE_WIDTH 256
+#define ICV_REMAP_TILE_HEIGHT 8
+
+/* the bilinear weights of the top-left, top-right, bottom-left and
+   bottom-right pixels for every value of mapalpha; the integer weights are
+   exact, i.e. they sum up to 1 << ICV_REMAP_COEF_BITS */
+static float icvRemapTab_32f[ICV_REMAP_TAB_SIZE * ICV_REMAP_TAB_SIZE * 4];
+static int icvRemapTab_8u[ICV_REMAP_TAB_SIZE * ICV_REMAP_TAB_SIZE * 4];
+
+static void icvInitRemapCoeffTab()
+{
+    static int inittab = 0;
+    if (!inittab)
+    {
+        for (int i = 0; i < ICV_REMAP_TAB_SIZE * ICV_REMAP_TAB_SIZE; i++)
+        {
+            int ifx = i & ICV_REMAP_MASK, ify = i >> ICV_REMAP_BITS;
+            float fx = ifx * (1.f / ICV_REMAP_TAB_SIZE);
+            float fy = ify * (1.f / ICV_REMAP_TAB_SIZE);
+
+            icvRemapTab_32f[i * 4] = (1.f - fx) * (1.f - fy);
+            icvRemapTab_32f[i * 4 + 1] = fx * (1.f - fy);
+            icvRemapTab_32f[i * 4 + 2] = (1.f - fx) * fy;
+            icvRemapTab_32f[i * 4 + 3] = fx * fy;
+
+            icvRemapTab_8u[i * 4] =
+                (ICV_REMAP_TAB_SIZE - ifx) * (ICV_REMAP_TAB_SIZE - ify);
+            icvRemapTab_8u[i * 4 + 1] = ifx * (ICV_REMAP_TAB_SIZE - ify);
+            icvRemapTab_8u[i * 4 + 2] = (ICV_REMAP_TAB_SIZE - ifx) * ify;
+            icvRemapTab_8u[i * 4 + 3] = ifx * ify;
+        }
+
+        inittab = 1;
+    }
+}
+
+void icvConvertMapsRow(const float* mapx, const float* mapy, short* mapxy,
+                       ushort* mapalpha, int width)
+{
+    int j;
+
+    // the integer coordinates are taken from the coordinates rounded as in
+    // the floating-point remap, so that both tell the same pixels for
+    // outliers; the fractions are then rounded to ICV_REMAP_BITS, but never
+    // up to the next pixel
+    if (mapalpha)
+        for (j = 0; j < width; j++)
+        {
+            int ix = cvRound(mapx[j] * (1 << ICV_WARP_SHIFT));
+            int iy = cvRound(mapy[j] * (1 << ICV_WARP_SHIFT));
+            int t0 = ix >> ICV_WARP_SHIFT, t1 = iy >> ICV_WARP_SHIFT;
+            int fx = CV_DESCALE(ix & ICV_WARP_MASK,
+                                ICV_WARP_SHIFT - ICV_REMAP_BITS);
+            int fy = CV_DESCALE(iy & ICV_WARP_MASK,
+                                ICV_WARP_SHIFT - ICV_REMAP_BITS);
+            mapxy[j * 2] = CV_CAST_16S(t0);
+            mapxy[j * 2 + 1] = CV_CAST_16S(t1);
+            mapalpha[j] = (ushort)(MIN(fy, ICV_REMAP_MASK) * ICV_REMAP_TAB_SIZE
+                                   + MIN(fx, ICV_REMAP_MASK));
+        }
+    else
+        for (j = 0; j < width; j++)
+        {
+            int t0 = cvRound(mapx[j]), t1 = cvRound(mapy[j]);
+            mapxy[j * 2] = CV_CAST_16S(t0);
+            mapxy[j * 2 + 1] = CV_CAST_16S(t1);
+        }
+}
+
+#define ICV_REMAP_DESCALE_8U(x) (uchar)CV_DESCALE((x), ICV_REMAP_COEF_BITS)
+
+#define ICV_DEF_REMAP_FIXED_BILINEAR_FUNC(flavor, arrtype, worktype, tab, \
+                                          load_macro, cast_macro)         \
+    static CvStatus CV_STDCALL icvRemapFixedRow_Bilinear_##flavor##_CnR(  \
+        const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,      \
+        const short* mapxy, const ushort* mapalpha, int width, int cn,    \
+        const arrtype* fillval)                                           \
+    {                                                                     \
+        int j, k;                                                         \
+        ssize.width--;                                                    \
+        ssize.height--;                                                   \
+        srcstep /= sizeof(src[0]);                                        \
+                                                                          \
+        for (j = 0; j < width; j++, dst += cn)                            \
+        {                                                                 \
+            int ix = mapxy[j * 2], iy = mapxy[j * 2 + 1];                 \
+                                                                          \
+            if ((unsigned)ix < (unsigned)ssize.width                      \
+                && (unsigned)iy < (unsigned)ssize.height)                 \
+            {                                                             \
+                const worktype* w = tab + mapalpha[j] * 4;                \
+                const arrtype* s = src + iy * srcstep + ix * cn;          \
+                for (k = 0; k < cn; k++, s++)                             \
+                {                                                         \
+                    worktype t = load_macro(s[0]) * w[0]                  \
+                                 + load_macro(s[cn]) * w[1]               \
+                                 + load_macro(s[srcstep]) * w[2]          \
+                                 + load_macro(s[srcstep + cn]) * w[3];    \
+                    dst[k] = cast_macro(t);                               \
+                }                                                         \
+            }                                                             \
+            else if (fillval)                                             \
+                for (k = 0; k < cn; k++)                                  \
+                    dst[k] = fillval[k];                                  \
+        }                                                                 \
+                                                                          \
+        return CV_OK;                                                     \
+    }
+
+#define ICV_DEF_REMAP_FIXED_NN_FUNC(flavor, arrtype)                 \
+    static CvStatus CV_STDCALL icvRemapFixedRow_NN_##flavor##_CnR(   \
+        const arrtype* src, int srcstep, CvSize ssize, arrtype* dst, \
+        const short* mapxy, const ushort*, int width, int cn,        \
+        const arrtype* fillval)                                      \
+    {                                                                \
+        int j, k;                                                    \
+        srcstep /= sizeof(src[0]);                                   \
+                                                                     \
+        for (j = 0; j < width; j++, dst += cn)                       \
+        {                                                            \
+            int ix = mapxy[j * 2], iy = mapxy[j * 2 + 1];            \
+                                                                     \
+            if ((unsigned)ix < (unsigned)ssize.width                 \
+                && (unsigned)iy < (unsigned)ssize.height)            \
+            {                                                        \
+                const arrtype* s = src + iy * srcstep + ix * cn;     \
+                for (k = 0; k < cn; k++)                             \
+                    dst[k] = s[k];                                   \
+            }                                                        \
+            else if (fillval)                                        \
+                for (k = 0; k < cn; k++)                             \
+                    dst[k] = fillval[k];                             \
+        }                                                            \
+                                                                     \
+        return CV_OK;                                                \
+    }
+
+ICV_DEF_REMAP_FIXED_BILINEAR_FUNC(8u, uchar, int, icvRemapTab_8u, CV_NOP,
+                                  ICV_REMAP_DESCALE_8U)
+ICV_DEF_REMAP_FIXED_BILINEAR_FUNC(16u, ushort, float, icvRemapTab_32f, CV_NOP,
+                                  (ushort)cvRound)
+ICV_DEF_REMAP_FIXED_BILINEAR_FUNC(16f, ushort, float, icvRemapTab_32f,
+                                  CV_16FTO32F, CV_CAST_16F)
+ICV_DEF_REMAP_FIXED_BILINEAR_FUNC(32f, float, float, icvRemapTab_32f, CV_NOP,
+                                  CV_NOP)
+
+ICV_DEF_REMAP_FIXED_NN_FUNC(8u, uchar)
+ICV_DEF_REMAP_FIXED_NN_FUNC(16u, ushort)
+ICV_DEF_REMAP_FIXED_NN_FUNC(32f, float)
+
 typedef CvStatus(CV_STDCALL* CvRemapFunc)(const void* src, int srcstep,
                                           CvSize ssize, void* dst, int dststep,
                                           CvSize dsize, const float* mapx,
                                           int mxstep, const float* mapy,
                                           int mystep, int cn,
-                                          const void* fillval);
+                                          const void* fillval, CvSlice rows);
 
-static void icvInitRemapTab(CvFuncTable* bilinear_tab, CvFuncTable* bicubic_tab)
+/* The arguments of cvRemap shared by the bands of destination rows */
+typedef struct CvRemapBand
+{
+    const uchar* src;
+    int srcstep;
+    CvSize ssize;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    const float* mapx;
+    int mxstep;
+    const float* mapy;
+    int mystep;
+    int cn;
+    const void* fillval;
+    CvRemapFunc func;
+} CvRemapBand;
+
+static int CV_CDECL icvRemapBand(int y0, int y1, void* arg)
+{
+    const CvRemapBand* p = (const CvRemapBand*)arg;
+
+    return p->func(p->src, p->srcstep, p->ssize, p->dst, p->dststep, p->dsize,
+                   p->mapx, p->mxstep, p->mapy, p->mystep, p->cn, p->fillval,
+                   cvSlice(y0, y1));
+}
+
+typedef CvStatus(CV_STDCALL* CvRemapFixedFunc)(
+    const void* src, int srcstep, CvSize ssize, void* dst, const short* mapxy,
+    const ushort* mapalpha, int width, int cn, const void* fillval);
+
+/* The arguments of cvRemap shared by the bands of destination rows when the
+   maps are in the fixed-point form */
+typedef struct CvRemapFixedBand
+{
+    const uchar* src;
+    int srcstep;
+    CvSize ssize;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    const uchar* mapxy;
+    int mxystep;
+    const uchar* mapalpha;
+    int mastep;
+    int cn;
+    int pix_size;
+    const void* fillval;
+    CvRemapFixedFunc func;
+} CvRemapFixedBand;
+
+static int CV_CDECL icvRemapFixedBand(int y0, int y1, void* arg)
+{
+    const CvRemapFixedBand* p = (const CvRemapFixedBand*)arg;
+    int i, i0, i1, j0, j1;
+
+    for (i0 = y0; i0 < y1; i0 = i1)
+    {
+        i1 = MIN(i0 + ICV_REMAP_TILE_HEIGHT, y1);
+        for (j0 = 0; j0 < p->dsize.width; j0 = j1)
+        {
+            j1 = MIN(j0 + ICV_REMAP_TILE_WIDTH, p->dsize.width);
+            for (i = i0; i < i1; i++)
+            {
+                const ushort* alpha =
+                    p->mapalpha
+                        ? (const ushort*)(p->mapalpha + i * p->mastep) + j0
+                        : 0;
+                p->func(p->src, p->srcstep, p->ssize,
+                        p->dst + i * p->dststep + j0 * p->pix_size,
+                        (const short*)(p->mapxy + i * p->mxystep) + j0 * 2,
+                        alpha, j1 - j0, p->cn, p->fillval);
+            }
+        }
+    }
+
+    return CV_OK;
+}
+
+static void icvInitRemapTab(CvFuncTable* bilinear_tab, CvFuncTable* bicubic_tab,
+                            CvFuncTable* fixed_bilinear_tab,
+                            CvFuncTable* fixed_nn_tab)
 {
     bilinear_tab->fn_2d[CV_8U] = (void*)icvRemap_Bilinear_8u_CnR;
     bilinear_tab->fn_2d[CV_16U] = (void*)icvRemap_Bilinear_16u_CnR;
+    bilinear_tab->fn_2d[CV_16F] = (void*)icvRemap_Bilinear_16f_CnR;
     bilinear_tab->fn_2d[CV_32F] = (void*)icvRemap_Bilinear_32f_CnR;
 
     bicubic_tab->fn_2d[CV_8U] = (void*)icvRemap_Bicubic_8u_CnR;
     bicubic_tab->fn_2d[CV_16U] = (void*)icvRemap_Bicubic_16u_CnR;
+    bicubic_tab->fn_2d[CV_16F] = (void*)icvRemap_Bicubic_16f_CnR;
     bicubic_tab->fn_2d[CV_32F] = (void*)icvRemap_Bicubic_32f_CnR;
+
+    fixed_bilinear_tab->fn_2d[CV_8U] =
+        (void*)icvRemapFixedRow_Bilinear_8u_CnR;
+    fixed_bilinear_tab->fn_2d[CV_16U] =
+        (void*)icvRemapFixedRow_Bilinear_16u_CnR;
+    fixed_bilinear_tab->fn_2d[CV_16F] =
+        (void*)icvRemapFixedRow_Bilinear_16f_CnR;
+    fixed_bilinear_tab->fn_2d[CV_32F] =
+        (void*)icvRemapFixedRow_Bilinear_32f_CnR;
+
+    fixed_nn_tab->fn_2d[CV_8U] = (void*)icvRemapFixedRow_NN_8u_CnR;
+    fixed_nn_tab->fn_2d[CV_16U] = (void*)icvRemapFixedRow_NN_16u_CnR;
+    fixed_nn_tab->fn_2d[CV_16F] = (void*)icvRemapFixedRow_NN_16u_CnR;
+    fixed_nn_tab->fn_2d[CV_32F] = (void*)icvRemapFixedRow_NN_32f_CnR;
 }
 
 /******************** IPP remap functions *********************/
@@ -1844,6 +2796,14 @@ icvRemap_32f_C1R_t icvRemap_32f_C1R_p = 0;
 icvRemap_32f_C3R_t icvRemap_32f_C3R_p = 0;
 icvRemap_32f_C4R_t icvRemap_32f_C4R_p = 0;
 
+icvRemapFixed_8u_C1R_t icvRemapFixed_8u_C1R_p = 0;
+icvRemapFixed_8u_C3R_t icvRemapFixed_8u_C3R_p = 0;
+icvRemapFixed_8u_C4R_t icvRemapFixed_8u_C4R_p = 0;
+
+icvRemapFixed_32f_C1R_t icvRemapFixed_32f_C1R_p = 0;
+icvRemapFixed_32f_C3R_t icvRemapFixed_32f_C3R_p = 0;
+icvRemapFixed_32f_C4R_t icvRemapFixed_32f_C4R_p = 0;
+
 /**************************************************************/
 
 CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
@@ -1851,6 +2811,8 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
 {
     static CvFuncTable bilinear_tab;
     static CvFuncTable bicubic_tab;
+    static CvFuncTable fixed_bilinear_tab;
+    static CvFuncTable fixed_nn_tab;
     static int inittab = 0;
 
     CV_FUNCNAME("cvRemap");
@@ -1861,34 +2823,58 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
     CvMat dststub, *dst = (CvMat*)dstarr;
     CvMat mxstub, *mapx = (CvMat*)_mapx;
     CvMat mystub, *mapy = (CvMat*)_mapy;
-    int type, depth, cn;
+    int type, depth, cn, fixed;
     int method = flags & 3;
     double fillbuf[4];
     CvSize ssize, dsize;
 
     if (!inittab)
     {
-        icvInitRemapTab(&bilinear_tab, &bicubic_tab);
+        icvInitRemapTab(&bilinear_tab, &bicubic_tab, &fixed_bilinear_tab,
+                        &fixed_nn_tab);
         icvInitLinearCoeffTab();
         icvInitCubicCoeffTab();
+        icvInitRemapCoeffTab();
         inittab = 1;
     }
 
     CV_CALL(src = cvGetMat(srcarr, &srcstub));
     CV_CALL(dst = cvGetMat(dstarr, &dststub));
     CV_CALL(mapx = cvGetMat(mapx, &mxstub));
-    CV_CALL(mapy = cvGetMat(mapy, &mystub));
+    fixed = CV_MAT_TYPE(mapx->type) == CV_16SC2;
+    if (mapy || !fixed)
+        CV_CALL(mapy = cvGetMat(mapy, &mystub));
 
     if (!CV_ARE_TYPES_EQ(src, dst))
         CV_ERROR(CV_StsUnmatchedFormats, "");
 
-    if (!CV_ARE_TYPES_EQ(mapx, mapy) || CV_MAT_TYPE(mapx->type) != CV_32FC1)
-        CV_ERROR(CV_StsUnmatchedFormats,
-                 "Both map arrays must have 32fC1 type");
-
-    if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, dst))
-        CV_ERROR(CV_StsUnmatchedSizes, "Both map arrays and the destination "
-                                       "array must have the same size");
+    if (fixed)
+    {
+        if (mapy && CV_MAT_TYPE(mapy->type) != CV_16UC1)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "The fixed-point maps must have 16sC2 and 16uC1 types");
+
+        if (mapy && method == CV_INTER_CUBIC)
+            CV_ERROR(CV_StsBadFlag, "Bicubic interpolation is not "
+                                    "supported for the fixed-point maps");
+
+        if (!CV_ARE_SIZES_EQ(mapx, dst)
+            || (mapy && !CV_ARE_SIZES_EQ(mapy, dst)))
+            CV_ERROR(CV_StsUnmatchedSizes, "The map arrays and the destination "
+                                           "array must have the same size");
+    }
+    else
+    {
+        if (!CV_ARE_TYPES_EQ(mapx, mapy)
+            || CV_MAT_TYPE(mapx->type) != CV_32FC1)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "Both map arrays must have 32fC1 type");
+
+        if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, dst))
+            CV_ERROR(CV_StsUnmatchedSizes, "Both map arrays and the "
+                                           "destination array must have the "
+                                           "same size");
+    }
 
     type = CV_MAT_TYPE(src->type);
     depth = CV_MAT_DEPTH(type);
@@ -1899,7 +2885,7 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
     ssize = cvGetMatSize(src);
     dsize = cvGetMatSize(dst);
 
-    if (icvRemap_8u_C1R_p)
+    if (icvRemap_8u_C1R_p && !fixed)
     {
         CvRemapIPPFunc ipp_func = type == CV_8UC1    ? icvRemap_8u_C1R_p
                                   : type == CV_8UC3  ? icvRemap_8u_C3R_p
@@ -1936,7 +2922,47 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
 
     cvScalarToRawData(&fillval, fillbuf, CV_MAT_TYPE(src->type), 0);
 
+    if (fixed)
     {
+        CvRemapFixedBand band;
+        CvRemapFixedFunc func = 0;
+
+        if (mapy)
+            func = type == CV_8UC1    ? icvRemapFixed_8u_C1R_p
+                   : type == CV_8UC3  ? icvRemapFixed_8u_C3R_p
+                   : type == CV_8UC4  ? icvRemapFixed_8u_C4R_p
+                   : type == CV_32FC1 ? icvRemapFixed_32f_C1R_p
+                   : type == CV_32FC3 ? icvRemapFixed_32f_C3R_p
+                   : type == CV_32FC4 ? icvRemapFixed_32f_C4R_p
+                                      : 0;
+        if (!func)
+            func = mapy ? (CvRemapFixedFunc)fixed_bilinear_tab.fn_2d[depth]
+                        : (CvRemapFixedFunc)fixed_nn_tab.fn_2d[depth];
+
+        if (!func)
+            CV_ERROR(CV_StsUnsupportedFormat, "");
+
+        band.src = src->data.ptr;
+        band.srcstep = src->step;
+        band.ssize = ssize;
+        band.dst = dst->data.ptr;
+        band.dststep = dst->step;
+        band.dsize = dsize;
+        band.mapxy = mapx->data.ptr;
+        band.mxystep = mapx->step;
+        band.mapalpha = mapy ? mapy->data.ptr : 0;
+        band.mastep = mapy ? mapy->step : 0;
+        band.cn = cn;
+        band.pix_size = CV_ELEM_SIZE(type);
+        band.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        band.func = func;
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, dsize.height),
+                                          icvRemapFixedBand, &band,
+                                          CV_PARALLEL_GRAIN(dsize.width)));
+    }
+    else
+    {
+        CvRemapBand band;
         CvRemapFunc func = method == CV_INTER_CUBIC
                                ? (CvRemapFunc)bicubic_tab.fn_2d[depth]
                                : (CvRemapFunc)bilinear_tab.fn_2d[depth];
@@ -1944,9 +2970,71 @@ CV_IMPL void cvRemap(const CvArr* srcarr, CvArr* dstarr, const CvArr* _mapx,
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
 
-        func(src->data.ptr, src->step, ssize, dst->data.ptr, dst->step, dsize,
-             mapx->data.fl, mapx->step, mapy->data.fl, mapy->step, cn,
-             flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0);
+        band.src = src->data.ptr;
+        band.srcstep = src->step;
+        band.ssize = ssize;
+        band.dst = dst->data.ptr;
+        band.dststep = dst->step;
+        band.dsize = dsize;
+        band.mapx = mapx->data.fl;
+        band.mxstep = mapx->step;
+        band.mapy = mapy->data.fl;
+        band.mystep = mapy->step;
+        band.cn = cn;
+        band.fillval = flags & CV_WARP_FILL_OUTLIERS ? fillbuf : 0;
+        band.func = func;
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, dsize.height),
+                                          icvRemapBand, &band,
+                                          CV_PARALLEL_GRAIN(dsize.width)));
+    }
+
+    __END__;
+}
+
+CV_IMPL void cvConvertMaps(const CvArr* _mapx, const CvArr* _mapy,
+                           CvArr* _mapxy, CvArr* _mapalpha)
+{
+    CV_FUNCNAME("cvConvertMaps");
+
+    __BEGIN__;
+
+    CvMat mxstub, *mapx = (CvMat*)_mapx;
+    CvMat mystub, *mapy = (CvMat*)_mapy;
+    CvMat mxystub, *mapxy = (CvMat*)_mapxy;
+    CvMat mastub, *mapalpha = (CvMat*)_mapalpha;
+    CvSize size;
+    int i;
+
+    CV_CALL(mapx = cvGetMat(mapx, &mxstub));
+    CV_CALL(mapy = cvGetMat(mapy, &mystub));
+    CV_CALL(mapxy = cvGetMat(mapxy, &mxystub));
+    if (mapalpha)
+        CV_CALL(mapalpha = cvGetMat(mapalpha, &mastub));
+
+    if (!CV_ARE_TYPES_EQ(mapx, mapy) || CV_MAT_TYPE(mapx->type) != CV_32FC1)
+        CV_ERROR(CV_StsUnmatchedFormats,
+                 "Both source map arrays must have 32fC1 type");
+
+    if (CV_MAT_TYPE(mapxy->type) != CV_16SC2
+        || (mapalpha && CV_MAT_TYPE(mapalpha->type) != CV_16UC1))
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "The fixed-point maps must have 16sC2 and 16uC1 types");
+
+    if (!CV_ARE_SIZES_EQ(mapx, mapy) || !CV_ARE_SIZES_EQ(mapx, mapxy)
+        || (mapalpha && !CV_ARE_SIZES_EQ(mapx, mapalpha)))
+        CV_ERROR(CV_StsUnmatchedSizes, "All the map arrays must have the "
+                                       "same size");
+
+    size = cvGetMatSize(mapx);
+
+    for (i = 0; i < size.height; i++)
+    {
+        icvConvertMapsRow(
+            (const float*)(mapx->data.ptr + mapx->step * i),
+            (const float*)(mapy->data.ptr + mapy->step * i),
+            (short*)(mapxy->data.ptr + mapxy->step * i),
+            mapalpha ? (ushort*)(mapalpha->data.ptr + mapalpha->step * i) : 0,
+            size.width);
     }
 
     __END__;
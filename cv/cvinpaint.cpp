@@ -80,11 +80,103 @@ typedef struct CvHeapElem
     struct CvHeapElem* next;
 } CvHeapElem;
 
+/* The priority queue of the fast marching. The elements are kept in a ring
+   of buckets of 1/ICV_FMM_BUCKET_SCALE distance units, every bucket sorted
+   by the distance; the pushed distances rarely exceed the popped ones by
+   more than a couple of units, so the insertion only walks back through a
+   few elements of the same bucket, and the distances beyond the ring wait
+   in the sorted overflow list. The elements are popped in the order of the
+   distance, the elements with equal distances in the order they were
+   pushed */
+#define ICV_FMM_BUCKETS 64 /* a power of 2 */
+#define ICV_FMM_BUCKET_SCALE 16.f
+
 class CvPriorityQueueFloat
 {
 protected:
-    CvHeapElem *mem, *empty, *head, *tail;
-    int num, in;
+    CvHeapElem *mem, *free_elems;
+    CvHeapElem *first[ICV_FMM_BUCKETS], *last[ICV_FMM_BUCKETS];
+    CvHeapElem *over_first, *over_last;
+    int num, in, ring_in;
+    int cur; // the key of the lowest bucket of the ring
+
+    static int Key(float T)
+    {
+        return T < (float)(INT_MAX / 2) / ICV_FMM_BUCKET_SCALE
+                   ? (int)(T * ICV_FMM_BUCKET_SCALE)
+                   : INT_MAX / 2;
+    }
+
+    // inserts the element after the last one that is not greater
+    static void Insert(CvHeapElem** _first, CvHeapElem** _last,
+                       CvHeapElem* add)
+    {
+        CvHeapElem* tmp = *_last;
+        while (tmp && tmp->T > add->T)
+            tmp = tmp->prev;
+        add->prev = tmp;
+        add->next = tmp ? tmp->next : *_first;
+        if (add->next)
+            add->next->prev = add;
+        else
+            *_last = add;
+        if (tmp)
+            tmp->next = add;
+        else
+            *_first = add;
+    }
+
+    // moves the overflow elements with the keys below limit to the ring
+    void Refill(int limit)
+    {
+        while (over_first && Key(over_first->T) < limit)
+        {
+            CvHeapElem* tmp = over_first;
+            int b = Key(tmp->T) & (ICV_FMM_BUCKETS - 1);
+            over_first = tmp->next;
+            if (over_first)
+                over_first->prev = NULL;
+            else
+                over_last = NULL;
+            tmp->prev = last[b];
+            tmp->next = NULL;
+            if (last[b])
+                last[b]->next = tmp;
+            else
+                first[b] = tmp;
+            last[b] = tmp;
+            ring_in++;
+        }
+    }
+
+    CvHeapElem* PopFirst(void)
+    {
+        CvHeapElem* tmp;
+        int b;
+        if (in == 0)
+            return NULL;
+        if (ring_in == 0)
+        {
+            cur = Key(over_first->T);
+            Refill(cur + ICV_FMM_BUCKETS);
+        }
+        while (!first[b = cur & (ICV_FMM_BUCKETS - 1)])
+        {
+            cur++;
+            Refill(cur + ICV_FMM_BUCKETS);
+        }
+        tmp = first[b];
+        first[b] = tmp->next;
+        if (first[b])
+            first[b]->prev = NULL;
+        else
+            last[b] = NULL;
+        tmp->next = free_elems;
+        free_elems = tmp;
+        in--;
+        ring_in--;
+        return tmp;
+    }
 
 public:
     bool Init(const CvMat* f)
@@ -97,28 +189,14 @@ public:
         }
         if (num <= 0)
             return false;
-        mem = (CvHeapElem*)cvAlloc((num + 2) * sizeof(CvHeapElem));
+        mem = (CvHeapElem*)cvAlloc(num * sizeof(CvHeapElem));
         if (mem == NULL)
             return false;
 
-        head = mem;
-        head->i = head->j = -1;
-        head->prev = NULL;
-        head->next = mem + 1;
-        head->T = -FLT_MAX;
-        empty = mem + 1;
-        for (i = 1; i <= num; i++)
-        {
-            mem[i].prev = mem + i - 1;
+        for (i = 0; i < num; i++)
             mem[i].next = mem + i + 1;
-            mem[i].i = mem[i].i = -1;
-            mem[i].T = FLT_MAX;
-        }
-        tail = mem + i;
-        tail->i = tail->j = -1;
-        tail->prev = mem + i - 1;
-        tail->next = NULL;
-        tail->T = FLT_MAX;
+        mem[num - 1].next = NULL;
+        free_elems = mem;
         return true;
     }
 
@@ -141,78 +219,55 @@ public:
 
     bool Push(int i, int j, float T)
     {
-        CvHeapElem *tmp = empty, *add = empty;
-        if (empty == tail)
+        CvHeapElem* add = free_elems;
+        int k;
+        if (!add)
             return false;
-        while (tmp->prev->T > T)
-            tmp = tmp->prev;
-        if (tmp != empty)
-        {
-            add->prev->next = add->next;
-            add->next->prev = add->prev;
-            empty = add->next;
-            add->prev = tmp->prev;
-            add->next = tmp;
-            add->prev->next = add;
-            add->next->prev = add;
-        }
-        else
-        {
-            empty = empty->next;
-        }
+        free_elems = add->next;
         add->i = i;
         add->j = j;
         add->T = T;
+        k = MAX(Key(T), cur);
+        if (k < cur + ICV_FMM_BUCKETS)
+        {
+            int b = k & (ICV_FMM_BUCKETS - 1);
+            Insert(first + b, last + b, add);
+            ring_in++;
+        }
+        else
+            Insert(&over_first, &over_last, add);
         in++;
-        //      printf("push i %3d  j %3d  T %12.4e  in %4d\n",i,j,T,in);
         return true;
     }
 
     bool Pop(int* i, int* j)
     {
-        CvHeapElem* tmp = head->next;
-        if (empty == tmp)
+        CvHeapElem* tmp = PopFirst();
+        if (!tmp)
             return false;
         *i = tmp->i;
         *j = tmp->j;
-        tmp->prev->next = tmp->next;
-        tmp->next->prev = tmp->prev;
-        tmp->prev = empty->prev;
-        tmp->next = empty;
-        tmp->prev->next = tmp;
-        tmp->next->prev = tmp;
-        empty = tmp;
-        in--;
-        //      printf("pop  i %3d  j %3d  T %12.4e  in
-        //      %4d\n",tmp->i,tmp->j,tmp->T,in);
         return true;
     }
 
     bool Pop(int* i, int* j, float* T)
     {
-        CvHeapElem* tmp = head->next;
-        if (empty == tmp)
+        CvHeapElem* tmp = PopFirst();
+        if (!tmp)
             return false;
         *i = tmp->i;
         *j = tmp->j;
         *T = tmp->T;
-        tmp->prev->next = tmp->next;
-        tmp->next->prev = tmp->prev;
-        tmp->prev = empty->prev;
-        tmp->next = empty;
-        tmp->prev->next = tmp;
-        tmp->next->prev = tmp;
-        empty = tmp;
-        in--;
-        //      printf("pop  i %3d  j %3d  T %12.4e  in
-        //      %4d\n",tmp->i,tmp->j,tmp->T,in);
         return true;
     }
 
     CvPriorityQueueFloat(void)
     {
-        num = in = 0;
-        mem = empty = head = tail = NULL;
+        int b;
+        num = in = ring_in = cur = 0;
+        mem = free_elems = over_first = over_last = NULL;
+        for (b = 0; b < ICV_FMM_BUCKETS; b++)
+            first[b] = last[b] = NULL;
     }
 
     ~CvPriorityQueueFloat(void) { cvFree(&mem); }
@@ -1322,46 +1377,24 @@ static void icvNSInpaintFMM(const CvMat* f, CvMat* t, CvMat* out, int range,
         }                                                           \
     }
 
-CV_IMPL void cvInpaint(const CvArr* _input_img, const CvArr* _inpaint_mask,
-                       CvArr* _output_img, double inpaintRange, int flags)
+/* inpaints a region of the image that holds the whole connected components
+   of the mask with the (range + 2)-pixel margin; the output already holds
+   the input pixels */
+static void icvInpaint(const CvMat* inpaint_mask, CvMat* output_img,
+                       int range, int flags)
 {
     CvMat *mask = 0, *band = 0, *f = 0, *t = 0, *out = 0;
     CvPriorityQueueFloat *Heap = 0, *Out = 0;
     IplConvKernel *el_cross = 0, *el_range = 0;
 
-    CV_FUNCNAME("cvInpaint");
+    CV_FUNCNAME("icvInpaint");
 
     __BEGIN__;
 
-    CvMat input_hdr, mask_hdr, output_hdr;
-    CvMat *input_img, *inpaint_mask, *output_img;
-    int range = cvRound(inpaintRange);
     int erows, ecols;
 
-    CV_CALL(input_img = cvGetMat(_input_img, &input_hdr));
-    CV_CALL(inpaint_mask = cvGetMat(_inpaint_mask, &mask_hdr));
-    CV_CALL(output_img = cvGetMat(_output_img, &output_hdr));
-
-    if (!CV_ARE_SIZES_EQ(input_img, output_img)
-        || !CV_ARE_SIZES_EQ(input_img, inpaint_mask))
-        CV_ERROR(CV_StsUnmatchedSizes,
-                 "All the input and output images must have the same size");
-
-    if (CV_MAT_TYPE(input_img->type) != CV_8UC1
-            && CV_MAT_TYPE(input_img->type) != CV_8UC3
-        || !CV_ARE_TYPES_EQ(input_img, output_img))
-        CV_ERROR(CV_StsUnsupportedFormat, "Only 8-bit 1-channel and 3-channel "
-                                          "input/output images are supported");
-
-    if (CV_MAT_TYPE(inpaint_mask->type) != CV_8UC1)
-        CV_ERROR(CV_StsUnsupportedFormat,
-                 "The mask must be 8-bit 1-channel image");
-
-    range = MAX(range, 1);
-    range = MIN(range, 100);
-
-    ecols = input_img->cols + 2;
-    erows = input_img->rows + 2;
+    ecols = output_img->cols + 2;
+    erows = output_img->rows + 2;
 
     CV_CALL(f = cvCreateMat(erows, ecols, CV_8UC1));
     CV_CALL(t = cvCreateMat(erows, ecols, CV_32FC1));
@@ -1370,7 +1403,6 @@ CV_IMPL void cvInpaint(const CvArr* _input_img, const CvArr* _inpaint_mask,
     CV_CALL(el_cross =
                 cvCreateStructuringElementEx(3, 3, 1, 1, CV_SHAPE_CROSS, NULL));
 
-    cvCopy(input_img, output_img);
     cvSet(mask, cvScalar(KNOWN, 0, 0, 0));
     COPY_MASK_BORDER1_C1(inpaint_mask, mask, uchar);
     SET_BORDER1_C1(mask, uchar, 0);
@@ -1421,3 +1453,172 @@ CV_IMPL void cvInpaint(const CvArr* _input_img, const CvArr* _inpaint_mask,
     cvReleaseMat(&t);
     cvReleaseMat(&f);
 }
+
+/* Finds the regions that can be inpainted independently: the bounding
+   boxes of the connected mask components grown by the margin, merged while
+   any two of them intersect. A pixel is inpainted from the pixels within
+   range and the distances of the outer band within range of the mask, so
+   with the margin of range + 2 pixels the result of every region is the
+   same as the result of the whole image. Returns the number of regions */
+static int icvFindInpaintRegions(const CvMat* inpaint_mask, int margin,
+                                 CvRect** _rects)
+{
+    CvMat* temp = 0;
+    CvMemStorage* storage = 0;
+    CvRect* rects = 0;
+    int count = 0;
+
+    CV_FUNCNAME("icvFindInpaintRegions");
+
+    __BEGIN__;
+
+    CvSeq *contours = 0, *c;
+    int i, j, merged;
+
+    CvMat temp_roi;
+
+    // cvFindContours ignores the outermost pixels, so the mask is copied
+    // into the image with the 1-pixel zero border
+    CV_CALL(temp = cvCreateMat(inpaint_mask->rows + 2, inpaint_mask->cols + 2,
+                               CV_8UC1));
+    CV_CALL(storage = cvCreateMemStorage(0));
+    cvZero(temp);
+    cvCopy(inpaint_mask, cvGetSubRect(temp, &temp_roi,
+                                      cvRect(1, 1, inpaint_mask->cols,
+                                             inpaint_mask->rows)));
+    CV_CALL(count = cvFindContours(temp, storage, &contours,
+                                   sizeof(CvContour), CV_RETR_EXTERNAL,
+                                   CV_CHAIN_APPROX_SIMPLE, cvPoint(-1, -1)));
+    if (count == 0)
+        EXIT;
+
+    CV_CALL(rects = (CvRect*)cvAlloc(count * sizeof(rects[0])));
+    for (c = contours, i = 0; c != 0; c = c->h_next, i++)
+    {
+        CvRect r = cvBoundingRect(c, 0);
+        int x1 = MIN(r.x + r.width + margin, inpaint_mask->cols);
+        int y1 = MIN(r.y + r.height + margin, inpaint_mask->rows);
+        r.x = MAX(r.x - margin, 0);
+        r.y = MAX(r.y - margin, 0);
+        r.width = x1 - r.x;
+        r.height = y1 - r.y;
+        rects[i] = r;
+    }
+
+    do
+    {
+        merged = 0;
+        for (i = 0; i < count; i++)
+            for (j = i + 1; j < count; j++)
+            {
+                CvRect a = rects[i], b = rects[j];
+                if (a.x < b.x + b.width && b.x < a.x + a.width
+                    && a.y < b.y + b.height && b.y < a.y + a.height)
+                {
+                    rects[i] = cvMaxRect(&a, &b);
+                    rects[j--] = rects[--count];
+                    merged = 1;
+                }
+            }
+    } while (merged);
+
+    __END__;
+
+    cvReleaseMat(&temp);
+    cvReleaseMemStorage(&storage);
+    *_rects = rects;
+    return count;
+}
+
+typedef struct CvInpaintRegions
+{
+    const CvMat* mask;
+    CvMat* output;
+    const CvRect* rects;
+    int range, flags;
+} CvInpaintRegions;
+
+static int CV_CDECL icvInpaintRegions(int start, int end, void* arg)
+{
+    const CvInpaintRegions* p = (const CvInpaintRegions*)arg;
+    int i;
+
+    for (i = start; i < end; i++)
+    {
+        CvMat mask, output;
+        cvGetSubRect(p->mask, &mask, p->rects[i]);
+        cvGetSubRect(p->output, &output, p->rects[i]);
+        icvInpaint(&mask, &output, p->range, p->flags);
+        if (cvGetErrStatus() < 0)
+            return cvGetErrStatus();
+    }
+
+    return CV_StsOk;
+}
+
+CV_IMPL void cvInpaint(const CvArr* _input_img, const CvArr* _inpaint_mask,
+                       CvArr* _output_img, double inpaintRange, int flags)
+{
+    CvRect* rects = 0;
+
+    CV_FUNCNAME("cvInpaint");
+
+    __BEGIN__;
+
+    CvMat input_hdr, mask_hdr, output_hdr;
+    CvMat *input_img, *inpaint_mask, *output_img;
+    CvInpaintRegions regions;
+    int range = cvRound(inpaintRange);
+    int i, j, count;
+
+    CV_CALL(input_img = cvGetMat(_input_img, &input_hdr));
+    CV_CALL(inpaint_mask = cvGetMat(_inpaint_mask, &mask_hdr));
+    CV_CALL(output_img = cvGetMat(_output_img, &output_hdr));
+
+    if (!CV_ARE_SIZES_EQ(input_img, output_img)
+        || !CV_ARE_SIZES_EQ(input_img, inpaint_mask))
+        CV_ERROR(CV_StsUnmatchedSizes,
+                 "All the input and output images must have the same size");
+
+    if (CV_MAT_TYPE(input_img->type) != CV_8UC1
+            && CV_MAT_TYPE(input_img->type) != CV_8UC3
+        || !CV_ARE_TYPES_EQ(input_img, output_img))
+        CV_ERROR(CV_StsUnsupportedFormat, "Only 8-bit 1-channel and 3-channel "
+                                          "input/output images are supported");
+
+    if (CV_MAT_TYPE(inpaint_mask->type) != CV_8UC1)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "The mask must be 8-bit 1-channel image");
+
+    range = MAX(range, 1);
+    range = MIN(range, 100);
+
+    cvCopy(input_img, output_img);
+
+    CV_CALL(count = icvFindInpaintRegions(inpaint_mask, range + 2, &rects));
+
+    // the largest regions go first, so the threads finish at about the
+    // same time
+    for (i = 1; i < count; i++)
+    {
+        CvRect r = rects[i];
+        for (j = i; j > 0 && rects[j - 1].width * rects[j - 1].height
+                                 < r.width * r.height;
+             j--)
+            rects[j] = rects[j - 1];
+        rects[j] = r;
+    }
+
+    regions.mask = inpaint_mask;
+    regions.output = output_img;
+    regions.rects = rects;
+    regions.range = range;
+    regions.flags = flags;
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, count), icvInpaintRegions,
+                                      &regions, 1));
+
+    __END__;
+
+    cvFree(&rects);
+}
@@ -0,0 +1,833 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+#include "_cv.h"
+
+/* Connected component labeling of large masks.
+
+   cvConnectedComponents splits the image into horizontal bands that are
+   labeled in parallel:
+
+   - every band is scanned by runs of nonzero pixels. A run takes the label
+     of the runs it touches in the previous row of the band (their labels
+     are merged in the union-find forest of the band) or a new provisional
+     label. The area, the bounding box and the coordinate sums are
+     accumulated per provisional label;
+   - the provisional labels of all the bands are numbered consecutively and
+     the runs that touch across the first row of every band are merged in
+     the common forest. The root of a tree is always its smallest label,
+     i.e. the one of the first pixel of the component in raster order;
+   - one sequential pass over the provisional labels flattens the forest to
+     the final labels 1..n (the components are numbered in the raster order
+     of their first pixels) and sums up the statistics;
+   - the bands are relabeled in parallel.
+
+   The result does not depend on the number of bands (threads).
+
+   cvFindComponentContours traces the outer border of every component from
+   its first pixel like cvFindContours does. The components are traced in
+   parallel into per-thread buffers, and every contour is then copied to
+   the storage with a single cvSeqPushMulti. */
+
+#define ICV_LABEL_MIN_BAND 32 /* the smallest band height */
+
+typedef struct CvLabelStats
+{
+    int area;
+    int xmin, ymin, xmax, ymax;
+    CvPoint start;
+    double sx, sy;
+} CvLabelStats;
+
+typedef struct CvLabelBand
+{
+    int y0, y1;
+    int count;   /* the number of provisional labels */
+    int max_count;
+    int offset;  /* the number of provisional labels of the previous bands */
+    int* parent; /* the union-find forest of the band, 0-based */
+    CvLabelStats* stats;
+} CvLabelBand;
+
+typedef struct CvLabelJob
+{
+    const CvMat* mask;
+    CvMat* labels;
+    int connectivity;
+    CvLabelBand* bands;
+    const int* map; /* the final 0-based labels of the provisional ones */
+} CvLabelJob;
+
+CV_INLINE int icvFindLabel(int* parent, int i)
+{
+    int root = i;
+
+    while (parent[root] != root)
+        root = parent[root];
+
+    while (parent[i] != root)
+    {
+        int next = parent[i];
+        parent[i] = root;
+        i = next;
+    }
+
+    return root;
+}
+
+/* merges the trees of a and b by attaching the greater root to the smaller
+   one; returns the new root */
+CV_INLINE int icvMergeLabels(int* parent, int a, int b)
+{
+    a = icvFindLabel(parent, a);
+    b = icvFindLabel(parent, b);
+
+    if (a < b)
+        parent[b] = a;
+    else
+    {
+        parent[a] = b;
+        a = b;
+    }
+
+    return a;
+}
+
+static CvStatus icvGrowLabelBand(CvLabelBand* band)
+{
+    int max_count = MAX(band->max_count * 2, 256);
+    int* parent = (int*)cvAlloc(max_count * sizeof(parent[0]));
+    CvLabelStats* stats =
+        (CvLabelStats*)cvAlloc(max_count * sizeof(stats[0]));
+
+    if (!parent || !stats)
+    {
+        cvFree(&parent);
+        cvFree(&stats);
+        return CV_OUTOFMEM_ERR;
+    }
+
+    if (band->count > 0)
+    {
+        memcpy(parent, band->parent, band->count * sizeof(parent[0]));
+        memcpy(stats, band->stats, band->count * sizeof(stats[0]));
+    }
+    cvFree(&band->parent);
+    cvFree(&band->stats);
+    band->parent = parent;
+    band->stats = stats;
+    band->max_count = max_count;
+
+    return CV_OK;
+}
+
+/* returns the end of the run of zero (nonzero != 0: non-zero) pixels that
+   starts at x; the pixels are tested 8 at a time */
+CV_INLINE int icvLabelRunEnd(const uchar* src, int x, int width, int nonzero)
+{
+    const uint64 ones = (uint64)-1 / 255;
+    uint64 v;
+
+    for (; x + 8 <= width; x += 8)
+    {
+        memcpy(&v, src + x, sizeof(v));
+        if (nonzero ? ((v - ones) & ~v & (ones << 7)) != 0 : v != 0)
+            break;
+    }
+
+    if (nonzero)
+        for (; x < width && src[x] != 0; x++)
+            ;
+    else
+        for (; x < width && src[x] == 0; x++)
+            ;
+
+    return x;
+}
+
+/* labels the bands [start,end) with the provisional 1-based labels of the
+   bands */
+static int CV_CDECL icvLabelBands(int start, int end, void* arg)
+{
+    const CvLabelJob* job = (const CvLabelJob*)arg;
+    int width = job->mask->cols;
+    int ext = job->connectivity == 8; /* diagonal neighbours */
+    int b, y;
+
+    for (b = start; b < end; b++)
+    {
+        CvLabelBand* band = job->bands + b;
+
+        band->count = 0;
+        for (y = band->y0; y < band->y1; y++)
+        {
+            const uchar* src = job->mask->data.ptr + y * job->mask->step;
+            int* dst = (int*)(job->labels->data.ptr + y * job->labels->step);
+            const int* prev =
+                y > band->y0
+                    ? (const int*)((const uchar*)dst - job->labels->step)
+                    : 0;
+            int x = 0;
+
+            for (;;)
+            {
+                CvLabelStats* st;
+                int x0, x1, i, l = -1;
+
+                x0 = icvLabelRunEnd(src, x, width, 0);
+                for (; x < x0; x++)
+                    dst[x] = 0;
+                if (x >= width)
+                    break;
+
+                x = x1 = icvLabelRunEnd(src, x0, width, 1);
+
+                if (prev)
+                {
+                    int xb = MIN(x1 + ext, width);
+
+                    // the runs of the previous row have the same label
+                    // throughout, so only the first pixel of a run counts
+                    for (i = MAX(x0 - ext, 0); i < xb; i++)
+                    {
+                        if (prev[i] != 0)
+                        {
+                            int u = prev[i] - 1;
+
+                            l = l < 0 ? icvFindLabel(band->parent, u)
+                                      : icvMergeLabels(band->parent, l, u);
+                            for (i++; i < xb && prev[i] != 0; i++)
+                                ;
+                        }
+                    }
+                }
+
+                if (l < 0)
+                {
+                    if (band->count == band->max_count
+                        && icvGrowLabelBand(band) < 0)
+                        return CV_OUTOFMEM_ERR;
+
+                    l = band->count++;
+                    band->parent[l] = l;
+                    st = band->stats + l;
+                    st->area = 0;
+                    st->xmin = x0;
+                    st->xmax = x1 - 1;
+                    st->ymin = st->ymax = y;
+                    st->start = cvPoint(x0, y);
+                    st->sx = st->sy = 0;
+                }
+                else
+                {
+                    st = band->stats + l;
+                    st->xmin = MIN(st->xmin, x0);
+                    st->xmax = MAX(st->xmax, x1 - 1);
+                    st->ymin = MIN(st->ymin, y);
+                    st->ymax = MAX(st->ymax, y);
+                }
+
+                st->area += x1 - x0;
+                // (x0 + x1 - 1)*(x1 - x0) is even, so the sum is exact
+                st->sx += (double)(x0 + x1 - 1) * (x1 - x0) * 0.5;
+                st->sy += (double)y * (x1 - x0);
+
+                for (i = x0; i < x1; i++)
+                    dst[i] = l + 1;
+            }
+        }
+    }
+
+    return CV_OK;
+}
+
+/* replaces the provisional labels of the bands [start,end) with the final
+   ones */
+static int CV_CDECL icvRelabelBands(int start, int end, void* arg)
+{
+    const CvLabelJob* job = (const CvLabelJob*)arg;
+    int width = job->mask->cols;
+    int b, x, y;
+
+    for (b = start; b < end; b++)
+    {
+        const CvLabelBand* band = job->bands + b;
+        const int* map = job->map + band->offset - 1;
+
+        for (y = band->y0; y < band->y1; y++)
+        {
+            const uchar* src = job->mask->data.ptr + y * job->mask->step;
+            int* dst = (int*)(job->labels->data.ptr + y * job->labels->step);
+
+            // the background is already zero and a run has a single label
+            for (x = 0;;)
+            {
+                int x0 = icvLabelRunEnd(src, x, width, 0), l;
+
+                if (x0 >= width)
+                    break;
+
+                x = icvLabelRunEnd(src, x0, width, 1);
+                l = map[dst[x0]] + 1;
+                if (l != dst[x0])
+                {
+                    for (; x0 < x; x0++)
+                        dst[x0] = l;
+                }
+            }
+        }
+    }
+
+    return CV_OK;
+}
+
+/* merges the components that touch across the first row of the band b in
+   the common forest */
+static void icvMergeLabelBand(const CvLabelJob* job, int* parent, int b)
+{
+    const CvLabelBand* band = job->bands + b;
+    int width = job->labels->cols;
+    int ext = job->connectivity == 8;
+    const int* cur = (const int*)(job->labels->data.ptr
+                                  + band->y0 * job->labels->step);
+    const int* prev = (const int*)((const uchar*)cur - job->labels->step);
+    int offset = band->offset - 1, prev_offset = band[-1].offset - 1;
+    int x = 0, i;
+
+    for (;;)
+    {
+        int x0, xb;
+
+        for (; x < width && cur[x] == 0; x++)
+            ;
+        if (x >= width)
+            break;
+
+        x0 = x;
+        for (; x < width && cur[x] != 0; x++)
+            ;
+
+        xb = MIN(x + ext, width);
+        for (i = MAX(x0 - ext, 0); i < xb; i++)
+        {
+            if (prev[i] != 0)
+            {
+                icvMergeLabels(parent, offset + cur[x0],
+                               prev_offset + prev[i]);
+                for (i++; i < xb && prev[i] != 0; i++)
+                    ;
+            }
+        }
+    }
+}
+
+CV_IMPL int cvConnectedComponents(const CvArr* image, CvArr* labelarr,
+                                  int connectivity, CvMemStorage* storage,
+                                  CvSeq** stats)
+{
+    int count = 0;
+    int nbands = 0;
+    CvLabelBand* bands = 0;
+    int* parent = 0;
+    CvLabelStats* acc = 0;
+
+    CV_FUNCNAME("cvConnectedComponents");
+
+    __BEGIN__;
+
+    CvMat mstub, *mask = (CvMat*)image;
+    CvMat lstub, *labels = (CvMat*)labelarr;
+    CvLabelJob job;
+    int b, i, total;
+
+    if (stats)
+        *stats = 0;
+
+    CV_CALL(mask = cvGetMat(mask, &mstub));
+    CV_CALL(labels = cvGetMat(labels, &lstub));
+
+    if (CV_MAT_TYPE(mask->type) != CV_8UC1)
+        CV_ERROR(CV_StsUnsupportedFormat, "The image must be 8uC1");
+
+    if (CV_MAT_TYPE(labels->type) != CV_32SC1)
+        CV_ERROR(CV_StsUnsupportedFormat, "The labels must be 32sC1");
+
+    if (!CV_ARE_SIZES_EQ(mask, labels))
+        CV_ERROR(CV_StsUnmatchedSizes, "");
+
+    if (connectivity != 4 && connectivity != 8)
+        CV_ERROR(CV_StsBadFlag, "Connectivity must be 4 or 8");
+
+    if (stats && !storage)
+        CV_ERROR(CV_StsNullPtr, "The statistics require a storage");
+
+    nbands = cvGetNumThreads() > 1
+                 ? MIN(cvGetNumThreads() * 4, mask->rows / ICV_LABEL_MIN_BAND)
+                 : 1;
+    nbands = MAX(nbands, 1);
+
+    CV_CALL(bands = (CvLabelBand*)cvAlloc(nbands * sizeof(bands[0])));
+    memset(bands, 0, nbands * sizeof(bands[0]));
+    for (b = 0; b < nbands; b++)
+    {
+        bands[b].y0 = (int)((int64)mask->rows * b / nbands);
+        bands[b].y1 = (int)((int64)mask->rows * (b + 1) / nbands);
+    }
+
+    job.mask = mask;
+    job.labels = labels;
+    job.connectivity = connectivity;
+    job.bands = bands;
+    job.map = 0;
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nbands), icvLabelBands,
+                                      &job, 1));
+
+    for (b = 0, total = 0; b < nbands; b++)
+    {
+        bands[b].offset = total;
+        total += bands[b].count;
+    }
+
+    if (total > 0)
+    {
+        CV_CALL(parent = (int*)cvAlloc(total * sizeof(parent[0])));
+        for (b = 0; b < nbands; b++)
+        {
+            const CvLabelBand* band = bands + b;
+
+            for (i = 0; i < band->count; i++)
+                parent[band->offset + i] = band->offset + band->parent[i];
+        }
+
+        for (b = 1; b < nbands; b++)
+            icvMergeLabelBand(&job, parent, b);
+
+        // every provisional label is greater than its parent, so the parent
+        // is already replaced with the final label
+        for (i = 0; i < total; i++)
+            parent[i] = parent[i] == i ? count++ : parent[parent[i]];
+
+        job.map = parent;
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nbands),
+                                          icvRelabelBands, &job, 1));
+    }
+
+    if (stats)
+    {
+        CvSeqWriter writer;
+
+        CV_CALL(cvStartWriteSeq(0, sizeof(CvSeq), sizeof(CvComponentStats),
+                                storage, &writer));
+
+        if (count > 0)
+        {
+            CV_CALL(acc = (CvLabelStats*)cvAlloc(count * sizeof(acc[0])));
+            memset(acc, 0, count * sizeof(acc[0]));
+
+            // the provisional labels go in the raster order of their first
+            // pixels, so the first one of a component sets its start point
+            for (b = 0; b < nbands; b++)
+            {
+                const CvLabelBand* band = bands + b;
+
+                for (i = 0; i < band->count; i++)
+                {
+                    const CvLabelStats* src = band->stats + i;
+                    CvLabelStats* dst = acc + parent[band->offset + i];
+
+                    if (dst->area == 0)
+                        *dst = *src;
+                    else
+                    {
+                        dst->area += src->area;
+                        dst->xmin = MIN(dst->xmin, src->xmin);
+                        dst->ymin = MIN(dst->ymin, src->ymin);
+                        dst->xmax = MAX(dst->xmax, src->xmax);
+                        dst->ymax = MAX(dst->ymax, src->ymax);
+                        dst->sx += src->sx;
+                        dst->sy += src->sy;
+                    }
+                }
+            }
+
+            for (i = 0; i < count; i++)
+            {
+                CvComponentStats cs;
+
+                cs.area = acc[i].area;
+                cs.rect = cvRect(acc[i].xmin, acc[i].ymin,
+                                 acc[i].xmax - acc[i].xmin + 1,
+                                 acc[i].ymax - acc[i].ymin + 1);
+                cs.centroid = cvPoint2D64f(acc[i].sx / acc[i].area,
+                                           acc[i].sy / acc[i].area);
+                cs.start = acc[i].start;
+                CV_WRITE_SEQ_ELEM(cs, writer);
+            }
+        }
+
+        CV_CALL(*stats = cvEndWriteSeq(&writer));
+    }
+
+    __END__;
+
+    if (bands)
+    {
+        for (int b = 0; b < nbands; b++)
+        {
+            cvFree(&bands[b].parent);
+            cvFree(&bands[b].stats);
+        }
+        cvFree(&bands);
+    }
+    cvFree(&parent);
+    cvFree(&acc);
+
+    return count;
+}
+
+/****************************************************************************************\
+*                                 Component contours *
+\****************************************************************************************/
+
+/* the chain code offsets, repeated twice */
+static const CvPoint icvComponentCodeDeltas[16] = {
+    { 1, 0 },  { 1, -1 }, { 0, -1 }, { -1, -1 }, { -1, 0 }, { -1, 1 },
+    { 0, 1 },  { 1, 1 },  { 1, 0 },  { 1, -1 },  { 0, -1 }, { -1, -1 },
+    { -1, 0 }, { -1, 1 }, { 0, 1 },  { 1, 1 }
+};
+
+typedef struct CvContourBuffer
+{
+    char* data;
+    int size, max_size; /* in bytes */
+} CvContourBuffer;
+
+typedef struct CvComponentContour
+{
+    int thread; /* the buffer that holds the contour */
+    int offset; /* in bytes */
+    int count;
+} CvComponentContour;
+
+typedef struct CvComponentContourJob
+{
+    const CvMat* labels;
+    const CvComponentStats* stats;
+    int method;
+    int elem_size;
+    CvPoint offset;
+    CvContourBuffer* buffers;
+    CvComponentContour* contours;
+} CvComponentContourJob;
+
+static CvStatus icvGrowContourBuffer(CvContourBuffer* buf)
+{
+    int max_size = MAX(buf->max_size * 2, 1 << 12);
+    char* data = (char*)cvAlloc(max_size);
+
+    if (!data)
+        return CV_OUTOFMEM_ERR;
+
+    if (buf->size > 0)
+        memcpy(data, buf->data, buf->size);
+    cvFree(&buf->data);
+    buf->data = data;
+    buf->max_size = max_size;
+
+    return CV_OK;
+}
+
+/* follows the outer border of the component from its first pixel in the
+   same way as icvFetchContour does. The pixels out of the image do not
+   belong to the component; the bounds are checked only if the bounding box
+   of the component touches the image edge */
+static CvStatus icvTraceComponent(const CvComponentContourJob* job, int id,
+                                  CvContourBuffer* buf,
+                                  CvComponentContour* contour)
+{
+    const CvMat* labels = job->labels;
+    const CvComponentStats* st = job->stats + id - 1;
+    const CvPoint* codes = icvComponentCodeDeltas;
+    int width = labels->cols, height = labels->rows;
+    int step = labels->step / sizeof(int);
+    int checked = st->rect.x <= 0 || st->rect.y <= 0
+                  || st->rect.x + st->rect.width >= width
+                  || st->rect.y + st->rect.height >= height;
+    CvPoint p = st->start, pt;
+    const int *i0, *i1, *i3, *i4;
+    int deltas[16];
+    int s, s_end, prev_s, k;
+
+#define ICV_IN_COMPONENT(x, y, ptr)                                   \
+    ((!checked                                                        \
+      || ((unsigned)(x) < (unsigned)width                             \
+          && (unsigned)(y) < (unsigned)height))                       \
+     && *(ptr) == id)
+
+#define ICV_WRITE_CONTOUR_ELEM(elem)                                  \
+    {                                                                 \
+        if (buf->size + (int)sizeof(elem) > buf->max_size             \
+            && icvGrowContourBuffer(buf) < 0)                         \
+            return CV_OUTOFMEM_ERR;                                   \
+        memcpy(buf->data + buf->size, &(elem), sizeof(elem));         \
+        buf->size += (int)sizeof(elem);                               \
+        contour->count++;                                             \
+    }
+
+    contour->thread = (int)(buf - job->buffers);
+    contour->offset = buf->size;
+    contour->count = 0;
+
+    if ((unsigned)p.x >= (unsigned)width || (unsigned)p.y >= (unsigned)height)
+        return CV_BADARG_ERR;
+
+    i0 = (const int*)(labels->data.ptr + p.y * labels->step) + p.x;
+    if (*i0 != id)
+        return CV_BADARG_ERR;
+
+    for (k = 0; k < 16; k++)
+        deltas[k] = codes[k].y * step + codes[k].x;
+
+    s_end = s = 4;
+    do
+    {
+        s = (s - 1) & 7;
+        i1 = i0 + deltas[s];
+        if (ICV_IN_COMPONENT(p.x + codes[s].x, p.y + codes[s].y, i1))
+            break;
+    } while (s != s_end);
+
+    if (s == s_end) /* single pixel component */
+    {
+        if (job->method != CV_CHAIN_CODE)
+        {
+            pt = cvPoint(p.x + job->offset.x, p.y + job->offset.y);
+            ICV_WRITE_CONTOUR_ELEM(pt);
+        }
+        return CV_OK;
+    }
+
+    i3 = i0;
+    prev_s = s ^ 4;
+
+    for (;;)
+    {
+        for (;;)
+        {
+            k = ++s;
+            i4 = i3 + deltas[k];
+            if (ICV_IN_COMPONENT(p.x + codes[k].x, p.y + codes[k].y, i4))
+                break;
+        }
+        s &= 7;
+
+        if (job->method == CV_CHAIN_CODE)
+        {
+            char code = (char)s;
+
+            ICV_WRITE_CONTOUR_ELEM(code);
+        }
+        else if (s != prev_s || job->method == CV_CHAIN_APPROX_NONE)
+        {
+            pt = cvPoint(p.x + job->offset.x, p.y + job->offset.y);
+            ICV_WRITE_CONTOUR_ELEM(pt);
+            prev_s = s;
+        }
+
+        if (i4 == i0 && i3 == i1)
+            break;
+
+        i3 = i4;
+        p.x += codes[s].x;
+        p.y += codes[s].y;
+        s = (s + 4) & 7;
+    }
+
+#undef ICV_IN_COMPONENT
+#undef ICV_WRITE_CONTOUR_ELEM
+
+    return CV_OK;
+}
+
+static int CV_CDECL icvTraceComponents(int start, int end, void* arg)
+{
+    const CvComponentContourJob* job = (const CvComponentContourJob*)arg;
+    CvContourBuffer* buf = job->buffers + cvGetThreadNum();
+    int i;
+
+    for (i = start; i < end; i++)
+    {
+        CvStatus status =
+            icvTraceComponent(job, i + 1, buf, job->contours + i);
+        if (status < 0)
+            return status;
+    }
+
+    return CV_OK;
+}
+
+CV_IMPL int cvFindComponentContours(const CvArr* labelarr,
+                                    const CvSeq* stats, CvMemStorage* storage,
+                                    CvSeq** first_contour, int header_size,
+                                    int method, CvPoint offset)
+{
+    int count = 0;
+    int nthreads = 0;
+    CvComponentStats* stat_buf = 0;
+    CvContourBuffer* buffers = 0;
+    CvComponentContour* contours = 0;
+
+    CV_FUNCNAME("cvFindComponentContours");
+
+    __BEGIN__;
+
+    CvMat lstub, *labels = (CvMat*)labelarr;
+    CvComponentContourJob job;
+    CvSeq* prev = 0;
+    int i;
+
+    if (!first_contour)
+        CV_ERROR(CV_StsNullPtr, "NULL double CvSeq pointer");
+    *first_contour = 0;
+
+    if (!storage)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    CV_CALL(labels = cvGetMat(labels, &lstub));
+
+    if (CV_MAT_TYPE(labels->type) != CV_32SC1)
+        CV_ERROR(CV_StsUnsupportedFormat, "The labels must be 32sC1");
+
+    if (!CV_IS_SEQ(stats) || stats->elem_size != sizeof(CvComponentStats))
+        CV_ERROR(CV_StsBadArg,
+                 "The statistics must come from cvConnectedComponents");
+
+    if (method != CV_CHAIN_CODE && method != CV_CHAIN_APPROX_NONE
+        && method != CV_CHAIN_APPROX_SIMPLE)
+        CV_ERROR(CV_StsOutOfRange, "Unsupported approximation method");
+
+    if (header_size < (int)(method == CV_CHAIN_CODE ? sizeof(CvChain)
+                                                    : sizeof(CvContour)))
+        CV_ERROR(CV_StsBadSize, "Too small header size");
+
+    count = stats->total;
+    if (count == 0)
+        EXIT;
+
+    nthreads = cvGetNumThreads();
+    CV_CALL(stat_buf = (CvComponentStats*)cvAlloc(count
+                                                  * sizeof(stat_buf[0])));
+    CV_CALL(contours = (CvComponentContour*)cvAlloc(count
+                                                    * sizeof(contours[0])));
+    CV_CALL(buffers = (CvContourBuffer*)cvAlloc(nthreads
+                                                * sizeof(buffers[0])));
+    memset(buffers, 0, nthreads * sizeof(buffers[0]));
+    cvCvtSeqToArray(stats, stat_buf);
+
+    job.labels = labels;
+    job.stats = stat_buf;
+    job.method = method;
+    job.elem_size = method == CV_CHAIN_CODE ? sizeof(char) : sizeof(CvPoint);
+    job.offset = offset;
+    job.buffers = buffers;
+    job.contours = contours;
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, count), icvTraceComponents,
+                                      &job, 16));
+
+    for (i = 0; i < count; i++)
+    {
+        const CvComponentContour* c = contours + i;
+        const CvComponentStats* st = stat_buf + i;
+        CvSeq* seq;
+
+        CV_CALL(seq = cvCreateSeq(method == CV_CHAIN_CODE
+                                      ? CV_SEQ_CHAIN_CONTOUR
+                                      : CV_SEQ_POLYGON,
+                                  header_size, job.elem_size, storage));
+        // a sequence block of the contour size does not waste the rest
+        // of the default 1K block on the small contours
+        if (c->count > 0)
+        {
+            CV_CALL(cvSetSeqBlockSize(seq, c->count));
+            CV_CALL(cvSeqPushMulti(seq, buffers[c->thread].data + c->offset,
+                                   c->count));
+            CV_CALL(cvSetSeqBlockSize(seq, 0));
+        }
+
+        if (method == CV_CHAIN_CODE)
+            ((CvChain*)seq)->origin =
+                cvPoint(st->start.x + offset.x, st->start.y + offset.y);
+        else
+            ((CvContour*)seq)->rect =
+                cvRect(st->rect.x + offset.x, st->rect.y + offset.y,
+                       st->rect.width, st->rect.height);
+
+        seq->h_prev = prev;
+        if (prev)
+            prev->h_next = seq;
+        else
+            *first_contour = seq;
+        prev = seq;
+    }
+
+    __END__;
+
+    if (buffers)
+    {
+        for (int i = 0; i < nthreads; i++)
+            cvFree(&buffers[i].data);
+        cvFree(&buffers);
+    }
+    cvFree(&stat_buf);
+    cvFree(&contours);
+
+    return count;
+}
+
+/* End of file. */
@@ -0,0 +1,1026 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+#include "_cv.h"
+#include <float.h>
+
+/* Dense optical flow by the inverse search of patches
+   (T.Kroeger, R.Timofte, D.Dai, L.Van Gool, "Fast Optical Flow using Dense
+   Inverse Search", ECCV 2016):
+
+   - the flow is estimated coarse to fine on the pyramids of both frames;
+   - on every level the initial flow of the patches on a regular grid is
+     taken from the upscaled flow of the coarser level and refined by the
+     inverse compositional Gauss-Newton search of the patch of prev in curr
+     (the Hessian of the patch is computed once, the mean of the patch
+     difference is subtracted on every step);
+   - the dense flow is the weighted mean of the flows of the patches that
+     cover the pixel, with the weight 1/max(1,d^2), where d is the difference
+     of the pixel and its match;
+   - optionally, a few red-black SOR iterations of the variational energy
+     (Charbonnier-penalized brightness constancy and flow smoothness) are
+     done on every level.
+
+   Every stage is split between threads by rows (of pixels or of patches)
+   and every output value is computed by a single thread in a fixed order,
+   so the result does not depend on the number of threads. */
+
+#define ICV_DIS_PATCH 8         /* patch side */
+#define ICV_DIS_BORDER 16       /* replicated border of the pyramid levels */
+#define ICV_DIS_MAX_LEVELS 16
+#define ICV_DIS_REFINE_BUFS 11
+
+struct CvDISOpticalFlow
+{
+    int finest_level; /* the flow is estimated on levels finest..coarsest */
+    int stride;       /* distance between the patches */
+    int iters;        /* gradient descent iterations per patch */
+    int var_iters;    /* SOR iterations of the variational refinement */
+    float alpha;      /* smoothness weight of the refinement */
+    float delta;      /* brightness constancy weight of the refinement */
+
+    CvSize size;
+    int levels; /* levels 0..levels-1 are allocated */
+    int finest, coarsest; /* levels for this frame size */
+    int last;      /* pyramid of the last curr frame */
+    int have_last; /* pyr[last] holds a valid frame */
+
+    /* pyramids of the last two frames with ICV_DIS_BORDER replicated
+       pixels on each side and the headers of their interiors */
+    CvMat* pyr_buf[2][ICV_DIS_MAX_LEVELS];
+    CvMat pyr[2][ICV_DIS_MAX_LEVELS];
+
+    /* gradients of prev (multiplied by 8) */
+    CvMat* grad_x[ICV_DIS_MAX_LEVELS];
+    CvMat* grad_y[ICV_DIS_MAX_LEVELS];
+
+    /* dense flow */
+    CvMat* flow_x[ICV_DIS_MAX_LEVELS];
+    CvMat* flow_y[ICV_DIS_MAX_LEVELS];
+
+    /* flows of the patches, densification sums and refinement data; they
+       are allocated for the finest level and reused by the coarser ones */
+    CvMat* patch_flow;
+    CvMat* acc[3];
+    CvMat* refine[ICV_DIS_REFINE_BUFS];
+};
+
+/****************************************************************************************\
+*                                   Inner loops *
+\****************************************************************************************/
+
+/* sums of 8 lanes in the same order as the built-in SIMD version adds the
+   lanes of the register */
+CV_INLINE float icvDISSumLanes(const float* a)
+{
+    return ((a[0] + a[4]) + (a[2] + a[6])) + ((a[1] + a[5]) + (a[3] + a[7]));
+}
+
+/* Warps the 8x8 patch of curr with the bilinear weights w[0..3] (src points
+   to the top-left neighbour of the top-left pixel) and computes, over the
+   patch, sum(d), sum(d^2), sum(Ix*d) and sum(Iy*d), d = warped - prev */
+IPCVAPI_IMPL(CvStatus, icvDISPatch_32f_C1R,
+             (const float* src, int srcstep, const float* prev, int prevstep,
+              const float* gx, const float* gy, int gradstep, const float* w,
+              float* sums),
+             (src, srcstep, prev, prevstep, gx, gy, gradstep, w, sums))
+{
+    float s[4][ICV_DIS_PATCH];
+    int i, j;
+
+    for (j = 0; j < ICV_DIS_PATCH; j++)
+        s[0][j] = s[1][j] = s[2][j] = s[3][j] = 0;
+
+    srcstep /= sizeof(src[0]);
+    prevstep /= sizeof(prev[0]);
+    gradstep /= sizeof(gx[0]);
+
+    for (i = 0; i < ICV_DIS_PATCH; i++, src += srcstep, prev += prevstep,
+        gx += gradstep, gy += gradstep)
+    {
+        for (j = 0; j < ICV_DIS_PATCH; j++)
+        {
+            float t = w[0] * src[j] + w[1] * src[j + 1];
+            float d;
+            t += w[2] * src[j + srcstep];
+            t += w[3] * src[j + srcstep + 1];
+            d = t - prev[j];
+            s[0][j] += d;
+            s[1][j] += d * d;
+            s[2][j] += gx[j] * d;
+            s[3][j] += gy[j] * d;
+        }
+    }
+
+    for (i = 0; i < 4; i++)
+        sums[i] = icvDISSumLanes(s[i]);
+
+    return CV_OK;
+}
+
+/* Adds the contribution of the patch with the flow (u,v) to the rows of the
+   densification sums: wsum += c, usum += c*u, vsum += c*v, where
+   c = 1/max(1,d^2) and d is the difference of the warped curr and prev */
+IPCVAPI_IMPL(CvStatus, icvDISDensify_32f_C1R,
+             (const float* src, int srcstep, const float* prev, int prevstep,
+              const float* w, float u, float v, float* wsum, float* usum,
+              float* vsum, int accstep, int rows),
+             (src, srcstep, prev, prevstep, w, u, v, wsum, usum, vsum, accstep,
+              rows))
+{
+    int i, j;
+
+    srcstep /= sizeof(src[0]);
+    prevstep /= sizeof(prev[0]);
+    accstep /= sizeof(wsum[0]);
+
+    for (i = 0; i < rows; i++, src += srcstep, prev += prevstep,
+        wsum += accstep, usum += accstep, vsum += accstep)
+    {
+        for (j = 0; j < ICV_DIS_PATCH; j++)
+        {
+            float t = w[0] * src[j] + w[1] * src[j + 1];
+            float d, c;
+            t += w[2] * src[j + srcstep];
+            t += w[3] * src[j + srcstep + 1];
+            d = t - prev[j];
+            c = 1.f / MAX(d * d, 1.f);
+            wsum[j] += c;
+            usum[j] += c * u;
+            vsum[j] += c * v;
+        }
+    }
+
+    return CV_OK;
+}
+
+/* Returns the pointer to the top-left neighbour of the position (x,y) of the
+   padded level and the bilinear weights. The position is clipped, so that
+   the patch stays inside the replicated border */
+static const float* icvDISWarpPtr(const CvMat* img, float x, float y,
+                                  float* w)
+{
+    float xmax = (float)(img->cols + ICV_DIS_BORDER - ICV_DIS_PATCH - 1);
+    float ymax = (float)(img->rows + ICV_DIS_BORDER - ICV_DIS_PATCH - 1);
+    int ix, iy;
+    float ax, ay;
+
+    x = MIN(MAX(x, (float)-ICV_DIS_BORDER), xmax);
+    y = MIN(MAX(y, (float)-ICV_DIS_BORDER), ymax);
+    ix = cvFloor(x);
+    iy = cvFloor(y);
+    ax = x - ix;
+    ay = y - iy;
+    w[0] = (1.f - ax) * (1.f - ay);
+    w[1] = ax * (1.f - ay);
+    w[2] = (1.f - ax) * ay;
+    w[3] = ax * ay;
+
+    return (const float*)(img->data.ptr + iy * img->step) + ix;
+}
+
+/* the position of the patch; the last patches of the row and the column
+   are aligned with the image edge */
+CV_INLINE int icvDISPatchPos(int idx, int stride, int len)
+{
+    return MIN(idx * stride, len - ICV_DIS_PATCH);
+}
+
+CV_INLINE int icvDISPatchCount(int len, int stride)
+{
+    return (len - ICV_DIS_PATCH + stride - 1) / stride + 1;
+}
+
+/****************************************************************************************\
+*                                   Inverse search *
+\****************************************************************************************/
+
+typedef struct CvDISLevel
+{
+    const CvMat* prev;
+    const CvMat* curr; /* padded */
+    const CvMat* gx;
+    const CvMat* gy;
+    CvMat* flow_x;
+    CvMat* flow_y;
+    CvMat patch_flow; /* (u,v) pairs of the patches */
+    CvMat acc[3];
+    CvMat* refine; /* ICV_DIS_REFINE_BUFS headers */
+    int stride, iters, nx, ny;
+    float alpha, delta;
+    int color; /* red-black SOR pass */
+} CvDISLevel;
+
+/* computes sum(d^2) - sum(d)^2/n, the SSD of the mean-normalized patches,
+   and the mean-normalized Gauss-Newton step */
+static float icvDISEvalPatch(const CvDISLevel* l, int x0, int y0, float u,
+                             float v, const float* h, float* du, float* dv)
+{
+    const float n = (float)(ICV_DIS_PATCH * ICV_DIS_PATCH);
+    const float* src;
+    float w[4], s[4], bx, by;
+
+    src = icvDISWarpPtr(l->curr, x0 + u, y0 + v, w);
+    icvDISPatch_32f_C1R_p(src, l->curr->step,
+                          (const float*)(l->prev->data.ptr + y0 * l->prev->step)
+                              + x0,
+                          l->prev->step,
+                          (const float*)(l->gx->data.ptr + y0 * l->gx->step)
+                              + x0,
+                          (const float*)(l->gy->data.ptr + y0 * l->gy->step)
+                              + x0,
+                          l->gx->step, w, s);
+
+    // h[0..4] are xx, xy, yy, sum(Ix), sum(Iy) of the patch, the gradients
+    // are multiplied by 8, so the step is multiplied by 8 below
+    bx = s[2] - h[3] * s[0] / n;
+    by = s[3] - h[4] * s[0] / n;
+    *du = 8.f * (h[2] * bx - h[1] * by);
+    *dv = 8.f * (h[0] * by - h[1] * bx);
+
+    return s[1] - s[0] * s[0] / n;
+}
+
+static int CV_CDECL icvDISSearchBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    const float n = (float)(ICV_DIS_PATCH * ICV_DIS_PATCH);
+    int pi, pj, i, j, it;
+
+    for (pi = start; pi < end; pi++)
+    {
+        int y0 = icvDISPatchPos(pi, l->stride, l->prev->rows);
+        float* pf = (float*)(l->patch_flow.data.ptr
+                             + pi * l->patch_flow.step);
+
+        for (pj = 0; pj < l->nx; pj++)
+        {
+            int x0 = icvDISPatchPos(pj, l->stride, l->prev->cols);
+            float u0 = CV_MAT_ELEM(*l->flow_x, float, y0 + ICV_DIS_PATCH / 2,
+                                   x0 + ICV_DIS_PATCH / 2);
+            float v0 = CV_MAT_ELEM(*l->flow_y, float, y0 + ICV_DIS_PATCH / 2,
+                                   x0 + ICV_DIS_PATCH / 2);
+            // the match may go at most half the patch into the replicated
+            // border; farther the border stripes match almost anything
+            float umin = (float)(-x0 - ICV_DIS_PATCH / 2);
+            float umax = (float)(l->prev->cols - x0 - ICV_DIS_PATCH / 2);
+            float vmin = (float)(-y0 - ICV_DIS_PATCH / 2);
+            float vmax = (float)(l->prev->rows - y0 - ICV_DIS_PATCH / 2);
+            float u = MIN(MAX(u0, umin), umax), v = MIN(MAX(v0, vmin), vmax);
+            float best_u = u0, best_v = v0;
+            float h[5] = {0, 0, 0, 0, 0}, det, best = FLT_MAX;
+
+            for (i = 0; i < ICV_DIS_PATCH; i++)
+            {
+                const float* gx = (const float*)(l->gx->data.ptr
+                                                 + (y0 + i) * l->gx->step)
+                                  + x0;
+                const float* gy = (const float*)(l->gy->data.ptr
+                                                 + (y0 + i) * l->gy->step)
+                                  + x0;
+                for (j = 0; j < ICV_DIS_PATCH; j++)
+                {
+                    h[0] += gx[j] * gx[j];
+                    h[1] += gx[j] * gy[j];
+                    h[2] += gy[j] * gy[j];
+                    h[3] += gx[j];
+                    h[4] += gy[j];
+                }
+            }
+
+            h[0] -= h[3] * h[3] / n;
+            h[1] -= h[3] * h[4] / n;
+            h[2] -= h[4] * h[4] / n;
+            det = h[0] * h[2] - h[1] * h[1];
+
+            // the flat patches keep the initial flow
+            if (det > FLT_EPSILON * (h[0] + h[2]) * (h[0] + h[2]))
+            {
+                det = 1.f / det;
+                h[0] *= det;
+                h[1] *= det;
+                h[2] *= det;
+
+                for (it = 0; it <= l->iters; it++)
+                {
+                    float du, dv;
+                    float ssd = icvDISEvalPatch(l, x0, y0, u, v, h, &du, &dv);
+
+                    if (ssd < best)
+                    {
+                        best = ssd;
+                        best_u = u;
+                        best_v = v;
+                    }
+                    if (du * du + dv * dv < 1e-4f)
+                        break;
+                    u -= du;
+                    v -= dv;
+                    u = MIN(MAX(u, umin), umax);
+                    v = MIN(MAX(v, vmin), vmax);
+                }
+
+                // the patch that has run away is most likely mismatched
+                if (fabs(best_u - u0) > ICV_DIS_PATCH
+                    || fabs(best_v - v0) > ICV_DIS_PATCH)
+                {
+                    best_u = u0;
+                    best_v = v0;
+                }
+            }
+
+            pf[pj * 2] = best_u;
+            pf[pj * 2 + 1] = best_v;
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/****************************************************************************************\
+*                                   Densification *
+\****************************************************************************************/
+
+static int CV_CDECL icvDISDensifyBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    int rows = l->prev->rows, cols = l->prev->cols;
+    int y, x, pi, pj;
+
+    for (y = start; y < end; y++)
+    {
+        float* wsum = (float*)(l->acc[0].data.ptr + y * l->acc[0].step);
+        float* usum = (float*)(l->acc[1].data.ptr + y * l->acc[1].step);
+        float* vsum = (float*)(l->acc[2].data.ptr + y * l->acc[2].step);
+        for (x = 0; x < cols; x++)
+            wsum[x] = usum[x] = vsum[x] = 0;
+    }
+
+    // the patch rows are visited in the same order by all the bands, so
+    // every pixel gets the contributions in the same order
+    for (pi = MAX((start - ICV_DIS_PATCH) / l->stride, 0); pi < l->ny; pi++)
+    {
+        int y0 = icvDISPatchPos(pi, l->stride, rows);
+        int ya = MAX(y0, start), yb = MIN(y0 + ICV_DIS_PATCH, end);
+        const float* pf = (const float*)(l->patch_flow.data.ptr
+                                         + pi * l->patch_flow.step);
+
+        if (y0 >= end)
+            break;
+        if (ya >= yb)
+            continue;
+
+        for (pj = 0; pj < l->nx; pj++)
+        {
+            int x0 = icvDISPatchPos(pj, l->stride, cols);
+            float u = pf[pj * 2], v = pf[pj * 2 + 1], w[4];
+            const float* src = icvDISWarpPtr(l->curr, x0 + u, y0 + v, w);
+
+            src = (const float*)((const uchar*)src + (ya - y0) * l->curr->step);
+            icvDISDensify_32f_C1R_p(
+                src, l->curr->step,
+                (const float*)(l->prev->data.ptr + ya * l->prev->step) + x0,
+                l->prev->step, w, u, v,
+                (float*)(l->acc[0].data.ptr + ya * l->acc[0].step) + x0,
+                (float*)(l->acc[1].data.ptr + ya * l->acc[1].step) + x0,
+                (float*)(l->acc[2].data.ptr + ya * l->acc[2].step) + x0,
+                l->acc[0].step, yb - ya);
+        }
+    }
+
+    for (y = start; y < end; y++)
+    {
+        const float* wsum = (const float*)(l->acc[0].data.ptr
+                                           + y * l->acc[0].step);
+        const float* usum = (const float*)(l->acc[1].data.ptr
+                                           + y * l->acc[1].step);
+        const float* vsum = (const float*)(l->acc[2].data.ptr
+                                           + y * l->acc[2].step);
+        float* fx = (float*)(l->flow_x->data.ptr + y * l->flow_x->step);
+        float* fy = (float*)(l->flow_y->data.ptr + y * l->flow_y->step);
+
+        for (x = 0; x < cols; x++)
+        {
+            float s = 1.f / wsum[x];
+            fx[x] = usum[x] * s;
+            fy[x] = vsum[x] * s;
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/****************************************************************************************\
+*                                 Variational refinement *
+\****************************************************************************************/
+
+/* indices of the refinement buffers */
+enum
+{
+    ICV_DIS_WARPED = 0, /* curr warped by the flow */
+    ICV_DIS_PSI,        /* smoothness weight of the pixel */
+    ICV_DIS_A11,        /* data term: psi*Ix^2, psi*Ix*Iy, psi*Iy^2 */
+    ICV_DIS_A12,
+    ICV_DIS_A22,
+    ICV_DIS_B1, /* -psi*Ix*It and -psi*Iy*It plus the smoothness terms */
+    ICV_DIS_B2,
+    ICV_DIS_WX, /* smoothness weights of the links to the right and */
+    ICV_DIS_WY, /* bottom neighbours */
+    ICV_DIS_DU, /* flow increment */
+    ICV_DIS_DV
+};
+
+#define ICV_DIS_ROW(l, idx, y) \
+    ((float*)((l)->refine[idx].data.ptr + (y) * (l)->refine[idx].step))
+
+#define ICV_DIS_EPS2 1e-6f
+#define ICV_DIS_SOR_OMEGA 1.6f
+
+/* warps curr by the flow and computes the smoothness weights */
+static int CV_CDECL icvDISWarpBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    int rows = l->prev->rows, cols = l->prev->cols;
+    int y, x;
+
+    for (y = start; y < end; y++)
+    {
+        const float* fx = (const float*)(l->flow_x->data.ptr
+                                         + y * l->flow_x->step);
+        const float* fy = (const float*)(l->flow_y->data.ptr
+                                         + y * l->flow_y->step);
+        const float* fx1 = (const float*)((const uchar*)fx
+                                          + (y < rows - 1) * l->flow_x->step);
+        const float* fy1 = (const float*)((const uchar*)fy
+                                          + (y < rows - 1) * l->flow_y->step);
+        float* warped = ICV_DIS_ROW(l, ICV_DIS_WARPED, y);
+        float* psi = ICV_DIS_ROW(l, ICV_DIS_PSI, y);
+
+        for (x = 0; x < cols; x++)
+        {
+            int x1 = x + (x < cols - 1);
+            float w[4], ux, uy, vx, vy;
+            const float* src = icvDISWarpPtr(l->curr, x + fx[x], y + fy[x], w);
+            const float* src1 = (const float*)((const uchar*)src
+                                               + l->curr->step);
+
+            warped[x] = w[0] * src[0] + w[1] * src[1] + w[2] * src1[0]
+                        + w[3] * src1[1];
+
+            ux = fx[x1] - fx[x];
+            vx = fy[x1] - fy[x];
+            uy = fx1[x] - fx[x];
+            vy = fy1[x] - fy[x];
+            psi[x] = l->alpha
+                     / (float)sqrt(ux * ux + uy * uy + vx * vx + vy * vy
+                                   + ICV_DIS_EPS2);
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/* computes the coefficients of the energy linearized at the current flow;
+   intensities are scaled to [0,1] */
+static int CV_CDECL icvDISCoeffsBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    int rows = l->prev->rows, cols = l->prev->cols;
+    const float scale = 1.f / 255;
+    int y, x;
+
+    for (y = start; y < end; y++)
+    {
+        int y0 = MAX(y - 1, 0), y1 = MIN(y + 1, rows - 1);
+        const float* I0 = (const float*)(l->prev->data.ptr + y * l->prev->step);
+        const float* Iw = ICV_DIS_ROW(l, ICV_DIS_WARPED, y);
+        const float* Iw0 = ICV_DIS_ROW(l, ICV_DIS_WARPED, y0);
+        const float* Iw1 = ICV_DIS_ROW(l, ICV_DIS_WARPED, y1);
+        const float* psi = ICV_DIS_ROW(l, ICV_DIS_PSI, y);
+        const float* psi0 = ICV_DIS_ROW(l, ICV_DIS_PSI, y0);
+        const float* psi1 = ICV_DIS_ROW(l, ICV_DIS_PSI, y1);
+        const float* fx = (const float*)(l->flow_x->data.ptr
+                                         + y * l->flow_x->step);
+        const float* fy = (const float*)(l->flow_y->data.ptr
+                                         + y * l->flow_y->step);
+        const float* fx0 = (const float*)(l->flow_x->data.ptr
+                                          + y0 * l->flow_x->step);
+        const float* fy0 = (const float*)(l->flow_y->data.ptr
+                                          + y0 * l->flow_y->step);
+        const float* fx1 = (const float*)(l->flow_x->data.ptr
+                                          + y1 * l->flow_x->step);
+        const float* fy1 = (const float*)(l->flow_y->data.ptr
+                                          + y1 * l->flow_y->step);
+        float* a11 = ICV_DIS_ROW(l, ICV_DIS_A11, y);
+        float* a12 = ICV_DIS_ROW(l, ICV_DIS_A12, y);
+        float* a22 = ICV_DIS_ROW(l, ICV_DIS_A22, y);
+        float* b1 = ICV_DIS_ROW(l, ICV_DIS_B1, y);
+        float* b2 = ICV_DIS_ROW(l, ICV_DIS_B2, y);
+        float* wx = ICV_DIS_ROW(l, ICV_DIS_WX, y);
+        float* wy = ICV_DIS_ROW(l, ICV_DIS_WY, y);
+        float* du = ICV_DIS_ROW(l, ICV_DIS_DU, y);
+        float* dv = ICV_DIS_ROW(l, ICV_DIS_DV, y);
+        float ky = y > 0 && y < rows - 1 ? 0.5f * scale : scale;
+
+        for (x = 0; x < cols; x++)
+        {
+            int xl = x - (x > 0), xr = x + (x < cols - 1);
+            float kx = xr - xl == 2 ? 0.5f * scale : scale;
+            float Ix = (Iw[xr] - Iw[xl]) * kx;
+            float Iy = (Iw1[x] - Iw0[x]) * ky;
+            float It = (Iw[x] - I0[x]) * scale;
+            float psi_d = l->delta / (float)sqrt(It * It + ICV_DIS_EPS2);
+
+            // the links that cross the image border have zero weight
+            float wl = x > 0 ? 0.5f * (psi[x - 1] + psi[x]) : 0.f;
+            float wr = x < cols - 1 ? 0.5f * (psi[x] + psi[x + 1]) : 0.f;
+            float wu = y > 0 ? 0.5f * (psi0[x] + psi[x]) : 0.f;
+            float wd = y < rows - 1 ? 0.5f * (psi[x] + psi1[x]) : 0.f;
+
+            a11[x] = psi_d * Ix * Ix;
+            a12[x] = psi_d * Ix * Iy;
+            a22[x] = psi_d * Iy * Iy;
+            b1[x] = -psi_d * Ix * It + wl * (fx[xl] - fx[x])
+                    + wr * (fx[xr] - fx[x]) + wu * (fx0[x] - fx[x])
+                    + wd * (fx1[x] - fx[x]);
+            b2[x] = -psi_d * Iy * It + wl * (fy[xl] - fy[x])
+                    + wr * (fy[xr] - fy[x]) + wu * (fy0[x] - fy[x])
+                    + wd * (fy1[x] - fy[x]);
+            wx[x] = wr;
+            wy[x] = wd;
+            du[x] = dv[x] = 0.f;
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/* one red or black half-iteration of SOR; the pixels of one color depend
+   only on the pixels of the other one */
+static int CV_CDECL icvDISSORBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    int rows = l->prev->rows, cols = l->prev->cols;
+    int y, x;
+
+    for (y = start; y < end; y++)
+    {
+        int y0 = MAX(y - 1, 0), y1 = MIN(y + 1, rows - 1);
+        const float* a11 = ICV_DIS_ROW(l, ICV_DIS_A11, y);
+        const float* a12 = ICV_DIS_ROW(l, ICV_DIS_A12, y);
+        const float* a22 = ICV_DIS_ROW(l, ICV_DIS_A22, y);
+        const float* b1 = ICV_DIS_ROW(l, ICV_DIS_B1, y);
+        const float* b2 = ICV_DIS_ROW(l, ICV_DIS_B2, y);
+        const float* wx = ICV_DIS_ROW(l, ICV_DIS_WX, y);
+        const float* wy = ICV_DIS_ROW(l, ICV_DIS_WY, y);
+        const float* wy0 = ICV_DIS_ROW(l, ICV_DIS_WY, y0);
+        const float* du0 = ICV_DIS_ROW(l, ICV_DIS_DU, y0);
+        const float* du1 = ICV_DIS_ROW(l, ICV_DIS_DU, y1);
+        const float* dv0 = ICV_DIS_ROW(l, ICV_DIS_DV, y0);
+        const float* dv1 = ICV_DIS_ROW(l, ICV_DIS_DV, y1);
+        float* du = ICV_DIS_ROW(l, ICV_DIS_DU, y);
+        float* dv = ICV_DIS_ROW(l, ICV_DIS_DV, y);
+        float wu_mask = y > 0 ? 1.f : 0.f;
+
+        for (x = (y + l->color) & 1; x < cols; x += 2)
+        {
+            int xl = x - (x > 0), xr = x + (x < cols - 1);
+            float wl = x > 0 ? wx[x - 1] : 0.f, wr = wx[x];
+            float wu = wy0[x] * wu_mask, wd = wy[x];
+            float sw = wl + wr + wu + wd;
+            float nu = wl * du[xl] + wr * du[xr] + wu * du0[x] + wd * du1[x];
+            float nv = wl * dv[xl] + wr * dv[xr] + wu * dv0[x] + wd * dv1[x];
+            float t;
+
+            t = (b1[x] + nu - a12[x] * dv[x]) / (a11[x] + sw + FLT_EPSILON);
+            du[x] += ICV_DIS_SOR_OMEGA * (t - du[x]);
+            t = (b2[x] + nv - a12[x] * du[x]) / (a22[x] + sw + FLT_EPSILON);
+            dv[x] += ICV_DIS_SOR_OMEGA * (t - dv[x]);
+        }
+    }
+
+    return CV_StsOk;
+}
+
+static int CV_CDECL icvDISUpdateBand(int start, int end, void* arg)
+{
+    const CvDISLevel* l = (const CvDISLevel*)arg;
+    int y, x;
+
+    for (y = start; y < end; y++)
+    {
+        const float* du = ICV_DIS_ROW(l, ICV_DIS_DU, y);
+        const float* dv = ICV_DIS_ROW(l, ICV_DIS_DV, y);
+        float* fx = (float*)(l->flow_x->data.ptr + y * l->flow_x->step);
+        float* fy = (float*)(l->flow_y->data.ptr + y * l->flow_y->step);
+
+        for (x = 0; x < l->prev->cols; x++)
+        {
+            fx[x] += du[x];
+            fy[x] += dv[x];
+        }
+    }
+
+    return CV_StsOk;
+}
+
+/****************************************************************************************\
+*                                      Driver *
+\****************************************************************************************/
+
+static void icvDISReleaseBuffers(CvDISOpticalFlow* dis)
+{
+    int i;
+
+    for (i = 0; i < ICV_DIS_MAX_LEVELS; i++)
+    {
+        cvReleaseMat(&dis->pyr_buf[0][i]);
+        cvReleaseMat(&dis->pyr_buf[1][i]);
+        cvReleaseMat(&dis->grad_x[i]);
+        cvReleaseMat(&dis->grad_y[i]);
+        cvReleaseMat(&dis->flow_x[i]);
+        cvReleaseMat(&dis->flow_y[i]);
+    }
+
+    cvReleaseMat(&dis->patch_flow);
+    for (i = 0; i < 3; i++)
+        cvReleaseMat(&dis->acc[i]);
+    for (i = 0; i < ICV_DIS_REFINE_BUFS; i++)
+        cvReleaseMat(&dis->refine[i]);
+
+    dis->size = cvSize(0, 0);
+    dis->levels = 0;
+    dis->have_last = 0;
+}
+
+/* chooses the levels for the frame size and allocates the buffers */
+static void icvDISCreateBuffers(CvDISOpticalFlow* dis, CvSize size)
+{
+    CV_FUNCNAME("icvDISCreateBuffers");
+
+    __BEGIN__;
+
+    CvSize sz[ICV_DIS_MAX_LEVELS];
+    int i, k, finest, coarsest;
+
+    sz[0] = size;
+    for (k = 1; k < ICV_DIS_MAX_LEVELS; k++)
+        sz[k] = cvSize((sz[k - 1].width + 1) / 2, (sz[k - 1].height + 1) / 2);
+
+    if (MIN(size.width, size.height) < ICV_DIS_PATCH)
+        CV_ERROR(CV_StsBadSize, "The frames are smaller than the patch");
+
+    // every level must hold at least one patch; the coarsest level is
+    // the last one that is not smaller than 4 patches
+    finest = dis->finest_level;
+    while (finest > 0
+           && MIN(sz[finest].width, sz[finest].height) < ICV_DIS_PATCH)
+        finest--;
+    coarsest = finest;
+    while (coarsest < ICV_DIS_MAX_LEVELS - 1
+           && MAX(sz[coarsest + 1].width, sz[coarsest + 1].height)
+                  >= ICV_DIS_PATCH * 4
+           && MIN(sz[coarsest + 1].width, sz[coarsest + 1].height)
+                  >= ICV_DIS_PATCH)
+        coarsest++;
+
+    for (k = 0; k <= coarsest; k++)
+        for (i = 0; i < 2; i++)
+        {
+            CV_CALL(dis->pyr_buf[i][k] = cvCreateMat(
+                        sz[k].height + ICV_DIS_BORDER * 2,
+                        sz[k].width + ICV_DIS_BORDER * 2, CV_32FC1));
+            cvGetSubRect(dis->pyr_buf[i][k], &dis->pyr[i][k],
+                         cvRect(ICV_DIS_BORDER, ICV_DIS_BORDER, sz[k].width,
+                                sz[k].height));
+        }
+
+    for (k = finest; k <= coarsest; k++)
+    {
+        CV_CALL(dis->grad_x[k] = cvCreateMat(sz[k].height, sz[k].width,
+                                             CV_32FC1));
+        CV_CALL(dis->grad_y[k] = cvCreateMat(sz[k].height, sz[k].width,
+                                             CV_32FC1));
+        CV_CALL(dis->flow_x[k] = cvCreateMat(sz[k].height, sz[k].width,
+                                             CV_32FC1));
+        CV_CALL(dis->flow_y[k] = cvCreateMat(sz[k].height, sz[k].width,
+                                             CV_32FC1));
+    }
+
+    CV_CALL(dis->patch_flow = cvCreateMat(
+                icvDISPatchCount(sz[finest].height, dis->stride),
+                icvDISPatchCount(sz[finest].width, dis->stride), CV_32FC2));
+    for (i = 0; i < 3; i++)
+        CV_CALL(dis->acc[i] = cvCreateMat(sz[finest].height,
+                                          sz[finest].width, CV_32FC1));
+    if (dis->var_iters > 0)
+        for (i = 0; i < ICV_DIS_REFINE_BUFS; i++)
+            CV_CALL(dis->refine[i] = cvCreateMat(sz[finest].height,
+                                                 sz[finest].width, CV_32FC1));
+
+    dis->size = size;
+    dis->levels = coarsest + 1;
+    dis->finest = finest;
+    dis->coarsest = coarsest;
+
+    __END__;
+
+    if (cvGetErrStatus() < 0)
+        icvDISReleaseBuffers(dis);
+}
+
+/* replicates the edge pixels of the level interior into its border */
+static void icvDISFillBorder(CvMat* buf)
+{
+    int rows = buf->rows, cols = buf->cols, b = ICV_DIS_BORDER;
+    int y, x;
+
+    for (y = b; y < rows - b; y++)
+    {
+        float* row = (float*)(buf->data.ptr + y * buf->step);
+        float left = row[b], right = row[cols - b - 1];
+
+        for (x = 0; x < b; x++)
+        {
+            row[x] = left;
+            row[cols - 1 - x] = right;
+        }
+    }
+
+    for (y = 0; y < b; y++)
+    {
+        memcpy(buf->data.ptr + y * buf->step, buf->data.ptr + b * buf->step,
+               cols * sizeof(float));
+        memcpy(buf->data.ptr + (rows - 1 - y) * buf->step,
+               buf->data.ptr + (rows - 1 - b) * buf->step,
+               cols * sizeof(float));
+    }
+}
+
+static void icvDISBuildPyramid(CvDISOpticalFlow* dis, int idx,
+                               const CvMat* img)
+{
+    CV_FUNCNAME("icvDISBuildPyramid");
+
+    __BEGIN__;
+
+    int k;
+
+    CV_CALL(cvConvert(img, &dis->pyr[idx][0]));
+    for (k = 1; k < dis->levels; k++)
+        CV_CALL(cvPyrDown(&dis->pyr[idx][k - 1], &dis->pyr[idx][k]));
+    for (k = dis->finest; k < dis->levels; k++)
+        icvDISFillBorder(dis->pyr_buf[idx][k]);
+
+    __END__;
+}
+
+CV_IMPL CvDISOpticalFlow* cvCreateDISOpticalFlow(int preset)
+{
+    CvDISOpticalFlow* dis = 0;
+
+    CV_FUNCNAME("cvCreateDISOpticalFlow");
+
+    __BEGIN__;
+
+    if (preset != CV_DISFLOW_ULTRAFAST && preset != CV_DISFLOW_FAST
+        && preset != CV_DISFLOW_MEDIUM)
+        CV_ERROR(CV_StsBadArg, "Unknown preset");
+
+    CV_CALL(dis = (CvDISOpticalFlow*)cvAlloc(sizeof(*dis)));
+    memset(dis, 0, sizeof(*dis));
+
+    dis->finest_level = preset == CV_DISFLOW_MEDIUM ? 1 : 2;
+    dis->stride = 4;
+    dis->iters = preset == CV_DISFLOW_ULTRAFAST ? 12
+                 : preset == CV_DISFLOW_FAST    ? 16
+                                                : 25;
+    dis->var_iters = preset == CV_DISFLOW_ULTRAFAST ? 0 : 5;
+    dis->alpha = 20.f;
+    dis->delta = 5.f;
+
+    __END__;
+
+    return dis;
+}
+
+CV_IMPL void cvReleaseDISOpticalFlow(CvDISOpticalFlow** _dis)
+{
+    CV_FUNCNAME("cvReleaseDISOpticalFlow");
+
+    __BEGIN__;
+
+    if (!_dis)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    if (*_dis)
+    {
+        icvDISReleaseBuffers(*_dis);
+        cvFree(_dis);
+    }
+
+    __END__;
+}
+
+CV_IMPL void cvCalcOpticalFlowDIS(CvDISOpticalFlow* dis, const CvArr* _prev,
+                                  const CvArr* _curr, CvArr* _velx,
+                                  CvArr* _vely, int flags)
+{
+    CV_FUNCNAME("cvCalcOpticalFlowDIS");
+
+    __BEGIN__;
+
+    CvMat prev_stub, *prev = (CvMat*)_prev;
+    CvMat curr_stub, *curr = (CvMat*)_curr;
+    CvMat velx_stub, *velx = (CvMat*)_velx;
+    CvMat vely_stub, *vely = (CvMat*)_vely;
+    CvDISLevel l;
+    CvMat refine[ICV_DIS_REFINE_BUFS];
+    CvSize size;
+    int a, b, k, i, it;
+
+    if (!dis)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    CV_CALL(prev = cvGetMat(prev, &prev_stub));
+    CV_CALL(curr = cvGetMat(curr, &curr_stub));
+    CV_CALL(velx = cvGetMat(velx, &velx_stub));
+    CV_CALL(vely = cvGetMat(vely, &vely_stub));
+
+    if (!CV_ARE_SIZES_EQ(prev, curr) || !CV_ARE_SIZES_EQ(velx, vely)
+        || !CV_ARE_SIZES_EQ(prev, velx))
+        CV_ERROR(CV_StsUnmatchedSizes, "");
+
+    if (CV_MAT_TYPE(prev->type) != CV_8UC1
+        || CV_MAT_TYPE(curr->type) != CV_8UC1
+        || CV_MAT_TYPE(velx->type) != CV_32FC1
+        || CV_MAT_TYPE(vely->type) != CV_32FC1)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "Source images must have 8uC1 type and "
+                 "destination images must have 32fC1 type");
+
+    size = cvGetMatSize(prev);
+    if (size.width != dis->size.width || size.height != dis->size.height)
+    {
+        icvDISReleaseBuffers(dis);
+        CV_CALL(icvDISCreateBuffers(dis, size));
+    }
+
+    // the pyramid of curr of the previous call is the pyramid of prev now
+    if ((flags & CV_LKFLOW_PYR_A_READY) && dis->have_last)
+        a = dis->last;
+    else
+    {
+        a = 0;
+        CV_CALL(icvDISBuildPyramid(dis, a, prev));
+    }
+    b = a ^ 1;
+    dis->have_last = 0;
+    CV_CALL(icvDISBuildPyramid(dis, b, curr));
+    dis->last = b;
+    dis->have_last = 1;
+
+    for (k = dis->finest; k < dis->levels; k++)
+    {
+        CV_CALL(cvSobel(&dis->pyr[a][k], dis->grad_x[k], 1, 0, 3));
+        CV_CALL(cvSobel(&dis->pyr[a][k], dis->grad_y[k], 0, 1, 3));
+    }
+
+    k = dis->coarsest;
+    if (flags & CV_LKFLOW_INITIAL_GUESSES)
+    {
+        double scale = 1. / (1 << k);
+        CV_CALL(cvResize(velx, dis->flow_x[k], CV_INTER_AREA));
+        CV_CALL(cvResize(vely, dis->flow_y[k], CV_INTER_AREA));
+        cvScale(dis->flow_x[k], dis->flow_x[k], scale);
+        cvScale(dis->flow_y[k], dis->flow_y[k], scale);
+    }
+    else
+    {
+        cvZero(dis->flow_x[k]);
+        cvZero(dis->flow_y[k]);
+    }
+
+    for (; k >= dis->finest; k--)
+    {
+        CvSize lsize = cvGetMatSize(dis->flow_x[k]);
+
+        if (k < dis->coarsest)
+        {
+            CV_CALL(cvResize(dis->flow_x[k + 1], dis->flow_x[k],
+                             CV_INTER_LINEAR));
+            CV_CALL(cvResize(dis->flow_y[k + 1], dis->flow_y[k],
+                             CV_INTER_LINEAR));
+            cvScale(dis->flow_x[k], dis->flow_x[k], 2.);
+            cvScale(dis->flow_y[k], dis->flow_y[k], 2.);
+        }
+
+        l.prev = &dis->pyr[a][k];
+        l.curr = &dis->pyr[b][k];
+        l.gx = dis->grad_x[k];
+        l.gy = dis->grad_y[k];
+        l.flow_x = dis->flow_x[k];
+        l.flow_y = dis->flow_y[k];
+        l.stride = dis->stride;
+        l.iters = dis->iters;
+        l.nx = icvDISPatchCount(lsize.width, dis->stride);
+        l.ny = icvDISPatchCount(lsize.height, dis->stride);
+        l.alpha = dis->alpha;
+        l.delta = dis->delta;
+        l.color = 0;
+        l.refine = refine;
+        cvGetSubRect(dis->patch_flow, &l.patch_flow,
+                     cvRect(0, 0, l.nx, l.ny));
+        for (i = 0; i < 3; i++)
+            cvGetSubRect(dis->acc[i], &l.acc[i],
+                         cvRect(0, 0, lsize.width, lsize.height));
+
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, l.ny), icvDISSearchBand,
+                                          &l, 1));
+        IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, lsize.height),
+                                          icvDISDensifyBand, &l,
+                                          ICV_DIS_PATCH * 2));
+
+        if (dis->var_iters > 0)
+        {
+            for (i = 0; i < ICV_DIS_REFINE_BUFS; i++)
+                cvGetSubRect(dis->refine[i], &refine[i],
+                             cvRect(0, 0, lsize.width, lsize.height));
+
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, lsize.height),
+                                              icvDISWarpBand, &l, 8));
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, lsize.height),
+                                              icvDISCoeffsBand, &l, 8));
+            for (it = 0; it < dis->var_iters * 2; it++)
+            {
+                l.color = it & 1;
+                IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, lsize.height),
+                                                  icvDISSORBand, &l, 8));
+            }
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, lsize.height),
+                                              icvDISUpdateBand, &l, 8));
+        }
+    }
+
+    k = dis->finest;
+    if (k == 0)
+    {
+        cvCopy(dis->flow_x[0], velx);
+        cvCopy(dis->flow_y[0], vely);
+    }
+    else
+    {
+        CV_CALL(cvResize(dis->flow_x[k], velx, CV_INTER_LINEAR));
+        CV_CALL(cvResize(dis->flow_y[k], vely, CV_INTER_LINEAR));
+        cvScale(velx, velx, (double)(1 << k));
+        cvScale(vely, vely, (double)(1 << k));
+    }
+
+    __END__;
+}
+
+/* End of file. */
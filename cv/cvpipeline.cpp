@@ -0,0 +1,645 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "_cv.h"
+
+/****************************************************************************************\
+                                     Image Pipeline
+\****************************************************************************************/
+
+/* the rows of all the stages of one band are meant to stay in the cache; the
+   default band height is the number of source rows that make up this size.
+   it bounds the memory of the stages, the time hardly depends on it */
+#define ICV_PIPELINE_BAND_SIZE (1 << 19)
+#define ICV_PIPELINE_MIN_BAND 16
+
+enum
+{
+    ICV_PIPELINE_FILTER = 0,
+    ICV_PIPELINE_SMOOTH = 1,
+    ICV_PIPELINE_RESIZE = 2,
+    ICV_PIPELINE_CVT_COLOR = 3
+};
+
+/* A stage gets the consecutive rows of its input image and passes the rows
+   of its output image down the chain as soon as it has computed them. The
+   rows of the last stage go straight to the pipeline output. */
+struct CvPipelineStage
+{
+    int kind;
+    CvBaseImageFilter* filter;
+    bool own_filter;
+    int smooth_type, param1, param2;
+    double param3, param4;
+    CvSize dsize;
+    int method;
+    int code, dst_cn;
+
+    // the state of the current CvImagePipeline::process call
+    CvSize src_size, dst_size;
+    int src_type, dst_type;
+    int max_src_rows, max_dst_rows;
+    CvMat* buf;
+    CvMat* dst;
+    int dst_y;
+    bool started;
+
+    // a resize keeps the source rows that the next destination rows read;
+    // the first stage reads the pipeline input directly
+    CvResizeState* resize;
+    CvMat* window;
+    int win_y0, win_y1, need_y1;
+    const uchar* src_data;
+    int src_step;
+};
+
+static CvMat icvPipelineRows(int rows, int cols, int type, const uchar* data,
+                             int step)
+{
+    CvMat mat = cvMat(rows, cols, type, (void*)data);
+    mat.step = step;
+    if (rows > 1 && step != mat.cols * CV_ELEM_SIZE(type))
+        mat.type &= ~CV_MAT_CONT_FLAG;
+    return mat;
+}
+
+static void icvPipelineInitSmooth(CvPipelineStage* stage, CvSize size,
+                                  int type)
+{
+    CV_FUNCNAME("icvPipelineInitSmooth");
+
+    __BEGIN__;
+
+    int depth = CV_MAT_DEPTH(type);
+    int param1 = stage->param1, param2 = stage->param2;
+
+    if (stage->smooth_type == CV_GAUSSIAN)
+    {
+        double sigma1 = stage->param3;
+        double sigma2 = stage->param4 ? stage->param4 : stage->param3;
+        float *kx, *ky;
+        CvMat KX, KY;
+
+        // automatic detection of kernel size from sigma, as in cvSmooth
+        if (param1 == 0 && sigma1 > 0)
+            param1 = cvRound(sigma1 * (depth == CV_8U ? 3 : 4) * 2 + 1) | 1;
+        if (param2 == 0 && sigma2 > 0)
+            param2 = cvRound(sigma2 * (depth == CV_8U ? 3 : 4) * 2 + 1) | 1;
+        if (param2 == 0)
+            param2 = param1;
+        if (param1 < 1 || (param1 & 1) == 0 || param2 < 1 || (param2 & 1) == 0)
+            CV_ERROR(CV_StsOutOfRange,
+                     "Both mask width and height must be >=1 and odd");
+
+        kx = (float*)cvStackAlloc(param1 * sizeof(kx[0]));
+        ky = (float*)cvStackAlloc(param2 * sizeof(ky[0]));
+        KX = cvMat(1, param1, CV_32F, kx);
+        KY = cvMat(1, param2, CV_32F, ky);
+
+        CvSepFilter::init_gaussian_kernel(&KX, sigma1);
+        if (param1 != param2 || fabs(sigma1 - sigma2) > FLT_EPSILON)
+            CvSepFilter::init_gaussian_kernel(&KY, sigma2);
+        else
+            KY.data.fl = kx;
+
+        CV_CALL(((CvSepFilter*)stage->filter)
+                    ->init(size.width, type, type, &KX, &KY));
+    }
+    else
+    {
+        if (param2 == 0)
+            param2 = param1;
+        if (param1 < 1 || (param1 & 1) == 0 || param2 < 1 || (param2 & 1) == 0)
+            CV_ERROR(CV_StsOutOfRange,
+                     "Both mask width and height must be >=1 and odd");
+
+        CV_CALL(((CvBoxFilter*)stage->filter)
+                    ->init(size.width, type, type, true,
+                           cvSize(param1, param2)));
+    }
+
+    __END__;
+}
+
+/* sets up the stage for the input of the given size and type and allocates
+   its buffers; max_src_rows must be set by the caller */
+static void icvPipelineInitStage(CvPipelineStage* stage, CvSize size, int type,
+                                 const CvMat* src, bool is_last)
+{
+    CV_FUNCNAME("icvPipelineInitStage");
+
+    __BEGIN__;
+
+    int max_rows = stage->max_src_rows;
+
+    stage->src_size = stage->dst_size = size;
+    stage->src_type = stage->dst_type = type;
+    stage->dst_y = 0;
+    stage->started = false;
+
+    if (stage->kind == ICV_PIPELINE_FILTER
+        || stage->kind == ICV_PIPELINE_SMOOTH)
+    {
+        if (stage->kind == ICV_PIPELINE_SMOOTH)
+            CV_CALL(icvPipelineInitSmooth(stage, size, type));
+
+        if (stage->filter->get_src_type() != type)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "The filter input type differs from the stage input");
+        stage->dst_type = stage->filter->get_dst_type();
+
+        // the last call produces the rows kept by the filter as well
+        stage->max_dst_rows =
+            max_rows + stage->filter->get_kernel_size().height;
+    }
+    else if (stage->kind == ICV_PIPELINE_RESIZE)
+    {
+        CvSize dsize = stage->dsize;
+        int srcstep, dy, span = 0;
+
+        if (stage->method == CV_INTER_AREA && size.width >= dsize.width
+            && size.height >= dsize.height
+            && (size.width % dsize.width != 0
+                || size.height % dsize.height != 0))
+            CV_ERROR(CV_StsNotImplemented,
+                     "The general \"area\" decimation needs the whole image");
+
+        stage->dst_size = dsize;
+        srcstep = src ? src->step : size.width * CV_ELEM_SIZE(type);
+        CV_CALL(stage->resize = icvCreateResizeState(size, dsize, type,
+                                                     srcstep, stage->method));
+
+        for (dy = 0; dy < dsize.height; dy++)
+        {
+            CvSlice rows = icvResizeSourceRows(stage->resize,
+                                               cvSlice(dy, dy + 1));
+            span = MAX(span, rows.end_index - rows.start_index);
+        }
+
+        stage->need_y1 =
+            icvResizeSourceRows(stage->resize,
+                                cvSlice(dsize.height - 1, dsize.height))
+                .end_index;
+        stage->win_y0 = stage->win_y1 = 0;
+
+        if (src)
+        {
+            stage->src_data = src->data.ptr;
+            stage->src_step = src->step;
+        }
+        else
+            CV_CALL(stage->window =
+                        cvCreateMat(span + max_rows, size.width, type));
+
+        stage->max_dst_rows = MAX(
+            cvRound((double)max_rows * dsize.height / size.height), 1);
+    }
+    else
+    {
+        stage->dst_type = CV_MAKETYPE(CV_MAT_DEPTH(type), stage->dst_cn);
+        stage->max_dst_rows = max_rows;
+    }
+
+    if (!is_last)
+        CV_CALL(stage->buf = cvCreateMat(stage->max_dst_rows,
+                                         stage->dst_size.width,
+                                         stage->dst_type));
+
+    __END__;
+}
+
+static void icvPipelineReleaseStage(CvPipelineStage* stage)
+{
+    cvReleaseMat(&stage->buf);
+    cvReleaseMat(&stage->window);
+    icvReleaseResizeState(&stage->resize);
+    stage->dst = 0;
+    stage->src_data = 0;
+}
+
+/* passes the rows [y, y + count) of the input image of stages[0] down the
+   chain; last is set for the call with the last rows of the image, it
+   always has some rows */
+static void icvPipelineFeed(CvPipelineStage** stages, int stage_count,
+                            const uchar* src, int srcstep, int y, int count,
+                            bool last)
+{
+    CV_FUNCNAME("icvPipelineFeed");
+
+    __BEGIN__;
+
+    CvPipelineStage* stage = stages[0];
+    CvMat* out = stage->buf ? stage->buf : stage->dst;
+    int out_y = stage->buf ? 0 : stage->dst_y;
+    uchar* dptr = out->data.ptr + out_y * out->step;
+    CvMat src_rows = icvPipelineRows(count, stage->src_size.width,
+                                     stage->src_type, src, srcstep);
+
+    if (stage->kind == ICV_PIPELINE_FILTER
+        || stage->kind == ICV_PIPELINE_SMOOTH)
+    {
+        int flags = last ? CV_END : CV_MIDDLE, rows;
+
+        if (!stage->started)
+        {
+            flags = last ? CV_WHOLE : CV_START;
+            stage->started = true;
+        }
+
+        CV_CALL(rows = stage->filter->process(&src_rows, out,
+                                              cvRect(0, 0, -1, -1),
+                                              cvPoint(0, out_y), flags));
+
+        // the first bands may only fill the kernel rows of the filter
+        if (rows > 0 && stage_count > 1)
+            CV_CALL(icvPipelineFeed(stages + 1, stage_count - 1, dptr,
+                                    out->step, stage->dst_y, rows, last));
+        stage->dst_y += rows;
+    }
+    else if (stage->kind == ICV_PIPELINE_RESIZE)
+    {
+        CvSize dsize = stage->dst_size;
+        int row_size = stage->src_size.width * CV_ELEM_SIZE(stage->src_type);
+        int avail = y + count, base_y, base_step;
+        const uchar* base;
+
+        if (stage->src_data)
+        {
+            base = stage->src_data;
+            base_y = 0;
+            base_step = stage->src_step;
+        }
+        else
+        {
+            CvMat* window = stage->window;
+            int keep_y = icvResizeSourceRows(stage->resize,
+                                             cvSlice(stage->dst_y,
+                                                     stage->dst_y + 1))
+                             .start_index;
+            int y0, y1;
+
+            // drop the rows that are above the next destination row
+            if (keep_y >= stage->win_y1)
+                stage->win_y0 = stage->win_y1 = MAX(keep_y, y);
+            else if (keep_y > stage->win_y0)
+            {
+                memmove(window->data.ptr,
+                        window->data.ptr
+                            + (keep_y - stage->win_y0) * window->step,
+                        (stage->win_y1 - keep_y) * window->step);
+                stage->win_y0 = keep_y;
+            }
+
+            // the rows below the source rows of the last destination row
+            // are not needed at all
+            y0 = MAX(y, stage->win_y1);
+            y1 = MIN(avail, stage->need_y1);
+            assert(y0 == stage->win_y1 || y1 <= y0);
+            assert(y1 - stage->win_y0 <= window->rows);
+
+            for (; y0 < y1; y0++, stage->win_y1++)
+                memcpy(window->data.ptr
+                           + (stage->win_y1 - stage->win_y0) * window->step,
+                       src + (y0 - y) * srcstep, row_size);
+
+            base = window->data.ptr;
+            base_y = stage->win_y0;
+            base_step = window->step;
+        }
+
+        while (stage->dst_y < dsize.height)
+        {
+            int dy0 = stage->dst_y;
+            int dy1 = MIN(dy0 + stage->max_dst_rows, dsize.height);
+            CvSlice rows;
+
+            // the last row is kept for the last call, so the stages below
+            // get the end of the image together with some rows
+            if (!last)
+            {
+                dy1 = MIN(dy1, dsize.height - 1);
+                while (dy1 > dy0
+                       && icvResizeSourceRows(stage->resize,
+                                              cvSlice(dy1 - 1, dy1))
+                                  .end_index
+                              > avail)
+                    dy1--;
+            }
+            if (dy1 <= dy0)
+                break;
+
+            rows = icvResizeSourceRows(stage->resize, cvSlice(dy0, dy1));
+            out_y = stage->buf ? 0 : dy0;
+            dptr = out->data.ptr + out_y * out->step;
+            IPPI_CALL(icvResizeRows(stage->resize,
+                                    base + (rows.start_index - base_y)
+                                               * base_step,
+                                    base_step, rows.start_index, dptr,
+                                    out->step, cvSlice(dy0, dy1)));
+
+            stage->dst_y = dy1;
+            if (stage_count > 1)
+                CV_CALL(icvPipelineFeed(stages + 1, stage_count - 1, dptr,
+                                        out->step, dy0, dy1 - dy0,
+                                        last && dy1 == dsize.height));
+        }
+    }
+    else
+    {
+        CvMat dst_rows = icvPipelineRows(count, stage->dst_size.width,
+                                         stage->dst_type, dptr, out->step);
+
+        CV_CALL(cvCvtColor(&src_rows, &dst_rows, stage->code));
+
+        if (stage_count > 1)
+            CV_CALL(icvPipelineFeed(stages + 1, stage_count - 1, dptr,
+                                    out->step, y, count, last));
+        stage->dst_y += count;
+    }
+
+    __END__;
+}
+
+CvImagePipeline::CvImagePipeline()
+{
+    stages = 0;
+    stage_count = max_stages = 0;
+}
+
+CvImagePipeline::~CvImagePipeline()
+{
+    clear();
+    cvFree(&stages);
+}
+
+void CvImagePipeline::clear()
+{
+    int i;
+
+    for (i = 0; i < stage_count; i++)
+    {
+        CvPipelineStage* stage = stages[i];
+
+        icvPipelineReleaseStage(stage);
+        if (stage->own_filter)
+            delete stage->filter;
+        cvFree(&stages[i]);
+    }
+
+    stage_count = 0;
+}
+
+void CvImagePipeline::add_stage(CvPipelineStage* stage)
+{
+    CV_FUNCNAME("CvImagePipeline::add_stage");
+
+    __BEGIN__;
+
+    CvPipelineStage* new_stage = 0;
+
+    if (stage_count == max_stages)
+    {
+        CvPipelineStage** new_stages = 0;
+        int new_max = MAX(max_stages * 2, 4);
+
+        CV_CALL(new_stages = (CvPipelineStage**)cvAlloc(
+                    new_max * sizeof(new_stages[0])));
+        if (stage_count > 0)
+            memcpy(new_stages, stages, stage_count * sizeof(stages[0]));
+        cvFree(&stages);
+        stages = new_stages;
+        max_stages = new_max;
+    }
+
+    CV_CALL(new_stage = (CvPipelineStage*)cvAlloc(sizeof(*new_stage)));
+    *new_stage = *stage;
+    stages[stage_count++] = new_stage;
+
+    __END__;
+}
+
+static void icvPipelineInitStageParams(CvPipelineStage* stage, int kind)
+{
+    memset(stage, 0, sizeof(*stage));
+    stage->kind = kind;
+}
+
+void CvImagePipeline::add_filter(CvBaseImageFilter* filter)
+{
+    CV_FUNCNAME("CvImagePipeline::add_filter");
+
+    __BEGIN__;
+
+    CvPipelineStage stage;
+
+    if (!filter)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    icvPipelineInitStageParams(&stage, ICV_PIPELINE_FILTER);
+    stage.filter = filter;
+    CV_CALL(add_stage(&stage));
+
+    __END__;
+}
+
+void CvImagePipeline::add_smooth(int smooth_type, int param1, int param2,
+                                 double param3, double param4)
+{
+    CV_FUNCNAME("CvImagePipeline::add_smooth");
+
+    __BEGIN__;
+
+    CvPipelineStage stage;
+
+    if (smooth_type != CV_BLUR && smooth_type != CV_GAUSSIAN)
+        CV_ERROR(CV_StsBadFlag,
+                 "Only CV_BLUR and CV_GAUSSIAN smoothing can be pipelined");
+
+    icvPipelineInitStageParams(&stage, ICV_PIPELINE_SMOOTH);
+    stage.smooth_type = smooth_type;
+    stage.param1 = param1;
+    stage.param2 = param2;
+    stage.param3 = param3;
+    stage.param4 = param4;
+    if (smooth_type == CV_GAUSSIAN)
+        stage.filter = new CvSepFilter;
+    else
+        stage.filter = new CvBoxFilter;
+    stage.own_filter = true;
+
+    add_stage(&stage);
+    if (cvGetErrStatus() < 0)
+        delete stage.filter;
+
+    __END__;
+}
+
+void CvImagePipeline::add_resize(CvSize dsize, int method)
+{
+    CV_FUNCNAME("CvImagePipeline::add_resize");
+
+    __BEGIN__;
+
+    CvPipelineStage stage;
+
+    if (dsize.width <= 0 || dsize.height <= 0)
+        CV_ERROR(CV_StsBadSize, "");
+
+    icvPipelineInitStageParams(&stage, ICV_PIPELINE_RESIZE);
+    stage.dsize = dsize;
+    stage.method = method;
+    CV_CALL(add_stage(&stage));
+
+    __END__;
+}
+
+void CvImagePipeline::add_cvt_color(int code, int dst_cn)
+{
+    CV_FUNCNAME("CvImagePipeline::add_cvt_color");
+
+    __BEGIN__;
+
+    CvPipelineStage stage;
+
+    if (dst_cn < 1 || dst_cn > 4)
+        CV_ERROR(CV_BadNumChannels, "");
+
+    icvPipelineInitStageParams(&stage, ICV_PIPELINE_CVT_COLOR);
+    stage.code = code;
+    stage.dst_cn = dst_cn;
+    CV_CALL(add_stage(&stage));
+
+    __END__;
+}
+
+void CvImagePipeline::process(const CvArr* srcarr, CvArr* dstarr,
+                              int band_height)
+{
+    int i;
+
+    CV_FUNCNAME("CvImagePipeline::process");
+
+    __BEGIN__;
+
+    CvMat srcstub, *src = (CvMat*)srcarr;
+    CvMat dststub, *dst = (CvMat*)dstarr;
+    CvSize size;
+    double rows_scale = 1, row_size;
+    int y, type, max_rows;
+
+    CV_CALL(src = cvGetMat(srcarr, &srcstub));
+    CV_CALL(dst = cvGetMat(dstarr, &dststub));
+
+    if (stage_count == 0)
+    {
+        CV_CALL(cvCopy(src, dst));
+        EXIT;
+    }
+
+    if (src->data.ptr == dst->data.ptr)
+        CV_ERROR(CV_StsInplaceNotSupported, "");
+
+    // the rows of all the stage outputs per a source row
+    size = cvGetMatSize(src);
+    row_size = size.width * CV_ELEM_SIZE(src->type);
+    for (i = 0; i < stage_count; i++)
+    {
+        CvPipelineStage* stage = stages[i];
+        CvSize dsize = stage->kind == ICV_PIPELINE_RESIZE ? stage->dsize : size;
+
+        rows_scale *= (double)dsize.height / size.height;
+        row_size += rows_scale * dsize.width * CV_ELEM_SIZE(src->type)
+                    * (stage->kind == ICV_PIPELINE_CVT_COLOR
+                           ? (double)stage->dst_cn / CV_MAT_CN(src->type)
+                           : 1.);
+        size = dsize;
+    }
+
+    if (band_height <= 0)
+        band_height = MAX(cvRound(ICV_PIPELINE_BAND_SIZE / row_size),
+                          ICV_PIPELINE_MIN_BAND);
+    band_height = MIN(band_height, src->rows);
+
+    size = cvGetMatSize(src);
+    type = CV_MAT_TYPE(src->type);
+    max_rows = band_height;
+    for (i = 0; i < stage_count; i++)
+    {
+        CvPipelineStage* stage = stages[i];
+
+        stage->max_src_rows = max_rows;
+        CV_CALL(icvPipelineInitStage(stage, size, type, i == 0 ? src : 0,
+                                     i == stage_count - 1));
+        size = stage->dst_size;
+        type = stage->dst_type;
+        max_rows = stage->max_dst_rows;
+    }
+
+    if (size.width != dst->cols || size.height != dst->rows)
+        CV_ERROR(CV_StsUnmatchedSizes,
+                 "The output size differs from the one of the last stage");
+    if (type != CV_MAT_TYPE(dst->type))
+        CV_ERROR(CV_StsUnmatchedFormats,
+                 "The output type differs from the one of the last stage");
+    stages[stage_count - 1]->dst = dst;
+
+    for (y = 0; y < src->rows; y += band_height)
+    {
+        int count = MIN(band_height, src->rows - y);
+        CV_CALL(icvPipelineFeed(stages, stage_count,
+                                src->data.ptr + y * src->step, src->step, y,
+                                count, y + count == src->rows));
+    }
+
+    __END__;
+
+    for (i = 0; i < stage_count; i++)
+        icvPipelineReleaseStage(stages[i]);
+}
+
+/* End of file. */
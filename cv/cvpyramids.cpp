@@ -86,11 +86,17 @@ direct,
 
 ////////// generic macro ////////////
 
-#define ICV_DEF_PYR_DOWN_FUNC(flavor, type, worktype, _pd_scale_)              \
+#define ICV_DEF_PYR_DOWN_FUNC(flavor, type, worktype, _pd_scale_, _row_func_,  \
+                              _col_func_)                                      \
     static CvStatus CV_STDCALL icvPyrDownG5x5_##flavor##_CnR(                  \
         const type* src, int srcstep, type* dst, int dststep, CvSize size,     \
-        void* buf, int Cs)                                                     \
+        void* buf, int Cs, CvSlice dst_rows)                                   \
     {                                                                          \
+        /* the built-in vectorized interior passes, if any */                  \
+        CvStatus(CV_STDCALL * row_func)(const type*, worktype*, int) =         \
+            _row_func_;                                                        \
+        CvStatus(CV_STDCALL * col_func)(const worktype**, type*, int) =        \
+            _col_func_;                                                        \
         worktype* buffer = (worktype*)buf; /* pointer to temporary buffer */   \
         worktype*                                                              \
             rows[PD_SZ]; /* array of rows pointers. dim(rows) is PD_SZ */      \
@@ -98,15 +104,28 @@ direct,
         int Wd = size.width / 2, Wdn = Wd * Cs;                                \
         int buffer_step = Wdn;                                                 \
         int pd_sz = (PD_SZ + 1) * buffer_step;                                 \
-        int fst = 0,                                                           \
-            lst = size.height <= PD_SZ / 2 ? size.height : PD_SZ / 2 + 1;      \
+        int fst = 0, lst;                                                      \
                                                                                \
         assert(Cs == 1 || Cs == 3);                                            \
         srcstep /= sizeof(src[0]);                                             \
         dststep /= sizeof(dst[0]);                                             \
+        dst += dst_rows.start_index * dststep;                                 \
+        y = dst_rows.start_index * 2;                                          \
+                                                                               \
+        if (y == 0)                                                            \
+            lst = size.height <= PD_SZ / 2 ? size.height : PD_SZ / 2 + 1;      \
+        else                                                                   \
+        {                                                                      \
+            /* a band that starts inside the image fills all the buffer rows   \
+             * around its first row */                                         \
+            src += (y - PD_SZ / 2) * srcstep;                                  \
+            lst = y + PD_SZ / 2 < size.height ? PD_SZ                          \
+                                              : size.height - y + PD_SZ / 2;   \
+        }                                                                      \
                                                                                \
         /* main loop */                                                        \
-        for (y = 0; y < size.height; y += 2, dst += dststep)                   \
+        for (; y < size.height && y < dst_rows.end_index * 2;                  \
+             y += 2, dst += dststep)                                           \
         {                                                                      \
             /* set first and last indices of buffer rows which are need to be  \
              * filled */                                                       \
@@ -139,12 +158,15 @@ direct,
                         row[Wd - 1] = PD_RB(src[Wd * 2 - 4], src[Wd * 2 - 3],  \
                                             src[Wd * 2 - 2], src[Wd * 2 - 1]); \
                         /* other points (even) */                              \
-                        for (x = 1; x < Wd - 1; x++)                           \
-                        {                                                      \
-                            row[x] = PD_FILTER(src[2 * x - 2], src[2 * x - 1], \
-                                               src[2 * x], src[2 * x + 1],     \
-                                               src[2 * x + 2]);                \
-                        }                                                      \
+                        if (row_func)                                          \
+                            row_func(src + 2, row + 1, Wd - 2);                \
+                        else                                                   \
+                            for (x = 1; x < Wd - 1; x++)                       \
+                            {                                                  \
+                                row[x] = PD_FILTER(                            \
+                                    src[2 * x - 2], src[2 * x - 1], src[2 * x],\
+                                    src[2 * x + 1], src[2 * x + 2]);           \
+                            }                                                  \
                     }                                                          \
                 else                                                           \
                     for (y1 = fst; y1 < lst; y1++, src += srcstep)             \
@@ -200,12 +222,20 @@ direct,
             {                                                                  \
                 if (y < size.height - PD_SZ / 2)                               \
                 {                                                              \
-                    for (x = 0; x < Wdn; x++, x1++)                            \
+                    if (col_func)                                              \
                     {                                                          \
-                        dst[x] = (type)_pd_scale_(                             \
-                            PD_FILTER(row01[x], row01[x1], row23[x],           \
-                                      row23[x1], row4[x]));                    \
+                        const worktype* crows[PD_SZ] = {                       \
+                            row01, row01 + buffer_step, row23,                 \
+                            row23 + buffer_step, row4};                        \
+                        col_func(crows, dst, Wdn);                             \
                     }                                                          \
+                    else                                                       \
+                        for (x = 0; x < Wdn; x++, x1++)                        \
+                        {                                                      \
+                            dst[x] = (type)_pd_scale_(                         \
+                                PD_FILTER(row01[x], row01[x1], row23[x],       \
+                                          row23[x1], row4[x]));                \
+                        }                                                      \
                     top_row += 2 * buffer_step;                                \
                     top_row &= top_row < pd_sz ? -1 : 0;                       \
                 }                                                              \
@@ -228,20 +258,22 @@ direct,
                         dst[x] = (type)_pd_scale_(                             \
                             PD_SINGULAR(row01[x], row01[x1]));                 \
                 }                                                              \
-                fst = PD_SZ - 2;                                               \
             }                                                                  \
                                                                                \
+            fst = PD_SZ - 2;                                                   \
             lst = y + 2 + PD_SZ / 2 < size.height ? PD_SZ : size.height - y;   \
         }                                                                      \
                                                                                \
         return CV_OK;                                                          \
     }
 
-ICV_DEF_PYR_DOWN_FUNC(8u, uchar, int, PD_SCALE_INT)
-ICV_DEF_PYR_DOWN_FUNC(16s, short, int, PD_SCALE_INT)
-ICV_DEF_PYR_DOWN_FUNC(16u, ushort, int, PD_SCALE_INT)
-ICV_DEF_PYR_DOWN_FUNC(32f, float, float, PD_SCALE_FLT)
-ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT)
+ICV_DEF_PYR_DOWN_FUNC(8u, uchar, int, PD_SCALE_INT, icvPyrDownRow_8u32s_C1R_p,
+                      icvPyrDownCol_32s8u_p)
+ICV_DEF_PYR_DOWN_FUNC(16s, short, int, PD_SCALE_INT, 0, 0)
+ICV_DEF_PYR_DOWN_FUNC(16u, ushort, int, PD_SCALE_INT, 0, 0)
+ICV_DEF_PYR_DOWN_FUNC(32f, float, float, PD_SCALE_FLT, icvPyrDownRow_32f_C1R_p,
+                      icvPyrDownCol_32f_p)
+ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT, 0, 0)
 
 /****************************************************************************************\
                            Up-sampling pyramids core functions
@@ -296,11 +328,17 @@ ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT)
 
 //////////// generic macro /////////////
 
-#define ICV_DEF_PYR_UP_FUNC(flavor, type, worktype, _pu_scale_)                \
+#define ICV_DEF_PYR_UP_FUNC(flavor, type, worktype, _pu_scale_, _row_func_,    \
+                            _col_func_)                                        \
     static CvStatus CV_STDCALL icvPyrUpG5x5_##flavor##_CnR(                    \
         const type* src, int srcstep, type* dst, int dststep, CvSize size,     \
         void* buf, int Cs)                                                     \
     {                                                                          \
+        /* the built-in vectorized interior passes, if any */                  \
+        CvStatus(CV_STDCALL * row_func)(const type*, worktype*, int) =         \
+            _row_func_;                                                        \
+        CvStatus(CV_STDCALL * col_func)(const worktype**, type*, type*, int) = \
+            _col_func_;                                                        \
         worktype* buffer = (worktype*)buf;                                     \
         worktype* rows[PU_SZ];                                                 \
         int y, top_row = 0;                                                    \
@@ -349,12 +387,16 @@ ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT)
                         row[size.width * 2 - 1] =                              \
                             PU_RB_ZI(src[size.width - 1]);                     \
                         /* other points */                                     \
-                        for (x = 1; x < size.width - 1; x++)                   \
-                        {                                                      \
-                            row[2 * x] =                                       \
-                                PU_FILTER(src[x - 1], src[x], src[x + 1]);     \
-                            row[2 * x + 1] = PU_FILTER_ZI(src[x], src[x + 1]); \
-                        }                                                      \
+                        if (row_func)                                          \
+                            row_func(src + 1, row + 2, size.width - 2);        \
+                        else                                                   \
+                            for (x = 1; x < size.width - 1; x++)               \
+                            {                                                  \
+                                row[2 * x] =                                   \
+                                    PU_FILTER(src[x - 1], src[x], src[x + 1]); \
+                                row[2 * x + 1] =                               \
+                                    PU_FILTER_ZI(src[x], src[x + 1]);          \
+                            }                                                  \
                     }                                                          \
                 else /* size.width <= PU_SZ/2 */                               \
                     for (y1 = fst; y1 < lst; y1++, src += srcstep)             \
@@ -419,13 +461,19 @@ ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT)
             {                                                                  \
                 if (y < size.height - PU_SZ / 2)                               \
                 {                                                              \
-                    for (x = 0; x < Wdn; x++)                                  \
+                    if (col_func)                                              \
                     {                                                          \
-                        dst[x] = (type)_pu_scale_(                             \
-                            PU_FILTER(row0[x], row1[x], row2[x]));             \
-                        dst1[x] =                                              \
-                            (type)_pu_scale_(PU_FILTER_ZI(row1[x], row2[x]));  \
+                        const worktype* crows[PU_SZ] = {row0, row1, row2};     \
+                        col_func(crows, dst, dst1, Wdn);                       \
                     }                                                          \
+                    else                                                       \
+                        for (x = 0; x < Wdn; x++)                              \
+                        {                                                      \
+                            dst[x] = (type)_pu_scale_(                         \
+                                PU_FILTER(row0[x], row1[x], row2[x]));         \
+                            dst1[x] = (type)_pu_scale_(                        \
+                                PU_FILTER_ZI(row1[x], row2[x]));               \
+                        }                                                      \
                     top_row += buffer_step;                                    \
                     top_row &= top_row < pu_sz ? -1 : 0;                       \
                 }                                                              \
@@ -462,11 +510,13 @@ ICV_DEF_PYR_DOWN_FUNC(64f, double, double, PD_SCALE_FLT)
         return CV_OK;                                                          \
     }
 
-ICV_DEF_PYR_UP_FUNC(8u, uchar, int, PU_SCALE_INT)
-ICV_DEF_PYR_UP_FUNC(16s, short, int, PU_SCALE_INT)
-ICV_DEF_PYR_UP_FUNC(16u, ushort, int, PU_SCALE_INT)
-ICV_DEF_PYR_UP_FUNC(32f, float, float, PU_SCALE_FLT)
-ICV_DEF_PYR_UP_FUNC(64f, double, double, PU_SCALE_FLT)
+ICV_DEF_PYR_UP_FUNC(8u, uchar, int, PU_SCALE_INT, icvPyrUpRow_8u32s_C1R_p,
+                    icvPyrUpCol_32s8u_p)
+ICV_DEF_PYR_UP_FUNC(16s, short, int, PU_SCALE_INT, 0, 0)
+ICV_DEF_PYR_UP_FUNC(16u, ushort, int, PU_SCALE_INT, 0, 0)
+ICV_DEF_PYR_UP_FUNC(32f, float, float, PU_SCALE_FLT, icvPyrUpRow_32f_C1R_p,
+                    icvPyrUpCol_32f_p)
+ICV_DEF_PYR_UP_FUNC(64f, double, double, PU_SCALE_FLT, 0, 0)
 
 static CvStatus CV_STDCALL icvPyrUpG5x5_GetBufSize(int roiWidth,
                                                    CvDataType dataType,
@@ -599,7 +649,7 @@ static CvStatus CV_STDCALL icvPyrDownG5x5_GetBufSize(int roiWidth,
                     }                                                          \
                 }                                                              \
             }                                                                  \
-            else if (W == 3 && Wd == 1 || W > 3 && !(Wd & 1))                  \
+            else if ((W == 3 && Wd == 1) || (W > 3 && !(W & 1)))               \
             {                                                                  \
                 for (i = 0; i < H; i++, src += src_step, buf += channels)      \
                 {                                                              \
@@ -769,7 +819,7 @@ static CvStatus CV_STDCALL icvPyrDownG5x5_GetBufSize(int roiWidth,
                 {                                                              \
                     for (j = 0; j < bufW; j++)                                 \
                         dst[j] = (arrtype)_pd_scale_(                          \
-                            PD_LT(buf[j - bufW * 2], buf[j - bufW], buf[j]));  \
+                            PD_LT(buf[j], buf[j - bufW], buf[j - bufW * 2]));  \
                 }                                                              \
                                                                                \
                 buf = buf0;                                                    \
@@ -905,7 +955,7 @@ static CvStatus CV_STDCALL icvPyrDownG5x5_GetBufSize(int roiWidth,
                                       buf[i * 2], buf[i * 2 + 1]));            \
                         else if (cols > 1)                                     \
                             dst[i] = (arrtype)_pd_scale_(PD_LT(                \
-                                buf[i * 2 - 2], buf[i * 2 - 1], buf[i * 2]));  \
+                                buf[i * 2], buf[i * 2 - 1], buf[i * 2 - 2]));  \
                     }                                                          \
                     else                                                       \
                     {                                                          \
@@ -918,11 +968,17 @@ static CvStatus CV_STDCALL icvPyrDownG5x5_GetBufSize(int roiWidth,
                             PD_LT(buf[2], buf[5], buf[8]));                    \
                                                                                \
                         /* middle part of the bottom row */                    \
-                        for (i = 3; i < Wd_ * 3; i++)                          \
+                        for (i = 3; i < Wd_ * 3; i += 3)                       \
                         {                                                      \
                             dst[i] = (arrtype)_pd_scale_(PD_FILTER(            \
                                 buf[i * 2 - 6], buf[i * 2 - 3], buf[i * 2],    \
                                 buf[i * 2 + 3], buf[i * 2 + 6]));              \
+                            dst[i + 1] = (arrtype)_pd_scale_(PD_FILTER(        \
+                                buf[i * 2 - 5], buf[i * 2 - 2], buf[i * 2 + 1],\
+                                buf[i * 2 + 4], buf[i * 2 + 7]));              \
+                            dst[i + 2] = (arrtype)_pd_scale_(PD_FILTER(        \
+                                buf[i * 2 - 4], buf[i * 2 - 1], buf[i * 2 + 2],\
+                                buf[i * 2 + 5], buf[i * 2 + 8]));              \
                         }                                                      \
                                                                                \
                         /* right part of the bottom row */                     \
@@ -941,13 +997,13 @@ static CvStatus CV_STDCALL icvPyrDownG5x5_GetBufSize(int roiWidth,
                         else if (cols > 1)                                     \
                         {                                                      \
                             dst[i] = (arrtype)_pd_scale_(PD_LT(                \
-                                buf[i * 2 - 6], buf[i * 2 - 3], buf[i * 2]));  \
+                                buf[i * 2], buf[i * 2 - 3], buf[i * 2 - 6]));  \
                             dst[i + 1] = (arrtype)_pd_scale_(                  \
-                                PD_LT(buf[i * 2 - 5], buf[i * 2 - 2],          \
-                                      buf[i * 2 + 1]));                        \
+                                PD_LT(buf[i * 2 + 1], buf[i * 2 - 2],          \
+                                      buf[i * 2 - 5]));                        \
                             dst[i + 2] = (arrtype)_pd_scale_(                  \
-                                PD_LT(buf[i * 2 - 4], buf[i * 2 - 1],          \
-                                      buf[i * 2 + 2]));                        \
+                                PD_LT(buf[i * 2 + 2], buf[i * 2 - 1],          \
+                                      buf[i * 2 - 4]));                        \
                         }                                                      \
                     }                                                          \
                 }                                                              \
@@ -997,14 +1053,58 @@ icvPyrUp_Gauss5x5_32f_C3R_t icvPyrUp_Gauss5x5_32f_C3R_p = 0;
 icvPyrUpGetBufSize_Gauss5x5_t icvPyrUpGetBufSize_Gauss5x5_p = 0;
 icvPyrDownGetBufSize_Gauss5x5_t icvPyrDownGetBufSize_Gauss5x5_p = 0;
 
+icvPyrDownRow_8u32s_C1R_t icvPyrDownRow_8u32s_C1R_p = 0;
+icvPyrDownRow_32f_C1R_t icvPyrDownRow_32f_C1R_p = 0;
+icvPyrDownCol_32s8u_t icvPyrDownCol_32s8u_p = 0;
+icvPyrDownCol_32f_t icvPyrDownCol_32f_p = 0;
+
+icvPyrUpRow_8u32s_C1R_t icvPyrUpRow_8u32s_C1R_p = 0;
+icvPyrUpRow_32f_C1R_t icvPyrUpRow_32f_C1R_p = 0;
+icvPyrUpCol_32s8u_t icvPyrUpCol_32s8u_p = 0;
+icvPyrUpCol_32f_t icvPyrUpCol_32f_p = 0;
+
 typedef CvStatus(CV_STDCALL* CvPyramidFunc)(const void* src, int srcstep,
                                             void* dst, int dststep, CvSize size,
                                             void* buffer, int cn);
 
+typedef CvStatus(CV_STDCALL* CvPyrDownFunc)(const void* src, int srcstep,
+                                            void* dst, int dststep, CvSize size,
+                                            void* buffer, int cn,
+                                            CvSlice dst_rows);
+
 typedef CvStatus(CV_STDCALL* CvPyramidIPPFunc)(const void* src, int srcstep,
                                                void* dst, int dststep,
                                                CvSize size, void* buffer);
 
+/* The arguments of the pyramid down-sampling shared by the bands of
+   destination rows; every band has its own ring buffer */
+typedef struct CvPyrDownBand
+{
+    const uchar* src;
+    int srcstep;
+    uchar* dst;
+    int dststep;
+    CvSize size;
+    int cn, buffer_size;
+    CvPyrDownFunc func;
+} CvPyrDownBand;
+
+static int CV_CDECL icvPyrDownBand(int y0, int y1, void* arg)
+{
+    const CvPyrDownBand* p = (const CvPyrDownBand*)arg;
+    void* buffer = cvAlloc(p->buffer_size);
+    CvStatus status;
+
+    if (!buffer)
+        return CV_OUTOFMEM_ERR;
+
+    status = p->func(p->src, p->srcstep, p->dst, p->dststep, p->size, buffer,
+                     p->cn, cvSlice(y0, y1));
+
+    cvFree(&buffer);
+    return status;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 /****************************************************************************************\
@@ -1018,6 +1118,7 @@ CV_IMPL void cvPyrUp(const void* srcarr, void* dstarr, int _filter)
 
     void* buffer = 0;
     int local_alloc = 0;
+    CvMat *temp_src = 0, *temp_dst = 0;
 
     CV_FUNCNAME("cvPyrUp");
 
@@ -1064,6 +1165,19 @@ CV_IMPL void cvPyrUp(const void* srcarr, void* dstarr, int _filter)
         CV_ERROR(CV_StsUnsupportedFormat,
                  "The images must have 1 or 3 channel");
 
+    // half-precision images are filtered by the single-precision kernels
+    if (depth == CV_16F)
+    {
+        CV_CALL(temp_src = cvCreateMat(src->rows, src->cols,
+                                       CV_MAKETYPE(CV_32F, cn)));
+        CV_CALL(temp_dst = cvCreateMat(dst->rows, dst->cols,
+                                       CV_MAKETYPE(CV_32F, cn)));
+        CV_CALL(cvConvert(src, temp_src));
+        CV_CALL(cvPyrUp(temp_src, temp_dst, filter));
+        CV_CALL(cvConvert(temp_dst, dst));
+        EXIT;
+    }
+
     func = (CvPyramidFunc)pyrup_tab.fn_2d[depth];
 
     if (!func)
@@ -1104,6 +1218,8 @@ CV_IMPL void cvPyrUp(const void* srcarr, void* dstarr, int _filter)
                            size, buffer));
     __END__;
 
+    cvReleaseMat(&temp_src);
+    cvReleaseMat(&temp_dst);
     if (buffer && !local_alloc)
         cvFree(&buffer);
 }
@@ -1116,6 +1232,7 @@ CV_IMPL void cvPyrDown(const void* srcarr, void* dstarr, int _filter)
 
     void* buffer = 0;
     int local_alloc = 0;
+    CvMat *temp_src = 0, *temp_dst = 0;
 
     CV_FUNCNAME("cvPyrDown");
 
@@ -1127,7 +1244,8 @@ CV_IMPL void cvPyrDown(const void* srcarr, void* dstarr, int _filter)
     CvMat srcstub, *src = (CvMat*)srcarr;
     CvMat dststub, *dst = (CvMat*)dstarr;
     CvFilter filter = (CvFilter)_filter;
-    CvPyramidFunc func;
+    CvPyrDownFunc func;
+    CvPyrDownBand band;
     CvPyramidIPPFunc ipp_func = 0;
     int use_ipp = 0;
     CvSize src_size, src_size2, dst_size;
@@ -1176,7 +1294,20 @@ CV_IMPL void cvPyrDown(const void* srcarr, void* dstarr, int _filter)
         CV_ERROR(CV_StsUnsupportedFormat,
                  "The images must have 1 or 3 channel");
 
-    func = (CvPyramidFunc)pyrdown_tab.fn_2d[depth];
+    // half-precision images are filtered by the single-precision kernels
+    if (depth == CV_16F)
+    {
+        CV_CALL(temp_src = cvCreateMat(src->rows, src->cols,
+                                       CV_MAKETYPE(CV_32F, cn)));
+        CV_CALL(temp_dst = cvCreateMat(dst->rows, dst->cols,
+                                       CV_MAKETYPE(CV_32F, cn)));
+        CV_CALL(cvConvert(src, temp_src));
+        CV_CALL(cvPyrDown(temp_src, temp_dst, filter));
+        CV_CALL(cvConvert(temp_dst, dst));
+        EXIT;
+    }
+
+    func = (CvPyrDownFunc)pyrdown_tab.fn_2d[depth];
 
     if (!func)
         CV_ERROR(CV_StsUnsupportedFormat, "");
@@ -1197,24 +1328,36 @@ CV_IMPL void cvPyrDown(const void* srcarr, void* dstarr, int _filter)
     }
 
     if (!use_ipp)
+    {
         icvPyrDownG5x5_GetBufSize(src_size2.width, icvDepthToDataType(type), cn,
                                   &buffer_size);
 
-    if (buffer_size <= CV_MAX_LOCAL_SIZE)
-    {
-        buffer = cvStackAlloc(buffer_size);
-        local_alloc = 1;
+        band.src = src->data.ptr;
+        band.srcstep = src->step;
+        band.dst = dst->data.ptr;
+        band.dststep = dst->step;
+        band.size = src_size2;
+        band.cn = cn;
+        band.buffer_size = buffer_size;
+        band.func = func;
+        IPPI_CALL((CvStatus)cvParallelFor(
+            cvSlice(0, src_size2.height / 2), icvPyrDownBand, &band,
+            CV_PARALLEL_GRAIN(src_size2.width / 2)));
     }
     else
-        CV_CALL(buffer = cvAlloc(buffer_size));
+    {
+        if (buffer_size <= CV_MAX_LOCAL_SIZE)
+        {
+            buffer = cvStackAlloc(buffer_size);
+            local_alloc = 1;
+        }
+        else
+            CV_CALL(buffer = cvAlloc(buffer_size));
 
-    if (!use_ipp)
-        func(src->data.ptr, src->step, dst->data.ptr, dst->step, src_size2,
-             buffer, cn);
-    else
         IPPI_CALL(ipp_func(src->data.ptr, src->step ? src->step : CV_STUB_STEP,
                            dst->data.ptr, dst->step ? dst->step : CV_STUB_STEP,
                            src_size2, buffer));
+    }
 
     if (src_size.width != dst_size.width * 2
         || src_size.height != dst_size.height * 2)
@@ -1231,10 +1374,259 @@ CV_IMPL void cvPyrDown(const void* srcarr, void* dstarr, int _filter)
 
     __END__;
 
+    cvReleaseMat(&temp_src);
+    cvReleaseMat(&temp_dst);
     if (buffer && !local_alloc)
         cvFree(&buffer);
 }
 
+/****************************************************************************************\
+*                                  Image pyramid object *
+\****************************************************************************************/
+
+#define ICV_PYR_MAX_LEVELS 32
+
+/* the released level buffers are kept for the following frames, the least
+   recently released ones are dropped first */
+#define ICV_PYR_POOL_SIZE 16
+#define ICV_PYR_POOL_MAX_BYTES (64 << 20)
+
+struct CvImagePyramid
+{
+    int max_levels;
+    int count; /* the levels of the current image */
+    int valid; /* the levels 0..valid-1 are computed */
+    CvMat* buf[ICV_PYR_MAX_LEVELS]; /* buf[0] is the copy of the image */
+    CvMat level[ICV_PYR_MAX_LEVELS];
+};
+
+static CvMat* icvPyrPool[ICV_PYR_POOL_SIZE];
+static size_t icvPyrPoolBytes = 0;
+
+static size_t icvPyrBufferBytes(const CvMat* mat)
+{
+    return (size_t)mat->rows * mat->step;
+}
+
+/* takes a buffer of the given size and type from the pool or allocates it */
+static CvMat* icvGetPyrBuffer(int rows, int cols, int type)
+{
+    CvMat* mat = 0;
+    int i;
+
+    cvLockCaches();
+    for (i = 0; i < ICV_PYR_POOL_SIZE && icvPyrPool[i]; i++)
+    {
+        CvMat* m = icvPyrPool[i];
+        if (m->rows == rows && m->cols == cols && CV_MAT_TYPE(m->type) == type)
+        {
+            mat = m;
+            icvPyrPoolBytes -= icvPyrBufferBytes(m);
+            for (; i < ICV_PYR_POOL_SIZE - 1 && icvPyrPool[i + 1]; i++)
+                icvPyrPool[i] = icvPyrPool[i + 1];
+            icvPyrPool[i] = 0;
+            break;
+        }
+    }
+    cvUnlockCaches();
+
+    return mat ? mat : cvCreateMat(rows, cols, type);
+}
+
+/* returns the buffer to the pool */
+static void icvPutPyrBuffer(CvMat** _mat)
+{
+    CvMat* dropped[ICV_PYR_POOL_SIZE + 1];
+    int i, count = 0, ndropped = 0;
+
+    if (!*_mat)
+        return;
+
+    cvLockCaches();
+    for (count = 0; count < ICV_PYR_POOL_SIZE && icvPyrPool[count]; count++)
+        ;
+    if (count == ICV_PYR_POOL_SIZE)
+    {
+        dropped[ndropped++] = icvPyrPool[--count];
+        icvPyrPoolBytes -= icvPyrBufferBytes(dropped[0]);
+    }
+    for (i = count; i > 0; i--)
+        icvPyrPool[i] = icvPyrPool[i - 1];
+    icvPyrPool[0] = *_mat;
+    icvPyrPoolBytes += icvPyrBufferBytes(*_mat);
+    count++;
+
+    while (icvPyrPoolBytes > ICV_PYR_POOL_MAX_BYTES)
+    {
+        CvMat* m = icvPyrPool[--count];
+        icvPyrPool[count] = 0;
+        icvPyrPoolBytes -= icvPyrBufferBytes(m);
+        dropped[ndropped++] = m;
+    }
+    cvUnlockCaches();
+
+    *_mat = 0;
+    for (i = 0; i < ndropped; i++)
+        cvReleaseMat(&dropped[i]);
+}
+
+CV_IMPL CvImagePyramid* cvCreateImagePyramid(int max_levels)
+{
+    CvImagePyramid* pyr = 0;
+
+    CV_FUNCNAME("cvCreateImagePyramid");
+
+    __BEGIN__;
+
+    if ((unsigned)max_levels > ICV_PYR_MAX_LEVELS)
+        CV_ERROR(CV_StsOutOfRange, "max_levels must be within 0..32");
+
+    CV_CALL(pyr = (CvImagePyramid*)cvAlloc(sizeof(*pyr)));
+    memset(pyr, 0, sizeof(*pyr));
+    pyr->max_levels = max_levels > 0 ? max_levels : ICV_PYR_MAX_LEVELS;
+
+    __END__;
+
+    return pyr;
+}
+
+CV_IMPL void cvReleaseImagePyramid(CvImagePyramid** _pyr)
+{
+    CV_FUNCNAME("cvReleaseImagePyramid");
+
+    __BEGIN__;
+
+    CvImagePyramid* pyr;
+    int i;
+
+    if (!_pyr)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    pyr = *_pyr;
+    if (!pyr)
+        EXIT;
+
+    for (i = 0; i < ICV_PYR_MAX_LEVELS; i++)
+        icvPutPyrBuffer(&pyr->buf[i]);
+    cvFree(_pyr);
+
+    __END__;
+}
+
+CV_IMPL void cvSetPyramidImage(CvImagePyramid* pyr, const CvArr* image,
+                               int copy)
+{
+    CV_FUNCNAME("cvSetPyramidImage");
+
+    __BEGIN__;
+
+    CvMat stub, *mat = (CvMat*)image;
+    CvSize size;
+    int i, type, depth, count;
+
+    if (!pyr)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    pyr->count = pyr->valid = 0;
+
+    CV_CALL(mat = cvGetMat(mat, &stub));
+    type = CV_MAT_TYPE(mat->type);
+    depth = CV_MAT_DEPTH(type);
+
+    if ((CV_MAT_CN(type) != 1 && CV_MAT_CN(type) != 3) || depth == CV_8S
+        || depth == CV_32S)
+        CV_ERROR(CV_StsUnsupportedFormat, "");
+
+    size = cvGetMatSize(mat);
+    for (count = 1; count < pyr->max_levels; count++)
+    {
+        if (size.width < 2 || size.height < 2)
+            break;
+        size.width = (size.width + 1) / 2;
+        size.height = (size.height + 1) / 2;
+    }
+
+    size = cvGetMatSize(mat);
+    for (i = 0; i < ICV_PYR_MAX_LEVELS; i++)
+    {
+        CvMat* buf = pyr->buf[i];
+
+        if (i >= count || (i == 0 && !copy))
+            icvPutPyrBuffer(&pyr->buf[i]);
+        else if (!buf || buf->rows != size.height || buf->cols != size.width
+                 || CV_MAT_TYPE(buf->type) != type)
+        {
+            icvPutPyrBuffer(&pyr->buf[i]);
+            CV_CALL(pyr->buf[i] =
+                        icvGetPyrBuffer(size.height, size.width, type));
+        }
+
+        if (i < count)
+        {
+            const CvMat* src = pyr->buf[i] ? pyr->buf[i] : mat;
+            cvInitMatHeader(&pyr->level[i], size.height, size.width, type,
+                            src->data.ptr, src->step);
+        }
+
+        size.width = (size.width + 1) / 2;
+        size.height = (size.height + 1) / 2;
+    }
+
+    if (copy)
+        CV_CALL(cvCopy(mat, pyr->buf[0]));
+
+    pyr->count = count;
+    pyr->valid = 1;
+
+    __END__;
+}
+
+CV_IMPL int cvGetPyramidLevelCount(const CvImagePyramid* pyr)
+{
+    int count = 0;
+
+    CV_FUNCNAME("cvGetPyramidLevelCount");
+
+    __BEGIN__;
+
+    if (!pyr)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    count = pyr->count;
+
+    __END__;
+
+    return count;
+}
+
+CV_IMPL const CvMat* cvGetPyramidLevel(CvImagePyramid* pyr, int level)
+{
+    const CvMat* result = 0;
+
+    CV_FUNCNAME("cvGetPyramidLevel");
+
+    __BEGIN__;
+
+    if (!pyr)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    if (pyr->count == 0)
+        CV_ERROR(CV_StsError, "The pyramid has no image");
+
+    if ((unsigned)level >= (unsigned)pyr->count)
+        CV_ERROR(CV_StsOutOfRange, "There is no such pyramid level");
+
+    for (; pyr->valid <= level; pyr->valid++)
+        CV_CALL(cvPyrDown(&pyr->level[pyr->valid - 1],
+                          &pyr->level[pyr->valid]));
+
+    result = &pyr->level[level];
+
+    __END__;
+
+    return result;
+}
+
 /* MSVC .NET 2003 spends a long time building this, thus, as the code
    is not performance-critical, we turn off the optimization here */
 #if defined _MSC_VER && _MSC_VER > 1300 && !defined CV_ICC
@@ -412,7 +412,7 @@ CV_IMPL CvBox2D cvMinAreaRect2(const CvArr* array, CvMemStorage* storage)
         cvStartReadSeq(ptseq, &reader);
         cvStartWriteSeq(CV_SEQ_KIND_CURVE | CV_SEQ_FLAG_CONVEX
                             | CV_SEQ_ELTYPE(ptseq->v_prev),
-                        sizeof(CvContour), CV_ELEM_SIZE(ptseq->v_prev->flags),
+                        sizeof(CvContour), CV_SEQ_ELTYPE_SIZE(ptseq->v_prev),
                         temp_storage, &writer);
 
         for (i = 0; i < ptseq->total; i++)
@@ -0,0 +1,3525 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+/****************************************************************************************\
+*                   Built-in SIMD versions of the optimized cv functions *
+\****************************************************************************************/
+
+#include "_cv.h"
+
+#if CV_BUILTIN_SIMD
+#include <immintrin.h>
+
+/* The functions fill the IPP function pointers declared in _cvipp.h (see
+   cv_builtin_tab below and icvUpdatePluginFuncTab() in cxswitcher.cpp).
+   Unless noted otherwise they produce exactly the same results as the C
+   code they replace. */
+
+/****************************************************************************************\
+*                                   Bilinear resize *
+\****************************************************************************************/
+
+/* Vertical interpolation of the two horizontally interpolated rows, the same
+   fixed-point arithmetic as ICV_DEF_RESIZE_BILINEAR_FUNC in cvimgwarp.cpp */
+typedef void (*CvResizeRow8uFunc)(const int* buf0, const int* buf1, int fy,
+                                  uchar* dst, int width);
+typedef void (*CvResizeRow32fFunc)(const float* buf0, const float* buf1,
+                                   float fy, float* dst, int width);
+
+/* Horizontal interpolation of a 32f row */
+typedef void (*CvResizeHLine32fFunc)(const float* src, const int* xofs,
+                                     const float* xalpha, float* buf,
+                                     int xmax, int width);
+
+#define ICV_RESIZE_DESCALE_8U(x) CV_DESCALE((x), ICV_WARP_SHIFT * 2)
+
+CV_TARGET_SSE4_1 static void icvResizeRow_8u_sse4_1(const int* buf0,
+                                                   const int* buf1, int fy,
+                                                   uchar* dst, int width)
+{
+    __m128i f = _mm_set1_epi32(fy);
+    __m128i delta = _mm_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+    int x = 0;
+
+    for (; x <= width - 8; x += 8)
+    {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(buf0 + x));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(buf0 + x + 4));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(buf1 + x));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(buf1 + x + 4));
+        b0 = _mm_mullo_epi32(_mm_sub_epi32(b0, a0), f);
+        b1 = _mm_mullo_epi32(_mm_sub_epi32(b1, a1), f);
+        a0 = _mm_add_epi32(_mm_slli_epi32(a0, ICV_WARP_SHIFT), b0);
+        a1 = _mm_add_epi32(_mm_slli_epi32(a1, ICV_WARP_SHIFT), b1);
+        a0 = _mm_srai_epi32(_mm_add_epi32(a0, delta), ICV_WARP_SHIFT * 2);
+        a1 = _mm_srai_epi32(_mm_add_epi32(a1, delta), ICV_WARP_SHIFT * 2);
+        a0 = _mm_packs_epi32(a0, a1);
+        _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(a0, a0));
+    }
+
+    for (; x < width; x++)
+        dst[x] = (uchar)ICV_RESIZE_DESCALE_8U(
+            (buf0[x] << ICV_WARP_SHIFT) + fy * (buf1[x] - buf0[x]));
+}
+
+CV_TARGET_AVX2 static void icvResizeRow_8u_avx2(const int* buf0,
+                                                const int* buf1, int fy,
+                                                uchar* dst, int width)
+{
+    __m256i f = _mm256_set1_epi32(fy);
+    __m256i delta = _mm256_set1_epi32(1 << (ICV_WARP_SHIFT * 2 - 1));
+    int x = 0;
+
+    for (; x <= width - 16; x += 16)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(buf0 + x));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(buf0 + x + 8));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(buf1 + x));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(buf1 + x + 8));
+        b0 = _mm256_mullo_epi32(_mm256_sub_epi32(b0, a0), f);
+        b1 = _mm256_mullo_epi32(_mm256_sub_epi32(b1, a1), f);
+        a0 = _mm256_add_epi32(_mm256_slli_epi32(a0, ICV_WARP_SHIFT), b0);
+        a1 = _mm256_add_epi32(_mm256_slli_epi32(a1, ICV_WARP_SHIFT), b1);
+        a0 = _mm256_srai_epi32(_mm256_add_epi32(a0, delta),
+                               ICV_WARP_SHIFT * 2);
+        a1 = _mm256_srai_epi32(_mm256_add_epi32(a1, delta),
+                               ICV_WARP_SHIFT * 2);
+        // packs works within the 128-bit lanes, restore the order
+        a0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(a0, a1), 0xd8);
+        _mm_storeu_si128((__m128i*)(dst + x),
+                         _mm_packus_epi16(_mm256_castsi256_si128(a0),
+                                          _mm256_extracti128_si256(a0, 1)));
+    }
+
+    for (; x < width; x++)
+        dst[x] = (uchar)ICV_RESIZE_DESCALE_8U(
+            (buf0[x] << ICV_WARP_SHIFT) + fy * (buf1[x] - buf0[x]));
+}
+
+CV_TARGET_SSE2 static void icvResizeRow_32f_sse2(const float* buf0,
+                                                 const float* buf1, float fy,
+                                                 float* dst, int width)
+{
+    __m128 f = _mm_set1_ps(fy);
+    int x = 0;
+
+    for (; x <= width - 8; x += 8)
+    {
+        __m128 a0 = _mm_loadu_ps(buf0 + x), a1 = _mm_loadu_ps(buf0 + x + 4);
+        __m128 b0 = _mm_loadu_ps(buf1 + x), b1 = _mm_loadu_ps(buf1 + x + 4);
+        b0 = _mm_mul_ps(f, _mm_sub_ps(b0, a0));
+        b1 = _mm_mul_ps(f, _mm_sub_ps(b1, a1));
+        _mm_storeu_ps(dst + x, _mm_add_ps(a0, b0));
+        _mm_storeu_ps(dst + x + 4, _mm_add_ps(a1, b1));
+    }
+
+    for (; x < width; x++)
+        dst[x] = buf0[x] + fy * (buf1[x] - buf0[x]);
+}
+
+CV_TARGET_AVX2 static void icvResizeRow_32f_avx2(const float* buf0,
+                                                 const float* buf1, float fy,
+                                                 float* dst, int width)
+{
+    __m256 f = _mm256_set1_ps(fy);
+    int x = 0;
+
+    for (; x <= width - 16; x += 16)
+    {
+        __m256 a0 = _mm256_loadu_ps(buf0 + x);
+        __m256 a1 = _mm256_loadu_ps(buf0 + x + 8);
+        __m256 b0 = _mm256_loadu_ps(buf1 + x);
+        __m256 b1 = _mm256_loadu_ps(buf1 + x + 8);
+        b0 = _mm256_mul_ps(f, _mm256_sub_ps(b0, a0));
+        b1 = _mm256_mul_ps(f, _mm256_sub_ps(b1, a1));
+        _mm256_storeu_ps(dst + x, _mm256_add_ps(a0, b0));
+        _mm256_storeu_ps(dst + x + 8, _mm256_add_ps(a1, b1));
+    }
+
+    for (; x < width; x++)
+        dst[x] = buf0[x] + fy * (buf1[x] - buf0[x]);
+}
+
+static void icvResizeHLine_32f_c(const float* src, const int* xofs,
+                                 const float* xalpha, float* buf, int xmax,
+                                 int width, int cn)
+{
+    int dx = 0;
+
+    for (; dx < xmax; dx++)
+    {
+        float t = src[xofs[dx]];
+        buf[dx] = t + xalpha[dx] * (src[xofs[dx] + cn] - t);
+    }
+
+    for (; dx < width; dx++)
+        buf[dx] = src[xofs[dx]];
+}
+
+#define ICV_DEF_RESIZE_HLINE_32F_C(cn)                                        \
+    static void icvResizeHLine_32f_C##cn##_c(const float* src,                \
+                                             const int* xofs,                 \
+                                             const float* xalpha,             \
+                                             float* buf, int xmax, int width) \
+    {                                                                         \
+        icvResizeHLine_32f_c(src, xofs, xalpha, buf, xmax, width, cn);        \
+    }
+
+ICV_DEF_RESIZE_HLINE_32F_C(1)
+ICV_DEF_RESIZE_HLINE_32F_C(3)
+ICV_DEF_RESIZE_HLINE_32F_C(4)
+
+#define ICV_DEF_RESIZE_HLINE_32F_AVX2(cn)                                   \
+    CV_TARGET_AVX2 static void icvResizeHLine_32f_C##cn##_avx2(             \
+        const float* src, const int* xofs, const float* xalpha, float* buf, \
+        int xmax, int width)                                                \
+    {                                                                       \
+        int dx = 0;                                                         \
+                                                                            \
+        for (; dx <= xmax - 8; dx += 8)                                     \
+        {                                                                   \
+            __m256i idx = _mm256_loadu_si256((const __m256i*)(xofs + dx));  \
+            __m256 t0 = _mm256_i32gather_ps(src, idx, 4);                   \
+            __m256 t1 = _mm256_i32gather_ps(src + cn, idx, 4);              \
+            t1 = _mm256_mul_ps(_mm256_loadu_ps(xalpha + dx),                \
+                               _mm256_sub_ps(t1, t0));                      \
+            _mm256_storeu_ps(buf + dx, _mm256_add_ps(t0, t1));              \
+        }                                                                   \
+                                                                            \
+        for (; dx < xmax; dx++)                                             \
+        {                                                                   \
+            float t = src[xofs[dx]];                                        \
+            buf[dx] = t + xalpha[dx] * (src[xofs[dx] + cn] - t);            \
+        }                                                                   \
+                                                                            \
+        for (; dx < width; dx++)                                            \
+            buf[dx] = src[xofs[dx]];                                        \
+    }
+
+ICV_DEF_RESIZE_HLINE_32F_AVX2(1)
+ICV_DEF_RESIZE_HLINE_32F_AVX2(3)
+ICV_DEF_RESIZE_HLINE_32F_AVX2(4)
+
+/* Computes the source offsets and the weights of the destination columns
+   as cvResize() does; returns the number of columns that are interpolated
+   (the others replicate the last source column) */
+static int icvResizeInitXTab(CvSize ssize, CvSize dsize, int cn, int* xofs,
+                             float* xalpha, int* ixalpha)
+{
+    float scale_x = (float)ssize.width / dsize.width;
+    int dx, k, xmax = dsize.width;
+
+    for (dx = 0; dx < dsize.width; dx++)
+    {
+        float fx = (float)((dx + 0.5) * scale_x - 0.5);
+        int sx = cvFloor(fx);
+        fx -= sx;
+
+        if (sx < 0)
+            fx = 0, sx = 0;
+
+        if (sx >= ssize.width - 1)
+        {
+            fx = 0, sx = ssize.width - 1;
+            if (xmax >= dsize.width)
+                xmax = dx;
+        }
+
+        for (k = 0; k < cn; k++)
+        {
+            xofs[dx * cn + k] = sx * cn + k;
+            if (xalpha)
+                xalpha[dx * cn + k] = fx;
+            else
+                ixalpha[dx * cn + k] = CV_FLT_TO_FIX(fx, ICV_WARP_SHIFT);
+        }
+    }
+
+    return xmax * cn;
+}
+
+/* Computes the source rows and the weight of the destination row dy */
+CV_INLINE float icvResizeInitY(CvSize ssize, CvSize dsize, int dy, int* sy)
+{
+    float scale_y = (float)ssize.height / dsize.height;
+    float fy = (float)((dy + 0.5) * scale_y - 0.5);
+    *sy = cvFloor(fy);
+    fy -= *sy;
+    if (*sy < 0)
+        *sy = 0, fy = 0;
+    return fy;
+}
+
+/* The destination rows are split between the threads; every band keeps
+   its own two horizontally interpolated source rows */
+typedef struct CvResizeBilinearBand
+{
+    const uchar* src;
+    int srcstep;
+    CvSize ssize;
+    uchar* dst;
+    int dststep;
+    CvSize dsize;
+    int cn, width, xmax;
+    const int* xofs;
+    const void* xalpha;
+    CvResizeHLine32fFunc hline;
+    void* row_func;
+} CvResizeBilinearBand;
+
+static int CV_CDECL icvResizeBilinearBand_8u(int dy0, int dy1, void* arg)
+{
+    const CvResizeBilinearBand* p = (const CvResizeBilinearBand*)arg;
+    const int* xofs = p->xofs;
+    const int* xalpha = (const int*)p->xalpha;
+    CvResizeRow8uFunc row_func = (CvResizeRow8uFunc)p->row_func;
+    int width = p->width, xmax = p->xmax, cn = p->cn, dx, dy, k;
+    int prev_sy0 = -1, prev_sy1 = -1;
+    int *buf, *buf0, *buf1;
+    uchar* dst = p->dst + dy0 * p->dststep;
+
+    buf = (int*)cvAlloc(width * 2 * sizeof(buf[0]));
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+    buf0 = buf;
+    buf1 = buf0 + width;
+
+    for (dy = dy0; dy < dy1; dy++, dst += p->dststep)
+    {
+        int sy0, sy1;
+        int fy = CV_FLT_TO_FIX(icvResizeInitY(p->ssize, p->dsize, dy, &sy0),
+                               ICV_WARP_SHIFT);
+        sy1 = sy0 + (fy > 0 && sy0 < p->ssize.height - 1);
+
+        if (sy0 == prev_sy0 && sy1 == prev_sy1)
+            k = 2;
+        else if (sy0 == prev_sy1)
+        {
+            int* t;
+            CV_SWAP(buf0, buf1, t);
+            k = 1;
+        }
+        else
+            k = 0;
+
+        for (; k < 2; k++)
+        {
+            int* _buf = k == 0 ? buf0 : buf1;
+            const uchar* _src = p->src + (k == 0 ? sy0 : sy1) * p->srcstep;
+
+            if (k == 1 && sy1 == sy0)
+            {
+                memcpy(buf1, buf0, width * sizeof(buf0[0]));
+                continue;
+            }
+
+            for (dx = 0; dx < xmax; dx++)
+            {
+                int t = _src[xofs[dx]];
+                _buf[dx] = (t << ICV_WARP_SHIFT)
+                           + xalpha[dx] * (_src[xofs[dx] + cn] - t);
+            }
+
+            for (; dx < width; dx++)
+                _buf[dx] = _src[xofs[dx]] << ICV_WARP_SHIFT;
+        }
+
+        prev_sy0 = sy0;
+        prev_sy1 = sy1;
+
+        row_func(buf0, buf1, sy0 == sy1 ? 0 : fy, dst, width);
+    }
+
+    cvFree(&buf);
+    return CV_OK;
+}
+
+static int CV_CDECL icvResizeBilinearBand_32f(int dy0, int dy1, void* arg)
+{
+    const CvResizeBilinearBand* p = (const CvResizeBilinearBand*)arg;
+    CvResizeRow32fFunc row_func = (CvResizeRow32fFunc)p->row_func;
+    int width = p->width, dy, k;
+    int prev_sy0 = -1, prev_sy1 = -1;
+    float *buf, *buf0, *buf1;
+    float* dst = (float*)(p->dst + dy0 * p->dststep);
+
+    buf = (float*)cvAlloc(width * 2 * sizeof(buf[0]));
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+    buf0 = buf;
+    buf1 = buf0 + width;
+
+    for (dy = dy0; dy < dy1; dy++, dst = (float*)((uchar*)dst + p->dststep))
+    {
+        int sy0, sy1;
+        float fy = icvResizeInitY(p->ssize, p->dsize, dy, &sy0);
+        sy1 = sy0 + (fy > 0 && sy0 < p->ssize.height - 1);
+
+        if (sy0 == prev_sy0 && sy1 == prev_sy1)
+            k = 2;
+        else if (sy0 == prev_sy1)
+        {
+            float* t;
+            CV_SWAP(buf0, buf1, t);
+            k = 1;
+        }
+        else
+            k = 0;
+
+        for (; k < 2; k++)
+        {
+            if (k == 1 && sy1 == sy0)
+            {
+                memcpy(buf1, buf0, width * sizeof(buf0[0]));
+                continue;
+            }
+
+            p->hline((const float*)(p->src
+                                    + (k == 0 ? sy0 : sy1) * p->srcstep),
+                     p->xofs, (const float*)p->xalpha, k == 0 ? buf0 : buf1,
+                     p->xmax, width);
+        }
+
+        prev_sy0 = sy0;
+        prev_sy1 = sy1;
+
+        if (sy0 == sy1)
+            memcpy(dst, buf0, width * sizeof(dst[0]));
+        else
+            row_func(buf0, buf1, fy, dst, width);
+    }
+
+    cvFree(&buf);
+    return CV_OK;
+}
+
+static CvStatus icvResizeBilinear_CnR(const void* src, int srcstep,
+                                      CvRect srcroi, void* dst, int dststep,
+                                      CvSize dsize, int interpolation,
+                                      int depth, int cn,
+                                      CvResizeHLine32fFunc hline,
+                                      void* row_func)
+{
+    CvResizeBilinearBand p;
+    int* buf;
+    int status;
+
+    if (interpolation != 1 << CV_INTER_LINEAR)
+        return CV_BADFLAG_ERR;
+
+    p.ssize = cvSize(srcroi.width, srcroi.height);
+    p.src = (const uchar*)src + srcroi.y * srcstep
+            + srcroi.x * cn * CV_ELEM_SIZE(depth);
+    p.srcstep = srcstep;
+    p.dst = (uchar*)dst;
+    p.dststep = dststep;
+    p.dsize = dsize;
+    p.cn = cn;
+    p.width = dsize.width * cn;
+    p.hline = hline;
+    p.row_func = row_func;
+
+    buf = (int*)cvAlloc(p.width * 2 * sizeof(buf[0]));
+    if (!buf)
+        return CV_OUTOFMEM_ERR;
+    p.xofs = buf;
+    p.xalpha = buf + p.width;
+
+    p.xmax = icvResizeInitXTab(p.ssize, dsize, cn, buf,
+                               depth == CV_32F ? (float*)p.xalpha : 0,
+                               depth == CV_32F ? 0 : (int*)p.xalpha);
+
+    status = cvParallelFor(cvSlice(0, dsize.height),
+                           depth == CV_32F ? icvResizeBilinearBand_32f
+                                           : icvResizeBilinearBand_8u,
+                           &p, CV_PARALLEL_GRAIN(dsize.width));
+
+    cvFree(&buf);
+    return (CvStatus)status;
+}
+
+#define ICV_DEF_RESIZE_8U(cn, isa)                                        \
+    static CvStatus CV_STDCALL icvResize_8u_C##cn##R_##isa(               \
+        const void* src, CvSize, int srcstep, CvRect srcroi, void* dst,   \
+        int dststep, CvSize dstroi, double, double, int interpolation)    \
+    {                                                                     \
+        return icvResizeBilinear_CnR(src, srcstep, srcroi, dst, dststep,  \
+                                     dstroi, interpolation, CV_8U, cn, 0, \
+                                     (void*)icvResizeRow_8u_##isa);       \
+    }
+
+#define ICV_DEF_RESIZE_32F(cn, isa, hline_isa)                          \
+    static CvStatus CV_STDCALL icvResize_32f_C##cn##R_##isa(            \
+        const void* src, CvSize, int srcstep, CvRect srcroi, void* dst, \
+        int dststep, CvSize dstroi, double, double, int interpolation)  \
+    {                                                                   \
+        return icvResizeBilinear_CnR(                                   \
+            src, srcstep, srcroi, dst, dststep, dstroi, interpolation,  \
+            CV_32F, cn, icvResizeHLine_32f_C##cn##_##hline_isa,         \
+            (void*)icvResizeRow_32f_##isa);                             \
+    }
+
+ICV_DEF_RESIZE_8U(1, sse4_1)
+ICV_DEF_RESIZE_8U(3, sse4_1)
+ICV_DEF_RESIZE_8U(4, sse4_1)
+ICV_DEF_RESIZE_8U(1, avx2)
+ICV_DEF_RESIZE_8U(3, avx2)
+ICV_DEF_RESIZE_8U(4, avx2)
+
+ICV_DEF_RESIZE_32F(1, sse2, c)
+ICV_DEF_RESIZE_32F(3, sse2, c)
+ICV_DEF_RESIZE_32F(4, sse2, c)
+ICV_DEF_RESIZE_32F(1, avx2, avx2)
+ICV_DEF_RESIZE_32F(3, avx2, avx2)
+ICV_DEF_RESIZE_32F(4, avx2, avx2)
+
+#define ICV_DEF_RESIZE_BILINEAR_VLINE(flavor, arrtype, worktype, isa)       \
+    static CvStatus CV_STDCALL icvResizeBilinearVLine_##flavor##_C1R_##isa( \
+        const worktype* buf0, const worktype* buf1, worktype fy,            \
+        arrtype* dst, int width)                                            \
+    {                                                                       \
+        icvResizeRow_##flavor##_##isa(buf0, buf1, fy, dst, width);          \
+        return CV_OK;                                                       \
+    }
+
+ICV_DEF_RESIZE_BILINEAR_VLINE(8u, uchar, int, sse4_1)
+ICV_DEF_RESIZE_BILINEAR_VLINE(8u, uchar, int, avx2)
+ICV_DEF_RESIZE_BILINEAR_VLINE(32f, float, float, sse2)
+ICV_DEF_RESIZE_BILINEAR_VLINE(32f, float, float, avx2)
+
+#undef ICV_DEF_RESIZE_BILINEAR_VLINE
+
+#undef ICV_DEF_RESIZE_8U
+#undef ICV_DEF_RESIZE_32F
+#undef ICV_DEF_RESIZE_HLINE_32F_C
+#undef ICV_DEF_RESIZE_HLINE_32F_AVX2
+
+/****************************************************************************************\
+*                                   Filtered resize *
+\****************************************************************************************/
+
+/* The row functions of the Lanczos and Mitchell resize, see
+   icvResizeFilterInitTab() in cvimgwarp.cpp. The horizontal 32f and 16u
+   functions sum the taps in a different order than the C code and may
+   differ from it in the last bits of the float results */
+
+#define ICV_RESIZE_FILTER_SCALE (1.f / (1 << ICV_RESIZE_FILTER_BITS))
+
+static void icvResizeFilterPixel_8u(const uchar* s, const short* w, int ksize,
+                                    int cn, float* dst)
+{
+    int k, c;
+
+    for (c = 0; c < cn; c++)
+    {
+        int sum = 0;
+        for (k = 0; k < ksize; k++)
+            sum += s[k * cn + c] * w[k];
+        dst[c] = sum * ICV_RESIZE_FILTER_SCALE;
+    }
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvResizeFilterHLine_8u_C1R_avx2(
+    const void* _src, float* dst, int width, int, const int* xofs,
+    const void* alpha, int ksize, int)
+{
+    const uchar* src = (const uchar*)_src;
+    int dx;
+
+    for (dx = 0; dx < width; dx++)
+    {
+        const uchar* s = src + xofs[dx];
+        const short* w = (const short*)alpha + dx * ksize;
+        __m256i sum8 = _mm256_setzero_si256();
+        __m128i sum4;
+        int k = 0, sum;
+
+        for (; k <= ksize - 16; k += 16)
+        {
+            __m256i p = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128((const __m128i*)(s + k)));
+            __m256i wk = _mm256_loadu_si256((const __m256i*)(w + k));
+            sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(p, wk));
+        }
+
+        sum4 = _mm_add_epi32(_mm256_castsi256_si128(sum8),
+                             _mm256_extracti128_si256(sum8, 1));
+        if (k <= ksize - 8)
+        {
+            __m128i p =
+                _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(s + k)));
+            __m128i wk = _mm_loadu_si128((const __m128i*)(w + k));
+            sum4 = _mm_add_epi32(sum4, _mm_madd_epi16(p, wk));
+            k += 8;
+        }
+        if (k <= ksize - 4)
+        {
+            __m128i p = _mm_cvtsi32_si128(*(const int*)(s + k));
+            p = _mm_cvtepu8_epi16(p);
+            __m128i wk = _mm_loadl_epi64((const __m128i*)(w + k));
+            sum4 = _mm_add_epi32(sum4, _mm_madd_epi16(p, wk));
+            k += 4;
+        }
+        sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, 0x4e));
+        sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, 0xb1));
+        sum = _mm_cvtsi128_si32(sum4);
+
+        for (; k < ksize; k++)
+            sum += s[k] * w[k];
+        dst[dx] = sum * ICV_RESIZE_FILTER_SCALE;
+    }
+
+    return CV_OK;
+}
+
+/* Multi-channel 8u rows: every 128-bit half takes a pair of taps, with the
+   two pixels interleaved channel by channel for _mm256_madd_epi16 */
+#define ICV_DEF_RESIZE_FILTER_HLINE_8U_AVX2(cn, mask0, mask1)                \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL                                \
+        icvResizeFilterHLine_8u_C##cn##R_avx2(                               \
+            const void* _src, float* dst, int width, int xmax,               \
+            const int* xofs, const void* alpha, int ksize, int)              \
+    {                                                                        \
+        const uchar* src = (const uchar*)_src;                               \
+        const __m256i mask = _mm256_setr_epi8 mask0;                         \
+        const __m128i mask2 = _mm_setr_epi8 mask1;                           \
+        const __m256i widx = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);      \
+        const __m128 scale = _mm_set1_ps(ICV_RESIZE_FILTER_SCALE);           \
+        int dx;                                                              \
+                                                                             \
+        for (dx = 0; dx < xmax; dx++)                                        \
+        {                                                                    \
+            const uchar* s = src + xofs[dx] * cn;                            \
+            const short* w = (const short*)alpha + dx * ksize;               \
+            __m256i sum8 = _mm256_setzero_si256();                           \
+            __m128i sum4;                                                    \
+            __m128 r;                                                        \
+            int k = 0;                                                       \
+                                                                             \
+            for (; k <= ksize - 4; k += 4, s += cn * 4)                      \
+            {                                                                \
+                __m256i p = _mm256_broadcastsi128_si256(                     \
+                    _mm_loadu_si128((const __m128i*)s));                     \
+                __m256i wk = _mm256_castsi128_si256(                         \
+                    _mm_loadl_epi64((const __m128i*)(w + k)));               \
+                p = _mm256_shuffle_epi8(p, mask);                            \
+                wk = _mm256_permutevar8x32_epi32(wk, widx);                  \
+                sum8 = _mm256_add_epi32(sum8, _mm256_madd_epi16(p, wk));     \
+            }                                                                \
+                                                                             \
+            sum4 = _mm_add_epi32(_mm256_castsi256_si128(sum8),               \
+                                 _mm256_extracti128_si256(sum8, 1));         \
+            if (k < ksize)                                                   \
+            {                                                                \
+                __m128i p = _mm_loadl_epi64((const __m128i*)s);              \
+                p = _mm_shuffle_epi8(p, mask2);                              \
+                __m128i wk =                                                 \
+                    _mm_set1_epi32((ushort)w[k] | ((int)w[k + 1] << 16));    \
+                sum4 = _mm_add_epi32(sum4, _mm_madd_epi16(p, wk));           \
+            }                                                                \
+                                                                             \
+            r = _mm_mul_ps(_mm_cvtepi32_ps(sum4), scale);                    \
+            if (cn == 4)                                                     \
+                _mm_storeu_ps(dst + dx * cn, r);                             \
+            else                                                             \
+            {                                                                \
+                _mm_storel_pi((__m64*)(dst + dx * cn), r);                   \
+                _mm_store_ss(dst + dx * cn + 2, _mm_movehl_ps(r, r));        \
+            }                                                                \
+        }                                                                    \
+                                                                             \
+        for (; dx < width; dx++)                                             \
+            icvResizeFilterPixel_8u(src + xofs[dx] * cn,                     \
+                                    (const short*)alpha + dx * ksize, ksize, \
+                                    cn, dst + dx * cn);                      \
+                                                                             \
+        return CV_OK;                                                        \
+    }
+
+ICV_DEF_RESIZE_FILTER_HLINE_8U_AVX2(
+    3,
+    (0, -1, 3, -1, 1, -1, 4, -1, 2, -1, 5, -1, -1, -1, -1, -1, 6, -1, 9, -1, 7,
+     -1, 10, -1, 8, -1, 11, -1, -1, -1, -1, -1),
+    (0, -1, 3, -1, 1, -1, 4, -1, 2, -1, 5, -1, -1, -1, -1, -1))
+ICV_DEF_RESIZE_FILTER_HLINE_8U_AVX2(
+    4,
+    (0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1, 8, -1, 12, -1, 9,
+     -1, 13, -1, 10, -1, 14, -1, 11, -1, 15, -1),
+    (0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6, -1, 3, -1, 7, -1))
+
+/* Loads 8 and 4 consecutive values of a 1-channel row and a pair of
+   3- or 4-channel pixels (the 4th channel is not used for 3 channels) */
+#define ICV_RESIZE_LOAD8_32F(s) _mm256_loadu_ps(s)
+#define ICV_RESIZE_LOAD4_32F(s) _mm_loadu_ps(s)
+#define ICV_RESIZE_LOAD2_32F_C3(s)                                \
+    _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s)), \
+                         _mm_loadu_ps((s) + 3), 1)
+#define ICV_RESIZE_LOAD2_32F_C4(s) _mm256_loadu_ps(s)
+
+#define ICV_RESIZE_LOAD8_16U(s) \
+    _mm256_cvtepi32_ps(         \
+        _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(s))))
+#define ICV_RESIZE_LOAD4_16U(s) \
+    _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(s))))
+#define ICV_RESIZE_LOAD2_16U_C3(s)                             \
+    _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_shuffle_epi8( \
+        _mm_loadu_si128((const __m128i*)(s)),                  \
+        _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1))))
+#define ICV_RESIZE_LOAD2_16U_C4(s) ICV_RESIZE_LOAD8_16U(s)
+
+#define ICV_DEF_RESIZE_FILTER_HLINE_AVX2(flavor, arrtype, FLAVOR)            \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL                                \
+        icvResizeFilterHLine_##flavor##_C1R_avx2(                            \
+            const void* _src, float* dst, int width, int, const int* xofs,   \
+            const void* alpha, int ksize, int)                               \
+    {                                                                        \
+        const arrtype* src = (const arrtype*)_src;                           \
+        int dx;                                                              \
+                                                                             \
+        for (dx = 0; dx < width; dx++)                                       \
+        {                                                                    \
+            const arrtype* s = src + xofs[dx];                               \
+            const float* w = (const float*)alpha + dx * ksize;               \
+            __m256 sum8 = _mm256_setzero_ps();                               \
+            __m128 sum4;                                                     \
+            float sum;                                                       \
+            int k = 0;                                                       \
+                                                                             \
+            for (; k <= ksize - 8; k += 8)                                   \
+            {                                                                \
+                __m256 p = ICV_RESIZE_LOAD8_##FLAVOR(s + k);                 \
+                __m256 wk = _mm256_loadu_ps(w + k);                          \
+                sum8 = _mm256_add_ps(sum8, _mm256_mul_ps(p, wk));            \
+            }                                                                \
+                                                                             \
+            sum4 = _mm_add_ps(_mm256_castps256_ps128(sum8),                  \
+                              _mm256_extractf128_ps(sum8, 1));               \
+            if (k <= ksize - 4)                                              \
+            {                                                                \
+                __m128 p = ICV_RESIZE_LOAD4_##FLAVOR(s + k);                 \
+                sum4 = _mm_add_ps(sum4, _mm_mul_ps(p, _mm_loadu_ps(w + k))); \
+                k += 4;                                                      \
+            }                                                                \
+            sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));              \
+            sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 1));          \
+            sum = _mm_cvtss_f32(sum4);                                       \
+                                                                             \
+            for (; k < ksize; k++)                                           \
+                sum += s[k] * w[k];                                          \
+            dst[dx] = sum;                                                   \
+        }                                                                    \
+                                                                             \
+        return CV_OK;                                                        \
+    }
+
+/* Multi-channel float rows: the 128-bit halves sum the even and the odd
+   taps */
+#define ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2(flavor, arrtype, FLAVOR, cn) \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL                            \
+        icvResizeFilterHLine_##flavor##_C##cn##R_avx2(                   \
+            const void* _src, float* dst, int width, int xmax,           \
+            const int* xofs, const void* alpha, int ksize, int)          \
+    {                                                                    \
+        const arrtype* src = (const arrtype*)_src;                       \
+        const __m256i widx = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);  \
+        int dx, k, c;                                                    \
+                                                                         \
+        for (dx = 0; dx < xmax; dx++)                                    \
+        {                                                                \
+            const arrtype* s = src + xofs[dx] * cn;                      \
+            const float* w = (const float*)alpha + dx * ksize;           \
+            __m256 sum8 = _mm256_setzero_ps();                           \
+            __m128 r;                                                    \
+                                                                         \
+            for (k = 0; k < ksize; k += 2, s += cn * 2)                  \
+            {                                                            \
+                __m256 wk = _mm256_permutevar8x32_ps(                    \
+                    _mm256_castps128_ps256(_mm_castsi128_ps(             \
+                        _mm_loadl_epi64((const __m128i*)(w + k)))),      \
+                    widx);                                               \
+                __m256 p = ICV_RESIZE_LOAD2_##FLAVOR##_C##cn(s);         \
+                sum8 = _mm256_add_ps(sum8, _mm256_mul_ps(p, wk));        \
+            }                                                            \
+                                                                         \
+            r = _mm_add_ps(_mm256_castps256_ps128(sum8),                 \
+                           _mm256_extractf128_ps(sum8, 1));              \
+            if (cn == 4)                                                 \
+                _mm_storeu_ps(dst + dx * cn, r);                         \
+            else                                                         \
+            {                                                            \
+                _mm_storel_pi((__m64*)(dst + dx * cn), r);               \
+                _mm_store_ss(dst + dx * cn + 2, _mm_movehl_ps(r, r));    \
+            }                                                            \
+        }                                                                \
+                                                                         \
+        for (; dx < width; dx++)                                         \
+        {                                                                \
+            const arrtype* s = src + xofs[dx] * cn;                      \
+            const float* w = (const float*)alpha + dx * ksize;           \
+                                                                         \
+            for (c = 0; c < cn; c++)                                     \
+            {                                                            \
+                float sum = 0;                                           \
+                for (k = 0; k < ksize; k++)                              \
+                    sum += s[k * cn + c] * w[k];                         \
+                dst[dx * cn + c] = sum;                                  \
+            }                                                            \
+        }                                                                \
+                                                                         \
+        return CV_OK;                                                    \
+    }
+
+ICV_DEF_RESIZE_FILTER_HLINE_AVX2(16u, ushort, 16U)
+ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2(16u, ushort, 16U, 3)
+ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2(16u, ushort, 16U, 4)
+ICV_DEF_RESIZE_FILTER_HLINE_AVX2(32f, float, 32F)
+ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2(32f, float, 32F, 3)
+ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2(32f, float, 32F, 4)
+
+/* The vertical functions sum the rows in the same order as the C code */
+#define ICV_RESIZE_FILTER_VSUM_AVX2(x)                               \
+    __m256 b = _mm256_set1_ps(beta[0]);                              \
+    __m256 s0 = _mm256_mul_ps(_mm256_loadu_ps(src[0] + (x)), b);     \
+    __m256 s1 = _mm256_mul_ps(_mm256_loadu_ps(src[0] + (x) + 8), b); \
+    for (k = 1; k < ksize; k++)                                      \
+    {                                                                \
+        __m256 p0 = _mm256_loadu_ps(src[k] + (x));                   \
+        __m256 p1 = _mm256_loadu_ps(src[k] + (x) + 8);               \
+        b = _mm256_set1_ps(beta[k]);                                 \
+        s0 = _mm256_add_ps(s0, _mm256_mul_ps(p0, b));                \
+        s1 = _mm256_add_ps(s1, _mm256_mul_ps(p1, b));                \
+    }
+
+#define ICV_DEF_RESIZE_FILTER_VLINE_AVX2(flavor, arrtype, cast_macro1,         \
+                                         cast_macro2, store_macro)             \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL                                  \
+        icvResizeFilterVLine_##flavor##_C1R_avx2(const float** src,            \
+                                                 const float* beta, int ksize, \
+                                                 void* _dst, int width)        \
+    {                                                                          \
+        arrtype* dst = (arrtype*)_dst;                                         \
+        int x = 0, k;                                                          \
+                                                                               \
+        for (; x <= width - 16; x += 16)                                       \
+        {                                                                      \
+            ICV_RESIZE_FILTER_VSUM_AVX2(x)                                     \
+            store_macro(dst + x, s0, s1);                                      \
+        }                                                                      \
+                                                                               \
+        for (; x < width; x++)                                                 \
+        {                                                                      \
+            float sum = src[0][x] * beta[0];                                   \
+            for (k = 1; k < ksize; k++)                                        \
+                sum += src[k][x] * beta[k];                                    \
+            dst[x] = (arrtype)cast_macro2(cast_macro1(sum));                   \
+        }                                                                      \
+                                                                               \
+        return CV_OK;                                                          \
+    }
+
+// the conversion rounds to the nearest even integer like cvRound()
+#define ICV_RESIZE_STORE16_8U(d, s0, s1)                                     \
+    {                                                                        \
+        __m256i i0 = _mm256_packs_epi32(_mm256_cvtps_epi32(s0),              \
+                                        _mm256_cvtps_epi32(s1));             \
+        i0 = _mm256_permute4x64_epi64(i0, 0xd8);                             \
+        _mm_storeu_si128((__m128i*)(d),                                      \
+                         _mm_packus_epi16(_mm256_castsi256_si128(i0),        \
+                                          _mm256_extracti128_si256(i0, 1))); \
+    }
+#define ICV_RESIZE_STORE16_16U(d, s0, s1)                                     \
+    _mm256_storeu_si256(                                                      \
+        (__m256i*)(d),                                                        \
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(_mm256_cvtps_epi32(s0),  \
+                                                     _mm256_cvtps_epi32(s1)), \
+                                 0xd8))
+#define ICV_RESIZE_STORE16_32F(d, s0, s1) \
+    (_mm256_storeu_ps(d, s0), _mm256_storeu_ps((d) + 8, s1))
+
+ICV_DEF_RESIZE_FILTER_VLINE_AVX2(8u, uchar, cvRound, CV_CAST_8U,
+                                 ICV_RESIZE_STORE16_8U)
+ICV_DEF_RESIZE_FILTER_VLINE_AVX2(16u, ushort, cvRound, CV_CAST_16U,
+                                 ICV_RESIZE_STORE16_16U)
+ICV_DEF_RESIZE_FILTER_VLINE_AVX2(32f, float, CV_NOP, CV_NOP,
+                                 ICV_RESIZE_STORE16_32F)
+
+#undef ICV_RESIZE_FILTER_SCALE
+#undef ICV_DEF_RESIZE_FILTER_HLINE_8U_AVX2
+#undef ICV_RESIZE_LOAD8_32F
+#undef ICV_RESIZE_LOAD4_32F
+#undef ICV_RESIZE_LOAD2_32F_C3
+#undef ICV_RESIZE_LOAD2_32F_C4
+#undef ICV_RESIZE_LOAD8_16U
+#undef ICV_RESIZE_LOAD4_16U
+#undef ICV_RESIZE_LOAD2_16U_C3
+#undef ICV_RESIZE_LOAD2_16U_C4
+#undef ICV_DEF_RESIZE_FILTER_HLINE_AVX2
+#undef ICV_DEF_RESIZE_FILTER_HLINE_CN_AVX2
+#undef ICV_RESIZE_FILTER_VSUM_AVX2
+#undef ICV_DEF_RESIZE_FILTER_VLINE_AVX2
+#undef ICV_RESIZE_STORE16_8U
+#undef ICV_RESIZE_STORE16_16U
+#undef ICV_RESIZE_STORE16_32F
+
+/****************************************************************************************\
+*                                   Bilinear remap *
+\****************************************************************************************/
+
+/* Computes the integer coordinates, the weights and the inlier mask of four
+   destination pixels the same way icvRemap_Bilinear_*_CnR does */
+CV_TARGET_SSE2 CV_INLINE __m128i icvRemapCoeffs_sse2(
+    const float* mapx, const float* mapy, CvSize ssize, __m128i& ix,
+    __m128i& iy, __m128& x0, __m128& y0)
+{
+    const __m128 scale = _mm_set1_ps((float)(1 << ICV_WARP_SHIFT));
+    const __m128 iscale = _mm_set1_ps(1.f / (1 << ICV_WARP_SHIFT));
+    const __m128i mask = _mm_set1_epi32(ICV_WARP_MASK);
+    const __m128i smin = _mm_set1_epi32(INT_MIN);
+    __m128i w, h;
+
+    ix = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mapx), scale));
+    iy = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mapy), scale));
+    x0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(ix, mask)), iscale);
+    y0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(iy, mask)), iscale);
+    ix = _mm_srai_epi32(ix, ICV_WARP_SHIFT);
+    iy = _mm_srai_epi32(iy, ICV_WARP_SHIFT);
+
+    // (unsigned)ix < (unsigned)(ssize.width - 1), in signed arithmetic
+    w = _mm_set1_epi32((ssize.width - 1) ^ INT_MIN);
+    h = _mm_set1_epi32((ssize.height - 1) ^ INT_MIN);
+    return _mm_and_si128(_mm_cmplt_epi32(_mm_xor_si128(ix, smin), w),
+                         _mm_cmplt_epi32(_mm_xor_si128(iy, smin), h));
+}
+
+/* the 3-channel pixels are loaded with their next value too when that
+   does not read past the last pixel of the image (wide != 0); the extra
+   lane is not stored */
+#define ICV_REMAP_LOAD_8u(s, cn, wide)                                      \
+    ((cn) == 4 || (wide)                                                    \
+         ? _mm_cvtepi32_ps(_mm_unpacklo_epi16(                              \
+               _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int*)(s)),       \
+                                 _mm_setzero_si128()),                      \
+               _mm_setzero_si128()))                                        \
+         : _mm_setr_ps((float)(s)[0], (float)(s)[1], (float)(s)[2], 0))
+
+#define ICV_REMAP_LOAD_32f(s, cn, wide)         \
+    ((cn) == 4 || (wide) ? _mm_loadu_ps(s)     \
+                         : _mm_setr_ps((s)[0], (s)[1], (s)[2], 0))
+
+#define ICV_REMAP_STORE_8u(d, v, cn)                          \
+    {                                                         \
+        __m128i _t = _mm_cvtps_epi32(v);                      \
+        _t = _mm_packs_epi32(_t, _t);                         \
+        int _p = _mm_cvtsi128_si32(_mm_packus_epi16(_t, _t)); \
+        if ((cn) == 4)                                        \
+            *(int*)(d) = _p;                                  \
+        else                                                  \
+            (d)[0] = (uchar)_p, (d)[1] = (uchar)(_p >> 8),    \
+            (d)[2] = (uchar)(_p >> 16);                       \
+    }
+
+#define ICV_REMAP_STORE_32f(d, v, cn)                   \
+    {                                                   \
+        if ((cn) == 4)                                  \
+            _mm_storeu_ps(d, v);                        \
+        else                                            \
+        {                                               \
+            _mm_storel_pi((__m64*)(d), v);              \
+            _mm_store_ss((d) + 2, _mm_movehl_ps(v, v)); \
+        }                                               \
+    }
+
+#define ICV_REMAP_CAST_8u(x) ((uchar)cvRound(x))
+#define ICV_REMAP_CAST_32f(x) (x)
+
+/* the pairs s0[0], s0[1] and s1[0], s1[1] of a single-channel row */
+#define ICV_REMAP_LOAD2_8u(s0, s1)                                      \
+    _mm_cvtepi32_ps(_mm_unpacklo_epi16(                                 \
+        _mm_unpacklo_epi8(                                              \
+            _mm_cvtsi32_si128(*(const ushort*)(s0)                      \
+                              | (*(const ushort*)(s1) << 16)),          \
+            _mm_setzero_si128()),                                       \
+        _mm_setzero_si128()))
+
+#define ICV_REMAP_LOAD2_32f(s0, s1)                                     \
+    _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(s0)),    \
+                 (const __m64*)(s1))
+
+/* four single-channel pixels, all inliers */
+#define ICV_REMAP_STORE4_8u(d, v)                                       \
+    {                                                                   \
+        __m128i _t = _mm_cvtps_epi32(v);                                \
+        _t = _mm_packs_epi32(_t, _t);                                   \
+        *(int*)(d) = _mm_cvtsi128_si32(_mm_packus_epi16(_t, _t));       \
+    }
+
+#define ICV_REMAP_STORE4_32f(d, v) _mm_storeu_ps(d, v)
+
+/* The SSE2 version: the coordinates and the weights are computed for four
+   pixels at once, the channels of a multi-channel pixel are interpolated
+   together */
+#define ICV_DEF_REMAP_SSE2(flavor, arrtype)                                   \
+    CV_TARGET_SSE2 static void icvRemapRow_##flavor##_sse2(                   \
+        const arrtype* src, int srcstep, CvSize ssize, arrtype* dst,          \
+        const float* mapx, const float* mapy, int width, int cn)              \
+    {                                                                         \
+        int j, k;                                                             \
+                                                                              \
+        for (j = 0; j < width; j += 4)                                        \
+        {                                                                     \
+            __m128i ix, iy, m;                                                \
+            __m128 x0, y0, x1, y1;                                            \
+            int ibuf[3][4];                                                   \
+            float fbuf[4][4];                                                 \
+            float mbuf[2][4];                                                 \
+            int n = MIN(width - j, 4);                                        \
+                                                                              \
+            if (n < 4)                                                        \
+            {                                                                 \
+                memcpy(mbuf[0], mapx + j, n * sizeof(float));                 \
+                memcpy(mbuf[1], mapy + j, n * sizeof(float));                 \
+                for (k = n; k < 4; k++)                                       \
+                    mbuf[0][k] = mbuf[1][k] = -1.f;                           \
+                m = icvRemapCoeffs_sse2(mbuf[0], mbuf[1], ssize, ix, iy, x0,  \
+                                        y0);                                  \
+            }                                                                 \
+            else                                                              \
+                m = icvRemapCoeffs_sse2(mapx + j, mapy + j, ssize, ix, iy,    \
+                                        x0, y0);                              \
+                                                                              \
+            if (_mm_movemask_epi8(m) == 0)                                    \
+                continue;                                                     \
+                                                                              \
+            _mm_storeu_si128((__m128i*)ibuf[0], ix);                          \
+            _mm_storeu_si128((__m128i*)ibuf[1], iy);                          \
+            _mm_storeu_si128((__m128i*)ibuf[2], m);                           \
+            x1 = _mm_sub_ps(_mm_set1_ps(1.f), x0);                            \
+            y1 = _mm_sub_ps(_mm_set1_ps(1.f), y0);                            \
+                                                                              \
+            if (cn == 1)                                                      \
+            {                                                                 \
+                const arrtype* sp[4];                                         \
+                __m128 a, b, t0, t1;                                          \
+                for (k = 0; k < 4; k++)                                       \
+                    sp[k] = ibuf[2][k] ? src + ibuf[1][k] * srcstep           \
+                                             + ibuf[0][k]                     \
+                                       : src;                                 \
+                /* the left and the right neighbours, top row first */        \
+                a = ICV_REMAP_LOAD2_##flavor(sp[0], sp[1]);                   \
+                b = ICV_REMAP_LOAD2_##flavor(sp[2], sp[3]);                   \
+                t0 = _mm_add_ps(                                              \
+                    _mm_mul_ps(x1, _mm_shuffle_ps(a, b, 0x88)),               \
+                    _mm_mul_ps(x0, _mm_shuffle_ps(a, b, 0xdd)));              \
+                a = ICV_REMAP_LOAD2_##flavor(sp[0] + srcstep,                 \
+                                             sp[1] + srcstep);                \
+                b = ICV_REMAP_LOAD2_##flavor(sp[2] + srcstep,                 \
+                                             sp[3] + srcstep);                \
+                t1 = _mm_add_ps(                                              \
+                    _mm_mul_ps(x1, _mm_shuffle_ps(a, b, 0x88)),               \
+                    _mm_mul_ps(x0, _mm_shuffle_ps(a, b, 0xdd)));              \
+                t0 = _mm_add_ps(_mm_mul_ps(y1, t0), _mm_mul_ps(y0, t1));      \
+                if (n == 4 && _mm_movemask_epi8(m) == 0xffff)                 \
+                {                                                             \
+                    ICV_REMAP_STORE4_##flavor(dst + j, t0);                   \
+                    continue;                                                 \
+                }                                                             \
+                _mm_storeu_ps(fbuf[0], t0);                                   \
+                for (k = 0; k < n; k++)                                       \
+                    if (ibuf[2][k])                                           \
+                        dst[j + k] = ICV_REMAP_CAST_##flavor(fbuf[0][k]);     \
+            }                                                                 \
+            else                                                              \
+            {                                                                 \
+                _mm_storeu_ps(fbuf[0], x0);                                   \
+                _mm_storeu_ps(fbuf[1], x1);                                   \
+                _mm_storeu_ps(fbuf[2], y0);                                   \
+                _mm_storeu_ps(fbuf[3], y1);                                   \
+                                                                              \
+                for (k = 0; k < n; k++)                                       \
+                {                                                             \
+                    const arrtype* s;                                         \
+                    __m128 t0, t1;                                            \
+                    int wide;                                                 \
+                                                                              \
+                    if (!ibuf[2][k])                                          \
+                        continue;                                             \
+                                                                              \
+                    s = src + ibuf[1][k] * srcstep + ibuf[0][k] * cn;         \
+                    wide = ibuf[0][k] < ssize.width - 2                       \
+                           || ibuf[1][k] < ssize.height - 2;                  \
+                    t0 = _mm_add_ps(                                          \
+                        _mm_mul_ps(_mm_set1_ps(fbuf[1][k]),                   \
+                                   ICV_REMAP_LOAD_##flavor(s, cn, 1)),        \
+                        _mm_mul_ps(_mm_set1_ps(fbuf[0][k]),                   \
+                                   ICV_REMAP_LOAD_##flavor(s + cn, cn, 1)));  \
+                    t1 = _mm_add_ps(                                          \
+                        _mm_mul_ps(                                           \
+                            _mm_set1_ps(fbuf[1][k]),                          \
+                            ICV_REMAP_LOAD_##flavor(s + srcstep, cn, 1)),     \
+                        _mm_mul_ps(_mm_set1_ps(fbuf[0][k]),                   \
+                                   ICV_REMAP_LOAD_##flavor(s + srcstep + cn,  \
+                                                           cn, wide)));       \
+                    t0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fbuf[3][k]), t0),  \
+                                    _mm_mul_ps(_mm_set1_ps(fbuf[2][k]), t1)); \
+                    ICV_REMAP_STORE_##flavor(dst + (j + k) * cn, t0, cn);     \
+                }                                                             \
+            }                                                                 \
+        }                                                                     \
+    }
+
+ICV_DEF_REMAP_SSE2(8u, uchar)
+ICV_DEF_REMAP_SSE2(32f, float)
+
+/* The AVX2 versions of the single-channel functions: the source pixels are
+   gathered and the outliers are masked out on store */
+CV_TARGET_AVX2 CV_INLINE __m256i icvRemapCoeffs_avx2(
+    const float* mapx, const float* mapy, CvSize ssize, int srcstep, int cn,
+    __m256i& ofs, __m256& x0, __m256& y0)
+{
+    const __m256 scale = _mm256_set1_ps((float)(1 << ICV_WARP_SHIFT));
+    const __m256 iscale = _mm256_set1_ps(1.f / (1 << ICV_WARP_SHIFT));
+    const __m256i mask = _mm256_set1_epi32(ICV_WARP_MASK);
+    const __m256i smin = _mm256_set1_epi32(INT_MIN);
+    __m256i ix, iy, m;
+
+    ix = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(mapx), scale));
+    iy = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(mapy), scale));
+    x0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(ix, mask)),
+                       iscale);
+    y0 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(iy, mask)),
+                       iscale);
+    ix = _mm256_srai_epi32(ix, ICV_WARP_SHIFT);
+    iy = _mm256_srai_epi32(iy, ICV_WARP_SHIFT);
+
+    m = _mm256_and_si256(
+        _mm256_cmpgt_epi32(_mm256_set1_epi32((ssize.width - 1) ^ INT_MIN),
+                           _mm256_xor_si256(ix, smin)),
+        _mm256_cmpgt_epi32(_mm256_set1_epi32((ssize.height - 1) ^ INT_MIN),
+                           _mm256_xor_si256(iy, smin)));
+
+    // the outliers read the top-left pixel
+    ofs = _mm256_add_epi32(_mm256_mullo_epi32(iy, _mm256_set1_epi32(srcstep)),
+                           _mm256_mullo_epi32(ix, _mm256_set1_epi32(cn)));
+    ofs = _mm256_and_si256(ofs, m);
+    return m;
+}
+
+CV_TARGET_AVX2 static void icvRemapRow_32f_C1_avx2(const float* src,
+                                                   int srcstep, CvSize ssize,
+                                                   float* dst,
+                                                   const float* mapx,
+                                                   const float* mapy,
+                                                   int width, int cn)
+{
+    int j = 0;
+
+    for (; j <= width - 8; j += 8)
+    {
+        __m256i ofs, m;
+        __m256 x0, y0, x1, y1, t0, t1;
+
+        m = icvRemapCoeffs_avx2(mapx + j, mapy + j, ssize, srcstep, 1, ofs,
+                                x0, y0);
+        if (_mm256_testz_si256(m, m))
+            continue;
+
+        x1 = _mm256_sub_ps(_mm256_set1_ps(1.f), x0);
+        y1 = _mm256_sub_ps(_mm256_set1_ps(1.f), y0);
+        t0 = _mm256_add_ps(
+            _mm256_mul_ps(x1, _mm256_i32gather_ps(src, ofs, 4)),
+            _mm256_mul_ps(x0, _mm256_i32gather_ps(src + 1, ofs, 4)));
+        t1 = _mm256_add_ps(
+            _mm256_mul_ps(x1, _mm256_i32gather_ps(src + srcstep, ofs, 4)),
+            _mm256_mul_ps(x0, _mm256_i32gather_ps(src + srcstep + 1, ofs, 4)));
+        t0 = _mm256_add_ps(_mm256_mul_ps(y1, t0), _mm256_mul_ps(y0, t1));
+        _mm256_maskstore_ps(dst + j, m, t0);
+    }
+
+    if (j < width)
+        icvRemapRow_32f_sse2(src, srcstep, ssize, dst + j, mapx + j, mapy + j,
+                             width - j, cn);
+}
+
+CV_TARGET_AVX2 static void icvRemapRow_8u_C1_avx2(const uchar* src,
+                                                  int srcstep, CvSize ssize,
+                                                  uchar* dst,
+                                                  const float* mapx,
+                                                  const float* mapy, int width,
+                                                  int cn)
+{
+    const __m256i bmask = _mm256_set1_epi32(255);
+    int j = 0;
+
+    // the 4-byte gathers need at least 2x2 pixels
+    if (ssize.width >= 2 && ssize.height >= 2 && srcstep >= 2)
+    {
+        for (; j <= width - 8; j += 8)
+        {
+            __m256i ofs, m, w0, w1, d;
+            __m256 x0, y0, x1, y1, t0, t1;
+            __m128i r;
+
+            m = icvRemapCoeffs_avx2(mapx + j, mapy + j, ssize, srcstep, 1,
+                                    ofs, x0, y0);
+            if (_mm256_testz_si256(m, m))
+                continue;
+
+            // w0 holds s[0] and s[1] in its low bytes, w1 holds s[srcstep]
+            // and s[srcstep+1] in its high bytes, so that no byte after the
+            // bottom-right tap is read
+            w0 = _mm256_i32gather_epi32((const int*)src, ofs, 1);
+            w1 = _mm256_i32gather_epi32((const int*)(src + srcstep - 2), ofs,
+                                        1);
+
+            x1 = _mm256_sub_ps(_mm256_set1_ps(1.f), x0);
+            y1 = _mm256_sub_ps(_mm256_set1_ps(1.f), y0);
+            t0 = _mm256_add_ps(
+                _mm256_mul_ps(x1, _mm256_cvtepi32_ps(
+                                      _mm256_and_si256(w0, bmask))),
+                _mm256_mul_ps(x0, _mm256_cvtepi32_ps(_mm256_and_si256(
+                                      _mm256_srli_epi32(w0, 8), bmask))));
+            t1 = _mm256_add_ps(
+                _mm256_mul_ps(x1, _mm256_cvtepi32_ps(_mm256_and_si256(
+                                      _mm256_srli_epi32(w1, 16), bmask))),
+                _mm256_mul_ps(x0, _mm256_cvtepi32_ps(
+                                      _mm256_srli_epi32(w1, 24))));
+            t0 = _mm256_add_ps(_mm256_mul_ps(y1, t0), _mm256_mul_ps(y0, t1));
+
+            // keep the destination pixels of the outliers
+            d = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((const __m128i*)(dst + j)));
+            d = _mm256_blendv_epi8(d, _mm256_cvtps_epi32(t0), m);
+            r = _mm_packs_epi32(_mm256_castsi256_si128(d),
+                                _mm256_extracti128_si256(d, 1));
+            _mm_storel_epi64((__m128i*)(dst + j), _mm_packus_epi16(r, r));
+        }
+    }
+
+    if (j < width)
+        icvRemapRow_8u_sse2(src, srcstep, ssize, dst + j, mapx + j, mapy + j,
+                            width - j, cn);
+}
+
+CV_TARGET_AVX2 static void icvRemapRow_8u_C4_avx2(const uchar* src,
+                                                  int srcstep, CvSize ssize,
+                                                  uchar* dst,
+                                                  const float* mapx,
+                                                  const float* mapy, int width,
+                                                  int cn)
+{
+    const __m256i bmask = _mm256_set1_epi32(255);
+    int j = 0, k;
+
+    for (; j <= width - 8; j += 8)
+    {
+        __m256i ofs, m, w[4], d = _mm256_setzero_si256();
+        __m256 x0, y0, x1, y1;
+
+        m = icvRemapCoeffs_avx2(mapx + j, mapy + j, ssize, srcstep, 4, ofs,
+                                x0, y0);
+        if (_mm256_testz_si256(m, m))
+            continue;
+
+        // one 4-channel pixel per 32-bit lane
+        w[0] = _mm256_i32gather_epi32((const int*)src, ofs, 1);
+        w[1] = _mm256_i32gather_epi32((const int*)(src + 4), ofs, 1);
+        w[2] = _mm256_i32gather_epi32((const int*)(src + srcstep), ofs, 1);
+        w[3] = _mm256_i32gather_epi32((const int*)(src + srcstep + 4), ofs, 1);
+
+        x1 = _mm256_sub_ps(_mm256_set1_ps(1.f), x0);
+        y1 = _mm256_sub_ps(_mm256_set1_ps(1.f), y0);
+
+        for (k = 0; k < 4; k++)
+        {
+            __m128i sh = _mm_cvtsi32_si128(k * 8);
+            __m256 s[4], t0, t1;
+            int l;
+
+            for (l = 0; l < 4; l++)
+                s[l] = _mm256_cvtepi32_ps(
+                    _mm256_and_si256(_mm256_srl_epi32(w[l], sh), bmask));
+
+            t0 = _mm256_add_ps(_mm256_mul_ps(x1, s[0]),
+                               _mm256_mul_ps(x0, s[1]));
+            t1 = _mm256_add_ps(_mm256_mul_ps(x1, s[2]),
+                               _mm256_mul_ps(x0, s[3]));
+            t0 = _mm256_add_ps(_mm256_mul_ps(y1, t0), _mm256_mul_ps(y0, t1));
+            d = _mm256_or_si256(
+                d, _mm256_sll_epi32(
+                       _mm256_and_si256(_mm256_cvtps_epi32(t0), bmask), sh));
+        }
+
+        // keep the destination pixels of the outliers
+        d = _mm256_blendv_epi8(
+            _mm256_loadu_si256((const __m256i*)(dst + j * 4)), d, m);
+        _mm256_storeu_si256((__m256i*)(dst + j * 4), d);
+    }
+
+    if (j < width)
+        icvRemapRow_8u_sse2(src, srcstep, ssize, dst + j * 4, mapx + j,
+                            mapy + j, width - j, cn);
+}
+
+/* As the 4-channel version, but every gather reads the 3 channels and the
+   first byte of the next pixel. That byte is past the image only for the
+   bottom-right neighbours; the blocks that use them go to the SSE2 code.
+   The outliers keep their destination pixels. */
+CV_TARGET_AVX2 static void icvRemapRow_8u_C3_avx2(const uchar* src,
+                                                  int srcstep, CvSize ssize,
+                                                  uchar* dst,
+                                                  const float* mapx,
+                                                  const float* mapy, int width,
+                                                  int cn)
+{
+    const __m256i bmask = _mm256_set1_epi32(255);
+    const __m256i last = _mm256_set1_epi32((ssize.height - 2) * srcstep
+                                           + (ssize.width - 2) * 3);
+    int j = 0, k;
+
+    for (; j <= width - 8; j += 8)
+    {
+        __m256i ofs, m, w[4], d = _mm256_setzero_si256();
+        __m256 x0, y0, x1, y1;
+        int dbuf[8], mbuf[8];
+
+        m = icvRemapCoeffs_avx2(mapx + j, mapy + j, ssize, srcstep, 3, ofs,
+                                x0, y0);
+        if (_mm256_testz_si256(m, m))
+            continue;
+        if (!_mm256_testz_si256(_mm256_cmpeq_epi32(ofs, last), m))
+        {
+            icvRemapRow_8u_sse2(src, srcstep, ssize, dst + j * 3, mapx + j,
+                                mapy + j, 8, cn);
+            continue;
+        }
+
+        w[0] = _mm256_i32gather_epi32((const int*)src, ofs, 1);
+        w[1] = _mm256_i32gather_epi32((const int*)(src + 3), ofs, 1);
+        w[2] = _mm256_i32gather_epi32((const int*)(src + srcstep), ofs, 1);
+        w[3] = _mm256_i32gather_epi32((const int*)(src + srcstep + 3), ofs, 1);
+
+        x1 = _mm256_sub_ps(_mm256_set1_ps(1.f), x0);
+        y1 = _mm256_sub_ps(_mm256_set1_ps(1.f), y0);
+
+        for (k = 0; k < 3; k++)
+        {
+            __m128i sh = _mm_cvtsi32_si128(k * 8);
+            __m256 s[4], t0, t1;
+            int l;
+
+            for (l = 0; l < 4; l++)
+                s[l] = _mm256_cvtepi32_ps(
+                    _mm256_and_si256(_mm256_srl_epi32(w[l], sh), bmask));
+
+            t0 = _mm256_add_ps(_mm256_mul_ps(x1, s[0]),
+                               _mm256_mul_ps(x0, s[1]));
+            t1 = _mm256_add_ps(_mm256_mul_ps(x1, s[2]),
+                               _mm256_mul_ps(x0, s[3]));
+            t0 = _mm256_add_ps(_mm256_mul_ps(y1, t0), _mm256_mul_ps(y0, t1));
+            d = _mm256_or_si256(
+                d, _mm256_sll_epi32(
+                       _mm256_and_si256(_mm256_cvtps_epi32(t0), bmask), sh));
+        }
+
+        _mm256_storeu_si256((__m256i*)dbuf, d);
+        _mm256_storeu_si256((__m256i*)mbuf, m);
+        for (k = 0; k < 8; k++)
+            if (mbuf[k])
+            {
+                uchar* p = dst + (j + k) * 3;
+                p[0] = (uchar)dbuf[k];
+                p[1] = (uchar)(dbuf[k] >> 8);
+                p[2] = (uchar)(dbuf[k] >> 16);
+            }
+    }
+
+    if (j < width)
+        icvRemapRow_8u_sse2(src, srcstep, ssize, dst + j * 3, mapx + j,
+                            mapy + j, width - j, cn);
+}
+
+typedef struct CvRemapBilinearBand
+{
+    const void* src;
+    int srcstep;
+    CvSize ssize;
+    const uchar* mapx;
+    int mxstep;
+    const uchar* mapy;
+    int mystep;
+    uchar* dst;
+    int dststep;
+    int width;
+} CvRemapBilinearBand;
+
+#define ICV_DEF_REMAP_FUNC(flavor, arrtype, cn, isa, row_func)                \
+    static int CV_CDECL icvRemapBand_##flavor##_C##cn##_##isa(int y0, int y1, \
+                                                             void* arg)       \
+    {                                                                         \
+        const CvRemapBilinearBand* p = (const CvRemapBilinearBand*)arg;       \
+        int y;                                                                \
+                                                                              \
+        for (y = y0; y < y1; y++)                                             \
+            row_func((const arrtype*)p->src, p->srcstep, p->ssize,            \
+                     (arrtype*)(p->dst + y * p->dststep),                     \
+                     (const float*)(p->mapx + y * p->mxstep),                 \
+                     (const float*)(p->mapy + y * p->mystep), p->width, cn);  \
+                                                                              \
+        return CV_OK;                                                         \
+    }                                                                         \
+                                                                              \
+    static CvStatus CV_STDCALL icvRemap_##flavor##_C##cn##R_##isa(            \
+        const void* src, CvSize ssize, int srcstep, CvRect srcroi,            \
+        const float* mapx, int mxstep, const float* mapy, int mystep,         \
+        void* dst, int dststep, CvSize dsize, int interpolation)              \
+    {                                                                         \
+        CvRemapBilinearBand p;                                                \
+                                                                              \
+        if (interpolation != 1 << CV_INTER_LINEAR || srcroi.x != 0            \
+            || srcroi.y != 0 || srcroi.width != ssize.width                   \
+            || srcroi.height != ssize.height)                                 \
+            return CV_BADFLAG_ERR;                                            \
+                                                                              \
+        p.src = src;                                                          \
+        p.srcstep = srcstep / sizeof(arrtype);                                \
+        p.ssize = ssize;                                                      \
+        p.mapx = (const uchar*)mapx;                                          \
+        p.mxstep = mxstep;                                                    \
+        p.mapy = (const uchar*)mapy;                                          \
+        p.mystep = mystep;                                                    \
+        p.dst = (uchar*)dst;                                                  \
+        p.dststep = dststep;                                                  \
+        p.width = dsize.width;                                                \
+                                                                              \
+        return (CvStatus)cvParallelFor(                                       \
+            cvSlice(0, dsize.height), icvRemapBand_##flavor##_C##cn##_##isa,  \
+            &p, CV_PARALLEL_GRAIN(dsize.width));                              \
+    }
+
+ICV_DEF_REMAP_FUNC(8u, uchar, 1, sse2, icvRemapRow_8u_sse2)
+ICV_DEF_REMAP_FUNC(8u, uchar, 3, sse2, icvRemapRow_8u_sse2)
+ICV_DEF_REMAP_FUNC(8u, uchar, 4, sse2, icvRemapRow_8u_sse2)
+ICV_DEF_REMAP_FUNC(32f, float, 1, sse2, icvRemapRow_32f_sse2)
+ICV_DEF_REMAP_FUNC(32f, float, 3, sse2, icvRemapRow_32f_sse2)
+ICV_DEF_REMAP_FUNC(32f, float, 4, sse2, icvRemapRow_32f_sse2)
+ICV_DEF_REMAP_FUNC(8u, uchar, 1, avx2, icvRemapRow_8u_C1_avx2)
+ICV_DEF_REMAP_FUNC(8u, uchar, 3, avx2, icvRemapRow_8u_C3_avx2)
+ICV_DEF_REMAP_FUNC(8u, uchar, 4, avx2, icvRemapRow_8u_C4_avx2)
+ICV_DEF_REMAP_FUNC(32f, float, 1, avx2, icvRemapRow_32f_C1_avx2)
+
+/****************************************************************************************\
+*                           Bilinear remap of fixed-point maps *
+\****************************************************************************************/
+
+/* The 8u weights are the exact products (32 - fx)*(32 - fy), fx*(32 - fy),
+   ... of icvRemapTab_8u in cvimgwarp.cpp, applied as two byte-sized
+   horizontal weights and two 16-bit vertical ones; the 32f weights are
+   computed the same way as icvRemapTab_32f */
+#define ICV_REMAP_FIXED_DELTA_8U (1 << (ICV_REMAP_COEF_BITS - 1))
+
+/* Computes the source offsets, the fractions of the coordinates and the
+   inlier mask of four destination pixels */
+CV_TARGET_SSE4_1 CV_INLINE __m128i icvRemapFixedCoeffs_sse4_1(
+    const short* mapxy, const ushort* mapalpha, CvSize ssize, int srcstep,
+    int cn, __m128i& ofs, __m128i& fx, __m128i& fy)
+{
+    const __m128i smin = _mm_set1_epi32(INT_MIN);
+    __m128i xy = _mm_loadu_si128((const __m128i*)mapxy);
+    __m128i a = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)mapalpha));
+    __m128i ix = _mm_srai_epi32(_mm_slli_epi32(xy, 16), 16);
+    __m128i iy = _mm_srai_epi32(xy, 16);
+    __m128i m = _mm_and_si128(
+        _mm_cmplt_epi32(_mm_xor_si128(ix, smin),
+                        _mm_set1_epi32((ssize.width - 1) ^ INT_MIN)),
+        _mm_cmplt_epi32(_mm_xor_si128(iy, smin),
+                        _mm_set1_epi32((ssize.height - 1) ^ INT_MIN)));
+
+    fx = _mm_and_si128(a, _mm_set1_epi32(ICV_REMAP_MASK));
+    fy = _mm_srli_epi32(a, ICV_REMAP_BITS);
+    ofs = _mm_add_epi32(_mm_mullo_epi32(iy, _mm_set1_epi32(srcstep)),
+                        _mm_mullo_epi32(ix, _mm_set1_epi32(cn)));
+    ofs = _mm_and_si128(ofs, m);
+    return m;
+}
+
+#define ICV_REMAP_FIXED_LOAD_8u(s, cn)             \
+    _mm_cvtsi32_si128((cn) == 4 ? *(const int*)(s) \
+                                : (s)[0] | ((s)[1] << 8) | ((s)[2] << 16))
+
+CV_TARGET_SSE4_1 static CvStatus CV_STDCALL icvRemapFixedRow_8u_sse4_1(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const uchar* src = (const uchar*)_src;
+    const uchar* fillval = (const uchar*)_fillval;
+    uchar* dst = (uchar*)_dst;
+    const __m128i delta = _mm_set1_epi32(ICV_REMAP_FIXED_DELTA_8U);
+    int j, k, l;
+
+    for (j = 0; j < width; j += 4)
+    {
+        __m128i ofs, fx, fy, m;
+        int ibuf[4][4];
+        short xybuf[8];
+        ushort abuf[4];
+        int n = MIN(width - j, 4);
+
+        if (n < 4)
+        {
+            memcpy(xybuf, mapxy + j * 2, n * 2 * sizeof(short));
+            memcpy(abuf, mapalpha + j, n * sizeof(ushort));
+            for (k = n; k < 4; k++)
+                xybuf[k * 2] = xybuf[k * 2 + 1] = -1, abuf[k] = 0;
+            m = icvRemapFixedCoeffs_sse4_1(xybuf, abuf, ssize, srcstep, cn,
+                                           ofs, fx, fy);
+        }
+        else
+            m = icvRemapFixedCoeffs_sse4_1(mapxy + j * 2, mapalpha + j, ssize,
+                                           srcstep, cn, ofs, fx, fy);
+
+        _mm_storeu_si128((__m128i*)ibuf[0], ofs);
+        _mm_storeu_si128((__m128i*)ibuf[1], fx);
+        _mm_storeu_si128((__m128i*)ibuf[2], fy);
+        _mm_storeu_si128((__m128i*)ibuf[3], m);
+
+        for (k = 0; k < n; k++)
+        {
+            uchar* d = dst + (j + k) * cn;
+            const uchar* s = src + ibuf[0][k];
+            int x0 = ibuf[1][k], y0 = ibuf[2][k];
+            int x1 = ICV_REMAP_TAB_SIZE - x0, y1 = ICV_REMAP_TAB_SIZE - y0;
+
+            if (!ibuf[3][k])
+            {
+                if (fillval)
+                    for (l = 0; l < cn; l++)
+                        d[l] = fillval[l];
+            }
+            else if (cn == 1)
+            {
+                int t0 = s[0] * x1 + s[1] * x0;
+                int t1 = s[srcstep] * x1 + s[srcstep + 1] * x0;
+                d[0] = (uchar)CV_DESCALE(t0 * y1 + t1 * y0,
+                                         ICV_REMAP_COEF_BITS);
+            }
+            else
+            {
+                // the top and the bottom pixel pairs are interleaved and
+                // interpolated along x together, then along y
+                __m128i t = _mm_unpacklo_epi8(
+                    ICV_REMAP_FIXED_LOAD_8u(s, cn),
+                    ICV_REMAP_FIXED_LOAD_8u(s + cn, cn));
+                __m128i b = _mm_unpacklo_epi8(
+                    ICV_REMAP_FIXED_LOAD_8u(s + srcstep, cn),
+                    ICV_REMAP_FIXED_LOAD_8u(s + srcstep + cn, cn));
+                int v;
+
+                t = _mm_maddubs_epi16(_mm_unpacklo_epi64(t, b),
+                                      _mm_set1_epi16((short)(x1 | (x0 << 8))));
+                t = _mm_madd_epi16(_mm_unpacklo_epi16(t, _mm_srli_si128(t, 8)),
+                                   _mm_set1_epi32(y1 | (y0 << 16)));
+                t = _mm_srai_epi32(_mm_add_epi32(t, delta),
+                                   ICV_REMAP_COEF_BITS);
+                t = _mm_packs_epi32(t, t);
+                v = _mm_cvtsi128_si32(_mm_packus_epi16(t, t));
+                if (cn == 4)
+                    *(int*)d = v;
+                else
+                    d[0] = (uchar)v, d[1] = (uchar)(v >> 8),
+                    d[2] = (uchar)(v >> 16);
+            }
+        }
+    }
+
+    return CV_OK;
+}
+
+/* Computes the source offsets, the fractions of the coordinates and the
+   inlier mask of eight destination pixels; the outliers read the top-left
+   pixel */
+CV_TARGET_AVX2 CV_INLINE __m256i icvRemapFixedCoeffs_avx2(
+    const short* mapxy, const ushort* mapalpha, CvSize ssize, int srcstep,
+    int cn, __m256i& ofs, __m256i& fx, __m256i& fy)
+{
+    const __m256i smin = _mm256_set1_epi32(INT_MIN);
+    __m256i xy = _mm256_loadu_si256((const __m256i*)mapxy);
+    __m256i a = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128((const __m128i*)mapalpha));
+    __m256i ix = _mm256_srai_epi32(_mm256_slli_epi32(xy, 16), 16);
+    __m256i iy = _mm256_srai_epi32(xy, 16);
+    __m256i m = _mm256_and_si256(
+        _mm256_cmpgt_epi32(_mm256_set1_epi32((ssize.width - 1) ^ INT_MIN),
+                           _mm256_xor_si256(ix, smin)),
+        _mm256_cmpgt_epi32(_mm256_set1_epi32((ssize.height - 1) ^ INT_MIN),
+                           _mm256_xor_si256(iy, smin)));
+
+    fx = _mm256_and_si256(a, _mm256_set1_epi32(ICV_REMAP_MASK));
+    fy = _mm256_srli_epi32(a, ICV_REMAP_BITS);
+    ofs = _mm256_add_epi32(_mm256_mullo_epi32(iy, _mm256_set1_epi32(srcstep)),
+                           _mm256_mullo_epi32(ix, _mm256_set1_epi32(cn)));
+    ofs = _mm256_and_si256(ofs, m);
+    return m;
+}
+
+/* the byte-sized horizontal weights (32 - fx, fx) and the 16-bit vertical
+   ones (32 - fy, fy) of eight pixels, one pair of each per 32-bit lane */
+#define ICV_REMAP_FIXED_WEIGHTS_AVX2(fx, fy, wx, wy)              \
+    {                                                             \
+        const __m256i _n = _mm256_set1_epi32(ICV_REMAP_TAB_SIZE); \
+        wx = _mm256_or_si256(_mm256_sub_epi32(_n, fx),            \
+                             _mm256_slli_epi32(fx, 8));           \
+        wx = _mm256_or_si256(wx, _mm256_slli_epi32(wx, 16));      \
+        wy = _mm256_or_si256(_mm256_sub_epi32(_n, fy),            \
+                             _mm256_slli_epi32(fy, 16));          \
+    }
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvRemapFixedRow_8u_C1_avx2(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const uchar* src = (const uchar*)_src;
+    const uchar* fillval = (const uchar*)_fillval;
+    uchar* dst = (uchar*)_dst;
+    const __m256i delta = _mm256_set1_epi32(ICV_REMAP_FIXED_DELTA_8U);
+    int j = 0;
+
+    // the 4-byte gathers need at least 2x2 pixels
+    if (ssize.width >= 2 && ssize.height >= 2 && srcstep >= 2)
+    {
+        __m256i fill = _mm256_set1_epi32(fillval ? fillval[0] : 0);
+
+        for (; j <= width - 8; j += 8)
+        {
+            __m256i ofs, fx, fy, wx, wy, m, w0, w1, d;
+            __m128i r;
+
+            m = icvRemapFixedCoeffs_avx2(mapxy + j * 2, mapalpha + j, ssize,
+                                         srcstep, 1, ofs, fx, fy);
+            if (_mm256_testz_si256(m, m) && !fillval)
+                continue;
+
+            // w0 holds s[0] and s[1] in its low bytes, w1 holds s[srcstep]
+            // and s[srcstep+1] in its high bytes, so that no byte after the
+            // bottom-right tap is read
+            w0 = _mm256_i32gather_epi32((const int*)src, ofs, 1);
+            w1 = _mm256_i32gather_epi32((const int*)(src + srcstep - 2), ofs,
+                                        1);
+            ICV_REMAP_FIXED_WEIGHTS_AVX2(fx, fy, wx, wy);
+
+            d = _mm256_maddubs_epi16(_mm256_blend_epi16(w0, w1, 0xAA), wx);
+            d = _mm256_madd_epi16(d, wy);
+            d = _mm256_srai_epi32(_mm256_add_epi32(d, delta),
+                                  ICV_REMAP_COEF_BITS);
+
+            // the outliers keep the destination pixels or get the fill value
+            d = _mm256_blendv_epi8(
+                fillval ? fill
+                        : _mm256_cvtepu8_epi32(
+                              _mm_loadl_epi64((const __m128i*)(dst + j))),
+                d, m);
+            r = _mm_packs_epi32(_mm256_castsi256_si128(d),
+                                _mm256_extracti128_si256(d, 1));
+            _mm_storel_epi64((__m128i*)(dst + j), _mm_packus_epi16(r, r));
+        }
+    }
+
+    if (j < width)
+        icvRemapFixedRow_8u_sse4_1(src, srcstep, ssize, dst + j,
+                                   mapxy + j * 2, mapalpha + j, width - j, cn,
+                                   fillval);
+    return CV_OK;
+}
+
+/* Interpolates eight pixels of up to 4 channels, one pixel per 32-bit lane
+   of the four taps; the pixels 0, 1 (4, 5) and 2, 3 (6, 7) are interpolated
+   along x in the low and the high unpacked halves, then along y one pixel
+   per unpacked quarter */
+CV_TARGET_AVX2 CV_INLINE __m256i icvRemapFixedInterp_8u_avx2(
+    __m256i tl, __m256i tr, __m256i bl, __m256i br, __m256i fx, __m256i fy)
+{
+    const __m256i delta = _mm256_set1_epi32(ICV_REMAP_FIXED_DELTA_8U);
+    __m256i wx, wy, r[4], t, b, d;
+
+    ICV_REMAP_FIXED_WEIGHTS_AVX2(fx, fy, wx, wy);
+
+    r[0] = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(tl, tr),
+                                _mm256_unpacklo_epi32(wx, wx));
+    r[1] = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(tl, tr),
+                                _mm256_unpackhi_epi32(wx, wx));
+    r[2] = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(bl, br),
+                                _mm256_unpacklo_epi32(wx, wx));
+    r[3] = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(bl, br),
+                                _mm256_unpackhi_epi32(wx, wx));
+
+    t = _mm256_madd_epi16(_mm256_unpacklo_epi16(r[0], r[2]),
+                          _mm256_shuffle_epi32(wy, 0x00));
+    b = _mm256_madd_epi16(_mm256_unpackhi_epi16(r[0], r[2]),
+                          _mm256_shuffle_epi32(wy, 0x55));
+    t = _mm256_srai_epi32(_mm256_add_epi32(t, delta), ICV_REMAP_COEF_BITS);
+    b = _mm256_srai_epi32(_mm256_add_epi32(b, delta), ICV_REMAP_COEF_BITS);
+    d = _mm256_packs_epi32(t, b);
+    t = _mm256_madd_epi16(_mm256_unpacklo_epi16(r[1], r[3]),
+                          _mm256_shuffle_epi32(wy, 0xAA));
+    b = _mm256_madd_epi16(_mm256_unpackhi_epi16(r[1], r[3]),
+                          _mm256_shuffle_epi32(wy, 0xFF));
+    t = _mm256_srai_epi32(_mm256_add_epi32(t, delta), ICV_REMAP_COEF_BITS);
+    b = _mm256_srai_epi32(_mm256_add_epi32(b, delta), ICV_REMAP_COEF_BITS);
+    return _mm256_packus_epi16(d, _mm256_packs_epi32(t, b));
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvRemapFixedRow_8u_C3_avx2(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const uchar* src = (const uchar*)_src;
+    const uchar* fillval = (const uchar*)_fillval;
+    uchar* dst = (uchar*)_dst;
+    const __m256i ones = _mm256_set1_epi32(-1);
+    // 3-byte pixels to 32-bit lanes and back, within the 128-bit halves
+    const __m256i expand = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3,
+        4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i compact = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5,
+        6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    int j = 0;
+
+    // the right and the bottom-right taps are read one byte to the left and
+    // shifted, so that no byte after the bottom-right pixel is read
+    if (ssize.width >= 2 && ssize.height >= 2)
+    {
+        __m256i fill = _mm256_set1_epi32(
+            fillval ? fillval[0] | (fillval[1] << 8) | (fillval[2] << 16) : 0);
+
+        for (; j <= width - 8; j += 8)
+        {
+            __m256i ofs, fx, fy, m, d;
+            uchar* dp = dst + j * 3;
+
+            m = icvRemapFixedCoeffs_avx2(mapxy + j * 2, mapalpha + j, ssize,
+                                         srcstep, 3, ofs, fx, fy);
+            if (_mm256_testz_si256(m, m) && !fillval)
+                continue;
+
+            d = icvRemapFixedInterp_8u_avx2(
+                _mm256_i32gather_epi32((const int*)src, ofs, 1),
+                _mm256_srli_epi32(
+                    _mm256_i32gather_epi32((const int*)(src + 2), ofs, 1), 8),
+                _mm256_i32gather_epi32((const int*)(src + srcstep), ofs, 1),
+                _mm256_srli_epi32(_mm256_i32gather_epi32(
+                                      (const int*)(src + srcstep + 2), ofs, 1),
+                                  8),
+                fx, fy);
+
+            // the outliers keep the destination pixels or get the fill value
+            if (fillval)
+                d = _mm256_blendv_epi8(fill, d, m);
+            else if (!_mm256_testc_si256(m, ones))
+            {
+                __m256i t = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)dp)),
+                    _mm_loadl_epi64((const __m128i*)(dp + 16)), 1);
+                t = _mm256_permutevar8x32_epi32(
+                    t, _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 5));
+                d = _mm256_blendv_epi8(_mm256_shuffle_epi8(t, expand), d, m);
+            }
+
+            d = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(d, compact),
+                _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+            _mm_storeu_si128((__m128i*)dp, _mm256_castsi256_si128(d));
+            _mm_storel_epi64((__m128i*)(dp + 16),
+                             _mm256_extracti128_si256(d, 1));
+        }
+    }
+
+    if (j < width)
+        icvRemapFixedRow_8u_sse4_1(src, srcstep, ssize, dst + j * 3,
+                                   mapxy + j * 2, mapalpha + j, width - j, cn,
+                                   fillval);
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvRemapFixedRow_8u_C4_avx2(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const uchar* src = (const uchar*)_src;
+    const uchar* fillval = (const uchar*)_fillval;
+    uchar* dst = (uchar*)_dst;
+    __m256i fill = _mm256_set1_epi32(fillval ? *(const int*)fillval : 0);
+    int j = 0;
+
+    // the outliers read the top-left pixel and its neighbors
+    if (ssize.width >= 2 && ssize.height >= 2)
+    {
+        for (; j <= width - 8; j += 8)
+        {
+            __m256i ofs, fx, fy, m, d;
+
+            m = icvRemapFixedCoeffs_avx2(mapxy + j * 2, mapalpha + j, ssize,
+                                         srcstep, 4, ofs, fx, fy);
+            if (_mm256_testz_si256(m, m) && !fillval)
+                continue;
+
+            d = icvRemapFixedInterp_8u_avx2(
+                _mm256_i32gather_epi32((const int*)src, ofs, 1),
+                _mm256_i32gather_epi32((const int*)(src + 4), ofs, 1),
+                _mm256_i32gather_epi32((const int*)(src + srcstep), ofs, 1),
+                _mm256_i32gather_epi32((const int*)(src + srcstep + 4), ofs,
+                                       1),
+                fx, fy);
+
+            // the outliers keep the destination pixels or get the fill value
+            d = _mm256_blendv_epi8(
+                fillval ? fill
+                        : _mm256_loadu_si256((const __m256i*)(dst + j * 4)),
+                d, m);
+            _mm256_storeu_si256((__m256i*)(dst + j * 4), d);
+        }
+    }
+
+    if (j < width)
+        icvRemapFixedRow_8u_sse4_1(src, srcstep, ssize, dst + j * 4,
+                                   mapxy + j * 2, mapalpha + j, width - j, cn,
+                                   fillval);
+    return CV_OK;
+}
+
+/* the 32f weights of four pixels, the same arithmetic as icvRemapTab_32f */
+#define ICV_REMAP_FIXED_WEIGHTS_32F(fx, fy, w)                           \
+    {                                                                    \
+        const __m128 _one = _mm_set1_ps(1.f);                            \
+        const __m128 _scale = _mm_set1_ps(1.f / ICV_REMAP_TAB_SIZE);     \
+        __m128 _x0 = _mm_mul_ps(_mm_cvtepi32_ps(fx), _scale);            \
+        __m128 _y0 = _mm_mul_ps(_mm_cvtepi32_ps(fy), _scale);            \
+        w[0] = _mm_mul_ps(_mm_sub_ps(_one, _x0), _mm_sub_ps(_one, _y0)); \
+        w[1] = _mm_mul_ps(_x0, _mm_sub_ps(_one, _y0));                   \
+        w[2] = _mm_mul_ps(_mm_sub_ps(_one, _x0), _y0);                   \
+        w[3] = _mm_mul_ps(_x0, _y0);                                     \
+    }
+
+CV_TARGET_SSE4_1 static CvStatus CV_STDCALL icvRemapFixedRow_32f_sse4_1(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const float* src = (const float*)_src;
+    const float* fillval = (const float*)_fillval;
+    float* dst = (float*)_dst;
+    int j, k, l;
+
+    srcstep /= sizeof(src[0]);
+
+    for (j = 0; j < width; j += 4)
+    {
+        __m128i ofs, fx, fy, m;
+        __m128 w[4];
+        int ibuf[2][4];
+        float fbuf[4][4];
+        short xybuf[8];
+        ushort abuf[4];
+        int n = MIN(width - j, 4);
+
+        if (n < 4)
+        {
+            memcpy(xybuf, mapxy + j * 2, n * 2 * sizeof(short));
+            memcpy(abuf, mapalpha + j, n * sizeof(ushort));
+            for (k = n; k < 4; k++)
+                xybuf[k * 2] = xybuf[k * 2 + 1] = -1, abuf[k] = 0;
+            m = icvRemapFixedCoeffs_sse4_1(xybuf, abuf, ssize, srcstep, cn,
+                                           ofs, fx, fy);
+        }
+        else
+            m = icvRemapFixedCoeffs_sse4_1(mapxy + j * 2, mapalpha + j, ssize,
+                                           srcstep, cn, ofs, fx, fy);
+
+        ICV_REMAP_FIXED_WEIGHTS_32F(fx, fy, w);
+        _mm_storeu_si128((__m128i*)ibuf[0], ofs);
+        _mm_storeu_si128((__m128i*)ibuf[1], m);
+        for (l = 0; l < 4; l++)
+            _mm_storeu_ps(fbuf[l], w[l]);
+
+        for (k = 0; k < n; k++)
+        {
+            float* d = dst + (j + k) * cn;
+            const float* s = src + ibuf[0][k];
+
+            if (!ibuf[1][k])
+            {
+                if (fillval)
+                    for (l = 0; l < cn; l++)
+                        d[l] = fillval[l];
+            }
+            else if (cn == 1)
+                d[0] = s[0] * fbuf[0][k] + s[1] * fbuf[1][k]
+                       + s[srcstep] * fbuf[2][k]
+                       + s[srcstep + 1] * fbuf[3][k];
+            else
+            {
+                __m128 t = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(ICV_REMAP_LOAD_32f(s, cn, 0),
+                                              _mm_set1_ps(fbuf[0][k])),
+                                   _mm_mul_ps(ICV_REMAP_LOAD_32f(s + cn, cn, 0),
+                                              _mm_set1_ps(fbuf[1][k]))),
+                        _mm_mul_ps(ICV_REMAP_LOAD_32f(s + srcstep, cn, 0),
+                                   _mm_set1_ps(fbuf[2][k]))),
+                    _mm_mul_ps(ICV_REMAP_LOAD_32f(s + srcstep + cn, cn, 0),
+                               _mm_set1_ps(fbuf[3][k])));
+                ICV_REMAP_STORE_32f(d, t, cn);
+            }
+        }
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvRemapFixedRow_32f_C1_avx2(
+    const void* _src, int srcstep, CvSize ssize, void* _dst,
+    const short* mapxy, const ushort* mapalpha, int width, int cn,
+    const void* _fillval)
+{
+    const float* src = (const float*)_src;
+    const float* fillval = (const float*)_fillval;
+    float* dst = (float*)_dst;
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 scale = _mm256_set1_ps(1.f / ICV_REMAP_TAB_SIZE);
+    __m256 fill = _mm256_set1_ps(fillval ? fillval[0] : 0.f);
+    int j = 0, step = srcstep / sizeof(src[0]);
+
+    for (; j <= width - 8; j += 8)
+    {
+        __m256i ofs, fx, fy, m;
+        __m256 x0, y0, x1, y1, d;
+
+        m = icvRemapFixedCoeffs_avx2(mapxy + j * 2, mapalpha + j, ssize, step,
+                                     1, ofs, fx, fy);
+        if (_mm256_testz_si256(m, m) && !fillval)
+            continue;
+
+        x0 = _mm256_mul_ps(_mm256_cvtepi32_ps(fx), scale);
+        y0 = _mm256_mul_ps(_mm256_cvtepi32_ps(fy), scale);
+        x1 = _mm256_sub_ps(one, x0);
+        y1 = _mm256_sub_ps(one, y0);
+
+        d = _mm256_add_ps(
+            _mm256_add_ps(
+                _mm256_add_ps(
+                    _mm256_mul_ps(_mm256_i32gather_ps(src, ofs, 4),
+                                  _mm256_mul_ps(x1, y1)),
+                    _mm256_mul_ps(_mm256_i32gather_ps(src + 1, ofs, 4),
+                                  _mm256_mul_ps(x0, y1))),
+                _mm256_mul_ps(_mm256_i32gather_ps(src + step, ofs, 4),
+                              _mm256_mul_ps(x1, y0))),
+            _mm256_mul_ps(_mm256_i32gather_ps(src + step + 1, ofs, 4),
+                          _mm256_mul_ps(x0, y0)));
+
+        // the outliers keep the destination pixels or get the fill value
+        if (fillval)
+            _mm256_storeu_ps(dst + j, _mm256_blendv_ps(
+                                          fill, d, _mm256_castsi256_ps(m)));
+        else
+            _mm256_maskstore_ps(dst + j, m, d);
+    }
+
+    if (j < width)
+        icvRemapFixedRow_32f_sse4_1(src, srcstep, ssize, dst + j,
+                                    mapxy + j * 2, mapalpha + j, width - j, cn,
+                                    fillval);
+    return CV_OK;
+}
+
+#define ICV_DEF_REMAP_FIXED_FUNC(flavor, cn, isa, row_func)               \
+    static CvStatus CV_STDCALL icvRemapFixed_##flavor##_C##cn##R_##isa(   \
+        const void* src, int srcstep, CvSize ssize, void* dst,            \
+        const short* mapxy, const ushort* mapalpha, int width, int,       \
+        const void* fillval)                                              \
+    {                                                                     \
+        return row_func(src, srcstep, ssize, dst, mapxy, mapalpha, width, \
+                        cn, fillval);                                     \
+    }
+
+ICV_DEF_REMAP_FIXED_FUNC(8u, 1, sse4_1, icvRemapFixedRow_8u_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(8u, 3, sse4_1, icvRemapFixedRow_8u_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(8u, 4, sse4_1, icvRemapFixedRow_8u_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(32f, 1, sse4_1, icvRemapFixedRow_32f_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(32f, 3, sse4_1, icvRemapFixedRow_32f_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(32f, 4, sse4_1, icvRemapFixedRow_32f_sse4_1)
+ICV_DEF_REMAP_FIXED_FUNC(8u, 1, avx2, icvRemapFixedRow_8u_C1_avx2)
+ICV_DEF_REMAP_FIXED_FUNC(8u, 3, avx2, icvRemapFixedRow_8u_C3_avx2)
+ICV_DEF_REMAP_FIXED_FUNC(8u, 4, avx2, icvRemapFixedRow_8u_C4_avx2)
+ICV_DEF_REMAP_FIXED_FUNC(32f, 1, avx2, icvRemapFixedRow_32f_C1_avx2)
+
+#undef ICV_REMAP_FIXED_DELTA_8U
+#undef ICV_REMAP_FIXED_LOAD_8u
+#undef ICV_REMAP_FIXED_WEIGHTS_AVX2
+#undef ICV_REMAP_FIXED_WEIGHTS_32F
+#undef ICV_DEF_REMAP_FIXED_FUNC
+
+#undef ICV_REMAP_LOAD_8u
+#undef ICV_REMAP_LOAD_32f
+#undef ICV_REMAP_STORE_8u
+#undef ICV_REMAP_STORE_32f
+#undef ICV_REMAP_CAST_8u
+#undef ICV_REMAP_CAST_32f
+#undef ICV_REMAP_LOAD2_8u
+#undef ICV_REMAP_LOAD2_32f
+#undef ICV_REMAP_STORE4_8u
+#undef ICV_REMAP_STORE4_32f
+#undef ICV_DEF_REMAP_SSE2
+#undef ICV_DEF_REMAP_FUNC
+
+/****************************************************************************************\
+*                                      Box filter *
+\****************************************************************************************/
+
+#define ICV_BOX_SHIFT 24
+
+/* The filters first add up the kernel rows of every column and then sum
+   the column sums along the rows. The 8u sums are exact, so the result is
+   the same as that of icvSumRow_8u32s and icvSumCol_32s8u; the 32f sums
+   are done in double precision as in icvSumRow_32f64f. */
+typedef void (*CvBoxCol8uFunc)(int* sum, const uchar* sp, const uchar* sm,
+                               int width);
+typedef void (*CvBoxRow8uFunc)(const int* sum, uchar* dst, int width,
+                               int ksize, int cn, int iscale);
+typedef void (*CvBoxCol32fFunc)(double* sum, const float* sp,
+                                const float* sm, int width);
+typedef void (*CvBoxRow32fFunc)(const double* sum, float* dst, int width,
+                                int ksize, int cn, double scale);
+
+/* kernels wider than this are summed along the rows with a running sum */
+#define ICV_BOX_MAX_DIRECT_8U 16
+#define ICV_BOX_MAX_DIRECT_32F 8
+/* with two doubles per register the direct sum loses to the running one
+   from about 5 taps */
+#define ICV_BOX_MAX_DIRECT_32F_SSE2 4
+
+#define ICV_BOX_DESCALE_8U(s0, iscale) \
+    ((uchar)CV_DESCALE((unsigned)(s0) * (unsigned)(iscale), ICV_BOX_SHIFT))
+
+static void icvBoxRunningRow_8u(const int* sum, uchar* dst, int width,
+                                int ksize, int cn, int iscale)
+{
+    int i, k;
+
+    ksize *= cn;
+    for (k = 0; k < cn; k++, sum++, dst++)
+    {
+        int s = 0;
+        for (i = 0; i < ksize; i += cn)
+            s += sum[i];
+        dst[0] = ICV_BOX_DESCALE_8U(s, iscale);
+        for (i = cn; i < width; i += cn)
+        {
+            s += sum[i + ksize - cn] - sum[i - cn];
+            dst[i] = ICV_BOX_DESCALE_8U(s, iscale);
+        }
+    }
+}
+
+static void icvBoxRunningRow_32f(const double* sum, float* dst, int width,
+                                 int ksize, int cn, double scale)
+{
+    int i, k;
+
+    ksize *= cn;
+    for (k = 0; k < cn; k++, sum++, dst++)
+    {
+        double s = 0;
+        for (i = 0; i < ksize; i += cn)
+            s += sum[i];
+        dst[0] = (float)(s * scale);
+        for (i = cn; i < width; i += cn)
+        {
+            s += sum[i + ksize - cn] - sum[i - cn];
+            dst[i] = (float)(s * scale);
+        }
+    }
+}
+
+CV_TARGET_SSE4_1 static void icvBoxCol_8u_sse4_1(int* sum, const uchar* sp,
+                                                 const uchar* sm, int width)
+{
+    int i = 0;
+
+    for (; i <= width - 4; i += 4)
+    {
+        __m128i t = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int*)(sp + i)));
+        if (sm)
+            t = _mm_sub_epi32(t, _mm_cvtepu8_epi32(
+                                     _mm_cvtsi32_si128(*(const int*)(sm + i))));
+        t = _mm_add_epi32(t, _mm_loadu_si128((const __m128i*)(sum + i)));
+        _mm_storeu_si128((__m128i*)(sum + i), t);
+    }
+
+    for (; i < width; i++)
+        sum[i] += sp[i] - (sm ? sm[i] : 0);
+}
+
+CV_TARGET_SSE4_1 static void icvBoxRow_8u_sse4_1(const int* sum, uchar* dst,
+                                                 int width, int ksize, int cn,
+                                                 int iscale)
+{
+    const __m128i s = _mm_set1_epi32(iscale);
+    const __m128i delta = _mm_set1_epi32(1 << (ICV_BOX_SHIFT - 1));
+    int i = 0, k;
+
+    if (ksize > ICV_BOX_MAX_DIRECT_8U)
+    {
+        icvBoxRunningRow_8u(sum, dst, width, ksize, cn, iscale);
+        return;
+    }
+
+    for (; i <= width - 8; i += 8)
+    {
+        __m128i t0 = _mm_loadu_si128((const __m128i*)(sum + i));
+        __m128i t1 = _mm_loadu_si128((const __m128i*)(sum + i + 4));
+
+        for (k = 1; k < ksize; k++)
+        {
+            const int* p = sum + i + k * cn;
+            t0 = _mm_add_epi32(t0, _mm_loadu_si128((const __m128i*)p));
+            t1 = _mm_add_epi32(t1, _mm_loadu_si128((const __m128i*)(p + 4)));
+        }
+
+        t0 = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(t0, s), delta),
+                            ICV_BOX_SHIFT);
+        t1 = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(t1, s), delta),
+                            ICV_BOX_SHIFT);
+        t0 = _mm_packs_epi32(t0, t1);
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(t0, t0));
+    }
+
+    for (; i < width; i++)
+    {
+        int t = sum[i];
+        for (k = 1; k < ksize; k++)
+            t += sum[i + k * cn];
+        dst[i] = ICV_BOX_DESCALE_8U(t, iscale);
+    }
+}
+
+CV_TARGET_AVX2 static void icvBoxCol_8u_avx2(int* sum, const uchar* sp,
+                                             const uchar* sm, int width)
+{
+    int i = 0;
+
+    for (; i <= width - 8; i += 8)
+    {
+        __m256i t =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(sp + i)));
+        if (sm)
+            t = _mm256_sub_epi32(t, _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                                        (const __m128i*)(sm + i))));
+        t = _mm256_add_epi32(t, _mm256_loadu_si256((const __m256i*)(sum + i)));
+        _mm256_storeu_si256((__m256i*)(sum + i), t);
+    }
+
+    for (; i < width; i++)
+        sum[i] += sp[i] - (sm ? sm[i] : 0);
+}
+
+CV_TARGET_AVX2 static void icvBoxRow_8u_avx2(const int* sum, uchar* dst,
+                                             int width, int ksize, int cn,
+                                             int iscale)
+{
+    const __m256i s = _mm256_set1_epi32(iscale);
+    const __m256i delta = _mm256_set1_epi32(1 << (ICV_BOX_SHIFT - 1));
+    int i = 0, k;
+
+    if (ksize > ICV_BOX_MAX_DIRECT_8U)
+    {
+        icvBoxRunningRow_8u(sum, dst, width, ksize, cn, iscale);
+        return;
+    }
+
+    for (; i <= width - 16; i += 16)
+    {
+        __m256i t0 = _mm256_loadu_si256((const __m256i*)(sum + i));
+        __m256i t1 = _mm256_loadu_si256((const __m256i*)(sum + i + 8));
+        __m128i r;
+
+        for (k = 1; k < ksize; k++)
+        {
+            const int* p = sum + i + k * cn;
+            t0 = _mm256_add_epi32(t0, _mm256_loadu_si256((const __m256i*)p));
+            t1 = _mm256_add_epi32(t1,
+                                  _mm256_loadu_si256((const __m256i*)(p + 8)));
+        }
+
+        t0 = _mm256_srli_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(t0, s), delta), ICV_BOX_SHIFT);
+        t1 = _mm256_srli_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(t1, s), delta), ICV_BOX_SHIFT);
+        t0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(t0, t1), 0xd8);
+        r = _mm_packus_epi16(_mm256_castsi256_si128(t0),
+                             _mm256_extracti128_si256(t0, 1));
+        _mm_storeu_si128((__m128i*)(dst + i), r);
+    }
+
+    for (; i < width; i++)
+    {
+        int t = sum[i];
+        for (k = 1; k < ksize; k++)
+            t += sum[i + k * cn];
+        dst[i] = ICV_BOX_DESCALE_8U(t, iscale);
+    }
+}
+
+CV_TARGET_SSE2 static void icvBoxCol_32f_sse2(double* sum, const float* sp,
+                                              const float* sm, int width)
+{
+    int i = 0;
+
+    for (; i <= width - 4; i += 4)
+    {
+        __m128 p = _mm_loadu_ps(sp + i);
+        __m128d t0 = _mm_cvtps_pd(p), t1 = _mm_cvtps_pd(_mm_movehl_ps(p, p));
+        if (sm)
+        {
+            __m128 m = _mm_loadu_ps(sm + i);
+            t0 = _mm_sub_pd(t0, _mm_cvtps_pd(m));
+            t1 = _mm_sub_pd(t1, _mm_cvtps_pd(_mm_movehl_ps(m, m)));
+        }
+        _mm_storeu_pd(sum + i, _mm_add_pd(_mm_loadu_pd(sum + i), t0));
+        _mm_storeu_pd(sum + i + 2, _mm_add_pd(_mm_loadu_pd(sum + i + 2), t1));
+    }
+
+    for (; i < width; i++)
+        sum[i] += (double)sp[i] - (sm ? sm[i] : 0);
+}
+
+CV_TARGET_SSE2 static void icvBoxRow_32f_sse2(const double* sum, float* dst,
+                                              int width, int ksize, int cn,
+                                              double scale)
+{
+    const __m128d s = _mm_set1_pd(scale);
+    int i = 0, k;
+
+    if (ksize > ICV_BOX_MAX_DIRECT_32F_SSE2)
+    {
+        icvBoxRunningRow_32f(sum, dst, width, ksize, cn, scale);
+        return;
+    }
+
+    for (; i <= width - 4; i += 4)
+    {
+        __m128d t0 = _mm_loadu_pd(sum + i), t1 = _mm_loadu_pd(sum + i + 2);
+
+        for (k = 1; k < ksize; k++)
+        {
+            const double* p = sum + i + k * cn;
+            t0 = _mm_add_pd(t0, _mm_loadu_pd(p));
+            t1 = _mm_add_pd(t1, _mm_loadu_pd(p + 2));
+        }
+
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(t0, s)),
+                                             _mm_cvtpd_ps(_mm_mul_pd(t1, s))));
+    }
+
+    for (; i < width; i++)
+    {
+        double t = sum[i];
+        for (k = 1; k < ksize; k++)
+            t += sum[i + k * cn];
+        dst[i] = (float)(t * scale);
+    }
+}
+
+CV_TARGET_AVX2 static void icvBoxCol_32f_avx2(double* sum, const float* sp,
+                                              const float* sm, int width)
+{
+    int i = 0;
+
+    for (; i <= width - 8; i += 8)
+    {
+        __m256 p = _mm256_loadu_ps(sp + i);
+        __m256d t0 = _mm256_cvtps_pd(_mm256_castps256_ps128(p));
+        __m256d t1 = _mm256_cvtps_pd(_mm256_extractf128_ps(p, 1));
+        if (sm)
+        {
+            __m256 m = _mm256_loadu_ps(sm + i);
+            t0 = _mm256_sub_pd(t0,
+                               _mm256_cvtps_pd(_mm256_castps256_ps128(m)));
+            t1 = _mm256_sub_pd(t1,
+                               _mm256_cvtps_pd(_mm256_extractf128_ps(m, 1)));
+        }
+        _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(sum + i), t0));
+        _mm256_storeu_pd(sum + i + 4,
+                         _mm256_add_pd(_mm256_loadu_pd(sum + i + 4), t1));
+    }
+
+    for (; i < width; i++)
+        sum[i] += (double)sp[i] - (sm ? sm[i] : 0);
+}
+
+CV_TARGET_AVX2 static void icvBoxRow_32f_avx2(const double* sum, float* dst,
+                                              int width, int ksize, int cn,
+                                              double scale)
+{
+    const __m256d s = _mm256_set1_pd(scale);
+    int i = 0, k;
+
+    if (ksize > ICV_BOX_MAX_DIRECT_32F)
+    {
+        icvBoxRunningRow_32f(sum, dst, width, ksize, cn, scale);
+        return;
+    }
+
+    for (; i <= width - 8; i += 8)
+    {
+        __m256d t0 = _mm256_loadu_pd(sum + i);
+        __m256d t1 = _mm256_loadu_pd(sum + i + 4);
+
+        for (k = 1; k < ksize; k++)
+        {
+            const double* p = sum + i + k * cn;
+            t0 = _mm256_add_pd(t0, _mm256_loadu_pd(p));
+            t1 = _mm256_add_pd(t1, _mm256_loadu_pd(p + 4));
+        }
+
+        _mm256_storeu_ps(
+            dst + i, _mm256_set_m128(_mm256_cvtpd_ps(_mm256_mul_pd(t1, s)),
+                                     _mm256_cvtpd_ps(_mm256_mul_pd(t0, s))));
+    }
+
+    for (; i < width; i++)
+    {
+        double t = sum[i];
+        for (k = 1; k < ksize; k++)
+            t += sum[i + k * cn];
+        dst[i] = (float)(t * scale);
+    }
+}
+
+/* src points to the pixel that corresponds to the top-left destination
+   pixel, the border pixels around the roi must be readable (see
+   icvIPPFilterNextStripe()) */
+#define ICV_DEF_BOX_FUNC(flavor, srctype, sumtype, scaletype, scale_init) \
+    static CvStatus icvBox_##flavor##_CnR(                                \
+        const srctype* src, int srcstep, srctype* dst, int dststep,       \
+        CvSize roi, CvSize ksize, CvPoint anchor, int cn,                 \
+        CvBoxCol##flavor##Func col_func, CvBoxRow##flavor##Func row_func) \
+    {                                                                     \
+        int width = roi.width * cn, y;                                    \
+        int sum_width = (roi.width + ksize.width - 1) * cn;               \
+        scaletype scale = scale_init;                                     \
+        sumtype* sum;                                                     \
+                                                                          \
+        srcstep /= sizeof(src[0]);                                        \
+        dststep /= sizeof(dst[0]);                                        \
+        src -= anchor.y * srcstep + anchor.x * cn;                        \
+                                                                          \
+        sum = (sumtype*)cvAlloc(sum_width * sizeof(sum[0]));              \
+        if (!sum)                                                         \
+            return CV_OUTOFMEM_ERR;                                       \
+                                                                          \
+        memset(sum, 0, sum_width * sizeof(sum[0]));                       \
+        for (y = 0; y < ksize.height - 1; y++)                            \
+            col_func(sum, src + y * srcstep, 0, sum_width);               \
+                                                                          \
+        for (y = 0; y < roi.height; y++, src += srcstep, dst += dststep)  \
+        {                                                                 \
+            col_func(sum, src + (ksize.height - 1) * srcstep,             \
+                     y > 0 ? src - srcstep : 0, sum_width);               \
+            row_func(sum, dst, width, ksize.width, cn, scale);            \
+        }                                                                 \
+                                                                          \
+        cvFree(&sum);                                                     \
+        return CV_OK;                                                     \
+    }
+
+ICV_DEF_BOX_FUNC(8u, uchar, int, int,
+                 cvFloor(1. / (ksize.width * ksize.height)
+                         * (1 << ICV_BOX_SHIFT)))
+ICV_DEF_BOX_FUNC(32f, float, double, double,
+                 1. / (ksize.width * ksize.height))
+
+#define ICV_DEF_BOX(flavor, srctype, cn, isa)                                 \
+    static CvStatus CV_STDCALL icvFilterBox_##flavor##_C##cn##R_##isa(        \
+        const void* src, int srcstep, void* dst, int dststep, CvSize roi,     \
+        CvSize ksize, CvPoint anchor)                                         \
+    {                                                                         \
+        return icvBox_##flavor##_CnR(                                         \
+            (const srctype*)src, srcstep, (srctype*)dst, dststep, roi, ksize, \
+            anchor, cn, icvBoxCol_##flavor##_##isa,                           \
+            icvBoxRow_##flavor##_##isa);                                      \
+    }
+
+ICV_DEF_BOX(8u, uchar, 1, sse4_1)
+ICV_DEF_BOX(8u, uchar, 3, sse4_1)
+ICV_DEF_BOX(8u, uchar, 4, sse4_1)
+ICV_DEF_BOX(8u, uchar, 1, avx2)
+ICV_DEF_BOX(8u, uchar, 3, avx2)
+ICV_DEF_BOX(8u, uchar, 4, avx2)
+ICV_DEF_BOX(32f, float, 1, sse2)
+ICV_DEF_BOX(32f, float, 3, sse2)
+ICV_DEF_BOX(32f, float, 4, sse2)
+ICV_DEF_BOX(32f, float, 1, avx2)
+ICV_DEF_BOX(32f, float, 3, avx2)
+ICV_DEF_BOX(32f, float, 4, avx2)
+
+#undef ICV_DEF_BOX_FUNC
+#undef ICV_DEF_BOX
+
+/****************************************************************************************\
+*                                 Separable linear filter *
+\****************************************************************************************/
+
+/* dst[x] = sum_i kernel[i]*src[x + (anchor - i)*delta], where delta is the
+   distance between the neighbor pixels: the number of channels for the
+   horizontal pass and the row step for the vertical one. There are no 8u
+   versions: the IPP interface rounds the vertical pass to 8u, which makes
+   the result differ from CvSepFilter by 1, so the 8u images are filtered by
+   CvSepFilter with the fixed-point kernels below. */
+#define ICV_SEPFILTER_TAP(x, i) (src + (x) + (anchor - (i)) * delta)
+
+CV_TARGET_SSE2 static void icvSepFilterLine_32f_sse2(const float* src,
+                                                     int delta, float* dst,
+                                                     int width,
+                                                     const float* kernel,
+                                                     int ksize, int anchor)
+{
+    int x = 0, i;
+
+    for (; x <= width - 8; x += 8)
+    {
+        __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+
+        for (i = 0; i < ksize; i++)
+        {
+            const float* p = ICV_SEPFILTER_TAP(x, i);
+            __m128 k = _mm_set1_ps(kernel[i]);
+            s0 = _mm_add_ps(s0, _mm_mul_ps(k, _mm_loadu_ps(p)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(k, _mm_loadu_ps(p + 4)));
+        }
+
+        _mm_storeu_ps(dst + x, s0);
+        _mm_storeu_ps(dst + x + 4, s1);
+    }
+
+    for (; x < width; x++)
+    {
+        float s = 0;
+        for (i = 0; i < ksize; i++)
+            s += kernel[i] * ICV_SEPFILTER_TAP(x, i)[0];
+        dst[x] = s;
+    }
+}
+
+CV_TARGET_AVX2 static void icvSepFilterLine_32f_avx2(const float* src,
+                                                     int delta, float* dst,
+                                                     int width,
+                                                     const float* kernel,
+                                                     int ksize, int anchor)
+{
+    int x = 0, i;
+
+    for (; x <= width - 16; x += 16)
+    {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+
+        for (i = 0; i < ksize; i++)
+        {
+            const float* p = ICV_SEPFILTER_TAP(x, i);
+            __m256 k = _mm256_set1_ps(kernel[i]);
+            s0 = _mm256_add_ps(s0, _mm256_mul_ps(k, _mm256_loadu_ps(p)));
+            s1 = _mm256_add_ps(s1, _mm256_mul_ps(k, _mm256_loadu_ps(p + 8)));
+        }
+
+        _mm256_storeu_ps(dst + x, s0);
+        _mm256_storeu_ps(dst + x + 8, s1);
+    }
+
+    if (x < width)
+        icvSepFilterLine_32f_sse2(src + x, delta, dst + x, width - x, kernel,
+                                  ksize, anchor);
+}
+
+#undef ICV_SEPFILTER_TAP
+
+#define ICV_DEF_SEPFILTER(flavor, arrtype, cn, isa)                           \
+    static CvStatus CV_STDCALL icvFilterRow_##flavor##_C##cn##R_##isa(        \
+        const void* _src, int srcstep, void* _dst, int dststep, CvSize size,  \
+        const float* kernel, int ksize, int anchor)                           \
+    {                                                                         \
+        const arrtype* src = (const arrtype*)_src;                            \
+        arrtype* dst = (arrtype*)_dst;                                        \
+        srcstep /= sizeof(src[0]);                                            \
+        dststep /= sizeof(dst[0]);                                            \
+                                                                              \
+        for (; size.height--; src += srcstep, dst += dststep)                 \
+            icvSepFilterLine_##flavor##_##isa(src, cn, dst, size.width * cn,  \
+                                              kernel, ksize, anchor);         \
+        return CV_OK;                                                         \
+    }                                                                         \
+                                                                              \
+    static CvStatus CV_STDCALL icvFilterColumn_##flavor##_C##cn##R_##isa(     \
+        const void* _src, int srcstep, void* _dst, int dststep, CvSize size,  \
+        const float* kernel, int ksize, int anchor)                           \
+    {                                                                         \
+        const arrtype* src = (const arrtype*)_src;                            \
+        arrtype* dst = (arrtype*)_dst;                                        \
+        srcstep /= sizeof(src[0]);                                            \
+        dststep /= sizeof(dst[0]);                                            \
+                                                                              \
+        for (; size.height--; src += srcstep, dst += dststep)                 \
+            icvSepFilterLine_##flavor##_##isa(src, srcstep, dst,              \
+                                              size.width * cn, kernel, ksize, \
+                                              anchor);                        \
+        return CV_OK;                                                         \
+    }
+
+ICV_DEF_SEPFILTER(32f, float, 1, sse2)
+ICV_DEF_SEPFILTER(32f, float, 3, sse2)
+ICV_DEF_SEPFILTER(32f, float, 4, sse2)
+ICV_DEF_SEPFILTER(32f, float, 1, avx2)
+ICV_DEF_SEPFILTER(32f, float, 3, avx2)
+ICV_DEF_SEPFILTER(32f, float, 4, avx2)
+
+#undef ICV_DEF_SEPFILTER
+
+/* The fixed-point passes of CvSepFilter for the symmetrical kernels, the
+   same integer arithmetic as icvFilterRowSymm_8u32s and
+   icvFilterColSymm_32s8u in cvfilter.cpp. The row sums of the source pixels
+   fit 16 bits, so the row pass multiplies them with pmaddwd. */
+#define ICV_SEPFILTER_FIXED_SHIFT 16
+
+#define ICV_LOAD_8U32S(p) \
+    _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(p)))
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvFilterRowSymm_8u32s_C1R_avx2(
+    const uchar* src, int* dst, int width, int cn, const int* kx, int ksize2)
+{
+    int i = 0, j, k;
+
+    for (; i <= width - 16; i += 16)
+    {
+        const uchar* s = src + i;
+        __m256i f = _mm256_set1_epi32(kx[0]);
+        __m256i s0 = _mm256_madd_epi16(ICV_LOAD_8U32S(s), f);
+        __m256i s1 = _mm256_madd_epi16(ICV_LOAD_8U32S(s + 8), f);
+
+        for (k = 1, j = cn; k <= ksize2; k++, j += cn)
+        {
+            __m256i a0 = _mm256_add_epi32(ICV_LOAD_8U32S(s + j),
+                                          ICV_LOAD_8U32S(s - j));
+            __m256i a1 = _mm256_add_epi32(ICV_LOAD_8U32S(s + j + 8),
+                                          ICV_LOAD_8U32S(s - j + 8));
+            f = _mm256_set1_epi32(kx[k]);
+            s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(a0, f));
+            s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(a1, f));
+        }
+
+        _mm256_storeu_si256((__m256i*)(dst + i), s0);
+        _mm256_storeu_si256((__m256i*)(dst + i + 8), s1);
+    }
+
+    for (; i < width; i++)
+    {
+        const uchar* s = src + i;
+        int s0 = kx[0] * s[0];
+        for (k = 1, j = cn; k <= ksize2; k++, j += cn)
+            s0 += kx[k] * (s[j] + s[-j]);
+        dst[i] = s0;
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvFilterColSymm_32s8u_C1R_avx2(
+    const int** src, uchar* dst, int dststep, int count, int width,
+    const int* ky, int ksize2)
+{
+    const __m256i delta =
+        _mm256_set1_epi32(1 << (ICV_SEPFILTER_FIXED_SHIFT - 1));
+
+    for (; count--; dst += dststep, src++)
+    {
+        int i = 0, k;
+
+        for (; i <= width - 16; i += 16)
+        {
+            __m256i f = _mm256_set1_epi32(ky[0]);
+            __m256i s0 = _mm256_mullo_epi32(
+                _mm256_loadu_si256((const __m256i*)(src[0] + i)), f);
+            __m256i s1 = _mm256_mullo_epi32(
+                _mm256_loadu_si256((const __m256i*)(src[0] + i + 8)), f);
+
+            for (k = 1; k <= ksize2; k++)
+            {
+                const int *p = src[k] + i, *q = src[-k] + i;
+                __m256i a0 = _mm256_add_epi32(
+                    _mm256_loadu_si256((const __m256i*)p),
+                    _mm256_loadu_si256((const __m256i*)q));
+                __m256i a1 = _mm256_add_epi32(
+                    _mm256_loadu_si256((const __m256i*)(p + 8)),
+                    _mm256_loadu_si256((const __m256i*)(q + 8)));
+                f = _mm256_set1_epi32(ky[k]);
+                s0 = _mm256_add_epi32(s0, _mm256_mullo_epi32(a0, f));
+                s1 = _mm256_add_epi32(s1, _mm256_mullo_epi32(a1, f));
+            }
+
+            s0 = _mm256_srai_epi32(_mm256_add_epi32(s0, delta),
+                                   ICV_SEPFILTER_FIXED_SHIFT);
+            s1 = _mm256_srai_epi32(_mm256_add_epi32(s1, delta),
+                                   ICV_SEPFILTER_FIXED_SHIFT);
+            s0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), 0xd8);
+            _mm_storeu_si128((__m128i*)(dst + i),
+                             _mm_packus_epi16(_mm256_castsi256_si128(s0),
+                                              _mm256_extracti128_si256(s0, 1)));
+        }
+
+        for (; i < width; i++)
+        {
+            int s0 = ky[0] * src[0][i];
+            for (k = 1; k <= ksize2; k++)
+                s0 += ky[k] * (src[k][i] + src[-k][i]);
+            dst[i] = (uchar)CV_DESCALE(s0, ICV_SEPFILTER_FIXED_SHIFT);
+        }
+    }
+
+    return CV_OK;
+}
+
+#undef ICV_LOAD_8U32S
+#undef ICV_SEPFILTER_FIXED_SHIFT
+
+/****************************************************************************************\
+*                                  Recursive gaussian *
+\****************************************************************************************/
+
+/* the operations of the C code in the same order, so both are bit-exact */
+#define ICV_RECURSIVE_STEP_TAIL()                                            \
+    for (; i < n; i++)                                                       \
+    {                                                                        \
+        float u = (c[0] * xa[i] + c[1] * xb[i])                              \
+                  - (a[0] * p0[i] + a[1] * q0[i]);                           \
+        float v = (c[2] * xa[i] + c[3] * xb[i])                              \
+                  - (a[2] * p1[i] + a[3] * q1[i]);                           \
+        q0[i] = p0[i];                                                       \
+        p0[i] = u;                                                           \
+        q1[i] = p1[i];                                                       \
+        p1[i] = v;                                                           \
+        dst[i] = add ? dst[i] + (u + v) : u + v;                             \
+    }
+
+CV_TARGET_SSE2 static CvStatus CV_STDCALL icvRecursiveGaussianStep_32f_sse2(
+    const float* xa, const float* xb, const float* c, const float* a,
+    float* state, float* dst, int n, int add)
+{
+    float *p0 = state, *q0 = p0 + n, *p1 = q0 + n, *q1 = p1 + n;
+    __m128 c0 = _mm_set1_ps(c[0]), c1 = _mm_set1_ps(c[1]);
+    __m128 c2 = _mm_set1_ps(c[2]), c3 = _mm_set1_ps(c[3]);
+    __m128 a0 = _mm_set1_ps(a[0]), a1 = _mm_set1_ps(a[1]);
+    __m128 a2 = _mm_set1_ps(a[2]), a3 = _mm_set1_ps(a[3]);
+    int i = 0;
+
+    for (; i <= n - 4; i += 4)
+    {
+        __m128 x0 = _mm_loadu_ps(xa + i), x1 = _mm_loadu_ps(xb + i);
+        __m128 y1 = _mm_loadu_ps(p0 + i), y2 = _mm_loadu_ps(p1 + i);
+        __m128 u = _mm_sub_ps(
+            _mm_add_ps(_mm_mul_ps(c0, x0), _mm_mul_ps(c1, x1)),
+            _mm_add_ps(_mm_mul_ps(a0, y1),
+                       _mm_mul_ps(a1, _mm_loadu_ps(q0 + i))));
+        __m128 v = _mm_sub_ps(
+            _mm_add_ps(_mm_mul_ps(c2, x0), _mm_mul_ps(c3, x1)),
+            _mm_add_ps(_mm_mul_ps(a2, y2),
+                       _mm_mul_ps(a3, _mm_loadu_ps(q1 + i))));
+        __m128 s = _mm_add_ps(u, v);
+
+        _mm_storeu_ps(q0 + i, y1);
+        _mm_storeu_ps(p0 + i, u);
+        _mm_storeu_ps(q1 + i, y2);
+        _mm_storeu_ps(p1 + i, v);
+        if (add)
+            s = _mm_add_ps(_mm_loadu_ps(dst + i), s);
+        _mm_storeu_ps(dst + i, s);
+    }
+
+    ICV_RECURSIVE_STEP_TAIL()
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvRecursiveGaussianStep_32f_avx2(
+    const float* xa, const float* xb, const float* c, const float* a,
+    float* state, float* dst, int n, int add)
+{
+    float *p0 = state, *q0 = p0 + n, *p1 = q0 + n, *q1 = p1 + n;
+    __m256 c0 = _mm256_set1_ps(c[0]), c1 = _mm256_set1_ps(c[1]);
+    __m256 c2 = _mm256_set1_ps(c[2]), c3 = _mm256_set1_ps(c[3]);
+    __m256 a0 = _mm256_set1_ps(a[0]), a1 = _mm256_set1_ps(a[1]);
+    __m256 a2 = _mm256_set1_ps(a[2]), a3 = _mm256_set1_ps(a[3]);
+    int i = 0;
+
+    for (; i <= n - 8; i += 8)
+    {
+        __m256 x0 = _mm256_loadu_ps(xa + i), x1 = _mm256_loadu_ps(xb + i);
+        __m256 y1 = _mm256_loadu_ps(p0 + i), y2 = _mm256_loadu_ps(p1 + i);
+        __m256 u = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_mul_ps(c0, x0), _mm256_mul_ps(c1, x1)),
+            _mm256_add_ps(_mm256_mul_ps(a0, y1),
+                          _mm256_mul_ps(a1, _mm256_loadu_ps(q0 + i))));
+        __m256 v = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_mul_ps(c2, x0), _mm256_mul_ps(c3, x1)),
+            _mm256_add_ps(_mm256_mul_ps(a2, y2),
+                          _mm256_mul_ps(a3, _mm256_loadu_ps(q1 + i))));
+        __m256 s = _mm256_add_ps(u, v);
+
+        _mm256_storeu_ps(q0 + i, y1);
+        _mm256_storeu_ps(p0 + i, u);
+        _mm256_storeu_ps(q1 + i, y2);
+        _mm256_storeu_ps(p1 + i, v);
+        if (add)
+            s = _mm256_add_ps(_mm256_loadu_ps(dst + i), s);
+        _mm256_storeu_ps(dst + i, s);
+    }
+
+    ICV_RECURSIVE_STEP_TAIL()
+
+    return CV_OK;
+}
+
+#undef ICV_RECURSIVE_STEP_TAIL
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL
+icvRecursiveGaussianLoad_8u32f_avx2(const uchar* src, float* dst, int len)
+{
+    int i = 0;
+
+    for (; i <= len - 8; i += 8)
+        _mm256_storeu_ps(dst + i,
+                         _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+                             _mm_loadl_epi64((const __m128i*)(src + i)))));
+
+    for (; i < len; i++)
+        dst[i] = (float)src[i];
+
+    return CV_OK;
+}
+
+/* _mm256_cvtps_epi32 rounds to the nearest even as cvRound does, the packs
+   saturate as CV_CAST_8U does */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL
+icvRecursiveGaussianStore_32f8u_avx2(const float* src, uchar* dst, int len)
+{
+    int i = 0;
+
+    for (; i <= len - 16; i += 16)
+    {
+        __m256i a = _mm256_cvtps_epi32(_mm256_loadu_ps(src + i));
+        __m256i b = _mm256_cvtps_epi32(_mm256_loadu_ps(src + i + 8));
+        __m256i w = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+        _mm_storeu_si128((__m128i*)(dst + i),
+                         _mm_packus_epi16(_mm256_castsi256_si128(w),
+                                          _mm256_extracti128_si256(w, 1)));
+    }
+
+    for (; i < len; i++)
+    {
+        int t = cvRound(src[i]);
+        dst[i] = CV_CAST_8U(t);
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                     BGR(A) to gray *
+\****************************************************************************************/
+
+#define ICV_GRAY_SHIFT 14
+#define ICV_GRAY_R 4899
+#define ICV_GRAY_G 9617
+#define ICV_GRAY_B ((1 << ICV_GRAY_SHIFT) - ICV_GRAY_R - ICV_GRAY_G)
+
+/* the same fixed-point coefficients as cscGr, cscGg and cscGb in
+   cvcolor.cpp, so the result is bit-exact */
+CV_TARGET_SSE4_1 static CvStatus CV_STDCALL icvBGRx2Gray_8u_CnC1R_sse4_1(
+    const uchar* src, int srcstep, uchar* dst, int dststep, CvSize size,
+    int src_cn, int blue_idx)
+{
+    int cb = blue_idx ? ICV_GRAY_R : ICV_GRAY_B;
+    int cr = blue_idx ? ICV_GRAY_B : ICV_GRAY_R;
+    // the pixels 0..3 are taken from src[0..15] and the pixels 4..7 from
+    // src[8..23] (3 channels) or src[16..31] (4 channels)
+    int o = src_cn == 4 ? 0 : 4, step1 = src_cn == 4 ? 16 : 8;
+    // (c0,c1) and (c2,1) pairs of 16-bit values, one pair per pixel; the
+    // rounding delta is added as 1*delta
+    const __m128i shuf01[] = {
+        _mm_setr_epi8(0, -1, 1, -1, src_cn, -1, src_cn + 1, -1, src_cn * 2,
+                      -1, src_cn * 2 + 1, -1, src_cn * 3, -1,
+                      src_cn * 3 + 1, -1),
+        _mm_setr_epi8(o, -1, o + 1, -1, o + src_cn, -1, o + src_cn + 1, -1,
+                      o + src_cn * 2, -1, o + src_cn * 2 + 1, -1,
+                      o + src_cn * 3, -1, o + src_cn * 3 + 1, -1)};
+    const __m128i shuf2[] = {
+        _mm_setr_epi8(2, -1, -1, -1, src_cn + 2, -1, -1, -1, src_cn * 2 + 2,
+                      -1, -1, -1, src_cn * 3 + 2, -1, -1, -1),
+        _mm_setr_epi8(o + 2, -1, -1, -1, o + src_cn + 2, -1, -1, -1,
+                      o + src_cn * 2 + 2, -1, -1, -1, o + src_cn * 3 + 2, -1,
+                      -1, -1)};
+    const __m128i c01 = _mm_set1_epi32((ICV_GRAY_G << 16) | cb);
+    const __m128i c2 = _mm_set1_epi32((1 << (ICV_GRAY_SHIFT - 1) << 16) | cr);
+    const __m128i one = _mm_set1_epi32(1 << 16);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        const uchar* s = src;
+        int i = 0, k;
+
+        for (; i <= size.width - 8; i += 8, s += src_cn * 8)
+        {
+            __m128i t[2];
+
+            for (k = 0; k < 2; k++)
+            {
+                __m128i p = _mm_loadu_si128((const __m128i*)(s + k * step1));
+                __m128i p2 = _mm_or_si128(_mm_shuffle_epi8(p, shuf2[k]), one);
+                t[k] = _mm_add_epi32(
+                    _mm_madd_epi16(_mm_shuffle_epi8(p, shuf01[k]), c01),
+                    _mm_madd_epi16(p2, c2));
+            }
+
+            t[0] = _mm_packs_epi32(_mm_srli_epi32(t[0], ICV_GRAY_SHIFT),
+                                   _mm_srli_epi32(t[1], ICV_GRAY_SHIFT));
+            _mm_storel_epi64((__m128i*)(dst + i),
+                             _mm_packus_epi16(t[0], t[0]));
+        }
+
+        for (; i < size.width; i++, s += src_cn)
+        {
+            int t = s[0] * cb + s[1] * ICV_GRAY_G + s[2] * cr;
+            dst[i] = (uchar)CV_DESCALE(t, ICV_GRAY_SHIFT);
+        }
+    }
+
+    return CV_OK;
+}
+
+#undef ICV_GRAY_SHIFT
+#undef ICV_GRAY_R
+#undef ICV_GRAY_G
+#undef ICV_GRAY_B
+
+/****************************************************************************************\
+*                                 Template Matching *
+\****************************************************************************************/
+
+/* 32 positions are accumulated at once; the products are added in the same
+   order as the C code does, so the result is bit-exact */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvCrossCorrRow_32f_C1R_avx2(
+    const float* src, const float* templ, int templ_len, float* dst, int len)
+{
+    int x = 0, j;
+
+    for (; x <= len - 32; x += 32)
+    {
+        const float* s = src + x;
+        __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+
+        for (j = 0; j < templ_len; j++, s++)
+        {
+            __m256 t = _mm256_broadcast_ss(templ + j);
+            a0 = _mm256_add_ps(a0, _mm256_mul_ps(t, _mm256_loadu_ps(s)));
+            a1 = _mm256_add_ps(a1, _mm256_mul_ps(t, _mm256_loadu_ps(s + 8)));
+            a2 = _mm256_add_ps(a2, _mm256_mul_ps(t, _mm256_loadu_ps(s + 16)));
+            a3 = _mm256_add_ps(a3, _mm256_mul_ps(t, _mm256_loadu_ps(s + 24)));
+        }
+
+        _mm256_storeu_ps(dst + x, a0);
+        _mm256_storeu_ps(dst + x + 8, a1);
+        _mm256_storeu_ps(dst + x + 16, a2);
+        _mm256_storeu_ps(dst + x + 24, a3);
+    }
+
+    for (; x <= len - 8; x += 8)
+    {
+        const float* s = src + x;
+        __m256 a0 = _mm256_setzero_ps();
+
+        for (j = 0; j < templ_len; j++, s++)
+            a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_broadcast_ss(templ + j),
+                                                 _mm256_loadu_ps(s)));
+        _mm256_storeu_ps(dst + x, a0);
+    }
+
+    for (; x < len; x++)
+    {
+        float s0 = 0;
+
+        for (j = 0; j < templ_len; j++)
+            s0 += templ[j] * src[x + j];
+        dst[x] = s0;
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                  DIS Optical Flow *
+\****************************************************************************************/
+
+/* the lanes are added in the order of icvDISSumLanes */
+CV_TARGET_AVX2 CV_INLINE float icvDISSumLanes_avx2(__m256 a)
+{
+    __m128 v = _mm_add_ps(_mm256_castps256_ps128(a),
+                          _mm256_extractf128_ps(a, 1));
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+
+/* a patch row is one register; the products are added in the same order
+   as the C code does, so the sums are bit-exact */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvDISPatch_32f_C1R_avx2(
+    const float* src, int srcstep, const float* prev, int prevstep,
+    const float* gx, const float* gy, int gradstep, const float* w,
+    float* sums)
+{
+    __m256 w0 = _mm256_set1_ps(w[0]), w1 = _mm256_set1_ps(w[1]);
+    __m256 w2 = _mm256_set1_ps(w[2]), w3 = _mm256_set1_ps(w[3]);
+    __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    __m256 a = _mm256_loadu_ps(src), b = _mm256_loadu_ps(src + 1);
+    int i;
+
+    srcstep /= sizeof(src[0]);
+    prevstep /= sizeof(prev[0]);
+    gradstep /= sizeof(gx[0]);
+
+    for (i = 0; i < 8; i++, prev += prevstep, gx += gradstep, gy += gradstep)
+    {
+        __m256 c, d, t;
+        src += srcstep;
+        c = _mm256_loadu_ps(src);
+        d = _mm256_loadu_ps(src + 1);
+        t = _mm256_add_ps(_mm256_mul_ps(w0, a), _mm256_mul_ps(w1, b));
+        t = _mm256_add_ps(t, _mm256_mul_ps(w2, c));
+        t = _mm256_add_ps(t, _mm256_mul_ps(w3, d));
+        a = c;
+        b = d;
+        t = _mm256_sub_ps(t, _mm256_loadu_ps(prev));
+        s0 = _mm256_add_ps(s0, t);
+        s1 = _mm256_add_ps(s1, _mm256_mul_ps(t, t));
+        s2 = _mm256_add_ps(s2, _mm256_mul_ps(_mm256_loadu_ps(gx), t));
+        s3 = _mm256_add_ps(s3, _mm256_mul_ps(_mm256_loadu_ps(gy), t));
+    }
+
+    sums[0] = icvDISSumLanes_avx2(s0);
+    sums[1] = icvDISSumLanes_avx2(s1);
+    sums[2] = icvDISSumLanes_avx2(s2);
+    sums[3] = icvDISSumLanes_avx2(s3);
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvDISDensify_32f_C1R_avx2(
+    const float* src, int srcstep, const float* prev, int prevstep,
+    const float* w, float u, float v, float* wsum, float* usum, float* vsum,
+    int accstep, int rows)
+{
+    __m256 w0 = _mm256_set1_ps(w[0]), w1 = _mm256_set1_ps(w[1]);
+    __m256 w2 = _mm256_set1_ps(w[2]), w3 = _mm256_set1_ps(w[3]);
+    __m256 vu = _mm256_set1_ps(u), vv = _mm256_set1_ps(v);
+    __m256 one = _mm256_set1_ps(1.f);
+    __m256 a = _mm256_loadu_ps(src), b = _mm256_loadu_ps(src + 1);
+    int i;
+
+    srcstep /= sizeof(src[0]);
+    prevstep /= sizeof(prev[0]);
+    accstep /= sizeof(wsum[0]);
+
+    for (i = 0; i < rows; i++, prev += prevstep, wsum += accstep,
+        usum += accstep, vsum += accstep)
+    {
+        __m256 c, d, t;
+        src += srcstep;
+        c = _mm256_loadu_ps(src);
+        d = _mm256_loadu_ps(src + 1);
+        t = _mm256_add_ps(_mm256_mul_ps(w0, a), _mm256_mul_ps(w1, b));
+        t = _mm256_add_ps(t, _mm256_mul_ps(w2, c));
+        t = _mm256_add_ps(t, _mm256_mul_ps(w3, d));
+        a = c;
+        b = d;
+        t = _mm256_sub_ps(t, _mm256_loadu_ps(prev));
+        t = _mm256_div_ps(one, _mm256_max_ps(_mm256_mul_ps(t, t), one));
+        _mm256_storeu_ps(wsum, _mm256_add_ps(_mm256_loadu_ps(wsum), t));
+        _mm256_storeu_ps(usum, _mm256_add_ps(_mm256_loadu_ps(usum),
+                                             _mm256_mul_ps(t, vu)));
+        _mm256_storeu_ps(vsum, _mm256_add_ps(_mm256_loadu_ps(vsum),
+                                             _mm256_mul_ps(t, vv)));
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                  Gaussian Pyramids *
+\****************************************************************************************/
+
+/* splits 16 floats into the even and the odd ones */
+CV_TARGET_AVX2 CV_INLINE void icvPyrDeinterleave_avx2(const float* src,
+                                                      __m256* even, __m256* odd)
+{
+    __m256 a = _mm256_loadu_ps(src), b = _mm256_loadu_ps(src + 8);
+
+    *even = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(_mm256_shuffle_ps(a, b, 0x88)), 0xd8));
+    *odd = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(_mm256_shuffle_ps(a, b, 0xdd)), 0xd8));
+}
+
+/* the sums fit 16 bits; the even and the odd source pixels are split by
+   reading the row as 16-bit words */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrDownRow_8u32s_C1R_avx2(
+    const uchar* src, int* dst, int len)
+{
+    const __m256i mask = _mm256_set1_epi16(0xff);
+    int x = 0;
+
+    for (; x <= len - 17; x += 16)
+    {
+        const uchar* s = src + x * 2;
+        __m256i a = _mm256_loadu_si256((const __m256i*)(s - 2));
+        __m256i b = _mm256_loadu_si256((const __m256i*)s);
+        __m256i c = _mm256_loadu_si256((const __m256i*)(s + 2));
+        __m256i e = _mm256_and_si256(b, mask);
+        __m256i t = _mm256_slli_epi16(
+            _mm256_add_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)),
+            2);
+
+        t = _mm256_add_epi16(t, _mm256_add_epi16(_mm256_slli_epi16(e, 2),
+                                                 _mm256_slli_epi16(e, 1)));
+        t = _mm256_add_epi16(t, _mm256_and_si256(a, mask));
+        t = _mm256_add_epi16(t, _mm256_and_si256(c, mask));
+        _mm256_storeu_si256((__m256i*)(dst + x),
+                            _mm256_cvtepu16_epi32(_mm256_castsi256_si128(t)));
+        _mm256_storeu_si256(
+            (__m256i*)(dst + x + 8),
+            _mm256_cvtepu16_epi32(_mm256_extracti128_si256(t, 1)));
+    }
+
+    for (; x < len; x++)
+    {
+        const uchar* s = src + x * 2;
+        dst[x] = s[0] * 6 + (s[-1] + s[1]) * 4 + s[-2] + s[2];
+    }
+
+    return CV_OK;
+}
+
+/* the operations go in the order of PD_FILTER */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrDownRow_32f_C1R_avx2(
+    const float* src, float* dst, int len)
+{
+    const __m256 k4 = _mm256_set1_ps(4.f), k6 = _mm256_set1_ps(6.f);
+    int x = 0;
+
+    for (; x <= len - 9; x += 8)
+    {
+        const float* s = src + x * 2;
+        __m256 e0, o0, e1, o1, e2, t;
+
+        icvPyrDeinterleave_avx2(s - 2, &e0, &o0);
+        icvPyrDeinterleave_avx2(s, &e1, &o1);
+        icvPyrDeinterleave_avx2(s + 2, &e2, &t);
+        t = _mm256_add_ps(_mm256_mul_ps(e1, k6),
+                          _mm256_mul_ps(_mm256_add_ps(o0, o1), k4));
+        t = _mm256_add_ps(_mm256_add_ps(t, e0), e2);
+        _mm256_storeu_ps(dst + x, t);
+    }
+
+    for (; x < len; x++)
+    {
+        const float* s = src + x * 2;
+        dst[x] = s[0] * 6 + (s[-1] + s[1]) * 4 + s[-2] + s[2];
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrDownCol_32s8u_avx2(
+    const int** rows, uchar* dst, int len)
+{
+    const int *r0 = rows[0], *r1 = rows[1], *r2 = rows[2];
+    const int *r3 = rows[3], *r4 = rows[4];
+    const __m256i delta = _mm256_set1_epi32(1 << 7);
+    __m256i s[2];
+    int x = 0, k;
+
+    for (; x <= len - 16; x += 16)
+    {
+        for (k = 0; k < 2; k++)
+        {
+            int i = x + k * 8;
+            __m256i c = _mm256_loadu_si256((const __m256i*)(r2 + i));
+            __m256i t = _mm256_add_epi32(
+                _mm256_loadu_si256((const __m256i*)(r1 + i)),
+                _mm256_loadu_si256((const __m256i*)(r3 + i)));
+
+            t = _mm256_add_epi32(_mm256_slli_epi32(t, 2),
+                                 _mm256_add_epi32(_mm256_slli_epi32(c, 2),
+                                                  _mm256_slli_epi32(c, 1)));
+            t = _mm256_add_epi32(
+                t, _mm256_add_epi32(
+                       _mm256_loadu_si256((const __m256i*)(r0 + i)),
+                       _mm256_loadu_si256((const __m256i*)(r4 + i))));
+            s[k] = _mm256_srai_epi32(_mm256_add_epi32(t, delta), 8);
+        }
+
+        s[0] = _mm256_permute4x64_epi64(_mm256_packs_epi32(s[0], s[1]), 0xd8);
+        _mm_storeu_si128((__m128i*)(dst + x),
+                         _mm_packus_epi16(_mm256_castsi256_si128(s[0]),
+                                          _mm256_extracti128_si256(s[0], 1)));
+    }
+
+    for (; x < len; x++)
+        dst[x] = (uchar)((r2[x] * 6 + (r1[x] + r3[x]) * 4 + r0[x] + r4[x]
+                          + (1 << 7)) >> 8);
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrDownCol_32f_avx2(
+    const float** rows, float* dst, int len)
+{
+    const float *r0 = rows[0], *r1 = rows[1], *r2 = rows[2];
+    const float *r3 = rows[3], *r4 = rows[4];
+    const __m256 k4 = _mm256_set1_ps(4.f), k6 = _mm256_set1_ps(6.f);
+    const __m256 scale = _mm256_set1_ps(0.00390625f);
+    int x = 0;
+
+    for (; x <= len - 8; x += 8)
+    {
+        __m256 t = _mm256_add_ps(
+            _mm256_mul_ps(_mm256_loadu_ps(r2 + x), k6),
+            _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(r1 + x),
+                                        _mm256_loadu_ps(r3 + x)),
+                          k4));
+        t = _mm256_add_ps(_mm256_add_ps(t, _mm256_loadu_ps(r0 + x)),
+                          _mm256_loadu_ps(r4 + x));
+        _mm256_storeu_ps(dst + x, _mm256_mul_ps(t, scale));
+    }
+
+    for (; x < len; x++)
+        dst[x] =
+            (r2[x] * 6 + (r1[x] + r3[x]) * 4 + r0[x] + r4[x]) * 0.00390625f;
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrUpRow_8u32s_C1R_avx2(
+    const uchar* src, int* dst, int len)
+{
+    int x = 0;
+
+    for (; x <= len - 8; x += 8)
+    {
+        __m256i a = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*)(src + x - 1)));
+        __m256i b =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + x)));
+        __m256i c = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*)(src + x + 1)));
+        __m256i even = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_slli_epi32(b, 2), _mm256_slli_epi32(b, 1)),
+            _mm256_add_epi32(a, c));
+        __m256i odd = _mm256_slli_epi32(_mm256_add_epi32(b, c), 2);
+        __m256i lo = _mm256_unpacklo_epi32(even, odd);
+        __m256i hi = _mm256_unpackhi_epi32(even, odd);
+
+        _mm256_storeu_si256((__m256i*)(dst + x * 2),
+                            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + x * 2 + 8),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    for (; x < len; x++)
+    {
+        dst[x * 2] = src[x] * 6 + src[x - 1] + src[x + 1];
+        dst[x * 2 + 1] = (src[x] + src[x + 1]) * 4;
+    }
+
+    return CV_OK;
+}
+
+/* the operations go in the order of PU_FILTER and PU_FILTER_ZI */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrUpRow_32f_C1R_avx2(
+    const float* src, float* dst, int len)
+{
+    const __m256 k4 = _mm256_set1_ps(4.f), k6 = _mm256_set1_ps(6.f);
+    int x = 0;
+
+    for (; x <= len - 8; x += 8)
+    {
+        __m256 a = _mm256_loadu_ps(src + x - 1);
+        __m256 b = _mm256_loadu_ps(src + x);
+        __m256 c = _mm256_loadu_ps(src + x + 1);
+        __m256 even = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b, k6), a), c);
+        __m256 odd = _mm256_mul_ps(_mm256_add_ps(b, c), k4);
+        __m256 lo = _mm256_unpacklo_ps(even, odd);
+        __m256 hi = _mm256_unpackhi_ps(even, odd);
+
+        _mm256_storeu_ps(dst + x * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + x * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    for (; x < len; x++)
+    {
+        dst[x * 2] = src[x] * 6 + src[x - 1] + src[x + 1];
+        dst[x * 2 + 1] = (src[x] + src[x + 1]) * 4;
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrUpCol_32s8u_avx2(
+    const int** rows, uchar* dst0, uchar* dst1, int len)
+{
+    const int *r0 = rows[0], *r1 = rows[1], *r2 = rows[2];
+    const __m256i delta = _mm256_set1_epi32(1 << 5);
+    __m256i s0[2], s1[2];
+    int x = 0, k;
+
+    for (; x <= len - 16; x += 16)
+    {
+        for (k = 0; k < 2; k++)
+        {
+            int i = x + k * 8;
+            __m256i b = _mm256_loadu_si256((const __m256i*)(r1 + i));
+            __m256i c = _mm256_loadu_si256((const __m256i*)(r2 + i));
+            __m256i t = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_slli_epi32(b, 2),
+                                 _mm256_slli_epi32(b, 1)),
+                _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(r0 + i)),
+                                 c));
+
+            s0[k] = _mm256_srai_epi32(_mm256_add_epi32(t, delta), 6);
+            t = _mm256_slli_epi32(_mm256_add_epi32(b, c), 2);
+            s1[k] = _mm256_srai_epi32(_mm256_add_epi32(t, delta), 6);
+        }
+
+        s0[0] =
+            _mm256_permute4x64_epi64(_mm256_packs_epi32(s0[0], s0[1]), 0xd8);
+        s1[0] =
+            _mm256_permute4x64_epi64(_mm256_packs_epi32(s1[0], s1[1]), 0xd8);
+        _mm_storeu_si128((__m128i*)(dst0 + x),
+                         _mm_packus_epi16(_mm256_castsi256_si128(s0[0]),
+                                          _mm256_extracti128_si256(s0[0], 1)));
+        _mm_storeu_si128((__m128i*)(dst1 + x),
+                         _mm_packus_epi16(_mm256_castsi256_si128(s1[0]),
+                                          _mm256_extracti128_si256(s1[0], 1)));
+    }
+
+    for (; x < len; x++)
+    {
+        dst0[x] = (uchar)((r1[x] * 6 + r0[x] + r2[x] + (1 << 5)) >> 6);
+        dst1[x] = (uchar)(((r1[x] + r2[x]) * 4 + (1 << 5)) >> 6);
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvPyrUpCol_32f_avx2(
+    const float** rows, float* dst0, float* dst1, int len)
+{
+    const float *r0 = rows[0], *r1 = rows[1], *r2 = rows[2];
+    const __m256 k4 = _mm256_set1_ps(4.f), k6 = _mm256_set1_ps(6.f);
+    const __m256 scale = _mm256_set1_ps(0.015625f);
+    int x = 0;
+
+    for (; x <= len - 8; x += 8)
+    {
+        __m256 b = _mm256_loadu_ps(r1 + x), c = _mm256_loadu_ps(r2 + x);
+        __m256 t = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(b, k6), _mm256_loadu_ps(r0 + x)), c);
+
+        _mm256_storeu_ps(dst0 + x, _mm256_mul_ps(t, scale));
+        t = _mm256_mul_ps(_mm256_add_ps(b, c), k4);
+        _mm256_storeu_ps(dst1 + x, _mm256_mul_ps(t, scale));
+    }
+
+    for (; x < len; x++)
+    {
+        dst0[x] = (r1[x] * 6 + r0[x] + r2[x]) * 0.015625f;
+        dst1[x] = ((r1[x] + r2[x]) * 4) * 0.015625f;
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                     Haar Cascades *
+\****************************************************************************************/
+
+/* the sum of the rectangle k of the stump in the eight windows at vofs,
+   times the weight of the rectangle */
+CV_TARGET_AVX2 CV_INLINE __m256 icvHaarRect_avx2(const int* base,
+                                                 const CvHaarStump* stump,
+                                                 int k, __m256i vofs)
+{
+    __m256i s = _mm256_sub_epi32(
+        _mm256_i32gather_epi32(base + stump->p[k][0], vofs, 4),
+        _mm256_i32gather_epi32(base + stump->p[k][1], vofs, 4));
+    s = _mm256_sub_epi32(
+        s, _mm256_i32gather_epi32(base + stump->p[k][2], vofs, 4));
+    s = _mm256_add_epi32(
+        s, _mm256_i32gather_epi32(base + stump->p[k][3], vofs, 4));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(s),
+                         _mm256_set1_ps(stump->weight[k]));
+}
+
+#define ICV_HAAR_AVX2_CHUNK 256
+
+/* runs the cascade stage by stage on eight of the windows [first,first+count)
+   at once, keeping the indices of the windows still alive in buf. The
+   rectangle sums are weighted in float and added in double in the order of
+   the C code, so the results are bit-exact */
+CV_TARGET_AVX2 static void icvHaarStumpChunk_avx2(
+    const CvHaarStumpCascade* cascade, int start_stage, int end_stage,
+    const int* ofs, const double* norm, int* result, int* buf, int first,
+    int count)
+{
+    int i, j, k, l, n = count;
+
+    for (i = 0; i < count; i++)
+    {
+        buf[i] = first + i;
+        result[first + i] = 1;
+    }
+
+    for (k = start_stage; k < end_stage && n > 0; k++)
+    {
+        const CvHaarStumpStage* stage = cascade->stages + k;
+        const CvHaarStump* stumps = cascade->stumps + stage->first;
+        __m256d threshold = _mm256_set1_pd(stage->threshold);
+        int m = 0;
+
+        for (i = 0; i < n; i += 8)
+        {
+            int len = MIN(n - i, 8), mask;
+            int idx[8];
+            __m256i vidx, vofs;
+            __m256d nf0, nf1, s0 = _mm256_setzero_pd(), s1 = s0;
+            // the masked gathers with all lanes set are the plain ones,
+            // without the undefined source that trips GCC 12 -Wall
+            const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+            // the missing lanes repeat the last window
+            for (l = 0; l < 8; l++)
+                idx[l] = buf[i + MIN(l, len - 1)];
+            vidx = _mm256_loadu_si256((const __m256i*)idx);
+            vofs = _mm256_i32gather_epi32(ofs, vidx, 4);
+            nf0 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), norm,
+                                           _mm256_castsi256_si128(vidx), all,
+                                           8);
+            nf1 = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), norm,
+                                           _mm256_extracti128_si256(vidx, 1),
+                                           all, 8);
+
+            for (j = 0; j < stage->count; j++)
+            {
+                const CvHaarStump* stump = stumps + j;
+                const int* base =
+                    stump->tilted ? cascade->tilted : cascade->sum;
+                __m256d t = _mm256_set1_pd(stump->threshold);
+                __m256d a = _mm256_set1_pd(stump->alpha[0]);
+                __m256d b = _mm256_set1_pd(stump->alpha[1]);
+                __m256 f = icvHaarRect_avx2(base, stump, 0, vofs);
+                __m256d sum0 = _mm256_cvtps_pd(_mm256_castps256_ps128(f));
+                __m256d sum1 = _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1));
+
+                f = icvHaarRect_avx2(base, stump, 1, vofs);
+                sum0 = _mm256_add_pd(
+                    sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+                sum1 = _mm256_add_pd(
+                    sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+
+                if (stage->rects > 2)
+                {
+                    f = icvHaarRect_avx2(base, stump, 2, vofs);
+                    sum0 = _mm256_add_pd(
+                        sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+                    sum1 = _mm256_add_pd(
+                        sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+                }
+
+                sum0 = _mm256_cmp_pd(sum0, _mm256_mul_pd(t, nf0), _CMP_LT_OQ);
+                sum1 = _mm256_cmp_pd(sum1, _mm256_mul_pd(t, nf1), _CMP_LT_OQ);
+                s0 = _mm256_add_pd(s0, _mm256_blendv_pd(b, a, sum0));
+                s1 = _mm256_add_pd(s1, _mm256_blendv_pd(b, a, sum1));
+            }
+
+            mask = _mm256_movemask_pd(_mm256_cmp_pd(s0, threshold, _CMP_LT_OQ))
+                   | (_mm256_movemask_pd(
+                          _mm256_cmp_pd(s1, threshold, _CMP_LT_OQ))
+                      << 4);
+
+            for (l = 0; l < len; l++)
+            {
+                if (mask & (1 << l))
+                    result[idx[l]] = -k;
+                else
+                    buf[m++] = idx[l];
+            }
+        }
+
+        n = m;
+    }
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvHaarStumpCascade_32s64f_avx2(
+    const CvHaarStumpCascade* cascade, int start_stage, int end_stage,
+    const int* ofs, const double* norm, int* result, int count)
+{
+    int buf[ICV_HAAR_AVX2_CHUNK];
+    int i;
+
+    for (i = 0; i < count; i += ICV_HAAR_AVX2_CHUNK)
+        icvHaarStumpChunk_avx2(cascade, start_stage, end_stage, ofs, norm,
+                               result, buf, i,
+                               MIN(count - i, ICV_HAAR_AVX2_CHUNK));
+
+    return CV_OK;
+}
+
+#endif /* CV_BUILTIN_SIMD */
+
+/****************************************************************************************\
+*                              The table of built-in functions *
+\****************************************************************************************/
+
+#define ICV_BUILTIN(name, isa, features) \
+    {(void**)&name##_p, (void*)name##_##isa, features},
+
+#define ICV_BUILTIN_C134(prefix, suffix, isa, features) \
+    ICV_BUILTIN(prefix##_C1##suffix, isa, features)     \
+    ICV_BUILTIN(prefix##_C3##suffix, isa, features)     \
+    ICV_BUILTIN(prefix##_C4##suffix, isa, features)
+
+/* the best variant of every function goes first */
+CvBuiltinFuncInfo cv_builtin_tab[] = {
+#if CV_BUILTIN_SIMD
+    ICV_BUILTIN_C134(icvResize_8u, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvResize_8u, R, sse4_1, CV_CPU_SSE4_1)
+    ICV_BUILTIN_C134(icvResize_32f, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvResize_32f, R, sse2, CV_CPU_SSE2)
+
+    ICV_BUILTIN(icvResizeBilinearVLine_8u_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvResizeBilinearVLine_8u_C1R, sse4_1, CV_CPU_SSE4_1)
+    ICV_BUILTIN(icvResizeBilinearVLine_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvResizeBilinearVLine_32f_C1R, sse2, CV_CPU_SSE2)
+
+    ICV_BUILTIN_C134(icvResizeFilterHLine_8u, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvResizeFilterHLine_16u, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvResizeFilterHLine_32f, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvResizeFilterVLine_8u_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvResizeFilterVLine_16u_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvResizeFilterVLine_32f_C1R, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN_C134(icvRemap_8u, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRemap_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvRemap_8u, R, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN_C134(icvRemap_32f, R, sse2, CV_CPU_SSE2)
+
+    ICV_BUILTIN(icvRemapFixed_8u_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRemapFixed_8u_C3R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRemapFixed_8u_C4R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRemapFixed_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvRemapFixed_8u, R, sse4_1, CV_CPU_SSE4_1)
+    ICV_BUILTIN_C134(icvRemapFixed_32f, R, sse4_1, CV_CPU_SSE4_1)
+
+    ICV_BUILTIN_C134(icvFilterBox_8u, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvFilterBox_8u, R, sse4_1, CV_CPU_SSE4_1)
+    ICV_BUILTIN_C134(icvFilterBox_32f, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvFilterBox_32f, R, sse2, CV_CPU_SSE2)
+
+    ICV_BUILTIN_C134(icvFilterRow_32f, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvFilterRow_32f, R, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN_C134(icvFilterColumn_32f, R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN_C134(icvFilterColumn_32f, R, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvFilterRowSymm_8u32s_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvFilterColSymm_32s8u_C1R, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN(icvRecursiveGaussianStep_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRecursiveGaussianStep_32f, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvRecursiveGaussianLoad_8u32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvRecursiveGaussianStore_32f8u, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN(icvBGRx2Gray_8u_CnC1R, sse4_1, CV_CPU_SSE4_1)
+
+    ICV_BUILTIN(icvCrossCorrRow_32f_C1R, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN(icvDISPatch_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDISDensify_32f_C1R, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN(icvPyrDownRow_8u32s_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrDownRow_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrDownCol_32s8u, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrDownCol_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrUpRow_8u32s_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrUpRow_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrUpCol_32s8u, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvPyrUpCol_32f, avx2, CV_CPU_AVX2)
+
+    ICV_BUILTIN(icvHaarStumpCascade_32s64f, avx2, CV_CPU_AVX2)
+#endif
+    {0, 0, 0}};
+
+#undef ICV_BUILTIN
+#undef ICV_BUILTIN_C134
+
+/* End of file. */
@@ -54,6 +54,8 @@ direct,
 
 static void icvSumRow_8u32s(const uchar* src0, int* dst, void* params);
 static void icvSumRow_32f64f(const float* src0, double* dst, void* params);
+static void icvSumRow_16f64f(const ushort* src0, double* dst, void* params);
+static void icvSumRow_16u64f(const ushort* src0, double* dst, void* params);
 static void icvSumCol_32s8u(const int** src, uchar* dst, int dst_step,
                             int count, void* params);
 static void icvSumCol_32s16s(const int** src, short* dst, int dst_step,
@@ -62,6 +64,10 @@ static void icvSumCol_32s32s(const int** src, int* dst, int dst_step, int count,
                              void* params);
 static void icvSumCol_64f32f(const double** src, float* dst, int dst_step,
                              int count, void* params);
+static void icvSumCol_64f16f(const double** src, ushort* dst, int dst_step,
+                             int count, void* params);
+static void icvSumCol_64f16u(const double** src, ushort* dst, int dst_step,
+                             int count, void* params);
 
 CvBoxFilter::CvBoxFilter()
 {
@@ -115,6 +121,10 @@ void CvBoxFilter::init(int _max_width, int _src_type, int _dst_type,
         x_func = (CvRowFilterFunc)icvSumRow_8u32s;
     else if (CV_MAT_DEPTH(src_type) == CV_32F)
         x_func = (CvRowFilterFunc)icvSumRow_32f64f;
+    else if (CV_MAT_DEPTH(src_type) == CV_16F)
+        x_func = (CvRowFilterFunc)icvSumRow_16f64f;
+    else if (CV_MAT_DEPTH(src_type) == CV_16U)
+        x_func = (CvRowFilterFunc)icvSumRow_16u64f;
     else
         CV_ERROR(CV_StsUnsupportedFormat,
                  "Unknown/unsupported input image format");
@@ -148,6 +158,20 @@ void CvBoxFilter::init(int _max_width, int _src_type, int _dst_type,
                                    "not) is supported in case of 32f output");
         y_func = (CvColumnFilterFunc)icvSumCol_64f32f;
     }
+    else if (CV_MAT_DEPTH(dst_type) == CV_16F)
+    {
+        if (CV_MAT_DEPTH(src_type) != CV_16F)
+            CV_ERROR(CV_StsBadArg, "Only 16f->16f box filter (normalized or "
+                                   "not) is supported in case of 16f output");
+        y_func = (CvColumnFilterFunc)icvSumCol_64f16f;
+    }
+    else if (CV_MAT_DEPTH(dst_type) == CV_16U)
+    {
+        if (CV_MAT_DEPTH(src_type) != CV_16U)
+            CV_ERROR(CV_StsBadArg, "Only 16u->16u box filter (normalized or "
+                                   "not) is supported in case of 16u output");
+        y_func = (CvColumnFilterFunc)icvSumCol_64f16u;
+    }
     else
     {
         CV_ERROR(CV_StsBadArg, "Unknown/unsupported destination image format");
@@ -158,11 +182,19 @@ void CvBoxFilter::init(int _max_width, int _src_type, int _dst_type,
 
 void CvBoxFilter::start_process(CvSlice x_range, int width)
 {
+    // the base class keeps the buffer layout of the previous stripe when the
+    // placement is the same, so the sum row is taken off the buffer only once
+    bool same_layout = x_range.start_index == prev_x_range.start_index
+                       && x_range.end_index == prev_x_range.end_index
+                       && width == prev_width;
     CvBaseImageFilter::start_process(x_range, width);
     int i, psz = CV_ELEM_SIZE(work_type);
     uchar* s;
-    buf_end -= buf_step;
-    buf_max_count--;
+    if (!same_layout)
+    {
+        buf_end -= buf_step;
+        buf_max_count--;
+    }
     assert(buf_max_count >= max_ky * 2 + 1);
     s = sum =
         buf_end
@@ -199,30 +231,37 @@ static void icvSumRow_8u32s(const uchar* src, int* dst, void* params)
     }
 }
 
-static void icvSumRow_32f64f(const float* src, double* dst, void* params)
-{
-    const CvBoxFilter* state = (const CvBoxFilter*)params;
-    int ksize = state->get_kernel_size().width;
-    int width = state->get_width();
-    int cn = CV_MAT_CN(state->get_src_type());
-    int i, k;
-
-    width = (width - 1) * cn;
-    ksize *= cn;
-
-    for (k = 0; k < cn; k++, src++, dst++)
-    {
-        double s = 0;
-        for (i = 0; i < ksize; i += cn)
-            s += src[i];
-        dst[0] = s;
-        for (i = 0; i < width; i += cn)
-        {
-            s += (double)src[i + ksize] - src[i];
-            dst[i + cn] = s;
-        }
+#define ICV_SUM_ROW_64F(flavor, srctype, load_macro)                     \
+    static void icvSumRow_##flavor##64f(const srctype* src, double* dst, \
+                                        void* params)                    \
+    {                                                                    \
+        const CvBoxFilter* state = (const CvBoxFilter*)params;           \
+        int ksize = state->get_kernel_size().width;                      \
+        int width = state->get_width();                                  \
+        int cn = CV_MAT_CN(state->get_src_type());                       \
+        int i, k;                                                        \
+                                                                         \
+        width = (width - 1) * cn;                                        \
+        ksize *= cn;                                                     \
+                                                                         \
+        for (k = 0; k < cn; k++, src++, dst++)                           \
+        {                                                                \
+            double s = 0;                                                \
+            for (i = 0; i < ksize; i += cn)                              \
+                s += load_macro(src[i]);                                 \
+            dst[0] = s;                                                  \
+            for (i = 0; i < width; i += cn)                              \
+            {                                                            \
+                s += (double)load_macro(src[i + ksize])                  \
+                     - load_macro(src[i]);                               \
+                dst[i + cn] = s;                                         \
+            }                                                            \
+        }                                                                \
     }
-}
+
+ICV_SUM_ROW_64F(32f, float, CV_NOP)
+ICV_SUM_ROW_64F(16f, ushort, CV_16FTO32F)
+ICV_SUM_ROW_64F(16u, ushort, CV_NOP)
 
 static void icvSumCol_32s8u(const int** src, uchar* dst, int dst_step,
                             int count, void* params)
@@ -433,80 +472,90 @@ static void icvSumCol_32s32s(const int** src, int* dst, int dst_step, int count,
     *_sum_count = sum_count;
 }
 
-static void icvSumCol_64f32f(const double** src, float* dst, int dst_step,
-                             int count, void* params)
-{
-    CvBoxFilter* state = (CvBoxFilter*)params;
-    int ksize = state->get_kernel_size().height;
-    int i, width = state->get_width();
-    int cn = CV_MAT_CN(state->get_src_type());
-    double scale = state->get_scale();
-    bool normalized = state->is_normalized();
-    double* sum = (double*)state->get_sum_buf();
-    int* _sum_count = state->get_sum_count_ptr();
-    int sum_count = *_sum_count;
-
-    dst_step /= sizeof(dst[0]);
-    width *= cn;
-    src += sum_count;
-    count += ksize - 1 - sum_count;
-
-    for (; count--; src++)
-    {
-        const double* sp = src[0];
-        if (sum_count + 1 < ksize)
-        {
-            for (i = 0; i <= width - 2; i += 2)
-            {
-                double s0 = sum[i] + sp[i], s1 = sum[i + 1] + sp[i + 1];
-                sum[i] = s0;
-                sum[i + 1] = s1;
-            }
-
-            for (; i < width; i++)
-                sum[i] += sp[i];
-
-            sum_count++;
-        }
-        else
-        {
-            const double* sm = src[-ksize + 1];
-            if (normalized)
-                for (i = 0; i <= width - 2; i += 2)
-                {
-                    double s0 = sum[i] + sp[i], s1 = sum[i + 1] + sp[i + 1];
-                    double t0 = s0 * scale, t1 = s1 * scale;
-                    s0 -= sm[i];
-                    s1 -= sm[i + 1];
-                    dst[i] = (float)t0;
-                    dst[i + 1] = (float)t1;
-                    sum[i] = s0;
-                    sum[i + 1] = s1;
-                }
-            else
-                for (i = 0; i <= width - 2; i += 2)
-                {
-                    double s0 = sum[i] + sp[i], s1 = sum[i + 1] + sp[i + 1];
-                    dst[i] = (float)s0;
-                    dst[i + 1] = (float)s1;
-                    s0 -= sm[i];
-                    s1 -= sm[i + 1];
-                    sum[i] = s0;
-                    sum[i + 1] = s1;
-                }
-
-            for (; i < width; i++)
-            {
-                double s0 = sum[i] + sp[i], t0 = s0 * scale;
-                sum[i] = s0 - sm[i];
-                dst[i] = (float)t0;
-            }
-            dst += dst_step;
-        }
+#define ICV_SUM_COL_64F(flavor, dsttype, cast_macro)                         \
+    static void icvSumCol_64f##flavor(const double** src, dsttype* dst,      \
+                                      int dst_step, int count, void* params) \
+    {                                                                        \
+        CvBoxFilter* state = (CvBoxFilter*)params;                           \
+        int ksize = state->get_kernel_size().height;                         \
+        int i, width = state->get_width();                                   \
+        int cn = CV_MAT_CN(state->get_src_type());                           \
+        double scale = state->get_scale();                                   \
+        bool normalized = state->is_normalized();                            \
+        double* sum = (double*)state->get_sum_buf();                         \
+        int* _sum_count = state->get_sum_count_ptr();                        \
+        int sum_count = *_sum_count;                                         \
+                                                                             \
+        dst_step /= sizeof(dst[0]);                                          \
+        width *= cn;                                                         \
+        src += sum_count;                                                    \
+        count += ksize - 1 - sum_count;                                      \
+                                                                             \
+        for (; count--; src++)                                               \
+        {                                                                    \
+            const double* sp = src[0];                                       \
+            if (sum_count + 1 < ksize)                                       \
+            {                                                                \
+                for (i = 0; i <= width - 2; i += 2)                          \
+                {                                                            \
+                    double s0 = sum[i] + sp[i], s1 = sum[i + 1] + sp[i + 1]; \
+                    sum[i] = s0;                                             \
+                    sum[i + 1] = s1;                                         \
+                }                                                            \
+                                                                             \
+                for (; i < width; i++)                                       \
+                    sum[i] += sp[i];                                         \
+                                                                             \
+                sum_count++;                                                 \
+            }                                                                \
+            else                                                             \
+            {                                                                \
+                const double* sm = src[-ksize + 1];                          \
+                if (normalized)                                              \
+                    for (i = 0; i <= width - 2; i += 2)                      \
+                    {                                                        \
+                        double s0 = sum[i] + sp[i];                          \
+                        double s1 = sum[i + 1] + sp[i + 1];                  \
+                        double t0 = s0 * scale, t1 = s1 * scale;             \
+                        s0 -= sm[i];                                         \
+                        s1 -= sm[i + 1];                                     \
+                        dst[i] = cast_macro(t0);                             \
+                        dst[i + 1] = cast_macro(t1);                         \
+                        sum[i] = s0;                                         \
+                        sum[i + 1] = s1;                                     \
+                    }                                                        \
+                else                                                         \
+                    for (i = 0; i <= width - 2; i += 2)                      \
+                    {                                                        \
+                        double s0 = sum[i] + sp[i];                          \
+                        double s1 = sum[i + 1] + sp[i + 1];                  \
+                        dst[i] = cast_macro(s0);                             \
+                        dst[i + 1] = cast_macro(s1);                         \
+                        s0 -= sm[i];                                         \
+                        s1 -= sm[i + 1];                                     \
+                        sum[i] = s0;                                         \
+                        sum[i + 1] = s1;                                     \
+                    }                                                        \
+                                                                             \
+                for (; i < width; i++)                                       \
+                {                                                            \
+                    double s0 = sum[i] + sp[i], t0 = s0 * scale;             \
+                    sum[i] = s0 - sm[i];                                     \
+                    dst[i] = cast_macro(t0);                                 \
+                }                                                            \
+                dst += dst_step;                                             \
+            }                                                                \
+        }                                                                    \
+                                                                             \
+        *_sum_count = sum_count;                                             \
     }
 
-    *_sum_count = sum_count;
-}
+ICV_SUM_COL_64F(32f, float, (float))
+ICV_SUM_COL_64F(16f, ushort, CV_CAST_16F)
+
+#define ICV_CAST_64F16U(t) CV_CAST_16U(cvRound(t))
+ICV_SUM_COL_64F(16u, ushort, ICV_CAST_64F16U)
+#undef ICV_CAST_64F16U
 
 /****************************************************************************************\
                                       Median Filter
@@ -754,6 +803,113 @@ static CvStatus CV_STDCALL icvMedianBlur_8u_CnR(uchar* src, int src_step,
     return CV_OK;
 }
 
+/* The median of 16-bit images. The window slides along every row, the
+   histogram of it has three levels: 256 coarse bins of the high bytes, 4096
+   bins of the high 12 bits and 65536 fine bins. The coarse bin of the median
+   is tracked from one position to the next, then 16 bins of each next level
+   are scanned, so the cost per pixel is O(m) for any intensity range. The
+   histograms are cleared once, and the pixels are taken out of them again
+   at the end of every row. The border pixels are replicated */
+static CvStatus CV_STDCALL icvMedianBlur_16u_CnR(ushort* src, int src_step,
+                                                 ushort* dst, int dst_step,
+                                                 CvSize size, int m, int cn)
+{
+    const int hist_size = 256 + 4096 + 65536;
+    int* hist = 0;
+    const ushort** rows = (const ushort**)cvStackAlloc(m * sizeof(rows[0]));
+    int coarse_bin[4], below[4];
+    int r = m / 2, n2 = m * m / 2;
+    int x, y, i, c;
+
+#define UPDATE_ACC16(col, delta)                                    \
+    {                                                               \
+        int ofs = (col) * cn;                                       \
+        for (i = 0; i < m; i++)                                     \
+            for (c = 0; c < cn; c++)                                \
+            {                                                       \
+                int p = rows[i][ofs + c];                           \
+                int* h = hist + c * hist_size;                      \
+                h[p >> 8] += (delta);                               \
+                h[256 + (p >> 4)] += (delta);                       \
+                h[256 + 4096 + p] += (delta);                       \
+                below[c] += (p >> 8) < coarse_bin[c] ? (delta) : 0; \
+            }                                                       \
+    }
+
+    if (cn > 4)
+        return CV_BADCHANNELS_ERR;
+
+    hist = (int*)cvAlloc(hist_size * cn * sizeof(hist[0]));
+    if (!hist)
+        return CV_OUTOFMEM_ERR;
+    memset(hist, 0, hist_size * cn * sizeof(hist[0]));
+    src_step /= sizeof(src[0]);
+    dst_step /= sizeof(dst[0]);
+
+    for (y = 0; y < size.height; y++, dst += dst_step)
+    {
+        for (i = 0; i < m; i++)
+        {
+            int yi = y - r + i;
+            yi = yi < 0 ? 0 : yi >= size.height ? size.height - 1 : yi;
+            rows[i] = src + yi * src_step;
+        }
+
+        for (c = 0; c < cn; c++)
+            coarse_bin[c] = below[c] = 0;
+
+        for (x = -r; x <= r; x++)
+            UPDATE_ACC16(MIN(MAX(x, 0), size.width - 1), 1);
+
+        for (x = 0; x < size.width; x++)
+        {
+            for (c = 0; c < cn; c++)
+            {
+                const int* h = hist + c * hist_size;
+                int k = coarse_bin[c], s = below[c];
+
+                while (s + h[k] <= n2)
+                    s += h[k++];
+                while (s > n2)
+                    s -= h[--k];
+                coarse_bin[c] = k;
+                below[c] = s;
+
+                // the bins of the high 12 bits, then the fine ones
+                for (k <<= 4;; k++)
+                {
+                    int t = s + h[256 + k];
+                    if (t > n2)
+                        break;
+                    s = t;
+                }
+
+                h += 256 + 4096 + (k << 4);
+                for (i = 0;; i++)
+                {
+                    s += h[i];
+                    if (s > n2)
+                        break;
+                }
+                dst[x * cn + c] = (ushort)((k << 4) + i);
+            }
+
+            if (x < size.width - 1)
+            {
+                UPDATE_ACC16(MAX(x - r, 0), -1);
+                UPDATE_ACC16(MIN(x + r + 1, size.width - 1), 1);
+            }
+        }
+
+        for (x = size.width - 1 - r; x <= size.width - 1 + r; x++)
+            UPDATE_ACC16(MIN(MAX(x, 0), size.width - 1), -1);
+    }
+
+#undef UPDATE_ACC16
+    cvFree(&hist);
+    return CV_OK;
+}
+
 /****************************************************************************************\
                                    Bilateral Filtering
 \****************************************************************************************/
@@ -987,6 +1143,386 @@ static CvStatus CV_STDCALL icvBilateralFiltering_8u_CnR(
 #undef COLOR_DISTANCE_C3
 }
 
+/****************************************************************************************\
+                              Recursive Gaussian Filter
+\****************************************************************************************/
+
+/* The 4th order recursive approximation of the gaussian by R. Deriche
+   ("Recursively implementing the Gaussian and its derivatives", 1993).
+   The kernel is the sum of two parts of the 2nd order. Each of them is split
+   into the causal part h(n), n >= 0, and the anti-causal part h(-n), n > 0,
+   computed by a recursion with 2 feed-forward and 2 feedback coefficients,
+   so the cost per pixel does not depend on sigma. The largest difference
+   from the sampled gaussian is about 0.05% of its peak for sigma from 0.5 to
+   a few hundred. The recursions run in single precision on the two parts
+   separately: with a large sigma the poles come close to 1, and their 4th
+   order product would amplify the rounding errors */
+typedef struct CvRecursiveGaussian
+{
+    float bp[4]; // causal parts, coefficients of x[n], x[n-1] of each
+    float bm[4]; // anti-causal parts, coefficients of x[n+1], x[n+2]
+    float a[4];  // feedback coefficients, the same for both directions
+    float sp[2]; // responses of the causal parts to the constant 1
+    float sm[2]; // responses of the anti-causal parts to the constant 1
+} CvRecursiveGaussian;
+
+static void icvInitRecursiveGaussian(CvRecursiveGaussian* g, double sigma)
+{
+    // h(n) = (a0*cos(w0*n/sigma) + a1*sin(w0*n/sigma))*exp(-b0*n/sigma) +
+    //        (c0*cos(w1*n/sigma) + c1*sin(w1*n/sigma))*exp(-b1*n/sigma)
+    static const double tab[2][4] = {{1.680, 3.735, 1.783, 0.6318},
+                                     {-0.6803, -0.2598, 1.723, 1.997}};
+    double bp[2][2], bm[2][2], sa[2], sum = 0;
+    int i, j;
+
+    for (i = 0; i < 2; i++)
+    {
+        double r = exp(-tab[i][2] / sigma), w = tab[i][3] / sigma;
+
+        g->a[i * 2] = (float)(-2 * r * cos(w));
+        g->a[i * 2 + 1] = (float)(r * r);
+        sa[i] = 1. + g->a[i * 2] + g->a[i * 2 + 1];
+
+        bp[i][0] = tab[i][0];
+        bp[i][1] = r * (tab[i][1] * sin(w) - tab[i][0] * cos(w));
+        // the anti-causal part is the mirrored causal one without h(0)
+        bm[i][0] = bp[i][1] - g->a[i * 2] * bp[i][0];
+        bm[i][1] = -g->a[i * 2 + 1] * bp[i][0];
+        sum += (bp[i][0] + bp[i][1] + bm[i][0] + bm[i][1]) / sa[i];
+    }
+
+    // normalize the kernel sum to 1
+    for (i = 0; i < 2; i++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            g->bp[i * 2 + j] = (float)(bp[i][j] / sum);
+            g->bm[i * 2 + j] = (float)(bm[i][j] / sum);
+        }
+
+        g->sp[i] = (float)(((double)g->bp[i * 2] + g->bp[i * 2 + 1]) / sa[i]);
+        g->sm[i] = (float)(((double)g->bm[i * 2] + g->bm[i * 2 + 1]) / sa[i]);
+    }
+}
+
+IPCVAPI_IMPL(CvStatus, icvRecursiveGaussianStep_32f,
+             (const float* xa, const float* xb, const float* c,
+              const float* a, float* state, float* dst, int n, int add),
+             (xa, xb, c, a, state, dst, n, add))
+{
+    float *p0 = state, *q0 = p0 + n, *p1 = q0 + n, *q1 = p1 + n;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        float u = (c[0] * xa[i] + c[1] * xb[i])
+                  - (a[0] * p0[i] + a[1] * q0[i]);
+        float v = (c[2] * xa[i] + c[3] * xb[i])
+                  - (a[2] * p1[i] + a[3] * q1[i]);
+
+        q0[i] = p0[i];
+        p0[i] = u;
+        q1[i] = p1[i];
+        p1[i] = v;
+        dst[i] = add ? dst[i] + (u + v) : u + v;
+    }
+
+    return CV_OK;
+}
+
+/* sets the state of the recursions to the response to the constant
+   border row x */
+static void icvInitRecursiveState(const float* s, const float* x,
+                                  float* state, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        state[i] = state[n + i] = s[0] * x[i];
+        state[n * 2 + i] = state[n * 3 + i] = s[1] * x[i];
+    }
+}
+
+/* Filters n parallel lines of len samples with the replicated border, the
+   sample k of the line i is src[k*sstep + i] and the result goes to
+   dst[k*n + i]. state has 4*n floats */
+static void icvRecursiveGaussianLines(const CvRecursiveGaussian* g,
+                                      const float* src, int sstep,
+                                      float* dst, int n, int len,
+                                      float* state)
+{
+    const float* last = src + (len - 1) * sstep;
+    int k;
+
+    icvInitRecursiveState(g->sp, src, state, n);
+    for (k = 0; k < len; k++)
+        icvRecursiveGaussianStep_32f_p(src + k * sstep,
+                                       src + MAX(k - 1, 0) * sstep, g->bp,
+                                       g->a, state, dst + k * n, n, 0);
+
+    icvInitRecursiveState(g->sm, last, state, n);
+    for (k = len - 1; k >= 0; k--)
+        icvRecursiveGaussianStep_32f_p(src + MIN(k + 1, len - 1) * sstep,
+                                       src + MIN(k + 2, len - 1) * sstep,
+                                       g->bm, g->a, state, dst + k * n, n, 1);
+}
+
+IPCVAPI_IMPL(CvStatus, icvRecursiveGaussianLoad_8u32f,
+             (const uchar* src, float* dst, int len), (src, dst, len))
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        dst[i] = CV_8TO32F(src[i]);
+
+    return CV_OK;
+}
+
+IPCVAPI_IMPL(CvStatus, icvRecursiveGaussianStore_32f8u,
+             (const float* src, uchar* dst, int len), (src, dst, len))
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        int t = cvRound(src[i]);
+        dst[i] = CV_CAST_8U(t);
+    }
+
+    return CV_OK;
+}
+
+static void icvLoadRecursiveRow(const uchar* src, int depth, float* dst,
+                                int len)
+{
+    int i;
+
+    if (depth == CV_8U)
+        icvRecursiveGaussianLoad_8u32f_p(src, dst, len);
+    else if (depth == CV_16U)
+        for (i = 0; i < len; i++)
+            dst[i] = ((const ushort*)src)[i];
+    else if (depth == CV_16F)
+        for (i = 0; i < len; i++)
+            dst[i] = CV_16FTO32F(((const ushort*)src)[i]);
+    else
+        memcpy(dst, src, len * sizeof(dst[0]));
+}
+
+static void icvStoreRecursiveRow(const float* src, uchar* dst, int depth,
+                                 int len)
+{
+    int i;
+
+    if (depth == CV_8U)
+        icvRecursiveGaussianStore_32f8u_p(src, dst, len);
+    else if (depth == CV_16U)
+        for (i = 0; i < len; i++)
+        {
+            int t = cvRound(src[i]);
+            ((ushort*)dst)[i] = CV_CAST_16U(t);
+        }
+    else if (depth == CV_16F)
+        for (i = 0; i < len; i++)
+            ((ushort*)dst)[i] = CV_CAST_16F(src[i]);
+    else
+        memcpy(dst, src, len * sizeof(src[0]));
+}
+
+/* The vertical pass runs first, over the strips of the source columns, and
+   stores its result to the 32f temporary image; its lines are the columns
+   of the strip, so it reads whole row segments. The horizontal pass runs
+   over the bands of the temporary image rows transposed, so that the pixels
+   of the same column lie together, and its lines are the rows of the band */
+#define ICV_RECURSIVE_STRIP 1024
+#define ICV_RECURSIVE_BAND 32
+
+typedef struct CvRecursiveGaussianBand
+{
+    const CvMat* src;
+    CvMat* dst;
+    CvMat* temp;
+    CvRecursiveGaussian gx;
+    CvRecursiveGaussian gy;
+} CvRecursiveGaussianBand;
+
+static int CV_CDECL icvRecursiveGaussianColumns(int s0, int s1, void* arg)
+{
+    const CvRecursiveGaussianBand* p = (const CvRecursiveGaussianBand*)arg;
+    const CvRecursiveGaussian* g = &p->gy;
+    float* buf = 0;
+    int status = CV_NOTDEFINED_ERR;
+
+    CV_FUNCNAME("icvRecursiveGaussianColumns");
+
+    __BEGIN__;
+
+    const int S = ICV_RECURSIVE_STRIP;
+    int depth = CV_MAT_DEPTH(p->src->type), esz = CV_ELEM_SIZE1(depth);
+    int len = p->src->cols * CV_MAT_CN(p->src->type);
+    int height = p->src->rows, s, y;
+
+    // the state of the recursions and 3 source rows converted to 32f
+    CV_CALL(buf = (float*)cvAlloc(S * 7 * sizeof(buf[0])));
+
+    for (s = s0; s < s1; s++)
+    {
+        int x0 = s * S, n = MIN(len - x0, S);
+        const uchar* src = p->src->data.ptr + x0 * esz;
+        float *state = buf, *x1 = state + n * 4, *x2 = x1 + n, *x3 = x2 + n;
+        const float *r1, *r2;
+
+#define ICV_LOAD_ROW(x, y)                                                  \
+    (depth == CV_32F                                                        \
+         ? (const float*)(src + (y) * p->src->step)                         \
+         : (icvLoadRecursiveRow(src + (y) * p->src->step, depth, (x), n), (x)))
+
+        // causal part: r1 is x[y], r2 is x[y-1]
+        r2 = ICV_LOAD_ROW(x2, 0);
+        icvInitRecursiveState(g->sp, r2, state, n);
+        for (y = 0; y < height; y++)
+        {
+            r1 = y == 0 ? r2 : ICV_LOAD_ROW(r2 == x1 ? x2 : x1, y);
+            icvRecursiveGaussianStep_32f_p(
+                r1, r2, g->bp, g->a, state,
+                (float*)(p->temp->data.ptr + y * p->temp->step) + x0, n, 0);
+            r2 = r1;
+        }
+
+        // anti-causal part: r1 is x[y+1], r2 is x[y+2]
+        r1 = r2 = ICV_LOAD_ROW(x1, height - 1);
+        icvInitRecursiveState(g->sm, r1, state, n);
+        for (y = height - 1; y >= 0; y--)
+        {
+            icvRecursiveGaussianStep_32f_p(
+                r1, r2, g->bm, g->a, state,
+                (float*)(p->temp->data.ptr + y * p->temp->step) + x0, n, 1);
+            if (y > 0)
+            {
+                // x[y] goes to the buffer that neither r1 nor r2 uses
+                float* t = r1 != x1 && r2 != x1   ? x1
+                           : r1 != x2 && r2 != x2 ? x2
+                                                  : x3;
+                r2 = r1;
+                r1 = ICV_LOAD_ROW(t, y);
+            }
+        }
+
+#undef ICV_LOAD_ROW
+    }
+
+    status = CV_OK;
+
+    __END__;
+
+    cvFree(&buf);
+
+    return status;
+}
+
+static int CV_CDECL icvRecursiveGaussianRows(int y0, int y1, void* arg)
+{
+    const CvRecursiveGaussianBand* p = (const CvRecursiveGaussianBand*)arg;
+    float* buf = 0;
+    int status = CV_NOTDEFINED_ERR;
+
+    CV_FUNCNAME("icvRecursiveGaussianRows");
+
+    __BEGIN__;
+
+    int cn = CV_MAT_CN(p->dst->type), depth = CV_MAT_DEPTH(p->dst->type);
+    int width = p->dst->cols, len = width * cn;
+    int rows = MAX(ICV_RECURSIVE_BAND / cn, 1), lanes;
+    int y, r, k, c;
+    float *row, *x, *t;
+
+    // whole vectors of the lines where possible
+    while (rows > 1 && rows * cn % 4 != 0)
+        rows--;
+    lanes = rows * cn;
+
+    CV_CALL(buf = (float*)cvAlloc((len + width * lanes * 2 + lanes * 4)
+                                  * sizeof(buf[0])));
+    row = buf;
+    x = row + len;
+    t = x + width * lanes;
+
+    for (y = y0; y < y1; y += rows)
+    {
+        int m = MIN(rows, y1 - y), n = m * cn;
+
+        // the pixels of the column k of the band go to x[k*n]
+        for (k = 0; k < width; k++)
+        {
+            const uchar* s = p->temp->data.ptr + y * p->temp->step
+                             + k * cn * sizeof(float);
+            float* xk = x + k * n;
+
+            for (r = 0; r < m; r++, s += p->temp->step, xk += cn)
+                for (c = 0; c < cn; c++)
+                    xk[c] = ((const float*)s)[c];
+        }
+
+        icvRecursiveGaussianLines(&p->gx, x, n, t, n, width,
+                                  t + width * lanes);
+
+        for (r = 0; r < m; r++)
+        {
+            for (k = 0; k < width; k++)
+                for (c = 0; c < cn; c++)
+                    row[k * cn + c] = t[k * n + r * cn + c];
+            icvStoreRecursiveRow(row,
+                                 p->dst->data.ptr + (y + r) * p->dst->step,
+                                 depth, len);
+        }
+    }
+
+    status = CV_OK;
+
+    __END__;
+
+    cvFree(&buf);
+
+    return status;
+}
+
+static CvStatus icvRecursiveGaussian(const CvMat* src, CvMat* dst,
+                                     double sigma_x, double sigma_y)
+{
+    CvRecursiveGaussianBand band;
+    CvMat* temp = 0;
+    int status = CV_NOTDEFINED_ERR;
+
+    CV_FUNCNAME("icvRecursiveGaussian");
+
+    __BEGIN__;
+
+    int cn = CV_MAT_CN(src->type);
+    int strips = (src->cols * cn + ICV_RECURSIVE_STRIP - 1)
+                 / ICV_RECURSIVE_STRIP;
+
+    CV_CALL(temp = cvCreateMat(src->rows, src->cols, CV_MAKETYPE(CV_32F, cn)));
+    band.src = src;
+    band.dst = dst;
+    band.temp = temp;
+    icvInitRecursiveGaussian(&band.gx, sigma_x);
+    icvInitRecursiveGaussian(&band.gy, sigma_y);
+
+    status = cvParallelFor(
+        cvSlice(0, strips), icvRecursiveGaussianColumns, &band,
+        CV_PARALLEL_GRAIN(src->rows * ICV_RECURSIVE_STRIP));
+    if (status >= 0)
+        status = cvParallelFor(cvSlice(0, src->rows), icvRecursiveGaussianRows,
+                               &band, CV_PARALLEL_GRAIN(src->cols * cn));
+
+    __END__;
+
+    cvReleaseMat(&temp);
+
+    return (CvStatus)status;
+}
+
 //////////////////////////////// IPP smoothing functions
 ////////////////////////////////////
 
@@ -1006,6 +1542,67 @@ typedef CvStatus(CV_STDCALL* CvSmoothFixedIPPFunc)(const void* src, int srcstep,
                                                    CvSize size, CvSize ksize,
                                                    CvPoint anchor);
 
+static bool icvSmoothOverlaps(const CvMat* src, const CvMat* dst)
+{
+    const uchar* src_end = src->data.ptr + (src->rows - 1) * src->step
+                           + src->cols * CV_ELEM_SIZE(src->type);
+    const uchar* dst_end = dst->data.ptr + (dst->rows - 1) * dst->step
+                           + dst->cols * CV_ELEM_SIZE(dst->type);
+
+    return src->data.ptr < dst_end && dst->data.ptr < src_end;
+}
+
+/* The box and gaussian filtering of a band of destination rows. Every band
+   runs its own filter over the source rows it needs, so the result is the
+   same as if the whole image was processed at once */
+typedef struct CvSmoothBand
+{
+    const CvMat* src;
+    CvMat* dst;
+    int smooth_type;
+    CvSize ksize;
+    const CvMat* kx;
+    const CvMat* ky;
+} CvSmoothBand;
+
+static int CV_CDECL icvSmoothBand(int y0, int y1, void* arg)
+{
+    const CvSmoothBand* p = (const CvSmoothBand*)arg;
+    CvBoxFilter box_filter;
+    CvSepFilter gaussian_filter;
+    CvBaseImageFilter* filter;
+    int status = CV_NOTDEFINED_ERR;
+
+    CV_FUNCNAME("icvSmoothBand");
+
+    __BEGIN__;
+
+    int src_type = CV_MAT_TYPE(p->src->type);
+    int dst_type = CV_MAT_TYPE(p->dst->type);
+
+    if (p->smooth_type == CV_GAUSSIAN)
+    {
+        CV_CALL(gaussian_filter.init(p->src->cols, src_type, dst_type, p->kx,
+                                     p->ky));
+        filter = &gaussian_filter;
+    }
+    else
+    {
+        CV_CALL(box_filter.init(p->src->cols, src_type, dst_type,
+                                p->smooth_type == CV_BLUR, p->ksize));
+        filter = &box_filter;
+    }
+
+    CV_CALL(filter->process(p->src, p->dst,
+                            cvRect(0, y0, p->src->cols, y1 - y0),
+                            cvPoint(0, y0), CV_SHARED_SRC));
+    status = CV_OK;
+
+    __END__;
+
+    return status;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
@@ -1024,9 +1621,9 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
     CvMat srcstub, *src = (CvMat*)srcarr;
     CvMat dststub, *dst = (CvMat*)dstarr;
     CvSize size;
-    int src_type, dst_type, depth, cn;
+    CvSmoothBand band;
+    int src_type, dst_type, depth, cn, grain;
     double sigma1 = 0, sigma2 = 0;
-    bool have_ipp = icvFilterMedian_8u_C1R_p != 0;
 
     CV_CALL(src = cvGetMat(src, &srcstub, &coi1));
     CV_CALL(dst = cvGetMat(dst, &dststub, &coi2));
@@ -1048,6 +1645,34 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
                  "The specified smoothing algorithm requires input and ouput "
                  "arrays be of the same type");
 
+    if (smooth_type == CV_GAUSSIAN_RECURSIVE)
+    {
+        // the kernel size is used only to derive the missing sigma
+        // the same way as in CV_GAUSSIAN
+        if (param2 == 0)
+            param2 = param1;
+        sigma1 = param3 > 0 ? param3
+                 : param1 > 0 ? (param1 / 2 - 1) * 0.3 + 0.8
+                              : 0;
+        sigma2 = param4 > 0 ? param4
+                 : param3 > 0 ? param3
+                 : param2 > 0 ? (param2 / 2 - 1) * 0.3 + 0.8
+                              : 0;
+
+        if (sigma1 <= 0 || sigma2 <= 0)
+            CV_ERROR(CV_StsOutOfRange,
+                     "Either sigma or the kernel size must be positive");
+
+        if (depth != CV_8U && depth != CV_16U && depth != CV_16F
+            && depth != CV_32F)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Recursive gaussian filter only supports 8u, 16u, 16f "
+                     "and 32f images");
+
+        IPPI_CALL(icvRecursiveGaussian(src, dst, sigma1, sigma2));
+        EXIT;
+    }
+
     if (smooth_type == CV_BLUR || smooth_type == CV_BLUR_NO_SCALE
         || smooth_type == CV_GAUSSIAN || smooth_type == CV_MEDIAN)
     {
@@ -1076,7 +1701,7 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         }
     }
 
-    if (have_ipp && (smooth_type == CV_BLUR || smooth_type == CV_MEDIAN)
+    if ((smooth_type == CV_BLUR || smooth_type == CV_MEDIAN)
         && size.width >= param1 && size.height >= param2 && param1 > 1
         && param2 > 1)
     {
@@ -1106,9 +1731,13 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         {
             CvSize el_size = {param1, param2};
             CvPoint el_anchor = {param1 / 2, param2 / 2};
+            // the optimal value may depend on CPU cache, overhead of the
+            // current IPP code etc. Every stripe repeats el_size.height-1
+            // rows of the previous one, so it should be several times higher
+            // than the kernel.
             int stripe_size =
-                1 << 14; // the optimal value may depend on CPU cache,
-                         // overhead of the current IPP code etc.
+                MAX(1 << 14, (src->cols + param1) * CV_ELEM_SIZE(src_type)
+                                 * param2 * 8);
             const uchar* shifted_ptr;
             int y, dy = 0;
             int temp_step, dst_step = dst->step;
@@ -1130,21 +1759,54 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         }
     }
 
+    band.src = src;
+    band.dst = dst;
+    band.smooth_type = smooth_type;
+    band.ksize = cvSize(param1, param2);
+    band.kx = band.ky = 0;
+    grain = CV_PARALLEL_GRAIN(size.width);
+
+    // the bands can not be computed in-place, and the running sums of the
+    // floating-point box filter would depend on where the bands start
+    if (icvSmoothOverlaps(src, dst)
+        || (smooth_type != CV_GAUSSIAN
+            && (depth == CV_32F || depth == CV_16F)))
+        grain = size.height;
+
     if (smooth_type == CV_BLUR || smooth_type == CV_BLUR_NO_SCALE)
     {
         CV_CALL(box_filter.init(src->cols, src_type, dst_type,
                                 smooth_type == CV_BLUR,
                                 cvSize(param1, param2)));
-        CV_CALL(box_filter.process(src, dst));
+        if (grain >= size.height)
+        {
+            CV_CALL(box_filter.process(src, dst));
+        }
+        else
+        {
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, size.height),
+                                              icvSmoothBand, &band, grain));
+        }
     }
     else if (smooth_type == CV_MEDIAN)
     {
-        if (depth != CV_8U || cn != 1 && cn != 3 && cn != 4)
+        if (depth != CV_8U && depth != CV_16U || cn != 1 && cn != 3 && cn != 4)
             CV_ERROR(CV_StsUnsupportedFormat,
-                     "Median filter only supports 8uC1, 8uC3 and 8uC4 images");
+                     "Median filter only supports 8u and 16u images with 1, 3 "
+                     "or 4 channels");
 
-        IPPI_CALL(icvMedianBlur_8u_CnR(src->data.ptr, src->step, dst->data.ptr,
-                                       dst->step, size, param1, cn));
+        if (depth == CV_8U)
+        {
+            IPPI_CALL(icvMedianBlur_8u_CnR(src->data.ptr, src->step,
+                                           dst->data.ptr, dst->step, size,
+                                           param1, cn));
+        }
+        else
+        {
+            IPPI_CALL(icvMedianBlur_16u_CnR(
+                (ushort*)src->data.ptr, src->step, (ushort*)dst->data.ptr,
+                dst->step, size, param1, cn));
+        }
     }
     else if (smooth_type == CV_GAUSSIAN)
     {
@@ -1160,7 +1822,7 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         else
             KY.data.fl = kx;
 
-        if (have_ipp && size.width >= param1 * 3 && size.height >= param2
+        if (size.width >= param1 * 3 && size.height >= param2
             && param1 > 1 && param2 > 1)
         {
             int done;
@@ -1172,7 +1834,17 @@ CV_IMPL void cvSmooth(const void* srcarr, void* dstarr, int smooth_type,
         }
 
         CV_CALL(gaussian_filter.init(src->cols, src_type, dst_type, &KX, &KY));
-        CV_CALL(gaussian_filter.process(src, dst));
+        band.kx = &KX;
+        band.ky = &KY;
+        if (grain >= size.height)
+        {
+            CV_CALL(gaussian_filter.process(src, dst));
+        }
+        else
+        {
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, size.height),
+                                              icvSmoothBand, &band, grain));
+        }
     }
     else if (smooth_type == CV_BILATERAL)
     {
@@ -58,7 +58,10 @@ static CvPluginFuncInfo cv_ipp_tab[] = {
 #undef _CV_IPP_H_
     {0, 0, 0, 0, 0}};
 
-static CvModuleInfo cv_info = {0, "cv", CV_VERSION, cv_ipp_tab};
+extern CvBuiltinFuncInfo cv_builtin_tab[];
+
+static CvModuleInfo cv_info = {0, "cv", CV_VERSION, cv_ipp_tab,
+                               cv_builtin_tab};
 CvModule cv_module(&cv_info);
 
 /* End of file. */
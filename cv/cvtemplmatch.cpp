@@ -315,12 +315,140 @@ icvCrossCorrValid_Norm_32f_C1R_t icvCrossCorrValid_Norm_32f_C1R_p = 0;
 icvCrossCorrValid_NormLevel_32f_C1R_t icvCrossCorrValid_NormLevel_32f_C1R_p = 0;
 icvSqrDistanceValid_Norm_32f_C1R_t icvSqrDistanceValid_Norm_32f_C1R_p = 0;
 
+icvCrossCorrRow_32f_C1R_t icvCrossCorrRow_32f_C1R_p = 0;
+
 typedef CvStatus(CV_STDCALL* CvTemplMatchIPPFunc)(
     const void* img, int imgstep, CvSize imgsize, const void* templ,
     int templstep, CvSize templsize, void* result, int rstep);
 
 /*****************************************************************************************/
 
+/* Converts the cross-correlation of the template with the image windows,
+   stored in result, to the measure of the method. sum and sqsum are the
+   integrals of the image (sqsum is not used by CV_TM_CCOEFF) and ofs is
+   the position of the top-left window of result in them */
+static void icvMatchTemplateNorm(CvMat* result, const CvMat* sum,
+                                 const CvMat* sqsum, CvPoint ofs,
+                                 CvSize templ_size, int cn, int method,
+                                 CvScalar templ_mean, CvScalar templ_sdv)
+{
+    int i, j, k;
+    double templ_norm = 0, templ_sum2 = 0;
+    int idx = 0, idx2 = 0;
+    double *p0, *p1, *p2, *p3;
+    double *q0, *q1, *q2, *q3;
+    double inv_area;
+    int sum_step, sqsum_step;
+    int num_type = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0
+                   : method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED
+                       ? 1
+                       : 2;
+    int is_normed = method == CV_TM_CCORR_NORMED
+                    || method == CV_TM_SQDIFF_NORMED
+                    || method == CV_TM_CCOEFF_NORMED;
+
+    if (method == CV_TM_CCORR)
+        return;
+
+    inv_area = 1. / ((double)templ_size.height * templ_size.width);
+
+    if (method == CV_TM_CCOEFF)
+        q0 = q1 = q2 = q3 = 0;
+    else
+    {
+        templ_norm = CV_SQR(templ_sdv.val[0]) + CV_SQR(templ_sdv.val[1])
+                     + CV_SQR(templ_sdv.val[2]) + CV_SQR(templ_sdv.val[3]);
+
+        if (templ_norm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED)
+        {
+            cvSet(result, cvScalarAll(1.));
+            return;
+        }
+
+        templ_sum2 = templ_norm + CV_SQR(templ_mean.val[0])
+                     + CV_SQR(templ_mean.val[1]) + CV_SQR(templ_mean.val[2])
+                     + CV_SQR(templ_mean.val[3]);
+
+        if (num_type != 1)
+        {
+            templ_mean = cvScalarAll(0);
+            templ_norm = templ_sum2;
+        }
+
+        templ_sum2 /= inv_area;
+        templ_norm = sqrt(templ_norm);
+        templ_norm /= sqrt(inv_area); // care of accuracy here
+
+        q0 = (double*)(sqsum->data.ptr + ofs.y * sqsum->step) + ofs.x * cn;
+        q1 = q0 + templ_size.width * cn;
+        q2 = (double*)((uchar*)q0 + templ_size.height * sqsum->step);
+        q3 = q2 + templ_size.width * cn;
+    }
+
+    p0 = (double*)(sum->data.ptr + ofs.y * sum->step) + ofs.x * cn;
+    p1 = p0 + templ_size.width * cn;
+    p2 = (double*)((uchar*)p0 + templ_size.height * sum->step);
+    p3 = p2 + templ_size.width * cn;
+
+    sum_step = sum ? sum->step / sizeof(double) : 0;
+    sqsum_step = sqsum ? sqsum->step / sizeof(double) : 0;
+
+    for (i = 0; i < result->rows; i++)
+    {
+        float* rrow = (float*)(result->data.ptr + i * result->step);
+        idx = i * sum_step;
+        idx2 = i * sqsum_step;
+
+        for (j = 0; j < result->cols; j++, idx += cn, idx2 += cn)
+        {
+            double num = rrow[j], t;
+            double wnd_mean2 = 0, wnd_sum2 = 0;
+
+            if (num_type == 1)
+            {
+                for (k = 0; k < cn; k++)
+                {
+                    t = p0[idx + k] - p1[idx + k] - p2[idx + k] + p3[idx + k];
+                    wnd_mean2 += CV_SQR(t);
+                    num -= t * templ_mean.val[k];
+                }
+
+                wnd_mean2 *= inv_area;
+            }
+
+            if (is_normed || num_type == 2)
+            {
+                for (k = 0; k < cn; k++)
+                {
+                    t = q0[idx2 + k] - q1[idx2 + k] - q2[idx2 + k]
+                        + q3[idx2 + k];
+                    wnd_sum2 += t;
+                }
+
+                if (num_type == 2)
+                    num = wnd_sum2 - 2 * num + templ_sum2;
+            }
+
+            if (is_normed)
+            {
+                t = sqrt(MAX(wnd_sum2 - wnd_mean2, 0)) * templ_norm;
+                if (t > DBL_EPSILON)
+                {
+                    num /= t;
+                    if (fabs(num) > 1.)
+                        num = num > 0 ? 1 : -1;
+                }
+                else
+                    num = method != CV_TM_SQDIFF_NORMED || num < DBL_EPSILON
+                              ? 0
+                              : 1;
+            }
+
+            rrow[j] = (float)num;
+        }
+    }
+}
+
 CV_IMPL void cvMatchTemplate(const CvArr* _img, const CvArr* _templ,
                              CvArr* _result, int method)
 {
@@ -333,22 +461,11 @@ CV_IMPL void cvMatchTemplate(const CvArr* _img, const CvArr* _templ,
 
     int coi1 = 0, coi2 = 0;
     int depth, cn;
-    int i, j, k;
+    int i, j;
     CvMat stub, *img = (CvMat*)_img;
     CvMat tstub, *templ = (CvMat*)_templ;
     CvMat rstub, *result = (CvMat*)_result;
-    CvScalar templ_mean = cvScalarAll(0);
-    double templ_norm = 0, templ_sum2 = 0;
-
-    int idx = 0, idx2 = 0;
-    double *p0, *p1, *p2, *p3;
-    double *q0, *q1, *q2, *q3;
-    double inv_area;
-    int sum_step, sqsum_step;
-    int num_type = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0
-                   : method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED
-                       ? 1
-                       : 2;
+    CvScalar templ_mean = cvScalarAll(0), templ_sdv = cvScalarAll(0);
     int is_normed = method == CV_TM_CCORR_NORMED
                     || method == CV_TM_SQDIFF_NORMED
                     || method == CV_TM_CCOEFF_NORMED;
@@ -432,120 +549,496 @@ CV_IMPL void cvMatchTemplate(const CvArr* _img, const CvArr* _templ,
     if (method == CV_TM_CCORR)
         EXIT;
 
-    inv_area = 1. / ((double)templ->rows * templ->cols);
-
     CV_CALL(sum = cvCreateMat(img->rows + 1, img->cols + 1,
                               CV_MAKETYPE(CV_64F, cn)));
     if (method == CV_TM_CCOEFF)
     {
         CV_CALL(cvIntegral(img, sum, 0, 0));
         CV_CALL(templ_mean = cvAvg(templ));
-        q0 = q1 = q2 = q3 = 0;
     }
     else
     {
-        CvScalar _templ_sdv = cvScalarAll(0);
         CV_CALL(sqsum = cvCreateMat(img->rows + 1, img->cols + 1,
                                     CV_MAKETYPE(CV_64F, cn)));
         CV_CALL(cvIntegral(img, sum, sqsum, 0));
-        CV_CALL(cvAvgSdv(templ, &templ_mean, &_templ_sdv));
+        CV_CALL(cvAvgSdv(templ, &templ_mean, &templ_sdv));
+    }
 
-        templ_norm = CV_SQR(_templ_sdv.val[0]) + CV_SQR(_templ_sdv.val[1])
-                     + CV_SQR(_templ_sdv.val[2]) + CV_SQR(_templ_sdv.val[3]);
+    icvMatchTemplateNorm(result, sum, sqsum, cvPoint(0, 0),
+                         cvGetMatSize(templ), cn, method, templ_mean,
+                         templ_sdv);
 
-        if (templ_norm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED)
-        {
-            cvSet(result, cvScalarAll(1.));
-            EXIT;
-        }
+    __END__;
 
-        templ_sum2 = templ_norm + CV_SQR(templ_mean.val[0])
-                     + CV_SQR(templ_mean.val[1]) + CV_SQR(templ_mean.val[2])
-                     + CV_SQR(templ_mean.val[3]);
+    cvReleaseMat(&sum);
+    cvReleaseMat(&sqsum);
+}
 
-        if (num_type != 1)
-        {
-            templ_mean = cvScalarAll(0);
-            templ_norm = templ_sum2;
-        }
+/******************************** Multi-Scale Search
+ * *************************************/
 
-        templ_sum2 /= inv_area;
-        templ_norm = sqrt(templ_norm);
-        templ_norm /= sqrt(inv_area); // care of accuracy here
+/* the template on the coarsest pyramid level searched has at least
+   ICV_MATCH_MIN_SIDE^2 pixels and no side shorter than ICV_MATCH_MIN_SIDE/2 */
+#define ICV_MATCH_MIN_SIDE 8
+#define ICV_MATCH_MAX_LEVELS 8
 
-        q0 = (double*)sqsum->data.ptr;
-        q1 = q0 + templ->cols * cn;
-        q2 = (double*)(sqsum->data.ptr + templ->rows * sqsum->step);
-        q3 = q2 + templ->cols * cn;
-    }
+/* the number of the coarse peaks refined on the finer levels */
+#define ICV_MATCH_CANDIDATES 8
 
-    p0 = (double*)sum->data.ptr;
-    p1 = p0 + templ->cols * cn;
-    p2 = (double*)(sum->data.ptr + templ->rows * sum->step);
-    p3 = p2 + templ->cols * cn;
+/* the peaks worse than the best one, or than the best match of the
+   previous scales, by more than this are not refined further */
+#define ICV_MATCH_PRUNE_MARGIN 0.15
 
-    sum_step = sum ? sum->step / sizeof(double) : 0;
-    sqsum_step = sqsum ? sqsum->step / sizeof(double) : 0;
+/* the radius of the window searched around a peak on the finer level */
+#define ICV_MATCH_REFINE_RADIUS 2
 
-    for (i = 0; i < result->rows; i++)
+/* the cost of the DFT correlation per image pixel and log2 of the
+   transform size, in direct correlation multiply-adds */
+#define ICV_MATCH_DFT_COST 16
+
+typedef struct CvMatchLevel
+{
+    CvMat* img;
+    CvMat* sum;
+    CvMat* sqsum;
+} CvMatchLevel;
+
+typedef struct CvMatchPeak
+{
+    CvPoint pt;
+    double score; // the larger the better for all the methods
+} CvMatchPeak;
+
+/* the direct cross-correlation of the template with all its positions in
+   img; img is (corr->cols + templ->cols - 1)x(corr->rows + templ->rows - 1).
+   Every template row is accumulated in single precision, as the DFT one
+   does, and the rows are summed up in double precision */
+static void icvMatchCorrDirect(const CvMat* img, const CvMat* templ,
+                               CvMat* corr)
+{
+    CvMat* fimg = 0;
+    CvMat* ftempl = 0;
+    double* buf = 0;
+
+    CV_FUNCNAME("icvMatchCorrDirect");
+
+    __BEGIN__;
+
+    int cn = CV_MAT_CN(img->type), width = corr->cols;
+    int x, y, i, j, tw = templ->cols * cn, th = templ->rows;
+    double* acc;
+    float* racc;
+
+    CV_CALL(fimg = cvCreateMat(img->rows, img->cols, CV_MAKETYPE(CV_32F, cn)));
+    CV_CALL(ftempl = cvCreateMat(th, templ->cols, CV_MAKETYPE(CV_32F, cn)));
+    CV_CALL(cvConvert(img, fimg));
+    CV_CALL(cvConvert(templ, ftempl));
+    CV_CALL(buf = (double*)cvAlloc(width * (sizeof(acc[0]) + sizeof(racc[0]))));
+    acc = buf;
+    racc = (float*)(acc + width);
+
+    for (y = 0; y < corr->rows; y++)
     {
-        float* rrow = (float*)(result->data.ptr + i * result->step);
-        idx = i * sum_step;
-        idx2 = i * sqsum_step;
+        float* crow = (float*)(corr->data.ptr + y * corr->step);
 
-        for (j = 0; j < result->cols; j++, idx += cn, idx2 += cn)
+        for (x = 0; x < width; x++)
+            acc[x] = 0;
+
+        for (i = 0; i < th; i++)
         {
-            double num = rrow[j], t;
-            double wnd_mean2 = 0, wnd_sum2 = 0;
+            const float* irow = (const float*)(fimg->data.ptr
+                                               + (y + i) * fimg->step);
+            const float* trow = (const float*)(ftempl->data.ptr
+                                               + i * ftempl->step);
 
-            if (num_type == 1)
+            if (cn == 1 && icvCrossCorrRow_32f_C1R_p)
             {
-                for (k = 0; k < cn; k++)
+                icvCrossCorrRow_32f_C1R_p(irow, trow, tw, racc, width);
+                for (x = 0; x < width; x++)
+                    acc[x] += racc[x];
+                continue;
+            }
+
+            // the sums of 4 adjacent positions stay in registers
+            for (x = 0; x <= width - 4; x += 4)
+            {
+                const float* src = irow + x * cn;
+                float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+                for (j = 0; j < tw; j++)
                 {
-                    t = p0[idx + k] - p1[idx + k] - p2[idx + k] + p3[idx + k];
-                    wnd_mean2 += CV_SQR(t);
-                    num -= t * templ_mean.val[k];
+                    float t = trow[j];
+                    s0 += t * src[j];
+                    s1 += t * src[j + cn];
+                    s2 += t * src[j + cn * 2];
+                    s3 += t * src[j + cn * 3];
                 }
+                racc[x] = s0;
+                racc[x + 1] = s1;
+                racc[x + 2] = s2;
+                racc[x + 3] = s3;
+            }
 
-                wnd_mean2 *= inv_area;
+            for (; x < width; x++)
+            {
+                const float* src = irow + x * cn;
+                float s0 = 0;
+
+                for (j = 0; j < tw; j++)
+                    s0 += trow[j] * src[j];
+                racc[x] = s0;
             }
 
-            if (is_normed || num_type == 2)
+            for (x = 0; x < width; x++)
+                acc[x] += racc[x];
+        }
+
+        for (x = 0; x < width; x++)
+            crow[x] = (float)acc[x];
+    }
+
+    __END__;
+
+    cvReleaseMat(&fimg);
+    cvReleaseMat(&ftempl);
+    cvFree(&buf);
+}
+
+/* computes the measure of the method for the template positions of rect
+   on the pyramid level, choosing the direct or the DFT correlation by the
+   cost. When the level has no integrals, they are computed for the window
+ */
+static void icvMatchWindow(const CvMatchLevel* level, const CvMat* templ,
+                           CvScalar mean, CvScalar sdv, int method,
+                           CvRect rect, CvMat* result)
+{
+    CvMat* lsum = 0;
+    CvMat* lsqsum = 0;
+
+    CV_FUNCNAME("icvMatchWindow");
+
+    __BEGIN__;
+
+    int cn = CV_MAT_CN(level->img->type);
+    CvMat roi, *sum = level->sum, *sqsum = level->sqsum;
+    CvPoint ofs = cvPoint(rect.x, rect.y);
+    double isz, direct_cost, dft_cost;
+
+    cvGetSubRect(level->img, &roi,
+                 cvRect(rect.x, rect.y, rect.width + templ->cols - 1,
+                        rect.height + templ->rows - 1));
+
+    isz = (double)roi.cols * roi.rows;
+    direct_cost = (double)rect.width * rect.height * templ->cols
+                  * templ->rows * cn;
+    dft_cost = ICV_MATCH_DFT_COST * isz * cn * (log(isz) / log(2.) + 1);
+
+    if (direct_cost <= dft_cost)
+    {
+        CV_CALL(icvMatchCorrDirect(&roi, templ, result));
+    }
+    else
+    {
+        CV_CALL(icvCrossCorr(&roi, templ, result));
+    }
+
+    if (!sum)
+    {
+        CV_CALL(lsum = cvCreateMat(roi.rows + 1, roi.cols + 1,
+                                   CV_MAKETYPE(CV_64F, cn)));
+        CV_CALL(lsqsum = cvCreateMat(roi.rows + 1, roi.cols + 1,
+                                     CV_MAKETYPE(CV_64F, cn)));
+        CV_CALL(cvIntegral(&roi, lsum, lsqsum, 0));
+        sum = lsum;
+        sqsum = lsqsum;
+        ofs = cvPoint(0, 0);
+    }
+
+    icvMatchTemplateNorm(result, sum, sqsum, ofs, cvGetMatSize(templ), cn,
+                         method, mean, sdv);
+
+    __END__;
+
+    cvReleaseMat(&lsum);
+    cvReleaseMat(&lsqsum);
+}
+
+/* collects up to max_count best local peaks of sign*result that are
+   further than min_dist from each other, the best first */
+static int icvFindMatchPeaks(const CvMat* result, double sign, int min_dist,
+                             CvMatchPeak* peaks, int max_count)
+{
+    int x, y, i, count = 0;
+
+    for (y = 0; y < result->rows; y++)
+    {
+        const float* rrow = (const float*)(result->data.ptr
+                                           + y * result->step);
+
+        for (x = 0; x < result->cols; x++)
+        {
+            double score = sign * rrow[x];
+
+            if (count == max_count && score <= peaks[count - 1].score)
+                continue;
+
+            // a close peak is replaced by the better one
+            for (i = 0; i < count; i++)
+                if (abs(peaks[i].pt.x - x) < min_dist
+                    && abs(peaks[i].pt.y - y) < min_dist)
+                    break;
+
+            if (i < count)
             {
-                for (k = 0; k < cn; k++)
-                {
-                    t = q0[idx2 + k] - q1[idx2 + k] - q2[idx2 + k]
-                        + q3[idx2 + k];
-                    wnd_sum2 += t;
-                }
+                if (score <= peaks[i].score)
+                    continue;
+            }
+            else if (count < max_count)
+                i = count++;
+            else
+                i = count - 1;
+
+            for (; i > 0 && peaks[i - 1].score < score; i--)
+                peaks[i] = peaks[i - 1];
+            peaks[i].pt = cvPoint(x, y);
+            peaks[i].score = score;
+        }
+    }
 
-                if (num_type == 2)
-                    num = wnd_sum2 - 2 * num + templ_sum2;
+    return count;
+}
+
+/* drops the peaks worse than the best one or than best_score by more than
+   the margin */
+static int icvPruneMatchPeaks(CvMatchPeak* peaks, int count,
+                              double best_score)
+{
+    int i, k = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (peaks[i].score >= peaks[0].score - ICV_MATCH_PRUNE_MARGIN
+            && peaks[i].score >= best_score - ICV_MATCH_PRUNE_MARGIN)
+            peaks[k++] = peaks[i];
+    }
+
+    return k;
+}
+
+CV_IMPL CvTemplMatch cvMatchTemplateMultiScale(const CvArr* _img,
+                                               const CvArr* _templ, int method,
+                                               double min_scale,
+                                               double max_scale,
+                                               double scale_step,
+                                               double stop_score)
+{
+    CvTemplMatch match;
+    CvMatchLevel levels[ICV_MATCH_MAX_LEVELS];
+    CvMat* ltempl[ICV_MATCH_MAX_LEVELS];
+    CvMat* result = 0;
+    CvImagePyramid* pyr = 0;
+    int nlevels = 0, l;
+
+    CV_FUNCNAME("cvMatchTemplateMultiScale");
+
+    memset(levels, 0, sizeof(levels));
+    memset(ltempl, 0, sizeof(ltempl));
+    match.rect = cvRect(0, 0, 0, 0);
+    match.scale = 0;
+    match.score = method == CV_TM_SQDIFF_NORMED ? DBL_MAX : -DBL_MAX;
+
+    __BEGIN__;
+
+    CvMat stub, tstub, *img = (CvMat*)_img, *templ = (CvMat*)_templ;
+    double sign = method == CV_TM_SQDIFF_NORMED ? -1 : 1;
+    double best_score = -DBL_MAX;
+    int i, k, n, scale_count, cn;
+    CvMatchPeak coarse_peaks[ICV_MATCH_CANDIDATES];
+    CvSize coarse_size = cvSize(0, 0);
+    int coarse_top = -1, coarse_count = 0;
+
+    CV_CALL(img = cvGetMat(img, &stub));
+    CV_CALL(templ = cvGetMat(templ, &tstub));
+
+    if (CV_MAT_DEPTH(img->type) != CV_8U && CV_MAT_DEPTH(img->type) != CV_32F)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "The function supports only 8u and 32f data types");
+
+    if (!CV_ARE_TYPES_EQ(img, templ))
+        CV_ERROR(CV_StsUnmatchedFormats,
+                 "image and template should have the same type");
+
+    if (method != CV_TM_SQDIFF_NORMED && method != CV_TM_CCORR_NORMED
+        && method != CV_TM_CCOEFF_NORMED)
+        CV_ERROR(CV_StsBadArg,
+                 "Only the normed methods are comparable across the scales");
+
+    if (min_scale <= 0 || max_scale < min_scale
+        || (scale_step <= 1 && max_scale > min_scale))
+        CV_ERROR(CV_StsOutOfRange, "Incorrect scale range or scale step");
+
+    cn = CV_MAT_CN(img->type);
+    scale_count = max_scale > min_scale
+                      ? cvFloor(log(max_scale / min_scale) / log(scale_step)
+                                + 1e-6)
+                            + 1
+                      : 1;
+
+    levels[0].img = img;
+    nlevels = 1;
+
+    for (n = 0; n < scale_count; n++)
+    {
+        double scale = min_scale * pow(scale_step, n);
+        CvSize tsize = cvSize(cvRound(templ->cols * scale),
+                              cvRound(templ->rows * scale));
+        CvScalar mean[ICV_MATCH_MAX_LEVELS], sdv[ICV_MATCH_MAX_LEVELS];
+        CvMatchPeak peaks[ICV_MATCH_CANDIDATES];
+        int top, count;
+
+        if (tsize.width < 1 || tsize.height < 1 || tsize.width > img->cols
+            || tsize.height > img->rows)
+            continue;
+
+        // the coarsest level where the template is still recognizable
+        for (top = 0; top + 1 < ICV_MATCH_MAX_LEVELS; top++)
+        {
+            int w = tsize.width >> (top + 1), h = tsize.height >> (top + 1);
+            if (w * h < ICV_MATCH_MIN_SIDE * ICV_MATCH_MIN_SIDE
+                || MIN(w, h) < ICV_MATCH_MIN_SIDE / 2)
+                break;
+        }
+
+        // the pyramid is built once and shared by all the scales; its
+        // buffers are recycled between the calls
+        for (; nlevels <= top; nlevels++)
+        {
+            if (!pyr)
+            {
+                CV_CALL(pyr = cvCreateImagePyramid(ICV_MATCH_MAX_LEVELS));
+                CV_CALL(cvSetPyramidImage(pyr, img));
             }
+            CV_CALL(levels[nlevels].img =
+                        (CvMat*)cvGetPyramidLevel(pyr, nlevels));
+        }
 
-            if (is_normed)
+        for (l = 0; l <= top; l++)
+        {
+            int w = MAX(cvRound(tsize.width / (double)(1 << l)), 1);
+            int h = MAX(cvRound(tsize.height / (double)(1 << l)), 1);
+
+            cvReleaseMat(&ltempl[l]);
+            CV_CALL(ltempl[l] = cvCreateMat(h, w, templ->type));
+            CV_CALL(cvResize(templ, ltempl[l],
+                             w < templ->cols ? CV_INTER_AREA
+                                             : CV_INTER_LINEAR));
+            CV_CALL(cvAvgSdv(ltempl[l], &mean[l], &sdv[l]));
+        }
+
+        // the whole coarsest level is searched; its integrals are reused
+        // by the following scales. The close scales give coarse templates
+        // that differ by a pixel at most, and the peaks found with one of
+        // them are refined with the exact templates of the others
+        if (top == coarse_top
+            && abs(ltempl[top]->cols - coarse_size.width) <= 1
+            && abs(ltempl[top]->rows - coarse_size.height) <= 1)
+            goto refine;
+
+        if (!levels[top].sum)
+        {
+            CvMat* limg = levels[top].img;
+            CV_CALL(levels[top].sum = cvCreateMat(limg->rows + 1,
+                                                  limg->cols + 1,
+                                                  CV_MAKETYPE(CV_64F, cn)));
+            CV_CALL(levels[top].sqsum = cvCreateMat(limg->rows + 1,
+                                                    limg->cols + 1,
+                                                    CV_MAKETYPE(CV_64F, cn)));
+            CV_CALL(cvIntegral(limg, levels[top].sum, levels[top].sqsum, 0));
+        }
+
+        CV_CALL(result = cvCreateMat(
+                    levels[top].img->rows - ltempl[top]->rows + 1,
+                    levels[top].img->cols - ltempl[top]->cols + 1,
+                    CV_32FC1));
+        CV_CALL(icvMatchWindow(&levels[top], ltempl[top], mean[top],
+                               sdv[top], method,
+                               cvRect(0, 0, result->cols, result->rows),
+                               result));
+        coarse_count = icvFindMatchPeaks(
+            result, sign,
+            MAX(MIN(ltempl[top]->cols, ltempl[top]->rows) / 2, 1),
+            coarse_peaks, top > 0 ? ICV_MATCH_CANDIDATES : 1);
+        coarse_top = top;
+        coarse_size = cvGetMatSize(ltempl[top]);
+        cvReleaseMat(&result);
+
+    refine:
+        memcpy(peaks, coarse_peaks, coarse_count * sizeof(peaks[0]));
+        count = icvPruneMatchPeaks(peaks, coarse_count, best_score);
+
+        // refine the peaks level by level in the small windows around them
+        for (l = top - 1; l >= 0 && count > 0; l--)
+        {
+            const int r = ICV_MATCH_REFINE_RADIUS;
+            float buf[(2 * r + 1) * (2 * r + 1)];
+            int max_x = levels[l].img->cols - ltempl[l]->cols;
+            int max_y = levels[l].img->rows - ltempl[l]->rows;
+
+            for (i = 0; i < count; i++)
             {
-                t = sqrt(MAX(wnd_sum2 - wnd_mean2, 0)) * templ_norm;
-                if (t > DBL_EPSILON)
-                {
-                    num /= t;
-                    if (fabs(num) > 1.)
-                        num = num > 0 ? 1 : -1;
-                }
-                else
-                    num = method != CV_TM_SQDIFF_NORMED || num < DBL_EPSILON
-                              ? 0
-                              : 1;
+                int cx = MIN(peaks[i].pt.x * 2, max_x);
+                int cy = MIN(peaks[i].pt.y * 2, max_y);
+                CvRect rect;
+                CvMatchPeak best;
+                CvMat win;
+
+                rect.x = MAX(cx - r, 0);
+                rect.y = MAX(cy - r, 0);
+                rect.width = MIN(cx + r, max_x) - rect.x + 1;
+                rect.height = MIN(cy + r, max_y) - rect.y + 1;
+                cvInitMatHeader(&win, rect.height, rect.width, CV_32FC1, buf);
+                CV_CALL(icvMatchWindow(&levels[l], ltempl[l], mean[l],
+                                       sdv[l], method, rect, &win));
+                icvFindMatchPeaks(&win, sign, 1, &best, 1);
+                peaks[i].pt = cvPoint(rect.x + best.pt.x, rect.y + best.pt.y);
+                peaks[i].score = best.score;
             }
 
-            rrow[j] = (float)num;
+            for (i = 1; i < count; i++)
+            {
+                CvMatchPeak t = peaks[i];
+                for (k = i; k > 0 && peaks[k - 1].score < t.score; k--)
+                    peaks[k] = peaks[k - 1];
+                peaks[k] = t;
+            }
+            count = icvPruneMatchPeaks(peaks, count, best_score);
+        }
+
+        if (count > 0 && peaks[0].score > best_score)
+        {
+            best_score = peaks[0].score;
+            match.rect = cvRect(peaks[0].pt.x, peaks[0].pt.y, ltempl[0]->cols,
+                                ltempl[0]->rows);
+            match.scale = scale;
+            match.score = sign * best_score;
+
+            if (stop_score > 0 && best_score >= sign * stop_score)
+                break;
         }
     }
 
     __END__;
 
-    cvReleaseMat(&sum);
-    cvReleaseMat(&sqsum);
+    for (l = 0; l < ICV_MATCH_MAX_LEVELS; l++)
+    {
+        cvReleaseMat(&levels[l].sum);
+        cvReleaseMat(&levels[l].sqsum);
+        cvReleaseMat(&ltempl[l]);
+    }
+    cvReleaseMat(&result);
+    cvReleaseImagePyramid(&pyr);
+
+    return match;
 }
 
 /* End of file. */
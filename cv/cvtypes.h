@@ -69,6 +69,14 @@ typedef struct CvHuMoments
     double hu1, hu2, hu3, hu4, hu5, hu6, hu7; /* Hu invariants */
 } CvHuMoments;
 
+/* The best match found by cvMatchTemplateMultiScale */
+typedef struct CvTemplMatch
+{
+    CvRect rect;  /* the matched image region (the size of scaled template) */
+    double scale; /* the template scale */
+    double score; /* the measure of the comparison method */
+} CvTemplMatch;
+
 /**************************** Connected Component
  * **************************************/
 
@@ -82,6 +90,16 @@ typedef struct CvConnectedComp
                       the holes)*/
 } CvConnectedComp;
 
+/* statistics of a component labeled by cvConnectedComponents */
+typedef struct CvComponentStats
+{
+    int area;              /* number of pixels */
+    CvRect rect;           /* bounding box */
+    CvPoint2D64f centroid; /* mean of the pixel coordinates */
+    CvPoint start;         /* the first pixel of the component in raster
+                              order */
+} CvComponentStats;
+
 /*
 Internal structure that is used for sequental retrieving contours from the
 image. It supports both hierarchical and plane variants of Suzuki algorithm.
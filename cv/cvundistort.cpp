@@ -51,7 +51,8 @@ direct,
 static CvStatus icvUnDistort_8u_CnR(const uchar* src, int srcstep, uchar* dst,
                                     int dststep, CvSize size,
                                     const float* intrinsic_matrix,
-                                    const float* dist_coeffs, int cn)
+                                    const float* dist_coeffs, int cn,
+                                    CvSlice rows)
 {
     int u, v, i;
     float u0 = intrinsic_matrix[2], v0 = intrinsic_matrix[5];
@@ -62,8 +63,9 @@ static CvStatus icvUnDistort_8u_CnR(const uchar* src, int srcstep, uchar* dst,
 
     srcstep /= sizeof(src[0]);
     dststep /= sizeof(dst[0]);
+    dst += rows.start_index * dststep;
 
-    for (v = 0; v < size.height; v++, dst += dststep)
+    for (v = rows.start_index; v < rows.end_index; v++, dst += dststep)
     {
         float y = (v - v0) * _fy;
         float y2 = y * y;
@@ -117,6 +119,29 @@ static CvStatus icvUnDistort_8u_CnR(const uchar* src, int srcstep, uchar* dst,
     return CV_OK;
 }
 
+/* The arguments of icvUnDistort_8u_CnR shared by the bands of destination
+   rows */
+typedef struct CvUndistortBand
+{
+    const uchar* src;
+    int srcstep;
+    uchar* dst;
+    int dststep;
+    CvSize size;
+    const float* intrinsic_matrix;
+    const float* dist_coeffs;
+    int cn;
+} CvUndistortBand;
+
+static int CV_CDECL icvUndistortBand(int v0, int v1, void* arg)
+{
+    const CvUndistortBand* p = (const CvUndistortBand*)arg;
+
+    return icvUnDistort_8u_CnR(p->src, p->srcstep, p->dst, p->dststep,
+                               p->size, p->intrinsic_matrix, p->dist_coeffs,
+                               p->cn, cvSlice(v0, v1));
+}
+
 icvUndistortGetSize_t icvUndistortGetSize_p = 0;
 icvCreateMapCameraUndistort_32f_C1R_t icvCreateMapCameraUndistort_32f_C1R_p = 0;
 icvUndistortRadial_8u_C1R_t icvUndistortRadial_8u_C1R_p = 0;
@@ -143,6 +168,7 @@ CV_IMPL void cvUndistort2(const CvArr* _src, CvArr* _dst, const CvMat* A,
     CvMat _a = cvMat(3, 3, CV_32F, a), _k;
     int cn, src_step, dst_step;
     CvSize size;
+    CvUndistortBand band;
 
     if (!inittab)
     {
@@ -213,8 +239,16 @@ CV_IMPL void cvUndistort2(const CvArr* _src, CvArr* _dst, const CvMat* A,
         }
     }
 
-    icvUnDistort_8u_CnR(src->data.ptr, src_step, dst->data.ptr, dst_step, size,
-                        a, k, cn);
+    band.src = src->data.ptr;
+    band.srcstep = src_step;
+    band.dst = dst->data.ptr;
+    band.dststep = dst_step;
+    band.size = size;
+    band.intrinsic_matrix = a;
+    band.dist_coeffs = k;
+    band.cn = cn;
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, size.height), icvUndistortBand,
+                                      &band, CV_PARALLEL_GRAIN(size.width)));
 
     __END__;
 
@@ -237,24 +271,39 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
     float *mapx, *mapy;
     CvMat _a = cvMat(3, 3, CV_32F, a), _k;
     int mapxstep, mapystep;
-    int u, v;
+    int u, v, fixed;
     float u0, v0, fx, fy, _fx, _fy, k1, k2, p1, p2;
     CvSize size;
 
     CV_CALL(_mapx = cvGetMat(_mapx, &mapxstub, &coi1));
-    CV_CALL(_mapy = cvGetMat(_mapy, &mapystub, &coi2));
+    fixed = CV_MAT_TYPE(_mapx->type) == CV_16SC2;
+    if (_mapy || !fixed)
+        CV_CALL(_mapy = cvGetMat(_mapy, &mapystub, &coi2));
 
     if (coi1 != 0 || coi2 != 0)
         CV_ERROR(CV_BadCOI, "The function does not support COI");
 
-    if (CV_MAT_TYPE(_mapx->type) != CV_32FC1)
-        CV_ERROR(CV_StsUnsupportedFormat, "Both maps must have 32fC1 type");
+    if (fixed)
+    {
+        if (_mapy && CV_MAT_TYPE(_mapy->type) != CV_16UC1)
+            CV_ERROR(CV_StsUnmatchedFormats,
+                     "The fixed-point maps must have 16sC2 and 16uC1 types");
 
-    if (!CV_ARE_TYPES_EQ(_mapx, _mapy))
-        CV_ERROR(CV_StsUnmatchedFormats, "");
+        if (_mapy && !CV_ARE_SIZES_EQ(_mapx, _mapy))
+            CV_ERROR(CV_StsUnmatchedSizes, "");
+    }
+    else
+    {
+        if (CV_MAT_TYPE(_mapx->type) != CV_32FC1)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "Both maps must have 32fC1 type");
 
-    if (!CV_ARE_SIZES_EQ(_mapx, _mapy))
-        CV_ERROR(CV_StsUnmatchedSizes, "");
+        if (!CV_ARE_TYPES_EQ(_mapx, _mapy))
+            CV_ERROR(CV_StsUnmatchedFormats, "");
+
+        if (!CV_ARE_SIZES_EQ(_mapx, _mapy))
+            CV_ERROR(CV_StsUnmatchedSizes, "");
+    }
 
     if (!CV_IS_MAT(A) || A->rows != 3 || A->cols != 3
         || CV_MAT_TYPE(A->type) != CV_32FC1 && CV_MAT_TYPE(A->type) != CV_64FC1)
@@ -287,13 +336,24 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
     p1 = k[2];
     p2 = k[3];
 
-    mapxstep = _mapx->step ? _mapx->step : CV_STUB_STEP;
-    mapystep = _mapy->step ? _mapy->step : CV_STUB_STEP;
-    mapx = _mapx->data.fl;
-    mapy = _mapy->data.fl;
-
     size = cvGetMatSize(_mapx);
 
+    if (fixed)
+    {
+        // compute a row of the floating-point maps at a time and convert it
+        CV_CALL(buffer = (uchar*)cvAlloc(size.width * 2 * sizeof(float)));
+        mapxstep = mapystep = 0;
+        mapx = (float*)buffer;
+        mapy = mapx + size.width;
+    }
+    else
+    {
+        mapxstep = _mapx->step ? _mapx->step : CV_STUB_STEP;
+        mapystep = _mapy->step ? _mapy->step : CV_STUB_STEP;
+        mapx = _mapx->data.fl;
+        mapy = _mapy->data.fl;
+    }
+
     /*if( icvUndistortGetSize_p && icvCreateMapCameraUndistort_32f_C1R_p )
     {
         int buf_size = 0;
@@ -329,6 +389,12 @@ CV_IMPL void cvInitUndistortMap(const CvMat* A, const CvMat* dist_coeffs,
             mapx[u] = _u;
             mapy[u] = _v;
         }
+
+        if (fixed)
+            icvConvertMapsRow(
+                mapx, mapy, (short*)(_mapx->data.ptr + _mapx->step * v),
+                _mapy ? (ushort*)(_mapy->data.ptr + _mapy->step * v) : 0,
+                size.width);
     }
 
     __END__;
@@ -0,0 +1,10 @@
+/* The helpers of cxcore/tests/cvtest_util.h for the tests of cv. */
+
+#ifndef _CV_CVTEST_UTIL_H_
+#define _CV_CVTEST_UTIL_H_
+
+#include "cv.h"
+
+#include "../../cxcore/tests/cvtest_util.h"
+
+#endif /* _CV_CVTEST_UTIL_H_ */
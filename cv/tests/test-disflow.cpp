@@ -0,0 +1,168 @@
+/* Measures the endpoint error and the speed of cvCalcOpticalFlowDIS on
+   synthetic motion at 2048x1080.
+
+   g++ -O2 test-disflow.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   prev is curr warped by the known flow, prev(x) = curr(x + flow(x)), over
+   a multi-scale texture. The error is the mean endpoint error (EPE) in
+   pixels, away from the 32-pixel border where the content enters the
+   frame. The times are the best of a few calls that build both pyramids,
+   with the built-in kernels on and off; a sequence that reuses the pyramid
+   of prev (CV_LKFLOW_PYR_A_READY) saves one pyramid per frame.
+   The EPE of every preset must stay within the limits below. */
+
+#include "cvtest_util.h"
+
+#include <math.h>
+
+#define BORDER 32
+
+/* noise at 1/16, 1/4 and full resolution, smoothed a little */
+static void make_texture(CvMat* img)
+{
+    CvMat* acc = cvCreateMat(img->rows, img->cols, CV_32FC1);
+    CvMat* up = cvCreateMat(img->rows, img->cols, CV_32FC1);
+    CvRNG rng = cvRNG(12345);
+    int scale;
+
+    cvZero(acc);
+    for (scale = 16; scale >= 1; scale /= 4)
+    {
+        CvMat* small =
+            cvCreateMat(img->rows / scale, img->cols / scale, CV_32FC1);
+        cvRandArr(&rng, small, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(1));
+        cvResize(small, up, CV_INTER_CUBIC);
+        cvScaleAdd(up, cvRealScalar(scale == 1 ? 0.2 : 0.4), acc, acc);
+        cvReleaseMat(&small);
+    }
+
+    cvSmooth(acc, acc, CV_GAUSSIAN, 3, 3);
+    cvConvertScale(acc, img, 255);
+
+    cvReleaseMat(&acc);
+    cvReleaseMat(&up);
+}
+
+/* kind 0 is a rotation and zoom around the center plus the shift, with
+   the largest displacement amp; kind 1 is a sine wave of amp pixels */
+static void make_flow(CvMat* u, CvMat* v, int kind, double amp)
+{
+    double cx = u->cols * 0.5, cy = u->rows * 0.5, r = sqrt(cx * cx + cy * cy);
+    int x, y;
+
+    for (y = 0; y < u->rows; y++)
+        for (x = 0; x < u->cols; x++)
+        {
+            double dx = x - cx, dy = y - cy, fu, fv;
+            if (kind == 0)
+            {
+                // a third of amp is the shift, the rest grows to the corners
+                double a = amp * 2 / 3 / r;
+                fu = amp / 3 + a * (0.6 * dx - 0.8 * dy);
+                fv = -amp / 3 + a * (0.8 * dx + 0.6 * dy);
+            }
+            else
+            {
+                fu = amp * sin(y * CV_PI / 180);
+                fv = amp * 0.5 * cos(x * CV_PI / 256);
+            }
+            CV_MAT_ELEM(*u, float, y, x) = (float)fu;
+            CV_MAT_ELEM(*v, float, y, x) = (float)fv;
+        }
+}
+
+static double calc_epe(const CvMat* u0, const CvMat* v0, const CvMat* u1,
+                       const CvMat* v1)
+{
+    double sum = 0;
+    int x, y, count = 0;
+
+    for (y = BORDER; y < u0->rows - BORDER; y++)
+        for (x = BORDER; x < u0->cols - BORDER; x++)
+        {
+            double du = CV_MAT_ELEM(*u0, float, y, x)
+                        - CV_MAT_ELEM(*u1, float, y, x);
+            double dv = CV_MAT_ELEM(*v0, float, y, x)
+                        - CV_MAT_ELEM(*v1, float, y, x);
+            sum += sqrt(du * du + dv * dv);
+            count++;
+        }
+
+    return sum / count;
+}
+
+int main(int, char**)
+{
+    static const char* presets[] = {"ultrafast", "fast", "medium"};
+    static const double max_epe[] = {1.5, 1.0, 0.5};
+    static const struct
+    {
+        const char* name;
+        int kind;
+        double amp;
+    } motions[] = {{"affine, 2 px", 0, 2},  {"affine, 8 px", 0, 8},
+                   {"affine, 24 px", 0, 24}, {"sine, 8 px", 1, 8},
+                   {"sine, 24 px", 1, 24}};
+    CvSize size = cvSize(2048, 1080);
+    CvMat* curr = cvCreateMat(size.height, size.width, CV_8UC1);
+    CvMat* prev = cvCreateMat(size.height, size.width, CV_8UC1);
+    CvMat* u0 = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvMat* v0 = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvMat* u = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvMat* v = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvMat* mapx = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvMat* mapy = cvCreateMat(size.height, size.width, CV_32FC1);
+    CvDISOpticalFlow* dis[3];
+    int i, j, x, y;
+
+    make_texture(curr);
+    for (j = 0; j < 3; j++)
+        dis[j] = cvCreateDISOpticalFlow(j);
+
+    printf("%-14s %-10s %7s %9s %9s %9s\n", "motion", "preset", "EPE",
+           "SIMD ms", "C ms", "SIMD fps");
+
+    for (i = 0; i < 5; i++)
+    {
+        make_flow(u0, v0, motions[i].kind, motions[i].amp);
+        for (y = 0; y < size.height; y++)
+            for (x = 0; x < size.width; x++)
+            {
+                CV_MAT_ELEM(*mapx, float, y, x) =
+                    x + CV_MAT_ELEM(*u0, float, y, x);
+                CV_MAT_ELEM(*mapy, float, y, x) =
+                    y + CV_MAT_ELEM(*v0, float, y, x);
+            }
+        cvRemap(curr, prev, mapx, mapy, CV_INTER_LINEAR, cvScalarAll(0));
+
+        for (j = 0; j < 3; j++)
+        {
+            double t0, t1, epe;
+
+            cvUseOptimized(0);
+            CVTEST_BEST_TIME(t0, 3, cvCalcOpticalFlowDIS(dis[j], prev, curr,
+                                                         u, v, 0));
+            cvUseOptimized(1);
+            CVTEST_BEST_TIME(t1, 3, cvCalcOpticalFlowDIS(dis[j], prev, curr,
+                                                         u, v, 0));
+
+            epe = calc_epe(u0, v0, u, v);
+            printf("%-14s %-10s %7.3f %9.1f %9.1f %9.1f%s\n", motions[i].name,
+                   presets[j], epe, t1, t0, 1000. / t1,
+                   cvtest_check(epe <= max_epe[j]));
+        }
+    }
+
+    for (j = 0; j < 3; j++)
+        cvReleaseDISOpticalFlow(&dis[j]);
+    cvReleaseMat(&curr);
+    cvReleaseMat(&prev);
+    cvReleaseMat(&u0);
+    cvReleaseMat(&v0);
+    cvReleaseMat(&u);
+    cvReleaseMat(&v);
+    cvReleaseMat(&mapx);
+    cvReleaseMat(&mapy);
+
+    return cvtest_report();
+}
@@ -0,0 +1,66 @@
+/* Compares the recursive gaussian (CV_GAUSSIAN_RECURSIVE) with the exact
+   separable one on a 4K frame and times both.
+
+   g++ -O2 test-gaussian.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   The exact filter is CV_GAUSSIAN with the kernel size 2*ceil(4*sigma)+1,
+   run on 32f. The 32f result of the recursive filter must stay within 0.05
+   gray levels of it, the 8u one within 1 level. The exact 32f filter of the
+   large sigmas takes a while. */
+
+#include "cvtest_util.h"
+
+int main(int, char**)
+{
+    static const double sigmas[] = {2, 5, 20, 50, 100};
+    CvSize size = cvSize(3840, 2160);
+    CvMat* src8u = cvCreateMat(size.height, size.width, CV_8UC3);
+    CvMat* src32f = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* exact = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* dst32f = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* dst8u = cvCreateMat(size.height, size.width, CV_8UC3);
+    CvMat* exact8u = cvCreateMat(size.height, size.width, CV_8UC3);
+    CvRNG rng = cvRNG(-1);
+    int i;
+
+    cvRandArr(&rng, src8u, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(256));
+    cvConvert(src8u, src32f);
+
+    printf("%6s %6s %9s %9s %9s %9s %9s %9s %9s\n", "sigma", "ksize",
+           "max diff", "mean diff", "8u diff", "exact 32f", "recur 32f",
+           "exact 8u", "recur 8u");
+
+    for (i = 0; i < 5; i++)
+    {
+        double sigma = sigmas[i], max_diff, mean_diff, diff8u;
+        int ksize = cvCeil(sigma * 4) * 2 + 1;
+        double t0, t1, t2, t3;
+
+        CVTEST_BEST_TIME(t0, 1, cvSmooth(src32f, exact, CV_GAUSSIAN, ksize,
+                                         ksize, sigma, sigma));
+        CVTEST_BEST_TIME(t1, 3, cvSmooth(src32f, dst32f, CV_GAUSSIAN_RECURSIVE,
+                                         0, 0, sigma, sigma));
+        CVTEST_BEST_TIME(t2, 1, cvSmooth(src8u, exact8u, CV_GAUSSIAN, ksize,
+                                         ksize, sigma, sigma));
+        CVTEST_BEST_TIME(t3, 3, cvSmooth(src8u, dst8u, CV_GAUSSIAN_RECURSIVE,
+                                         0, 0, sigma, sigma));
+
+        max_diff = cvNorm(exact, dst32f, CV_C);
+        mean_diff = cvNorm(exact, dst32f, CV_L1) / (size.width * size.height * 3);
+        cvConvert(exact, exact8u);
+        diff8u = cvNorm(exact8u, dst8u, CV_C);
+
+        printf("%6g %6d %9.3f %9.4f %9g %8.0fms %7.0fms %7.0fms %7.0fms%s\n",
+               sigma, ksize, max_diff, mean_diff, diff8u, t0, t1, t2, t3,
+               cvtest_check(max_diff <= 0.05 && diff8u <= 1));
+    }
+
+    cvReleaseMat(&src8u);
+    cvReleaseMat(&src32f);
+    cvReleaseMat(&exact);
+    cvReleaseMat(&dst32f);
+    cvReleaseMat(&dst8u);
+    cvReleaseMat(&exact8u);
+
+    return cvtest_report();
+}
@@ -0,0 +1,183 @@
+/* Times cvHaarDetectObjects per 1920x1080 frame with the built-in stump
+   evaluator off (cvUseOptimized(0)) and on, and checks that both find the
+   same objects.
+
+   g++ -O2 test-haar.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   The cascade is synthetic, with the stage sizes of the frontal face
+   cascade (25 stages, 2913 stumps on a 24x24 window) and random two- and
+   three-rectangle features; it is written to a file storage and read back
+   with cvLoad. The stage thresholds reject most windows of the textured
+   frame in the first stages and let a few tens pass all of them. The
+   times are the best of 3 with scale 1.1 and min_neighbors 3. Pass a
+   number of threads as the argument to run on more than one; the
+   reference detections always come from one thread. */
+
+#include "cvtest_util.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* a random haar-like feature of 2 or 3 rectangles within the window */
+static void write_feature(CvFileStorage* fs, CvRNG* rng)
+{
+    int vertical = cvRandInt(rng) % 2, parts = 2 + cvRandInt(rng) % 2;
+    int w = 2 + cvRandInt(rng) % 6, h = 2 + cvRandInt(rng) % 6;
+    int x, y, i;
+    CvRect r[2];
+
+    if (vertical)
+        h = MIN(h * parts, 24) / parts * parts;
+    else
+        w = MIN(w * parts, 24) / parts * parts;
+    x = cvRandInt(rng) % (24 - w + 1);
+    y = cvRandInt(rng) % (24 - h + 1);
+
+    // the whole area with weight -1 and the middle (or the second half)
+    // with weight parts, so a flat window gives 0
+    r[0] = cvRect(x, y, w, h);
+    r[1] = vertical ? cvRect(x, y + (parts == 3 ? h / 3 : h / 2), w,
+                             h / parts)
+                    : cvRect(x + (parts == 3 ? w / 3 : w / 2), y, w / parts,
+                             h);
+
+    cvStartWriteStruct(fs, "feature", CV_NODE_MAP);
+    cvStartWriteStruct(fs, "rects", CV_NODE_SEQ);
+    for (i = 0; i < 2; i++)
+    {
+        cvStartWriteStruct(fs, 0, CV_NODE_SEQ + CV_NODE_FLOW);
+        cvWriteInt(fs, 0, r[i].x);
+        cvWriteInt(fs, 0, r[i].y);
+        cvWriteInt(fs, 0, r[i].width);
+        cvWriteInt(fs, 0, r[i].height);
+        cvWriteReal(fs, 0, i == 0 ? -1. : (double)parts);
+        cvEndWriteStruct(fs);
+    }
+    cvEndWriteStruct(fs);
+    cvWriteInt(fs, "tilted", 0);
+    cvEndWriteStruct(fs);
+}
+
+static CvHaarClassifierCascade* create_cascade(const char* filename)
+{
+    static const int stage_sizes[] = {
+        9,   16,  27,  32,  52,  53,  62,  72,  83,  91,  99,  115, 127,
+        135, 136, 137, 159, 155, 169, 196, 197, 181, 199, 211, 200};
+    CvFileStorage* fs = cvOpenFileStorage(filename, 0, CV_STORAGE_WRITE);
+    CvHaarClassifierCascade* cascade;
+    CvRNG rng = cvRNG(7);
+    int i, j;
+
+    cvStartWriteStruct(fs, "cascade", CV_NODE_MAP, CV_TYPE_NAME_HAAR);
+    cvStartWriteStruct(fs, "size", CV_NODE_SEQ + CV_NODE_FLOW);
+    cvWriteInt(fs, 0, 24);
+    cvWriteInt(fs, 0, 24);
+    cvEndWriteStruct(fs);
+
+    cvStartWriteStruct(fs, "stages", CV_NODE_SEQ);
+    for (i = 0; i < 25; i++)
+    {
+        cvStartWriteStruct(fs, 0, CV_NODE_MAP);
+        cvStartWriteStruct(fs, "trees", CV_NODE_SEQ);
+        for (j = 0; j < stage_sizes[i]; j++)
+        {
+            // a stump: the feature against 0, voting -1 or +1
+            cvStartWriteStruct(fs, 0, CV_NODE_SEQ);
+            cvStartWriteStruct(fs, 0, CV_NODE_MAP);
+            write_feature(fs, &rng);
+            cvWriteReal(fs, "threshold", 0.);
+            cvWriteReal(fs, "left_val", -1.);
+            cvWriteReal(fs, "right_val", 1.);
+            cvEndWriteStruct(fs);
+            cvEndWriteStruct(fs);
+        }
+        cvEndWriteStruct(fs);
+        // the sum of n votes spreads over about sqrt(n)
+        cvWriteReal(fs, "stage_threshold",
+                    0.5 * sqrt((double)stage_sizes[i]));
+        cvWriteInt(fs, "parent", i - 1);
+        cvWriteInt(fs, "next", -1);
+        cvEndWriteStruct(fs);
+    }
+    cvEndWriteStruct(fs);
+    cvEndWriteStruct(fs);
+    cvReleaseFileStorage(&fs);
+
+    cascade = (CvHaarClassifierCascade*)cvLoad(filename);
+    remove(filename);
+    return cascade;
+}
+
+static CvSeq* detect(const CvMat* img, CvHaarClassifierCascade* cascade,
+                     CvMemStorage* storage, int flags, double* best)
+{
+    CvSeq* objects = 0;
+
+    CVTEST_BEST_TIME(*best, 3,
+                     (cvClearMemStorage(storage),
+                      objects = cvHaarDetectObjects(img, cascade, storage, 1.1,
+                                                    3, flags, cvSize(24, 24))));
+    return objects;
+}
+
+static int same_objects(CvSeq* a, CvSeq* b)
+{
+    int i;
+
+    if (a->total != b->total)
+        return 0;
+    for (i = 0; i < a->total; i++)
+    {
+        CvAvgComp* ca = (CvAvgComp*)cvGetSeqElem(a, i);
+        CvAvgComp* cb = (CvAvgComp*)cvGetSeqElem(b, i);
+        if (memcmp(&ca->rect, &cb->rect, sizeof(ca->rect)) != 0
+            || ca->neighbors != cb->neighbors)
+            return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    static const int flags[] = {0, CV_HAAR_DO_CANNY_PRUNING,
+                                CV_HAAR_SCALE_IMAGE};
+    static const char* flag_names[] = {"default", "canny", "scale image"};
+    CvHaarClassifierCascade* cascade = create_cascade("test-haar.xml");
+    CvMat* img = cvCreateMat(1080, 1920, CV_8UC1);
+    CvMemStorage* storage0 = cvCreateMemStorage(0);
+    CvMemStorage* storage1 = cvCreateMemStorage(0);
+    int threads = argc > 1 ? atoi(argv[1]) : 1;
+    CvRNG rng = cvRNG(-1);
+    int i;
+
+    // a texture with detail at a few scales, as in a natural frame
+    cvRandArr(&rng, img, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(256));
+    cvSmooth(img, img, CV_GAUSSIAN, 5, 5);
+
+    printf("%d thread(s)\n", threads);
+    printf("%-12s %8s %9s %9s\n", "flags", "objects", "C ms", "SIMD ms");
+
+    for (i = 0; i < 3; i++)
+    {
+        CvSeq *objects0, *objects1;
+        double t0, t1;
+
+        cvSetNumThreads(1);
+        cvUseOptimized(0);
+        objects0 = detect(img, cascade, storage0, flags[i], &t0);
+        cvSetNumThreads(threads);
+        cvUseOptimized(1);
+        objects1 = detect(img, cascade, storage1, flags[i], &t1);
+
+        printf("%-12s %8d %9.1f %9.1f%s\n", flag_names[i], objects1->total,
+               t0, t1, cvtest_check(same_objects(objects0, objects1)));
+    }
+
+    cvReleaseHaarClassifierCascade(&cascade);
+    cvReleaseMat(&img);
+    cvReleaseMemStorage(&storage0);
+    cvReleaseMemStorage(&storage1);
+
+    return cvtest_report();
+}
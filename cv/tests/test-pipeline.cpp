@@ -0,0 +1,163 @@
+/* Checks CvImagePipeline against the sequential calls of the same stages
+   and times both on 4K and 8K frames.
+
+   g++ -O2 test-pipeline.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   The chain is gaussian 5x5 -> bilinear 1/2 -> gray on 8UC3. The
+   sequential version needs two intermediate images, allocated for every
+   frame ("seq") or reused between the frames ("reused"); the pipeline
+   keeps a band of rows per stage. "peak MB" is the most memory held
+   through cvAlloc at once by each version, above what is allocated before
+   the call. Pass a band height as the argument to time only that height. */
+
+#include "cvtest_util.h"
+#include "cv.hpp"
+
+#include <stdlib.h>
+
+/* the memory held through cvAlloc: now and the most since the last reset */
+static size_t alloc_bytes = 0, alloc_peak = 0;
+
+/* keeps the size in front of the block, which stays CV_MALLOC_ALIGN aligned */
+#define ALLOC_HEADER 64
+
+static void* CV_CDECL count_alloc(size_t size, void*)
+{
+    char* ptr = (char*)malloc(size + ALLOC_HEADER + 32);
+    char* aligned;
+
+    if (!ptr)
+        return 0;
+    aligned = (char*)(((size_t)ptr + ALLOC_HEADER + 31) & ~(size_t)31);
+    ((size_t*)aligned)[-1] = size;
+    ((char**)aligned)[-2] = ptr;
+    alloc_bytes += size;
+    alloc_peak = MAX(alloc_peak, alloc_bytes);
+    return aligned;
+}
+
+static int CV_CDECL count_free(void* ptr, void*)
+{
+    alloc_bytes -= ((size_t*)ptr)[-1];
+    free(((char**)ptr)[-2]);
+    return 0;
+}
+
+/* resets the peak and returns the bytes allocated above the current ones */
+static size_t peak_since(size_t base)
+{
+    size_t peak = alloc_peak - base;
+    alloc_peak = alloc_bytes;
+    return peak;
+}
+
+/* the sequential chain, with the intermediate images allocated for the
+   frame (blurred and small are 0) or reused from the previous frames;
+   returns the bytes of the intermediate images */
+static size_t run_sequential(const CvMat* src, CvMat* dst, CvSepFilter* gauss,
+                             CvMat* blurred, CvMat* small)
+{
+    bool temp = !blurred;
+    size_t bytes;
+
+    if (temp)
+    {
+        blurred = cvCreateMat(src->rows, src->cols, src->type);
+        small = cvCreateMat(dst->rows, dst->cols, src->type);
+    }
+    bytes = (size_t)blurred->step * blurred->rows
+            + (size_t)small->step * small->rows;
+
+    gauss->process(src, blurred);
+    cvResize(blurred, small, CV_INTER_LINEAR);
+    cvCvtColor(small, dst, CV_BGR2GRAY);
+
+    if (temp)
+    {
+        cvReleaseMat(&blurred);
+        cvReleaseMat(&small);
+    }
+    return bytes;
+}
+
+static void bench(CvSize size, int band_height)
+{
+    CvMat* src = cvCreateMat(size.height, size.width, CV_8UC3);
+    CvMat* dst0 = cvCreateMat(size.height / 2, size.width / 2, CV_8UC1);
+    CvMat* dst1 = cvCreateMat(size.height / 2, size.width / 2, CV_8UC1);
+    CvMat* blurred = cvCreateMat(size.height, size.width, CV_8UC3);
+    CvMat* small = cvCreateMat(size.height / 2, size.width / 2, CV_8UC3);
+    float k[5];
+    CvMat K = cvMat(1, 5, CV_32F, k);
+    CvSepFilter gauss;
+    CvImagePipeline pipeline;
+    CvRNG rng = cvRNG(-1);
+    double t0 = DBL_MAX, t1 = DBL_MAX, t2 = DBL_MAX, diff;
+    size_t bytes = 0, peak_seq = 0, peak_pipe = 0, base;
+    int i;
+
+    cvRandArr(&rng, src, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(256));
+    CvSepFilter::init_gaussian_kernel(&K);
+    gauss.init(size.width, CV_8UC3, CV_8UC3, &K, &K);
+
+    pipeline.add_smooth(CV_GAUSSIAN, 5, 5);
+    pipeline.add_resize(cvGetSize(dst0), CV_INTER_LINEAR);
+    pipeline.add_cvt_color(CV_BGR2GRAY, 1);
+
+    for (i = 0; i < 5; i++)
+    {
+        int64 t;
+
+        base = alloc_bytes;
+        peak_since(base);
+        t = cvGetTickCount();
+        bytes = run_sequential(src, dst0, &gauss, 0, 0);
+        t0 = MIN(t0, cvtest_ms_since(t));
+        peak_seq = peak_since(base);
+
+        t = cvGetTickCount();
+        run_sequential(src, dst0, &gauss, blurred, small);
+        t2 = MIN(t2, cvtest_ms_since(t));
+        peak_since(base);
+
+        t = cvGetTickCount();
+        pipeline.process(src, dst1, band_height);
+        t1 = MIN(t1, cvtest_ms_since(t));
+        peak_pipe = peak_since(base);
+    }
+
+    diff = cvNorm(dst0, dst1, CV_C);
+    printf("%4dx%-4d %6d %9.3g %10.1f %10.1f %10.1f %9.1f %9.1f %9.2f%s\n",
+           size.width, size.height, band_height, diff, t0, t2, t1,
+           bytes / 1048576., peak_seq / 1048576., peak_pipe / 1048576.,
+           cvtest_check(diff == 0));
+
+    cvReleaseMat(&src);
+    cvReleaseMat(&dst0);
+    cvReleaseMat(&dst1);
+    cvReleaseMat(&blurred);
+    cvReleaseMat(&small);
+}
+
+int main(int argc, char** argv)
+{
+    static const CvSize sizes[] = {{3840, 2160}, {7680, 4320}};
+    static const int bands[] = {0, 16, 64, 256};
+    int i, j;
+
+    cvSetMemoryManager(count_alloc, count_free, 0);
+    printf("%9s %6s %9s %10s %10s %10s %9s %9s %9s\n", "size", "band",
+           "max diff", "seq ms", "reused ms", "pipe ms", "temp MB",
+           "peak seq", "peak pipe");
+
+    for (i = 0; i < 2; i++)
+    {
+        if (argc > 1)
+            bench(sizes[i], atoi(argv[1]));
+        else
+            for (j = 0; j < 4; j++)
+                bench(sizes[i], bands[j]);
+    }
+
+    return cvtest_report();
+}
@@ -0,0 +1,127 @@
+/* Compares cvRemap with the fixed-point maps of cvConvertMaps against the
+   floating-point maps and times both.
+
+   g++ -O2 test-remap.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   The images are smoothed, so the fixed-point maps, within 1/32 pixel of
+   the float ones, stay within 2 levels of the float path for 8u and within
+   0.6% of the range for the other depths. The maps also point just outside
+   the image (within 1/64 pixel), where both paths must agree on the
+   outliers. */
+
+#include "cvtest_util.h"
+
+/* the best of a few runs, in ms */
+static double time_remap(const CvMat* src, CvMat* dst, const CvMat* mapx,
+                         const CvMat* mapy)
+{
+    double best;
+
+    CVTEST_BEST_TIME(best, 5,
+                     cvRemap(src, dst, mapx, mapy,
+                             CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS,
+                             cvScalarAll(200)));
+    return best;
+}
+
+static void init_undistort_maps(CvMat* mapx, CvMat* mapy)
+{
+    double a[] = {mapx->cols * 0.9, 0, mapx->cols * 0.5,
+                  0, mapx->cols * 0.9, mapx->rows * 0.5,
+                  0, 0, 1};
+    double k[] = {-0.28, 0.09, 0.001, -0.0005};
+    CvMat A = cvMat(3, 3, CV_64F, a), K = cvMat(1, 4, CV_64F, k);
+
+    cvInitUndistortMap(&A, &K, mapx, mapy);
+}
+
+/* the identity shifted by up to 1/64 pixel, so the first and the last
+   rows and columns are partly out of the image */
+static void init_border_maps(CvMat* mapx, CvMat* mapy)
+{
+    static const float shifts[] = {-0.015f, -0.01f, -0.001f, 0.f,
+                                   0.001f,  0.01f,  0.015f};
+    int x, y;
+
+    for (y = 0; y < mapx->rows; y++)
+        for (x = 0; x < mapx->cols; x++)
+        {
+            CV_MAT_ELEM(*mapx, float, y, x) = x + shifts[(x + y) % 7];
+            CV_MAT_ELEM(*mapy, float, y, x) = y + shifts[(x * 3 + y) % 7];
+        }
+}
+
+static void check(const char* name, int type, const CvMat* mapx,
+                  const CvMat* mapy)
+{
+    CvSize size = cvGetSize(mapx);
+    CvMat* src = cvCreateMat(size.height, size.width, type);
+    CvMat* dst0 = cvCreateMat(size.height, size.width, type);
+    CvMat* dst1 = cvCreateMat(size.height, size.width, type);
+    CvMat* mapxy = cvCreateMat(size.height, size.width, CV_16SC2);
+    CvMat* mapalpha = cvCreateMat(size.height, size.width, CV_16UC1);
+    CvRNG rng = cvRNG(-1);
+    double range = CV_MAT_DEPTH(type) == CV_8U    ? 255.
+                   : CV_MAT_DEPTH(type) == CV_16U ? 65535.
+                                                  : 1.;
+    double max_diff = CV_MAT_DEPTH(type) == CV_8U ? 2. : range * 0.006;
+    double tconv, t0, t1, diff;
+    int64 t;
+
+    cvRandArr(&rng, src, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(range));
+    cvSmooth(src, src, CV_GAUSSIAN, 7, 7);
+
+    t = cvGetTickCount();
+    cvConvertMaps(mapx, mapy, mapxy, mapalpha);
+    tconv = cvtest_ms_since(t);
+
+    t0 = time_remap(src, dst0, mapx, mapy);
+    t1 = time_remap(src, dst1, mapxy, mapalpha);
+
+    diff = cvNorm(dst0, dst1, CV_C);
+    printf("%-24s %4dx%-4d %9.3g %9.2f %9.2f %9.2f%s\n", name, size.width,
+           size.height, diff, t0, t1, tconv, cvtest_check(diff <= max_diff));
+
+    cvReleaseMat(&src);
+    cvReleaseMat(&dst0);
+    cvReleaseMat(&dst1);
+    cvReleaseMat(&mapxy);
+    cvReleaseMat(&mapalpha);
+}
+
+int main(int, char**)
+{
+    static const CvSize sizes[] = {{1920, 1080}, {3840, 2160}};
+    static const int types[] = {CV_8UC1, CV_8UC3, CV_16UC3, CV_32FC3};
+    static const char* type_names[] = {"8UC1", "8UC3", "16UC3", "32FC3"};
+    char name[64];
+    int i, j;
+
+    printf("%-24s %9s %9s %9s %9s %9s\n", "maps", "size", "max diff",
+           "float ms", "fixed ms", "conv ms");
+
+    for (i = 0; i < 2; i++)
+    {
+        CvMat* mapx = cvCreateMat(sizes[i].height, sizes[i].width, CV_32FC1);
+        CvMat* mapy = cvCreateMat(sizes[i].height, sizes[i].width, CV_32FC1);
+
+        init_undistort_maps(mapx, mapy);
+        for (j = 0; j < 4; j++)
+        {
+            sprintf(name, "undistort %s", type_names[j]);
+            check(name, types[j], mapx, mapy);
+        }
+
+        init_border_maps(mapx, mapy);
+        for (j = 0; j < 4; j++)
+        {
+            sprintf(name, "border %s", type_names[j]);
+            check(name, types[j], mapx, mapy);
+        }
+
+        cvReleaseMat(&mapx);
+        cvReleaseMat(&mapy);
+    }
+
+    return cvtest_report();
+}
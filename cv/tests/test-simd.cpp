@@ -0,0 +1,220 @@
+/* Checks the built-in SIMD kernels behind the IPP hooks against the C code
+   (cvUseOptimized(0)) and times both on a 1080p frame.
+
+   g++ -O2 test-simd.cpp -I.. -I../../cxcore -L<libdir> -lcv -lcxcore
+
+   Every kernel must be bit-exact, except the 32f separable filters that sum
+   in a different order, and must not be slower than the C code by more
+   than the noise of the timing (SLOWER_MARGIN, SLOWER_TIMINGS). */
+
+#include "cvtest_util.h"
+
+/* a built-in kernel may take up to this times the C time; the same code
+   timed twice differs by up to about 15% on a loaded machine */
+#define SLOWER_MARGIN 1.2
+
+/* a kernel is slower only when it is in this many timings, an occasional
+   slow run of the machine is not */
+#define SLOWER_TIMINGS 3
+
+typedef struct CvTestParams
+{
+    int type, a, b;
+    double scale, shift, max_diff;
+    const CvMat *mapx, *mapy;
+} CvTestParams;
+
+typedef void (*CvTestFunc)(const CvMat* src, CvMat* dst,
+                           const CvTestParams* p);
+
+static void run_convert(const CvMat* src, CvMat* dst, const CvTestParams* p)
+{
+    cvConvertScale(src, dst, p->scale, p->shift);
+}
+
+static void run_resize(const CvMat* src, CvMat* dst, const CvTestParams*)
+{
+    cvResize(src, dst, CV_INTER_LINEAR);
+}
+
+static void run_remap(const CvMat* src, CvMat* dst, const CvTestParams* p)
+{
+    cvRemap(src, dst, p->mapx, p->mapy,
+            CV_INTER_LINEAR + CV_WARP_FILL_OUTLIERS, cvScalarAll(0));
+}
+
+static void run_smooth(const CvMat* src, CvMat* dst, const CvTestParams* p)
+{
+    cvSmooth(src, dst, p->type, p->a, p->b);
+}
+
+static void run_recursive(const CvMat* src, CvMat* dst, const CvTestParams* p)
+{
+    cvSmooth(src, dst, CV_GAUSSIAN_RECURSIVE, 0, 0, p->scale, p->scale);
+}
+
+static void run_gray(const CvMat* src, CvMat* dst, const CvTestParams* p)
+{
+    cvCvtColor(src, dst, p->type);
+}
+
+static void check(const char* name, CvTestFunc func, const CvMat* src,
+                  int dst_type, CvSize dst_size, const CvTestParams* p)
+{
+    CvMat* dst0 = cvCreateMat(dst_size.height, dst_size.width, dst_type);
+    CvMat* dst1 = cvCreateMat(dst_size.height, dst_size.width, dst_type);
+    double t0, t1, t, diff;
+    int i, k, ok;
+
+    for (k = 0; k < SLOWER_TIMINGS; k++)
+    {
+        // alternate the two so a change of the machine load hits both
+        t0 = t1 = DBL_MAX;
+        for (i = 0; i < 3; i++)
+        {
+            cvUseOptimized(0);
+            CVTEST_BEST_TIME(t, 3, func(src, dst0, p));
+            t0 = MIN(t0, t);
+            cvUseOptimized(1);
+            CVTEST_BEST_TIME(t, 3, func(src, dst1, p));
+            t1 = MIN(t1, t);
+        }
+        if (t1 <= t0 * SLOWER_MARGIN)
+            break;
+    }
+
+    diff = cvNorm(dst0, dst1, CV_C);
+    ok = diff <= p->max_diff && t1 <= t0 * SLOWER_MARGIN;
+    printf("%-26s %10.3g %9.2f %9.2f %7.2fx%s\n", name, diff, t0, t1, t0 / t1,
+           cvtest_check(ok));
+
+    cvReleaseMat(&dst0);
+    cvReleaseMat(&dst1);
+}
+
+int main(int, char**)
+{
+    static const int cns[] = {1, 3, 4};
+    CvSize size = cvSize(1920, 1080);
+    CvRNG rng = cvRNG(-1);
+    CvMat *src8u[5], *src32f[5];
+    CvMat *mapx, *mapy, *shiftx, *shifty;
+    CvTestParams p = {0, 0, 0, 1, 0, 0, 0, 0};
+    char name[64];
+    int i, k, x, y;
+
+    for (i = 0; i < 3; i++)
+    {
+        int cn = cns[i];
+        src8u[cn] = cvCreateMat(size.height, size.width, CV_8UC(cn));
+        src32f[cn] = cvCreateMat(size.height, size.width, CV_32FC(cn));
+        cvRandArr(&rng, src8u[cn], CV_RAND_UNI, cvScalarAll(0),
+                  cvScalarAll(256));
+        cvRandArr(&rng, src32f[cn], CV_RAND_UNI, cvScalarAll(0),
+                  cvScalarAll(1000));
+    }
+
+    // a rotation by 5 degrees around the center, partly out of the image
+    mapx = cvCreateMat(size.height, size.width, CV_32FC1);
+    mapy = cvCreateMat(size.height, size.width, CV_32FC1);
+    for (y = 0; y < size.height; y++)
+        for (x = 0; x < size.width; x++)
+        {
+            double dx = x - size.width * 0.5, dy = y - size.height * 0.5;
+            CV_MAT_ELEM(*mapx, float, y, x) =
+                (float)(size.width * 0.5 + dx * 0.9962 - dy * 0.0872);
+            CV_MAT_ELEM(*mapy, float, y, x) =
+                (float)(size.height * 0.5 + dx * 0.0872 + dy * 0.9962);
+        }
+
+    // a shift by a quarter pixel, up to the bottom-right pixel
+    shiftx = cvCreateMat(size.height, size.width, CV_32FC1);
+    shifty = cvCreateMat(size.height, size.width, CV_32FC1);
+    for (y = 0; y < size.height; y++)
+        for (x = 0; x < size.width; x++)
+        {
+            CV_MAT_ELEM(*shiftx, float, y, x) = x + 0.25f;
+            CV_MAT_ELEM(*shifty, float, y, x) = y + 0.25f;
+        }
+
+    printf("built-in kernels: 0x%x\n", cvGetCPUFeatures());
+    printf("%-26s %10s %9s %9s %8s\n", "kernel", "max diff", "C ms", "SIMD ms",
+           "speedup");
+
+    p.scale = 255. / 1000;
+    check("convertScale 32f->8u", run_convert, src32f[1], CV_8UC1, size, &p);
+    p.scale = 0.5;
+    p.shift = 3;
+    check("convertScale 32f->32f", run_convert, src32f[1], CV_32FC1, size,
+          &p);
+
+    for (i = 0; i < 3; i++)
+    {
+        int cn = cns[i];
+        CvSize small = cvSize(size.width * 2 / 3, size.height * 2 / 3);
+
+        p.max_diff = 0;
+        sprintf(name, "resize 8uC%d", cn);
+        check(name, run_resize, src8u[cn], CV_8UC(cn), small, &p);
+        sprintf(name, "resize 32fC%d", cn);
+        check(name, run_resize, src32f[cn], CV_32FC(cn), small, &p);
+        p.mapx = mapx;
+        p.mapy = mapy;
+        sprintf(name, "remap 8uC%d", cn);
+        check(name, run_remap, src8u[cn], CV_8UC(cn), size, &p);
+        sprintf(name, "remap 32fC%d", cn);
+        check(name, run_remap, src32f[cn], CV_32FC(cn), size, &p);
+        p.mapx = shiftx;
+        p.mapy = shifty;
+        sprintf(name, "remap shift 8uC%d", cn);
+        check(name, run_remap, src8u[cn], CV_8UC(cn), size, &p);
+        sprintf(name, "remap shift 32fC%d", cn);
+        check(name, run_remap, src32f[cn], CV_32FC(cn), size, &p);
+
+        for (k = 3; k <= 7; k += 4)
+        {
+            p.a = p.b = k;
+            p.type = CV_BLUR;
+            p.max_diff = 0;
+            sprintf(name, "blur %dx%d 8uC%d", k, k, cn);
+            check(name, run_smooth, src8u[cn], CV_8UC(cn), size, &p);
+            sprintf(name, "blur %dx%d 32fC%d", k, k, cn);
+            check(name, run_smooth, src32f[cn], CV_32FC(cn), size, &p);
+
+            p.type = CV_GAUSSIAN;
+            sprintf(name, "gaussian %dx%d 8uC%d", k, k, cn);
+            check(name, run_smooth, src8u[cn], CV_8UC(cn), size, &p);
+            p.max_diff = 1e-3;
+            sprintf(name, "gaussian %dx%d 32fC%d", k, k, cn);
+            check(name, run_smooth, src32f[cn], CV_32FC(cn), size, &p);
+        }
+    }
+
+    p.max_diff = 0;
+    p.scale = 5;
+    for (i = 0; i < 3; i++)
+    {
+        int cn = cns[i];
+        sprintf(name, "recursive gaussian 8uC%d", cn);
+        check(name, run_recursive, src8u[cn], CV_8UC(cn), size, &p);
+        sprintf(name, "recursive gaussian 32fC%d", cn);
+        check(name, run_recursive, src32f[cn], CV_32FC(cn), size, &p);
+    }
+
+    p.type = CV_BGR2GRAY;
+    check("BGR->gray 8u", run_gray, src8u[3], CV_8UC1, size, &p);
+    p.type = CV_BGRA2GRAY;
+    check("BGRA->gray 8u", run_gray, src8u[4], CV_8UC1, size, &p);
+
+    for (i = 0; i < 3; i++)
+    {
+        cvReleaseMat(&src8u[cns[i]]);
+        cvReleaseMat(&src32f[cns[i]]);
+    }
+    cvReleaseMat(&mapx);
+    cvReleaseMat(&mapy);
+    cvReleaseMat(&shiftx);
+    cvReleaseMat(&shifty);
+
+    return cvtest_report();
+}
@@ -85,8 +85,9 @@ extern const char* icvHersheyGlyphs[];
 
 extern const signed char icvDepthToType[];
 
-#define icvIplToCvDepth(depth) \
-    icvDepthToType[(((depth) & 255) >> 2) + ((depth) < 0)]
+#define icvIplToCvDepth(depth)         \
+    ((depth) == IPL_DEPTH_16F ? CV_16F \
+     : icvDepthToType[(((depth) & 255) >> 2) + ((depth) < 0)])
 
 extern const uchar icvSaturate8u[];
 #define CV_FAST_CAST_8U(t) \
@@ -317,6 +318,10 @@ typedef CvStatus(CV_STDCALL* CvCopyMaskFunc)(const void* src, int src_step,
 
 CvCopyMaskFunc icvGetCopyMaskFunc(int elem_size);
 
+/* builds the elements of a sequence that has a total but no blocks yet, a
+   raw payload of a binary file storage (cxpersistence.cpp) */
+void icvBuildLazySeq(CvSeq* seq);
+
 CvStatus CV_STDCALL icvSetZero_8u_C1R(uchar* dst, int dststep, CvSize size);
 
 CvStatus CV_STDCALL icvScale_32f(const float* src, float* dst, int len, float a,
@@ -70,6 +70,55 @@ IPCVAPI_EX(CvStatus, icvCvt_32f64f, "ippsConvert_32f64f",
 IPCVAPI_EX(CvStatus, icvCvt_64f32f, "ippsConvert_64f32f",
            CV_PLUGINS1(CV_PLUGIN_IPPS),
            (const double* src, float* dst, int len))
+IPCVAPI_EX(CvStatus, icvCvt_16f32f, "ippsConvert_16f32f",
+           CV_PLUGINS1(CV_PLUGIN_IPPS),
+           (const ushort* src, float* dst, int len))
+/* ippsConvert_32f16f takes a rounding mode, so there is only the built-in
+   SIMD version (cxsimd.cpp) */
+IPCVAPI_EX(CvStatus, icvCvt_32f16f, "icvCvt_32f16f", 0,
+           (const float* src, ushort* dst, int len))
+
+/* there are no IPP counterparts, only the built-in SIMD versions (cxsimd.cpp)
+ */
+IPCVAPI_EX(CvStatus, icvCvtScale_32f8u_C1R, "icvCvtScale_32f8u_C1R", 0,
+           (const float* src, int srcstep, uchar* dst, int dststep,
+            CvSize size, double scale, double shift))
+IPCVAPI_EX(CvStatus, icvCvtScale_32f_C1R, "icvCvtScale_32f_C1R", 0,
+           (const float* src, int srcstep, float* dst, int dststep,
+            CvSize size, double scale, double shift))
+
+/* the 16-bit LUT with 32-bit table entries and the shaper LUT (cxlut.cpp) */
+IPCVAPI_EX(CvStatus, icvLUT_Transform16u_32s_CnR,
+           "icvLUT_Transform16u_32s_CnR", 0,
+           (const ushort* src, int srcstep, int* dst, int dststep,
+            CvSize size, const int* lut, int cn))
+IPCVAPI_EX(CvStatus, icvLUTInterp_32f_CnR, "icvLUTInterp_32f_CnR", 0,
+           (const float* src, int srcstep, float* dst, int dststep,
+            CvSize size, const float* lut, int lut_size, int cn,
+            float min_val, float max_val, float scale, int log_spaced))
+/* update per-channel extrema and sums with a row of cn-channel data and
+   find the histogram bins of the row (cxstats.cpp) */
+IPCVAPI_EX(CvStatus, icvImageStatsRow_32f, "icvImageStatsRow_32f", 0,
+           (const float* src, int len, int cn, float* min_val,
+            float* max_val, double* sum, double* sqsum))
+IPCVAPI_EX(CvStatus, icvHistBins_32f, "icvHistBins_32f", 0,
+           (const float* src, int len, int cn, int* idx, int bins,
+            float hist_min, float hist_max, float scale))
+/* find the per-channel maximum absolute difference of two rows of cn-channel
+   data and its first pixel, add the squared differences and mark the pixels
+   that differ by more than threshold; the horizontal and the vertical passes
+   of the windowed SSIM statistics (cxquality.cpp) */
+IPCVAPI_EX(CvStatus, icvDiffRow_32f, "icvDiffRow_32f", 0,
+           (const float* src1, const float* src2, int len, int cn,
+            float* max_diff, int* max_pos, double* sqsum, uchar* mask,
+            float threshold))
+IPCVAPI_EX(CvStatus, icvSSIMRowH_32f, "icvSSIMRowH_32f", 0,
+           (const float* src1, const float* src2, int len, int cn,
+            const float* kernel, int ksize, float* dst))
+IPCVAPI_EX(CvStatus, icvSSIMRowV_32f, "icvSSIMRowV_32f", 0,
+           (const float** rows, int len, int cn, const float* kernel,
+            int ksize, float c1, float c2, double* ssim_sum,
+            double* cs_sum))
 
 #define IPCV_COPYSET(flavor, arrtype, scalartype)                            \
     IPCVAPI_EX(CvStatus, icvCopy##flavor, "ippiCopy" #flavor,                \
@@ -590,6 +639,8 @@ IPCV_TRANSFORM(_8u, 32f_8u, 3)
 IPCV_TRANSFORM(_16u, 32f_16u, 3)
 IPCV_TRANSFORM(_16s, 32f_16s, 3)
 IPCV_TRANSFORM(_32f, _32f, 3)
+IPCV_TRANSFORM(_8u, 32f_8u, 4)
+IPCV_TRANSFORM(_16u, 32f_16u, 4)
 IPCV_TRANSFORM(_32f, _32f, 4)
 
 #undef IPCV_TRANSFORM
@@ -667,4 +718,17 @@ IPCV_DFT(C_64fc, CToC_64fc, CToC_64fc)
 IPCV_DFT(R_64f, RToPack_64f, PackToR_64f)
 #undef IPCV_DFT
 
+/* a radix-4 or radix-2 pass over the power-of-2 factor of the mixed-radix
+   DFT (cxdxt.cpp); there are only the built-in SIMD versions (cxsimd.cpp) */
+#define IPCV_DFT_RADIX(radix, flavor)                   \
+    IPCVAPI_EX(CvStatus, icvDFTRadix##radix##_##flavor, \
+               "icvDFTRadix" #radix "_" #flavor, 0,     \
+               (void* dst, int n0, int nx, const void* wave, int dw0))
+
+IPCV_DFT_RADIX(4, 32fc)
+IPCV_DFT_RADIX(2, 32fc)
+IPCV_DFT_RADIX(4, 64fc)
+IPCV_DFT_RADIX(2, 64fc)
+#undef IPCV_DFT_RADIX
+
 #endif /*_CXCORE_IPP_H_*/
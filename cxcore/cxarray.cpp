@@ -968,10 +968,12 @@ CV_IMPL void cvCreateData(CvArr* arr)
             int depth = img->depth;
             int width = img->width;
 
-            if (img->depth == IPL_DEPTH_32F || img->nChannels == 64)
+            if (img->depth == IPL_DEPTH_32F || img->depth == IPL_DEPTH_16F
+                || img->nChannels == 64)
             {
-                img->width *= img->depth == IPL_DEPTH_32F ? sizeof(float)
-                                                          : sizeof(double);
+                img->width *= img->depth == IPL_DEPTH_32F   ? sizeof(float)
+                              : img->depth == IPL_DEPTH_16F ? sizeof(ushort)
+                                                            : sizeof(double);
                 img->depth = IPL_DEPTH_8U;
             }
 
@@ -1715,6 +1717,10 @@ CV_IMPL void cvScalarToRawData(const CvScalar* scalar, void* data, int type,
         while (cn--)
             ((double*)data)[cn] = (double)(scalar->val[cn]);
         break;
+    case CV_16FC1:
+        while (cn--)
+            ((ushort*)data)[cn] = cvFloatToHalf((float)(scalar->val[cn]));
+        break;
     default:
         assert(0);
         CV_ERROR_FROM_CODE(CV_BadDepth);
@@ -1782,6 +1788,10 @@ CV_IMPL void cvRawDataToScalar(const void* data, int flags, CvScalar* scalar)
         while (cn--)
             scalar->val[cn] = ((double*)data)[cn];
         break;
+    case CV_16F:
+        while (cn--)
+            scalar->val[cn] = cvHalfToFloat(((ushort*)data)[cn]);
+        break;
     default:
         assert(0);
         CV_ERROR_FROM_CODE(CV_BadDepth);
@@ -1808,6 +1818,8 @@ static double icvGetReal(const void* data, int type)
         return *(float*)data;
     case CV_64F:
         return *(double*)data;
+    case CV_16F:
+        return cvHalfToFloat(*(ushort*)data);
     }
 
     return 0;
@@ -1847,6 +1859,9 @@ static void icvSetReal(double value, const void* data, int type)
         case CV_64F:
             *(double*)data = value;
             break;
+        case CV_16F:
+            *(ushort*)data = cvFloatToHalf((float)value);
+            break;
         }
     }
 }
@@ -3283,7 +3298,8 @@ CV_IMPL IplImage* cvInitImageHeader(IplImage* image, CvSize size, int depth,
     if ((depth != (int)IPL_DEPTH_1U && depth != (int)IPL_DEPTH_8U
          && depth != (int)IPL_DEPTH_8S && depth != (int)IPL_DEPTH_16U
          && depth != (int)IPL_DEPTH_16S && depth != (int)IPL_DEPTH_32S
-         && depth != (int)IPL_DEPTH_32F && depth != (int)IPL_DEPTH_64F)
+         && depth != (int)IPL_DEPTH_32F && depth != (int)IPL_DEPTH_64F
+         && depth != (int)IPL_DEPTH_16F)
         || channels < 0)
         CV_ERROR(CV_BadDepth, "Unsupported format");
     if (origin != CV_ORIGIN_BL && origin != CV_ORIGIN_TL)
@@ -3307,7 +3323,7 @@ CV_IMPL IplImage* cvInitImageHeader(IplImage* image, CvSize size, int depth,
     image->depth = depth;
     image->align = align;
     image->widthStep =
-        (((image->width * image->nChannels * (image->depth & ~IPL_DEPTH_SIGN)
+        (((image->width * image->nChannels * (image->depth & 255)
            + 7)
           / 8)
          + align - 1)
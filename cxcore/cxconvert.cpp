@@ -1430,6 +1430,78 @@ typedef CvStatus(CV_STDCALL* CvCvtScaleFunc)(const void* src, int srcstep,
                                              CvSize size, double scale,
                                              double shift, int param);
 
+icvCvtScale_32f8u_C1R_t icvCvtScale_32f8u_C1R_p = 0;
+icvCvtScale_32f_C1R_t icvCvtScale_32f_C1R_p = 0;
+
+#define ICV_CVT_16F_BLOCK 256
+
+/* Converts to or from CV_16F by blocks: the half source elements are expanded
+   to float, the conversion to float or to the destination depth is done by
+   the regular functions, and the half destination elements are packed back.
+   cvt_func/cvtscale_func (one of them is 0) convert to float when the
+   destination is 16F. */
+static CvStatus CV_STDCALL icvCvt_16f_C1R(const uchar* src, int srcstep,
+                                          uchar* dst, int dststep, CvSize size,
+                                          int srctype, int dsttype,
+                                          CvCvtFunc cvt_func,
+                                          CvCvtScaleFunc cvtscale_func,
+                                          double scale, double shift)
+{
+    float buf[ICV_CVT_16F_BLOCK * 2];
+    int src_depth = CV_MAT_DEPTH(srctype), dst_depth = CV_MAT_DEPTH(dsttype);
+    int src_elem_size = CV_ELEM_SIZE1(src_depth);
+    int dst_elem_size = CV_ELEM_SIZE1(dst_depth);
+    CvSize block = {0, 1};
+    int i;
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        for (i = 0; i < size.width; i += block.width)
+        {
+            const uchar* s = src + i * src_elem_size;
+            uchar* d = dst + i * dst_elem_size;
+            float* fbuf = buf + ICV_CVT_16F_BLOCK;
+            int type = src_depth;
+
+            block.width = MIN(size.width - i, ICV_CVT_16F_BLOCK);
+
+            if (src_depth == CV_16F)
+            {
+                icvCvt_16f32f((const ushort*)s, buf, block.width);
+                s = (const uchar*)buf;
+                type = CV_32F;
+            }
+
+            if (dst_depth == CV_16F)
+            {
+                if (cvtscale_func)
+                    cvtscale_func(s, CV_STUB_STEP, fbuf, CV_STUB_STEP, block,
+                                  scale, shift, type);
+                else if (type != CV_32F)
+                    cvt_func(s, CV_STUB_STEP, fbuf, CV_STUB_STEP, block, type);
+                else
+                    fbuf = (float*)s;
+
+                icvCvt_32f16f(fbuf, (ushort*)d, block.width);
+            }
+            else if (cvtscale_func)
+                cvtscale_func(s, CV_STUB_STEP, d, CV_STUB_STEP, block, scale,
+                              shift, type);
+            else if (type != dst_depth)
+                cvt_func(s, CV_STUB_STEP, d, CV_STUB_STEP, block, type);
+            else
+                memcpy(d, s, block.width * dst_elem_size);
+        }
+    }
+
+    return CV_OK;
+}
+
+typedef CvStatus(CV_STDCALL* CvCvtScaleIPPFunc)(const void* src, int srcstep,
+                                                void* dst, int dststep,
+                                                CvSize size, double scale,
+                                                double shift);
+
 CV_IMPL void cvConvertScale(const void* srcarr, void* dstarr, double scale,
                             double shift)
 {
@@ -1497,6 +1569,28 @@ CV_IMPL void cvConvertScale(const void* srcarr, void* dstarr, double scale,
             inittab = 1;
         }
 
+        if (CV_MAT_DEPTH(type) == CV_16F || CV_MAT_DEPTH(dsttype) == CV_16F)
+        {
+            int depth = CV_MAT_DEPTH(dsttype) == CV_16F ? CV_32F
+                                                        : CV_MAT_DEPTH(dsttype);
+            CvCvtFunc func =
+                no_scale ? (CvCvtFunc)(cvt_tab.fn_2d[depth]) : 0;
+            CvCvtScaleFunc scale_func =
+                no_scale ? 0 : (CvCvtScaleFunc)(cvtscale_tab.fn_2d[depth]);
+
+            if (!func && !scale_func)
+                CV_ERROR(CV_StsUnsupportedFormat, "");
+
+            do
+            {
+                IPPI_CALL(icvCvt_16f_C1R(
+                    iterator.ptr[0], CV_STUB_STEP, iterator.ptr[1],
+                    CV_STUB_STEP, iterator.size, type, dsttype, func,
+                    scale_func, scale, shift));
+            } while (cvNextNArraySlice(&iterator));
+            EXIT;
+        }
+
         if (no_scale)
         {
             CvCvtFunc func = (CvCvtFunc)(cvt_tab.fn_2d[CV_MAT_DEPTH(dsttype)]);
@@ -1592,6 +1686,23 @@ CV_IMPL void cvConvertScale(const void* srcarr, void* dstarr, double scale,
     if (!CV_ARE_CNS_EQ(src, dst))
         CV_ERROR(CV_StsUnmatchedFormats, "");
 
+    if (CV_MAT_DEPTH(type) == CV_16F || CV_MAT_DEPTH(dst->type) == CV_16F)
+    {
+        int depth = CV_MAT_DEPTH(dst->type) == CV_16F ? CV_32F
+                                                      : CV_MAT_DEPTH(dst->type);
+        CvCvtFunc func = no_scale ? (CvCvtFunc)(cvt_tab.fn_2d[depth]) : 0;
+        CvCvtScaleFunc scale_func =
+            no_scale ? 0 : (CvCvtScaleFunc)(cvtscale_tab.fn_2d[depth]);
+
+        if (!func && !scale_func)
+            CV_ERROR(CV_StsUnsupportedFormat, "");
+
+        IPPI_CALL(icvCvt_16f_C1R(src->data.ptr, src_step, dst->data.ptr,
+                                 dst_step, size, type, dst->type, func,
+                                 scale_func, scale, shift));
+        EXIT;
+    }
+
     if (no_scale)
     {
         CvCvtFunc func = (CvCvtFunc)(cvt_tab.fn_2d[CV_MAT_DEPTH(dst->type)]);
@@ -1606,6 +1717,22 @@ CV_IMPL void cvConvertScale(const void* srcarr, void* dstarr, double scale,
     {
         CvCvtScaleFunc func =
             (CvCvtScaleFunc)(cvtscale_tab.fn_2d[CV_MAT_DEPTH(dst->type)]);
+        CvCvtScaleIPPFunc ipp_func = 0;
+
+        if (CV_MAT_DEPTH(type) == CV_32F)
+        {
+            if (CV_MAT_DEPTH(dst->type) == CV_8U)
+                ipp_func = (CvCvtScaleIPPFunc)icvCvtScale_32f8u_C1R_p;
+            else if (CV_MAT_DEPTH(dst->type) == CV_32F)
+                ipp_func = (CvCvtScaleIPPFunc)icvCvtScale_32f_C1R_p;
+        }
+
+        if (ipp_func)
+        {
+            IPPI_CALL(ipp_func(src->data.ptr, src_step, dst->data.ptr,
+                               dst_step, size, scale, shift));
+            EXIT;
+        }
 
         if (!func)
             CV_ERROR(CV_StsUnsupportedFormat, "");
@@ -1670,6 +1797,56 @@ IPCVAPI_IMPL(CvStatus, icvCvt_64f32f, (const double* src, float* dst, int len),
     return CV_OK;
 }
 
+IPCVAPI_IMPL(CvStatus, icvCvt_16f32f, (const ushort* src, float* dst, int len),
+             (src, dst, len))
+{
+    int i;
+    for (i = 0; i <= len - 4; i += 4)
+    {
+        float t0 = cvHalfToFloat(src[i]);
+        float t1 = cvHalfToFloat(src[i + 1]);
+
+        dst[i] = t0;
+        dst[i + 1] = t1;
+
+        t0 = cvHalfToFloat(src[i + 2]);
+        t1 = cvHalfToFloat(src[i + 3]);
+
+        dst[i + 2] = t0;
+        dst[i + 3] = t1;
+    }
+
+    for (; i < len; i++)
+        dst[i] = cvHalfToFloat(src[i]);
+
+    return CV_OK;
+}
+
+IPCVAPI_IMPL(CvStatus, icvCvt_32f16f, (const float* src, ushort* dst, int len),
+             (src, dst, len))
+{
+    int i;
+    for (i = 0; i <= len - 4; i += 4)
+    {
+        ushort t0 = cvFloatToHalf(src[i]);
+        ushort t1 = cvFloatToHalf(src[i + 1]);
+
+        dst[i] = t0;
+        dst[i + 1] = t1;
+
+        t0 = cvFloatToHalf(src[i + 2]);
+        t1 = cvFloatToHalf(src[i + 3]);
+
+        dst[i + 2] = t0;
+        dst[i + 3] = t1;
+    }
+
+    for (; i < len; i++)
+        dst[i] = cvFloatToHalf(src[i]);
+
+    return CV_OK;
+}
+
 CvStatus CV_STDCALL icvScale_32f(const float* src, float* dst, int len, float a,
                                  float b)
 {
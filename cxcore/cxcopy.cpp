@@ -79,13 +79,17 @@ static CvStatus CV_STDCALL icvSet_8u_C1R(uchar* dst, int dst_step, CvSize size,
 
     if (size.height--)
     {
-        while (dst + copy_len <= dst_limit)
+        int filled = MIN(copy_len, size.width), len = filled;
+        memcpy(dst, scalar, filled);
+
+        // replicate the filled part, doubling it up to a few kilobytes;
+        // its length stays a multiple of copy_len
+        for (; filled < size.width; filled += len)
         {
-            memcpy(dst, scalar, copy_len);
-            dst += copy_len;
+            if (len < (1 << 12))
+                len = filled;
+            memcpy(dst + filled, dst, MIN(len, size.width - filled));
         }
-
-        memcpy(dst, scalar, dst_limit - dst);
     }
 
     if (size.height)
@@ -875,6 +875,17 @@ extern "C"
     cvAvgSdv(const CvArr* arr, CvScalar* mean, CvScalar* std_dev,
              const CvArr* mask CV_DEFAULT(NULL));
 
+    /* Computes per-channel minimum, maximum, sum and sum of squares of 8u,
+       16u or 32f array and, optionally, the histograms of the values within
+       [hist_min,hist_max) (by default, the whole 8u or 16u range and [0,1)
+       for 32f) in a single pass. hist is 32sC1 or 32fC1 array with a row of
+       bins per channel. sample_step > 1 takes only every sample_step-th
+       pixel of every sample_step-th row */
+    CVAPI(void)
+    cvImageStats(const CvArr* arr, CvImageStats* stats,
+                 CvArr* hist CV_DEFAULT(NULL), double hist_min CV_DEFAULT(0),
+                 double hist_max CV_DEFAULT(0), int sample_step CV_DEFAULT(1));
+
     /* Finds global minimum, maximum and their positions */
     CVAPI(void)
     cvMinMaxLoc(const CvArr* arr, double* min_val, double* max_val,
@@ -904,6 +915,29 @@ extern "C"
     cvNorm(const CvArr* arr1, const CvArr* arr2 CV_DEFAULT(NULL),
            int norm_type CV_DEFAULT(CV_L2), const CvArr* mask CV_DEFAULT(NULL));
 
+    /* Compares two 8u, 16u, 16f or 32f arrays of the same size and type in a
+       single pass: finds the per-channel maximum absolute difference and its
+       first location, the mean squared error and the PSNR,
+       10*log10(peak^2/mse) (DBL_MAX for the identical channels). peak = 0
+       means 255 (8u), 65535 (16u) or 1 (16f, 32f). The optional 8uC1 mask is
+       set to 255 where any channel differs by more than threshold and to 0
+       elsewhere */
+    CVAPI(void)
+    cvImageDiff(const CvArr* arr1, const CvArr* arr2, CvImageDiff* diff,
+                CvArr* mask CV_DEFAULT(NULL), double threshold CV_DEFAULT(0),
+                double peak CV_DEFAULT(0));
+
+#define CV_SSIM_MULTISCALE 1
+
+    /* Computes the per-channel mean structural similarity of two arrays
+       (11x11 gaussian window, sigma = 1.5, the valid region only). With
+       CV_SSIM_MULTISCALE the 5-scale MS-SSIM is computed instead; the arrays
+       must be at least 176x176 then. peak has the same meaning as in
+       cvImageDiff */
+    CVAPI(CvScalar)
+    cvSSIM(const CvArr* arr1, const CvArr* arr2, int flags CV_DEFAULT(0),
+           double peak CV_DEFAULT(0));
+
     CVAPI(void)
     cvNormalize(const CvArr* src, CvArr* dst, double a CV_DEFAULT(1.),
                 double b CV_DEFAULT(0.), int norm_type CV_DEFAULT(CV_L2),
@@ -979,6 +1013,24 @@ extern "C"
        all the blocks to the parent when it is cleared */
     CVAPI(void) cvClearMemStorage(CvMemStorage* storage);
 
+    /* Clears the storage if *storage is not NULL (re-creating it if
+       block_size > 0 differs from its block size), creates a new one
+       otherwise. Keeping the storage between the calls of a per-frame loop
+       this way avoids all the block allocations after the first frame */
+    CVAPI(CvMemStorage*)
+    cvReuseMemStorage(CvMemStorage** storage, int block_size CV_DEFAULT(0));
+
+    /* Sets the maximal total size of the released storage blocks each thread
+       keeps for the next storages (2MB by default, 0 disables the pooling).
+       The pool of the calling thread is trimmed at once, the others on their
+       next release. Returns the previous value */
+    CVAPI(int) cvSetMemStoragePoolSize(int max_bytes);
+
+    /* Retrieves the block allocation counters of all the storages;
+       optionally resets them */
+    CVAPI(void)
+    cvGetMemStorageStats(CvMemStorageStats* stats, int reset CV_DEFAULT(0));
+
     /* Remember a storage "free memory" position */
     CVAPI(void)
     cvSaveMemStoragePos(const CvMemStorage* storage, CvMemStoragePos* pos);
@@ -1501,11 +1553,38 @@ extern "C"
                    int thickness CV_DEFAULT(1), int line_type CV_DEFAULT(8),
                    CvPoint offset CV_DEFAULT(cvPoint(0, 0)));
 
-    /* Does look-up transformation. Elements of the source array
-       (that should be 8uC1 or 8sC1) are used as indexes in lutarr 256-element
-       table */
+    /* Does look-up transformation. Elements of the source array are used as
+       indexes in lutarr table: 8u/8s - 256-element table, 16u - 65536-element
+       table; 32f source elements of [0,1] are mapped to a table of any size
+       with linear interpolation (see cvShaperLUT). The table may have 1 or
+       as many channels as the source */
     CVAPI(void) cvLUT(const CvArr* src, CvArr* dst, const CvArr* lut);
 
+#define CV_LUT_UNIFORM 0
+#define CV_LUT_LOG 1
+
+    /* Transforms 32f array with the shaper table (32f, 2 or more elements)
+       that samples a function at the points of [min_val,max_val] returned by
+       cvShaperLUTSamples; the values in between are linearly interpolated,
+       the values outside of the range are clipped. CV_LUT_LOG spaces the
+       points evenly in octaves (and linearly within an octave) from the
+       power of two not above min_val; with an element per octave or more
+       the number per octave is integral, every power of two is a point and
+       the last points may lie above max_val. The interpolation is then
+       linear in the value, a table of its own points gives the source back
+       within about 2e-6 relative error */
+    CVAPI(void)
+    cvShaperLUT(const CvArr* src, CvArr* dst, const CvArr* lut,
+                double min_val CV_DEFAULT(0), double max_val CV_DEFAULT(1),
+                int flags CV_DEFAULT(CV_LUT_UNIFORM));
+
+    /* Fills 32fC1 array with the source values that the elements of the
+       shaper table of the same size correspond to (for CV_LUT_LOG they may
+       start below min_val and end above max_val, see cvShaperLUT) */
+    CVAPI(void)
+    cvShaperLUTSamples(CvArr* samples, double min_val, double max_val,
+                       int flags CV_DEFAULT(CV_LUT_UNIFORM));
+
     /******************* Iteration through the sequence tree *****************/
     typedef struct CvTreeNodeIterator
     {
@@ -1551,6 +1630,18 @@ extern "C"
      * code */
     CVAPI(int) cvUseOptimized(int on_off);
 
+#define CV_CPU_NONE 0
+#define CV_CPU_SSE2 1
+#define CV_CPU_SSE4_1 2
+#define CV_CPU_AVX2 4
+#define CV_CPU_AVX512 8
+#define CV_CPU_F16C 16
+
+    /* Retrieves the instruction set extensions (CV_CPU_*) that the built-in
+       optimized functions may use. The OPENCV_CPU_FEATURES environment
+       variable, if set, masks the detected set */
+    CVAPI(int) cvGetCPUFeatures(void);
+
     /* Retrieves information about the registered modules and loaded optimized
      * plugins */
     CVAPI(void)
@@ -1853,12 +1944,34 @@ extern "C"
     /*********************************** Multi-Threading
      * ************************************/
 
-    /* retrieve/set the number of threads used in OpenMP implementations */
+    /* retrieve/set the number of threads used in parallel implementations.
+       0 means the value of OPENCV_NUM_THREADS environment variable or,
+       if it is not set, the number of processors */
     CVAPI(int) cvGetNumThreads(void);
     CVAPI(void) cvSetNumThreads(int threads CV_DEFAULT(0));
-    /* get index of the thread being executed */
+    /* get index of the thread being executed, 0..cvGetNumThreads()-1 */
     CVAPI(int) cvGetThreadNum(void);
 
+    /* processes the subrange [start,end) of the loop; returns CV_StsOk or
+       a negative error code */
+    typedef int(CV_CDECL* CvParallelLoopBody)(int start, int end,
+                                              void* userdata);
+
+    /* splits the range into subranges of at least <grain> iterations and
+       runs the body on them in the calling thread and the thread pool.
+       The idle threads steal the work of the busy ones. Calls made from
+       inside the body run sequentially in the calling thread. Returns the
+       first error code returned by the body, CV_StsOk otherwise */
+    CVAPI(int)
+    cvParallelFor(CvSlice range, CvParallelLoopBody body, void* userdata,
+                  int grain CV_DEFAULT(1));
+
+    /* lock/unlock the mutex that guards the tables the library caches
+       between the calls (e.g. the DFT plans). It is held only briefly and
+       no other library function is called while it is locked */
+    CVAPI(void) cvLockCaches(void);
+    CVAPI(void) cvUnlockCaches(void);
+
 #ifdef __cplusplus
 }
 
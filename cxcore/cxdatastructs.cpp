@@ -47,6 +47,12 @@ direct,
 //M*/
 #include "_cxcore.h"
 
+#if defined WIN32 || defined WIN64
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #define ICV_FREE_PTR(storage) \
     ((char*)(storage)->top + (storage)->block_size - (storage)->free_space)
 
@@ -79,6 +85,284 @@ static const char icvPower2ShiftTab[] = {
 *            Functions for manipulating memory storage - list of memory blocks *
 \****************************************************************************************/
 
+/* Root storages take their blocks from, and give them back to, a per-thread
+   list of released blocks, so that the code creating and releasing a storage
+   per call or per frame does not go to the heap every time. The lists are
+   keyed by the block size (a few sizes per thread), bounded in bytes by
+   icvMemPoolMaxBytes and freed when the thread exits. A block released by
+   another thread than the one that allocated it simply moves to the pool of
+   the releasing thread. Child storages are not affected: they borrow from,
+   and return to, their parent. */
+#define ICV_MEM_POOL_SIZES 4
+#define ICV_MEM_POOL_MAX_BYTES (2 << 20)
+
+typedef struct CvMemBlockPool
+{
+    int block_size[ICV_MEM_POOL_SIZES];
+    int count[ICV_MEM_POOL_SIZES];
+    CvMemBlock* free_list[ICV_MEM_POOL_SIZES];
+    size_t bytes;
+} CvMemBlockPool;
+
+static volatile int icvMemPoolMaxBytes = ICV_MEM_POOL_MAX_BYTES;
+static CvMemStorageStats icvMemStats;
+
+#if defined WIN32 || defined WIN64
+#define ICV_MEM_STAT_INC(counter) \
+    InterlockedIncrement64((volatile LONG64*)&icvMemStats.counter)
+/* returns the counter and sets it to 0 in one step */
+#define ICV_MEM_STAT_RESET(counter) \
+    InterlockedExchange64((volatile LONG64*)&icvMemStats.counter, 0)
+#define ICV_MEM_STAT_READ(counter) \
+    InterlockedCompareExchange64((volatile LONG64*)&icvMemStats.counter, 0, 0)
+#else
+#define ICV_MEM_STAT_INC(counter) \
+    __sync_fetch_and_add(&icvMemStats.counter, (int64)1)
+#define ICV_MEM_STAT_RESET(counter) \
+    __sync_lock_test_and_set(&icvMemStats.counter, (int64)0)
+#define ICV_MEM_STAT_READ(counter) \
+    __sync_fetch_and_add(&icvMemStats.counter, (int64)0)
+#endif
+
+static void icvFreeMemBlockPool(void* ptr)
+{
+    CvMemBlockPool* pool = (CvMemBlockPool*)ptr;
+    int i;
+
+    if (!pool)
+        return;
+
+    for (i = 0; i < ICV_MEM_POOL_SIZES; i++)
+    {
+        CvMemBlock* block = pool->free_list[i];
+        while (block)
+        {
+            CvMemBlock* next = block->next;
+            cvFree(&block);
+            ICV_MEM_STAT_INC(heap_frees);
+            block = next;
+        }
+    }
+    cvFree(&pool);
+}
+
+#if defined WIN32 || defined WIN64
+
+static DWORD icvMemPoolKey = FLS_OUT_OF_INDEXES;
+static INIT_ONCE icvMemPoolOnce = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI icvMemPoolDestructor(PVOID ptr) { icvFreeMemBlockPool(ptr); }
+
+static BOOL CALLBACK icvInitMemPoolKey(PINIT_ONCE, PVOID, PVOID*)
+{
+    icvMemPoolKey = FlsAlloc(icvMemPoolDestructor);
+    return TRUE;
+}
+
+static CvMemBlockPool* icvGetMemBlockPool(int create)
+{
+    CvMemBlockPool* pool;
+
+    InitOnceExecuteOnce(&icvMemPoolOnce, icvInitMemPoolKey, 0, 0);
+    if (icvMemPoolKey == FLS_OUT_OF_INDEXES)
+        return 0;
+    pool = (CvMemBlockPool*)FlsGetValue(icvMemPoolKey);
+    if (!pool && create)
+    {
+        pool = (CvMemBlockPool*)cvAlloc(sizeof(*pool));
+        if (pool)
+        {
+            memset(pool, 0, sizeof(*pool));
+            FlsSetValue(icvMemPoolKey, pool);
+        }
+    }
+    return pool;
+}
+
+#else
+
+static pthread_key_t icvMemPoolKey;
+static pthread_once_t icvMemPoolOnce = PTHREAD_ONCE_INIT;
+static int icvMemPoolKeyOk = 0;
+
+static void icvInitMemPoolKey(void)
+{
+    icvMemPoolKeyOk =
+        pthread_key_create(&icvMemPoolKey, icvFreeMemBlockPool) == 0;
+}
+
+static CvMemBlockPool* icvGetMemBlockPool(int create)
+{
+    CvMemBlockPool* pool;
+
+    pthread_once(&icvMemPoolOnce, icvInitMemPoolKey);
+    if (!icvMemPoolKeyOk)
+        return 0;
+    pool = (CvMemBlockPool*)pthread_getspecific(icvMemPoolKey);
+    if (!pool && create)
+    {
+        pool = (CvMemBlockPool*)cvAlloc(sizeof(*pool));
+        if (pool)
+        {
+            memset(pool, 0, sizeof(*pool));
+            pthread_setspecific(icvMemPoolKey, pool);
+        }
+    }
+    return pool;
+}
+
+#endif
+
+/* takes a block of the given size from the pool of the calling thread or,
+   if there is none, from the heap */
+static CvMemBlock* icvAllocMemBlock(int block_size)
+{
+    CvMemBlock* block = 0;
+
+    CV_FUNCNAME("icvAllocMemBlock");
+
+    __BEGIN__;
+
+    CvMemBlockPool* pool = icvGetMemBlockPool(0);
+
+    if (pool)
+    {
+        int i;
+        for (i = 0; i < ICV_MEM_POOL_SIZES; i++)
+            if (pool->block_size[i] == block_size && pool->free_list[i])
+            {
+                block = pool->free_list[i];
+                pool->free_list[i] = block->next;
+                pool->count[i]--;
+                pool->bytes -= block_size;
+                ICV_MEM_STAT_INC(pool_hits);
+                EXIT;
+            }
+    }
+
+    CV_CALL(block = (CvMemBlock*)cvAlloc(block_size));
+    ICV_MEM_STAT_INC(heap_allocs);
+
+    __END__;
+
+    return block;
+}
+
+/* puts a released block to the pool of the calling thread or, if the pool
+   is full, back to the heap */
+static void icvFreeMemBlock(CvMemBlock* block, int block_size)
+{
+    CvMemBlockPool* pool = 0;
+    int max_bytes = icvMemPoolMaxBytes;
+
+    if (max_bytes > 0)
+        pool = icvGetMemBlockPool(1);
+
+    if (pool && pool->bytes + block_size <= (size_t)max_bytes)
+    {
+        int i, empty = -1;
+        for (i = 0; i < ICV_MEM_POOL_SIZES; i++)
+        {
+            if (pool->block_size[i] == block_size)
+                break;
+            if (empty < 0 && pool->count[i] == 0)
+                empty = i;
+        }
+
+        if (i == ICV_MEM_POOL_SIZES && empty >= 0)
+        {
+            i = empty;
+            pool->block_size[i] = block_size;
+        }
+
+        if (i < ICV_MEM_POOL_SIZES)
+        {
+            block->next = pool->free_list[i];
+            pool->free_list[i] = block;
+            pool->count[i]++;
+            pool->bytes += block_size;
+            ICV_MEM_STAT_INC(pool_returns);
+            return;
+        }
+    }
+
+    cvFree(&block);
+    ICV_MEM_STAT_INC(heap_frees);
+}
+
+/* gives the pooled blocks of the calling thread back to the heap
+   until the pool holds no more than max_bytes */
+static void icvTrimMemBlockPool(size_t max_bytes)
+{
+    CvMemBlockPool* pool = icvGetMemBlockPool(0);
+    int i;
+
+    if (!pool)
+        return;
+
+    for (i = 0; i < ICV_MEM_POOL_SIZES && pool->bytes > max_bytes; i++)
+    {
+        while (pool->free_list[i] && pool->bytes > max_bytes)
+        {
+            CvMemBlock* block = pool->free_list[i];
+            pool->free_list[i] = block->next;
+            pool->count[i]--;
+            pool->bytes -= pool->block_size[i];
+            cvFree(&block);
+            ICV_MEM_STAT_INC(heap_frees);
+        }
+    }
+}
+
+CV_IMPL int cvSetMemStoragePoolSize(int max_bytes)
+{
+    int prev = icvMemPoolMaxBytes;
+
+    CV_FUNCNAME("cvSetMemStoragePoolSize");
+
+    __BEGIN__;
+
+    if (max_bytes < 0)
+        CV_ERROR(CV_StsOutOfRange, "The pool size must be non-negative");
+
+    icvMemPoolMaxBytes = max_bytes;
+    icvTrimMemBlockPool((size_t)max_bytes);
+
+    __END__;
+
+    return prev;
+}
+
+CV_IMPL void cvGetMemStorageStats(CvMemStorageStats* stats, int reset)
+{
+    CV_FUNCNAME("cvGetMemStorageStats");
+
+    __BEGIN__;
+
+    if (!stats)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    /* the counters are updated by the other threads meanwhile, so each one
+       is read and reset atomically; an increment is either reported now or
+       left for the next call */
+    if (reset)
+    {
+        stats->heap_allocs = ICV_MEM_STAT_RESET(heap_allocs);
+        stats->heap_frees = ICV_MEM_STAT_RESET(heap_frees);
+        stats->pool_hits = ICV_MEM_STAT_RESET(pool_hits);
+        stats->pool_returns = ICV_MEM_STAT_RESET(pool_returns);
+    }
+    else
+    {
+        stats->heap_allocs = ICV_MEM_STAT_READ(heap_allocs);
+        stats->heap_frees = ICV_MEM_STAT_READ(heap_frees);
+        stats->pool_hits = ICV_MEM_STAT_READ(pool_hits);
+        stats->pool_returns = ICV_MEM_STAT_READ(pool_returns);
+    }
+
+    __END__;
+}
+
 /* initializes allocated storage */
 static void icvInitMemStorage(CvMemStorage* storage, int block_size)
 {
@@ -186,7 +470,7 @@ static void icvDestroyMemStorage(CvMemStorage* storage)
         }
         else
         {
-            cvFree(&temp);
+            icvFreeMemBlock(temp, storage->block_size);
         }
     }
 
@@ -243,6 +527,38 @@ CV_IMPL void cvClearMemStorage(CvMemStorage* storage)
     __END__;
 }
 
+/* clears the storage if it exists or creates a new one */
+CV_IMPL CvMemStorage* cvReuseMemStorage(CvMemStorage** storage, int block_size)
+{
+    CvMemStorage* st = 0;
+
+    CV_FUNCNAME("cvReuseMemStorage");
+
+    __BEGIN__;
+
+    if (!storage)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    st = *storage;
+    if (st && block_size > 0 &&
+        st->block_size != cvAlign(block_size, CV_STRUCT_ALIGN))
+        CV_CALL(cvReleaseMemStorage(storage));
+
+    if (*storage)
+    {
+        CV_CALL(cvClearMemStorage(*storage));
+    }
+    else
+    {
+        CV_CALL(*storage = cvCreateMemStorage(block_size));
+    }
+    st = *storage;
+
+    __END__;
+
+    return st;
+}
+
 /* moves stack pointer to next block.
    If no blocks, allocate new one and link it to the storage */
 static void icvGoNextMemBlock(CvMemStorage* storage)
@@ -260,7 +576,7 @@ static void icvGoNextMemBlock(CvMemStorage* storage)
 
         if (!(storage->parent))
         {
-            CV_CALL(block = (CvMemBlock*)cvAlloc(storage->block_size));
+            CV_CALL(block = icvAllocMemBlock(storage->block_size));
         }
         else
         {
@@ -451,7 +767,9 @@ CV_IMPL CvSeq* cvCreateSeq(int seq_flags, int header_size, int elem_size,
         int typesize = CV_ELEM_SIZE(elemtype);
 
         if (elemtype != CV_SEQ_ELTYPE_GENERIC && typesize != 0
-            && typesize != elem_size)
+            && typesize != elem_size
+            && !(elemtype == CV_SEQ_ELTYPE_PTR
+                 && elem_size == (int)sizeof(void*)))
             CV_ERROR(CV_StsBadSize, "Specified element size doesn't match to "
                                     "the size of the specified element type "
                                     "(try to use 0 for element type)");
@@ -519,6 +837,13 @@ CV_IMPL char* cvGetSeqElem(const CvSeq* seq, int index)
             return 0;
     }
 
+    if (!seq->first)
+    {
+        icvBuildLazySeq((CvSeq*)seq);
+        if (!seq->first)
+            return 0;
+    }
+
     block = seq->first;
     if (index + index <= total)
     {
@@ -682,7 +1007,9 @@ CV_IMPL CvSeq* cvMakeSeqHeaderForArray(int seq_flags, int header_size,
         int typesize = CV_ELEM_SIZE(elemtype);
 
         if (elemtype != CV_SEQ_ELTYPE_GENERIC && typesize != 0
-            && typesize != elem_size)
+            && typesize != elem_size
+            && !(elemtype == CV_SEQ_ELTYPE_PTR
+                 && elem_size == (int)sizeof(void*)))
             CV_ERROR(CV_StsBadSize, "Element size doesn't match to the size of "
                                     "predefined element type "
                                     "(try to use 0 for sequence element type)");
@@ -1075,6 +1402,9 @@ CV_IMPL void cvStartReadSeq(const CvSeq* seq, CvSeqReader* reader, int reverse)
     reader->header_size = sizeof(CvSeqReader);
     reader->seq = (CvSeq*)seq;
 
+    if (!seq->first && seq->total > 0)
+        CV_CALL(icvBuildLazySeq((CvSeq*)seq));
+
     first_block = seq->first;
 
     if (first_block)
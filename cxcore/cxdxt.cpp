@@ -77,6 +77,11 @@ icvDFTGetBufSize_R_64f_t icvDFTGetBufSize_R_64f_p = 0;
 icvDFTFwd_RToPack_64f_t icvDFTFwd_RToPack_64f_p = 0;
 icvDFTInv_PackToR_64f_t icvDFTInv_PackToR_64f_p = 0;
 
+icvDFTRadix4_32fc_t icvDFTRadix4_32fc_p = 0;
+icvDFTRadix2_32fc_t icvDFTRadix2_32fc_p = 0;
+icvDFTRadix4_64fc_t icvDFTRadix4_64fc_p = 0;
+icvDFTRadix2_64fc_t icvDFTRadix2_64fc_p = 0;
+
 /*icvDCTFwdInitAlloc_32f_t icvDCTFwdInitAlloc_32f_p = 0;
 icvDCTFwdFree_32f_t icvDCTFwdFree_32f_p = 0;
 icvDCTFwdGetBufSize_32f_t icvDCTFwdGetBufSize_32f_p = 0;
@@ -316,9 +321,8 @@ static void icvDFTInit(int n0, int nf, int* factors, int* itab, int elem_size,
 
             digits[1]++;
 
-            assert(nf >= 2); // because we read radix[2] which is uninitialized
-                             // otherwise
-            for (i = n, j = radix[2]; i < n0;)
+            // radix[2] is only initialized (and needed) for several factors
+            for (i = n, j = nf >= 2 ? radix[2] : 0; i < n0;)
             {
                 for (k = 0; k < n; k++)
                     itab[i + k] = itab[k] + j;
@@ -567,6 +571,12 @@ static CvStatus CV_STDCALL icvDFT_64fc(const CvComplex64f* src,
             n *= 4;
             dw0 /= 4;
 
+            if (icvDFTRadix4_64fc_p)
+            {
+                icvDFTRadix4_64fc_p(dst, n0, nx, wave, dw0);
+                continue;
+            }
+
             for (i = 0; i < n0; i += n)
             {
                 CvComplex64f* v0;
@@ -652,6 +662,12 @@ static CvStatus CV_STDCALL icvDFT_64fc(const CvComplex64f* src,
             n *= 2;
             dw0 /= 2;
 
+            if (icvDFTRadix2_64fc_p)
+            {
+                icvDFTRadix2_64fc_p(dst, n0, nx, wave, dw0);
+                continue;
+            }
+
             for (i = 0; i < n0; i += n)
             {
                 CvComplex64f* v = dst + i;
@@ -1077,6 +1093,12 @@ static CvStatus CV_STDCALL icvDFT_32fc(const CvComplex32f* src,
             n *= 4;
             dw0 /= 4;
 
+            if (icvDFTRadix4_32fc_p)
+            {
+                icvDFTRadix4_32fc_p(dst, n0, nx, wave, dw0);
+                continue;
+            }
+
             for (i = 0; i < n0; i += n)
             {
                 CvComplex32f* v0;
@@ -1162,6 +1184,12 @@ static CvStatus CV_STDCALL icvDFT_32fc(const CvComplex32f* src,
             n *= 2;
             dw0 /= 2;
 
+            if (icvDFTRadix2_32fc_p)
+            {
+                icvDFTRadix2_32fc_p(dst, n0, nx, wave, dw0);
+                continue;
+            }
+
             for (i = 0; i < n0; i += n)
             {
                 CvComplex32f* v = dst + i;
@@ -1780,116 +1808,70 @@ static void icvCopyColumn(const uchar* _src, int src_step, uchar* _dst,
     }
 }
 
-static void icvCopyFrom2Columns(const uchar* _src, int src_step, uchar* _dst0,
-                                uchar* _dst1, int len, int elem_size)
+/* gathers <cols> adjacent columns of complex elements into consecutive
+   vectors of <len> elements, reading the source row by row */
+static void icvCopyFromColumns(const uchar* src, int src_step, uchar* _dst,
+                               int len, int cols, int elem_size)
 {
-    int i, t0, t1;
-    const int* src = (const int*)_src;
-    int* dst0 = (int*)_dst0;
-    int* dst1 = (int*)_dst1;
-    src_step /= sizeof(src[0]);
+    int i, j;
 
-    if (elem_size == sizeof(int))
+    if (elem_size == sizeof(int64))
     {
         for (i = 0; i < len; i++, src += src_step)
         {
-            t0 = src[0];
-            t1 = src[1];
-            dst0[i] = t0;
-            dst1[i] = t1;
-        }
-    }
-    else if (elem_size == sizeof(int) * 2)
-    {
-        for (i = 0; i < len * 2; i += 2, src += src_step)
-        {
-            t0 = src[0];
-            t1 = src[1];
-            dst0[i] = t0;
-            dst0[i + 1] = t1;
-            t0 = src[2];
-            t1 = src[3];
-            dst1[i] = t0;
-            dst1[i + 1] = t1;
+            const int64* s = (const int64*)src;
+            int64* dst = (int64*)_dst + i;
+            for (j = 0; j < cols; j++, dst += len)
+                dst[0] = s[j];
         }
     }
-    else if (elem_size == sizeof(int) * 4)
+    else
     {
-        for (i = 0; i < len * 4; i += 4, src += src_step)
+        assert(elem_size == sizeof(int64) * 2);
+        for (i = 0; i < len; i++, src += src_step)
         {
-            t0 = src[0];
-            t1 = src[1];
-            dst0[i] = t0;
-            dst0[i + 1] = t1;
-            t0 = src[2];
-            t1 = src[3];
-            dst0[i + 2] = t0;
-            dst0[i + 3] = t1;
-            t0 = src[4];
-            t1 = src[5];
-            dst1[i] = t0;
-            dst1[i + 1] = t1;
-            t0 = src[6];
-            t1 = src[7];
-            dst1[i + 2] = t0;
-            dst1[i + 3] = t1;
+            const int64* s = (const int64*)src;
+            int64* dst = (int64*)_dst + i * 2;
+            for (j = 0; j < cols * 2; j += 2, dst += len * 2)
+            {
+                int64 t0 = s[j], t1 = s[j + 1];
+                dst[0] = t0;
+                dst[1] = t1;
+            }
         }
     }
 }
 
-static void icvCopyTo2Columns(const uchar* _src0, const uchar* _src1,
-                              uchar* _dst, int dst_step, int len, int elem_size)
+/* the reverse of icvCopyFromColumns: scatters the consecutive vectors to
+   <cols> adjacent columns, writing the destination row by row */
+static void icvCopyToColumns(const uchar* _src, uchar* dst, int dst_step,
+                             int len, int cols, int elem_size)
 {
-    int i, t0, t1;
-    const int* src0 = (const int*)_src0;
-    const int* src1 = (const int*)_src1;
-    int* dst = (int*)_dst;
-    dst_step /= sizeof(dst[0]);
+    int i, j;
 
-    if (elem_size == sizeof(int))
+    if (elem_size == sizeof(int64))
     {
         for (i = 0; i < len; i++, dst += dst_step)
         {
-            t0 = src0[i];
-            t1 = src1[i];
-            dst[0] = t0;
-            dst[1] = t1;
+            const int64* src = (const int64*)_src + i;
+            int64* d = (int64*)dst;
+            for (j = 0; j < cols; j++, src += len)
+                d[j] = src[0];
         }
     }
-    else if (elem_size == sizeof(int) * 2)
-    {
-        for (i = 0; i < len * 2; i += 2, dst += dst_step)
-        {
-            t0 = src0[i];
-            t1 = src0[i + 1];
-            dst[0] = t0;
-            dst[1] = t1;
-            t0 = src1[i];
-            t1 = src1[i + 1];
-            dst[2] = t0;
-            dst[3] = t1;
-        }
-    }
-    else if (elem_size == sizeof(int) * 4)
+    else
     {
-        for (i = 0; i < len * 4; i += 4, dst += dst_step)
+        assert(elem_size == sizeof(int64) * 2);
+        for (i = 0; i < len; i++, dst += dst_step)
         {
-            t0 = src0[i];
-            t1 = src0[i + 1];
-            dst[0] = t0;
-            dst[1] = t1;
-            t0 = src0[i + 2];
-            t1 = src0[i + 3];
-            dst[2] = t0;
-            dst[3] = t1;
-            t0 = src1[i];
-            t1 = src1[i + 1];
-            dst[4] = t0;
-            dst[5] = t1;
-            t0 = src1[i + 2];
-            t1 = src1[i + 3];
-            dst[6] = t0;
-            dst[7] = t1;
+            const int64* src = (const int64*)_src + i * 2;
+            int64* d = (int64*)dst;
+            for (j = 0; j < cols * 2; j += 2, src += len * 2)
+            {
+                int64 t0 = src[0], t1 = src[1];
+                d[j] = t0;
+                d[j + 1] = t1;
+            }
         }
     }
 }
@@ -1935,6 +1917,240 @@ typedef CvStatus(CV_STDCALL* CvDFTFunc)(const void* src, void* dst, int n,
                                         const void* spec, void* buf, int inv,
                                         double scale);
 
+/* The twiddle factors and the permutation table of one transform length.
+   The plans of the recently used lengths are kept in a small list, the
+   most recent first; a plan is freed when it has been dropped from the
+   list and no transform uses it anymore */
+typedef struct CvDFTPlan
+{
+    int len, elem_size, inv_itab;
+    int nf, factors[34];
+    int* itab;
+    void* wave;
+    int refcount;
+} CvDFTPlan;
+
+#define ICV_DFT_PLAN_CACHE_SIZE 16
+
+/* the tables of the longer transforms take a lot of memory, while
+   computing them costs little compared to the transform itself */
+#define ICV_MAX_CACHED_DFT_LEN (1 << 16)
+
+static CvDFTPlan* icvDFTPlanCache[ICV_DFT_PLAN_CACHE_SIZE];
+
+static void icvReleaseDFTPlan(CvDFTPlan** _plan)
+{
+    CvDFTPlan* plan = *_plan;
+    int refcount;
+
+    if (!plan)
+        return;
+
+    *_plan = 0;
+    cvLockCaches();
+    refcount = --plan->refcount;
+    cvUnlockCaches();
+
+    if (refcount == 0)
+        cvFree(&plan);
+}
+
+/* returns the plan of the complex transform of <len> elements of
+   <elem_size> bytes; the caller releases it with icvReleaseDFTPlan */
+static CvDFTPlan* icvGetDFTPlan(int len, int elem_size, int inv_itab)
+{
+    CvDFTPlan *plan = 0, *dropped = 0;
+    int i, nf, factors[34];
+
+    nf = icvDFTFactorize(len, factors);
+
+    // the inverse permutation is only different for mixed radices
+    if (len <= 5 || factors[0] == factors[nf - 1])
+        inv_itab = 0;
+
+    if (len <= ICV_MAX_CACHED_DFT_LEN)
+    {
+        cvLockCaches();
+        for (i = 0; i < ICV_DFT_PLAN_CACHE_SIZE && icvDFTPlanCache[i]; i++)
+        {
+            CvDFTPlan* p = icvDFTPlanCache[i];
+            if (p->len == len && p->elem_size == elem_size
+                && p->inv_itab == inv_itab)
+            {
+                for (; i > 0; i--)
+                    icvDFTPlanCache[i] = icvDFTPlanCache[i - 1];
+                icvDFTPlanCache[0] = plan = p;
+                plan->refcount++;
+                break;
+            }
+        }
+        cvUnlockCaches();
+
+        if (plan)
+            return plan;
+    }
+
+    plan = (CvDFTPlan*)cvAlloc(sizeof(*plan) + len * (elem_size + sizeof(int))
+                               + 16);
+    if (!plan)
+        return 0;
+
+    plan->len = len;
+    plan->elem_size = elem_size;
+    plan->inv_itab = inv_itab;
+    plan->nf = nf;
+    memcpy(plan->factors, factors, nf * sizeof(factors[0]));
+    plan->wave = cvAlignPtr(plan + 1, 16);
+    plan->itab = (int*)((uchar*)plan->wave + len * elem_size);
+    plan->refcount = 1;
+    icvDFTInit(len, nf, factors, plan->itab, elem_size, plan->wave, inv_itab);
+
+    // two threads may add the same plan concurrently; the copy is harmless
+    // and is eventually dropped from the list
+    if (len <= ICV_MAX_CACHED_DFT_LEN)
+    {
+        plan->refcount++;
+        cvLockCaches();
+        dropped = icvDFTPlanCache[ICV_DFT_PLAN_CACHE_SIZE - 1];
+        for (i = ICV_DFT_PLAN_CACHE_SIZE - 1; i > 0; i--)
+            icvDFTPlanCache[i] = icvDFTPlanCache[i - 1];
+        icvDFTPlanCache[0] = plan;
+        cvUnlockCaches();
+        icvReleaseDFTPlan(&dropped);
+    }
+
+    return plan;
+}
+
+/* allocates the scratch buffer of a band: on the stack if it is small */
+#define ICV_DFT_ALLOC_BUF(buf, size)                 \
+    ((buf) = (size) <= CV_MAX_LOCAL_DFT_SIZE         \
+                 ? (uchar*)cvStackAlloc((size) + 32) \
+                 : (uchar*)cvAlloc((size) + 32))
+
+#define ICV_DFT_FREE_BUF(buf, size)     \
+    if ((size) > CV_MAX_LOCAL_DFT_SIZE) \
+        cvFree(&(buf))
+
+/* The row-wise transforms of a cvDFT stage, shared by the bands of rows
+   that cvParallelFor hands out */
+typedef struct CvDFTRowsBand
+{
+    CvDFTFunc func;
+    const uchar* src;
+    int src_step;
+    uchar* dst;
+    int dst_step;
+    int len, flags;
+    double scale;
+    const CvDFTPlan* plan;
+    const void* spec;
+    int tmp_size, buf_size;
+    int dptr_offset, dst_full_len;
+} CvDFTRowsBand;
+
+static int CV_CDECL icvDFTRowsBand(int start, int end, void* arg)
+{
+    const CvDFTRowsBand* p = (const CvDFTRowsBand*)arg;
+    const CvDFTPlan* plan = p->plan;
+    int size = p->tmp_size + p->buf_size;
+    int i, nf = plan ? plan->nf : 0, factors[34];
+    uchar *buffer, *tmp_buf = 0, *ptr;
+    CvStatus status = CV_OK;
+
+    if (!ICV_DFT_ALLOC_BUF(buffer, size))
+        return CV_StsNoMem;
+
+    ptr = (uchar*)cvAlignPtr(buffer, 16);
+    if (p->tmp_size)
+    {
+        tmp_buf = ptr;
+        ptr += p->tmp_size;
+    }
+
+    // the real transforms modify the factors on the fly
+    if (plan)
+        memcpy(factors, plan->factors, nf * sizeof(factors[0]));
+
+    for (i = start; i < end && status >= 0; i++)
+    {
+        const uchar* sptr = p->src + (size_t)i * p->src_step;
+        uchar* dptr0 = p->dst + (size_t)i * p->dst_step;
+        uchar* dptr = tmp_buf ? tmp_buf : dptr0;
+
+        status = p->func(sptr, dptr, p->len, nf, factors,
+                         plan ? plan->itab : 0, plan ? plan->wave : 0, p->len,
+                         p->spec, ptr, p->flags, p->scale);
+        if (dptr != dptr0)
+            memcpy(dptr0, dptr + p->dptr_offset, p->dst_full_len);
+    }
+
+    ICV_DFT_FREE_BUF(buffer, size);
+    return status;
+}
+
+/* the width of the column blocks the column-wise transforms gather and
+   scatter at once, in bytes: a cache line of every row */
+#define ICV_DFT_COL_BLOCK 64
+
+/* The column-wise transforms of a cvDFT stage, shared by the blocks of
+   complex columns that cvParallelFor hands out */
+typedef struct CvDFTColsBand
+{
+    CvDFTFunc func;
+    const uchar* src;
+    int src_step;
+    uchar* dst;
+    int dst_step;
+    int len, count, block, elem_size, inv;
+    double scale;
+    const CvDFTPlan* plan;
+    const void* spec;
+    int use_buf, buf_size;
+} CvDFTColsBand;
+
+static int CV_CDECL icvDFTColsBand(int start, int end, void* arg)
+{
+    const CvDFTColsBand* p = (const CvDFTColsBand*)arg;
+    const CvDFTPlan* plan = p->plan;
+    int len = p->len, es = p->elem_size, vec_size = len * es;
+    int size = p->block * vec_size * (p->use_buf ? 2 : 1) + p->buf_size;
+    int i, j, nf = plan ? plan->nf : 0, factors[34];
+    uchar *buffer, *cbuf, *dbuf, *ptr;
+    CvStatus status = CV_OK;
+
+    if (!ICV_DFT_ALLOC_BUF(buffer, size))
+        return CV_StsNoMem;
+
+    cbuf = dbuf = (uchar*)cvAlignPtr(buffer, 16);
+    ptr = cbuf + p->block * vec_size;
+    if (p->use_buf)
+    {
+        dbuf = ptr;
+        ptr += p->block * vec_size;
+    }
+
+    if (plan)
+        memcpy(factors, plan->factors, nf * sizeof(factors[0]));
+
+    for (i = start; i < end && status >= 0; i++)
+    {
+        int col = i * p->block, cols = MIN(p->block, p->count - col);
+
+        icvCopyFromColumns(p->src + col * es, p->src_step, cbuf, len, cols,
+                           es);
+        for (j = 0; j < cols && status >= 0; j++)
+            status = p->func(cbuf + j * vec_size, dbuf + j * vec_size, len,
+                             nf, factors, plan ? plan->itab : 0,
+                             plan ? plan->wave : 0, len, p->spec, ptr, p->inv,
+                             p->scale);
+        icvCopyToColumns(dbuf, p->dst + col * es, p->dst_step, len, cols, es);
+    }
+
+    ICV_DFT_FREE_BUF(buffer, size);
+    return status;
+}
+
 CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                    int nonzero_rows)
 {
@@ -1945,12 +2161,13 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
     int local_alloc = 1;
     int depth = -1;
     void *spec_c = 0, *spec_r = 0, *spec = 0;
+    CvDFTPlan* plan = 0;
 
     CV_FUNCNAME("cvDFT");
 
     __BEGIN__;
 
-    int prev_len = 0, buf_size = 0, stage = 0;
+    int buf_size = 0, stage = 0;
     int nf = 0, inv = (flags & CV_DXT_INVERSE) != 0;
     int real_transform = 0;
     CvMat *src = (CvMat*)srcarr, *dst = (CvMat*)dstarr;
@@ -2059,10 +2276,12 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
         uchar* wave = 0;
         int* itab = 0;
         uchar* ptr;
-        int i, len, count, sz = 0;
+        int i, len, count, sz = 0, scratch_sz = 0;
         int use_buf = 0, odd_real = 0;
         CvDFTFunc dft_func;
 
+        icvReleaseDFTPlan(&plan);
+
         if (stage == 0) // row-wise transform
         {
             len = !inv ? src->cols : dst->cols;
@@ -2078,7 +2297,6 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
         {
             len = dst->rows;
             count = !inv ? src0->cols : dst->cols;
-            sz = 2 * len * complex_elem_size;
         }
 
         spec = 0;
@@ -2128,34 +2346,36 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                 spec = spec_c;
             }
 
-            sz += ipp_sz;
+            scratch_sz = cvAlign(ipp_sz, 16);
         }
         else
         {
-            if (len != prev_len)
-                nf = icvDFTFactorize(len, factors);
+            CV_CALL(plan = icvGetDFTPlan(len, complex_elem_size,
+                                         stage == 0 && inv && real_transform));
+            nf = plan->nf;
+            memcpy(factors, plan->factors, nf * sizeof(factors[0]));
+            itab = plan->itab;
+            wave = (uchar*)plan->wave;
 
             inplace_transform = factors[0] == factors[nf - 1];
-            sz += len * (complex_elem_size + sizeof(int));
             i = nf > 1 && (factors[0] & 1) == 0;
             if ((factors[i] & 1) != 0 && factors[i] > 5)
-                sz += (factors[i] + 1) * complex_elem_size;
+                scratch_sz = (factors[i] + 1) * complex_elem_size;
 
             if (stage == 0
                     && (src->data.ptr == dst->data.ptr && !inplace_transform
                         || odd_real)
                 || stage == 1 && !inplace_transform)
-            {
                 use_buf = 1;
-                sz += len * complex_elem_size;
-            }
         }
 
+        // the bands of the transforms allocate their buffers themselves;
+        // the first and the last columns of the real transforms use this
+        if (stage == 1 && real_transform)
+            sz = (use_buf ? 3 : 2) * len * complex_elem_size + scratch_sz;
+
         if (sz > buf_size)
         {
-            prev_len = 0; // because we release the buffer,
-                          // force recalculation of
-                          // twiddle factors and permutation table
             if (!local_alloc && buffer)
                 cvFree(&buffer);
             if (sz <= CV_MAX_LOCAL_DFT_SIZE)
@@ -2172,38 +2392,20 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
             }
         }
 
-        ptr = (uchar*)buffer;
-        if (!spec)
-        {
-            wave = ptr;
-            ptr += len * complex_elem_size;
-            itab = (int*)ptr;
-            ptr = (uchar*)cvAlignPtr(ptr + len * sizeof(int), 16);
-
-            if (len != prev_len
-                || (!inplace_transform && inv && real_transform))
-                icvDFTInit(len, nf, factors, itab, complex_elem_size, wave,
-                           stage == 0 && inv && real_transform);
-            // otherwise reuse the tables calculated on the previous stage
-        }
+        ptr = (uchar*)cvAlignPtr(buffer, 16);
 
         if (stage == 0)
         {
-            uchar* tmp_buf = 0;
+            CvDFTRowsBand band;
             int dptr_offset = 0;
             int dst_full_len = len * elem_size;
             int _flags = inv
                          + (CV_MAT_CN(src->type) != CV_MAT_CN(dst->type)
                                 ? ICV_DFT_COMPLEX_INPUT_OR_OUTPUT
                                 : 0);
-            if (use_buf)
-            {
-                tmp_buf = ptr;
-                ptr += len * complex_elem_size;
-                if (odd_real && !inv && len > 1
-                    && !(_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
-                    dptr_offset = elem_size;
-            }
+            if (use_buf && odd_real && !inv && len > 1
+                && !(_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
+                dptr_offset = elem_size;
 
             if (!inv && (_flags & ICV_DFT_COMPLEX_INPUT_OR_OUTPUT))
                 dst_full_len += (len & 1) ? elem_size : complex_elem_size;
@@ -2222,22 +2424,25 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
             if (nonzero_rows <= 0 || nonzero_rows > count)
                 nonzero_rows = count;
 
-            for (i = 0; i < nonzero_rows; i++)
-            {
-                uchar* sptr = src->data.ptr + i * src->step;
-                uchar* dptr0 = dst->data.ptr + i * dst->step;
-                uchar* dptr = dptr0;
-
-                if (tmp_buf)
-                    dptr = tmp_buf;
-
-                dft_func(sptr, dptr, len, nf, factors, itab, wave, len, spec,
-                         ptr, _flags, scale);
-                if (dptr != dptr0)
-                    memcpy(dptr0, dptr + dptr_offset, dst_full_len);
-            }
-
-            for (; i < count; i++)
+            band.func = dft_func;
+            band.src = src->data.ptr;
+            band.src_step = src->step;
+            band.dst = dst->data.ptr;
+            band.dst_step = dst->step;
+            band.len = len;
+            band.flags = _flags;
+            band.scale = scale;
+            band.plan = plan;
+            band.spec = spec;
+            band.tmp_size = use_buf ? len * complex_elem_size : 0;
+            band.buf_size = scratch_sz;
+            band.dptr_offset = dptr_offset;
+            band.dst_full_len = dst_full_len;
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nonzero_rows),
+                                              icvDFTRowsBand, &band,
+                                              CV_PARALLEL_GRAIN(len)));
+
+            for (i = nonzero_rows; i < count; i++)
             {
                 uchar* dptr0 = dst->data.ptr + i * dst->step;
                 memset(dptr0, 0, dst_full_len);
@@ -2374,30 +2579,28 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
                 }
             }
 
-            for (i = a; i < b; i += 2)
+            if (a < b)
             {
-                if (i + 1 < b)
-                {
-                    icvCopyFrom2Columns(sptr0, src->step, buf0, buf1, len,
-                                        complex_elem_size);
-                    IPPI_CALL(dft_func(buf1, dbuf1, len, nf, factors, itab,
-                                       wave, len, spec, ptr, inv, scale));
-                }
-                else
-                    icvCopyColumn(sptr0, src->step, buf0, complex_elem_size,
-                                  len, complex_elem_size);
-
-                IPPI_CALL(dft_func(buf0, dbuf0, len, nf, factors, itab, wave,
-                                   len, spec, ptr, inv, scale));
-
-                if (i + 1 < b)
-                    icvCopyTo2Columns(dbuf0, dbuf1, dptr0, dst->step, len,
-                                      complex_elem_size);
-                else
-                    icvCopyColumn(dbuf0, complex_elem_size, dptr0, dst->step,
-                                  len, complex_elem_size);
-                sptr0 += 2 * complex_elem_size;
-                dptr0 += 2 * complex_elem_size;
+                CvDFTColsBand band;
+                band.func = dft_func;
+                band.src = sptr0;
+                band.src_step = src->step;
+                band.dst = dptr0;
+                band.dst_step = dst->step;
+                band.len = len;
+                band.count = b - a;
+                band.block = ICV_DFT_COL_BLOCK / complex_elem_size;
+                band.elem_size = complex_elem_size;
+                band.inv = inv;
+                band.scale = scale;
+                band.plan = plan;
+                band.spec = spec;
+                band.use_buf = use_buf;
+                band.buf_size = scratch_sz;
+                IPPI_CALL((CvStatus)cvParallelFor(
+                    cvSlice(0, (band.count + band.block - 1) / band.block),
+                    icvDFTColsBand, &band,
+                    CV_PARALLEL_GRAIN(band.block * len)));
             }
 
             if (stage != 0)
@@ -2411,6 +2614,8 @@ CV_IMPL void cvDFT(const CvArr* srcarr, CvArr* dstarr, int flags,
     if (buffer && !local_alloc)
         cvFree(&buffer);
 
+    icvReleaseDFTPlan(&plan);
+
     if (spec_c)
     {
         if (depth == CV_32F)
@@ -209,9 +209,406 @@ typedef CvStatus(CV_STDCALL* CvLUT_TransformCnFunc)(const void* src,
                                                     int dststep, CvSize size,
                                                     const void* lut, int cn);
 
+/****************************************************************************************\
+*                  LUT Transform of 16-bit data and interpolated shaper LUT *
+\****************************************************************************************/
+
+/* 16-bit sources index a 65536-entry table; cn is the number of the table
+   channels, 1 (the table is shared by all the channels) or 2..4 */
+#define ICV_LUT_16U_BODY(dsttype)                         \
+    srcstep /= sizeof(src[0]);                            \
+    dststep /= sizeof(dst[0]);                            \
+    size.width *= cn;                                     \
+                                                          \
+    for (; size.height--; src += srcstep, dst += dststep) \
+    {                                                     \
+        int i;                                            \
+        if (cn == 1)                                      \
+        {                                                 \
+            ICV_LUT_CASE_C1(dsttype)                      \
+        }                                                 \
+        else if (cn == 2)                                 \
+        {                                                 \
+            ICV_LUT_CASE_C2(dsttype)                      \
+        }                                                 \
+        else if (cn == 3)                                 \
+        {                                                 \
+            ICV_LUT_CASE_C3(dsttype)                      \
+        }                                                 \
+        else                                              \
+        {                                                 \
+            ICV_LUT_CASE_C4(dsttype)                      \
+        }                                                 \
+    }                                                     \
+                                                          \
+    return CV_OK;
+
+#define ICV_DEF_LUT_FUNC_16U(flavor, dsttype)                      \
+    static CvStatus CV_STDCALL icvLUT_Transform16u_##flavor##_CnR( \
+        const ushort* src, int srcstep, dsttype* dst, int dststep, \
+        CvSize size, const dsttype* lut, int cn)                   \
+    {                                                              \
+        ICV_LUT_16U_BODY(dsttype)                                  \
+    }
+
+ICV_DEF_LUT_FUNC_16U(8u, uchar)
+ICV_DEF_LUT_FUNC_16U(16u, ushort)
+ICV_DEF_LUT_FUNC_16U(64f, double)
+
+/* 32-bit tables are gathered by the built-in SIMD version, if any */
+IPCVAPI_IMPL(CvStatus, icvLUT_Transform16u_32s_CnR,
+             (const ushort* src, int srcstep, int* dst, int dststep,
+              CvSize size, const int* lut, int cn),
+             (src, srcstep, dst, dststep, size, lut, cn))
+{
+    ICV_LUT_16U_BODY(int)
+}
+
+#define icvLUT_Transform16u_8s_CnR icvLUT_Transform16u_8u_CnR
+#define icvLUT_Transform16u_16s_CnR icvLUT_Transform16u_16u_CnR
+#define icvLUT_Transform16u_32f_CnR icvLUT_Transform16u_32s_CnR
+
+CV_DEF_INIT_FUNC_TAB_2D(LUT_Transform16u, CnR)
+
+/* the mantissa bits of a float */
+#define ICV_LUT_MANTISSA_MASK ((1 << 23) - 1)
+
+/* The log-spaced shaper LUT: the entries start at the power of two that is
+   not above min_val (the integer image of min_val with the mantissa bits
+   cleared) and there are as many of them in every octave. If the table has
+   an entry per octave of the range or more, the number per octave is made
+   integral, so every power of two is a sample and the table is linear in
+   the value between two neighbouring samples; the last samples may then go
+   past max_val. Returns the number of the entries per octave */
+static double icvShaperLUTPerOctave(int lut_size, float min_val,
+                                    float max_val)
+{
+    Cv32suf a, b;
+    double per_octave;
+
+    a.f = min_val;
+    b.f = max_val;
+    a.i &= ~ICV_LUT_MANTISSA_MASK;
+    per_octave = (lut_size - 1) * (double)(1 << 23) / ((double)b.i - a.i);
+
+    return per_octave >= 1 ? floor(per_octave) : per_octave;
+}
+
+/* The shaper LUT: lut_size entries of every of the cn table channels sample
+   a function at lut_size points of [min_val,max_val], spaced uniformly or,
+   if log_spaced is set, uniformly in the pseudo-logarithm of the value (the
+   integer image of a positive float, i.e. exponent*2^23 + mantissa bits),
+   that is, by the same number per octave and linearly within an octave.
+   The log-spaced points start at the power of two below min_val (see
+   icvShaperLUTPerOctave). The source values are clipped to the range and
+   the result is linearly interpolated between the two nearest entries. The
+   SIMD version repeats the arithmetics operation by operation and gives
+   the same results */
+IPCVAPI_IMPL(CvStatus, icvLUTInterp_32f_CnR,
+             (const float* src, int srcstep, float* dst, int dststep,
+              CvSize size, const float* lut, int lut_size, int cn,
+              float min_val, float max_val, float scale, int log_spaced),
+             (src, srcstep, dst, dststep, size, lut, lut_size, cn, min_val,
+              max_val, scale, log_spaced))
+{
+    float tmax = (float)(lut_size - 1);
+    int imax = lut_size - 2;
+    Cv32suf base;
+
+    base.f = min_val;
+    base.i &= ~ICV_LUT_MANTISSA_MASK;
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    size.width *= cn;
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i, k = 0;
+
+        for (i = 0; i < size.width; i++)
+        {
+            Cv32suf v;
+            float t, f;
+            const float* l;
+            int idx;
+
+            v.f = src[i];
+            v.f = v.f > min_val ? v.f : min_val;
+            v.f = v.f < max_val ? v.f : max_val;
+            t = log_spaced ? (float)(v.i - base.i) * scale
+                           : (v.f - min_val) * scale;
+            t = t < tmax ? t : tmax;
+            idx = (int)t;
+            idx = idx < imax ? idx : imax;
+            f = t - (float)idx;
+            l = lut + idx * cn + k;
+            dst[i] = l[0] + f * (l[cn] - l[0]);
+
+            if (++k >= cn)
+                k = 0;
+        }
+    }
+
+    return CV_OK;
+}
+
+/* The 16-bit and the shaper LUT are run in parallel over bands of rows
+   (or, for continuous arrays processed as a single row, of pixels) */
+typedef struct CvLUTBand
+{
+    const uchar* src;
+    int src_step, src_pix_size;
+    uchar* dst;
+    int dst_step, dst_pix_size;
+    CvSize size;
+    const void* lut;
+    int cn;
+    CvLUT_TransformCnFunc func;
+
+    /* the shaper LUT parameters */
+    int lut_size, log_spaced;
+    float min_val, max_val, scale;
+} CvLUTBand;
+
+static int CV_CDECL icvLUTBand(int start, int end, void* arg)
+{
+    const CvLUTBand* p = (const CvLUTBand*)arg;
+    const uchar* src = p->src;
+    uchar* dst = p->dst;
+    CvSize size = p->size;
+
+    if (size.height == 1)
+    {
+        src += start * p->src_pix_size;
+        dst += start * p->dst_pix_size;
+        size.width = end - start;
+    }
+    else
+    {
+        src += start * p->src_step;
+        dst += start * p->dst_step;
+        size.height = end - start;
+    }
+
+    if (p->func)
+        return p->func(src, p->src_step, dst, p->dst_step, size, p->lut, p->cn);
+
+    return icvLUTInterp_32f_CnR((const float*)src, p->src_step, (float*)dst,
+                                p->dst_step, size, (const float*)p->lut,
+                                p->lut_size, p->cn, p->min_val, p->max_val,
+                                p->scale, p->log_spaced);
+}
+
+static CvStatus icvRunLUTBands(CvLUTBand* band)
+{
+    CvSlice range;
+    int grain;
+
+    if (band->size.height == 1)
+    {
+        range = cvSlice(0, band->size.width);
+        grain = CV_PARALLEL_MIN_PIXELS;
+    }
+    else
+    {
+        range = cvSlice(0, band->size.height);
+        grain = CV_PARALLEL_GRAIN(band->size.width);
+    }
+
+    return (CvStatus)cvParallelFor(range, icvLUTBand, band, grain);
+}
+
+/* Checks the arrays and fills the band description that is common for
+   the 16-bit and the shaper LUT */
+static void icvInitLUTBand(CvLUTBand* band, const CvMat* src, const CvMat* dst,
+                           const CvMat* lut)
+{
+    CV_FUNCNAME("icvInitLUTBand");
+
+    __BEGIN__;
+
+    int cn = CV_MAT_CN(dst->type), lut_cn = CV_MAT_CN(lut->type);
+    int src_step = src->step, dst_step = dst->step;
+    CvSize size = cvGetMatSize(src);
+
+    if (!CV_ARE_SIZES_EQ(src, dst))
+        CV_ERROR(CV_StsUnmatchedSizes, "");
+
+    if (!CV_ARE_CNS_EQ(src, dst))
+        CV_ERROR(CV_StsUnmatchedFormats, "");
+
+    if (!CV_IS_MAT_CONT(lut->type) || (lut_cn != 1 && lut_cn != cn)
+        || !CV_ARE_DEPTHS_EQ(dst, lut))
+        CV_ERROR(CV_StsBadArg,
+                 "The LUT must be continuous array with 1 or as many "
+                 "channels as the destination and of the same depth");
+
+    if (lut_cn == 1)
+    {
+        size.width *= cn;
+        cn = 1;
+    }
+
+    if (CV_IS_MAT_CONT(src->type & dst->type))
+    {
+        size.width *= size.height;
+        size.height = 1;
+        src_step = dst_step = CV_STUB_STEP;
+    }
+
+    memset(band, 0, sizeof(*band));
+    band->src = src->data.ptr;
+    band->src_step = src_step;
+    band->src_pix_size = CV_ELEM_SIZE1(src->type) * cn;
+    band->dst = dst->data.ptr;
+    band->dst_step = dst_step;
+    band->dst_pix_size = CV_ELEM_SIZE1(dst->type) * cn;
+    band->size = size;
+    band->lut = lut->data.ptr;
+    band->cn = cn;
+    band->lut_size = lut->rows * lut->cols;
+
+    __END__;
+}
+
+CV_IMPL void cvShaperLUT(const void* srcarr, void* dstarr, const void* lutarr,
+                         double min_val, double max_val, int flags)
+{
+    CV_FUNCNAME("cvShaperLUT");
+
+    __BEGIN__;
+
+    int coi1 = 0, coi2 = 0;
+    CvMat srcstub, *src = (CvMat*)srcarr;
+    CvMat dststub, *dst = (CvMat*)dstarr;
+    CvMat lutstub, *lut = (CvMat*)lutarr;
+    CvLUTBand band;
+    double range;
+
+    if (!CV_IS_MAT(src))
+        CV_CALL(src = cvGetMat(src, &srcstub, &coi1));
+
+    if (!CV_IS_MAT(dst))
+        CV_CALL(dst = cvGetMat(dst, &dststub, &coi2));
+
+    if (!CV_IS_MAT(lut))
+        CV_CALL(lut = cvGetMat(lut, &lutstub));
+
+    if (coi1 != 0 || coi2 != 0)
+        CV_ERROR(CV_BadCOI, "");
+
+    if (CV_MAT_DEPTH(src->type) != CV_32F || CV_MAT_DEPTH(dst->type) != CV_32F)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "The source and the destination must be 32-bit float");
+
+    CV_CALL(icvInitLUTBand(&band, src, dst, lut));
+
+    if (band.lut_size < 2)
+        CV_ERROR(CV_StsBadSize, "The shaper LUT must have 2 or more entries");
+
+    if (flags != CV_LUT_UNIFORM && flags != CV_LUT_LOG)
+        CV_ERROR(CV_StsBadFlag, "Unknown LUT spacing");
+
+    if (!(min_val < max_val) || (flags == CV_LUT_LOG && !(min_val > 0)))
+        CV_ERROR(CV_StsOutOfRange,
+                 "The range is empty or, for the log-spaced LUT, not positive");
+
+    band.min_val = (float)min_val;
+    band.max_val = (float)max_val;
+    band.log_spaced = flags == CV_LUT_LOG;
+
+    if (band.log_spaced)
+    {
+        Cv32suf a, b;
+        a.f = band.min_val;
+        b.f = band.max_val;
+        range = (double)b.i - a.i;
+    }
+    else
+        range = (double)band.max_val - band.min_val;
+
+    if (range <= 0)
+        CV_ERROR(CV_StsOutOfRange, "The range is empty in 32-bit float");
+
+    band.scale = band.log_spaced
+                     ? (float)(icvShaperLUTPerOctave(band.lut_size,
+                                                     band.min_val,
+                                                     band.max_val)
+                               / (1 << 23))
+                     : (float)((band.lut_size - 1) / range);
+
+    IPPI_CALL(icvRunLUTBands(&band));
+
+    __END__;
+}
+
+CV_IMPL void cvShaperLUTSamples(CvArr* samplesarr, double min_val,
+                                double max_val, int flags)
+{
+    CV_FUNCNAME("cvShaperLUTSamples");
+
+    __BEGIN__;
+
+    CvMat stub, *samples = (CvMat*)samplesarr;
+    float* data;
+    int i, n;
+
+    if (!CV_IS_MAT(samples))
+        CV_CALL(samples = cvGetMat(samples, &stub));
+
+    if (CV_MAT_TYPE(samples->type) != CV_32FC1
+        || !CV_IS_MAT_CONT(samples->type))
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "The samples must be continuous 32fC1 array");
+
+    n = samples->rows * samples->cols;
+    if (n < 2)
+        CV_ERROR(CV_StsBadSize, "The shaper LUT must have 2 or more entries");
+
+    if (flags != CV_LUT_UNIFORM && flags != CV_LUT_LOG)
+        CV_ERROR(CV_StsBadFlag, "Unknown LUT spacing");
+
+    if (!(min_val < max_val) || (flags == CV_LUT_LOG && !(min_val > 0)))
+        CV_ERROR(CV_StsOutOfRange,
+                 "The range is empty or, for the log-spaced LUT, not positive");
+
+    data = samples->data.fl;
+
+    if (flags == CV_LUT_LOG)
+    {
+        double per_octave =
+            icvShaperLUTPerOctave(n, (float)min_val, (float)max_val);
+        Cv32suf a;
+        double base;
+
+        a.f = (float)min_val;
+        base = (double)(a.i >> 23);
+
+        // the sample i is at i/per_octave octaves from the base, linearly
+        // within its octave; the exponent 0 is the linear range of the
+        // denormals
+        for (i = 0; i < n; i++)
+        {
+            double p = base + i / per_octave;
+            int e = cvFloor(p);
+            double v = e == 0 ? ldexp(p, -126) : ldexp(1 + (p - e), e - 127);
+            data[i] = (float)MIN(v, FLT_MAX);
+        }
+    }
+    else
+    {
+        double delta = (max_val - min_val) / (n - 1);
+        for (i = 0; i < n; i++)
+            data[i] = (float)(min_val + i * delta);
+        data[n - 1] = (float)max_val;
+    }
+
+    __END__;
+}
+
 CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
 {
-    static CvFuncTable lut_c1_tab, lut_cn_tab;
+    static CvFuncTable lut_c1_tab, lut_cn_tab, lut_16u_tab;
     static CvLUT_TransformFunc lut_8u_tab[4];
     static int inittab = 0;
 
@@ -232,6 +629,7 @@ CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
     {
         icvInitLUT_Transform8uC1RTable(&lut_c1_tab);
         icvInitLUT_Transform8uCnRTable(&lut_cn_tab);
+        icvInitLUT_Transform16uCnRTable(&lut_16u_tab);
         lut_8u_tab[0] = (CvLUT_TransformFunc)icvLUT_Transform8u_8u_C1R;
         lut_8u_tab[1] = (CvLUT_TransformFunc)icvLUT_Transform8u_8u_C2R;
         lut_8u_tab[2] = (CvLUT_TransformFunc)icvLUT_Transform8u_8u_C3R;
@@ -251,6 +649,32 @@ CV_IMPL void cvLUT(const void* srcarr, void* dstarr, const void* lutarr)
     if (coi1 != 0 || coi2 != 0)
         CV_ERROR(CV_BadCOI, "");
 
+    if (CV_MAT_DEPTH(src->type) == CV_32F)
+    {
+        // the shaper LUT sampling [0,1] uniformly
+        CV_CALL(cvShaperLUT(src, dst, lut, 0, 1, CV_LUT_UNIFORM));
+        EXIT;
+    }
+
+    if (CV_MAT_DEPTH(src->type) == CV_16U)
+    {
+        CvLUTBand band;
+
+        CV_CALL(icvInitLUTBand(&band, src, dst, lut));
+
+        if (band.lut_size != 65536)
+            CV_ERROR(CV_StsBadArg,
+                     "The LUT for 16-bit data must have 65536 elements");
+
+        band.func = (CvLUT_TransformCnFunc)(
+            lut_16u_tab.fn_2d[CV_MAT_DEPTH(dst->type)]);
+        if (!band.func)
+            CV_ERROR(CV_StsUnsupportedFormat, "");
+
+        IPPI_CALL(icvRunLUTBands(&band));
+        EXIT;
+    }
+
     if (!CV_ARE_SIZES_EQ(src, dst))
         CV_ERROR(CV_StsUnmatchedSizes, "");
 
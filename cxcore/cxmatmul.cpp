@@ -1656,6 +1656,8 @@ icvColorTwist_8u_C3R_t icvColorTwist_8u_C3R_p = 0;
 icvColorTwist_16u_C3R_t icvColorTwist_16u_C3R_p = 0;
 icvColorTwist_16s_C3R_t icvColorTwist_16s_C3R_p = 0;
 icvColorTwist_32f_C3R_t icvColorTwist_32f_C3R_p = 0;
+icvColorTwist_8u_C4R_t icvColorTwist_8u_C4R_p = 0;
+icvColorTwist_16u_C4R_t icvColorTwist_16u_C4R_p = 0;
 icvColorTwist_32f_C4R_t icvColorTwist_32f_C4R_p = 0;
 
 icvColorToGray_8u_C3C1R_t icvColorToGray_8u_C3C1R_p = 0;
@@ -1709,7 +1711,7 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
     if (CV_IS_SEQ(src))
     {
         src_seq = (CvSeq*)src;
-        if (CV_ELEM_SIZE(src_seq->flags) != src_seq->elem_size)
+        if (CV_SEQ_ELTYPE_SIZE(src_seq) != src_seq->elem_size)
             CV_ERROR(CV_StsUnsupportedFormat,
                      "Unsupported type of sequence elements");
     }
@@ -1719,7 +1721,7 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
     if (CV_IS_SEQ(dst))
     {
         dst_seq = (CvSeq*)dst;
-        if (CV_ELEM_SIZE(dst_seq->flags) != dst_seq->elem_size)
+        if (CV_SEQ_ELTYPE_SIZE(dst_seq) != dst_seq->elem_size)
             CV_ERROR(CV_StsUnsupportedFormat,
                      "Unsupported type of sequence elements");
     }
@@ -1872,12 +1874,15 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
                        : type == CV_16UC3 ? icvColorTwist_16u_C3R_p
                        : type == CV_16SC3 ? icvColorTwist_16s_C3R_p
                        : type == CV_32FC3 ? icvColorTwist_32f_C3R_p
-                       : type == CV_32FC4 && fabs(buffer[4]) < DBL_EPSILON
-                               && fabs(buffer[9]) < DBL_EPSILON
-                               && fabs(buffer[14]) < DBL_EPSILON
-                               && fabs(buffer[19]) < DBL_EPSILON
-                           ? icvColorTwist_32f_C4R_p
-                           : 0;
+                       : cn != 4 || fabs(buffer[4]) >= DBL_EPSILON
+                               || fabs(buffer[9]) >= DBL_EPSILON
+                               || fabs(buffer[14]) >= DBL_EPSILON
+                               || fabs(buffer[19]) >= DBL_EPSILON
+                           ? 0
+                       : type == CV_8UC4  ? icvColorTwist_8u_C4R_p
+                       : type == CV_16UC4 ? icvColorTwist_16u_C4R_p
+                       : type == CV_32FC4 ? icvColorTwist_32f_C4R_p
+                                          : 0;
         else if (dst_cn == 1 && (cn == 3 || cn == 4) && buffer[0] >= 0
                  && buffer[1] >= 0 && buffer[2] >= 0
                  && buffer[0] + buffer[1] + buffer[2] <= 1.01
@@ -1992,8 +1997,8 @@ CV_IMPL void cvTransform(const CvArr* srcarr, CvArr* dstarr,
             CvSeqBlock* src_block = src_seq->first;
             CvSeqBlock* dst_block = dst_seq->first;
             int src_idx = 0, dst_idx = 0;
-            int src_elem_size = CV_ELEM_SIZE(src_seq->flags);
-            int dst_elem_size = CV_ELEM_SIZE(dst_seq->flags);
+            int src_elem_size = CV_SEQ_ELTYPE_SIZE(src_seq);
+            int dst_elem_size = CV_SEQ_ELTYPE_SIZE(dst_seq);
 
             for (i = src_seq->total; i > 0;)
             {
@@ -111,11 +111,14 @@ direct,
 #define CV_MAX_STRLEN 1024
 
 /* maximum possible number of threads in parallel implementations */
-#ifdef _OPENMP
 #define CV_MAX_THREADS 128
-#else
-#define CV_MAX_THREADS 1
-#endif
+
+/* minimal number of pixels in a band of rows processed by a thread */
+#define CV_PARALLEL_MIN_PIXELS (1 << 14)
+
+/* cvParallelFor grain for a loop over the rows of the given width */
+#define CV_PARALLEL_GRAIN(width) \
+    MAX(CV_PARALLEL_MIN_PIXELS / MAX((width), 1), 1)
 
 #if 0 /*def  CV_CHECK_FOR_NANS*/
 #define CV_CHECK_NANS(arr) cvCheckArray((arr))
@@ -212,6 +215,9 @@ direct,
 #define CV_CAST_64S(t) (int64)(t)
 #define CV_CAST_32F(t) (float)(t)
 #define CV_CAST_64F(t) (double)(t)
+#define CV_CAST_16F(t) cvFloatToHalf((float)(t))
+
+#define CV_16FTO32F(x) cvHalfToFloat(x)
 
 #define CV_PASTE2(a, b) a##b
 #define CV_PASTE(a, b) CV_PASTE2(a, b)
@@ -673,6 +679,7 @@ typedef enum CvStatus
 #define CV_PLUGIN_IPPVM 5 /* IPP: vector math functions */
 #define CV_PLUGIN_IPPCC 6 /* IPP: color space conversion */
 #define CV_PLUGIN_MKL 8   /* Intel Math Kernel Library */
+#define CV_PLUGIN_BUILTIN 9 /* built-in SIMD functions, see cxswitcher.cpp */
 
 #define CV_PLUGIN_MAX 16
 
@@ -683,6 +690,28 @@ typedef enum CvStatus
 
 #define CV_NOTHROW throw()
 
+/* Built-in SIMD functions are compiled for several instruction sets at once
+   and selected at run time according to cvGetCPUFeatures() */
+#if (defined __GNUC__ || defined __clang__) \
+    && (defined __i386__ || defined __x86_64__)
+#define CV_BUILTIN_SIMD 1
+#define CV_TARGET_SSE2 __attribute__((target("sse2")))
+#define CV_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#define CV_TARGET_AVX2 __attribute__((target("avx2")))
+#define CV_TARGET_AVX512 __attribute__((target("avx512f")))
+#define CV_TARGET_F16C __attribute__((target("avx,f16c")))
+#elif defined _MSC_VER && _MSC_VER >= 1910 \
+    && (defined _M_IX86 || defined _M_X64)
+#define CV_BUILTIN_SIMD 1
+#define CV_TARGET_SSE2
+#define CV_TARGET_SSE4_1
+#define CV_TARGET_AVX2
+#define CV_TARGET_AVX512
+#define CV_TARGET_F16C
+#else
+#define CV_BUILTIN_SIMD 0
+#endif
+
 #ifndef IPCVAPI
 #define IPCVAPI(type, declspec, name, args) \
     /* function pointer */                  \
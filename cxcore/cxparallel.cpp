@@ -0,0 +1,385 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "_cxcore.h"
+
+#if defined WIN32 || defined WIN64
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/****************************************************************************************\
+*                                      Thread pool *
+\****************************************************************************************/
+
+/* A call of cvParallelFor is a job. The range is split evenly into one slot
+   per participant; every participant processes its slot from the front, in
+   chunks, and when it is exhausted takes the upper half of the largest
+   remaining slot. The calling thread is always participant #0, so a job
+   completes even if all the pool threads are busy with other jobs. */
+typedef struct CvParallelJob
+{
+    CvParallelLoopBody body;
+    void* userdata;
+    int grain;
+    int chunk;
+    int slot_count;
+    int joined;
+    int active;
+    int status;
+    CvSlice slots[CV_MAX_THREADS];
+    struct CvParallelJob* next;
+} CvParallelJob;
+
+static CvParallelJob* icvPoolJobs = 0;
+static int icvPoolThreads = 0;
+
+static void icvPoolThread(void);
+
+/* the pool mutex and conditions, the index of the participant the thread
+   is (plus one, 0 outside of the jobs) and the pool thread start */
+#if defined WIN32 || defined WIN64
+
+static SRWLOCK icvPoolMutex = SRWLOCK_INIT;
+static CONDITION_VARIABLE icvPoolWork = CONDITION_VARIABLE_INIT;
+static CONDITION_VARIABLE icvPoolDone = CONDITION_VARIABLE_INIT;
+static DWORD icvThreadIdxKey = TLS_OUT_OF_INDEXES;
+static INIT_ONCE icvThreadIdxOnce = INIT_ONCE_STATIC_INIT;
+
+static void icvLockPool(void) { AcquireSRWLockExclusive(&icvPoolMutex); }
+
+static void icvUnlockPool(void) { ReleaseSRWLockExclusive(&icvPoolMutex); }
+
+static void icvWaitPool(CONDITION_VARIABLE* cond)
+{
+    SleepConditionVariableSRW(cond, &icvPoolMutex, INFINITE, 0);
+}
+
+static void icvWakePool(CONDITION_VARIABLE* cond)
+{
+    WakeAllConditionVariable(cond);
+}
+
+static BOOL CALLBACK icvInitThreadIdxKey(PINIT_ONCE, PVOID, PVOID*)
+{
+    icvThreadIdxKey = TlsAlloc();
+    return TRUE;
+}
+
+static int icvGetThreadIdx(void)
+{
+    InitOnceExecuteOnce(&icvThreadIdxOnce, icvInitThreadIdxKey, 0, 0);
+    return (int)(size_t)TlsGetValue(icvThreadIdxKey);
+}
+
+static void icvSetThreadIdx(int idx)
+{
+    TlsSetValue(icvThreadIdxKey, (void*)(size_t)idx);
+}
+
+static DWORD WINAPI icvPoolThreadProc(LPVOID)
+{
+    icvPoolThread();
+    return 0;
+}
+
+static int icvStartPoolThread(void)
+{
+    HANDLE thread = CreateThread(0, 0, icvPoolThreadProc, 0, 0, 0);
+
+    if (!thread)
+        return 0;
+    CloseHandle(thread);
+    return 1;
+}
+
+#else
+
+static pthread_mutex_t icvPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t icvPoolWork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t icvPoolDone = PTHREAD_COND_INITIALIZER;
+static pthread_key_t icvThreadIdxKey;
+static pthread_once_t icvThreadIdxOnce = PTHREAD_ONCE_INIT;
+
+static void icvLockPool(void) { pthread_mutex_lock(&icvPoolMutex); }
+
+static void icvUnlockPool(void) { pthread_mutex_unlock(&icvPoolMutex); }
+
+static void icvWaitPool(pthread_cond_t* cond)
+{
+    pthread_cond_wait(cond, &icvPoolMutex);
+}
+
+static void icvWakePool(pthread_cond_t* cond) { pthread_cond_broadcast(cond); }
+
+static void icvInitThreadIdxKey(void)
+{
+    pthread_key_create(&icvThreadIdxKey, 0);
+}
+
+static int icvGetThreadIdx(void)
+{
+    pthread_once(&icvThreadIdxOnce, icvInitThreadIdxKey);
+    return (int)(size_t)pthread_getspecific(icvThreadIdxKey);
+}
+
+static void icvSetThreadIdx(int idx)
+{
+    pthread_setspecific(icvThreadIdxKey, (void*)(size_t)idx);
+}
+
+static void* icvPoolThreadProc(void*)
+{
+    icvPoolThread();
+    return 0;
+}
+
+static int icvStartPoolThread(void)
+{
+    pthread_t thread;
+    pthread_attr_t attr;
+    int ok;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    ok = pthread_create(&thread, &attr, icvPoolThreadProc, 0) == 0;
+    pthread_attr_destroy(&attr);
+
+    return ok;
+}
+
+#endif
+
+static void icvUnlinkJob(CvParallelJob* job)
+{
+    CvParallelJob** prev = &icvPoolJobs;
+
+    while (*prev && *prev != job)
+        prev = &(*prev)->next;
+    if (*prev)
+        *prev = job->next;
+}
+
+/* runs the slot <idx> of the job and steals the work of other slots until
+   nothing is left. The pool mutex is locked on entry and on exit */
+static void icvRunJob(CvParallelJob* job, int idx)
+{
+    int prev_idx = icvGetThreadIdx();
+
+    icvSetThreadIdx(idx + 1);
+
+    while (job->status >= 0)
+    {
+        CvSlice* slot = job->slots + idx;
+        int start, end, status;
+
+        if (slot->start_index >= slot->end_index)
+        {
+            int i, victim = -1, len = 0;
+
+            for (i = 0; i < job->slot_count; i++)
+            {
+                int l = job->slots[i].end_index - job->slots[i].start_index;
+                if (l > len)
+                    victim = i, len = l;
+            }
+
+            if (victim < 0)
+                break;
+
+            if (len >= job->grain * 2)
+                len /= 2;
+            slot->end_index = job->slots[victim].end_index;
+            slot->start_index = job->slots[victim].end_index -= len;
+        }
+
+        start = slot->start_index;
+        end = MIN(start + job->chunk, slot->end_index);
+        if (slot->end_index - end < job->grain)
+            end = slot->end_index;
+        slot->start_index = end;
+
+        icvUnlockPool();
+        status = job->body(start, end, job->userdata);
+        icvLockPool();
+
+        if (status < 0 && job->status >= 0)
+            job->status = status;
+    }
+
+    icvSetThreadIdx(prev_idx);
+}
+
+static void icvPoolThread(void)
+{
+    icvLockPool();
+
+    for (;;)
+    {
+        CvParallelJob* job = icvPoolJobs;
+
+        if (!job)
+        {
+            icvWaitPool(&icvPoolWork);
+            continue;
+        }
+
+        if (++job->joined == job->slot_count)
+            icvUnlinkJob(job);
+        job->active++;
+        icvRunJob(job, job->joined - 1);
+        if (--job->active == 0)
+            icvWakePool(&icvPoolDone);
+    }
+}
+
+/* starts more pool threads if needed. Called with the pool mutex locked */
+static void icvGrowPool(int count)
+{
+    while (icvPoolThreads < count && icvStartPoolThread())
+        icvPoolThreads++;
+}
+
+CV_IMPL int cvGetThreadNum(void)
+{
+    int idx;
+
+#ifdef _OPENMP
+    if (omp_in_parallel())
+        return omp_get_thread_num();
+#endif
+
+    idx = icvGetThreadIdx();
+    return idx > 0 ? idx - 1 : 0;
+}
+
+CV_IMPL int cvParallelFor(CvSlice range, CvParallelLoopBody body,
+                          void* userdata, int grain)
+{
+    CvParallelJob job;
+    int i, len = range.end_index - range.start_index;
+    int threads = cvGetNumThreads();
+
+    if (!body)
+        return CV_StsNullPtr;
+
+    if (len <= 0)
+        return CV_StsOk;
+
+    grain = MAX(grain, 1);
+    job.slot_count = MIN(threads, len / grain);
+
+    // nested calls and small ranges run sequentially
+    if (job.slot_count <= 1 || icvGetThreadIdx() > 0)
+        return body(range.start_index, range.end_index, userdata);
+
+    job.body = body;
+    job.userdata = userdata;
+    job.grain = grain;
+    job.chunk = MAX(grain, len / (job.slot_count * 4));
+    job.joined = 1;
+    job.active = 1;
+    job.status = CV_StsOk;
+    job.next = 0;
+
+    for (i = 0; i < job.slot_count; i++)
+    {
+        job.slots[i].start_index =
+            range.start_index + (int)((int64)len * i / job.slot_count);
+        job.slots[i].end_index =
+            range.start_index + (int)((int64)len * (i + 1) / job.slot_count);
+    }
+
+    icvLockPool();
+
+    icvGrowPool(threads - 1);
+    if (icvPoolThreads > 0)
+    {
+        CvParallelJob** tail = &icvPoolJobs;
+        while (*tail)
+            tail = &(*tail)->next;
+        *tail = &job;
+        icvWakePool(&icvPoolWork);
+    }
+
+    icvRunJob(&job, 0);
+
+    // no new participants; wait for the ones still running their chunks
+    if (job.joined < job.slot_count)
+        icvUnlinkJob(&job);
+    job.active--;
+    while (job.active > 0)
+        icvWaitPool(&icvPoolDone);
+
+    icvUnlockPool();
+
+    return job.status;
+}
+
+/* the cache mutex is separate from the pool one: the caches are consulted
+   from inside the parallel loop bodies */
+#if defined WIN32 || defined WIN64
+
+static SRWLOCK icvCacheMutex = SRWLOCK_INIT;
+
+CV_IMPL void cvLockCaches(void) { AcquireSRWLockExclusive(&icvCacheMutex); }
+
+CV_IMPL void cvUnlockCaches(void) { ReleaseSRWLockExclusive(&icvCacheMutex); }
+
+#else
+
+static pthread_mutex_t icvCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+CV_IMPL void cvLockCaches(void) { pthread_mutex_lock(&icvCacheMutex); }
+
+CV_IMPL void cvUnlockCaches(void) { pthread_mutex_unlock(&icvCacheMutex); }
+
+#endif
+
+/* End of file. */
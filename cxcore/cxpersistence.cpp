@@ -49,6 +49,14 @@ direct,
 #include "_cxcore.h"
 #include <ctype.h>
 
+#if defined WIN32 || defined WIN64
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 /****************************************************************************************\
 *                            Common macros and type definitions *
 \****************************************************************************************/
@@ -93,6 +101,20 @@ typedef struct CvFileMapNode
     struct CvFileMapNode* next;
 } CvFileMapNode;
 
+/* a sequence of numbers stored as a raw payload of a binary storage; the
+   data points to the numbers in the mapped file, so that cvReadRawData can
+   copy them at once. The sequence has its total but no blocks until
+   cvGetSeqElem or cvStartReadSeq needs the nodes (see icvBuildLazySeq) */
+typedef struct CvFileRawSeq
+{
+    CV_SEQUENCE_FIELDS()
+    int depth;
+    const uchar* data;
+} CvFileRawSeq;
+
+#define CV_NODE_SEQ_RAW 512
+#define CV_NODE_SEQ_IS_RAW(seq) (((seq)->flags & CV_NODE_SEQ_RAW) != 0)
+
 typedef struct CvXMLStackRecord
 {
     CvMemStoragePos pos;
@@ -125,6 +147,7 @@ typedef struct CvFileStorage
 {
     int flags;
     int is_xml;
+    int is_bin;
     int write_mode;
     int is_first;
     CvMemStorage* memstorage;
@@ -156,8 +179,23 @@ typedef struct CvFileStorage
     CvWriteComment write_comment;
     CvStartNextStream start_next_stream;
     // CvParse parse;
+
+    /* binary storage: the current file offset, the index offset of the
+       count of the open raw payload (0 if none) and its depth; the mapped
+       (or read) file */
+    int64 file_pos;
+    int raw_count_pos;
+    int raw_depth;
+    uchar* map_ptr;
+    size_t map_size;
+    int map_is_alloc;
 } CvFileStorage;
 
+/* 'r', a reference (pointer-sized integer) in the format strings */
+#define CV_FS_REF CV_DEPTH_MAX
+#define CV_FS_ELEM_SIZE(type) \
+    ((type) == CV_FS_REF ? (int)sizeof(size_t) : CV_ELEM_SIZE(type))
+
 #define CV_YML_INDENT 3
 #define CV_XML_INDENT 2
 #define CV_YML_INDENT_FLOW 1
@@ -364,6 +402,9 @@ static char* icvFSFlush(CvFileStorage* fs)
     return ptr;
 }
 
+static void icvBinClose(CvFileStorage* fs);
+static void icvBinUnmapFile(CvFileStorage* fs);
+
 /* closes file storage and deallocates buffers */
 CV_IMPL void cvReleaseFileStorage(CvFileStorage** p_fs)
 {
@@ -386,9 +427,14 @@ CV_IMPL void cvReleaseFileStorage(CvFileStorage** p_fs)
                 while (fs->write_stack->total > 0)
                     cvEndWriteStruct(fs);
             }
-            icvFSFlush(fs);
-            if (fs->is_xml)
-                fputs("</opencv_storage>\n", fs->file);
+            if (fs->is_bin)
+                icvBinClose(fs);
+            else
+            {
+                icvFSFlush(fs);
+                if (fs->is_xml)
+                    fputs("</opencv_storage>\n", fs->file);
+            }
         }
 
         // icvFSReleaseCollection( fs->roots ); // delete all the user types
@@ -402,6 +448,7 @@ CV_IMPL void cvReleaseFileStorage(CvFileStorage** p_fs)
 
         cvReleaseMemStorage(&fs->strstorage);
 
+        icvBinUnmapFile(fs);
         cvFree(&fs->buffer_start);
         cvReleaseMemStorage(&fs->memstorage);
 
@@ -2683,6 +2730,785 @@ static void icvXMLWriteComment(CvFileStorage* fs, const char* comment,
     __END__;
 }
 
+/****************************************************************************************\
+*                                    Binary Storage *
+\****************************************************************************************/
+
+/* A binary storage is the header, the payloads of the numbers written by
+   cvWriteRawData, each aligned to CV_BIN_ALIGN bytes of the file, and the
+   index, written when the storage is closed. The index is the tree of the
+   nodes in pre-order:
+
+   node   := op [key] value        (op | CV_BIN_NAMED and a key in maps)
+   value  := int32 | float64 | string              (INT, REAL, STR)
+           | flags:uint8 type_name:string node* END (SEQ, MAP)
+           | depth:uint8 count:int64 offset:int64   (RAW, in sequences)
+   string := length:int32 chars
+
+   The top-level collections are the stream roots. Successive raw writes of
+   the same depth into a sequence are merged into one payload, so a matrix
+   is stored as one block that is read with a memcpy from the mapped file;
+   the formats of mixed depths and the writes shorter than CV_BIN_MIN_RAW
+   bytes are stored as scalar nodes. The numbers are in the native byte
+   order, which is checked when the file is opened. */
+#define CV_BIN_SIGNATURE "%CVBIN:1.0\n"
+#define CV_BIN_BYTE_ORDER 0x01020304
+#define CV_BIN_ALIGN 64
+#define CV_BIN_MIN_RAW 64
+#define CV_BIN_MAX_LEVEL 1024
+
+#define CV_BIN_RAW 7
+#define CV_BIN_END 15
+#define CV_BIN_NAMED 128
+
+typedef struct CvBinHeader
+{
+    char signature[12];
+    int byte_order;
+    int64 index_offset;
+    int64 index_size;
+    int64 reserved[4];
+} CvBinHeader;
+
+static int icvIsBinStorage(const char* filename, int write_mode)
+{
+    const char* dot_pos = strrchr(filename, '.');
+    char buf[sizeof(CV_BIN_SIGNATURE)];
+    FILE* file;
+    int is_bin;
+
+    if (write_mode)
+        return dot_pos
+               && (strcmp(dot_pos, ".cvb") == 0 || strcmp(dot_pos, ".CVB") == 0
+                   || strcmp(dot_pos, ".Cvb") == 0);
+
+    file = fopen(filename, "rb");
+    if (!file)
+        return 0;
+    is_bin = fread(buf, 1, sizeof(buf), file) == sizeof(buf)
+             && memcmp(buf, CV_BIN_SIGNATURE, sizeof(buf)) == 0;
+    fclose(file);
+
+    return is_bin;
+}
+
+static void icvBinPut(CvFileStorage* fs, const void* data, int len)
+{
+    char* ptr = icvFSResizeWriteBuffer(fs, fs->buffer, len);
+    if (ptr && len > 0)
+    {
+        memcpy(ptr, data, len);
+        fs->buffer = ptr + len;
+    }
+}
+
+static void icvBinPutByte(CvFileStorage* fs, int value)
+{
+    uchar c = (uchar)value;
+    icvBinPut(fs, &c, 1);
+}
+
+static void icvBinPutString(CvFileStorage* fs, const char* str, int len)
+{
+    icvBinPut(fs, &len, sizeof(len));
+    icvBinPut(fs, str, len);
+}
+
+static void icvBinPad(CvFileStorage* fs)
+{
+    static const char zeros[CV_BIN_ALIGN] = {0};
+    int pad = (int)(-fs->file_pos & (CV_BIN_ALIGN - 1));
+
+    fwrite(zeros, 1, pad, fs->file);
+    fs->file_pos += pad;
+}
+
+/* writes the op byte and the key of a new node; the first node of a stream
+   also opens the root collection */
+static void icvBinWriteOp(CvFileStorage* fs, const char* key, int op,
+                          const char* cvFuncName)
+{
+    __BEGIN__;
+
+    int keylen = 0;
+    int struct_flags = fs->struct_flags;
+
+    if (key && key[0] == '\0')
+        key = 0;
+
+    if (CV_NODE_IS_COLLECTION(struct_flags))
+    {
+        if ((CV_NODE_IS_MAP(struct_flags) ^ (key != 0)))
+            CV_ERROR(CV_StsBadArg,
+                     "An attempt to add element without a key to a map, "
+                     "or add element with key to sequence");
+    }
+    else
+    {
+        fs->is_first = 0;
+        struct_flags = key ? CV_NODE_MAP : CV_NODE_SEQ;
+        icvBinPutByte(fs, struct_flags);
+        icvBinPutByte(fs, 0);
+        icvBinPutString(fs, 0, 0);
+    }
+
+    if (key)
+    {
+        keylen = (int)strlen(key);
+        if (keylen > CV_FS_MAX_LEN)
+            CV_ERROR(CV_StsBadArg, "The key is too long");
+        op |= CV_BIN_NAMED;
+    }
+
+    icvBinPutByte(fs, op);
+    if (key)
+        icvBinPutString(fs, key, keylen);
+
+    fs->struct_flags = struct_flags & ~CV_NODE_EMPTY;
+    fs->raw_count_pos = 0;
+
+    __END__;
+}
+
+static void icvBinStartWriteStruct(CvFileStorage* fs, const char* key,
+                                   int struct_flags,
+                                   const char* type_name CV_DEFAULT(0))
+{
+    CV_FUNCNAME("icvBinStartWriteStruct");
+
+    __BEGIN__;
+
+    int parent_flags;
+
+    struct_flags =
+        (struct_flags & (CV_NODE_TYPE_MASK | CV_NODE_FLOW)) | CV_NODE_EMPTY;
+    if (!CV_NODE_IS_COLLECTION(struct_flags))
+        CV_ERROR(CV_StsBadArg, "Some collection type - CV_NODE_SEQ or "
+                               "CV_NODE_MAP, must be specified");
+
+    CV_CALL(icvBinWriteOp(fs, key, CV_NODE_TYPE(struct_flags), cvFuncName));
+    icvBinPutByte(fs, struct_flags & CV_NODE_FLOW);
+    icvBinPutString(fs, type_name, type_name ? (int)strlen(type_name) : 0);
+
+    parent_flags = fs->struct_flags;
+    cvSeqPush(fs->write_stack, &parent_flags);
+    fs->struct_flags = struct_flags;
+
+    __END__;
+}
+
+static void icvBinEndWriteStruct(CvFileStorage* fs)
+{
+    CV_FUNCNAME("icvBinEndWriteStruct");
+
+    __BEGIN__;
+
+    int parent_flags = 0;
+
+    if (fs->write_stack->total == 0)
+        CV_ERROR(CV_StsError, "EndWriteStruct w/o matching StartWriteStruct");
+
+    cvSeqPop(fs->write_stack, &parent_flags);
+    icvBinPutByte(fs, CV_BIN_END);
+    fs->struct_flags = parent_flags;
+    fs->raw_count_pos = 0;
+
+    __END__;
+}
+
+/* closes the root collection of the current stream, if any */
+static void icvBinEndStream(CvFileStorage* fs)
+{
+    while (fs->write_stack->total > 0)
+        icvBinEndWriteStruct(fs);
+
+    if (CV_NODE_IS_COLLECTION(fs->struct_flags))
+    {
+        icvBinPutByte(fs, CV_BIN_END);
+        fs->struct_flags = CV_NODE_EMPTY;
+        fs->raw_count_pos = 0;
+    }
+}
+
+static void icvBinStartNextStream(CvFileStorage* fs)
+{
+    if (!fs->is_first)
+        icvBinEndStream(fs);
+}
+
+static void icvBinWriteInt(CvFileStorage* fs, const char* key, int value)
+{
+    CV_FUNCNAME("icvBinWriteInt");
+
+    __BEGIN__;
+
+    CV_CALL(icvBinWriteOp(fs, key, CV_NODE_INT, cvFuncName));
+    icvBinPut(fs, &value, sizeof(value));
+
+    __END__;
+}
+
+static void icvBinWriteReal(CvFileStorage* fs, const char* key, double value)
+{
+    CV_FUNCNAME("icvBinWriteReal");
+
+    __BEGIN__;
+
+    CV_CALL(icvBinWriteOp(fs, key, CV_NODE_REAL, cvFuncName));
+    icvBinPut(fs, &value, sizeof(value));
+
+    __END__;
+}
+
+static void icvBinWriteString(CvFileStorage* fs, const char* key,
+                              const char* str, int /*quote*/)
+{
+    CV_FUNCNAME("icvBinWriteString");
+
+    __BEGIN__;
+
+    if (!str)
+        CV_ERROR(CV_StsNullPtr, "Null string pointer");
+
+    CV_CALL(icvBinWriteOp(fs, key, CV_NODE_STR, cvFuncName));
+    icvBinPutString(fs, str, (int)strlen(str));
+
+    __END__;
+}
+
+/* comments are not stored, as the text parsers skip them as well */
+static void icvBinWriteComment(CvFileStorage* /*fs*/, const char* comment,
+                               int /*eol_comment*/)
+{
+    CV_FUNCNAME("icvBinWriteComment");
+
+    __BEGIN__;
+
+    if (!comment)
+        CV_ERROR(CV_StsNullPtr, "Null comment");
+
+    __END__;
+}
+
+/* reads a stored number into a temporary scalar node */
+static void icvBinGetScalar(const uchar* ptr, int depth, CvFileNode* node)
+{
+    node->tag = CV_NODE_INT;
+    node->info = 0;
+
+    switch (depth)
+    {
+    case CV_8U:
+        node->data.i = *ptr;
+        break;
+    case CV_8S:
+        node->data.i = *(const signed char*)ptr;
+        break;
+    case CV_16U:
+        node->data.i = *(const ushort*)ptr;
+        break;
+    case CV_16S:
+        node->data.i = *(const short*)ptr;
+        break;
+    case CV_32S:
+        node->data.i = *(const int*)ptr;
+        break;
+    case CV_32F:
+        node->tag = CV_NODE_REAL;
+        node->data.f = *(const float*)ptr;
+        break;
+    case CV_64F:
+        node->tag = CV_NODE_REAL;
+        node->data.f = *(const double*)ptr;
+        break;
+    default:
+        node->tag = CV_NODE_REAL;
+        node->data.f = cvHalfToFloat(*(const ushort*)ptr);
+    }
+}
+
+/* builds the nodes of a raw sequence of a binary storage on the first access
+   by cvGetSeqElem or cvStartReadSeq; the matrices read with cvReadRawData
+   never need them */
+void icvBuildLazySeq(CvSeq* seq)
+{
+    int count = seq->total;
+
+    CV_FUNCNAME("icvBuildLazySeq");
+
+    __BEGIN__;
+
+    const CvFileRawSeq* raw = (const CvFileRawSeq*)seq;
+    const uchar* data = raw->data;
+    CvSeqReader reader;
+    int i;
+
+    if (!CV_NODE_SEQ_IS_RAW(seq) || seq->first || count == 0)
+        EXIT;
+
+    seq->total = 0;
+    CV_CALL(cvSeqPushMulti(seq, 0, count));
+    CV_CALL(cvStartReadSeq(seq, &reader, 0));
+    for (i = 0; i < count; i++, data += CV_ELEM_SIZE(raw->depth))
+    {
+        icvBinGetScalar(data, raw->depth, (CvFileNode*)reader.ptr);
+        CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), reader);
+    }
+
+    __END__;
+
+    // cvReadRawData still reads the payload if the nodes could not be made
+    if (!seq->first)
+        seq->total = count;
+}
+
+/* stores the elements written by cvWriteRawData; fmt_pairs are decoded
+   from dt, with the single-pair formats already folded by len */
+static void icvBinWriteRawData(CvFileStorage* fs, const char* data0, int len,
+                               const int* fmt_pairs, int fmt_pair_count)
+{
+    CV_FUNCNAME("icvBinWriteRawData");
+
+    __BEGIN__;
+
+    int depth = fmt_pairs[1], k, cn = 0;
+    int64 count;
+    size_t size = 0;
+
+    for (k = 0; k < fmt_pair_count; k++)
+    {
+        cn += fmt_pairs[k * 2];
+        if (fmt_pairs[k * 2 + 1] != depth)
+            depth = -1;
+    }
+
+    if (depth == CV_FS_REF)
+        depth = -1;
+
+    count = (int64)len * cn;
+    if (depth >= 0)
+    {
+        size = (size_t)count * CV_ELEM_SIZE(depth);
+        if (size < CV_BIN_MIN_RAW
+            && !(fs->raw_count_pos > 0 && fs->raw_depth == depth))
+            depth = -1;
+    }
+
+    if (depth < 0)
+    {
+        int offset = 0;
+
+        for (; len--;)
+        {
+            for (k = 0; k < fmt_pair_count; k++)
+            {
+                int i, elem_type = fmt_pairs[k * 2 + 1];
+                int elem_size = CV_FS_ELEM_SIZE(elem_type);
+                const char* data;
+
+                offset = cvAlign(offset, elem_size);
+                data = data0 + offset;
+
+                for (i = 0; i < fmt_pairs[k * 2]; i++, data += elem_size)
+                {
+                    if (elem_type == CV_FS_REF)
+                    {
+                        CV_CALL(icvBinWriteInt(fs, 0, (int)*(size_t*)data));
+                    }
+                    else
+                    {
+                        CvFileNode node;
+                        icvBinGetScalar((const uchar*)data, elem_type, &node);
+                        if (CV_NODE_IS_INT(node.tag))
+                        {
+                            CV_CALL(icvBinWriteInt(fs, 0, node.data.i));
+                        }
+                        else
+                        {
+                            CV_CALL(icvBinWriteReal(fs, 0, node.data.f));
+                        }
+                    }
+                }
+
+                offset = (int)(data - data0);
+            }
+        }
+        EXIT;
+    }
+
+    if (fs->raw_count_pos > 0 && fs->raw_depth == depth)
+    {
+        char* count_ptr = fs->buffer_start + fs->raw_count_pos;
+        int64 total;
+
+        memcpy(&total, count_ptr, sizeof(total));
+        total += count;
+        memcpy(count_ptr, &total, sizeof(total));
+    }
+    else
+    {
+        CV_CALL(icvBinWriteOp(fs, 0, CV_BIN_RAW, cvFuncName));
+        icvBinPad(fs);
+        icvBinPutByte(fs, depth);
+        fs->raw_count_pos = (int)(fs->buffer - fs->buffer_start);
+        fs->raw_depth = depth;
+        icvBinPut(fs, &count, sizeof(count));
+        icvBinPut(fs, &fs->file_pos, sizeof(fs->file_pos));
+    }
+
+    if (fwrite(data0, 1, size, fs->file) != size)
+        CV_ERROR(CV_StsError, "Could not write the data to the file");
+    fs->file_pos += size;
+
+    __END__;
+}
+
+/* writes the index and the header of the binary storage being closed */
+static void icvBinClose(CvFileStorage* fs)
+{
+    CvBinHeader header;
+
+    icvBinEndStream(fs);
+    icvBinPad(fs);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.signature, CV_BIN_SIGNATURE, sizeof(header.signature));
+    header.byte_order = CV_BIN_BYTE_ORDER;
+    header.index_offset = fs->file_pos;
+    header.index_size = fs->buffer - fs->buffer_start;
+
+    fwrite(fs->buffer_start, 1, (size_t)header.index_size, fs->file);
+    fseek(fs->file, 0, SEEK_SET);
+    fwrite(&header, 1, sizeof(header), fs->file);
+}
+
+/* maps the whole file into memory; reads it if it can not be mapped */
+static void icvBinMapFile(CvFileStorage* fs)
+{
+    CV_FUNCNAME("icvBinMapFile");
+
+    __BEGIN__;
+
+    size_t size;
+    void* ptr = 0;
+
+#if defined WIN32 || defined WIN64
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(fs->file));
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file, &file_size))
+        CV_ERROR(CV_StsError, "Could not get the file size");
+    size = (size_t)file_size.QuadPart;
+    if (size > 0)
+    {
+        HANDLE mapping = CreateFileMapping(file, 0, PAGE_READONLY, 0, 0, 0);
+        if (mapping)
+        {
+            ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+#else
+    struct stat st;
+
+    if (fstat(fileno(fs->file), &st) != 0)
+        CV_ERROR(CV_StsError, "Could not get the file size");
+    size = (size_t)st.st_size;
+    if (size > 0)
+    {
+        ptr = mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(fs->file), 0);
+        if (ptr == MAP_FAILED)
+            ptr = 0;
+    }
+#endif
+
+    if (!ptr)
+    {
+        CV_CALL(ptr = cvAlloc(size + 1));
+        fs->map_is_alloc = 1;
+        fseek(fs->file, 0, SEEK_SET);
+        if (fread(ptr, 1, size, fs->file) != size)
+        {
+            cvFree(&ptr);
+            CV_ERROR(CV_StsError, "Could not read the file");
+        }
+    }
+
+    fs->map_ptr = (uchar*)ptr;
+    fs->map_size = size;
+
+    __END__;
+}
+
+static void icvBinUnmapFile(CvFileStorage* fs)
+{
+    if (!fs->map_ptr)
+        return;
+
+    if (fs->map_is_alloc)
+        cvFree(&fs->map_ptr);
+    else
+    {
+#if defined WIN32 || defined WIN64
+        UnmapViewOfFile(fs->map_ptr);
+#else
+        munmap(fs->map_ptr, fs->map_size);
+#endif
+    }
+
+    fs->map_ptr = 0;
+    fs->map_size = 0;
+}
+
+#define CV_BIN_CHECK_SIZE(n)                               \
+    {                                                      \
+        if (end - ptr < (int64)(n))                        \
+            CV_PARSE_ERROR("Unexpected end of the index"); \
+    }
+
+static const uchar* icvBinGetString(CvFileStorage* fs, const uchar* ptr,
+                                    const uchar* end, int* len)
+{
+    CV_FUNCNAME("icvBinGetString");
+
+    __BEGIN__;
+
+    CV_BIN_CHECK_SIZE(sizeof(*len));
+    memcpy(len, ptr, sizeof(*len));
+    ptr += sizeof(*len);
+    if (*len < 0)
+        CV_PARSE_ERROR("Negative string length");
+    CV_BIN_CHECK_SIZE(*len);
+
+    __END__;
+
+    return ptr;
+}
+
+/* checks and reads a raw payload descriptor */
+static const uchar* icvBinGetRaw(CvFileStorage* fs, const uchar* ptr,
+                                 const uchar* end, int* depth,
+                                 int* count, const uchar** data)
+{
+    CV_FUNCNAME("icvBinGetRaw");
+
+    __BEGIN__;
+
+    int64 total, offset, limit;
+
+    CV_BIN_CHECK_SIZE(1 + sizeof(total) + sizeof(offset));
+    *depth = *ptr++;
+    memcpy(&total, ptr, sizeof(total));
+    memcpy(&offset, ptr + sizeof(total), sizeof(offset));
+    ptr += sizeof(total) + sizeof(offset);
+
+    if (*depth >= CV_DEPTH_MAX)
+        CV_PARSE_ERROR("Invalid depth of the raw data");
+
+    limit = (int64)(end - fs->map_ptr);
+    if (total < 0 || total > INT_MAX || offset < (int64)sizeof(CvBinHeader)
+        || offset > limit || total > (limit - offset) / CV_ELEM_SIZE(*depth))
+        CV_PARSE_ERROR("The raw data is out of the file");
+
+    *count = (int)total;
+    *data = fs->map_ptr + offset;
+
+    __END__;
+
+    return ptr;
+}
+
+static const uchar* icvBinParseValue(CvFileStorage* fs, const uchar* ptr,
+                                     const uchar* end, CvFileNode* node,
+                                     int op, int level)
+{
+    CV_FUNCNAME("icvBinParseValue");
+
+    __BEGIN__;
+
+    int len;
+
+    memset(node, 0, sizeof(*node));
+
+    switch (op)
+    {
+    case CV_NODE_INT:
+        CV_BIN_CHECK_SIZE(sizeof(node->data.i));
+        memcpy(&node->data.i, ptr, sizeof(node->data.i));
+        ptr += sizeof(node->data.i);
+        node->tag = CV_NODE_INT;
+        break;
+    case CV_NODE_REAL:
+        CV_BIN_CHECK_SIZE(sizeof(node->data.f));
+        memcpy(&node->data.f, ptr, sizeof(node->data.f));
+        ptr += sizeof(node->data.f);
+        node->tag = CV_NODE_REAL;
+        break;
+    case CV_NODE_STR:
+        CV_CALL(ptr = icvBinGetString(fs, ptr, end, &len));
+        CV_CALL(node->data.str = cvMemStorageAllocString(
+                    fs->memstorage, (const char*)ptr, len));
+        ptr += len;
+        node->tag = CV_NODE_STR;
+        break;
+    case CV_NODE_SEQ:
+    case CV_NODE_MAP:
+    {
+        char type_name[CV_FS_MAX_LEN + 1];
+        int is_simple = 1;
+
+        if (level > CV_BIN_MAX_LEVEL)
+            CV_PARSE_ERROR("Too deep nesting of the collections");
+
+        CV_BIN_CHECK_SIZE(1);
+        ptr++; // the flow flag is not needed for reading
+        CV_CALL(ptr = icvBinGetString(fs, ptr, end, &len));
+        if (len > CV_FS_MAX_LEN)
+            CV_PARSE_ERROR("Too long type name");
+        if (len > 0)
+        {
+            memcpy(type_name, ptr, len);
+            type_name[len] = '\0';
+            CV_CALL(node->info = cvFindType(type_name));
+        }
+        ptr += len;
+
+        CV_CALL(icvFSCreateCollection(
+            fs, op + (node->info ? CV_NODE_USER : 0), node));
+
+        for (;;)
+        {
+            CvFileNode* elem = 0;
+            int elem_op;
+
+            CV_BIN_CHECK_SIZE(1);
+            elem_op = *ptr++;
+            if (elem_op == CV_BIN_END)
+                break;
+
+            if ((op == CV_NODE_MAP) ^ ((elem_op & CV_BIN_NAMED) != 0))
+                CV_PARSE_ERROR("A named element of a sequence "
+                               "or an unnamed element of a map");
+            elem_op &= ~CV_BIN_NAMED;
+
+            if (op == CV_NODE_MAP)
+            {
+                CvStringHashNode* key;
+                CV_CALL(ptr = icvBinGetString(fs, ptr, end, &len));
+                if (len == 0)
+                    CV_PARSE_ERROR("An empty key");
+                CV_CALL(key = cvGetHashedKey(fs, (const char*)ptr, len, 1));
+                CV_CALL(elem = cvGetFileNode(fs, node, key, 1));
+                ptr += len;
+            }
+            else if (elem_op == CV_BIN_RAW)
+            {
+                int depth = 0, count = 0;
+                const uchar* data = 0;
+                CvSeq* seq = node->data.seq;
+                CvSeqReader reader;
+                int i;
+
+                CV_CALL(ptr = icvBinGetRaw(fs, ptr, end, &depth, &count,
+                                           &data));
+
+                if (seq->total == 0 && ptr < end && *ptr == CV_BIN_END)
+                {
+                    // the whole sequence is one payload; the nodes are
+                    // built only if they are read
+                    CvFileRawSeq* raw;
+                    CV_CALL(raw = (CvFileRawSeq*)cvCreateSeq(
+                                seq->flags, sizeof(CvFileRawSeq),
+                                sizeof(CvFileNode), fs->memstorage));
+                    raw->flags |= CV_NODE_SEQ_RAW;
+                    raw->depth = depth;
+                    raw->data = data;
+                    raw->total = count;
+                    node->data.seq = (CvSeq*)raw;
+                    continue;
+                }
+
+                if (count == 0)
+                    continue;
+
+                CV_CALL(cvSeqPushMulti(seq, 0, count));
+                CV_CALL(cvStartReadSeq(seq, &reader, 0));
+                CV_CALL(cvSetSeqReaderPos(&reader, seq->total - count, 0));
+                for (i = 0; i < count; i++, data += CV_ELEM_SIZE(depth))
+                {
+                    icvBinGetScalar(data, depth, (CvFileNode*)reader.ptr);
+                    CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), reader);
+                }
+                continue;
+            }
+            else
+            {
+                CV_CALL(elem = (CvFileNode*)cvSeqPush(node->data.seq, 0));
+            }
+
+            CV_CALL(ptr = icvBinParseValue(fs, ptr, end, elem, elem_op,
+                                           level + 1));
+            if (op == CV_NODE_MAP)
+                elem->tag |= CV_NODE_NAMED;
+            is_simple &= !CV_NODE_IS_COLLECTION(elem->tag);
+        }
+
+        node->data.seq->flags |= is_simple ? CV_NODE_SEQ_SIMPLE : 0;
+        break;
+    }
+    default:
+        CV_PARSE_ERROR("Unknown node type");
+    }
+
+    __END__;
+
+    return ptr;
+}
+
+static void icvBinParse(CvFileStorage* fs)
+{
+    CV_FUNCNAME("icvBinParse");
+
+    __BEGIN__;
+
+    CvBinHeader header;
+    const uchar *ptr, *end;
+
+    CV_CALL(icvBinMapFile(fs));
+
+    if (fs->map_size < sizeof(header))
+        CV_PARSE_ERROR("Too short binary file");
+    memcpy(&header, fs->map_ptr, sizeof(header));
+
+    if (memcmp(header.signature, CV_BIN_SIGNATURE, sizeof(header.signature))
+        != 0)
+        CV_PARSE_ERROR("Invalid signature of the binary file");
+    if (header.byte_order != CV_BIN_BYTE_ORDER)
+        CV_PARSE_ERROR("The binary file is written with a different "
+                       "byte order");
+    if (header.index_offset < (int64)sizeof(header)
+        || header.index_offset > (int64)fs->map_size || header.index_size < 0
+        || header.index_size > (int64)fs->map_size - header.index_offset)
+        CV_PARSE_ERROR("Invalid index of the binary file");
+
+    ptr = fs->map_ptr + header.index_offset;
+    end = ptr + header.index_size;
+
+    while (ptr < end)
+    {
+        CvFileNode* root_node;
+        int op = *ptr++;
+
+        if (op != CV_NODE_SEQ && op != CV_NODE_MAP)
+            CV_PARSE_ERROR("Only collections as the streams are supported");
+
+        CV_CALL(root_node = (CvFileNode*)cvSeqPush(fs->roots, 0));
+        CV_CALL(ptr = icvBinParseValue(fs, ptr, end, root_node, op, 0));
+    }
+
+    __END__;
+}
+
 /****************************************************************************************\
 *                              Common High-Level Functions *
 \****************************************************************************************/
@@ -2715,9 +3541,15 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
 
     fs->flags = CV_FILE_STORAGE;
     fs->write_mode = (flags & 3) != 0;
-    fs->file = fopen(fs->filename, !fs->write_mode ? "rt"
-                                   : !append       ? "wt"
-                                                   : "a+t");
+    fs->is_bin = icvIsBinStorage(fs->filename, fs->write_mode);
+    if (fs->is_bin && append)
+        CV_ERROR(CV_StsNotImplemented,
+                 "Appending to binary file storages is not supported");
+
+    fs->file = fopen(fs->filename, fs->is_bin ? (fs->write_mode ? "wb" : "rb")
+                                   : !fs->write_mode ? "rt"
+                                   : !append         ? "wt"
+                                                     : "a+t");
     if (!fs->file)
         EXIT;
 
@@ -2752,7 +3584,22 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
         CV_CALL(fs->buffer_start = fs->buffer =
                     (char*)cvAlloc(buf_size + 1024));
         fs->buffer_end = fs->buffer_start + buf_size;
-        if (fs->is_xml)
+        if (fs->is_bin)
+        {
+            CvBinHeader header;
+            memset(&header, 0, sizeof(header));
+            fwrite(&header, 1, sizeof(header), fs->file);
+            fs->file_pos = sizeof(header);
+
+            fs->start_write_struct = icvBinStartWriteStruct;
+            fs->end_write_struct = icvBinEndWriteStruct;
+            fs->write_int = icvBinWriteInt;
+            fs->write_real = icvBinWriteReal;
+            fs->write_string = icvBinWriteString;
+            fs->write_comment = icvBinWriteComment;
+            fs->start_next_stream = icvBinStartNextStream;
+        }
+        else if (fs->is_xml)
         {
             int file_size = (int)ftell(fs->file);
             CV_CALL(fs->strstorage = cvCreateChildMemStorage(fs->memstorage));
@@ -2821,6 +3668,17 @@ CV_IMPL CvFileStorage* cvOpenFileStorage(const char* filename,
             fs->start_next_stream = icvYMLStartNextStream;
         }
     }
+    else if (fs->is_bin)
+    {
+        CV_CALL(fs->str_hash =
+                    cvCreateMap(0, sizeof(CvStringHash),
+                                sizeof(CvStringHashNode), fs->memstorage, 256));
+
+        CV_CALL(fs->roots = cvCreateSeq(0, sizeof(CvSeq), sizeof(CvFileNode),
+                                        fs->memstorage));
+
+        CV_CALL(icvBinParse(fs));
+    }
     else
     {
         int buf_size;
@@ -2969,9 +3827,10 @@ CV_IMPL void cvStartNextStream(CvFileStorage* fs)
     __END__;
 }
 
-static const char icvTypeSymbol[] = "ucwsifdr";
+static const char icvTypeSymbol[] = "ucwsifdh";
 #define CV_FS_MAX_FMT_PAIRS 128
 
+
 static char* icvEncodeFormat(int elem_type, char* dt)
 {
     sprintf(dt, "%d%c", CV_MAT_CN(elem_type),
@@ -3017,11 +3876,11 @@ static int icvDecodeFormat(const char* dt, int* fmt_pairs, int max_len)
         else
         {
             const char* pos = strchr(icvTypeSymbol, c);
-            if (!pos)
+            if (!pos && c != 'r')
                 CV_ERROR(CV_StsBadArg, "Invalid data type specification");
             if (fmt_pairs[i] == 0)
                 fmt_pairs[i] = 1;
-            fmt_pairs[i + 1] = (int)(pos - icvTypeSymbol);
+            fmt_pairs[i + 1] = pos ? (int)(pos - icvTypeSymbol) : CV_FS_REF;
             if (i > 0 && fmt_pairs[i + 1] == fmt_pairs[i - 1])
                 fmt_pairs[i - 2] += fmt_pairs[i];
             else
@@ -3056,13 +3915,13 @@ static int icvCalcElemSize(const char* dt, int initial_size)
     fmt_pair_count *= 2;
     for (i = 0, size = initial_size; i < fmt_pair_count; i += 2)
     {
-        comp_size = CV_ELEM_SIZE(fmt_pairs[i + 1]);
+        comp_size = CV_FS_ELEM_SIZE(fmt_pairs[i + 1]);
         size = cvAlign(size, comp_size);
         size += comp_size * fmt_pairs[i];
     }
     if (initial_size == 0)
     {
-        comp_size = CV_ELEM_SIZE(fmt_pairs[1]);
+        comp_size = CV_FS_ELEM_SIZE(fmt_pairs[1]);
         size = cvAlign(size, comp_size);
     }
 
@@ -3126,13 +3985,20 @@ CV_IMPL void cvWriteRawData(CvFileStorage* fs, const void* _data, int len,
         len = 1;
     }
 
+    if (fs->is_bin)
+    {
+        CV_CALL(
+            icvBinWriteRawData(fs, data0, len, fmt_pairs, fmt_pair_count));
+        EXIT;
+    }
+
     for (; len--;)
     {
         for (k = 0; k < fmt_pair_count; k++)
         {
             int i, count = fmt_pairs[k * 2];
             int elem_type = fmt_pairs[k * 2 + 1];
-            int elem_size = CV_ELEM_SIZE(elem_type);
+            int elem_size = CV_FS_ELEM_SIZE(elem_type);
             const char *data, *ptr;
 
             offset = cvAlign(offset, elem_size);
@@ -3170,7 +4036,11 @@ CV_IMPL void cvWriteRawData(CvFileStorage* fs, const void* _data, int len,
                     ptr = icvDoubleToString(buf, *(double*)data);
                     data += sizeof(double);
                     break;
-                case CV_USRTYPE1: /* reference */
+                case CV_16F:
+                    ptr = icvFloatToString(buf, cvHalfToFloat(*(ushort*)data));
+                    data += sizeof(ushort);
+                    break;
+                case CV_FS_REF:
                     ptr = icv_itoa((int)*(size_t*)data, buf, 10);
                     data += sizeof(size_t);
                     break;
@@ -3217,6 +4087,19 @@ CV_IMPL void cvStartReadRawData(const CvFileStorage* fs, const CvFileNode* src,
         reader->block_min = reader->ptr;
         reader->seq = 0;
     }
+    else if (node_type == CV_NODE_SEQ && CV_NODE_SEQ_IS_RAW(src->data.seq))
+    {
+        // reads the payload directly; block is 0, unlike in the readers of
+        // cvStartReadSeq
+        const CvFileRawSeq* raw = (const CvFileRawSeq*)src->data.seq;
+
+        memset(reader, 0, sizeof(*reader));
+        reader->header_size = sizeof(*raw);
+        reader->seq = src->data.seq;
+        reader->ptr = reader->block_min = (char*)raw->data;
+        reader->block_max =
+            reader->ptr + (size_t)raw->total * CV_ELEM_SIZE(raw->depth);
+    }
     else if (node_type == CV_NODE_SEQ)
     {
         CV_CALL(cvStartReadSeq(src->data.seq, reader, 0));
@@ -3242,6 +4125,7 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
 
     int fmt_pairs[CV_FS_MAX_FMT_PAIRS * 2], k = 0, fmt_pair_count;
     int i = 0, offset = 0, count = 0;
+    int raw_depth = -1, raw_size = 0;
 
     CV_CHECK_FILE_STORAGE(fs);
 
@@ -3255,12 +4139,32 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
     CV_CALL(fmt_pair_count =
                 icvDecodeFormat(dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS));
 
+    if (reader->seq && !reader->block && CV_NODE_SEQ_IS_RAW(reader->seq))
+    {
+        // the raw payload of a binary storage; the numbers of the same type
+        // are copied as is
+        raw_depth = ((const CvFileRawSeq*)reader->seq)->depth;
+        raw_size = CV_ELEM_SIZE(raw_depth);
+
+        if (len <= 0 || (reader->block_max - reader->ptr) / raw_size < len)
+            CV_ERROR(CV_StsOutOfRange,
+                     "The slice is out of the stored sequence");
+
+        if (fmt_pair_count == 1 && fmt_pairs[1] == raw_depth
+            && len % fmt_pairs[0] == 0)
+        {
+            memcpy(data0, reader->ptr, (size_t)len * raw_size);
+            reader->ptr += (size_t)len * raw_size;
+            EXIT;
+        }
+    }
+
     for (;;)
     {
         for (k = 0; k < fmt_pair_count; k++)
         {
             int elem_type = fmt_pairs[k * 2 + 1];
-            int elem_size = CV_ELEM_SIZE(elem_type);
+            int elem_size = CV_FS_ELEM_SIZE(elem_type);
             char* data;
 
             count = fmt_pairs[k * 2];
@@ -3270,6 +4174,15 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
             for (i = 0; i < count; i++)
             {
                 CvFileNode* node = (CvFileNode*)reader->ptr;
+                CvFileNode raw_node;
+
+                if (raw_depth >= 0)
+                {
+                    icvBinGetScalar((const uchar*)reader->ptr, raw_depth,
+                                    &raw_node);
+                    node = &raw_node;
+                }
+
                 if (CV_NODE_IS_INT(node->tag))
                 {
                     int ival = node->data.i;
@@ -3282,6 +4195,7 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
                         break;
                     case CV_8S:
                         *(char*)data = CV_CAST_8S(ival);
+                        data++;
                         break;
                     case CV_16U:
                         *(ushort*)data = CV_CAST_16U(ival);
@@ -3303,7 +4217,11 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
                         *(double*)data = (double)ival;
                         data += sizeof(double);
                         break;
-                    case CV_USRTYPE1: /* reference */
+                    case CV_16F:
+                        *(ushort*)data = cvFloatToHalf((float)ival);
+                        data += sizeof(ushort);
+                        break;
+                    case CV_FS_REF:
                         *(size_t*)data = ival;
                         data += sizeof(size_t);
                         break;
@@ -3327,6 +4245,7 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
                     case CV_8S:
                         ival = cvRound(fval);
                         *(char*)data = CV_CAST_8S(ival);
+                        data++;
                         break;
                     case CV_16U:
                         ival = cvRound(fval);
@@ -3351,7 +4270,11 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
                         *(double*)data = fval;
                         data += sizeof(double);
                         break;
-                    case CV_USRTYPE1: /* reference */
+                    case CV_16F:
+                        *(ushort*)data = cvFloatToHalf((float)fval);
+                        data += sizeof(ushort);
+                        break;
+                    case CV_FS_REF:
                         ival = cvRound(fval);
                         *(size_t*)data = ival;
                         data += sizeof(size_t);
@@ -3365,7 +4288,10 @@ CV_IMPL void cvReadRawDataSlice(const CvFileStorage* fs, CvSeqReader* reader,
                     CV_ERROR(CV_StsError,
                              "The sequence element is not a numerical scalar");
 
-                CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), *reader);
+                if (raw_depth >= 0)
+                    reader->ptr += raw_size;
+                else
+                    CV_NEXT_SEQ_ELEM(sizeof(CvFileNode), *reader);
                 if (!--len)
                     goto end_loop;
             }
@@ -3417,6 +4343,14 @@ static void icvWriteCollection(CvFileStorage* fs, const CvFileNode* node)
     int is_map = CV_NODE_IS_MAP(node->tag);
     CvSeqReader reader;
 
+    if (CV_NODE_SEQ_IS_RAW(node->data.seq))
+    {
+        const CvFileRawSeq* raw = (const CvFileRawSeq*)node->data.seq;
+        char dt[] = {icvTypeSymbol[raw->depth], '\0'};
+        cvWriteRawData(fs, raw->data, total, dt);
+        return;
+    }
+
     cvStartReadSeq(node->data.seq, &reader, 0);
 
     for (i = 0; i < total; i++)
@@ -3847,14 +4781,14 @@ static void* icvReadSparseMat(CvFileStorage* fs, CvFileNode* node)
     elements = data->data.seq;
     cvStartReadRawData(fs, data, &reader);
 
+    // the indices are read with cvReadRawDataSlice() rather than from the
+    // nodes directly, since a binary storage may keep the whole sequence
+    // as a single raw payload
     for (i = 0; i < elements->total;)
     {
-        CvFileNode* elem = (CvFileNode*)reader.ptr;
         uchar* val;
         int k;
-        if (!CV_NODE_IS_INT(elem->tag))
-            CV_ERROR(CV_StsParseError, "Sparse matrix data is corrupted");
-        k = elem->data.i;
+        CV_CALL(cvReadRawDataSlice(fs, &reader, 1, &k, "i"));
         if (i > 0 && k >= 0)
             idx[dims - 1] = k;
         else
@@ -3863,18 +4797,17 @@ static void* icvReadSparseMat(CvFileStorage* fs, CvFileNode* node)
                 k = dims + k - 1;
             else
                 idx[0] = k, k = 1;
+            if ((unsigned)k > (unsigned)dims)
+                CV_ERROR(CV_StsParseError, "Sparse matrix data is corrupted");
             for (; k < dims; k++)
             {
-                CV_NEXT_SEQ_ELEM(elements->elem_size, reader);
                 i++;
-                elem = (CvFileNode*)reader.ptr;
-                if (!CV_NODE_IS_INT(elem->tag) || elem->data.i < 0)
+                CV_CALL(cvReadRawDataSlice(fs, &reader, 1, idx + k, "i"));
+                if (idx[k] < 0)
                     CV_ERROR(CV_StsParseError,
                              "Sparse matrix data is corrupted");
-                idx[k] = elem->data.i;
             }
         }
-        CV_NEXT_SEQ_ELEM(elements->elem_size, reader);
         i++;
         CV_CALL(val = cvPtrND(mat, idx, 0, 1, 0));
         CV_CALL(cvReadRawDataSlice(fs, &reader, cn, val, dt));
@@ -4144,6 +5077,12 @@ static char* icvGetFormat(const CvSeq* seq, const char* dt_key,
                      "The size of element calculated from \"dt\" and "
                      "the elem_size do not match");
     }
+    else if (CV_MAT_TYPE(seq->flags) == CV_SEQ_ELTYPE_PTR
+             && seq->elem_size == initial_elem_size + (int)sizeof(void*))
+    {
+        /* a sequence of pointers, not of 16F numbers */
+        dt = strcpy(dt_buf, "r");
+    }
     else if (CV_MAT_TYPE(seq->flags) != 0 || seq->elem_size == 1)
     {
         int align = CV_MAT_DEPTH(seq->flags) == CV_64F ? sizeof(double)
@@ -4540,7 +5479,7 @@ static void icvWriteGraph(CvFileStorage* fs, const char* name,
                 fmt_pair_count =
                     icvDecodeFormat(dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS);
                 if (fmt_pair_count > 2
-                    || CV_ELEM_SIZE(fmt_pairs[2 * 2 + 1])
+                    || CV_FS_ELEM_SIZE(fmt_pairs[2 * 2 + 1])
                            >= (int)sizeof(double))
                     edge_user_align = sizeof(double);
             }
@@ -4662,7 +5601,7 @@ static void* icvReadGraph(CvFileStorage* fs, CvFileNode* node)
         CV_CALL(src_vtx_size = icvCalcElemSize(vtx_dt, 0));
         CV_CALL(vtx_size = icvCalcElemSize(vtx_dt, vtx_size));
         CV_CALL(fmt_pair_count =
-                    icvDecodeFormat(edge_dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS));
+                    icvDecodeFormat(vtx_dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS));
         fmt_pair_count *= 2;
         for (i = 0; i < fmt_pair_count; i += 2)
             vtx_items_per_elem += fmt_pairs[i];
@@ -4681,7 +5620,7 @@ static void* icvReadGraph(CvFileStorage* fs, CvFileNode* node)
 
         // alignment of user part of the edge data following 2if
         if (fmt_pair_count > 2
-            && CV_ELEM_SIZE(fmt_pairs[5]) >= (int)sizeof(double))
+            && CV_FS_ELEM_SIZE(fmt_pairs[5]) >= (int)sizeof(double))
             edge_user_align = sizeof(double);
 
         fmt_pair_count *= 2;
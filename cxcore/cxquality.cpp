@@ -0,0 +1,699 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "_cxcore.h"
+
+/* cvImageDiff and cvSSIM convert the rows of 8u, 16u and 16f arrays to float
+   by blocks on the fly, so every depth goes through the same 32f hooks and
+   no full-size temporary arrays are created (but the downscaled levels of
+   MS-SSIM). The work is split into a fixed number of chunks that depends
+   only on the array size, and the per-chunk sums are merged in order, so
+   the results do not change with the number of threads */
+
+#define ICV_QUALITY_BLOCK 1008 /* an even number of pixels of 1-4 channels */
+
+/* returns src converted to float and multiplied by scale, or src itself
+   when it is float and scale is 1 */
+static const float* icvRowTo32f(const uchar* src, float* buf, int len,
+                                int depth, float scale)
+{
+    int i;
+
+    if (depth == CV_8U)
+        for (i = 0; i < len; i++)
+            buf[i] = src[i] * scale;
+    else if (depth == CV_16U)
+        for (i = 0; i < len; i++)
+            buf[i] = ((const ushort*)src)[i] * scale;
+    else if (depth == CV_16F)
+    {
+        icvCvt_16f32f((const ushort*)src, buf, len);
+        if (scale != 1.f)
+            for (i = 0; i < len; i++)
+                buf[i] *= scale;
+    }
+    else if (scale != 1.f)
+        for (i = 0; i < len; i++)
+            buf[i] = ((const float*)src)[i] * scale;
+    else
+        return (const float*)src;
+
+    return buf;
+}
+
+static double icvDefaultPeak(int depth)
+{
+    return depth == CV_8U ? 255. : depth == CV_16U ? 65535. : 1.;
+}
+
+/****************************************************************************************\
+*                                    Image Difference *
+\****************************************************************************************/
+
+#define ICV_DIFF_MAX_CHUNKS 32
+
+typedef struct CvImageDiffBand
+{
+    const uchar *data1, *data2;
+    int step1, step2;
+    uchar* mask;
+    int mask_step;
+    int rows, cols;
+    int cn, depth;
+    int nchunks;
+    float threshold;
+    CvImageDiff* partial; /* mse keeps the sums of the squared differences */
+} CvImageDiffBand;
+
+/* max_pos[k] is set only when max_diff[k] grows; the maximum is initialized
+   with -1, so the first pixel always sets it */
+IPCVAPI_IMPL(CvStatus, icvDiffRow_32f,
+             (const float* src1, const float* src2, int len, int cn,
+              float* max_diff, int* max_pos, double* sqsum, uchar* mask,
+              float threshold),
+             (src1, src2, len, cn, max_diff, max_pos, sqsum, mask,
+              threshold))
+{
+    int i, k;
+
+    for (i = 0; i < len; i += cn)
+    {
+        int differs = 0;
+
+        for (k = 0; k < cn; k++)
+        {
+            float d = (float)fabs(src1[i + k] - src2[i + k]);
+            double t = d;
+            if (d > max_diff[k])
+            {
+                max_diff[k] = d;
+                max_pos[k] = i / cn;
+            }
+            sqsum[k] += t * t;
+            differs |= d > threshold;
+        }
+
+        if (mask)
+            mask[i / cn] = (uchar)(differs ? 255 : 0);
+    }
+
+    return CV_OK;
+}
+
+static void icvImageDiffChunk(const CvImageDiffBand* p, int chunk, int y0,
+                              int y1)
+{
+    float buf1[ICV_QUALITY_BLOCK], buf2[ICV_QUALITY_BLOCK];
+    int cn = p->cn, len = p->cols * cn, esz = CV_ELEM_SIZE1(p->depth);
+    int x, y, k, pos[4];
+    float mx[4];
+    double sq[4];
+    CvImageDiff* diff = p->partial + chunk;
+
+    memset(diff, 0, sizeof(*diff));
+    for (k = 0; k < cn; k++)
+    {
+        mx[k] = -1.f;
+        sq[k] = 0;
+    }
+
+    for (y = y0; y < y1; y++)
+    {
+        const uchar* row1 = p->data1 + y * p->step1;
+        const uchar* row2 = p->data2 + y * p->step2;
+        uchar* mask = p->mask ? p->mask + y * p->mask_step : 0;
+
+        for (x = 0; x < len; x += ICV_QUALITY_BLOCK)
+        {
+            int n = MIN(len - x, ICV_QUALITY_BLOCK);
+            const float* s1 =
+                icvRowTo32f(row1 + x * esz, buf1, n, p->depth, 1.f);
+            const float* s2 =
+                icvRowTo32f(row2 + x * esz, buf2, n, p->depth, 1.f);
+
+            for (k = 0; k < cn; k++)
+                pos[k] = -1;
+            icvDiffRow_32f(s1, s2, n, cn, mx, pos, sq,
+                           mask ? mask + x / cn : 0, p->threshold);
+            for (k = 0; k < cn; k++)
+                if (pos[k] >= 0)
+                    diff->max_loc[k] = cvPoint(x / cn + pos[k], y);
+        }
+    }
+
+    for (k = 0; k < cn; k++)
+    {
+        diff->max_diff.val[k] = mx[k];
+        diff->mse.val[k] = sq[k];
+    }
+}
+
+static int CV_CDECL icvImageDiffBand(int start, int end, void* arg)
+{
+    const CvImageDiffBand* p = (const CvImageDiffBand*)arg;
+    int chunk;
+
+    for (chunk = start; chunk < end; chunk++)
+    {
+        int y0 = (int)((int64)p->rows * chunk / p->nchunks);
+        int y1 = (int)((int64)p->rows * (chunk + 1) / p->nchunks);
+        icvImageDiffChunk(p, chunk, y0, y1);
+    }
+
+    return CV_StsOk;
+}
+
+/* checks that the arrays can be compared by cvImageDiff or cvSSIM */
+static void icvCheckQualityArrays(const CvArr* arr1, const CvArr* arr2,
+                                  CvMat* stub1, CvMat* stub2, CvMat** mat1,
+                                  CvMat** mat2)
+{
+    CV_FUNCNAME("icvCheckQualityArrays");
+
+    __BEGIN__;
+
+    int coi1 = 0, coi2 = 0, depth;
+
+    *mat1 = (CvMat*)arr1;
+    *mat2 = (CvMat*)arr2;
+
+    if (!CV_IS_MAT(*mat1))
+        CV_CALL(*mat1 = cvGetMat(*mat1, stub1, &coi1));
+
+    if (!CV_IS_MAT(*mat2))
+        CV_CALL(*mat2 = cvGetMat(*mat2, stub2, &coi2));
+
+    if (coi1 != 0 || coi2 != 0)
+        CV_ERROR(CV_BadCOI, "");
+
+    if (!CV_ARE_TYPES_EQ(*mat1, *mat2))
+        CV_ERROR(CV_StsUnmatchedFormats, "");
+
+    if (!CV_ARE_SIZES_EQ(*mat1, *mat2))
+        CV_ERROR(CV_StsUnmatchedSizes, "");
+
+    depth = CV_MAT_DEPTH((*mat1)->type);
+
+    if (depth != CV_8U && depth != CV_16U && depth != CV_16F
+        && depth != CV_32F)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "Only 8u, 16u, 16f and 32f arrays are supported");
+
+    if (CV_MAT_CN((*mat1)->type) > 4)
+        CV_ERROR(CV_StsOutOfRange, "The arrays must have at most 4 channels");
+
+    __END__;
+}
+
+CV_IMPL void cvImageDiff(const CvArr* arr1, const CvArr* arr2,
+                         CvImageDiff* diff, CvArr* maskarr, double threshold,
+                         double peak)
+{
+    CvImageDiff* partial = 0;
+
+    CV_FUNCNAME("cvImageDiff");
+
+    __BEGIN__;
+
+    CvMat stub1, stub2, maskstub, *mat1, *mat2, *mask = (CvMat*)maskarr;
+    CvImageDiffBand band;
+    int depth, cn, nchunks, total, i, k;
+
+    CV_CALL(icvCheckQualityArrays(arr1, arr2, &stub1, &stub2, &mat1, &mat2));
+
+    if (!diff)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    depth = CV_MAT_DEPTH(mat1->type);
+    cn = CV_MAT_CN(mat1->type);
+
+    if (mask)
+    {
+        if (!CV_IS_MAT(mask))
+            CV_CALL(mask = cvGetMat(mask, &maskstub));
+
+        if (!CV_IS_MASK_ARR(mask))
+            CV_ERROR(CV_StsBadMask, "");
+
+        if (!CV_ARE_SIZES_EQ(mat1, mask))
+            CV_ERROR(CV_StsUnmatchedSizes, "");
+    }
+
+    if (peak == 0)
+        peak = icvDefaultPeak(depth);
+
+    if (peak < 0)
+        CV_ERROR(CV_StsOutOfRange, "The peak value must be positive");
+
+    memset(&band, 0, sizeof(band));
+    band.data1 = mat1->data.ptr;
+    band.data2 = mat2->data.ptr;
+    band.step1 = mat1->step;
+    band.step2 = mat2->step;
+    band.mask = mask ? mask->data.ptr : 0;
+    band.mask_step = mask ? mask->step : 0;
+    band.rows = mat1->rows;
+    band.cols = mat1->cols;
+    band.cn = cn;
+    band.depth = depth;
+    band.threshold = (float)threshold;
+
+    total = mat1->rows * mat1->cols;
+    nchunks = MIN(total / CV_PARALLEL_MIN_PIXELS, ICV_DIFF_MAX_CHUNKS);
+    nchunks = MAX(MIN(nchunks, band.rows), 1);
+    band.nchunks = nchunks;
+
+    CV_CALL(partial = (CvImageDiff*)cvAlloc(nchunks * sizeof(partial[0])));
+    band.partial = partial;
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nchunks), icvImageDiffBand,
+                                      &band, 1));
+
+    // merge the chunks; the first of the equal maxima is the earliest one
+    memset(diff, 0, sizeof(*diff));
+    diff->count = total;
+
+    for (k = 0; k < cn; k++)
+    {
+        double mx = -1, sq = 0, mse;
+
+        for (i = 0; i < nchunks; i++)
+        {
+            if (partial[i].max_diff.val[k] > mx)
+            {
+                mx = partial[i].max_diff.val[k];
+                diff->max_loc[k] = partial[i].max_loc[k];
+            }
+            sq += partial[i].mse.val[k];
+        }
+
+        mse = sq / total;
+        diff->max_diff.val[k] = MAX(mx, 0);
+        diff->mse.val[k] = mse;
+        diff->psnr.val[k] =
+            mse > 0 ? 10 * log10(peak * peak / mse) : DBL_MAX;
+    }
+
+    __END__;
+
+    cvFree(&partial);
+}
+
+/****************************************************************************************\
+*                                  Structural Similarity *
+\****************************************************************************************/
+
+/* The valid region is split into tiles of ICV_SSIM_TILE x ICV_SSIM_BAND
+   output pixels. A tile filters every input row horizontally into a ring
+   of ICV_SSIM_KSIZE rows of the five window statistics (the means, the
+   mean squares and the mean product of the arrays), and every completed
+   ring gives an output row of the vertical pass, which is reduced to the
+   sums of SSIM and of its contrast-structure term right away. The ring of
+   a tile stays in the cache */
+
+#define ICV_SSIM_KSIZE 11
+#define ICV_SSIM_SIGMA 1.5
+#define ICV_SSIM_TILE 256
+#define ICV_SSIM_BAND 128
+#define ICV_SSIM_SCALES 5
+
+typedef struct CvSSIMBand
+{
+    const uchar *data1, *data2;
+    int step1, step2;
+    int cn, depth;
+    float scale;       /* brings the values to [0,1] */
+    int width, height; /* the valid region */
+    int tiles_x;
+    const float* kernel;
+    float c1, c2;
+    double* sums; /* the SSIM and the cs sums of every tile, 4 + 4 */
+} CvSSIMBand;
+
+/* dst[q*len + i], q = 0..4, are the windowed sums of src1, src2, src1^2,
+   src2^2 and src1*src2 at the element i */
+IPCVAPI_IMPL(CvStatus, icvSSIMRowH_32f,
+             (const float* src1, const float* src2, int len, int cn,
+              const float* kernel, int ksize, float* dst),
+             (src1, src2, len, cn, kernel, ksize, dst))
+{
+    int i, j;
+
+    for (i = 0; i < len; i++)
+    {
+        float s1 = 0, s2 = 0, s11 = 0, s22 = 0, s12 = 0;
+
+        for (j = 0; j < ksize; j++)
+        {
+            float a = src1[i + j * cn], b = src2[i + j * cn], w = kernel[j];
+            s1 += w * a;
+            s2 += w * b;
+            s11 += w * (a * a);
+            s22 += w * (b * b);
+            s12 += w * (a * b);
+        }
+
+        dst[i] = s1;
+        dst[i + len] = s2;
+        dst[i + len * 2] = s11;
+        dst[i + len * 3] = s22;
+        dst[i + len * 4] = s12;
+    }
+
+    return CV_OK;
+}
+
+/* rows[j] are the outputs of icvSSIMRowH_32f for the window rows */
+IPCVAPI_IMPL(CvStatus, icvSSIMRowV_32f,
+             (const float** rows, int len, int cn, const float* kernel,
+              int ksize, float c1, float c2, double* ssim_sum,
+              double* cs_sum),
+             (rows, len, cn, kernel, ksize, c1, c2, ssim_sum, cs_sum))
+{
+    int i, j, k = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        float mu1 = 0, mu2 = 0, s11 = 0, s22 = 0, s12 = 0;
+        float mu11, mu22, mu12, l, cs;
+
+        for (j = 0; j < ksize; j++)
+        {
+            const float* r = rows[j] + i;
+            float w = kernel[j];
+            mu1 += w * r[0];
+            mu2 += w * r[len];
+            s11 += w * r[len * 2];
+            s22 += w * r[len * 3];
+            s12 += w * r[len * 4];
+        }
+
+        mu11 = mu1 * mu1;
+        mu22 = mu2 * mu2;
+        mu12 = mu1 * mu2;
+        l = (mu12 * 2 + c1) / (mu11 + mu22 + c1);
+        cs = ((s12 - mu12) * 2 + c2) / ((s11 - mu11) + (s22 - mu22) + c2);
+        ssim_sum[k] += l * cs;
+        cs_sum[k] += cs;
+
+        if (++k >= cn)
+            k = 0;
+    }
+
+    return CV_OK;
+}
+
+static int CV_CDECL icvSSIMBand(int start, int end, void* arg)
+{
+    const CvSSIMBand* p = (const CvSSIMBand*)arg;
+    const int ksize = ICV_SSIM_KSIZE;
+    float buf1[(ICV_SSIM_TILE + ICV_SSIM_KSIZE - 1) * 4];
+    float buf2[(ICV_SSIM_TILE + ICV_SSIM_KSIZE - 1) * 4];
+    const float* rows[ICV_SSIM_KSIZE];
+    int cn = p->cn, esz = CV_ELEM_SIZE1(p->depth);
+    int ring_step = ICV_SSIM_TILE * cn * 5, chunk, i, y;
+    float* ring = (float*)cvAlloc(ksize * ring_step * sizeof(ring[0]));
+
+    if (!ring)
+        return CV_StsNoMem;
+
+    for (chunk = start; chunk < end; chunk++)
+    {
+        int x0 = (chunk % p->tiles_x) * ICV_SSIM_TILE;
+        int y0 = (chunk / p->tiles_x) * ICV_SSIM_BAND;
+        int x1 = MIN(x0 + ICV_SSIM_TILE, p->width);
+        int y1 = MIN(y0 + ICV_SSIM_BAND, p->height);
+        int len = (x1 - x0) * cn, inlen = len + (ksize - 1) * cn;
+        double* ssim_sum = p->sums + chunk * 8;
+        double* cs_sum = ssim_sum + 4;
+
+        memset(ssim_sum, 0, 8 * sizeof(ssim_sum[0]));
+
+        for (y = y0; y < y1 + ksize - 1; y++)
+        {
+            const float* s1 = icvRowTo32f(
+                p->data1 + y * p->step1 + x0 * cn * esz, buf1, inlen,
+                p->depth, p->scale);
+            const float* s2 = icvRowTo32f(
+                p->data2 + y * p->step2 + x0 * cn * esz, buf2, inlen,
+                p->depth, p->scale);
+
+            icvSSIMRowH_32f(s1, s2, len, cn, p->kernel, ksize,
+                            ring + ((y - y0) % ksize) * ring_step);
+
+            if (y - y0 >= ksize - 1)
+            {
+                for (i = 0; i < ksize; i++)
+                    rows[i] = ring + ((y - y0 + 1 + i) % ksize) * ring_step;
+                icvSSIMRowV_32f(rows, len, cn, p->kernel, ksize, p->c1, p->c2,
+                                ssim_sum, cs_sum);
+            }
+        }
+    }
+
+    cvFree(&ring);
+    return CV_StsOk;
+}
+
+/* computes the mean SSIM and the mean cs of every channel of one scale */
+static void icvSSIMScale(const CvMat* mat1, const CvMat* mat2, float scale,
+                         const float* kernel, double* ssim, double* cs)
+{
+    double* sums = 0;
+
+    CV_FUNCNAME("icvSSIMScale");
+
+    __BEGIN__;
+
+    CvSSIMBand band;
+    int nchunks, i, k;
+    double total;
+
+    memset(&band, 0, sizeof(band));
+    band.data1 = mat1->data.ptr;
+    band.data2 = mat2->data.ptr;
+    band.step1 = mat1->step;
+    band.step2 = mat2->step;
+    band.cn = CV_MAT_CN(mat1->type);
+    band.depth = CV_MAT_DEPTH(mat1->type);
+    band.scale = scale;
+    band.width = mat1->cols - ICV_SSIM_KSIZE + 1;
+    band.height = mat1->rows - ICV_SSIM_KSIZE + 1;
+    band.tiles_x = (band.width + ICV_SSIM_TILE - 1) / ICV_SSIM_TILE;
+    band.kernel = kernel;
+    band.c1 = 0.01f * 0.01f;
+    band.c2 = 0.03f * 0.03f;
+
+    nchunks = (band.height + ICV_SSIM_BAND - 1) / ICV_SSIM_BAND;
+    nchunks *= band.tiles_x;
+    CV_CALL(sums = (double*)cvAlloc(nchunks * 8 * sizeof(sums[0])));
+    band.sums = sums;
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nchunks), icvSSIMBand, &band,
+                                      1));
+
+    total = (double)band.width * band.height;
+    for (k = 0; k < band.cn; k++)
+    {
+        double s = 0, c = 0;
+        for (i = 0; i < nchunks; i++)
+        {
+            s += sums[i * 8 + k];
+            c += sums[i * 8 + 4 + k];
+        }
+        ssim[k] = s / total;
+        cs[k] = c / total;
+    }
+
+    __END__;
+
+    cvFree(&sums);
+}
+
+typedef struct CvSSIMDownBand
+{
+    const CvMat* src;
+    CvMat* dst;
+    float scale;
+} CvSSIMDownBand;
+
+/* averages 2x2 blocks of src into the float dst, multiplying by scale */
+static int CV_CDECL icvSSIMDownBand(int start, int end, void* arg)
+{
+    const CvSSIMDownBand* p = (const CvSSIMDownBand*)arg;
+    float buf0[ICV_QUALITY_BLOCK], buf1[ICV_QUALITY_BLOCK];
+    int depth = CV_MAT_DEPTH(p->src->type), cn = CV_MAT_CN(p->src->type);
+    int esz = CV_ELEM_SIZE1(depth), len = p->dst->cols * 2 * cn;
+    int i, k, x, y;
+
+    for (y = start; y < end; y++)
+    {
+        const uchar* src0 = p->src->data.ptr + y * 2 * p->src->step;
+        const uchar* src1 = src0 + p->src->step;
+        float* dst = (float*)(p->dst->data.ptr + y * p->dst->step);
+
+        for (x = 0; x < len; x += ICV_QUALITY_BLOCK)
+        {
+            int n = MIN(len - x, ICV_QUALITY_BLOCK);
+            const float* s0 =
+                icvRowTo32f(src0 + x * esz, buf0, n, depth, p->scale);
+            const float* s1 =
+                icvRowTo32f(src1 + x * esz, buf1, n, depth, p->scale);
+            float* d = dst + x / 2;
+
+            for (i = 0; i < n; i += cn * 2)
+                for (k = 0; k < cn; k++)
+                    d[i / 2 + k] = (s0[i + k] + s0[i + cn + k] + s1[i + k] +
+                                    s1[i + cn + k]) * 0.25f;
+        }
+    }
+
+    return CV_StsOk;
+}
+
+CV_IMPL CvScalar cvSSIM(const CvArr* arr1, const CvArr* arr2, int flags,
+                        double peak)
+{
+    static const double ms_weights[ICV_SSIM_SCALES] = {0.0448, 0.2856, 0.3001,
+                                                       0.2363, 0.1333};
+    CvScalar result = cvScalarAll(0);
+    CvMat *level1 = 0, *level2 = 0, *temp1 = 0, *temp2 = 0;
+
+    CV_FUNCNAME("cvSSIM");
+
+    __BEGIN__;
+
+    CvMat stub1, stub2, *mat1, *mat2;
+    const CvMat *src1, *src2;
+    float kernel[ICV_SSIM_KSIZE], scale;
+    double w[ICV_SSIM_KSIZE], ksum = 0, ssim[4], cs[4];
+    int cn, nscales, i, k;
+
+    CV_CALL(icvCheckQualityArrays(arr1, arr2, &stub1, &stub2, &mat1, &mat2));
+
+    if (flags & ~CV_SSIM_MULTISCALE)
+        CV_ERROR(CV_StsBadFlag, "");
+
+    nscales = flags & CV_SSIM_MULTISCALE ? ICV_SSIM_SCALES : 1;
+    if ((MIN(mat1->rows, mat1->cols) >> (nscales - 1)) < ICV_SSIM_KSIZE)
+        CV_ERROR(CV_StsBadSize, "The arrays are too small for the window");
+
+    if (peak == 0)
+        peak = icvDefaultPeak(CV_MAT_DEPTH(mat1->type));
+
+    if (peak < 0)
+        CV_ERROR(CV_StsOutOfRange, "The peak value must be positive");
+
+    for (i = 0; i < ICV_SSIM_KSIZE; i++)
+    {
+        double t = i - ICV_SSIM_KSIZE / 2;
+        ksum += w[i] = exp(-t * t / (2 * ICV_SSIM_SIGMA * ICV_SSIM_SIGMA));
+    }
+    for (i = 0; i < ICV_SSIM_KSIZE; i++)
+        kernel[i] = (float)(w[i] / ksum);
+
+    cn = CV_MAT_CN(mat1->type);
+    scale = (float)(1. / peak);
+    src1 = mat1;
+    src2 = mat2;
+
+    if (nscales > 1)
+        result = cvScalar(1, cn > 1, cn > 2, cn > 3);
+
+    for (i = 0; i < nscales; i++)
+    {
+        CV_CALL(icvSSIMScale(src1, src2, scale, kernel, ssim, cs));
+
+        if (nscales == 1)
+            for (k = 0; k < cn; k++)
+                result.val[k] = ssim[k];
+        else
+            // the negative terms are clipped, so the powers are defined
+            for (k = 0; k < cn; k++)
+                result.val[k] *=
+                    pow(MAX(i < nscales - 1 ? cs[k] : ssim[k], 0.),
+                        ms_weights[i]);
+
+        if (i < nscales - 1)
+        {
+            CvSSIMDownBand down;
+            int rows = src1->rows / 2, cols = src1->cols / 2;
+
+            CV_CALL(temp1 = cvCreateMat(rows, cols, CV_32FC(cn)));
+            CV_CALL(temp2 = cvCreateMat(rows, cols, CV_32FC(cn)));
+
+            down.scale = scale;
+            down.src = src1;
+            down.dst = temp1;
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, rows), icvSSIMDownBand,
+                                              &down, CV_PARALLEL_GRAIN(cols)));
+            down.src = src2;
+            down.dst = temp2;
+            IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, rows), icvSSIMDownBand,
+                                              &down, CV_PARALLEL_GRAIN(cols)));
+
+            cvReleaseMat(&level1);
+            cvReleaseMat(&level2);
+            src1 = level1 = temp1;
+            src2 = level2 = temp2;
+            temp1 = temp2 = 0;
+            scale = 1.f;
+        }
+    }
+
+    __END__;
+
+    cvReleaseMat(&level1);
+    cvReleaseMat(&level2);
+    cvReleaseMat(&temp1);
+    cvReleaseMat(&temp2);
+
+    return result;
+}
+
+/* End of file. */
@@ -0,0 +1,1624 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+/****************************************************************************************\
+*                 Built-in SIMD versions of the optimized cxcore functions *
+\****************************************************************************************/
+
+#include "_cxcore.h"
+
+#if CV_BUILTIN_SIMD
+#include <immintrin.h>
+
+/****************************************************************************************\
+*                                     cvConvertScale *
+\****************************************************************************************/
+
+/* The values are scaled in double precision and rounded with the current
+   (round-to-nearest) mode, as cvRound() does, so the results match the C
+   code in cxconvert.cpp bit by bit. */
+
+/* the zero-masking AVX-512 conversions with all lanes set are the plain
+   ones; the plain intrinsics of GCC 12 pass an undefined vector as the
+   unused source and trip -Wmaybe-uninitialized */
+#define ICV_MASK8_ALL ((__mmask8)-1)
+
+#define ICV_CVT_SCALE_TAIL_32F8U()               \
+    for (; i < size.width; i++)                  \
+    {                                            \
+        int t = cvRound(src[i] * scale + shift); \
+        dst[i] = CV_CAST_8U(t);                  \
+    }
+
+#define ICV_CVT_SCALE_TAIL_32F() \
+    for (; i < size.width; i++)  \
+        dst[i] = (float)(src[i] * scale + shift);
+
+CV_TARGET_SSE2 static CvStatus CV_STDCALL icvCvtScale_32f8u_C1R_sse2(
+    const float* src, int srcstep, uchar* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m128d a = _mm_set1_pd(scale), b = _mm_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 8; i += 8)
+        {
+            __m128 s0 = _mm_loadu_ps(src + i), s1 = _mm_loadu_ps(src + i + 4);
+            __m128i t0 = _mm_cvtpd_epi32(
+                _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(s0), a), b));
+            __m128i t1 = _mm_cvtpd_epi32(_mm_add_pd(
+                _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(s0, s0)), a), b));
+            __m128i t2 = _mm_cvtpd_epi32(
+                _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(s1), a), b));
+            __m128i t3 = _mm_cvtpd_epi32(_mm_add_pd(
+                _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(s1, s1)), a), b));
+            t0 = _mm_packs_epi32(_mm_unpacklo_epi64(t0, t1),
+                                 _mm_unpacklo_epi64(t2, t3));
+            _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(t0, t0));
+        }
+        ICV_CVT_SCALE_TAIL_32F8U();
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvCvtScale_32f8u_C1R_avx2(
+    const float* src, int srcstep, uchar* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m256d a = _mm256_set1_pd(scale), b = _mm256_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 16; i += 16)
+        {
+            __m128i t[4];
+            for (int k = 0; k < 4; k++)
+            {
+                __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(src + i + k * 4));
+                t[k] = _mm256_cvtpd_epi32(
+                    _mm256_add_pd(_mm256_mul_pd(v, a), b));
+            }
+            t[0] = _mm_packs_epi32(t[0], t[1]);
+            t[2] = _mm_packs_epi32(t[2], t[3]);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(t[0], t[2]));
+        }
+        ICV_CVT_SCALE_TAIL_32F8U();
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX512 static CvStatus CV_STDCALL icvCvtScale_32f8u_C1R_avx512(
+    const float* src, int srcstep, uchar* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m512d a = _mm512_set1_pd(scale), b = _mm512_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 32; i += 32)
+        {
+            __m256i t[4];
+            for (int k = 0; k < 4; k++)
+            {
+                __m512d v = _mm512_maskz_cvtps_pd(
+                    ICV_MASK8_ALL, _mm256_loadu_ps(src + i + k * 8));
+                t[k] = _mm512_maskz_cvtpd_epi32(
+                    ICV_MASK8_ALL, _mm512_add_pd(_mm512_mul_pd(v, a), b));
+            }
+            // the 256-bit packs work within 128-bit lanes, the final
+            // permutation restores the order
+            t[0] = _mm256_packs_epi32(t[0], t[1]);
+            t[2] = _mm256_packs_epi32(t[2], t[3]);
+            t[0] = _mm256_packus_epi16(t[0], t[2]);
+            t[0] = _mm256_permutevar8x32_epi32(
+                t[0], _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            _mm256_storeu_si256((__m256i*)(dst + i), t[0]);
+        }
+        ICV_CVT_SCALE_TAIL_32F8U();
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_SSE2 static CvStatus CV_STDCALL icvCvtScale_32f_C1R_sse2(
+    const float* src, int srcstep, float* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m128d a = _mm_set1_pd(scale), b = _mm_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 4; i += 4)
+        {
+            __m128 s = _mm_loadu_ps(src + i);
+            __m128 t0 = _mm_cvtpd_ps(
+                _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(s), a), b));
+            __m128 t1 = _mm_cvtpd_ps(_mm_add_pd(
+                _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(s, s)), a), b));
+            _mm_storeu_ps(dst + i, _mm_movelh_ps(t0, t1));
+        }
+        ICV_CVT_SCALE_TAIL_32F();
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvCvtScale_32f_C1R_avx2(
+    const float* src, int srcstep, float* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m256d a = _mm256_set1_pd(scale), b = _mm256_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 8; i += 8)
+        {
+            __m256d v0 = _mm256_cvtps_pd(_mm_loadu_ps(src + i));
+            __m256d v1 = _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4));
+            __m128 t0 = _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(v0, a), b));
+            __m128 t1 = _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(v1, a), b));
+            _mm_storeu_ps(dst + i, t0);
+            _mm_storeu_ps(dst + i + 4, t1);
+        }
+        ICV_CVT_SCALE_TAIL_32F();
+    }
+
+    return CV_OK;
+}
+
+CV_TARGET_AVX512 static CvStatus CV_STDCALL icvCvtScale_32f_C1R_avx512(
+    const float* src, int srcstep, float* dst, int dststep, CvSize size,
+    double scale, double shift)
+{
+    __m512d a = _mm512_set1_pd(scale), b = _mm512_set1_pd(shift);
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0;
+        for (; i <= size.width - 16; i += 16)
+        {
+            __m512d v0 =
+                _mm512_maskz_cvtps_pd(ICV_MASK8_ALL, _mm256_loadu_ps(src + i));
+            __m512d v1 = _mm512_maskz_cvtps_pd(ICV_MASK8_ALL,
+                                               _mm256_loadu_ps(src + i + 8));
+            __m256 t0 = _mm512_maskz_cvtpd_ps(
+                ICV_MASK8_ALL, _mm512_add_pd(_mm512_mul_pd(v0, a), b));
+            __m256 t1 = _mm512_maskz_cvtpd_ps(
+                ICV_MASK8_ALL, _mm512_add_pd(_mm512_mul_pd(v1, a), b));
+            _mm256_storeu_ps(dst + i, t0);
+            _mm256_storeu_ps(dst + i + 8, t1);
+        }
+        ICV_CVT_SCALE_TAIL_32F();
+    }
+
+    return CV_OK;
+}
+
+#undef ICV_CVT_SCALE_TAIL_32F8U
+#undef ICV_CVT_SCALE_TAIL_32F
+#undef ICV_MASK8_ALL
+
+/****************************************************************************************\
+*                               Half <-> float conversion *
+\****************************************************************************************/
+
+/* vcvtps2ph rounds to the nearest even value like cvFloatToHalf() */
+
+CV_TARGET_F16C static CvStatus CV_STDCALL icvCvt_16f32f_f16c(const ushort* src,
+                                                             float* dst,
+                                                             int len)
+{
+    int i = 0;
+    for (; i <= len - 16; i += 16)
+    {
+        __m128i h0 = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i h1 = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h0));
+        _mm256_storeu_ps(dst + i + 8, _mm256_cvtph_ps(h1));
+    }
+    for (; i < len; i++)
+        dst[i] = cvHalfToFloat(src[i]);
+
+    return CV_OK;
+}
+
+CV_TARGET_F16C static CvStatus CV_STDCALL icvCvt_32f16f_f16c(const float* src,
+                                                             ushort* dst,
+                                                             int len)
+{
+    int i = 0;
+    for (; i <= len - 16; i += 16)
+    {
+        __m128i h0 = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+                                     _MM_FROUND_TO_NEAREST_INT);
+        __m128i h1 = _mm256_cvtps_ph(_mm256_loadu_ps(src + i + 8),
+                                     _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h0);
+        _mm_storeu_si128((__m128i*)(dst + i + 8), h1);
+    }
+    for (; i < len; i++)
+        dst[i] = cvFloatToHalf(src[i]);
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                         cvGEMM *
+\****************************************************************************************/
+
+/* D = alpha*op(X)*op(Y) + beta*D, where the arguments come in the BLAS ?gemm
+   order that cvGEMM uses (the second matrix of cvGEMM first). The operands
+   are copied block by block into panels of ICV_GEMM_MR rows and ICV_GEMM_NR
+   columns, that the register-blocked kernel walks sequentially. Both depths
+   are packed to double and the products are accumulated in double, as the C
+   code does; 32f destination is rounded once per ICV_GEMM_KC-long slice of
+   the dot products. D is not read when beta is 0. */
+
+#define ICV_GEMM_MR 4
+#define ICV_GEMM_NR 8
+#define ICV_GEMM_MC 96
+#define ICV_GEMM_KC 256
+#define ICV_GEMM_NC 1024
+
+typedef void (*CvGEMMKernelFunc)(int kc, const double* a, const double* b,
+                                 double* tile);
+
+typedef void (*CvGEMMPackFunc)(const void* src, int pstep, int kstep, int n,
+                               int kc, int w, double* buf);
+
+typedef void (*CvGEMMStoreFunc)(const double* tile, void* dst, int ldd, int m,
+                                int n, double alpha, double beta, int first);
+
+/* packs the n x kc block src(i, k) = src[i*pstep + k*kstep] into panels
+   of w rows, zero-padding the last one */
+#define ICV_DEF_GEMM_PACK_STORE(flavor, arrtype)                           \
+    static void icvGEMMPack_##flavor(const void* _src, int pstep,          \
+                                     int kstep, int n, int kc, int w,      \
+                                     double* buf)                          \
+    {                                                                      \
+        const arrtype* src = (const arrtype*)_src;                         \
+        int i, j, k;                                                       \
+                                                                           \
+        for (i = 0; i < n; i += w, src += pstep * w)                       \
+        {                                                                  \
+            int m = MIN(w, n - i);                                         \
+            for (k = 0; k < kc; k++, buf += w)                             \
+            {                                                              \
+                const arrtype* s = src + k * kstep;                        \
+                for (j = 0; j < m; j++)                                    \
+                    buf[j] = s[j * pstep];                                 \
+                for (; j < w; j++)                                         \
+                    buf[j] = 0;                                            \
+            }                                                              \
+        }                                                                  \
+    }                                                                      \
+                                                                           \
+    static void icvGEMMStore_##flavor(const double* tile, void* _dst,      \
+                                      int ldd, int m, int n, double alpha, \
+                                      double beta, int first)              \
+    {                                                                      \
+        arrtype* dst = (arrtype*)_dst;                                     \
+        int i, j;                                                          \
+                                                                           \
+        for (i = 0; i < m; i++, tile += ICV_GEMM_NR, dst += ldd)           \
+        {                                                                  \
+            if (!first)                                                    \
+                for (j = 0; j < n; j++)                                    \
+                    dst[j] = (arrtype)(dst[j] + tile[j] * alpha);          \
+            else if (beta == 0)                                            \
+                for (j = 0; j < n; j++)                                    \
+                    dst[j] = (arrtype)(tile[j] * alpha);                   \
+            else                                                           \
+                for (j = 0; j < n; j++)                                    \
+                    dst[j] = (arrtype)(tile[j] * alpha + dst[j] * beta);   \
+        }                                                                  \
+    }
+
+ICV_DEF_GEMM_PACK_STORE(32f, float)
+ICV_DEF_GEMM_PACK_STORE(64f, double)
+
+#undef ICV_DEF_GEMM_PACK_STORE
+
+/* the 4x8 tile of the products of a 4-row panel of X and an 8-column
+   panel of Y */
+CV_TARGET_SSE2 static void icvGEMMKernel_sse2(int kc, const double* a,
+                                              const double* b, double* tile)
+{
+    int j, k;
+
+    for (j = 0; j < ICV_GEMM_NR; j += 4)
+    {
+        __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+        __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+        __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+        __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+        const double* ap = a;
+        const double* bp = b + j;
+
+        for (k = 0; k < kc; k++, ap += ICV_GEMM_MR, bp += ICV_GEMM_NR)
+        {
+            __m128d b0 = _mm_loadu_pd(bp), b1 = _mm_loadu_pd(bp + 2);
+            __m128d t = _mm_load1_pd(ap);
+            c00 = _mm_add_pd(c00, _mm_mul_pd(t, b0));
+            c01 = _mm_add_pd(c01, _mm_mul_pd(t, b1));
+            t = _mm_load1_pd(ap + 1);
+            c10 = _mm_add_pd(c10, _mm_mul_pd(t, b0));
+            c11 = _mm_add_pd(c11, _mm_mul_pd(t, b1));
+            t = _mm_load1_pd(ap + 2);
+            c20 = _mm_add_pd(c20, _mm_mul_pd(t, b0));
+            c21 = _mm_add_pd(c21, _mm_mul_pd(t, b1));
+            t = _mm_load1_pd(ap + 3);
+            c30 = _mm_add_pd(c30, _mm_mul_pd(t, b0));
+            c31 = _mm_add_pd(c31, _mm_mul_pd(t, b1));
+        }
+
+        _mm_storeu_pd(tile + j, c00);
+        _mm_storeu_pd(tile + j + 2, c01);
+        _mm_storeu_pd(tile + ICV_GEMM_NR + j, c10);
+        _mm_storeu_pd(tile + ICV_GEMM_NR + j + 2, c11);
+        _mm_storeu_pd(tile + ICV_GEMM_NR * 2 + j, c20);
+        _mm_storeu_pd(tile + ICV_GEMM_NR * 2 + j + 2, c21);
+        _mm_storeu_pd(tile + ICV_GEMM_NR * 3 + j, c30);
+        _mm_storeu_pd(tile + ICV_GEMM_NR * 3 + j + 2, c31);
+    }
+}
+
+CV_TARGET_AVX2 static void icvGEMMKernel_avx2(int kc, const double* a,
+                                              const double* b, double* tile)
+{
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    int k;
+
+    for (k = 0; k < kc; k++, a += ICV_GEMM_MR, b += ICV_GEMM_NR)
+    {
+        __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+        __m256d t = _mm256_broadcast_sd(a);
+        c00 = _mm256_add_pd(c00, _mm256_mul_pd(t, b0));
+        c01 = _mm256_add_pd(c01, _mm256_mul_pd(t, b1));
+        t = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_add_pd(c10, _mm256_mul_pd(t, b0));
+        c11 = _mm256_add_pd(c11, _mm256_mul_pd(t, b1));
+        t = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_add_pd(c20, _mm256_mul_pd(t, b0));
+        c21 = _mm256_add_pd(c21, _mm256_mul_pd(t, b1));
+        t = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_add_pd(c30, _mm256_mul_pd(t, b0));
+        c31 = _mm256_add_pd(c31, _mm256_mul_pd(t, b1));
+    }
+
+    _mm256_storeu_pd(tile, c00);
+    _mm256_storeu_pd(tile + 4, c01);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR, c10);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR + 4, c11);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR * 2, c20);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR * 2 + 4, c21);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR * 3, c30);
+    _mm256_storeu_pd(tile + ICV_GEMM_NR * 3 + 4, c31);
+}
+
+/* the state shared by the bands of rows of one packed slice of op(Y) */
+typedef struct CvGEMMBand
+{
+    const uchar* x;
+    int x_pstep, x_kstep;
+    const double* ybuf;
+    uchar* d;
+    int ldd;
+    int rows, nc, kc;
+    double alpha, beta;
+    int first;
+    int elem_size;
+    CvGEMMKernelFunc kernel;
+    CvGEMMPackFunc pack;
+    CvGEMMStoreFunc store;
+} CvGEMMBand;
+
+/* multiplies the blocks [start, end) of ICV_GEMM_MC rows of the current
+   slice of op(X) by the packed slice of op(Y) */
+static int CV_CDECL icvGEMMBand(int start, int end, void* arg)
+{
+    const CvGEMMBand* band = (const CvGEMMBand*)arg;
+    double tile[ICV_GEMM_MR * ICV_GEMM_NR];
+    double* xbuf;
+    int es = band->elem_size, kc = band->kc;
+    int ic, ir, jr;
+
+    xbuf = (double*)cvAlloc(ICV_GEMM_MC * MAX(kc, 1) * sizeof(xbuf[0]));
+    if (!xbuf)
+        return CV_OUTOFMEM_ERR;
+
+    for (ic = start * ICV_GEMM_MC; ic < end * ICV_GEMM_MC && ic < band->rows;
+         ic += ICV_GEMM_MC)
+    {
+        int mc = MIN(ICV_GEMM_MC, band->rows - ic);
+        band->pack(band->x + (size_t)ic * band->x_pstep * es, band->x_pstep,
+                   band->x_kstep, mc, kc, ICV_GEMM_MR, xbuf);
+
+        for (jr = 0; jr < band->nc; jr += ICV_GEMM_NR)
+        {
+            int nr = MIN(ICV_GEMM_NR, band->nc - jr);
+            const double* ypanel = band->ybuf + jr * kc;
+
+            for (ir = 0; ir < mc; ir += ICV_GEMM_MR)
+            {
+                band->kernel(kc, xbuf + ir * kc, ypanel, tile);
+                band->store(tile,
+                            band->d + ((size_t)(ic + ir) * band->ldd + jr) * es,
+                            band->ldd, MIN(ICV_GEMM_MR, mc - ir), nr,
+                            band->alpha, band->beta, band->first);
+            }
+        }
+    }
+
+    cvFree(&xbuf);
+    return CV_OK;
+}
+
+/* op(X) is <rows> x <len>, op(Y) is <len> x <cols>, D is <rows> x <cols> */
+static void icvGEMM(const char* transy, const char* transx, int cols,
+                    int rows, int len, double alpha, const void* y, int ldy,
+                    const void* x, int ldx, double beta, void* d, int ldd,
+                    int elem_size, CvGEMMKernelFunc kernel,
+                    CvGEMMPackFunc pack, CvGEMMStoreFunc store)
+{
+    CvGEMMBand band;
+    double* ybuf;
+    int y_pstep, y_kstep, jc, pc;
+
+    if (rows <= 0 || cols <= 0)
+        return;
+
+    ybuf = (double*)cvAlloc(ICV_GEMM_KC * cvAlign(MIN(cols, ICV_GEMM_NC),
+                                                  ICV_GEMM_NR)
+                            * sizeof(ybuf[0]));
+    if (!ybuf)
+        return;
+
+    if (*transx == 'n' || *transx == 'N')
+        band.x_pstep = ldx, band.x_kstep = 1;
+    else
+        band.x_pstep = 1, band.x_kstep = ldx;
+
+    if (*transy == 'n' || *transy == 'N')
+        y_pstep = 1, y_kstep = ldy;
+    else
+        y_pstep = ldy, y_kstep = 1;
+
+    band.ldd = ldd;
+    band.rows = rows;
+    band.alpha = alpha;
+    band.beta = beta;
+    band.elem_size = elem_size;
+    band.kernel = kernel;
+    band.pack = pack;
+    band.store = store;
+    band.ybuf = ybuf;
+
+    for (jc = 0; jc < cols; jc += ICV_GEMM_NC)
+    {
+        band.nc = MIN(ICV_GEMM_NC, cols - jc);
+        band.d = (uchar*)d + (size_t)jc * elem_size;
+
+        /* a single empty slice still applies beta when len is 0 */
+        for (pc = 0; pc < len || pc == 0; pc += ICV_GEMM_KC)
+        {
+            band.kc = MIN(ICV_GEMM_KC, len - pc);
+            band.first = pc == 0;
+            band.x = (const uchar*)x + (size_t)pc * band.x_kstep * elem_size;
+            pack((const uchar*)y + ((size_t)jc * y_pstep + (size_t)pc * y_kstep)
+                                       * elem_size,
+                 y_pstep, y_kstep, band.nc, band.kc, ICV_GEMM_NR, ybuf);
+
+            cvParallelFor(cvSlice(0, (rows + ICV_GEMM_MC - 1) / ICV_GEMM_MC),
+                          icvGEMMBand, &band, 1);
+        }
+    }
+
+    cvFree(&ybuf);
+}
+
+#define ICV_DEF_BLAS_GEMM(flavor, arrtype, isa)                              \
+    static void CV_CDECL icvBLAS_GEMM_##flavor##_##isa(                      \
+        const char* transa, const char* transb, int* n, int* m, int* k,      \
+        const void* alpha, const void* a, int* lda, const void* b, int* ldb, \
+        const void* beta, void* c, int* ldc)                                 \
+    {                                                                        \
+        icvGEMM(transa, transb, *n, *m, *k, *(const arrtype*)alpha, a, *lda, \
+                b, *ldb, *(const arrtype*)beta, c, *ldc, sizeof(arrtype),    \
+                icvGEMMKernel_##isa, icvGEMMPack_##flavor,                   \
+                icvGEMMStore_##flavor);                                      \
+    }
+
+ICV_DEF_BLAS_GEMM(32f, float, sse2)
+ICV_DEF_BLAS_GEMM(32f, float, avx2)
+ICV_DEF_BLAS_GEMM(64f, double, sse2)
+ICV_DEF_BLAS_GEMM(64f, double, avx2)
+
+#undef ICV_DEF_BLAS_GEMM
+
+/****************************************************************************************\
+*                                      cvTransform *
+\****************************************************************************************/
+
+/* The built-in versions of the ColorTwist hooks, that cvTransform calls with
+   the float cn x 4 matrix ([M|shift] for 3 channels, M for 4 channels).
+   Every output channel is computed as ((m0*x0 + m1*x1) + m2*x2) + m3[*x3]
+   in single precision, in the same order in the vector code and in the
+   scalar tails. 8u/16u/16s rows are widened to
+   float in chunks of ICV_TWIST_CHUNK pixels and rounded back with cvRound()
+   semantics; a result may differ from the double-precision C code by one
+   unit when it falls within the float error of a half. */
+
+#define ICV_TWIST_CHUNK 256
+
+#define ICV_TWIST_PIX_C3(s, d, m)                                      \
+    {                                                                  \
+        float x0 = (s)[0], x1 = (s)[1], x2 = (s)[2];                   \
+        float t0 = (m)[0] * x0 + (m)[1] * x1 + (m)[2] * x2 + (m)[3];   \
+        float t1 = (m)[4] * x0 + (m)[5] * x1 + (m)[6] * x2 + (m)[7];   \
+        float t2 = (m)[8] * x0 + (m)[9] * x1 + (m)[10] * x2 + (m)[11]; \
+        (d)[0] = t0;                                                   \
+        (d)[1] = t1;                                                   \
+        (d)[2] = t2;                                                   \
+    }
+
+#define ICV_TWIST_PIX_C4(s, d, m)                                 \
+    {                                                             \
+        float x0 = (s)[0], x1 = (s)[1], x2 = (s)[2], x3 = (s)[3]; \
+        float t0 = (m)[0] * x0 + (m)[1] * x1 + (m)[2] * x2        \
+                   + (m)[3] * x3;                                 \
+        float t1 = (m)[4] * x0 + (m)[5] * x1 + (m)[6] * x2        \
+                   + (m)[7] * x3;                                 \
+        float t2 = (m)[8] * x0 + (m)[9] * x1 + (m)[10] * x2       \
+                   + (m)[11] * x3;                                \
+        float t3 = (m)[12] * x0 + (m)[13] * x1 + (m)[14] * x2     \
+                   + (m)[15] * x3;                                \
+        (d)[0] = t0;                                              \
+        (d)[1] = t1;                                              \
+        (d)[2] = t2;                                              \
+        (d)[3] = t3;                                              \
+    }
+
+/* 8 interleaved 3-channel pixels are split into the planes of the two
+   halves of 4 pixels (lanes 0-3 and 4-7), transformed, and merged back */
+CV_TARGET_AVX2 static void icvColorTwistRow_32f_C3_avx2(const float* src,
+                                                        float* dst, int len,
+                                                        const float* m)
+{
+    __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]);
+    __m256 m2 = _mm256_set1_ps(m[2]), m3 = _mm256_set1_ps(m[3]);
+    __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]);
+    __m256 m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]);
+    __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]);
+    __m256 m10 = _mm256_set1_ps(m[10]), m11 = _mm256_set1_ps(m[11]);
+    int i = 0;
+
+    for (; i <= len - 8; i += 8, src += 24, dst += 24)
+    {
+        __m256 v03 = _mm256_castps128_ps256(_mm_loadu_ps(src));
+        __m256 v14 = _mm256_castps128_ps256(_mm_loadu_ps(src + 4));
+        __m256 v25 = _mm256_castps128_ps256(_mm_loadu_ps(src + 8));
+        v03 = _mm256_insertf128_ps(v03, _mm_loadu_ps(src + 12), 1);
+        v14 = _mm256_insertf128_ps(v14, _mm_loadu_ps(src + 16), 1);
+        v25 = _mm256_insertf128_ps(v25, _mm_loadu_ps(src + 20), 1);
+        __m256 xy = _mm256_shuffle_ps(v14, v25, _MM_SHUFFLE(2, 1, 3, 2));
+        __m256 yz = _mm256_shuffle_ps(v03, v14, _MM_SHUFFLE(1, 0, 2, 1));
+        __m256 x0 = _mm256_shuffle_ps(v03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        __m256 x1 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        __m256 x2 = _mm256_shuffle_ps(yz, v25, _MM_SHUFFLE(3, 0, 3, 1));
+        __m256 t0, t1, t2;
+
+        t0 = _mm256_add_ps(_mm256_mul_ps(m0, x0), _mm256_mul_ps(m1, x1));
+        t0 = _mm256_add_ps(_mm256_add_ps(t0, _mm256_mul_ps(m2, x2)), m3);
+        t1 = _mm256_add_ps(_mm256_mul_ps(m4, x0), _mm256_mul_ps(m5, x1));
+        t1 = _mm256_add_ps(_mm256_add_ps(t1, _mm256_mul_ps(m6, x2)), m7);
+        t2 = _mm256_add_ps(_mm256_mul_ps(m8, x0), _mm256_mul_ps(m9, x1));
+        t2 = _mm256_add_ps(_mm256_add_ps(t2, _mm256_mul_ps(m10, x2)), m11);
+
+        xy = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+        yz = _mm256_shuffle_ps(t1, t2, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 zx = _mm256_shuffle_ps(t2, t0, _MM_SHUFFLE(3, 1, 2, 0));
+        v03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+        v14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        v25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm_storeu_ps(dst, _mm256_castps256_ps128(v03));
+        _mm_storeu_ps(dst + 4, _mm256_castps256_ps128(v14));
+        _mm_storeu_ps(dst + 8, _mm256_castps256_ps128(v25));
+        _mm_storeu_ps(dst + 12, _mm256_extractf128_ps(v03, 1));
+        _mm_storeu_ps(dst + 16, _mm256_extractf128_ps(v14, 1));
+        _mm_storeu_ps(dst + 20, _mm256_extractf128_ps(v25, 1));
+    }
+
+    for (; i < len; i++, src += 3, dst += 3)
+        ICV_TWIST_PIX_C3(src, dst, m);
+}
+
+/* a vector holds 2 pixels; the channels of each are broadcast in turn
+   and multiplied by the columns of the matrix */
+CV_TARGET_AVX2 static void icvColorTwistRow_32f_C4_avx2(const float* src,
+                                                        float* dst, int len,
+                                                        const float* m)
+{
+    __m128 m0 = _mm_setr_ps(m[0], m[4], m[8], m[12]);
+    __m128 m1 = _mm_setr_ps(m[1], m[5], m[9], m[13]);
+    __m128 m2 = _mm_setr_ps(m[2], m[6], m[10], m[14]);
+    __m128 m3 = _mm_setr_ps(m[3], m[7], m[11], m[15]);
+    __m256 c0 = _mm256_insertf128_ps(_mm256_castps128_ps256(m0), m0, 1);
+    __m256 c1 = _mm256_insertf128_ps(_mm256_castps128_ps256(m1), m1, 1);
+    __m256 c2 = _mm256_insertf128_ps(_mm256_castps128_ps256(m2), m2, 1);
+    __m256 c3 = _mm256_insertf128_ps(_mm256_castps128_ps256(m3), m3, 1);
+    int i = 0;
+
+    for (; i <= len - 4; i += 4, src += 16, dst += 16)
+    {
+        __m256 v0 = _mm256_loadu_ps(src), v1 = _mm256_loadu_ps(src + 8);
+        __m256 t0, t1;
+
+        t0 = _mm256_add_ps(_mm256_mul_ps(c0, _mm256_permute_ps(v0, 0x00)),
+                           _mm256_mul_ps(c1, _mm256_permute_ps(v0, 0x55)));
+        t1 = _mm256_add_ps(_mm256_mul_ps(c0, _mm256_permute_ps(v1, 0x00)),
+                           _mm256_mul_ps(c1, _mm256_permute_ps(v1, 0x55)));
+        t0 = _mm256_add_ps(t0, _mm256_mul_ps(c2, _mm256_permute_ps(v0, 0xaa)));
+        t1 = _mm256_add_ps(t1, _mm256_mul_ps(c2, _mm256_permute_ps(v1, 0xaa)));
+        t0 = _mm256_add_ps(t0, _mm256_mul_ps(c3, _mm256_permute_ps(v0, 0xff)));
+        t1 = _mm256_add_ps(t1, _mm256_mul_ps(c3, _mm256_permute_ps(v1, 0xff)));
+
+        _mm256_storeu_ps(dst, t0);
+        _mm256_storeu_ps(dst + 8, t1);
+    }
+
+    for (; i < len; i++, src += 4, dst += 4)
+        ICV_TWIST_PIX_C4(src, dst, m);
+}
+
+CV_TARGET_AVX2 static void icvWidenRow_8u32f_avx2(const uchar* src,
+                                                  float* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m128i v = _mm_loadl_epi64((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)));
+    }
+    for (; i < len; i++)
+        dst[i] = (float)src[i];
+}
+
+CV_TARGET_AVX2 static void icvWidenRow_16u32f_avx2(const ushort* src,
+                                                   float* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v)));
+    }
+    for (; i < len; i++)
+        dst[i] = (float)src[i];
+}
+
+CV_TARGET_AVX2 static void icvWidenRow_16s32f_avx2(const short* src,
+                                                   float* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)));
+    }
+    for (; i < len; i++)
+        dst[i] = (float)src[i];
+}
+
+/* vcvtps2dq returns INT_MIN for NaNs and out-of-range values, as cvRound()
+   does, and the saturating packs then match CV_CAST_8U/16U/16S */
+CV_TARGET_AVX2 static void icvNarrowRow_32f8u_avx2(const float* src,
+                                                   uchar* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m256i v = _mm256_cvtps_epi32(_mm256_loadu_ps(src + i));
+        __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                    _mm256_extracti128_si256(v, 1));
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(w, w));
+    }
+    for (; i < len; i++)
+    {
+        int t = cvRound(src[i]);
+        dst[i] = CV_CAST_8U(t);
+    }
+}
+
+CV_TARGET_AVX2 static void icvNarrowRow_32f16u_avx2(const float* src,
+                                                    ushort* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m256i v = _mm256_cvtps_epi32(_mm256_loadu_ps(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i),
+                         _mm_packus_epi32(_mm256_castsi256_si128(v),
+                                          _mm256_extracti128_si256(v, 1)));
+    }
+    for (; i < len; i++)
+    {
+        int t = cvRound(src[i]);
+        dst[i] = CV_CAST_16U(t);
+    }
+}
+
+CV_TARGET_AVX2 static void icvNarrowRow_32f16s_avx2(const float* src,
+                                                    short* dst, int len)
+{
+    int i = 0;
+    for (; i <= len - 8; i += 8)
+    {
+        __m256i v = _mm256_cvtps_epi32(_mm256_loadu_ps(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i),
+                         _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                         _mm256_extracti128_si256(v, 1)));
+    }
+    for (; i < len; i++)
+    {
+        int t = cvRound(src[i]);
+        dst[i] = CV_CAST_16S(t);
+    }
+}
+
+static CvStatus CV_STDCALL icvColorTwist_32f_C3R_avx2(const void* src,
+                                                      int srcstep, void* dst,
+                                                      int dststep, CvSize size,
+                                                      const float* twist)
+{
+    for (; size.height--; src = (const uchar*)src + srcstep,
+                          dst = (uchar*)dst + dststep)
+        icvColorTwistRow_32f_C3_avx2((const float*)src, (float*)dst,
+                                     size.width, twist);
+    return CV_OK;
+}
+
+static CvStatus CV_STDCALL icvColorTwist_32f_C4R_avx2(const void* src,
+                                                      int srcstep, void* dst,
+                                                      int dststep, CvSize size,
+                                                      const float* twist)
+{
+    for (; size.height--; src = (const uchar*)src + srcstep,
+                          dst = (uchar*)dst + dststep)
+        icvColorTwistRow_32f_C4_avx2((const float*)src, (float*)dst,
+                                     size.width, twist);
+    return CV_OK;
+}
+
+#define ICV_DEF_COLOR_TWIST(flavor, arrtype, cn)                              \
+    static CvStatus CV_STDCALL icvColorTwist_##flavor##_C##cn##R_avx2(        \
+        const void* _src, int srcstep, void* _dst, int dststep, CvSize size,  \
+        const float* twist)                                                   \
+    {                                                                         \
+        float buf[ICV_TWIST_CHUNK * cn];                                      \
+        const arrtype* src = (const arrtype*)_src;                            \
+        arrtype* dst = (arrtype*)_dst;                                        \
+        srcstep /= sizeof(src[0]);                                            \
+        dststep /= sizeof(dst[0]);                                            \
+                                                                              \
+        for (; size.height--; src += srcstep, dst += dststep)                 \
+        {                                                                     \
+            int i, len;                                                       \
+            for (i = 0; i < size.width; i += len)                             \
+            {                                                                 \
+                len = MIN(size.width - i, ICV_TWIST_CHUNK);                   \
+                icvWidenRow_##flavor##32f_avx2(src + i * cn, buf, len * cn);  \
+                icvColorTwistRow_32f_C##cn##_avx2(buf, buf, len, twist);      \
+                icvNarrowRow_32f##flavor##_avx2(buf, dst + i * cn, len * cn); \
+            }                                                                 \
+        }                                                                     \
+                                                                              \
+        return CV_OK;                                                         \
+    }
+
+ICV_DEF_COLOR_TWIST(8u, uchar, 3)
+ICV_DEF_COLOR_TWIST(16u, ushort, 3)
+ICV_DEF_COLOR_TWIST(16s, short, 3)
+ICV_DEF_COLOR_TWIST(8u, uchar, 4)
+ICV_DEF_COLOR_TWIST(16u, ushort, 4)
+
+#undef ICV_DEF_COLOR_TWIST
+#undef ICV_TWIST_PIX_C3
+#undef ICV_TWIST_PIX_C4
+
+/****************************************************************************************\
+*                                          cvDFT *
+\****************************************************************************************/
+
+/* The radix-4 and radix-2 passes of icvDFT_32fc/64fc, two complex numbers
+   per vector. The computations are done in double and in the same order as
+   in the C code, so the results are the same up to the sign of zeros. */
+
+/* (a.re*w.re - a.im*w.im, a.im*w.re + a.re*w.im) for both numbers */
+CV_TARGET_AVX2 static inline __m256d icvCMul_avx2(__m256d a, __m256d w)
+{
+    __m256d t0 = _mm256_mul_pd(a, _mm256_movedup_pd(w));
+    __m256d t1 = _mm256_mul_pd(_mm256_permute_pd(a, 5),
+                               _mm256_permute_pd(w, 15));
+    return _mm256_addsub_pd(t0, t1);
+}
+
+/* a0 = v0[0], a1 = v0[nx], a2 = v1[0], a3 = v1[nx] (twiddled) */
+#define ICV_DFT_BUTTERFLY4(a0, a1, a2, a3)                            \
+    {                                                                 \
+        __m256d p = _mm256_add_pd(a0, a1), q = _mm256_sub_pd(a0, a1); \
+        __m256d s = _mm256_add_pd(a2, a3);                            \
+        /* -i*(a2 - a3) */                                            \
+        __m256d t = _mm256_shuffle_pd(_mm256_sub_pd(a2, a3),          \
+                                      _mm256_sub_pd(a3, a2), 5);      \
+        a0 = _mm256_add_pd(p, s);                                     \
+        a2 = _mm256_sub_pd(p, s);                                     \
+        a1 = _mm256_add_pd(q, t);                                     \
+        a3 = _mm256_sub_pd(q, t);                                     \
+    }
+
+#define ICV_LOAD2_32FC(p) _mm256_cvtps_pd(_mm_loadu_ps((const float*)(p)))
+#define ICV_LOAD1_32FC(p) \
+    _mm256_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(p))))
+#define ICV_LOADW_32FC(p0, p1)    \
+    _mm256_cvtps_pd(_mm_loadh_pi( \
+        _mm_castpd_ps(_mm_load_sd((const double*)(p0))), (const __m64*)(p1)))
+#define ICV_STORE2_32FC(p, v) _mm_storeu_ps((float*)(p), _mm256_cvtpd_ps(v))
+#define ICV_STORE1_32FC(p, v) \
+    _mm_storel_pi((__m64*)(p), _mm256_cvtpd_ps(v))
+
+#define ICV_LOAD2_64FC(p) _mm256_loadu_pd((const double*)(p))
+#define ICV_LOAD1_64FC(p)                     \
+    _mm256_insertf128_pd(_mm256_setzero_pd(), \
+                         _mm_loadu_pd((const double*)(p)), 0)
+#define ICV_LOADW_64FC(p0, p1)                                     \
+    _mm256_insertf128_pd(                                          \
+        _mm256_castpd128_pd256(_mm_loadu_pd((const double*)(p0))), \
+        _mm_loadu_pd((const double*)(p1)), 1)
+#define ICV_STORE2_64FC(p, v) _mm256_storeu_pd((double*)(p), v)
+#define ICV_STORE1_64FC(p, v) \
+    _mm_storeu_pd((double*)(p), _mm256_castpd256_pd128(v))
+
+/* the j-th and (j+1)-th (or only the j-th, when <_N> is 1) columns of the
+   radix-4 butterflies of the group <v0> */
+#define ICV_DFT_RADIX4_STEP(FLAVOR, _N)                                        \
+    {                                                                          \
+        int dw = j * dw0;                                                      \
+        __m256d a0 = ICV_LOAD##_N##_##FLAVOR(v0 + j);                          \
+        __m256d a1 = ICV_LOAD##_N##_##FLAVOR(v0 + nx + j);                     \
+        __m256d a2 = ICV_LOAD##_N##_##FLAVOR(v1 + j);                          \
+        __m256d a3 = ICV_LOAD##_N##_##FLAVOR(v1 + nx + j);                     \
+        a1 = icvCMul_avx2(a1, ICV_LOADW_##FLAVOR(wave + dw * 2,                \
+                                                 wave + (dw + dw0) * 2));      \
+        a2 = icvCMul_avx2(a2, ICV_LOADW_##FLAVOR(wave + dw, wave + dw + dw0)); \
+        a3 = icvCMul_avx2(a3, ICV_LOADW_##FLAVOR(wave + dw * 3,                \
+                                                 wave + (dw + dw0) * 3));      \
+        ICV_DFT_BUTTERFLY4(a0, a1, a2, a3);                                    \
+        ICV_STORE##_N##_##FLAVOR(v0 + j, a0);                                  \
+        ICV_STORE##_N##_##FLAVOR(v0 + nx + j, a1);                             \
+        ICV_STORE##_N##_##FLAVOR(v1 + j, a2);                                  \
+        ICV_STORE##_N##_##FLAVOR(v1 + nx + j, a3);                             \
+    }
+
+#define ICV_DFT_RADIX2_STEP(FLAVOR, _N)                                        \
+    {                                                                          \
+        int dw = j * dw0;                                                      \
+        __m256d a0 = ICV_LOAD##_N##_##FLAVOR(v + j);                           \
+        __m256d a1 = ICV_LOAD##_N##_##FLAVOR(v + nx + j);                      \
+        a1 = icvCMul_avx2(a1, ICV_LOADW_##FLAVOR(wave + dw, wave + dw + dw0)); \
+        ICV_STORE##_N##_##FLAVOR(v + j, _mm256_add_pd(a0, a1));                \
+        ICV_STORE##_N##_##FLAVOR(v + nx + j, _mm256_sub_pd(a0, a1));           \
+    }
+
+#define ICV_DEF_DFT_RADIX(flavor, FLAVOR, datatype)                         \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL icvDFTRadix4_##flavor##_avx2( \
+        void* _dst, int n0, int nx, const void* _wave, int dw0)             \
+    {                                                                       \
+        datatype* dst = (datatype*)_dst;                                    \
+        const datatype* wave = (const datatype*)_wave;                      \
+        int i, j, n = nx * 4;                                               \
+                                                                            \
+        for (i = 0; i < n0; i += n)                                         \
+        {                                                                   \
+            datatype* v0 = dst + i;                                         \
+            datatype* v1 = v0 + nx * 2;                                     \
+            __m256d a0 = ICV_LOAD1_##FLAVOR(v0);                            \
+            __m256d a1 = ICV_LOAD1_##FLAVOR(v0 + nx);                       \
+            __m256d a2 = ICV_LOAD1_##FLAVOR(v1);                            \
+            __m256d a3 = ICV_LOAD1_##FLAVOR(v1 + nx);                       \
+            ICV_DFT_BUTTERFLY4(a0, a1, a2, a3);                             \
+            ICV_STORE1_##FLAVOR(v0, a0);                                    \
+            ICV_STORE1_##FLAVOR(v0 + nx, a1);                               \
+            ICV_STORE1_##FLAVOR(v1, a2);                                    \
+            ICV_STORE1_##FLAVOR(v1 + nx, a3);                               \
+                                                                            \
+            for (j = 1; j < nx - 1; j += 2)                                 \
+                ICV_DFT_RADIX4_STEP(FLAVOR, 2);                             \
+            if (j < nx)                                                     \
+                ICV_DFT_RADIX4_STEP(FLAVOR, 1);                             \
+        }                                                                   \
+                                                                            \
+        return CV_OK;                                                       \
+    }                                                                       \
+                                                                            \
+    CV_TARGET_AVX2 static CvStatus CV_STDCALL icvDFTRadix2_##flavor##_avx2( \
+        void* _dst, int n0, int nx, const void* _wave, int dw0)             \
+    {                                                                       \
+        datatype* dst = (datatype*)_dst;                                    \
+        const datatype* wave = (const datatype*)_wave;                      \
+        int i, j, n = nx * 2;                                               \
+                                                                            \
+        for (i = 0; i < n0; i += n)                                         \
+        {                                                                   \
+            datatype* v = dst + i;                                          \
+            __m256d a0 = ICV_LOAD1_##FLAVOR(v);                             \
+            __m256d a1 = ICV_LOAD1_##FLAVOR(v + nx);                        \
+            ICV_STORE1_##FLAVOR(v, _mm256_add_pd(a0, a1));                  \
+            ICV_STORE1_##FLAVOR(v + nx, _mm256_sub_pd(a0, a1));             \
+                                                                            \
+            for (j = 1; j < nx - 1; j += 2)                                 \
+                ICV_DFT_RADIX2_STEP(FLAVOR, 2);                             \
+            if (j < nx)                                                     \
+                ICV_DFT_RADIX2_STEP(FLAVOR, 1);                             \
+        }                                                                   \
+                                                                            \
+        return CV_OK;                                                       \
+    }
+
+ICV_DEF_DFT_RADIX(32fc, 32FC, CvComplex32f)
+ICV_DEF_DFT_RADIX(64fc, 64FC, CvComplex64f)
+
+#undef ICV_DEF_DFT_RADIX
+#undef ICV_DFT_RADIX4_STEP
+#undef ICV_DFT_RADIX2_STEP
+#undef ICV_DFT_BUTTERFLY4
+#undef ICV_LOAD2_32FC
+#undef ICV_LOAD1_32FC
+#undef ICV_LOADW_32FC
+#undef ICV_STORE2_32FC
+#undef ICV_STORE1_32FC
+#undef ICV_LOAD2_64FC
+#undef ICV_LOAD1_64FC
+#undef ICV_LOADW_64FC
+#undef ICV_STORE2_64FC
+#undef ICV_STORE1_64FC
+
+/****************************************************************************************\
+*                                         cvLUT *
+\****************************************************************************************/
+
+/* the table channel of every lane: the vector starting at the element 8*k
+   of a row uses the offsets ofs[(k % cn)*8 .. (k % cn)*8 + 7] */
+static void icvInitLUTChannelOffsets(int* ofs, int cn)
+{
+    int k;
+    for (k = 0; k < cn * 8; k++)
+        ofs[k] = k % cn;
+}
+
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvLUT_Transform16u_32s_CnR_avx2(
+    const ushort* src, int srcstep, int* dst, int dststep, CvSize size,
+    const int* lut, int cn)
+{
+    int ofs[32];
+    __m256i vcn = _mm256_set1_epi32(cn);
+
+    icvInitLUTChannelOffsets(ofs, cn);
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    size.width *= cn;
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0, k = 0;
+        for (; i <= size.width - 8; i += 8)
+        {
+            __m256i idx = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128((const __m128i*)(src + i)));
+            idx = _mm256_add_epi32(
+                _mm256_mullo_epi32(idx, vcn),
+                _mm256_loadu_si256((const __m256i*)(ofs + k * 8)));
+            _mm256_storeu_si256((__m256i*)(dst + i),
+                                _mm256_i32gather_epi32(lut, idx, 4));
+            if (++k >= cn)
+                k = 0;
+        }
+
+        for (; i < size.width; i++)
+            dst[i] = lut[src[i] * cn + i % cn];
+    }
+
+    return CV_OK;
+}
+
+/* repeats icvLUTInterp_32f_CnR (cxlut.cpp) operation by operation, so the
+   results are the same; max/min take the second operand for NaNs just like
+   the conditional expressions of the C version do */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvLUTInterp_32f_CnR_avx2(
+    const float* src, int srcstep, float* dst, int dststep, CvSize size,
+    const float* lut, int lut_size, int cn, float min_val, float max_val,
+    float scale, int log_spaced)
+{
+    int ofs[32];
+    float tmax = (float)(lut_size - 1);
+    int imax = lut_size - 2;
+    Cv32suf base;
+    __m256 vmin = _mm256_set1_ps(min_val), vmax = _mm256_set1_ps(max_val);
+    __m256 vscale = _mm256_set1_ps(scale), vtmax = _mm256_set1_ps(tmax);
+    __m256i vimax = _mm256_set1_epi32(imax), vcn = _mm256_set1_epi32(cn);
+    __m256i vbase;
+
+    // the power of two below min_val, see icvShaperLUTPerOctave (cxlut.cpp)
+    base.f = min_val;
+    base.i &= ~((1 << 23) - 1);
+    vbase = _mm256_set1_epi32(base.i);
+    icvInitLUTChannelOffsets(ofs, cn);
+    srcstep /= sizeof(src[0]);
+    dststep /= sizeof(dst[0]);
+    size.width *= cn;
+
+    for (; size.height--; src += srcstep, dst += dststep)
+    {
+        int i = 0, k = 0;
+        for (; i <= size.width - 8; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(src + i), t, f, l0, l1;
+            __m256i idx;
+
+            x = _mm256_min_ps(_mm256_max_ps(x, vmin), vmax);
+            if (log_spaced)
+                t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(
+                                      _mm256_castps_si256(x), vbase)),
+                                  vscale);
+            else
+                t = _mm256_mul_ps(_mm256_sub_ps(x, vmin), vscale);
+            t = _mm256_min_ps(t, vtmax);
+            idx = _mm256_min_epi32(_mm256_cvttps_epi32(t), vimax);
+            f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(idx));
+            idx = _mm256_add_epi32(
+                _mm256_mullo_epi32(idx, vcn),
+                _mm256_loadu_si256((const __m256i*)(ofs + k * 8)));
+            l0 = _mm256_i32gather_ps(lut, idx, 4);
+            l1 = _mm256_i32gather_ps(lut + cn, idx, 4);
+            _mm256_storeu_ps(
+                dst + i,
+                _mm256_add_ps(l0, _mm256_mul_ps(f, _mm256_sub_ps(l1, l0))));
+            if (++k >= cn)
+                k = 0;
+        }
+
+        for (; i < size.width; i++)
+        {
+            Cv32suf v;
+            float t, f;
+            const float* l;
+            int idx;
+
+            v.f = src[i];
+            v.f = v.f > min_val ? v.f : min_val;
+            v.f = v.f < max_val ? v.f : max_val;
+            t = log_spaced ? (float)(v.i - base.i) * scale
+                           : (v.f - min_val) * scale;
+            t = t < tmax ? t : tmax;
+            idx = (int)t;
+            idx = idx < imax ? idx : imax;
+            f = t - (float)idx;
+            l = lut + idx * cn + i % cn;
+            dst[i] = l[0] + f * (l[cn] - l[0]);
+        }
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                      cvImageStats *
+\****************************************************************************************/
+
+/* a block of 8*nv elements starts at channel 0; the vector v of the block
+   starts at channel 8*v % cn, so 1, 2 and 4 channels need one set of the
+   accumulators and 3 channels need three. The lanes are folded into the
+   channels when the row is done */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvImageStatsRow_32f_avx2(
+    const float* src, int len, int cn, float* min_val, float* max_val,
+    double* sum, double* sqsum)
+{
+    int nv = cn == 3 ? 3 : 1, i = 0, j, v;
+    __m256 vmin[3], vmax[3];
+    __m256d s0[3], s1[3], q0[3], q1[3];
+    float fbuf[8];
+    double dbuf[4];
+
+    for (v = 0; v < nv; v++)
+    {
+        for (j = 0; j < 8; j++)
+            fbuf[j] = min_val[(v * 8 + j) % cn];
+        vmin[v] = _mm256_loadu_ps(fbuf);
+        for (j = 0; j < 8; j++)
+            fbuf[j] = max_val[(v * 8 + j) % cn];
+        vmax[v] = _mm256_loadu_ps(fbuf);
+        s0[v] = s1[v] = q0[v] = q1[v] = _mm256_setzero_pd();
+    }
+
+    for (; i <= len - nv * 8; i += nv * 8)
+        for (v = 0; v < nv; v++)
+        {
+            __m256 x = _mm256_loadu_ps(src + i + v * 8);
+            __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+            __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+
+            // NaNs keep the accumulated extrema, as in the C version
+            vmin[v] = _mm256_min_ps(x, vmin[v]);
+            vmax[v] = _mm256_max_ps(x, vmax[v]);
+            s0[v] = _mm256_add_pd(s0[v], lo);
+            s1[v] = _mm256_add_pd(s1[v], hi);
+            q0[v] = _mm256_add_pd(q0[v], _mm256_mul_pd(lo, lo));
+            q1[v] = _mm256_add_pd(q1[v], _mm256_mul_pd(hi, hi));
+        }
+
+    for (v = 0; v < nv; v++)
+    {
+        _mm256_storeu_ps(fbuf, vmin[v]);
+        for (j = 0; j < 8; j++)
+            min_val[(v * 8 + j) % cn] =
+                MIN(min_val[(v * 8 + j) % cn], fbuf[j]);
+        _mm256_storeu_ps(fbuf, vmax[v]);
+        for (j = 0; j < 8; j++)
+            max_val[(v * 8 + j) % cn] =
+                MAX(max_val[(v * 8 + j) % cn], fbuf[j]);
+
+        _mm256_storeu_pd(dbuf, s0[v]);
+        for (j = 0; j < 4; j++)
+            sum[(v * 8 + j) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, s1[v]);
+        for (j = 0; j < 4; j++)
+            sum[(v * 8 + j + 4) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, q0[v]);
+        for (j = 0; j < 4; j++)
+            sqsum[(v * 8 + j) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, q1[v]);
+        for (j = 0; j < 4; j++)
+            sqsum[(v * 8 + j + 4) % cn] += dbuf[j];
+    }
+
+    for (; i < len; i++)
+    {
+        float x = src[i];
+        double t = x;
+        int k = i % cn;
+        if (x < min_val[k])
+            min_val[k] = x;
+        if (x > max_val[k])
+            max_val[k] = x;
+        sum[k] += t;
+        sqsum[k] += t * t;
+    }
+
+    return CV_OK;
+}
+
+/* repeats icvHistBins_32f (cxstats.cpp) operation by operation */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvHistBins_32f_avx2(
+    const float* src, int len, int cn, int* idx, int bins, float hist_min,
+    float hist_max, float scale)
+{
+    int i = 0, k = 0, j, ofs[32];
+    __m256 vmin = _mm256_set1_ps(hist_min), vmax = _mm256_set1_ps(hist_max);
+    __m256 vscale = _mm256_set1_ps(scale);
+    __m256i vlast = _mm256_set1_epi32(bins - 1);
+    __m256i vout = _mm256_set1_epi32(cn * bins);
+
+    // the bins offsets of the lanes, see icvInitLUTChannelOffsets
+    icvInitLUTChannelOffsets(ofs, cn);
+    for (j = 0; j < cn * 8; j++)
+        ofs[j] *= bins;
+
+    for (; i <= len - 8; i += 8)
+    {
+        __m256 v = _mm256_loadu_ps(src + i);
+        __m256 inside = _mm256_and_ps(_mm256_cmp_ps(v, vmin, _CMP_GE_OQ),
+                                      _mm256_cmp_ps(v, vmax, _CMP_LT_OQ));
+        __m256i t = _mm256_cvttps_epi32(
+            _mm256_mul_ps(_mm256_sub_ps(v, vmin), vscale));
+        t = _mm256_add_epi32(
+            _mm256_min_epi32(t, vlast),
+            _mm256_loadu_si256((const __m256i*)(ofs + k * 8)));
+        t = _mm256_blendv_epi8(vout, t, _mm256_castps_si256(inside));
+        _mm256_storeu_si256((__m256i*)(idx + i), t);
+        if (++k >= cn)
+            k = 0;
+    }
+
+    for (; i < len; i++)
+    {
+        float v = src[i];
+        int t = cn * bins;
+
+        if (v >= hist_min && v < hist_max)
+        {
+            t = (int)((v - hist_min) * scale);
+            t = (i % cn) * bins + MIN(t, bins - 1);
+        }
+        idx[i] = t;
+    }
+
+    return CV_OK;
+}
+
+/****************************************************************************************\
+*                                  cvImageDiff, cvSSIM *
+\****************************************************************************************/
+
+/* the lanes are mapped to the channels as in icvImageStatsRow_32f_avx2. The
+   maximum is found by lanes, and then the row is scanned for its first
+   occurrence, so the position is the same as in the C version */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvDiffRow_32f_avx2(
+    const float* src1, const float* src2, int len, int cn, float* max_diff,
+    int* max_pos, double* sqsum, uchar* mask, float threshold)
+{
+    int nv = cn == 3 ? 3 : 1, npix = nv * 8 / cn, cmask = (1 << cn) - 1;
+    int i = 0, j, k, v;
+    __m256 vabs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vthresh = _mm256_set1_ps(threshold);
+    __m256 vmax[3];
+    __m256d q0[3], q1[3];
+    float fbuf[8], rowmax[4];
+    double dbuf[4];
+
+    for (v = 0; v < nv; v++)
+    {
+        vmax[v] = _mm256_set1_ps(-1.f);
+        q0[v] = q1[v] = _mm256_setzero_pd();
+    }
+
+    for (; i <= len - nv * 8; i += nv * 8)
+    {
+        int bits = 0;
+
+        for (v = 0; v < nv; v++)
+        {
+            __m256 d = _mm256_and_ps(
+                _mm256_sub_ps(_mm256_loadu_ps(src1 + i + v * 8),
+                              _mm256_loadu_ps(src2 + i + v * 8)),
+                vabs);
+            __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(d));
+            __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(d, 1));
+
+            // NaNs keep the maximum, as in the C version
+            vmax[v] = _mm256_max_ps(d, vmax[v]);
+            q0[v] = _mm256_add_pd(q0[v], _mm256_mul_pd(lo, lo));
+            q1[v] = _mm256_add_pd(q1[v], _mm256_mul_pd(hi, hi));
+            bits |= _mm256_movemask_ps(_mm256_cmp_ps(d, vthresh, _CMP_GT_OQ))
+                    << (v * 8);
+        }
+
+        if (mask)
+            for (j = 0; j < npix; j++)
+                mask[i / cn + j] = (uchar)((bits >> j * cn) & cmask ? 255 : 0);
+    }
+
+    for (k = 0; k < cn; k++)
+        rowmax[k] = -1.f;
+
+    for (v = 0; v < nv; v++)
+    {
+        _mm256_storeu_ps(fbuf, vmax[v]);
+        for (j = 0; j < 8; j++)
+            rowmax[(v * 8 + j) % cn] = MAX(rowmax[(v * 8 + j) % cn], fbuf[j]);
+
+        _mm256_storeu_pd(dbuf, q0[v]);
+        for (j = 0; j < 4; j++)
+            sqsum[(v * 8 + j) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, q1[v]);
+        for (j = 0; j < 4; j++)
+            sqsum[(v * 8 + j + 4) % cn] += dbuf[j];
+    }
+
+    for (k = 0; k < cn; k++)
+        if (rowmax[k] > max_diff[k])
+        {
+            for (j = k; (float)fabs(src1[j] - src2[j]) != rowmax[k]; j += cn)
+                ;
+            max_diff[k] = rowmax[k];
+            max_pos[k] = j / cn;
+        }
+
+    for (; i < len; i += cn)
+    {
+        int differs = 0;
+
+        for (k = 0; k < cn; k++)
+        {
+            float d = (float)fabs(src1[i + k] - src2[i + k]);
+            double t = d;
+            if (d > max_diff[k])
+            {
+                max_diff[k] = d;
+                max_pos[k] = i / cn;
+            }
+            sqsum[k] += t * t;
+            differs |= d > threshold;
+        }
+
+        if (mask)
+            mask[i / cn] = (uchar)(differs ? 255 : 0);
+    }
+
+    return CV_OK;
+}
+
+/* repeats icvSSIMRowH_32f (cxquality.cpp) operation by operation */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvSSIMRowH_32f_avx2(
+    const float* src1, const float* src2, int len, int cn,
+    const float* kernel, int ksize, float* dst)
+{
+    int i = 0, j;
+
+    for (; i <= len - 8; i += 8)
+    {
+        __m256 s1 = _mm256_setzero_ps(), s2 = s1, s11 = s1, s22 = s1;
+        __m256 s12 = s1;
+
+        for (j = 0; j < ksize; j++)
+        {
+            __m256 a = _mm256_loadu_ps(src1 + i + j * cn);
+            __m256 b = _mm256_loadu_ps(src2 + i + j * cn);
+            __m256 w = _mm256_broadcast_ss(kernel + j);
+            s1 = _mm256_add_ps(s1, _mm256_mul_ps(w, a));
+            s2 = _mm256_add_ps(s2, _mm256_mul_ps(w, b));
+            s11 = _mm256_add_ps(s11, _mm256_mul_ps(w, _mm256_mul_ps(a, a)));
+            s22 = _mm256_add_ps(s22, _mm256_mul_ps(w, _mm256_mul_ps(b, b)));
+            s12 = _mm256_add_ps(s12, _mm256_mul_ps(w, _mm256_mul_ps(a, b)));
+        }
+
+        _mm256_storeu_ps(dst + i, s1);
+        _mm256_storeu_ps(dst + i + len, s2);
+        _mm256_storeu_ps(dst + i + len * 2, s11);
+        _mm256_storeu_ps(dst + i + len * 3, s22);
+        _mm256_storeu_ps(dst + i + len * 4, s12);
+    }
+
+    for (; i < len; i++)
+    {
+        float s1 = 0, s2 = 0, s11 = 0, s22 = 0, s12 = 0;
+
+        for (j = 0; j < ksize; j++)
+        {
+            float a = src1[i + j * cn], b = src2[i + j * cn], w = kernel[j];
+            s1 += w * a;
+            s2 += w * b;
+            s11 += w * (a * a);
+            s22 += w * (b * b);
+            s12 += w * (a * b);
+        }
+
+        dst[i] = s1;
+        dst[i + len] = s2;
+        dst[i + len * 2] = s11;
+        dst[i + len * 3] = s22;
+        dst[i + len * 4] = s12;
+    }
+
+    return CV_OK;
+}
+
+/* repeats icvSSIMRowV_32f (cxquality.cpp) operation by operation; the sums
+   are accumulated by lanes as in icvImageStatsRow_32f_avx2 */
+CV_TARGET_AVX2 static CvStatus CV_STDCALL icvSSIMRowV_32f_avx2(
+    const float** rows, int len, int cn, const float* kernel, int ksize,
+    float c1, float c2, double* ssim_sum, double* cs_sum)
+{
+    int nv = cn == 3 ? 3 : 1, i = 0, j, v;
+    __m256 vc1 = _mm256_set1_ps(c1), vc2 = _mm256_set1_ps(c2);
+    __m256d ss0[3], ss1[3], cs0[3], cs1[3];
+    double dbuf[4];
+
+    for (v = 0; v < nv; v++)
+        ss0[v] = ss1[v] = cs0[v] = cs1[v] = _mm256_setzero_pd();
+
+    for (; i <= len - nv * 8; i += nv * 8)
+        for (v = 0; v < nv; v++)
+        {
+            __m256 mu1 = _mm256_setzero_ps(), mu2 = mu1, s11 = mu1, s22 = mu1;
+            __m256 s12 = mu1, mu11, mu22, mu12, l, cs;
+            int x = i + v * 8;
+
+            for (j = 0; j < ksize; j++)
+            {
+                const float* r = rows[j] + x;
+                __m256 w = _mm256_broadcast_ss(kernel + j);
+                mu1 = _mm256_add_ps(mu1, _mm256_mul_ps(w, _mm256_loadu_ps(r)));
+                mu2 = _mm256_add_ps(
+                    mu2, _mm256_mul_ps(w, _mm256_loadu_ps(r + len)));
+                s11 = _mm256_add_ps(
+                    s11, _mm256_mul_ps(w, _mm256_loadu_ps(r + len * 2)));
+                s22 = _mm256_add_ps(
+                    s22, _mm256_mul_ps(w, _mm256_loadu_ps(r + len * 3)));
+                s12 = _mm256_add_ps(
+                    s12, _mm256_mul_ps(w, _mm256_loadu_ps(r + len * 4)));
+            }
+
+            mu11 = _mm256_mul_ps(mu1, mu1);
+            mu22 = _mm256_mul_ps(mu2, mu2);
+            mu12 = _mm256_mul_ps(mu1, mu2);
+            l = _mm256_div_ps(
+                _mm256_add_ps(_mm256_add_ps(mu12, mu12), vc1),
+                _mm256_add_ps(_mm256_add_ps(mu11, mu22), vc1));
+            s12 = _mm256_sub_ps(s12, mu12);
+            cs = _mm256_div_ps(
+                _mm256_add_ps(_mm256_add_ps(s12, s12), vc2),
+                _mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(s11, mu11),
+                                            _mm256_sub_ps(s22, mu22)),
+                              vc2));
+            l = _mm256_mul_ps(l, cs);
+
+            ss0[v] = _mm256_add_pd(
+                ss0[v], _mm256_cvtps_pd(_mm256_castps256_ps128(l)));
+            ss1[v] = _mm256_add_pd(
+                ss1[v], _mm256_cvtps_pd(_mm256_extractf128_ps(l, 1)));
+            cs0[v] = _mm256_add_pd(
+                cs0[v], _mm256_cvtps_pd(_mm256_castps256_ps128(cs)));
+            cs1[v] = _mm256_add_pd(
+                cs1[v], _mm256_cvtps_pd(_mm256_extractf128_ps(cs, 1)));
+        }
+
+    for (v = 0; v < nv; v++)
+    {
+        _mm256_storeu_pd(dbuf, ss0[v]);
+        for (j = 0; j < 4; j++)
+            ssim_sum[(v * 8 + j) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, ss1[v]);
+        for (j = 0; j < 4; j++)
+            ssim_sum[(v * 8 + j + 4) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, cs0[v]);
+        for (j = 0; j < 4; j++)
+            cs_sum[(v * 8 + j) % cn] += dbuf[j];
+        _mm256_storeu_pd(dbuf, cs1[v]);
+        for (j = 0; j < 4; j++)
+            cs_sum[(v * 8 + j + 4) % cn] += dbuf[j];
+    }
+
+    for (; i < len; i++)
+    {
+        float mu1 = 0, mu2 = 0, s11 = 0, s22 = 0, s12 = 0;
+        float mu11, mu22, mu12, l, cs;
+        int k = i % cn;
+
+        for (j = 0; j < ksize; j++)
+        {
+            const float* r = rows[j] + i;
+            float w = kernel[j];
+            mu1 += w * r[0];
+            mu2 += w * r[len];
+            s11 += w * r[len * 2];
+            s22 += w * r[len * 3];
+            s12 += w * r[len * 4];
+        }
+
+        mu11 = mu1 * mu1;
+        mu22 = mu2 * mu2;
+        mu12 = mu1 * mu2;
+        l = (mu12 * 2 + c1) / (mu11 + mu22 + c1);
+        cs = ((s12 - mu12) * 2 + c2) / ((s11 - mu11) + (s22 - mu22) + c2);
+        ssim_sum[k] += l * cs;
+        cs_sum[k] += cs;
+    }
+
+    return CV_OK;
+}
+
+#endif /* CV_BUILTIN_SIMD */
+
+/****************************************************************************************\
+*                              The table of built-in functions *
+\****************************************************************************************/
+
+#define ICV_BUILTIN(name, isa, features) \
+    {(void**)&name##_p, (void*)name##_##isa, features},
+
+/* the best variant of every function goes first */
+CvBuiltinFuncInfo cxcore_builtin_tab[] = {
+#if CV_BUILTIN_SIMD
+    ICV_BUILTIN(icvCvtScale_32f8u_C1R, avx512, CV_CPU_AVX512)
+    ICV_BUILTIN(icvCvtScale_32f8u_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvCvtScale_32f8u_C1R, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvCvtScale_32f_C1R, avx512, CV_CPU_AVX512)
+    ICV_BUILTIN(icvCvtScale_32f_C1R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvCvtScale_32f_C1R, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvCvt_16f32f, f16c, CV_CPU_F16C)
+    ICV_BUILTIN(icvCvt_32f16f, f16c, CV_CPU_F16C)
+    ICV_BUILTIN(icvBLAS_GEMM_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvBLAS_GEMM_32f, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvBLAS_GEMM_64f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvBLAS_GEMM_64f, sse2, CV_CPU_SSE2)
+    ICV_BUILTIN(icvColorTwist_8u_C3R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_16u_C3R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_16s_C3R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_32f_C3R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_8u_C4R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_16u_C4R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvColorTwist_32f_C4R, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDFTRadix4_32fc, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDFTRadix2_32fc, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDFTRadix4_64fc, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDFTRadix2_64fc, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvLUT_Transform16u_32s_CnR, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvLUTInterp_32f_CnR, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvImageStatsRow_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvHistBins_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvDiffRow_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvSSIMRowH_32f, avx2, CV_CPU_AVX2)
+    ICV_BUILTIN(icvSSIMRowV_32f, avx2, CV_CPU_AVX2)
+#endif
+    {0, 0, 0}};
+
+#undef ICV_BUILTIN
+
+/* End of file. */
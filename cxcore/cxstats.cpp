@@ -0,0 +1,506 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this
+license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without
+modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright
+notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote
+products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is"
+and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are
+disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any
+direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "_cxcore.h"
+
+/****************************************************************************************\
+*                                    Image Statistics *
+\****************************************************************************************/
+
+/* cvImageStats splits the sampled rows into chunks that cvParallelFor
+   processes independently. The 8u and 16u chunks only count the pixels of
+   every value; the extrema, the sums and the histograms are derived from
+   the merged counters afterwards, so they are exact. The 32f chunks
+   accumulate the extrema and the sums of every row (icvImageStatsRow_32f)
+   and then bin the row while it is still in cache. The number of 8u and
+   32f chunks depends only on the array size, so the 32f sums do not change
+   with the number of threads */
+
+#define ICV_STATS_MAX_CHUNKS 32
+#define ICV_STATS_HIST_BLOCK 1020 /* divisible by 1, 2, 3 and 4 channels */
+
+typedef struct CvImageStatsBand
+{
+    const uchar* data;
+    int step;     /* the step between the sampled rows, in bytes */
+    int pix_step; /* the step between the sampled pixels, in elements */
+    int rows, cols;
+    int cn, depth;
+    int nchunks;
+    int levels; /* the counters per channel: 256 (8u), 65536 (16u) or the
+                   histogram bins (32f) */
+    int chunk_size; /* cn*levels counters of a chunk and one more for the
+                       32f values out of the histogram range */
+    int* counts;
+    CvImageStats* partial; /* the extrema and the sums of the 32f chunks */
+    float hist_min, hist_max, hist_scale;
+} CvImageStatsBand;
+
+IPCVAPI_IMPL(CvStatus, icvImageStatsRow_32f,
+             (const float* src, int len, int cn, float* min_val,
+              float* max_val, double* sum, double* sqsum),
+             (src, len, cn, min_val, max_val, sum, sqsum))
+{
+    int i, k;
+
+    for (k = 0; k < cn; k++)
+    {
+        float mn = min_val[k], mx = max_val[k];
+        double s = 0, sq = 0;
+
+        for (i = k; i < len; i += cn)
+        {
+            float v = src[i];
+            double t = v;
+            if (v < mn)
+                mn = v;
+            if (v > mx)
+                mx = v;
+            s += t;
+            sq += t * t;
+        }
+
+        min_val[k] = mn;
+        max_val[k] = mx;
+        sum[k] += s;
+        sqsum[k] += sq;
+    }
+
+    return CV_OK;
+}
+
+/* finds the histogram bins of a row of cn-channel data, bins per channel:
+   idx[i] = (i % cn)*bins + bin or, for the values out of the range, cn*bins
+   (the counter after the last bin of the last channel) */
+IPCVAPI_IMPL(CvStatus, icvHistBins_32f,
+             (const float* src, int len, int cn, int* idx, int bins,
+              float hist_min, float hist_max, float scale),
+             (src, len, cn, idx, bins, hist_min, hist_max, scale))
+{
+    int i, k = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        float v = src[i];
+        int t = cn * bins;
+
+        if (v >= hist_min && v < hist_max)
+        {
+            t = (int)((v - hist_min) * scale);
+            t = k * bins + MIN(t, bins - 1);
+        }
+        idx[i] = t;
+
+        if (++k >= cn)
+            k = 0;
+    }
+
+    return CV_OK;
+}
+
+static void icvImageStatsChunk_32f(const CvImageStatsBand* p, int chunk,
+                                   int y0, int y1)
+{
+    int cn = p->cn, width = p->cols, pix_step = p->pix_step;
+    int bins = p->levels, x, y, k;
+    int* counts = p->counts ? p->counts + chunk * p->chunk_size : 0;
+    float mn[4], mx[4];
+    double s[4], sq[4];
+    CvImageStats* stats = p->partial + chunk;
+
+    for (k = 0; k < cn; k++)
+    {
+        mn[k] = FLT_MAX;
+        mx[k] = -FLT_MAX;
+        s[k] = sq[k] = 0;
+    }
+
+    for (y = y0; y < y1; y++)
+    {
+        const float* src = (const float*)(p->data + y * p->step);
+
+        if (pix_step == cn)
+            icvImageStatsRow_32f(src, width * cn, cn, mn, mx, s, sq);
+        else
+            for (x = 0; x < width; x++)
+                for (k = 0; k < cn; k++)
+                {
+                    float v = src[x * pix_step + k];
+                    double t = v;
+                    if (v < mn[k])
+                        mn[k] = v;
+                    if (v > mx[k])
+                        mx[k] = v;
+                    s[k] += t;
+                    sq[k] += t * t;
+                }
+
+        if (counts && pix_step == cn)
+        {
+            int idx[ICV_STATS_HIST_BLOCK];
+
+            for (x = 0; x < width * cn; x += ICV_STATS_HIST_BLOCK)
+            {
+                int i, len = MIN(width * cn - x, ICV_STATS_HIST_BLOCK);
+                icvHistBins_32f(src + x, len, cn, idx, bins, p->hist_min,
+                                p->hist_max, p->hist_scale);
+                for (i = 0; i < len; i++)
+                    counts[idx[i]]++;
+            }
+        }
+        else if (counts)
+        {
+            float lo = p->hist_min, hi = p->hist_max, scale = p->hist_scale;
+
+            for (x = 0; x < width; x++, src += pix_step)
+                for (k = 0; k < cn; k++)
+                {
+                    float v = src[k];
+                    if (v >= lo && v < hi)
+                    {
+                        int idx = (int)((v - lo) * scale);
+                        counts[k * bins + MIN(idx, bins - 1)]++;
+                    }
+                }
+        }
+    }
+
+    for (k = 0; k < cn; k++)
+    {
+        stats->min_val.val[k] = mn[k];
+        stats->max_val.val[k] = mx[k];
+        stats->sum.val[k] = s[k];
+        stats->sqsum.val[k] = sq[k];
+    }
+}
+
+#define ICV_DEF_STATS_COUNT_FUNC(flavor, srctype)                           \
+    static void icvImageStatsChunk_##flavor(const CvImageStatsBand* p,      \
+                                            int chunk, int y0, int y1)      \
+    {                                                                       \
+        int cn = p->cn, width = p->cols, pix_step = p->pix_step;            \
+        int levels = p->levels, x, y;                                       \
+        int* c0 = p->counts + chunk * p->chunk_size;                        \
+        int* c1 = c0 + levels * MIN(cn - 1, 1);                             \
+        int* c2 = c0 + levels * MIN(cn - 1, 2);                             \
+        int* c3 = c0 + levels * MIN(cn - 1, 3);                             \
+                                                                            \
+        for (y = y0; y < y1; y++)                                           \
+        {                                                                   \
+            const srctype* src = (const srctype*)(p->data + y * p->step);   \
+                                                                            \
+            if (cn == 1)                                                    \
+            {                                                               \
+                for (x = 0; x <= width - 4; x += 4, src += pix_step * 4)    \
+                {                                                           \
+                    int t0 = src[0], t1 = src[pix_step];                    \
+                    c0[t0]++;                                               \
+                    c0[t1]++;                                               \
+                    t0 = src[pix_step * 2];                                 \
+                    t1 = src[pix_step * 3];                                 \
+                    c0[t0]++;                                               \
+                    c0[t1]++;                                               \
+                }                                                           \
+                for (; x < width; x++, src += pix_step)                     \
+                    c0[src[0]]++;                                           \
+            }                                                               \
+            else if (cn == 2)                                               \
+                for (x = 0; x < width; x++, src += pix_step)                \
+                {                                                           \
+                    int t0 = src[0], t1 = src[1];                           \
+                    c0[t0]++;                                               \
+                    c1[t1]++;                                               \
+                }                                                           \
+            else if (cn == 3)                                               \
+                for (x = 0; x < width; x++, src += pix_step)                \
+                {                                                           \
+                    int t0 = src[0], t1 = src[1], t2 = src[2];              \
+                    c0[t0]++;                                               \
+                    c1[t1]++;                                               \
+                    c2[t2]++;                                               \
+                }                                                           \
+            else                                                            \
+                for (x = 0; x < width; x++, src += pix_step)                \
+                {                                                           \
+                    int t0 = src[0], t1 = src[1], t2 = src[2], t3 = src[3]; \
+                    c0[t0]++;                                               \
+                    c1[t1]++;                                               \
+                    c2[t2]++;                                               \
+                    c3[t3]++;                                               \
+                }                                                           \
+        }                                                                   \
+    }
+
+ICV_DEF_STATS_COUNT_FUNC(8u, uchar)
+ICV_DEF_STATS_COUNT_FUNC(16u, ushort)
+
+static int CV_CDECL icvImageStatsBand(int start, int end, void* arg)
+{
+    const CvImageStatsBand* p = (const CvImageStatsBand*)arg;
+    int chunk;
+
+    for (chunk = start; chunk < end; chunk++)
+    {
+        int y0 = (int)((int64)p->rows * chunk / p->nchunks);
+        int y1 = (int)((int64)p->rows * (chunk + 1) / p->nchunks);
+
+        if (p->depth == CV_8U)
+            icvImageStatsChunk_8u(p, chunk, y0, y1);
+        else if (p->depth == CV_16U)
+            icvImageStatsChunk_16u(p, chunk, y0, y1);
+        else
+            icvImageStatsChunk_32f(p, chunk, y0, y1);
+    }
+
+    return CV_StsOk;
+}
+
+CV_IMPL void cvImageStats(const CvArr* arr, CvImageStats* stats,
+                          CvArr* histarr, double hist_min, double hist_max,
+                          int sample_step)
+{
+    int *counts = 0, *bin_counts = 0;
+    CvImageStats* partial = 0;
+
+    CV_FUNCNAME("cvImageStats");
+
+    __BEGIN__;
+
+    CvMat stub, *mat = (CvMat*)arr;
+    CvMat histstub, *hist = (CvMat*)histarr;
+    CvImageStatsBand band;
+    int coi = 0, depth, cn, bins = 0, nchunks, total, i, k, v;
+    size_t counts_size = 0;
+
+    if (!CV_IS_MAT(mat))
+        CV_CALL(mat = cvGetMat(mat, &stub, &coi));
+
+    if (coi != 0)
+        CV_ERROR(CV_BadCOI, "");
+
+    if (!stats)
+        CV_ERROR(CV_StsNullPtr, "");
+
+    depth = CV_MAT_DEPTH(mat->type);
+    cn = CV_MAT_CN(mat->type);
+
+    if (depth != CV_8U && depth != CV_16U && depth != CV_32F)
+        CV_ERROR(CV_StsUnsupportedFormat,
+                 "Only 8u, 16u and 32f arrays are supported");
+
+    if (cn > 4)
+        CV_ERROR(CV_StsOutOfRange, "The array must have at most 4 channels");
+
+    if (sample_step < 1)
+        CV_ERROR(CV_StsOutOfRange, "The sampling step must be positive");
+
+    if (hist)
+    {
+        if (!CV_IS_MAT(hist))
+            CV_CALL(hist = cvGetMat(hist, &histstub));
+
+        if (CV_MAT_TYPE(hist->type) != CV_32SC1
+            && CV_MAT_TYPE(hist->type) != CV_32FC1)
+            CV_ERROR(CV_StsUnsupportedFormat,
+                     "The histogram must be 32sC1 or 32fC1 array");
+
+        if (hist->rows != cn)
+            CV_ERROR(CV_StsUnmatchedSizes,
+                     "The histogram must have a row of bins per channel");
+
+        bins = hist->cols;
+
+        if (hist_min == 0 && hist_max == 0)
+            hist_max = depth == CV_8U ? 256 : depth == CV_16U ? 65536 : 1;
+
+        if (!(hist_min < hist_max))
+            CV_ERROR(CV_StsOutOfRange, "The histogram range is empty");
+    }
+
+    memset(&band, 0, sizeof(band));
+    band.data = mat->data.ptr;
+    band.step = mat->step * sample_step;
+    band.pix_step = cn * sample_step;
+    band.rows = (mat->rows + sample_step - 1) / sample_step;
+    band.cols = (mat->cols + sample_step - 1) / sample_step;
+    band.cn = cn;
+    band.depth = depth;
+    band.levels = depth == CV_8U ? 256 : depth == CV_16U ? 65536 : bins;
+    band.chunk_size = cn * band.levels + 1;
+
+    // the 16u counters are large, so there are no more chunks than threads
+    total = band.rows * band.cols;
+    nchunks = MIN(total / CV_PARALLEL_MIN_PIXELS, ICV_STATS_MAX_CHUNKS);
+    if (depth == CV_16U)
+        nchunks = MIN(nchunks, cvGetNumThreads());
+    nchunks = MAX(MIN(nchunks, band.rows), 1);
+    band.nchunks = nchunks;
+
+    if (depth != CV_32F || hist)
+    {
+        counts_size = (size_t)nchunks * band.chunk_size * sizeof(counts[0]);
+        CV_CALL(counts = (int*)cvAlloc(counts_size));
+        memset(counts, 0, counts_size);
+        band.counts = counts;
+    }
+
+    if (depth == CV_32F)
+    {
+        CV_CALL(partial =
+                    (CvImageStats*)cvAlloc(nchunks * sizeof(partial[0])));
+        band.partial = partial;
+        if (hist)
+        {
+            band.hist_min = (float)hist_min;
+            band.hist_max = (float)hist_max;
+            band.hist_scale = (float)(bins / (hist_max - hist_min));
+        }
+    }
+
+    IPPI_CALL((CvStatus)cvParallelFor(cvSlice(0, nchunks), icvImageStatsBand,
+                                      &band, 1));
+
+    // merge the chunks
+    if (counts)
+        for (i = 1; i < nchunks; i++)
+        {
+            const int* c = counts + (size_t)i * band.chunk_size;
+            for (k = 0; k < cn * band.levels; k++)
+                counts[k] += c[k];
+        }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->count = total;
+
+    if (depth == CV_32F)
+    {
+        for (k = 0; k < cn; k++)
+        {
+            double mn = partial[0].min_val.val[k];
+            double mx = partial[0].max_val.val[k];
+            double s = 0, sq = 0;
+
+            for (i = 0; i < nchunks; i++)
+            {
+                mn = MIN(mn, partial[i].min_val.val[k]);
+                mx = MAX(mx, partial[i].max_val.val[k]);
+                s += partial[i].sum.val[k];
+                sq += partial[i].sqsum.val[k];
+            }
+
+            stats->min_val.val[k] = mn;
+            stats->max_val.val[k] = mx;
+            stats->sum.val[k] = s;
+            stats->sqsum.val[k] = sq;
+        }
+    }
+    else
+    {
+        double bin_scale = hist ? bins / (hist_max - hist_min) : 0;
+
+        if (hist)
+        {
+            CV_CALL(bin_counts = (int*)cvAlloc(cn * bins * sizeof(counts[0])));
+            memset(bin_counts, 0, cn * bins * sizeof(counts[0]));
+        }
+
+        for (k = 0; k < cn; k++)
+        {
+            int* c = counts + k * band.levels;
+            int mn = -1, mx = 0;
+            int64 s = 0, sq = 0;
+
+            for (v = 0; v < band.levels; v++)
+                if (c[v])
+                {
+                    if (mn < 0)
+                        mn = v;
+                    mx = v;
+                    s += (int64)c[v] * v;
+                    sq += (int64)c[v] * ((unsigned)v * v);
+                }
+
+            stats->min_val.val[k] = MAX(mn, 0);
+            stats->max_val.val[k] = mx;
+            stats->sum.val[k] = (double)s;
+            stats->sqsum.val[k] = (double)sq;
+
+            if (hist)
+            {
+                int* h = bin_counts + k * bins;
+                for (v = 0; v < band.levels; v++)
+                    if (c[v] && v >= hist_min && v < hist_max)
+                    {
+                        int idx = cvFloor((v - hist_min) * bin_scale);
+                        h[MIN(idx, bins - 1)] += c[v];
+                    }
+            }
+        }
+    }
+
+    if (hist)
+        for (k = 0; k < cn; k++)
+        {
+            const int* c = (bin_counts ? bin_counts : counts) + k * bins;
+            uchar* h = hist->data.ptr + k * hist->step;
+
+            if (CV_MAT_TYPE(hist->type) == CV_32SC1)
+                memcpy(h, c, bins * sizeof(c[0]));
+            else
+                for (i = 0; i < bins; i++)
+                    ((float*)h)[i] = (float)c[i];
+        }
+
+    __END__;
+
+    cvFree(&counts);
+    cvFree(&bin_counts);
+    cvFree(&partial);
+}
+
+/* End of file. */
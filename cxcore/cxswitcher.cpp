@@ -65,12 +65,22 @@ direct,
 #else
 #include <dlfcn.h>
 #include <sys/time.h>
+#include <unistd.h>
 #endif
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <ctype.h>
 
+#if CV_BUILTIN_SIMD
+#if defined _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 #define CV_PROC_GENERIC 0
 #define CV_PROC_SHIFT 10
 #define CV_PROC_ARCH_MASK ((1 << CV_PROC_SHIFT) - 1)
@@ -87,6 +97,7 @@ typedef struct CvProcessorInfo
     int model;
     int count;
     double frequency; // clocks per microsecond
+    int features;     // CV_CPU_* flags
 } CvProcessorInfo;
 
 #undef MASM_INLINE_ASSEMBLY
@@ -105,6 +116,71 @@ typedef struct CvProcessorInfo
 
 #endif
 
+/*
+   determine the instruction set extensions usable by the built-in functions
+*/
+static int icvInitCPUFeatures()
+{
+    int features = CV_CPU_NONE;
+
+#if CV_BUILTIN_SIMD
+    unsigned regs[4] = {0, 0, 0, 0}, max_leaf;
+    unsigned xcr0 = 0;
+
+#if defined _MSC_VER
+    __cpuid((int*)regs, 0);
+    max_leaf = regs[0];
+    __cpuid((int*)regs, 1);
+#else
+    __cpuid(0, regs[0], regs[1], regs[2], regs[3]);
+    max_leaf = regs[0];
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    if (regs[3] & (1 << 26))
+        features |= CV_CPU_SSE2;
+    if ((features & CV_CPU_SSE2) && (regs[2] & (1 << 19)))
+        features |= CV_CPU_SSE4_1;
+
+    // AVX state must be enabled by the OS (OSXSAVE + XCR0)
+    if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)))
+    {
+#if defined _MSC_VER
+        xcr0 = (unsigned)_xgetbv(0);
+#else
+        unsigned xcr0_hi;
+        __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" /* xgetbv */
+                             : "=a"(xcr0), "=d"(xcr0_hi)
+                             : "c"(0));
+#endif
+    }
+
+    // half <-> float conversions (VEX-encoded, so the AVX state is needed)
+    if ((regs[2] & (1 << 29)) && (xcr0 & 6) == 6)
+        features |= CV_CPU_F16C;
+
+    if ((features & CV_CPU_SSE4_1) && (xcr0 & 6) == 6 && max_leaf >= 7)
+    {
+#if defined _MSC_VER
+        __cpuidex((int*)regs, 7, 0);
+#else
+        __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        if (regs[1] & (1 << 5))
+            features |= CV_CPU_AVX2;
+        if ((features & CV_CPU_AVX2) && (regs[1] & (1 << 16))
+            && (xcr0 & 0xe6) == 0xe6)
+            features |= CV_CPU_AVX512;
+    }
+#endif
+
+    const char* mask = getenv("OPENCV_CPU_FEATURES");
+    if (mask && *mask)
+        features &= (int)strtol(mask, 0, 0);
+
+    return features;
+}
+
 /*
    determine processor type
 */
@@ -127,6 +203,7 @@ static void icvInitProcessorInfo(CvProcessorInfo* cpu_info)
     LARGE_INTEGER freq;
 
     GetSystemInfo(&sys);
+    cpu_info->count = (int)sys.dwNumberOfProcessors;
 
     if (sys.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_INTEL
         && sys.dwProcessorType == PROCESSOR_INTEL_PENTIUM
@@ -136,7 +213,6 @@ static void icvInitProcessorInfo(CvProcessorInfo* cpu_info)
         int id = 0;
         HKEY key = 0;
 
-        cpu_info->count = (int)sys.dwNumberOfProcessors;
         unsigned long val = 0, sz = sizeof(val);
 
         if (RegOpenKeyEx(HKEY_LOCAL_MACHINE,
@@ -220,6 +296,7 @@ static void icvInitProcessorInfo(CvProcessorInfo* cpu_info)
     }
 #else
     cpu_info->frequency = 1;
+    cpu_info->count = (int)sysconf(_SC_NPROCESSORS_ONLN);
 
 #ifdef __x86_64__
     cpu_info->model = CV_PROC_EM64T;
@@ -272,6 +349,9 @@ static void icvInitProcessorInfo(CvProcessorInfo* cpu_info)
     }
 #endif
 #endif
+
+    cpu_info->count = MAX(cpu_info->count, 1);
+    cpu_info->features = icvInitCPUFeatures();
 }
 
 CV_INLINE const CvProcessorInfo* icvGetProcessorInfo()
@@ -343,8 +423,12 @@ typedef struct CvPluginInfo
     char name[100];
 } CvPluginInfo;
 
+extern CvBuiltinFuncInfo cxcore_builtin_tab[];
+
 static CvPluginInfo plugins[CV_PLUGIN_MAX];
-static CvModuleInfo cxcore_info = {0, "cxcore", CV_VERSION, cxcore_ipp_tab};
+static int use_builtin = 1;
+static CvModuleInfo cxcore_info = {0, "cxcore", CV_VERSION, cxcore_ipp_tab,
+                                   cxcore_builtin_tab};
 
 CvModuleInfo *CvModule::first = 0, *CvModule::last = 0;
 
@@ -372,7 +456,8 @@ CvModule::~CvModule()
     }
 }
 
-static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
+static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab,
+                                  const CvBuiltinFuncInfo* builtin_tab)
 {
     int i, loaded_functions = 0;
 
@@ -485,6 +570,32 @@ static int icvUpdatePluginFuncTab(CvPluginFuncInfo* func_tab)
             plugins[i].handle = 0;
     }
 
+    // 3. assign the built-in functions to the pointers that no plugin has
+    // filled. The table lists the best variant of every function first.
+    if (use_builtin && builtin_tab)
+    {
+        int features = icvGetProcessorInfo()->features;
+
+        for (i = 0; builtin_tab[i].func_addr != 0; i++)
+        {
+            int j, required = builtin_tab[i].cpu_features;
+
+            if ((features & required) != required)
+                continue;
+
+            for (j = 0; func_tab[j].func_addr != 0; j++)
+                if (func_tab[j].func_addr == builtin_tab[i].func_addr)
+                    break;
+
+            if (func_tab[j].func_addr == 0 || func_tab[j].loaded_from != 0)
+                continue;
+
+            *func_tab[j].func_addr = builtin_tab[i].builtin_func_addr;
+            func_tab[j].loaded_from = CV_PLUGIN_BUILTIN;
+            loaded_functions++;
+        }
+    }
+
     return loaded_functions;
 }
 
@@ -526,7 +637,8 @@ CV_IMPL int cvRegisterModule(const CvModuleInfo* module)
     }
     else
     {
-        CV_CALL(icvUpdatePluginFuncTab(module_copy->func_tab));
+        CV_CALL(icvUpdatePluginFuncTab(module_copy->func_tab,
+                                       module_copy->builtin_tab));
     }
 
     __END__;
@@ -562,6 +674,8 @@ CV_IMPL int cvUseOptimized(int load_flag)
                               : arch == CV_PROC_EM64T ? mkl_sfx_em64t
                                                       : mkl_sfx_ia32;
 
+    use_builtin = load_flag != 0;
+
     for (i = 0; i < CV_PLUGIN_MAX; i++)
         plugins[i].basename = 0;
     plugins[CV_PLUGIN_NONE].basename = 0;
@@ -631,13 +745,19 @@ CV_IMPL int cvUseOptimized(int load_flag)
     }
 
     for (module = CvModule::first; module != 0; module = module->next)
-        loaded_functions += icvUpdatePluginFuncTab(module->func_tab);
+        loaded_functions +=
+            icvUpdatePluginFuncTab(module->func_tab, module->builtin_tab);
 
     return loaded_functions;
 }
 
 CvModule cxcore_module(&cxcore_info);
 
+CV_IMPL int cvGetCPUFeatures(void)
+{
+    return icvGetProcessorInfo()->features;
+}
+
 CV_IMPL void cvGetModuleInfo(const char* name, const char** version,
                              const char** plugin_list)
 {
@@ -709,6 +829,18 @@ CV_IMPL void cvGetModuleInfo(const char* name, const char** version,
                 ptr += strlen(ptr);
             }
 
+        if (use_builtin)
+        {
+            int features = icvGetProcessorInfo()->features;
+            sprintf(ptr, "builtin-%s, ",
+                    features & CV_CPU_AVX512   ? "avx512"
+                    : features & CV_CPU_AVX2   ? "avx2"
+                    : features & CV_CPU_SSE4_1 ? "sse4.1"
+                    : features & CV_CPU_SSE2   ? "sse2"
+                                               : "c");
+            ptr += strlen(ptr);
+        }
+
         if (ptr > plugin_list_buf)
         {
             ptr[-2] = '\0';
@@ -766,42 +898,29 @@ CV_IMPL int64 cvGetTickCount(void)
 CV_IMPL double cvGetTickFrequency() { return icvGetProcessorInfo()->frequency; }
 
 static int icvNumThreads = 0;
-static int icvNumProcs = 0;
 
 CV_IMPL int cvGetNumThreads(void)
 {
-    if (!icvNumProcs)
+    if (!icvNumThreads)
         cvSetNumThreads(0);
     return icvNumThreads;
 }
 
 CV_IMPL void cvSetNumThreads(int threads)
 {
-    if (!icvNumProcs)
+    if (threads <= 0)
     {
-#ifdef _OPENMP
-        icvNumProcs = omp_get_num_procs();
-        icvNumProcs = MIN(icvNumProcs, CV_MAX_THREADS);
-#else
-        icvNumProcs = 1;
-#endif
+        const char* env = getenv("OPENCV_NUM_THREADS");
+        threads = env && *env ? atoi(env) : 0;
+        if (threads <= 0)
+            threads = icvGetProcessorInfo()->count;
     }
 
-    if (threads <= 0)
-        threads = icvNumProcs;
-    else
-        threads = MIN(threads, icvNumProcs);
-
-    icvNumThreads = threads;
-}
-
-CV_IMPL int cvGetThreadNum(void)
-{
+    threads = MIN(threads, CV_MAX_THREADS);
 #ifdef _OPENMP
-    return omp_get_thread_num();
-#else
-    return 0;
+    omp_set_num_threads(threads);
 #endif
+    icvNumThreads = threads;
 }
 
 /* End of file. */
@@ -299,6 +299,53 @@ CV_INLINE int cvIsInf(double value)
 #endif
 }
 
+/* IEEE 754 half-precision numbers (the elements of CV_16F arrays) are stored
+   as ushort. The conversion to half rounds to the nearest even value, as the
+   F16C instructions do, and keeps infinities and NaNs */
+CV_INLINE float cvHalfToFloat(ushort value)
+{
+    Cv32suf out;
+    unsigned sign = (unsigned)(value & 0x8000) << 16;
+    unsigned bits = value & 0x7fff;
+
+    if (bits >= 0x7c00) /* Inf or NaN */
+        out.u = sign | 0x7f800000 | ((bits & 0x3ff) << 13);
+    else if (bits >= 0x400) /* normalized */
+        out.u = sign | ((bits << 13) + 0x38000000);
+    else /* denormalized, bits * 2^-24 */
+    {
+        out.f = (float)bits * 5.9604644775390625e-8f;
+        out.u |= sign;
+    }
+
+    return out.f;
+}
+
+CV_INLINE ushort cvFloatToHalf(float value)
+{
+    Cv32suf in;
+    unsigned sign, bits;
+
+    in.f = value;
+    sign = (in.u >> 16) & 0x8000;
+    bits = in.u & 0x7fffffff;
+
+    if (bits >= 0x7f800000) /* Inf or NaN */
+        bits = bits > 0x7f800000 ? 0x7e00 | ((bits >> 13) & 0x3ff) : 0x7c00;
+    else if (bits >= 0x477ff000) /* rounds to Inf */
+        bits = 0x7c00;
+    else if (bits >= 0x38800000) /* normalized */
+        bits = (bits - 0x38000000 + 0xfff + ((bits >> 13) & 1)) >> 13;
+    else /* denormalized, rounded by the float addition */
+    {
+        in.u = bits;
+        in.f += 0.5f;
+        bits = in.u - 0x3f000000;
+    }
+
+    return (ushort)(sign | bits);
+}
+
 /*************** Random number generation *******************/
 
 typedef uint64 CvRNG;
@@ -372,8 +419,8 @@ typedef struct _IplImage
     int nChannels;    /* Most of OpenCV functions support 1,2,3 or 4 channels */
     int alphaChannel; /* ignored by OpenCV */
     int depth;        /* pixel depth in bits: IPL_DEPTH_8U, IPL_DEPTH_8S,
-                         IPL_DEPTH_16S,        IPL_DEPTH_32S, IPL_DEPTH_32F and
-                         IPL_DEPTH_64F        are supported */
+                         IPL_DEPTH_16S,        IPL_DEPTH_32S, IPL_DEPTH_32F,
+                         IPL_DEPTH_64F and IPL_DEPTH_16F are supported */
     char colorModel[4];  /* ignored by OpenCV */
     char channelSeq[4];  /* ditto */
     int dataOrder;       /* 0 - interleaved color channels, 1 - separate color
@@ -455,6 +502,10 @@ typedef struct _IplConvKernelFP
    floating point data in IplImage's */
 #define IPL_DEPTH_64F 64
 
+/* for storing half-precision floating point data (CV_16F) in IplImage's;
+   the flag tells it apart from IPL_DEPTH_16U */
+#define IPL_DEPTH_16F (0x40000000 | 16)
+
 /* get reference to pixel at (col,row),
    for multi-channel images (col) should be multiplied by number of channels */
 #define CV_IMAGE_ELEM(image, elemtype, row, col) \
@@ -475,6 +526,13 @@ typedef struct _IplConvKernelFP
 #define CV_32S 4
 #define CV_32F 5
 #define CV_64F 6
+#define CV_16F 7 /* IEEE 754 half-precision, stored as ushort */
+
+/* the pointer-sized element type of CV_SEQ_ELTYPE_PTR sequences and of the
+   file storage references. The depth field has no free code, so it shares 7
+   with CV_16F, and CV_ELEM_SIZE(CV_USRTYPE1) is 2, not sizeof(void*) as in
+   the earlier versions. The size of the sequence elements is taken with
+   CV_SEQ_ELTYPE_SIZE(seq), which tells the two apart by seq->elem_size */
 #define CV_USRTYPE1 7
 
 #define CV_MAKETYPE(depth, cn) ((depth) + (((cn) - 1) << CV_CN_SHIFT))
@@ -522,6 +580,12 @@ typedef struct _IplConvKernelFP
 #define CV_64FC4 CV_MAKETYPE(CV_64F, 4)
 #define CV_64FC(n) CV_MAKETYPE(CV_64F, (n))
 
+#define CV_16FC1 CV_MAKETYPE(CV_16F, 1)
+#define CV_16FC2 CV_MAKETYPE(CV_16F, 2)
+#define CV_16FC3 CV_MAKETYPE(CV_16F, 3)
+#define CV_16FC4 CV_MAKETYPE(CV_16F, 4)
+#define CV_16FC(n) CV_MAKETYPE(CV_16F, (n))
+
 #define CV_AUTO_STEP 0x7fffffff
 #define CV_WHOLE_ARR cvSlice(0, 0x3fffffff)
 
@@ -605,16 +669,13 @@ typedef struct CvMat
 #define CV_IS_MAT_CONST(mat) (((mat)->height | (mat)->width) == 1)
 
 /* size of each channel item,
-   0x124489 = 1000 0100 0100 0010 0010 0001 0001 ~ array of
+   0x28442211 = 0010 1000 0100 0100 0010 0010 0001 0001 ~ array of
    sizeof(arr_type_elem) */
-#define CV_ELEM_SIZE1(type) \
-    ((((sizeof(size_t) << 28) | 0x8442211) >> CV_MAT_DEPTH(type) * 4) & 15)
+#define CV_ELEM_SIZE1(type) ((0x28442211 >> CV_MAT_DEPTH(type) * 4) & 15)
 
-/* 0x3a50 = 11 10 10 01 01 00 00 ~ array of log2(sizeof(arr_type_elem)) */
-#define CV_ELEM_SIZE(type)                                            \
-    (CV_MAT_CN(type) << ((((sizeof(size_t) / 4 + 1) * 16384 | 0x3a50) \
-                          >> CV_MAT_DEPTH(type) * 2)                  \
-                         & 3))
+/* 0x7a50 = 01 11 10 10 01 01 00 00 ~ array of log2(sizeof(arr_type_elem)) */
+#define CV_ELEM_SIZE(type) \
+    (CV_MAT_CN(type) << ((0x7a50 >> CV_MAT_DEPTH(type) * 2) & 3))
 
 /* inline constructor. No data is allocated internally!!!
    (use together with cvCreateData, or use cvCreateMat instead to
@@ -623,7 +684,7 @@ CV_INLINE CvMat cvMat(int rows, int cols, int type, void* data CV_DEFAULT(NULL))
 {
     CvMat m;
 
-    assert((unsigned)CV_MAT_DEPTH(type) <= CV_64F);
+    assert((unsigned)CV_MAT_DEPTH(type) <= CV_16F);
     type = CV_MAT_TYPE(type);
     m.type = CV_MAT_MAGIC_VAL | CV_MAT_CONT_FLAG | type;
     m.cols = cols;
@@ -684,6 +745,8 @@ CV_INLINE void cvmSet(CvMat* mat, int row, int col, double value)
 CV_INLINE int cvCvToIplDepth(int type)
 {
     int depth = CV_MAT_DEPTH(type);
+    if (depth == CV_16F)
+        return IPL_DEPTH_16F;
     return CV_ELEM_SIZE1(depth) * 8
            | (depth == CV_8S || depth == CV_16S || depth == CV_32S
                   ? IPL_DEPTH_SIGN
@@ -1107,6 +1170,32 @@ CV_INLINE CvScalar cvScalarAll(double val0123)
     return scalar;
 }
 
+/*********************************** CvImageStats
+ * ***************************************/
+
+/* per-channel statistics of an array computed by cvImageStats */
+typedef struct CvImageStats
+{
+    int count;         /* the number of the sampled pixels */
+    CvScalar min_val;  /* the minimum of every channel */
+    CvScalar max_val;  /* the maximum */
+    CvScalar sum;      /* the sum of the sampled values */
+    CvScalar sqsum;    /* the sum of their squares */
+} CvImageStats;
+
+/*********************************** CvImageDiff
+ * ****************************************/
+
+/* per-channel differences of two arrays computed by cvImageDiff */
+typedef struct CvImageDiff
+{
+    int count;          /* the number of the compared pixels */
+    CvScalar max_diff;  /* the maximum absolute difference of every channel */
+    CvPoint max_loc[4]; /* its first location in the raster order */
+    CvScalar mse;       /* the mean squared difference */
+    CvScalar psnr;      /* the peak signal-to-noise ratio, dB */
+} CvImageDiff;
+
 /****************************************************************************************\
 *                                   Dynamic Data structures *
 \****************************************************************************************/
@@ -1143,6 +1232,15 @@ typedef struct CvMemStoragePos
     int free_space;
 } CvMemStoragePos;
 
+/* process-wide counters of the memory storage blocks */
+typedef struct CvMemStorageStats
+{
+    int64 heap_allocs;  /* blocks allocated from the heap */
+    int64 heap_frees;   /* blocks freed to the heap */
+    int64 pool_hits;    /* blocks taken from the thread block pools */
+    int64 pool_returns; /* blocks put to the thread block pools */
+} CvMemStorageStats;
+
 /*********************************** Sequence
  * *******************************************/
 
@@ -1385,6 +1483,14 @@ typedef CvContour CvPoint2DSeq;
 #define CV_SEQ_ELTYPE(seq) ((seq)->flags & CV_SEQ_ELTYPE_MASK)
 #define CV_SEQ_KIND(seq) ((seq)->flags & CV_SEQ_KIND_MASK)
 
+/* size of the element type of the sequence; a CV_SEQ_ELTYPE_PTR sequence
+   of pointer-sized elements is a sequence of pointers, not of CV_16F */
+#define CV_SEQ_ELTYPE_SIZE(seq)                              \
+    (CV_MAT_TYPE((seq)->flags) == CV_SEQ_ELTYPE_PTR          \
+             && (seq)->elem_size == (int)sizeof(void*)       \
+         ? (int)sizeof(void*)                                \
+         : CV_ELEM_SIZE((seq)->flags))
+
 /* flag checking */
 #define CV_IS_SEQ_INDEX(seq)                     \
     ((CV_SEQ_ELTYPE(seq) == CV_SEQ_ELTYPE_INDEX) \
@@ -1713,12 +1819,20 @@ typedef struct CvPluginFuncInfo
     int loaded_from;
 } CvPluginFuncInfo;
 
+typedef struct CvBuiltinFuncInfo
+{
+    void** func_addr;
+    void* builtin_func_addr;
+    int cpu_features;
+} CvBuiltinFuncInfo;
+
 typedef struct CvModuleInfo
 {
     struct CvModuleInfo* next;
     const char* name;
     const char* version;
     CvPluginFuncInfo* func_tab;
+    CvBuiltinFuncInfo* builtin_tab;
 } CvModuleInfo;
 
 #endif /*_CXCORE_TYPES_H_*/
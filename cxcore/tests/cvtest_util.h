@@ -0,0 +1,59 @@
+/* Helpers of the checks and benchmarks in cxcore/tests and cv/tests.
+
+   Each test is a standalone program (see RV_BUILD_CV_TESTS in the top
+   CMakeLists.txt). It prints a table, marks the rows that fail a check
+   with "FAILED" and returns the number of failed checks as its exit
+   status. */
+
+#ifndef _CVTEST_UTIL_H_
+#define _CVTEST_UTIL_H_
+
+#include "cxcore.h"
+
+#include <stdio.h>
+
+/* the least total time of the runs of CVTEST_BEST_TIME, in ms */
+#define CVTEST_MIN_TOTAL_MS 200
+
+static int cvtest_failures = 0;
+
+/* the milliseconds since the cvGetTickCount() value t */
+CV_INLINE double cvtest_ms_since(int64 t)
+{
+    return (cvGetTickCount() - t) / (cvGetTickFrequency() * 1000.);
+}
+
+/* counts a failed check; returns the mark to append to its table row */
+CV_INLINE const char* cvtest_check(int ok)
+{
+    cvtest_failures += !ok;
+    return ok ? "" : "  FAILED";
+}
+
+/* prints the number of failed checks and returns it for main() */
+CV_INLINE int cvtest_report(void)
+{
+    printf("%d failed\n", cvtest_failures);
+    return cvtest_failures;
+}
+
+/* runs the statement call at least runs times and for at least
+   CVTEST_MIN_TOTAL_MS, and sets best to the shortest run in ms */
+#define CVTEST_BEST_TIME(best, runs, call)                                \
+    do                                                                    \
+    {                                                                     \
+        double _total = 0;                                                \
+        int _i;                                                           \
+        (best) = DBL_MAX;                                                 \
+        for (_i = 0; _i < (runs) || _total < CVTEST_MIN_TOTAL_MS; _i++)   \
+        {                                                                 \
+            int64 _t = cvGetTickCount();                                  \
+            double _ms;                                                   \
+            call;                                                         \
+            _ms = cvtest_ms_since(_t);                                    \
+            (best) = MIN((best), _ms);                                    \
+            _total += _ms;                                                \
+        }                                                                 \
+    } while (0)
+
+#endif /* _CVTEST_UTIL_H_ */
@@ -0,0 +1,65 @@
+/* Times cvDFT on 2K and 4K frames, with the built-in radix kernels off
+   (cvUseOptimized(0)) and on, and checks that the inverse transform gives
+   back the source.
+
+   g++ -O2 test-dxt.cpp -I.. -L<libdir> -lcxcore
+
+   "first" is the first call for the size, which builds the plan; the other
+   times are the best of a few calls with the cached plan. Pass a number of
+   threads as the argument to run on more than one. */
+
+#include "cvtest_util.h"
+
+#include <stdlib.h>
+
+static void bench(int rows, int cols, int type)
+{
+    CvMat* src = cvCreateMat(rows, cols, type);
+    CvMat* freq = cvCreateMat(rows, cols, type);
+    CvMat* back = cvCreateMat(rows, cols, type);
+    CvRNG rng = cvRNG(-1);
+    double first, c_fwd, fwd, inv, diff;
+    int64 t;
+    CvMat h0, h1;
+
+    cvRandArr(&rng, src, CV_RAND_UNI, cvScalarAll(-1), cvScalarAll(1));
+
+    t = cvGetTickCount();
+    cvDFT(src, freq, CV_DXT_FORWARD);
+    first = cvtest_ms_since(t);
+
+    cvUseOptimized(0);
+    CVTEST_BEST_TIME(c_fwd, 3, cvDFT(src, freq, CV_DXT_FORWARD));
+    cvUseOptimized(1);
+    CVTEST_BEST_TIME(fwd, 3, cvDFT(src, freq, CV_DXT_FORWARD));
+    CVTEST_BEST_TIME(inv, 3, cvDFT(freq, back, CV_DXT_INV_SCALE));
+
+    diff = cvNorm(cvReshape(src, &h0, 1), cvReshape(back, &h1, 1),
+                  CV_RELATIVE_C);
+    printf("%4dx%-4d %-4s %10.3g %9.2f %9.2f %9.2f %9.2f%s\n", cols, rows,
+           CV_MAT_CN(type) == 1 ? "32f" : "32fc", diff, first, c_fwd, fwd,
+           inv, cvtest_check(diff <= 1e-5));
+
+    cvReleaseMat(&src);
+    cvReleaseMat(&freq);
+    cvReleaseMat(&back);
+}
+
+int main(int argc, char** argv)
+{
+    static const CvSize sizes[] = {{2048, 2048}, {3840, 2160}, {4096, 4096}};
+    int i;
+
+    cvSetNumThreads(argc > 1 ? atoi(argv[1]) : 1);
+    printf("%d thread(s)\n", cvGetNumThreads());
+    printf("%9s %-4s %10s %9s %9s %9s %9s\n", "size", "type", "max diff",
+           "first ms", "C fwd ms", "fwd ms", "inv ms");
+
+    for (i = 0; i < 3; i++)
+    {
+        bench(sizes[i].height, sizes[i].width, CV_32FC1);
+        bench(sizes[i].height, sizes[i].width, CV_32FC2);
+    }
+
+    return cvtest_report();
+}
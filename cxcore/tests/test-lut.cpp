@@ -0,0 +1,171 @@
+/* Times cvLUT of 16-bit data to 16u and 32f and the 32f shaper LUT on a
+   3840x2160 3-channel frame against cvPow of the same gamma curve, and
+   checks the results.
+
+   g++ -O2 test-lut.cpp -I.. -L<libdir> -lcxcore
+
+   The 16-bit LUTs must give the table entries of the source values. The
+   shaper LUTs must be bit-exact with the built-in kernels off
+   (cvUseOptimized(0)) and on, and the log-spaced one must be within
+   MAX_GAMMA_ERR of cvPow. A table that holds its own samples must give the
+   source back within MAX_IDENTITY_ERR, which also checks that the
+   log-spaced samples do not straddle a power of two. */
+
+#include "cvtest_util.h"
+
+#include <math.h>
+
+/* the relative errors of the log-spaced shaper LUT */
+#define MAX_GAMMA_ERR 1e-5
+#define MAX_IDENTITY_ERR 1e-5
+
+#define GAMMA (1 / 2.4)
+
+/* the largest relative difference of the 32f arrays of the same size */
+static double max_rel_diff(const CvMat* a, const CvMat* b)
+{
+    int i, len = a->rows * a->cols * CV_MAT_CN(a->type);
+    double diff = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        double x = a->data.fl[i], y = b->data.fl[i];
+        diff = MAX(diff, fabs(x - y) / MAX(fabs(y), FLT_MIN));
+    }
+    return diff;
+}
+
+/* the 16-bit source values looked up in the table one by one */
+static int lut16_equal(const CvMat* src, const CvMat* dst, const CvMat* lut)
+{
+    int i, len = src->rows * src->cols * CV_MAT_CN(src->type);
+
+    for (i = 0; i < len; i++)
+    {
+        ushort v = src->data.s[i];
+        if (CV_MAT_DEPTH(dst->type) == CV_16U
+                ? dst->data.s[i] != lut->data.s[v]
+                : dst->data.fl[i] != lut->data.fl[v])
+            return 0;
+    }
+    return 1;
+}
+
+static void print_row(const char* name, double ms, double pow_ms,
+                      double err, int ok)
+{
+    printf("%-26s %9.2f %7.1f %7.2fx %10.3g%s\n", name, ms, 1000. / ms,
+           pow_ms / ms, err, cvtest_check(ok));
+}
+
+/* a table sampling x^GAMMA on [min_val,max_val] with the shaper LUT and the
+   shaper LUT of src with it, with the built-in kernels off and on */
+static void check_shaper(const char* name, const CvMat* src, CvMat* dst,
+                         const CvMat* ref, double pow_ms, double min_val,
+                         double max_val, int flags, int check_err)
+{
+    CvMat* samples = cvCreateMat(1, 4096, CV_32FC1);
+    CvMat* dst0 = cvCreateMat(src->rows, src->cols, src->type);
+    double t, err;
+
+    cvShaperLUTSamples(samples, min_val, max_val, flags);
+    cvPow(samples, samples, GAMMA);
+
+    cvUseOptimized(0);
+    cvShaperLUT(src, dst0, samples, min_val, max_val, flags);
+    cvUseOptimized(1);
+    CVTEST_BEST_TIME(t, 5,
+                     cvShaperLUT(src, dst, samples, min_val, max_val, flags));
+
+    err = max_rel_diff(dst, ref);
+    print_row(name, t, pow_ms, err,
+              cvNorm(dst0, dst, CV_C) == 0 && (!check_err
+                                               || err <= MAX_GAMMA_ERR));
+
+    cvReleaseMat(&samples);
+    cvReleaseMat(&dst0);
+}
+
+/* a table of 257 of its own samples on [min_val,max_val] applied to
+   values spread evenly in the logarithm over the range */
+static void check_identity(const char* name, double min_val, double max_val,
+                           int flags)
+{
+    CvMat* samples = cvCreateMat(1, 257, CV_32FC1);
+    CvMat* src = cvCreateMat(1, 1 << 20, CV_32FC1);
+    CvMat* dst = cvCreateMat(1, 1 << 20, CV_32FC1);
+    double err;
+    int i;
+
+    for (i = 0; i < src->cols; i++)
+        src->data.fl[i] = (float)(min_val * pow(max_val / min_val,
+                                                (double)i / (src->cols - 1)));
+    cvShaperLUTSamples(samples, min_val, max_val, flags);
+    cvShaperLUT(src, dst, samples, min_val, max_val, flags);
+
+    err = max_rel_diff(dst, src);
+    printf("%-26s %10.3g%s\n", name, err,
+           cvtest_check(err <= MAX_IDENTITY_ERR));
+
+    cvReleaseMat(&samples);
+    cvReleaseMat(&src);
+    cvReleaseMat(&dst);
+}
+
+int main(int, char**)
+{
+    CvSize size = cvSize(3840, 2160);
+    CvRNG rng = cvRNG(-1);
+    CvMat* src16u = cvCreateMat(size.height, size.width, CV_16UC3);
+    CvMat* src32f = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* dst16u = cvCreateMat(size.height, size.width, CV_16UC3);
+    CvMat* dst32f = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* ref = cvCreateMat(size.height, size.width, CV_32FC3);
+    CvMat* lut16u = cvCreateMat(1, 65536, CV_16UC1);
+    CvMat* lut32f = cvCreateMat(1, 65536, CV_32FC1);
+    double pow_ms, t;
+    int i;
+
+    for (i = 0; i < 65536; i++)
+    {
+        double v = pow(i / 65535., GAMMA);
+        lut16u->data.s[i] = (ushort)cvRound(v * 65535);
+        lut32f->data.fl[i] = (float)v;
+    }
+    cvRandArr(&rng, src16u, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(65536));
+    cvRandArr(&rng, src32f, CV_RAND_UNI, cvScalarAll(1e-4), cvScalarAll(1));
+
+    printf("%-26s %9s %7s %8s %10s\n", "3840x2160x3", "ms", "fps",
+           "vs pow", "max error");
+
+    CVTEST_BEST_TIME(pow_ms, 5, cvPow(src32f, ref, GAMMA));
+    print_row("cvPow 32f", pow_ms, pow_ms, 0, 1);
+
+    CVTEST_BEST_TIME(t, 5, cvLUT(src16u, dst16u, lut16u));
+    print_row("cvLUT 16u->16u", t, pow_ms, 0,
+              lut16_equal(src16u, dst16u, lut16u));
+    CVTEST_BEST_TIME(t, 5, cvLUT(src16u, dst32f, lut32f));
+    print_row("cvLUT 16u->32f", t, pow_ms, 0,
+              lut16_equal(src16u, dst32f, lut32f));
+
+    check_shaper("cvShaperLUT 4096 log", src32f, dst32f, ref, pow_ms, 1e-4,
+                 1, CV_LUT_LOG, 1);
+    // uniform spacing is coarse near 0, where the curve is steep
+    check_shaper("cvShaperLUT 4096 uniform", src32f, dst32f, ref, pow_ms, 0,
+                 1, CV_LUT_UNIFORM, 0);
+
+    printf("\n%-26s %10s\n", "identity table of 257", "max error");
+    check_identity("log 1e-3..100", 1e-3, 100, CV_LUT_LOG);
+    check_identity("log 0.75..3000", 0.75, 3000, CV_LUT_LOG);
+    check_identity("uniform 1e-3..100", 1e-3, 100, CV_LUT_UNIFORM);
+
+    cvReleaseMat(&src16u);
+    cvReleaseMat(&src32f);
+    cvReleaseMat(&dst16u);
+    cvReleaseMat(&dst32f);
+    cvReleaseMat(&ref);
+    cvReleaseMat(&lut16u);
+    cvReleaseMat(&lut32f);
+
+    return cvtest_report();
+}
@@ -0,0 +1,110 @@
+/* Checks the built-in GEMM and cvTransform kernels against the C code
+   (cvUseOptimized(0)) and times both.
+
+   g++ -O2 test-matmul.cpp -I.. -L<libdir> -lcxcore
+
+   Both GEMM paths accumulate in double, so they agree to the rounding of
+   the result. The built-in cvTransform applies the matrix in single
+   precision, as the IPP ColorTwist functions it replaces do, so the integer
+   results may differ by 1. */
+
+#include "cvtest_util.h"
+
+static void check_gemm(int m, int n, int k, int depth, int flags)
+{
+    CvMat* a = cvCreateMat(m, k, CV_MAKETYPE(depth, 1));
+    CvMat* b = flags & CV_GEMM_B_T ? cvCreateMat(n, k, CV_MAKETYPE(depth, 1))
+                                   : cvCreateMat(k, n, CV_MAKETYPE(depth, 1));
+    CvMat* d0 = cvCreateMat(m, n, CV_MAKETYPE(depth, 1));
+    CvMat* d1 = cvCreateMat(m, n, CV_MAKETYPE(depth, 1));
+    CvRNG rng = cvRNG(-1);
+    double max_diff = depth == CV_32F ? 1e-5 : 1e-12, t0, t1, diff;
+    char name[64];
+
+    cvRandArr(&rng, a, CV_RAND_UNI, cvScalarAll(-1), cvScalarAll(1));
+    cvRandArr(&rng, b, CV_RAND_UNI, cvScalarAll(-1), cvScalarAll(1));
+
+    cvUseOptimized(0);
+    CVTEST_BEST_TIME(t0, 3, cvGEMM(a, b, 1, 0, 0, d0, flags));
+    cvUseOptimized(1);
+    CVTEST_BEST_TIME(t1, 3, cvGEMM(a, b, 1, 0, 0, d1, flags));
+
+    diff = cvNorm(d0, d1, CV_RELATIVE_C);
+    sprintf(name, "gemm %s %dx%dx%d%s", depth == CV_32F ? "32f" : "64f", m, n,
+            k, flags & CV_GEMM_B_T ? " B^T" : "");
+    printf("%-30s %10.3g %9.2f %9.2f %7.2fx%s\n", name, diff, t0, t1, t0 / t1,
+           cvtest_check(diff <= max_diff));
+
+    cvReleaseMat(&a);
+    cvReleaseMat(&b);
+    cvReleaseMat(&d0);
+    cvReleaseMat(&d1);
+}
+
+static void check_transform(int type, int with_shift)
+{
+    static const double m[] = {0.40, 0.35, 0.18, 0.05, 0.21, 0.72, 0.07,
+                               0.03, 0.02, 0.12, 0.95, 0.01, 0.1, 0.2,
+                               0.3,  0.4};
+    static const double s[] = {3, -5, 7, 0};
+    int cn = CV_MAT_CN(type), depth = CV_MAT_DEPTH(type);
+    CvMat M = cvMat(cn, cn, CV_64F, (void*)m);
+    CvMat S = cvMat(cn, 1, CV_64F, (void*)s);
+    CvMat* src = cvCreateMat(1080, 1920, type);
+    CvMat* dst0 = cvCreateMat(1080, 1920, type);
+    CvMat* dst1 = cvCreateMat(1080, 1920, type);
+    CvRNG rng = cvRNG(-1);
+    double range = depth == CV_8U ? 256 : depth == CV_16U ? 65536 : 1;
+    double max_diff = depth == CV_32F ? 1e-5 : 1, t0, t1, diff;
+    CvMat h0, h1;
+    char name[64];
+
+    cvRandArr(&rng, src, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(range));
+
+    cvUseOptimized(0);
+    CVTEST_BEST_TIME(t0, 5, cvTransform(src, dst0, &M, with_shift ? &S : 0));
+    cvUseOptimized(1);
+    CVTEST_BEST_TIME(t1, 5, cvTransform(src, dst1, &M, with_shift ? &S : 0));
+
+    // cvNorm takes up to 4 channels, compare the rows as single-channel
+    diff = cvNorm(cvReshape(dst0, &h0, 1), cvReshape(dst1, &h1, 1),
+                  depth == CV_32F ? CV_RELATIVE_C : CV_C);
+    sprintf(name, "transform 1920x1080 %sC%d %dx%d",
+            depth == CV_8U ? "8U" : depth == CV_16U ? "16U" : "32F", cn, cn,
+            cn + with_shift);
+    printf("%-30s %10.3g %9.2f %9.2f %7.2fx%s\n", name, diff, t0, t1, t0 / t1,
+           cvtest_check(diff <= max_diff));
+
+    cvReleaseMat(&src);
+    cvReleaseMat(&dst0);
+    cvReleaseMat(&dst1);
+}
+
+int main(int, char**)
+{
+    static const int types[] = {CV_8UC3, CV_16UC3, CV_32FC3,
+                                CV_8UC4, CV_16UC4, CV_32FC4};
+    int i;
+
+    printf("%-30s %10s %9s %9s %8s\n", "operation", "max diff", "C ms",
+           "SIMD ms", "speedup");
+
+    check_gemm(128, 128, 128, CV_32F, 0);
+    check_gemm(512, 512, 512, CV_32F, 0);
+    check_gemm(1024, 1024, 1024, CV_32F, 0);
+    check_gemm(512, 512, 512, CV_64F, 0);
+    check_gemm(512, 512, 512, CV_64F, CV_GEMM_B_T);
+    check_gemm(1024, 1024, 1024, CV_64F, 0);
+    check_gemm(10000, 16, 16, CV_32F, 0);
+    check_gemm(1000, 1000, 3, CV_64F, 0);
+
+    for (i = 0; i < 6; i++)
+    {
+        // the C4 kernels take a 4x4 matrix without the shift
+        check_transform(types[i], CV_MAT_CN(types[i]) == 3);
+        if (CV_MAT_CN(types[i]) == 3)
+            check_transform(types[i], 0);
+    }
+
+    return cvtest_report();
+}
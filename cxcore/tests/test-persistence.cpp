@@ -0,0 +1,313 @@
+/* Writes the same data to .yml, .xml and .cvb file storages, reads it
+   back and compares it with the originals, then times cvSave and cvLoad
+   of an undistort map in the three formats.
+
+   g++ -O2 test-persistence.cpp -I.. -L<libdir> -lcxcore
+
+   The sequences are read through cvReadRawData, cvGetSeqElem and a
+   sequence reader, which see the same nodes whether the numbers were
+   parsed from text or come from a binary payload; a binary payload gets
+   its nodes only when they are read, never when a matrix is. Pass a
+   directory for the temporary files as the argument (the current one by
+   default). */
+
+#include "cvtest_util.h"
+
+#include <string.h>
+
+/* prints only the failed checks */
+static void check(const char* format, const char* what, int ok)
+{
+    const char* mark = cvtest_check(ok);
+
+    if (!ok)
+        printf("%-4s %-40s%s\n", format, what, mark);
+}
+
+static long file_size(const char* filename)
+{
+    FILE* f = fopen(filename, "rb");
+    long size = -1;
+
+    if (f)
+    {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    return size;
+}
+
+/* compares the types, the sizes and the bytes; cvNorm does not take 8s */
+static int mats_equal(const CvMat* a, const CvMat* b)
+{
+    int y;
+
+    if (!a || !CV_ARE_TYPES_EQ(a, b) || !CV_ARE_SIZES_EQ(a, b))
+        return 0;
+    for (y = 0; y < a->rows; y++)
+        if (memcmp(a->data.ptr + (size_t)a->step * y,
+                   b->data.ptr + (size_t)b->step * y,
+                   (size_t)a->cols * CV_ELEM_SIZE(a->type)) != 0)
+            return 0;
+    return 1;
+}
+
+static void write_data(const char* filename, CvMat** mats, int mat_count)
+{
+    CvFileStorage* fs = cvOpenFileStorage(filename, 0, CV_STORAGE_WRITE);
+    int list[100];
+    double reals[3] = {0.5, -1e10, 3.25};
+    char name[16];
+    int i;
+
+    for (i = 0; i < 100; i++)
+        list[i] = i * i - 1000;
+
+    cvWriteInt(fs, "int", -7);
+    cvWriteReal(fs, "real", 0.125);
+    cvWriteString(fs, "string", "a b:c", 1);
+
+    cvStartWriteStruct(fs, "map", CV_NODE_MAP);
+    cvStartWriteStruct(fs, "inner", CV_NODE_MAP + CV_NODE_FLOW);
+    cvWriteInt(fs, "x", 1);
+    cvWriteInt(fs, "y", 2);
+    cvEndWriteStruct(fs);
+    cvStartWriteStruct(fs, "reals", CV_NODE_SEQ + CV_NODE_FLOW);
+    cvWriteRawData(fs, reals, 3, "d");
+    cvEndWriteStruct(fs);
+    cvEndWriteStruct(fs);
+
+    // a payload of its own, long enough to be stored raw in .cvb
+    cvStartWriteStruct(fs, "list", CV_NODE_SEQ + CV_NODE_FLOW);
+    cvWriteRawData(fs, list, 100, "i");
+    cvEndWriteStruct(fs);
+
+    // a payload between ordinary elements
+    cvStartWriteStruct(fs, "mixed", CV_NODE_SEQ + CV_NODE_FLOW);
+    cvWriteString(fs, 0, "first", 0);
+    cvWriteRawData(fs, list, 100, "i");
+    cvWriteInt(fs, 0, 5);
+    cvEndWriteStruct(fs);
+
+    for (i = 0; i < mat_count; i++)
+    {
+        sprintf(name, "mat%d", i);
+        cvWrite(fs, name, mats[i]);
+    }
+
+    cvReleaseFileStorage(&fs);
+}
+
+/* reads the 100 numbers of the list in the three ways */
+static void check_list(const char* format, CvFileStorage* fs,
+                       CvFileNode* node, int offset)
+{
+    int list[100], i, ok;
+    CvSeq* seq;
+    CvSeqReader reader;
+
+    check(format, "list is a sequence", node && CV_NODE_IS_SEQ(node->tag));
+    if (!node || !CV_NODE_IS_SEQ(node->tag))
+        return;
+    seq = node->data.seq;
+    check(format, "list length", seq->total == offset + 100 + (offset > 0));
+
+    if (offset == 0)
+    {
+        memset(list, 0, sizeof(list));
+        cvReadRawData(fs, node, list, "i");
+        for (i = 0, ok = 1; i < 100; i++)
+            ok &= list[i] == i * i - 1000;
+        check(format, "list through cvReadRawData", ok);
+
+        memset(list, 0, sizeof(list));
+        cvStartReadRawData(fs, node, &reader);
+        cvReadRawDataSlice(fs, &reader, 50, list, "i");
+        cvReadRawDataSlice(fs, &reader, 50, list + 50, "i");
+        for (i = 0, ok = 1; i < 100; i++)
+            ok &= list[i] == i * i - 1000;
+        check(format, "list through cvReadRawDataSlice", ok);
+    }
+
+    for (i = 0, ok = 1; i < 100; i++)
+    {
+        CvFileNode* elem = (CvFileNode*)cvGetSeqElem(seq, offset + i);
+        ok &= CV_NODE_IS_INT(elem->tag) && elem->data.i == i * i - 1000;
+    }
+    check(format, "list through cvGetSeqElem", ok);
+
+    cvStartReadSeq(seq, &reader, 0);
+    for (i = 0, ok = 1; i < seq->total; i++)
+    {
+        CvFileNode* elem = (CvFileNode*)reader.ptr;
+        if (i >= offset && i < offset + 100)
+            ok &= CV_NODE_IS_INT(elem->tag)
+                  && elem->data.i == (i - offset) * (i - offset) - 1000;
+        CV_NEXT_SEQ_ELEM(seq->elem_size, reader);
+    }
+    check(format, "list through a sequence reader", ok);
+}
+
+static void check_data(const char* format, const char* filename,
+                       CvMat** mats, int mat_count)
+{
+    CvFileStorage* fs = cvOpenFileStorage(filename, 0, CV_STORAGE_READ);
+    CvFileNode* node;
+    char name[64];
+    double reals[3];
+    int i;
+
+    check(format, "open", fs != 0);
+    if (!fs)
+        return;
+
+    check(format, "int", cvReadIntByName(fs, 0, "int", 0) == -7);
+    check(format, "real", cvReadRealByName(fs, 0, "real", 0) == 0.125);
+    check(format, "string",
+          strcmp(cvReadStringByName(fs, 0, "string", ""), "a b:c") == 0);
+
+    node = cvGetFileNodeByName(fs, 0, "map");
+    node = cvGetFileNodeByName(fs, node, "inner");
+    check(format, "nested map", cvReadIntByName(fs, node, "x", 0) == 1
+                                    && cvReadIntByName(fs, node, "y", 0) == 2);
+    node = cvGetFileNodeByName(fs, cvGetFileNodeByName(fs, 0, "map"), "reals");
+    cvReadRawData(fs, node, reals, "d");
+    check(format, "reals",
+          reals[0] == 0.5 && reals[1] == -1e10 && reals[2] == 3.25);
+
+    check_list(format, fs, cvGetFileNodeByName(fs, 0, "list"), 0);
+    check_list(format, fs, cvGetFileNodeByName(fs, 0, "mixed"), 1);
+
+    for (i = 0; i < mat_count; i++)
+    {
+        CvMat* mat;
+
+        sprintf(name, "mat%d", i);
+        mat = (CvMat*)cvReadByName(fs, 0, name);
+        sprintf(name, "mat%d (%dx%d type %d)", i, mats[i]->cols,
+                mats[i]->rows, CV_MAT_TYPE(mats[i]->type));
+        check(format, name, mats_equal(mat, mats[i]));
+        cvReleaseMat(&mat);
+    }
+
+    cvReleaseFileStorage(&fs);
+}
+
+/* reads the map with cvRead, which in .cvb must leave the sequence of the
+   numbers without nodes, then reads the numbers with a sequence reader,
+   which builds them */
+static void check_map_nodes(const char* format, const char* filename)
+{
+    CvFileStorage* fs = cvOpenFileStorage(filename, 0, CV_STORAGE_READ);
+    CvFileNode* node = cvGetFileNodeByName(fs, 0, "map");
+    CvMat* map = (CvMat*)cvRead(fs, node);
+    CvSeq* seq = cvGetFileNodeByName(fs, node, "data")->data.seq;
+    CvSeqReader reader;
+    int i, ok;
+
+    if (strcmp(format, "cvb") == 0)
+        check(format, "map read without nodes", seq->first == 0);
+
+    cvStartReadSeq(seq, &reader, 0);
+    ok = seq->total == map->rows * map->cols * 2;
+    for (i = 0; i < seq->total && ok; i++)
+    {
+        CvFileNode* elem = (CvFileNode*)reader.ptr;
+        ok = CV_NODE_IS_REAL(elem->tag)
+             && (float)elem->data.f == map->data.fl[i];
+        CV_NEXT_SEQ_ELEM(seq->elem_size, reader);
+    }
+    check(format, "map through a sequence reader", ok);
+
+    cvReleaseMat(&map);
+    cvReleaseFileStorage(&fs);
+}
+
+/* writes an undistort map with its fixed-point version and loads the
+   float one, the best of 3 */
+static void bench(const char* format, const char* filename)
+{
+    CvMat* map = cvCreateMat(1080, 1920, CV_32FC2);
+    CvMat* fixed = cvCreateMat(1080, 1920, CV_16SC2);
+    CvMat* loaded = 0;
+    CvRNG rng = cvRNG(-1);
+    CvFileStorage* fs;
+    double twrite, tload;
+    int64 t;
+
+    cvRandArr(&rng, map, CV_RAND_UNI, cvScalarAll(-10), cvScalarAll(2000));
+    cvConvert(map, fixed);
+
+    t = cvGetTickCount();
+    fs = cvOpenFileStorage(filename, 0, CV_STORAGE_WRITE);
+    cvWrite(fs, "map", map);
+    cvWrite(fs, "fixed", fixed);
+    cvReleaseFileStorage(&fs);
+    twrite = cvtest_ms_since(t);
+
+    CVTEST_BEST_TIME(tload, 3, (cvReleaseMat(&loaded),
+                                loaded = (CvMat*)cvLoad(filename, 0, "map")));
+
+    // the text formats keep 9 significant digits of the floats
+    check(format, "loaded map",
+          loaded && CV_ARE_TYPES_EQ(loaded, map)
+              && CV_ARE_SIZES_EQ(loaded, map)
+              && cvNorm(loaded, map, CV_RELATIVE_C) <= 1e-7);
+    check_map_nodes(format, filename);
+    printf("%-4s %9.1f %10.1f %10.1f\n", format, file_size(filename) / 1e6,
+           twrite, tload);
+
+    cvReleaseMat(&map);
+    cvReleaseMat(&fixed);
+    cvReleaseMat(&loaded);
+    remove(filename);
+}
+
+int main(int argc, char** argv)
+{
+    static const char* formats[] = {"yml", "xml", "cvb"};
+    static const int types[] = {CV_8UC1, CV_8SC3,  CV_16UC1, CV_16SC3,
+                                CV_32SC1, CV_32FC3, CV_64FC1};
+    CvMat* mats[8];
+    CvMat* big = cvCreateMat(480, 640, CV_8UC3);
+    CvRNG rng = cvRNG(-1);
+    const char* dir = argc > 1 ? argv[1] : ".";
+    char filename[1024];
+    int i;
+
+    for (i = 0; i < 7; i++)
+    {
+        CvMat* temp = cvCreateMat(5 + i, 7 + i * 3,
+                                  CV_MAKETYPE(CV_64F, CV_MAT_CN(types[i])));
+
+        // cvRandArr does not fill 8s arrays
+        cvRandArr(&rng, temp, CV_RAND_UNI, cvScalarAll(-100.5),
+                  cvScalarAll(100.5));
+        mats[i] = cvCreateMat(temp->rows, temp->cols, types[i]);
+        cvConvert(temp, mats[i]);
+        cvReleaseMat(&temp);
+    }
+    cvRandArr(&rng, big, CV_RAND_UNI, cvScalarAll(0), cvScalarAll(256));
+    mats[7] = big;
+
+    for (i = 0; i < 3; i++)
+    {
+        sprintf(filename, "%s/test-persistence.%s", dir, formats[i]);
+        write_data(filename, mats, 8);
+        check_data(formats[i], filename, mats, 8);
+        remove(filename);
+    }
+
+    printf("%-4s %9s %10s %10s\n", "", "size MB", "write ms", "load ms");
+    for (i = 0; i < 3; i++)
+    {
+        sprintf(filename, "%s/test-persistence-map.%s", dir, formats[i]);
+        bench(formats[i], filename);
+    }
+
+    for (i = 0; i < 8; i++)
+        cvReleaseMat(&mats[i]);
+
+    return cvtest_report();
+}
@@ -0,0 +1,292 @@
+/* Checks cvImageDiff and cvSSIM against naive references and times them,
+   with MS-SSIM, on 1920x1080 and 3840x2160 3-channel frames of 8u, 16u,
+   16f and 32f.
+
+   g++ -O2 test-quality.cpp -I.. -L<libdir> -lcxcore
+
+   The frames are a wave pattern with uniform noise and the same frame with
+   gaussian noise. The reference difference takes the absolute differences
+   in float like cvImageDiff, so the maxima and their first locations must
+   be the same and the mask must match; the MSE and the PSNR may differ by
+   the order of the summation only. The reference SSIM is the direct 11x11
+   window sum in double on a 256x256 part of the frames. */
+
+#include "cvtest_util.h"
+
+#include <math.h>
+#include <string.h>
+
+#define MAX_MSE_ERR 1e-9  /* relative */
+#define MAX_SSIM_ERR 1e-4 /* absolute */
+
+#define DIFF_THRESHOLD 0.05 /* of the peak */
+#define SSIM_PART 256
+
+/* prints only the failed checks */
+static void check(const char* depth, const char* what, int ok)
+{
+    const char* mark = cvtest_check(ok);
+
+    if (!ok)
+        printf("%-4s %-30s%s\n", depth, what, mark);
+}
+
+/* arr converted to 64f and multiplied by scale */
+static CvMat* to64f(const CvArr* arr, double scale)
+{
+    CvMat stub, *mat = cvGetMat(arr, &stub);
+    CvMat* dst =
+        cvCreateMat(mat->rows, mat->cols, CV_64FC(CV_MAT_CN(mat->type)));
+
+    cvConvertScale(mat, dst, scale);
+    return dst;
+}
+
+static void check_diff(const char* name, const CvMat* a, const CvMat* b,
+                       double peak)
+{
+    int cn = CV_MAT_CN(a->type), x, y, k, ok;
+    CvMat* a64 = to64f(a, 1);
+    CvMat* b64 = to64f(b, 1);
+    CvMat* mask = cvCreateMat(a->rows, a->cols, CV_8UC1);
+    CvImageDiff diff;
+    double mx[4], sq[4], threshold = DIFF_THRESHOLD * peak;
+    CvPoint loc[4];
+
+    cvImageDiff(a, b, &diff, mask, threshold);
+
+    for (k = 0; k < cn; k++)
+    {
+        mx[k] = -1;
+        sq[k] = 0;
+    }
+    for (y = 0, ok = 1; y < a->rows; y++)
+    {
+        const double* pa = (const double*)(a64->data.ptr + y * a64->step);
+        const double* pb = (const double*)(b64->data.ptr + y * b64->step);
+
+        for (x = 0; x < a->cols; x++)
+        {
+            int differs = 0;
+
+            for (k = 0; k < cn; k++)
+            {
+                float d = (float)fabs((float)pa[x * cn + k]
+                                      - (float)pb[x * cn + k]);
+                if (d > mx[k])
+                {
+                    mx[k] = d;
+                    loc[k] = cvPoint(x, y);
+                }
+                sq[k] += (double)d * d;
+                differs |= d > (float)threshold;
+            }
+            ok &= CV_MAT_ELEM(*mask, uchar, y, x) == (differs ? 255 : 0);
+        }
+    }
+    check(name, "mask", ok);
+
+    for (k = 0; k < cn; k++)
+    {
+        double mse = sq[k] / ((double)a->rows * a->cols);
+        double psnr = 10 * log10(peak * peak / mse);
+
+        check(name, "max diff", diff.max_diff.val[k] == mx[k]);
+        check(name, "max diff location", diff.max_loc[k].x == loc[k].x
+                                             && diff.max_loc[k].y == loc[k].y);
+        check(name, "mse",
+              fabs(diff.mse.val[k] - mse) <= MAX_MSE_ERR * mse);
+        check(name, "psnr",
+              fabs(diff.psnr.val[k] - psnr) <= MAX_MSE_ERR * psnr);
+    }
+    check(name, "count", diff.count == a->rows * a->cols);
+
+    printf("%-4s %12.4g %12.4g %10.4f %10.4f\n", name, diff.max_diff.val[0],
+           mx[0], diff.psnr.val[0],
+           10 * log10(peak * peak * a->rows * a->cols / sq[0]));
+
+    cvReleaseMat(&a64);
+    cvReleaseMat(&b64);
+    cvReleaseMat(&mask);
+}
+
+/* the mean SSIM of every channel by the definition */
+static CvScalar ssim_reference(const CvArr* a, const CvArr* b, double peak)
+{
+    const double c1 = 0.01 * 0.01, c2 = 0.03 * 0.03;
+    CvMat* a64 = to64f(a, 1. / peak);
+    CvMat* b64 = to64f(b, 1. / peak);
+    int cn = CV_MAT_CN(a64->type), x, y, i, j, k;
+    int width = a64->cols - 10, height = a64->rows - 10;
+    double w[11], wsum = 0;
+    CvScalar sum = cvScalarAll(0);
+
+    for (i = 0; i < 11; i++)
+        wsum += w[i] = exp(-(i - 5) * (i - 5) / (2 * 1.5 * 1.5));
+
+    for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+            for (k = 0; k < cn; k++)
+            {
+                double mu1 = 0, mu2 = 0, s11 = 0, s22 = 0, s12 = 0;
+
+                for (i = 0; i < 11; i++)
+                    for (j = 0; j < 11; j++)
+                    {
+                        double wij = w[i] * w[j] / (wsum * wsum);
+                        double p = ((const double*)(a64->data.ptr
+                                                    + (y + i) * a64->step))
+                            [(x + j) * cn + k];
+                        double q = ((const double*)(b64->data.ptr
+                                                    + (y + i) * b64->step))
+                            [(x + j) * cn + k];
+                        mu1 += wij * p;
+                        mu2 += wij * q;
+                        s11 += wij * p * p;
+                        s22 += wij * q * q;
+                        s12 += wij * p * q;
+                    }
+
+                sum.val[k] += (2 * mu1 * mu2 + c1)
+                              * (2 * (s12 - mu1 * mu2) + c2)
+                              / ((mu1 * mu1 + mu2 * mu2 + c1)
+                                 * (s11 - mu1 * mu1 + s22 - mu2 * mu2 + c2));
+            }
+
+    for (k = 0; k < cn; k++)
+        sum.val[k] /= (double)width * height;
+
+    cvReleaseMat(&a64);
+    cvReleaseMat(&b64);
+    return sum;
+}
+
+static void check_ssim(const char* name, const CvMat* a, const CvMat* b,
+                       double peak)
+{
+    CvMat part1, part2;
+    CvRect r = cvRect(a->cols / 3, a->rows / 3, SSIM_PART, SSIM_PART);
+    CvScalar s, ref;
+    int k, cn = CV_MAT_CN(a->type);
+
+    cvGetSubRect(a, &part1, r);
+    cvGetSubRect(b, &part2, r);
+    s = cvSSIM(&part1, &part2);
+    ref = ssim_reference(&part1, &part2, peak);
+
+    for (k = 0; k < cn; k++)
+        check(name, "ssim", fabs(s.val[k] - ref.val[k]) <= MAX_SSIM_ERR);
+
+    printf("%-4s %12.6f %12.6f\n", name, s.val[0], ref.val[0]);
+}
+
+/* the reference frame and the noisy one of the size, values in [0,1] */
+static void create_frames(CvSize size, CvMat** a, CvMat** b)
+{
+    CvRNG rng = cvRNG(-1);
+    CvMat* noise = cvCreateMat(size.height, size.width, CV_32FC3);
+    int x, y;
+
+    *a = cvCreateMat(size.height, size.width, CV_32FC3);
+    *b = cvCreateMat(size.height, size.width, CV_32FC3);
+    cvRandArr(&rng, *a, CV_RAND_UNI, cvScalarAll(-0.1), cvScalarAll(0.1));
+    cvRandArr(&rng, noise, CV_RAND_NORMAL, cvScalarAll(0),
+              cvScalarAll(0.02));
+    for (y = 0; y < size.height; y++)
+    {
+        float* pa = (float*)((*a)->data.ptr + y * (*a)->step);
+        float* pb = (float*)((*b)->data.ptr + y * (*b)->step);
+        const float* pn = (const float*)(noise->data.ptr + y * noise->step);
+
+        for (x = 0; x < size.width * 3; x++)
+        {
+            pa[x] += (float)(0.5 + 0.35 * sin(x / 3 * 0.05 + x % 3)
+                                       * cos(y * 0.07));
+            pb[x] = MIN(MAX(pa[x] + pn[x], 0.f), 1.f);
+        }
+    }
+
+    cvReleaseMat(&noise);
+}
+
+/* src of [0,1] converted to depth with the values of [0,peak] */
+static CvMat* convert_frame(const CvMat* src, int depth, double peak)
+{
+    CvMat* dst = cvCreateMat(src->rows, src->cols,
+                             CV_MAKETYPE(depth, CV_MAT_CN(src->type)));
+
+    cvConvertScale(src, dst, peak);
+    return dst;
+}
+
+int main(int, char**)
+{
+    static const int depths[] = {CV_8U, CV_16U, CV_16F, CV_32F};
+    static const char* depth_names[] = {"8u", "16u", "16f", "32f"};
+    static const double peaks[] = {255, 65535, 1, 1};
+    static const CvSize sizes[] = {{1920, 1080}, {3840, 2160}};
+    CvMat *a32f, *b32f;
+    int i, j;
+
+    create_frames(sizes[0], &a32f, &b32f);
+
+    printf("%-4s %12s %12s %10s %10s\n", "", "max diff", "reference",
+           "psnr", "reference");
+    for (i = 0; i < 4; i++)
+    {
+        CvMat* a = convert_frame(a32f, depths[i], peaks[i]);
+        CvMat* b = convert_frame(b32f, depths[i], peaks[i]);
+
+        check_diff(depth_names[i], a, b, peaks[i]);
+
+        cvReleaseMat(&a);
+        cvReleaseMat(&b);
+    }
+
+    printf("\n%-4s %12s %12s\n", "", "ssim", "reference");
+    for (i = 0; i < 4; i++)
+    {
+        CvMat* a = convert_frame(a32f, depths[i], peaks[i]);
+        CvMat* b = convert_frame(b32f, depths[i], peaks[i]);
+
+        check_ssim(depth_names[i], a, b, peaks[i]);
+
+        cvReleaseMat(&a);
+        cvReleaseMat(&b);
+    }
+    cvReleaseMat(&a32f);
+    cvReleaseMat(&b32f);
+
+    printf("\n%-10s %-4s %9s %9s %9s %9s\n", "frames/s", "", "diff ms",
+           "diff", "ssim", "ms-ssim");
+    for (j = 0; j < 2; j++)
+    {
+        create_frames(sizes[j], &a32f, &b32f);
+
+        for (i = 0; i < 4; i++)
+        {
+            CvMat* a = convert_frame(a32f, depths[i], peaks[i]);
+            CvMat* b = convert_frame(b32f, depths[i], peaks[i]);
+            CvImageDiff diff;
+            double tdiff, tssim, tms;
+            char size_name[32];
+
+            CVTEST_BEST_TIME(tdiff, 3, cvImageDiff(a, b, &diff));
+            CVTEST_BEST_TIME(tssim, 3, cvSSIM(a, b));
+            CVTEST_BEST_TIME(tms, 3, cvSSIM(a, b, CV_SSIM_MULTISCALE));
+
+            sprintf(size_name, "%dx%d", sizes[j].width, sizes[j].height);
+            printf("%-10s %-4s %9.2f %9.1f %9.1f %9.1f\n", size_name,
+                   depth_names[i], tdiff, 1000. / tdiff, 1000. / tssim,
+                   1000. / tms);
+
+            cvReleaseMat(&a);
+            cvReleaseMat(&b);
+        }
+
+        cvReleaseMat(&a32f);
+        cvReleaseMat(&b32f);
+    }
+
+    return cvtest_report();
+}
@@ -21,6 +21,7 @@
 #include <config.h>
 
 #include <libexif/exif-content.h>
+#include <libexif/exif-data-priv.h>
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -117,6 +118,8 @@ void exif_content_dump(ExifContent* content, unsigned int indent)
     if (!content)
         return;
 
+    if (content->parent)
+        exif_data_load_lazy_entries(content->parent, content);
     printf("%sDumping exif content (%u entries)...\n", buf, content->count);
     for (i = 0; i < content->count; i++)
         exif_entry_dump(content->entries[i], indent + 1);
@@ -156,6 +159,10 @@ void exif_content_remove_entry(ExifContent* c, ExifEntry* e)
     if (!c || !c->priv || !e || (e->parent != c))
         return;
 
+    /* A removed entry must not be loaded again later. */
+    if (c->parent)
+        exif_data_load_lazy_entries(c->parent, c);
+
     /* Search the entry */
     for (i = 0; i < c->count; i++)
         if (c->entries[i] == e)
@@ -183,6 +190,8 @@ ExifEntry* exif_content_get_entry(ExifContent* content, ExifTag tag)
     for (i = 0; i < content->count; i++)
         if (content->entries[i]->tag == tag)
             return (content->entries[i]);
+    if (content->parent)
+        return exif_data_load_lazy_entry(content->parent, content, tag);
     return (NULL);
 }
 
@@ -194,6 +203,8 @@ void exif_content_foreach_entry(ExifContent* content,
     if (!content || !func)
         return;
 
+    if (content->parent)
+        exif_data_load_lazy_entries(content->parent, content);
     for (i = 0; i < content->count; i++)
         func(content->entries[i], data);
 }
@@ -22,6 +22,7 @@
 
 #include <libexif/exif-mnote-data.h>
 #include <libexif/exif-data.h>
+#include <libexif/exif-data-priv.h>
 #include <libexif/exif-ifd.h>
 #include <libexif/exif-mnote-data-priv.h>
 #include <libexif/exif-utils.h>
@@ -66,6 +67,14 @@ struct _ExifDataPrivate
 
     ExifDataOption options;
     ExifDataType data_type;
+
+    /* Copy of the loaded data while entries are decoded lazily */
+    unsigned char* lazy_d;
+    unsigned int lazy_ds;
+    unsigned int lazy_offset[EXIF_IFD_COUNT];
+    unsigned char lazy_pending[EXIF_IFD_COUNT];
+    unsigned char lazy_busy;
+    unsigned char lazy_mnote;
 };
 
 static void* exif_data_alloc(ExifData* data, unsigned int i)
@@ -83,9 +92,21 @@ static void* exif_data_alloc(ExifData* data, unsigned int i)
     return NULL;
 }
 
+static void exif_data_interpret_maker_note(ExifData* data,
+                                           const unsigned char* d,
+                                           unsigned int ds);
+
 ExifMnoteData* exif_data_get_mnote_data(ExifData* d)
 {
-    return (d && d->priv) ? d->priv->md : NULL;
+    if (!d || !d->priv)
+        return NULL;
+
+    if (d->priv->lazy_mnote)
+    {
+        d->priv->lazy_mnote = 0;
+        exif_data_interpret_maker_note(d, d->priv->lazy_d, d->priv->lazy_ds);
+    }
+    return d->priv->md;
 }
 
 ExifData* exif_data_new(void)
@@ -305,6 +326,80 @@ static void exif_data_load_data_thumbnail(ExifData* data,
     memcpy(data->data, d + offset, data->size);
 }
 
+/*
+ * Load the entry at position i of the IFD table at offset. Pointers to
+ * other IFDs and to the thumbnail are not entries.
+ */
+static ExifEntry* exif_data_load_data_content_entry(ExifData* data,
+                                                    ExifIfd ifd,
+                                                    const unsigned char* d,
+                                                    unsigned int ds,
+                                                    unsigned int offset,
+                                                    unsigned int i)
+{
+    ExifEntry* entry;
+    ExifTag tag = exif_get_short(d + offset + 12 * i, data->priv->order);
+
+    switch (tag)
+    {
+    case EXIF_TAG_EXIF_IFD_POINTER:
+    case EXIF_TAG_GPS_INFO_IFD_POINTER:
+    case EXIF_TAG_INTEROPERABILITY_IFD_POINTER:
+    case EXIF_TAG_JPEG_INTERCHANGE_FORMAT_LENGTH:
+    case EXIF_TAG_JPEG_INTERCHANGE_FORMAT:
+        return NULL;
+    default:
+        break;
+    }
+
+    /*
+     * If we don't know the tag, don't fail. It could be that new
+     * versions of the standard have defined additional tags. Note that
+     * 0 is a valid tag in the GPS IFD.
+     */
+    if (!exif_tag_get_name_in_ifd(tag, ifd))
+    {
+
+        /*
+         * Special case: Tag and format 0. That's against specification.
+         * At least up to 2.2. But Photoshop writes it anyways.
+         */
+        if (!memcmp(d + offset + 12 * i, "\0\0\0\0", 4))
+        {
+            exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
+                     "Skipping empty entry at position %i in '%s'.", i,
+                     exif_ifd_get_name(ifd));
+            return NULL;
+        }
+        exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
+                 "Unknown tag 0x%04x (entry %i in '%s'). Please report "
+                 "this tag "
+                 "to <libexif-devel@lists.sourceforge.net>.",
+                 tag, i, exif_ifd_get_name(ifd));
+        if (data->priv->options & EXIF_DATA_OPTION_IGNORE_UNKNOWN_TAGS)
+            return NULL;
+    }
+    entry = exif_entry_new_mem(data->priv->mem);
+    if (!entry)
+        return NULL;
+    if (!exif_data_load_data_entry(data, entry, d, ds, offset + 12 * i))
+    {
+        exif_entry_unref(entry);
+        return NULL;
+    }
+    exif_content_add_entry(data->ifd[ifd], entry);
+    exif_entry_unref(entry);
+    if (entry->parent != data->ifd[ifd])
+        return NULL;
+
+    /* Lazily loaded entries are not fixed as a whole. */
+    if (data->priv->lazy_d
+        && (data->priv->options & EXIF_DATA_OPTION_FOLLOW_SPECIFICATION))
+        exif_entry_fix(entry);
+
+    return entry;
+}
+
 #undef CHECK_REC
 #define CHECK_REC(i)                                               \
     if ((i) == ifd)                                                \
@@ -315,7 +410,7 @@ static void exif_data_load_data_thumbnail(ExifData* data,
                  exif_ifd_get_name(i));                            \
         break;                                                     \
     }                                                              \
-    if (data->ifd[(i)]->count)                                     \
+    if (data->ifd[(i)]->count || data->priv->lazy_pending[(i)])    \
     {                                                              \
         exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData", \
                  "Attemt to load IFD "                             \
@@ -332,7 +427,6 @@ static void exif_data_load_data_content(ExifData* data, ExifIfd ifd,
 {
     ExifLong o, thumbnail_offset = 0, thumbnail_length = 0;
     ExifShort n;
-    ExifEntry* entry;
     unsigned int i;
     ExifTag tag;
 
@@ -351,6 +445,11 @@ static void exif_data_load_data_content(ExifData* data, ExifIfd ifd,
     /* Read the number of entries */
     if (offset >= ds - 1)
         return;
+    if (data->priv->lazy_d)
+    {
+        data->priv->lazy_offset[ifd] = offset;
+        data->priv->lazy_pending[ifd] = 1;
+    }
     n = exif_get_short(d + offset, data->priv->order);
     exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
              "Loading %i entries...", n);
@@ -407,42 +506,92 @@ static void exif_data_load_data_content(ExifData* data, ExifIfd ifd,
             break;
         default:
 
-            /*
-             * If we don't know the tag, don't fail. It could be that new
-             * versions of the standard have defined additional tags. Note that
-             * 0 is a valid tag in the GPS IFD.
-             */
-            if (!exif_tag_get_name_in_ifd(tag, ifd))
-            {
+            /* Lazily loaded entries are decoded on demand. */
+            if (data->priv->lazy_d)
+                break;
 
-                /*
-                 * Special case: Tag and format 0. That's against specification.
-                 * At least up to 2.2. But Photoshop writes it anyways.
-                 */
-                if (!memcmp(d + offset + 12 * i, "\0\0\0\0", 4))
-                {
-                    exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
-                             "Skipping empty entry at position %i in '%s'.", i,
-                             exif_ifd_get_name(ifd));
-                    break;
-                }
-                exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
-                         "Unknown tag 0x%04x (entry %i in '%s'). Please report "
-                         "this tag "
-                         "to <libexif-devel@lists.sourceforge.net>.",
-                         tag, i, exif_ifd_get_name(ifd));
-                if (data->priv->options & EXIF_DATA_OPTION_IGNORE_UNKNOWN_TAGS)
-                    break;
-            }
-            entry = exif_entry_new_mem(data->priv->mem);
-            if (exif_data_load_data_entry(data, entry, d, ds, offset + 12 * i))
-                exif_content_add_entry(data->ifd[ifd], entry);
-            exif_entry_unref(entry);
+            exif_data_load_data_content_entry(data, ifd, d, ds, offset, i);
             break;
         }
     }
 }
 
+ExifEntry* exif_data_load_lazy_entry(ExifData* data, ExifContent* content,
+                                     ExifTag tag)
+{
+    const unsigned char* d;
+    unsigned int ds, offset, i, n;
+    ExifEntry* entry;
+    ExifIfd ifd = exif_content_get_ifd(content);
+
+    if (!data || !data->priv || !data->priv->lazy_d || data->priv->lazy_busy)
+        return NULL;
+    if ((ifd == EXIF_IFD_COUNT) || !data->priv->lazy_pending[ifd])
+        return NULL;
+
+    /* Offsets are relative to the byte order mark. */
+    d = data->priv->lazy_d + 6;
+    ds = data->priv->lazy_ds - 6;
+    offset = data->priv->lazy_offset[ifd];
+    n = exif_get_short(d + offset, data->priv->order);
+    offset += 2;
+    if (offset + 12 * n > ds)
+        n = (ds - offset) / 12;
+
+    for (i = 0; i < n; i++)
+        if (exif_get_short(d + offset + 12 * i, data->priv->order) == tag)
+            break;
+    if (i == n)
+        return NULL;
+
+    data->priv->lazy_busy = 1;
+    entry = exif_data_load_data_content_entry(data, ifd, d, ds, offset, i);
+    data->priv->lazy_busy = 0;
+
+    return entry;
+}
+
+void exif_data_load_lazy_entries(ExifData* data, ExifContent* content)
+{
+    const unsigned char* d;
+    unsigned int ds, offset, i, n;
+    ExifIfd ifd = exif_content_get_ifd(content);
+
+    if (!data || !data->priv || !data->priv->lazy_d || data->priv->lazy_busy)
+        return;
+    if ((ifd == EXIF_IFD_COUNT) || !data->priv->lazy_pending[ifd])
+        return;
+    data->priv->lazy_pending[ifd] = 0;
+
+    d = data->priv->lazy_d + 6;
+    ds = data->priv->lazy_ds - 6;
+    offset = data->priv->lazy_offset[ifd];
+    n = exif_get_short(d + offset, data->priv->order);
+    offset += 2;
+    if (offset + 12 * n > ds)
+        n = (ds - offset) / 12;
+
+    /* Entries that have been looked up already are kept. */
+    data->priv->lazy_busy = 1;
+    for (i = 0; i < n; i++)
+    {
+        if (exif_content_get_entry(
+                content, exif_get_short(d + offset + 12 * i,
+                                        data->priv->order)))
+            continue;
+        exif_data_load_data_content_entry(data, ifd, d, ds, offset, i);
+    }
+    data->priv->lazy_busy = 0;
+}
+
+static void exif_data_load_all_lazy_entries(ExifData* data)
+{
+    unsigned int i;
+
+    for (i = 0; i < EXIF_IFD_COUNT; i++)
+        exif_data_load_lazy_entries(data, data->ifd[i]);
+}
+
 static int cmp_func(const unsigned char* p1, const unsigned char* p2,
                     ExifByteOrder o)
 {
@@ -824,6 +973,27 @@ void exif_data_load_data(ExifData* data, const unsigned char* d_orig,
     exif_log(data->priv->log, EXIF_LOG_CODE_DEBUG, "ExifData",
              "Found EXIF header.");
 
+    /*
+     * Entries are decoded on demand from a private copy of the data
+     * if requested. Fall back to decoding all of them if we cannot
+     * make that copy.
+     */
+    exif_mem_free(data->priv->mem, data->priv->lazy_d);
+    data->priv->lazy_d = NULL;
+    data->priv->lazy_ds = 0;
+    data->priv->lazy_mnote = 0;
+    memset(data->priv->lazy_pending, 0, sizeof(data->priv->lazy_pending));
+    if (data->priv->options & EXIF_DATA_OPTION_LAZY_ENTRIES)
+    {
+        data->priv->lazy_d = exif_data_alloc(data, ds);
+        if (data->priv->lazy_d)
+        {
+            memcpy(data->priv->lazy_d, d, ds);
+            data->priv->lazy_ds = ds;
+            d = data->priv->lazy_d;
+        }
+    }
+
     /* Byte order (offset 6, length 2) */
     if (ds < 14)
         return;
@@ -883,8 +1053,23 @@ void exif_data_load_data(ExifData* data, const unsigned char* d_orig,
      * If we got an EXIF_TAG_MAKER_NOTE, try to interpret it. Some
      * cameras use pointers in the maker note tag that point to the
      * space between IFDs. Here is the only place where we have access
-     * to that data.
+     * to that data, unless we keep a copy of it for lazy loading.
      */
+    if (data->priv->lazy_d)
+    {
+        data->priv->lazy_mnote = 1;
+        return;
+    }
+    exif_data_interpret_maker_note(data, d, ds);
+
+    if (data->priv->options & EXIF_DATA_OPTION_FOLLOW_SPECIFICATION)
+        exif_data_fix(data);
+}
+
+static void exif_data_interpret_maker_note(ExifData* data,
+                                           const unsigned char* d,
+                                           unsigned int ds)
+{
     switch (exif_data_get_type_maker_note(data))
     {
     case EXIF_DATA_TYPE_MAKER_NOTE_OLYMPUS:
@@ -913,9 +1098,6 @@ void exif_data_load_data(ExifData* data, const unsigned char* d_orig,
         exif_mnote_data_set_offset(data->priv->md, data->priv->offset_mnote);
         exif_mnote_data_load(data->priv->md, d, ds);
     }
-
-    if (data->priv->options & EXIF_DATA_OPTION_FOLLOW_SPECIFICATION)
-        exif_data_fix(data);
 }
 
 void exif_data_save_data(ExifData* data, unsigned char** d, unsigned int* ds)
@@ -923,6 +1105,10 @@ void exif_data_save_data(ExifData* data, unsigned char** d, unsigned int* ds)
     if (!data || !d || !ds)
         return;
 
+    /* Everything gets saved, including the lazily loaded entries. */
+    exif_data_load_all_lazy_entries(data);
+    exif_data_get_mnote_data(data);
+
     /* Header */
     *ds = 14;
     *d = exif_data_alloc(data, *ds);
@@ -1025,6 +1211,7 @@ void exif_data_free(ExifData* data)
             exif_mnote_data_unref(data->priv->md);
             data->priv->md = NULL;
         }
+        exif_mem_free(mem, data->priv->lazy_d);
         exif_mem_free(mem, data->priv);
         exif_mem_free(mem, data);
     }
@@ -1039,6 +1226,8 @@ void exif_data_dump(ExifData* data)
     if (!data)
         return;
 
+    if (data->priv)
+        exif_data_load_all_lazy_entries(data);
     for (i = 0; i < EXIF_IFD_COUNT; i++)
     {
         if (data->ifd[i] && data->ifd[i]->count)
@@ -1156,6 +1345,9 @@ static struct
     {EXIF_DATA_OPTION_DONT_CHANGE_MAKER_NOTE, N_("Don not change maker note"),
      N_("When loading and resaving Exif data, save the maker note unmodified."
         " Be aware that the maker note can get corrupted.")},
+    {EXIF_DATA_OPTION_LAZY_ENTRIES, N_("Load entries lazily"),
+     N_("Decode entries when they are first looked up instead of when "
+        "loading EXIF data.")},
     {0, NULL, NULL}};
 
 const char* exif_data_option_get_name(ExifDataOption o)
@@ -1218,6 +1410,8 @@ static void fix_func(ExifContent* c, void* data)
 
 void exif_data_fix(ExifData* d)
 {
+    if (d && d->priv)
+        exif_data_load_all_lazy_entries(d);
     exif_data_foreach_content(d, fix_func, NULL);
 }
 
@@ -28,6 +28,12 @@
 #include <string.h>
 #include <stdio.h>
 
+#if defined(HAVE_UNISTD_H) && !defined(_WIN32)
+#include <sys/types.h>
+#include <unistd.h>
+#define EXIF_LOADER_PREAD 1
+#endif
+
 #undef JPEG_MARKER_SOI
 #define JPEG_MARKER_SOI 0xd8
 #undef JPEG_MARKER_APP0
@@ -40,6 +46,10 @@
 #define JPEG_MARKER_APP13 0xed
 #undef JPEG_MARKER_COM
 #define JPEG_MARKER_COM 0xfe
+#undef JPEG_MARKER_EOI
+#define JPEG_MARKER_EOI 0xd9
+#undef JPEG_MARKER_SOS
+#define JPEG_MARKER_SOS 0xda
 
 typedef enum
 {
@@ -75,6 +85,9 @@ struct _ExifLoader
 
     unsigned int ref_count;
 
+    /* Options of the ExifData returned by exif_loader_get_data */
+    ExifDataOption options;
+
     ExifLog* log;
     ExifMem* mem;
 };
@@ -99,6 +112,84 @@ static void* exif_loader_alloc(ExifLoader* l, unsigned int i)
 #undef MIN
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
+/*
+ * Read len bytes at position pos of the file. The position of the stream
+ * is left alone where pread is available.
+ */
+static unsigned int exif_loader_pread(FILE* f, unsigned char* buf,
+                                      unsigned int len, long pos)
+{
+#ifdef EXIF_LOADER_PREAD
+    ssize_t r = pread(fileno(f), buf, len, (off_t)pos);
+
+    return (r > 0) ? (unsigned int)r : 0;
+#else
+    if (fseek(f, pos, SEEK_SET))
+        return 0;
+    return fread(buf, 1, len, f);
+#endif
+}
+
+/*
+ * Walk the segment headers of a JPEG file and read only the APP1 segment
+ * that holds the EXIF data. Returns 0 if the file has to be scanned.
+ */
+static int exif_loader_read_jpeg(ExifLoader* l, FILE* f)
+{
+    unsigned char h[4 + sizeof(ExifHeader)];
+    unsigned int len;
+    long pos = 2;
+
+    if ((exif_loader_pread(f, h, 2, 0) != 2) || (h[0] != 0xff)
+        || (h[1] != JPEG_MARKER_SOI))
+        return 0;
+
+    while (1)
+    {
+        if ((exif_loader_pread(f, h, 4, pos) != 4) || (h[0] != 0xff))
+            return 0;
+
+        /* Fill bytes */
+        if (h[1] == 0xff)
+        {
+            pos++;
+            continue;
+        }
+
+        /* No EXIF data in front of the image data. */
+        if ((h[1] == JPEG_MARKER_SOS) || (h[1] == JPEG_MARKER_EOI))
+            return 0;
+
+        /* Markers without a length (TEM, RSTn) */
+        if ((h[1] == 0x01) || ((h[1] >= 0xd0) && (h[1] <= 0xd7)))
+            return 0;
+
+        len = (h[2] << 8) | h[3];
+        if (len < 2)
+            return 0;
+
+        if ((h[1] == JPEG_MARKER_APP1) && (len >= 2 + sizeof(ExifHeader))
+            && (exif_loader_pread(f, h + 4, sizeof(ExifHeader), pos + 4)
+                == sizeof(ExifHeader))
+            && !memcmp(h + 4, ExifHeader, sizeof(ExifHeader)))
+        {
+            l->size = len - 2;
+            l->buf = exif_loader_alloc(l, l->size);
+            if (!l->buf)
+            {
+                l->size = 0;
+                return 0;
+            }
+            l->bytes_read = exif_loader_pread(f, l->buf, l->size, pos + 4);
+            l->data_format = EL_DATA_FORMAT_EXIF;
+            l->state = EL_EXIF_FOUND;
+            return 1;
+        }
+
+        pos += 2 + len;
+    }
+}
+
 void exif_loader_write_file(ExifLoader* l, const char* path)
 {
     FILE* f;
@@ -115,6 +206,22 @@ void exif_loader_write_file(ExifLoader* l, const char* path)
                  _("The file '%s' could not be opened."), path);
         return;
     }
+
+    /*
+     * Most files are JPEG files. Read their EXIF data directly unless
+     * the loader has been fed other data already.
+     */
+    if ((l->state == EL_READ) && !l->buf && !l->b_len
+        && (l->data_format == EL_DATA_FORMAT_UNKNOWN))
+    {
+        if (exif_loader_read_jpeg(l, f))
+        {
+            fclose(f);
+            return;
+        }
+        rewind(f);
+    }
+
     while (1)
     {
         size = fread(data, 1, sizeof(data), f);
@@ -395,12 +502,22 @@ ExifData* exif_loader_get_data(ExifLoader* loader)
         return NULL;
 
     ed = exif_data_new_mem(loader->mem);
+    if (!ed)
+        return NULL;
+    exif_data_set_option(ed, loader->options);
     exif_data_log(ed, loader->log);
     exif_data_load_data(ed, loader->buf, loader->bytes_read);
 
     return ed;
 }
 
+void exif_loader_set_data_option(ExifLoader* loader, ExifDataOption o)
+{
+    if (!loader)
+        return;
+    loader->options |= o;
+}
+
 void exif_loader_log(ExifLoader* loader, ExifLog* log)
 {
     if (!loader)
@@ -0,0 +1,46 @@
+/* exif-data-priv.h
+ *
+ * Copyright  2003 Lutz Mller <lutz@users.sourceforge.net>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __EXIF_DATA_PRIV_H__
+#define __EXIF_DATA_PRIV_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <libexif/exif-data.h>
+
+    /*
+     * With EXIF_DATA_OPTION_LAZY_ENTRIES, the entries of an IFD stay in the
+     * loaded data until they are asked for. exif_content_get_entry decodes
+     * a single entry, and the functions that walk all entries first decode
+     * the rest.
+     */
+
+    ExifEntry* exif_data_load_lazy_entry(ExifData* data, ExifContent* content,
+                                         ExifTag tag);
+    void exif_data_load_lazy_entries(ExifData* data, ExifContent* content);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __EXIF_DATA_PRIV_H__ */
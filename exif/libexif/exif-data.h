@@ -89,7 +89,8 @@ extern "C"
     {
         EXIF_DATA_OPTION_IGNORE_UNKNOWN_TAGS = 1 << 0,
         EXIF_DATA_OPTION_FOLLOW_SPECIFICATION = 1 << 1,
-        EXIF_DATA_OPTION_DONT_CHANGE_MAKER_NOTE = 1 << 2
+        EXIF_DATA_OPTION_DONT_CHANGE_MAKER_NOTE = 1 << 2,
+        EXIF_DATA_OPTION_LAZY_ENTRIES = 1 << 3
     } ExifDataOption;
 
     EXIF_EXPORT const char* exif_data_option_get_name(ExifDataOption);
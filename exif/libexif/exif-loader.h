@@ -82,6 +82,14 @@ extern "C"
      */
     EXIF_EXPORT ExifData* exif_loader_get_data(ExifLoader* loader);
 
+    /*! Set an option of the ExifData returned by exif_loader_get_data, in
+     *  addition to the default options
+     * \param[in] loader the loader
+     * \param[in] o the option, for example EXIF_DATA_OPTION_LAZY_ENTRIES
+     */
+    EXIF_EXPORT void exif_loader_set_data_option(ExifLoader* loader,
+                                                 ExifDataOption o);
+
     EXIF_EXPORT void exif_loader_log(ExifLoader*, ExifLog*);
 
 #ifdef __cplusplus
@@ -88,6 +88,7 @@ class TiXmlAttribute;
 class TiXmlText;
 class TiXmlDeclaration;
 class TiXmlParsingData;
+class TiXmlStreamParser;
 
 const int TIXML_MAJOR_VERSION = 2;
 const int TIXML_MINOR_VERSION = 6;
@@ -207,6 +208,7 @@ class TiXmlBase
     friend class TiXmlNode;
     friend class TiXmlElement;
     friend class TiXmlDocument;
+    friend class TiXmlStreamParser;
 
 public:
     TiXmlBase()
@@ -1508,6 +1510,7 @@ private:
 class TiXmlText : public TiXmlNode
 {
     friend class TiXmlElement;
+    friend class TiXmlStreamParser;
 
 public:
     /** Constructor for text element. By default, it is treated as
@@ -1768,7 +1771,7 @@ public:
     /** Load a file using the given FILE*. Returns true if successful. Note that
        this method doesn't stream - the entire object pointed at by the FILE*
             will be interpreted as an XML file. TinyXML doesn't stream in XML
-       from the current file location. Streaming may be added in the future.
+       from the current file location. Use TiXmlStreamParser for that.
     */
     bool LoadFile(FILE*, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING);
     /// Save a file using the given FILE*. Returns true if successful.
@@ -2229,6 +2232,114 @@ private:
     TIXML_STRING lineBreak;
 };
 
+/** Drive a TiXmlVisitor straight from the XML text, without building a DOM.
+
+        Input is pushed in chunks of any size with Feed() and terminated with
+   Finish(), or read ChunkSize() bytes at a time from a FILE* or a memory
+   buffer by ParseFile() and Parse(). Only the chain of open elements and the
+   node being parsed are kept in memory, so memory use depends on the nesting
+   depth and the largest single tag or text run, not on the document size.
+
+        The callbacks follow TiXmlNode::Accept(): Elements get a
+   VisitEnter/VisitExit pair and leaves get Visit(). Returning false skips the
+   children or the remaining siblings exactly as Accept() does. Once the
+   document itself stops visiting, parsing ends and the rest of the input is
+   not read.
+
+        The nodes handed to the visitor are transient. An element has its
+   attributes and a valid Parent() chain, but no children, and each node is
+   deleted once its Visit() or VisitExit() returns. Clone() anything that
+   needs to be kept.
+
+        @verbatim
+        TiXmlStreamParser parser( &myVisitor );
+        if ( !parser.ParseFile( "manifest.xml" ) )
+                printf( "%s at %d\n", parser.ErrorDesc(), parser.ErrorRow() );
+        @endverbatim
+*/
+class TiXmlStreamParser
+{
+public:
+    TiXmlStreamParser(TiXmlVisitor* visitor,
+                      TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING);
+    ~TiXmlStreamParser();
+
+    /** Push the next length bytes of the document. Returns false once
+            parsing is over, either because of an error or because the
+       visitor stopped it, at which point further input is ignored.
+    */
+    bool Feed(const char* data, size_t length);
+
+    /// Signal the end of the input. Returns true if the document was good.
+    bool Finish();
+
+    /// Stream a whole file, reading it ChunkSize() bytes at a time.
+    bool ParseFile(const char* filename);
+
+    /// Stream from the current position of a FILE* to its end.
+    bool ParseFile(FILE* file);
+
+    /// Stream length bytes of memory, ChunkSize() bytes at a time.
+    bool Parse(const char* data, size_t length);
+
+    /// Drop any partial state so that a new document can be fed.
+    void Reset();
+
+    /// Set the read size used by ParseFile() and Parse(). Default 16k.
+    void SetChunkSize(size_t size) { chunkSize = size ? size : 1; }
+
+    size_t ChunkSize() const { return chunkSize; }
+
+    /// Same as TiXmlDocument::SetTabSize(). Call before feeding any input.
+    void SetTabSize(int _tabsize) { document.SetTabSize(_tabsize); }
+
+    /// True if parsing ended before the end of the document was reached.
+    bool Stopped() const { return done && stopped; }
+
+    bool Error() const { return document.Error(); } ///< See TiXmlDocument.
+    const char* ErrorDesc() const { return document.ErrorDesc(); }
+    int ErrorId() const { return document.ErrorId(); }
+    int ErrorRow() const { return document.ErrorRow(); }
+    int ErrorCol() const { return document.ErrorCol(); }
+
+private:
+    TiXmlStreamParser(const TiXmlStreamParser&); // not implemented.
+    void operator=(const TiXmlStreamParser&);    // not allowed.
+
+    void Append(const char* data, size_t length);
+    void Process(bool atEnd);
+    size_t FindEnd(int kind, size_t start);
+    bool Active(int nodeDepth) const
+    {
+        return quietDepth < 0 || nodeDepth <= quietDepth;
+    }
+    void Enter(TiXmlElement* element, bool empty);
+    void Exit();
+    void Leaf(TiXmlNode* node);
+    void Quiet(int nodeDepth);
+    void EndDocument();
+
+    TiXmlVisitor* visitor;
+    TiXmlEncoding encoding;
+    TiXmlEncoding initialEncoding;
+    TiXmlDocument document; // root of the open element chain, holds errors
+    TiXmlNode* current;
+    int depth;
+    int quietDepth; // nodes deeper than this get no callbacks
+    bool started;
+    bool done;
+    bool stopped;
+    bool sawNode;
+    bool pendingCR;
+    char* buffer;
+    size_t length;
+    size_t capacity;
+    size_t scan; // resume offset of the terminator search, from token start
+    char scanQuote;
+    size_t chunkSize;
+    TiXmlCursor cursor;
+};
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -28,6 +28,8 @@ distribution.
 
 #include "tinyxml.h"
 
+FILE* TiXmlFOpen(const char* filename, const char* mode);
+
 // #define DEBUG_PARSER
 #if defined(DEBUG_PARSER)
 #if defined(DEBUG) && defined(_MSC_VER)
@@ -190,6 +192,7 @@ void TiXmlBase::ConvertUTF32ToUTF8(unsigned long input, char* output,
 class TiXmlParsingData
 {
     friend class TiXmlDocument;
+    friend class TiXmlStreamParser;
 
 public:
     void Stamp(const char* now, TiXmlEncoding encoding);
@@ -1708,3 +1711,526 @@ bool TiXmlText::Blank() const
             return false;
     return true;
 }
+
+// What ends the token the stream parser is looking at.
+enum
+{
+    TIXML_STREAM_TEXT,    // the next '<', which is not consumed
+    TIXML_STREAM_TAG,     // a '>' outside of quotes
+    TIXML_STREAM_COMMENT, // "-->"
+    TIXML_STREAM_CDATA,   // "]]>"
+    TIXML_STREAM_OTHER    // any '>'
+};
+
+TiXmlStreamParser::TiXmlStreamParser(TiXmlVisitor* _visitor,
+                                     TiXmlEncoding _encoding)
+    : visitor(_visitor)
+    , encoding(_encoding)
+    , initialEncoding(_encoding)
+    , buffer(0)
+    , length(0)
+    , capacity(256)
+    , chunkSize(16 * 1024)
+{
+    assert(visitor);
+    buffer = new char[capacity];
+    Reset();
+}
+
+TiXmlStreamParser::~TiXmlStreamParser() { delete[] buffer; }
+
+void TiXmlStreamParser::Reset()
+{
+    document.Clear();
+    document.ClearError();
+    encoding = initialEncoding;
+    current = &document;
+    depth = 0;
+    quietDepth = -1;
+    started = false;
+    done = false;
+    stopped = false;
+    sawNode = false;
+    pendingCR = false;
+    length = 0;
+    buffer[0] = buffer[1] = buffer[2] = 0;
+    scan = 0;
+    scanQuote = 0;
+    cursor.row = 0;
+    cursor.col = 0;
+}
+
+bool TiXmlStreamParser::Feed(const char* data, size_t dataLength)
+{
+    if (done || document.Error())
+        return false;
+
+    Append(data, dataLength);
+    if (!document.Error())
+        Process(false);
+    return !done && !document.Error();
+}
+
+bool TiXmlStreamParser::Finish()
+{
+    if (!done && !document.Error())
+    {
+        Process(true);
+        if (!done && !document.Error())
+            EndDocument();
+    }
+    return !document.Error();
+}
+
+bool TiXmlStreamParser::ParseFile(const char* filename)
+{
+    // reading in binary mode so that we can normalize the EOL
+    FILE* file = TiXmlFOpen(filename, "rb");
+    if (!file)
+    {
+        Reset();
+        document.SetError(TiXmlBase::TIXML_ERROR_OPENING_FILE, 0, 0,
+                          TIXML_ENCODING_UNKNOWN);
+        return false;
+    }
+
+    bool result = ParseFile(file);
+    fclose(file);
+    return result;
+}
+
+bool TiXmlStreamParser::ParseFile(FILE* file)
+{
+    Reset();
+    if (!file)
+    {
+        document.SetError(TiXmlBase::TIXML_ERROR_OPENING_FILE, 0, 0,
+                          TIXML_ENCODING_UNKNOWN);
+        return false;
+    }
+
+    char* chunk = new char[chunkSize];
+    size_t n;
+    while ((n = fread(chunk, 1, chunkSize, file)) > 0)
+    {
+        if (!Feed(chunk, n))
+            break;
+    }
+    delete[] chunk;
+
+    if (ferror(file))
+    {
+        document.SetError(TiXmlBase::TIXML_ERROR_OPENING_FILE, 0, 0,
+                          TIXML_ENCODING_UNKNOWN);
+        return false;
+    }
+    return Finish();
+}
+
+bool TiXmlStreamParser::Parse(const char* data, size_t dataLength)
+{
+    Reset();
+    for (size_t offset = 0; offset < dataLength; offset += chunkSize)
+    {
+        size_t n = dataLength - offset;
+        if (!Feed(data + offset, n < chunkSize ? n : chunkSize))
+            break;
+    }
+    return Finish();
+}
+
+void TiXmlStreamParser::Append(const char* data, size_t dataLength)
+{
+    // Keep three zero bytes after the data: the parse routines expect null
+    // terminated text and peek up to two bytes ahead for byte order marks.
+    if (length + dataLength + 3 > capacity)
+    {
+        size_t newCapacity = capacity * 2;
+        if (newCapacity < length + dataLength + 3)
+            newCapacity = length + dataLength + 3;
+
+        char* newBuffer = new char[newCapacity];
+        memcpy(newBuffer, buffer, length);
+        delete[] buffer;
+        buffer = newBuffer;
+        capacity = newCapacity;
+    }
+
+    // Normalize the line breaks as TiXmlDocument::LoadFile() does, allowing
+    // for a CR-LF pair split across two chunks.
+    const char CR = 0x0d;
+    const char LF = 0x0a;
+    for (size_t i = 0; i < dataLength; ++i)
+    {
+        char c = data[i];
+        if (c == 0)
+        {
+            document.SetError(TiXmlBase::TIXML_ERROR_EMBEDDED_NULL, 0, 0,
+                              encoding);
+            break;
+        }
+        if (c == CR)
+        {
+            c = LF;
+            pendingCR = true;
+        }
+        else if (c == LF && pendingCR)
+        {
+            pendingCR = false;
+            continue;
+        }
+        else
+        {
+            pendingCR = false;
+        }
+        buffer[length++] = c;
+    }
+    buffer[length] = buffer[length + 1] = buffer[length + 2] = 0;
+}
+
+size_t TiXmlStreamParser::FindEnd(int kind, size_t start)
+{
+    // Offset of the first '>' that can close a comment or a CDATA section.
+    const size_t minEnd = kind == TIXML_STREAM_COMMENT ? 6
+                          : kind == TIXML_STREAM_CDATA ? 11
+                                                       : 0;
+
+    for (size_t i = start + scan; i < length; ++i)
+    {
+        const char c = buffer[i];
+        switch (kind)
+        {
+        case TIXML_STREAM_TEXT:
+            if (c == '<')
+                return i;
+            break;
+
+        case TIXML_STREAM_TAG:
+            if (scanQuote)
+            {
+                if (c == scanQuote)
+                    scanQuote = 0;
+            }
+            else if (c == '\"' || c == '\'')
+                scanQuote = c;
+            else if (c == '>')
+                return i + 1;
+            break;
+
+        case TIXML_STREAM_COMMENT:
+        case TIXML_STREAM_CDATA:
+            if (c == '>' && i - start >= minEnd)
+            {
+                const char close = kind == TIXML_STREAM_COMMENT ? '-' : ']';
+                if (buffer[i - 1] == close && buffer[i - 2] == close)
+                    return i + 1;
+            }
+            break;
+
+        default:
+            if (c == '>')
+                return i + 1;
+            break;
+        }
+    }
+
+    // Not there yet: carry on from here when more data arrives.
+    scan = length - start;
+    return 0;
+}
+
+void TiXmlStreamParser::Process(bool atEnd)
+{
+    TiXmlParsingData data(buffer, document.TabSize(), cursor.row, cursor.col);
+    size_t pos = 0;
+
+    while (!done && !document.Error())
+    {
+        const char* p = buffer + pos;
+
+        if (!started)
+        {
+            // Wait for enough data to look for the Microsoft UTF-8 lead bytes.
+            if (length < 3 && !atEnd)
+                break;
+
+            const unsigned char* pU = (const unsigned char*)p;
+            if (encoding == TIXML_ENCODING_UNKNOWN && pU[0] == TIXML_UTF_LEAD_0
+                && pU[1] == TIXML_UTF_LEAD_1 && pU[2] == TIXML_UTF_LEAD_2)
+            {
+                encoding = TIXML_ENCODING_UTF8;
+            }
+
+            started = true;
+            if (!visitor->VisitEnter(document))
+                Quiet(0);
+            continue;
+        }
+
+        if (depth == 0)
+        {
+            p = TiXmlBase::SkipWhiteSpace(p, encoding);
+            if (!p || !*p)
+            {
+                pos = length;
+                break;
+            }
+            pos = p - buffer;
+
+            // Like TiXmlDocument::Parse(), stop at anything that isn't a node.
+            if (*p != '<')
+            {
+                EndDocument();
+                break;
+            }
+        }
+        else if (*p != '<')
+        {
+            size_t end = FindEnd(TIXML_STREAM_TEXT, pos);
+            if (!end)
+            {
+                if (atEnd)
+                    document.SetError(TiXmlBase::TIXML_ERROR_READING_END_TAG,
+                                      buffer + length, &data, encoding);
+                break;
+            }
+
+            // White space between tags is not a text node.
+            const char* q = TiXmlBase::SkipWhiteSpace(p, encoding);
+            if (q < buffer + end)
+            {
+                TiXmlText* text = new TiXmlText("");
+                current->LinkEndChild(text);
+                if (!text->Parse(TiXmlBase::IsWhiteSpaceCondensed() ? q : p,
+                                 &data, encoding))
+                {
+                    document.SetError(
+                        TiXmlBase::TIXML_ERROR_READING_ELEMENT_VALUE, p, &data,
+                        encoding);
+                    break;
+                }
+
+                if (text->Blank())
+                    current->RemoveChild(text);
+                else
+                    Leaf(text);
+            }
+            pos = end;
+            scan = 0;
+            continue;
+        }
+
+        // Enough to tell the markup apart, see TiXmlNode::Identify().
+        if (length - pos < 9 && !atEnd)
+            break;
+
+        int kind = TIXML_STREAM_OTHER;
+        TiXmlNode* node = 0;
+        bool endTag = false;
+        bool element = false;
+
+        if (depth > 0 && p[1] == '/')
+            endTag = true;
+        else if (TiXmlBase::StringEqual(p, "<?xml", true, encoding))
+            kind = TIXML_STREAM_TAG;
+        else if (TiXmlBase::StringEqual(p, "<!--", false, encoding))
+            kind = TIXML_STREAM_COMMENT;
+        else if (TiXmlBase::StringEqual(p, "<![CDATA[", false, encoding))
+            kind = TIXML_STREAM_CDATA;
+        else if (TiXmlBase::StringEqual(p, "<!", false, encoding))
+            kind = TIXML_STREAM_OTHER;
+        else if (TiXmlBase::IsAlpha(*(p + 1), encoding) || *(p + 1) == '_')
+            element = true;
+
+        if (element)
+            kind = TIXML_STREAM_TAG;
+
+        size_t end = FindEnd(kind, pos);
+        if (!end && !atEnd)
+            break;
+
+        if (endTag)
+        {
+            // </foo > and </foo> are both valid end tags.
+            const char* name = current->Value();
+            const size_t nameLength = strlen(name);
+            const char* q = p + 2;
+            if (end && strncmp(q, name, nameLength) == 0)
+                q = TiXmlBase::SkipWhiteSpace(q + nameLength, encoding);
+
+            if (!end || !q || *q != '>')
+            {
+                document.SetError(TiXmlBase::TIXML_ERROR_READING_END_TAG, p,
+                                  &data, encoding);
+                break;
+            }
+            Exit();
+        }
+        else if (element)
+        {
+            TiXmlElement* e = new TiXmlElement("");
+            current->LinkEndChild(e);
+
+            // Show TiXmlElement::Parse() a start tag as an empty tag, so that
+            // it stops after the attributes instead of reading the contents.
+            // The byte after the tag is always there: at worst it is one of
+            // the zeros after the data.
+            const bool empty = end && buffer[end - 2] == '/';
+            const bool open = end && !empty;
+            char saved = 0;
+            if (open)
+            {
+                saved = buffer[end];
+                buffer[end - 1] = '/';
+                buffer[end] = '>';
+            }
+
+            const char* r = e->Parse(p, &data, encoding);
+
+            if (open)
+            {
+                buffer[end - 1] = '>';
+                buffer[end] = saved;
+            }
+            if (!r || document.Error())
+                break;
+            if (!end)
+                end = r - buffer;
+
+            Enter(e, !open);
+        }
+        else
+        {
+            if (kind == TIXML_STREAM_TAG)
+                node = new TiXmlDeclaration();
+            else if (kind == TIXML_STREAM_COMMENT)
+                node = new TiXmlComment();
+            else if (kind == TIXML_STREAM_CDATA)
+            {
+                TiXmlText* text = new TiXmlText("");
+                text->SetCDATA(true);
+                node = text;
+            }
+            else
+                node = new TiXmlUnknown();
+
+            current->LinkEndChild(node);
+            const char* r = node->Parse(p, &data, encoding);
+            if (!r || document.Error())
+                break;
+            if (!end)
+                end = r - buffer;
+
+            // Did we get encoding info?
+            if (depth == 0 && encoding == TIXML_ENCODING_UNKNOWN
+                && node->ToDeclaration())
+            {
+                const char* enc = node->ToDeclaration()->Encoding();
+                if (*enc == 0
+                    || TiXmlBase::StringEqual(enc, "UTF-8", true,
+                                              TIXML_ENCODING_UNKNOWN)
+                    || TiXmlBase::StringEqual(enc, "UTF8", true,
+                                              TIXML_ENCODING_UNKNOWN))
+                    encoding = TIXML_ENCODING_UTF8;
+                else
+                    encoding = TIXML_ENCODING_LEGACY;
+            }
+
+            Leaf(node);
+        }
+
+        pos = end;
+        scan = 0;
+        scanQuote = 0;
+    }
+
+    if (done)
+    {
+        length = 0;
+        buffer[0] = 0;
+        return;
+    }
+
+    // Drop what has been consumed, remembering where in the file it ended.
+    if (pos)
+    {
+        data.Stamp(buffer + pos, encoding);
+        cursor = data.Cursor();
+        length -= pos;
+        memmove(buffer, buffer + pos, length + 3);
+    }
+}
+
+void TiXmlStreamParser::Enter(TiXmlElement* element, bool empty)
+{
+    sawNode = true;
+    current = element;
+    ++depth;
+
+    if (Active(depth)
+        && !visitor->VisitEnter(*element, element->FirstAttribute()))
+        quietDepth = depth;
+
+    if (empty)
+        Exit();
+}
+
+void TiXmlStreamParser::Exit()
+{
+    const bool more =
+        !Active(depth) || visitor->VisitExit(*current->ToElement());
+    if (quietDepth == depth)
+        quietDepth = -1;
+
+    TiXmlNode* parent = current->Parent();
+    parent->RemoveChild(current);
+    current = parent;
+    --depth;
+
+    if (!more)
+        Quiet(depth);
+}
+
+void TiXmlStreamParser::Leaf(TiXmlNode* node)
+{
+    sawNode = true;
+    const bool more = !Active(depth + 1) || node->Accept(visitor);
+    current->RemoveChild(node);
+
+    if (!more)
+        Quiet(depth);
+}
+
+void TiXmlStreamParser::Quiet(int nodeDepth)
+{
+    // The children of the node at nodeDepth are skipped from now on. For
+    // the document that means we are done.
+    quietDepth = nodeDepth;
+    if (nodeDepth == 0)
+    {
+        stopped = true;
+        EndDocument();
+    }
+}
+
+void TiXmlStreamParser::EndDocument()
+{
+    if (!stopped)
+    {
+        if (depth > 0)
+        {
+            document.SetError(TiXmlBase::TIXML_ERROR_READING_END_TAG, 0, 0,
+                              encoding);
+            return;
+        }
+        if (!sawNode)
+        {
+            document.SetError(TiXmlBase::TIXML_ERROR_DOCUMENT_EMPTY, 0, 0,
+                              encoding);
+            return;
+        }
+    }
+
+    visitor->VisitExit(document);
+    done = true;
+}
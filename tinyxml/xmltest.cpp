@@ -67,6 +67,87 @@ bool XmlTest(const char* testString, int expected, int found, bool noEcho)
     return pass;
 }
 
+// Records the callbacks it gets, to compare a streamed parse with a DOM walk.
+class XmlEventRecorder : public TiXmlVisitor
+{
+public:
+    XmlEventRecorder(const char* _stopAt = 0)
+        : stopAt(_stopAt)
+    {
+    }
+
+    virtual bool VisitEnter(const TiXmlDocument&)
+    {
+        events += "[doc]";
+        return true;
+    }
+
+    virtual bool VisitExit(const TiXmlDocument&)
+    {
+        events += "[/doc]";
+        return true;
+    }
+
+    virtual bool VisitEnter(const TiXmlElement& element,
+                            const TiXmlAttribute* attribute)
+    {
+        events += "<";
+        events += element.Value();
+        for (; attribute; attribute = attribute->Next())
+        {
+            events += " ";
+            events += attribute->Name();
+            events += "=";
+            events += attribute->Value();
+        }
+        events += ">";
+        return !stopAt || strcmp(stopAt, element.Value()) != 0;
+    }
+
+    virtual bool VisitExit(const TiXmlElement& element)
+    {
+        events += "</";
+        events += element.Value();
+        events += ">";
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlDeclaration& declaration)
+    {
+        events += "[?";
+        events += declaration.Version();
+        events += "]";
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlText& text)
+    {
+        events += text.CDATA() ? "[cdata:" : "[text:";
+        events += text.Value();
+        events += "]";
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlComment& comment)
+    {
+        events += "[!";
+        events += comment.Value();
+        events += "]";
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlUnknown& unknown)
+    {
+        events += "[unknown:";
+        events += unknown.Value();
+        events += "]";
+        return true;
+    }
+
+    const char* stopAt;
+    TIXML_STRING events;
+};
+
 //
 // This file demonstrates some basic functionality of TinyXml.
 // Note that the example is very contrived. It presumes you know
@@ -1406,6 +1487,62 @@ int main()
         }*/
     }
 
+    {
+        // Streaming parse: the same callbacks as a DOM walk, however the
+        // input is chunked.
+        const char* xml =
+            "<?xml version=\"1.0\"?>\r\n"
+            "<!-- manifest -->"
+            "<shots show='demo' note=\"a > b\">\r\n"
+            "  <shot name='sh010'>plate &amp; grade</shot>\n"
+            "  <shot name='sh020'/><![CDATA[ <raw> ]]>"
+            "<!DOCTYPE ignored>"
+            "</shots >";
+
+        TiXmlDocument doc;
+        doc.Parse(xml);
+        XmlEventRecorder domEvents;
+        doc.Accept(&domEvents);
+
+        const size_t chunkSizes[] = {1, 2, 3, 7, 64, 16 * 1024};
+        for (size_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++i)
+        {
+            XmlEventRecorder streamEvents;
+            TiXmlStreamParser parser(&streamEvents);
+            parser.SetChunkSize(chunkSizes[i]);
+            XmlTest("Stream parse chunked.", true,
+                    parser.Parse(xml, strlen(xml)));
+            XmlTest("Stream parse chunked.", domEvents.events.c_str(),
+                    streamEvents.events.c_str(), true);
+        }
+
+        XmlEventRecorder stopEvents("shots");
+        TiXmlStreamParser stopParser(&stopEvents);
+        XmlTest("Stream parse skips children.", true,
+                stopParser.Parse(xml, strlen(xml)));
+        XmlTest("Stream parse skips children.",
+                "[doc][?1.0][! manifest ]<shots show=demo note=a > b></shots>"
+                "[/doc]",
+                stopEvents.events.c_str());
+
+        XmlEventRecorder errorEvents;
+        TiXmlStreamParser errorParser(&errorEvents);
+        errorParser.SetChunkSize(4);
+        const char* bad = "<a>\n<b></a>";
+        XmlTest("Stream parse mismatched end tag.", false,
+                errorParser.Parse(bad, strlen(bad)));
+        XmlTest("Stream parse mismatched end tag.",
+                TiXmlBase::TIXML_ERROR_READING_END_TAG, errorParser.ErrorId());
+        XmlTest("Stream parse error row.", 2, errorParser.ErrorRow());
+        XmlTest("Stream parse error col.", 4, errorParser.ErrorCol());
+
+        errorParser.Parse("<a>", 3);
+        XmlTest("Stream parse missing end tag.", true, errorParser.Error());
+        errorParser.Parse("  ", 2);
+        XmlTest("Stream parse empty document.",
+                TiXmlBase::TIXML_ERROR_DOCUMENT_EMPTY, errorParser.ErrorId());
+    }
+
 /*  1417717 experiment
 {
         TiXmlDocument xml;
@@ -110,6 +110,175 @@ yaml_strdup(const yaml_char_t* str)
 #endif
 }
 
+/*
+ * An arena block.  The allocations follow the header.
+ */
+
+struct yaml_arena_block_s
+{
+    struct yaml_arena_block_s* next;
+    size_t size;
+    size_t used;
+};
+
+#define ARENA_ALIGNMENT 16
+
+#define ARENA_ALIGN(size) \
+    (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+#define ARENA_HEADER_SIZE ARENA_ALIGN(sizeof(struct yaml_arena_block_s))
+
+#define ARENA_INITIAL_SIZE 65536
+
+#define ARENA_MAXIMUM_SIZE 4194304
+
+/*
+ * Allocate a block with the document allocator.
+ */
+
+static void* yaml_document_memory_malloc(yaml_document_memory_t* memory,
+                                         size_t size)
+{
+    if (memory->malloc_handler)
+        return memory->malloc_handler(memory->data, size ? size : 1);
+
+    return yaml_malloc(size);
+}
+
+/*
+ * Free a block with the document allocator.
+ */
+
+static void yaml_document_memory_free(yaml_document_memory_t* memory,
+                                      void* ptr)
+{
+    if (!ptr)
+        return;
+
+    if (!memory->malloc_handler)
+        yaml_free(ptr);
+    else if (memory->free_handler)
+        memory->free_handler(memory->data, ptr);
+}
+
+/*
+ * Allocate a dynamic memory block owned by a document.
+ */
+
+YAML_DECLARE(void*)
+
+yaml_document_malloc(yaml_document_t* document, size_t size)
+{
+    yaml_document_memory_t* memory = &document->memory;
+    struct yaml_arena_block_s* block = memory->blocks;
+    void* ptr;
+
+    if (!memory->arena)
+        return yaml_document_memory_malloc(memory, size);
+
+    if (size > (size_t)-1 - ARENA_HEADER_SIZE - ARENA_ALIGNMENT)
+        return NULL;
+    size = size ? ARENA_ALIGN(size) : ARENA_ALIGNMENT;
+
+    if (!block || block->size - block->used < size)
+    {
+        size_t block_size = ARENA_INITIAL_SIZE;
+
+        if (block)
+        {
+            block_size = block->size * 2;
+            if (block_size > ARENA_MAXIMUM_SIZE)
+                block_size = ARENA_MAXIMUM_SIZE;
+        }
+
+        /* Oversized requests get a block of their own. */
+
+        if (size > block_size / 4)
+        {
+            block = yaml_document_memory_malloc(memory,
+                                                ARENA_HEADER_SIZE + size);
+            if (!block)
+                return NULL;
+
+            block->size = block->used = size;
+            if (memory->blocks)
+            {
+                block->next = memory->blocks->next;
+                memory->blocks->next = block;
+            }
+            else
+            {
+                block->next = NULL;
+                memory->blocks = block;
+            }
+
+            return (char*)block + ARENA_HEADER_SIZE;
+        }
+
+        block =
+            yaml_document_memory_malloc(memory, ARENA_HEADER_SIZE + block_size);
+        if (!block)
+            return NULL;
+
+        block->next = memory->blocks;
+        block->size = block_size;
+        block->used = 0;
+        memory->blocks = block;
+    }
+
+    ptr = (char*)block + ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+
+    return ptr;
+}
+
+/*
+ * Free a dynamic memory block owned by a document.  Arena allocations are
+ * only released with the whole document.
+ */
+
+YAML_DECLARE(void)
+
+yaml_document_free(yaml_document_t* document, void* ptr)
+{
+    if (!document->memory.arena)
+        yaml_document_memory_free(&document->memory, ptr);
+}
+
+/*
+ * Copy a string into the document memory.
+ */
+
+YAML_DECLARE(yaml_char_t*)
+
+yaml_document_strndup(yaml_document_t* document, const yaml_char_t* str,
+                      size_t length)
+{
+    yaml_char_t* copy = yaml_document_malloc(document, length + 1);
+
+    if (!copy)
+        return NULL;
+
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+/*
+ * Release the arena blocks of a document.
+ */
+
+static void yaml_document_delete_arena(yaml_document_t* document)
+{
+    while (document->memory.blocks)
+    {
+        struct yaml_arena_block_s* next = document->memory.blocks->next;
+        yaml_document_memory_free(&document->memory, document->memory.blocks);
+        document->memory.blocks = next;
+    }
+}
+
 /*
  * Extend a string.
  */
@@ -178,6 +347,35 @@ yaml_stack_extend(void** start, void** top, void** end)
     return 1;
 }
 
+/*
+ * Extend a stack owned by a document.
+ */
+
+YAML_DECLARE(int)
+
+yaml_document_stack_extend(yaml_document_t* document, void** start,
+                           void** top, void** end)
+{
+    size_t size = (char*)*end - (char*)*start;
+    void* new_start;
+
+    if (DOCUMENT_MALLOC(document))
+        return yaml_stack_extend(start, top, end);
+
+    new_start = yaml_document_malloc(document, size * 2);
+    if (!new_start)
+        return 0;
+
+    memcpy(new_start, *start, size);
+    yaml_document_free(document, *start);
+
+    *top = (char*)new_start + ((char*)*top - (char*)*start);
+    *end = (char*)new_start + size * 2;
+    *start = new_start;
+
+    return 1;
+}
+
 /*
  * Extend or move a queue.
  */
@@ -355,6 +553,53 @@ yaml_parser_set_input_string(yaml_parser_t* parser, const unsigned char* input,
     parser->input.string.end = input + size;
 }
 
+/*
+ * Return plain scalars as views into the input string.
+ */
+
+YAML_DECLARE(void)
+
+yaml_parser_set_scalar_views(yaml_parser_t* parser, int enable)
+{
+    assert(parser); /* Non-NULL parser object expected. */
+    assert(parser->read_handler
+           == yaml_string_read_handler); /* A string input expected. */
+
+    parser->scalar_views = enable;
+}
+
+/*
+ * Set the allocator of the loaded documents.
+ */
+
+YAML_DECLARE(void)
+
+yaml_parser_set_document_allocator(yaml_parser_t* parser,
+                                   yaml_malloc_handler_t* malloc_handler,
+                                   yaml_free_handler_t* free_handler,
+                                   void* data)
+{
+    assert(parser); /* Non-NULL parser object expected. */
+    assert(malloc_handler || !free_handler); /* No lone free handler. */
+
+    parser->document_memory.malloc_handler = malloc_handler;
+    parser->document_memory.free_handler = free_handler;
+    parser->document_memory.data = data;
+}
+
+/*
+ * Allocate the loaded documents from an arena.
+ */
+
+YAML_DECLARE(void)
+
+yaml_parser_set_document_arena(yaml_parser_t* parser, int enable)
+{
+    assert(parser); /* Non-NULL parser object expected. */
+
+    parser->document_memory.arena = enable;
+}
+
 /*
  * Set a file input.
  */
@@ -679,7 +924,8 @@ yaml_token_delete(yaml_token_t* token)
         break;
 
     case YAML_SCALAR_TOKEN:
-        yaml_free(token->data.scalar.value);
+        if (!token->data.scalar.view)
+            yaml_free(token->data.scalar.value);
         break;
 
     default:
@@ -1130,7 +1376,8 @@ yaml_event_delete(yaml_event_t* event)
     case YAML_SCALAR_EVENT:
         yaml_free(event->data.scalar.anchor);
         yaml_free(event->data.scalar.tag);
-        yaml_free(event->data.scalar.value);
+        if (!event->data.scalar.view)
+            yaml_free(event->data.scalar.value);
         break;
 
     case YAML_SEQUENCE_START_EVENT:
@@ -1271,26 +1518,33 @@ yaml_document_delete(yaml_document_t* document)
 
     assert(document); /* Non-NULL document object is expected. */
 
-    while (!STACK_EMPTY(&context, document->nodes))
+    if (document->memory.arena)
+    {
+        yaml_document_delete_arena(document);
+    }
+    else
     {
-        yaml_node_t node = POP(&context, document->nodes);
-        yaml_free(node.tag);
-        switch (node.type)
+        while (!STACK_EMPTY(&context, document->nodes))
         {
-        case YAML_SCALAR_NODE:
-            yaml_free(node.data.scalar.value);
-            break;
-        case YAML_SEQUENCE_NODE:
-            STACK_DEL(&context, node.data.sequence.items);
-            break;
-        case YAML_MAPPING_NODE:
-            STACK_DEL(&context, node.data.mapping.pairs);
-            break;
-        default:
-            assert(0); /* Should not happen. */
+            yaml_node_t node = POP(&context, document->nodes);
+            yaml_document_free(document, node.tag);
+            switch (node.type)
+            {
+            case YAML_SCALAR_NODE:
+                yaml_document_free(document, node.data.scalar.value);
+                break;
+            case YAML_SEQUENCE_NODE:
+                DOCUMENT_STACK_DEL(document, node.data.sequence.items);
+                break;
+            case YAML_MAPPING_NODE:
+                DOCUMENT_STACK_DEL(document, node.data.mapping.pairs);
+                break;
+            default:
+                assert(0); /* Should not happen. */
+            }
         }
+        DOCUMENT_STACK_DEL(document, document->nodes);
     }
-    STACK_DEL(&context, document->nodes);
 
     yaml_free(document->version_directive);
     for (tag_directive = document->tag_directives.start;
@@ -1368,7 +1622,7 @@ yaml_document_add_scalar(yaml_document_t* document, yaml_char_t* tag,
 
     if (!yaml_check_utf8(tag, strlen((char*)tag)))
         goto error;
-    tag_copy = yaml_strdup(tag);
+    tag_copy = yaml_document_strndup(document, tag, strlen((char*)tag));
     if (!tag_copy)
         goto error;
 
@@ -1379,21 +1633,19 @@ yaml_document_add_scalar(yaml_document_t* document, yaml_char_t* tag,
 
     if (!yaml_check_utf8(value, length))
         goto error;
-    value_copy = yaml_malloc(length + 1);
+    value_copy = yaml_document_strndup(document, value, length);
     if (!value_copy)
         goto error;
-    memcpy(value_copy, value, length);
-    value_copy[length] = '\0';
 
     SCALAR_NODE_INIT(node, tag_copy, value_copy, length, style, mark, mark);
-    if (!PUSH(&context, document->nodes, node))
+    if (!DOCUMENT_PUSH(&context, document, document->nodes, node))
         goto error;
 
     return document->nodes.top - document->nodes.start;
 
 error:
-    yaml_free(tag_copy);
-    yaml_free(value_copy);
+    yaml_document_free(document, tag_copy);
+    yaml_document_free(document, value_copy);
 
     return 0;
 }
@@ -1433,23 +1685,23 @@ yaml_document_add_sequence(yaml_document_t* document, yaml_char_t* tag,
 
     if (!yaml_check_utf8(tag, strlen((char*)tag)))
         goto error;
-    tag_copy = yaml_strdup(tag);
+    tag_copy = yaml_document_strndup(document, tag, strlen((char*)tag));
     if (!tag_copy)
         goto error;
 
-    if (!STACK_INIT(&context, items, INITIAL_STACK_SIZE))
+    if (!DOCUMENT_STACK_INIT(&context, document, items, INITIAL_STACK_SIZE))
         goto error;
 
     SEQUENCE_NODE_INIT(node, tag_copy, items.start, items.end, style, mark,
                        mark);
-    if (!PUSH(&context, document->nodes, node))
+    if (!DOCUMENT_PUSH(&context, document, document->nodes, node))
         goto error;
 
     return document->nodes.top - document->nodes.start;
 
 error:
-    STACK_DEL(&context, items);
-    yaml_free(tag_copy);
+    DOCUMENT_STACK_DEL(document, items);
+    yaml_document_free(document, tag_copy);
 
     return 0;
 }
@@ -1489,23 +1741,23 @@ yaml_document_add_mapping(yaml_document_t* document, yaml_char_t* tag,
 
     if (!yaml_check_utf8(tag, strlen((char*)tag)))
         goto error;
-    tag_copy = yaml_strdup(tag);
+    tag_copy = yaml_document_strndup(document, tag, strlen((char*)tag));
     if (!tag_copy)
         goto error;
 
-    if (!STACK_INIT(&context, pairs, INITIAL_STACK_SIZE))
+    if (!DOCUMENT_STACK_INIT(&context, document, pairs, INITIAL_STACK_SIZE))
         goto error;
 
     MAPPING_NODE_INIT(node, tag_copy, pairs.start, pairs.end, style, mark,
                       mark);
-    if (!PUSH(&context, document->nodes, node))
+    if (!DOCUMENT_PUSH(&context, document, document->nodes, node))
         goto error;
 
     return document->nodes.top - document->nodes.start;
 
 error:
-    STACK_DEL(&context, pairs);
-    yaml_free(tag_copy);
+    DOCUMENT_STACK_DEL(document, pairs);
+    yaml_document_free(document, tag_copy);
 
     return 0;
 }
@@ -1533,8 +1785,9 @@ yaml_document_append_sequence_item(yaml_document_t* document, int sequence,
     assert(item > 0 && document->nodes.start + item <= document->nodes.top);
     /* Valid item id is required. */
 
-    if (!PUSH(&context, document->nodes.start[sequence - 1].data.sequence.items,
-              item))
+    if (!DOCUMENT_PUSH(&context, document,
+                       document->nodes.start[sequence - 1].data.sequence.items,
+                       item))
         return 0;
 
     return 1;
@@ -1570,8 +1823,9 @@ yaml_document_append_mapping_pair(yaml_document_t* document, int mapping,
     pair.key = key;
     pair.value = value;
 
-    if (!PUSH(&context, document->nodes.start[mapping - 1].data.mapping.pairs,
-              pair))
+    if (!DOCUMENT_PUSH(&context, document,
+                       document->nodes.start[mapping - 1].data.mapping.pairs,
+                       pair))
         return 0;
 
     return 1;
@@ -20,6 +20,10 @@ yaml_emitter_dump(yaml_emitter_t* emitter, yaml_document_t* document);
 
 static void yaml_emitter_delete_document_and_anchors(yaml_emitter_t* emitter);
 
+static yaml_char_t* yaml_emitter_take_string(yaml_emitter_t* emitter,
+                                             yaml_char_t* string,
+                                             size_t length);
+
 /*
  * Anchor functions.
  */
@@ -183,6 +187,25 @@ static void yaml_emitter_delete_document_and_anchors(yaml_emitter_t* emitter)
         return;
     }
 
+    /*
+     * The events have taken over the directives.  The node strings of a
+     * document with its own memory were copied, so they are still there.
+     */
+
+    if (!DOCUMENT_MALLOC(emitter->document))
+    {
+        emitter->document->version_directive = NULL;
+        emitter->document->tag_directives.start = NULL;
+        emitter->document->tag_directives.end = NULL;
+        yaml_document_delete(emitter->document);
+        yaml_free(emitter->anchors);
+
+        emitter->anchors = NULL;
+        emitter->last_anchor_id = 0;
+        emitter->document = NULL;
+        return;
+    }
+
     for (index = 0;
          emitter->document->nodes.start + index < emitter->document->nodes.top;
          index++)
@@ -214,6 +237,32 @@ static void yaml_emitter_delete_document_and_anchors(yaml_emitter_t* emitter)
     emitter->document = NULL;
 }
 
+/*
+ * Hand a node string over to an event, which frees it.  The strings in the
+ * memory of the document itself are copied.
+ */
+
+static yaml_char_t* yaml_emitter_take_string(yaml_emitter_t* emitter,
+                                             yaml_char_t* string,
+                                             size_t length)
+{
+    yaml_char_t* copy;
+
+    if (DOCUMENT_MALLOC(emitter->document))
+        return string;
+
+    copy = yaml_malloc(length + 1);
+    if (!copy)
+    {
+        emitter->error = YAML_MEMORY_ERROR;
+        return NULL;
+    }
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
 /*
  * Check the references of a node and assign the anchor id if needed.
  */
@@ -345,9 +394,22 @@ static int yaml_emitter_dump_scalar(yaml_emitter_t* emitter, yaml_node_t* node,
     int quoted_implicit =
         (strcmp((char*)node->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
 
-    SCALAR_EVENT_INIT(event, anchor, node->tag, node->data.scalar.value,
-                      node->data.scalar.length, plain_implicit, quoted_implicit,
-                      node->data.scalar.style, mark, mark);
+    yaml_char_t* tag =
+        yaml_emitter_take_string(emitter, node->tag, strlen((char*)node->tag));
+    yaml_char_t* value = yaml_emitter_take_string(
+        emitter, node->data.scalar.value, node->data.scalar.length);
+
+    if (!tag || !value)
+    {
+        yaml_free(anchor);
+        yaml_free(tag);
+        yaml_free(value);
+        return 0;
+    }
+
+    SCALAR_EVENT_INIT(event, anchor, tag, value, node->data.scalar.length,
+                      plain_implicit, quoted_implicit, node->data.scalar.style,
+                      mark, mark);
 
     return yaml_emitter_emit(emitter, &event);
 }
@@ -366,7 +428,16 @@ static int yaml_emitter_dump_sequence(yaml_emitter_t* emitter,
 
     yaml_node_item_t* item;
 
-    SEQUENCE_START_EVENT_INIT(event, anchor, node->tag, implicit,
+    yaml_char_t* tag =
+        yaml_emitter_take_string(emitter, node->tag, strlen((char*)node->tag));
+
+    if (!tag)
+    {
+        yaml_free(anchor);
+        return 0;
+    }
+
+    SEQUENCE_START_EVENT_INIT(event, anchor, tag, implicit,
                               node->data.sequence.style, mark, mark);
     if (!yaml_emitter_emit(emitter, &event))
         return 0;
@@ -399,7 +470,16 @@ static int yaml_emitter_dump_mapping(yaml_emitter_t* emitter, yaml_node_t* node,
 
     yaml_node_pair_t* pair;
 
-    MAPPING_START_EVENT_INIT(event, anchor, node->tag, implicit,
+    yaml_char_t* tag =
+        yaml_emitter_take_string(emitter, node->tag, strlen((char*)node->tag));
+
+    if (!tag)
+    {
+        yaml_free(anchor);
+        return 0;
+    }
+
+    MAPPING_START_EVENT_INIT(event, anchor, tag, implicit,
                              node->data.mapping.style, mark, mark);
     if (!yaml_emitter_emit(emitter, &event))
         return 0;
@@ -29,6 +29,19 @@ static int yaml_parser_set_composer_error_context(yaml_parser_t* parser,
 static int yaml_parser_register_anchor(yaml_parser_t* parser, int index,
                                        yaml_char_t* anchor);
 
+static yaml_alias_data_t* yaml_parser_find_anchor(yaml_parser_t* parser,
+                                                  yaml_char_t* anchor);
+
+static int yaml_parser_index_anchor(yaml_parser_t* parser, int position);
+
+/*
+ * Document memory.
+ */
+
+static yaml_char_t* yaml_parser_adopt_string(yaml_parser_t* parser,
+                                             yaml_char_t* string,
+                                             size_t length, int borrowed);
+
 /*
  * Clean up functions.
  */
@@ -71,7 +84,10 @@ yaml_parser_load(yaml_parser_t* parser, yaml_document_t* document)
     assert(document); /* Non-NULL document object is expected. */
 
     memset(document, 0, sizeof(yaml_document_t));
-    if (!STACK_INIT(parser, document->nodes, INITIAL_STACK_SIZE))
+    document->memory = parser->document_memory;
+    document->memory.blocks = NULL;
+    if (!DOCUMENT_STACK_INIT(parser, document, document->nodes,
+                             INITIAL_STACK_SIZE))
         goto error;
 
     if (!parser->stream_start_produced)
@@ -161,6 +177,34 @@ static void yaml_parser_delete_aliases(yaml_parser_t* parser)
         yaml_free(POP(parser, parser->aliases).anchor);
     }
     STACK_DEL(parser, parser->aliases);
+
+    yaml_free(parser->anchors.slots);
+    parser->anchors.slots = NULL;
+    parser->anchors.size = 0;
+}
+
+/*
+ * Move a string of an event into the memory of the document.  The event
+ * string is released (unless it is borrowed) even if the copy fails.
+ */
+
+static yaml_char_t* yaml_parser_adopt_string(yaml_parser_t* parser,
+                                             yaml_char_t* string,
+                                             size_t length, int borrowed)
+{
+    yaml_char_t* copy;
+
+    if (!borrowed && DOCUMENT_MALLOC(parser->document))
+        return string;
+
+    copy = yaml_document_strndup(parser->document, string, length);
+    if (!copy)
+        parser->error = YAML_MEMORY_ERROR;
+
+    if (!borrowed)
+        yaml_free(string);
+
+    return copy;
 }
 
 /*
@@ -227,6 +271,94 @@ static int yaml_parser_load_node(yaml_parser_t* parser,
     return 0;
 }
 
+/*
+ * Hash an anchor (FNV-1a).
+ */
+
+static size_t yaml_anchor_hash(const yaml_char_t* anchor)
+{
+    size_t hash = 2166136261u;
+
+    while (*anchor)
+    {
+        hash ^= *anchor++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+ * Find the alias data of an anchor.
+ */
+
+static yaml_alias_data_t* yaml_parser_find_anchor(yaml_parser_t* parser,
+                                                  yaml_char_t* anchor)
+{
+    size_t mask = parser->anchors.size - 1;
+    size_t slot;
+
+    if (!parser->anchors.size)
+        return NULL;
+
+    for (slot = yaml_anchor_hash(anchor) & mask;
+         parser->anchors.slots[slot]; slot = (slot + 1) & mask)
+    {
+        yaml_alias_data_t* alias_data =
+            parser->aliases.start + parser->anchors.slots[slot] - 1;
+
+        if (strcmp((char*)alias_data->anchor, (char*)anchor) == 0)
+            return alias_data;
+    }
+
+    return NULL;
+}
+
+/*
+ * Add the alias data at the given position of the list to the hash index.
+ */
+
+static int yaml_parser_index_anchor(yaml_parser_t* parser, int position)
+{
+    size_t mask;
+    size_t slot;
+
+    /* Keep the index at most half full, so that the probes stay short. */
+
+    if ((size_t)(position + 1) * 2 > parser->anchors.size)
+    {
+        size_t size = parser->anchors.size ? parser->anchors.size * 2
+                                           : INITIAL_STACK_SIZE * 2;
+        int* slots = yaml_malloc(size * sizeof(*slots));
+        int other;
+
+        if (!slots)
+        {
+            parser->error = YAML_MEMORY_ERROR;
+            return 0;
+        }
+        memset(slots, 0, size * sizeof(*slots));
+
+        yaml_free(parser->anchors.slots);
+        parser->anchors.slots = slots;
+        parser->anchors.size = size;
+
+        for (other = 0; other < position; other++)
+        {
+            if (!yaml_parser_index_anchor(parser, other))
+                return 0;
+        }
+    }
+
+    mask = parser->anchors.size - 1;
+    for (slot = yaml_anchor_hash(parser->aliases.start[position].anchor) & mask;
+         parser->anchors.slots[slot]; slot = (slot + 1) & mask)
+        ;
+    parser->anchors.slots[slot] = position + 1;
+
+    return 1;
+}
+
 /*
  * Add an anchor.
  */
@@ -244,16 +376,13 @@ static int yaml_parser_register_anchor(yaml_parser_t* parser, int index,
     data.index = index;
     data.mark = parser->document->nodes.start[index - 1].start_mark;
 
-    for (alias_data = parser->aliases.start; alias_data != parser->aliases.top;
-         alias_data++)
+    alias_data = yaml_parser_find_anchor(parser, anchor);
+    if (alias_data)
     {
-        if (strcmp((char*)alias_data->anchor, (char*)anchor) == 0)
-        {
-            yaml_free(anchor);
-            return yaml_parser_set_composer_error_context(
-                parser, "found duplicate anchor; first occurence",
-                alias_data->mark, "second occurence", data.mark);
-        }
+        yaml_free(anchor);
+        return yaml_parser_set_composer_error_context(
+            parser, "found duplicate anchor; first occurence",
+            alias_data->mark, "second occurence", data.mark);
     }
 
     if (!PUSH(parser, parser->aliases, data))
@@ -262,7 +391,8 @@ static int yaml_parser_register_anchor(yaml_parser_t* parser, int index,
         return 0;
     }
 
-    return 1;
+    return yaml_parser_index_anchor(
+        parser, (int)(parser->aliases.top - parser->aliases.start) - 1);
 }
 
 /*
@@ -273,19 +403,12 @@ static int yaml_parser_load_alias(yaml_parser_t* parser,
                                   yaml_event_t* first_event)
 {
     yaml_char_t* anchor = first_event->data.alias.anchor;
-    yaml_alias_data_t* alias_data;
-
-    for (alias_data = parser->aliases.start; alias_data != parser->aliases.top;
-         alias_data++)
-    {
-        if (strcmp((char*)alias_data->anchor, (char*)anchor) == 0)
-        {
-            yaml_free(anchor);
-            return alias_data->index;
-        }
-    }
+    yaml_alias_data_t* alias_data = yaml_parser_find_anchor(parser, anchor);
 
     yaml_free(anchor);
+    if (alias_data)
+        return alias_data->index;
+
     return yaml_parser_set_composer_error(parser, "found undefined alias",
                                           first_event->start_mark);
 }
@@ -300,6 +423,7 @@ static int yaml_parser_load_scalar(yaml_parser_t* parser,
     yaml_node_t node;
     int index;
     yaml_char_t* tag = first_event->data.scalar.tag;
+    yaml_char_t* value;
 
     if (!STACK_LIMIT(parser, parser->document->nodes, INT_MAX - 1))
         goto error;
@@ -307,18 +431,30 @@ static int yaml_parser_load_scalar(yaml_parser_t* parser,
     if (!tag || strcmp((char*)tag, "!") == 0)
     {
         yaml_free(tag);
-        tag = yaml_strdup((yaml_char_t*)YAML_DEFAULT_SCALAR_TAG);
-        if (!tag)
-            goto error;
+        tag = yaml_parser_adopt_string(
+            parser, (yaml_char_t*)YAML_DEFAULT_SCALAR_TAG,
+            strlen(YAML_DEFAULT_SCALAR_TAG), 1);
+    }
+    else
+    {
+        tag = yaml_parser_adopt_string(parser, tag, strlen((char*)tag), 0);
     }
 
-    SCALAR_NODE_INIT(node, tag, first_event->data.scalar.value,
-                     first_event->data.scalar.length,
+    /* A borrowed value is copied: the document outlives the input string. */
+
+    value = yaml_parser_adopt_string(parser, first_event->data.scalar.value,
+                                     first_event->data.scalar.length,
+                                     first_event->data.scalar.view);
+    if (!tag || !value)
+        goto node_error;
+
+    SCALAR_NODE_INIT(node, tag, value, first_event->data.scalar.length,
                      first_event->data.scalar.style, first_event->start_mark,
                      first_event->end_mark);
 
-    if (!PUSH(parser, parser->document->nodes, node))
-        goto error;
+    if (!DOCUMENT_PUSH(parser, parser->document, parser->document->nodes,
+                       node))
+        goto node_error;
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -328,10 +464,17 @@ static int yaml_parser_load_scalar(yaml_parser_t* parser,
 
     return index;
 
+node_error:
+    yaml_document_free(parser->document, tag);
+    yaml_document_free(parser->document, value);
+    yaml_free(first_event->data.scalar.anchor);
+    return 0;
+
 error:
     yaml_free(tag);
     yaml_free(first_event->data.scalar.anchor);
-    yaml_free(first_event->data.scalar.value);
+    if (!first_event->data.scalar.view)
+        yaml_free(first_event->data.scalar.value);
     return 0;
 }
 
@@ -361,20 +504,28 @@ static int yaml_parser_load_sequence(yaml_parser_t* parser,
     if (!tag || strcmp((char*)tag, "!") == 0)
     {
         yaml_free(tag);
-        tag = yaml_strdup((yaml_char_t*)YAML_DEFAULT_SEQUENCE_TAG);
-        if (!tag)
-            goto error;
+        tag = yaml_parser_adopt_string(
+            parser, (yaml_char_t*)YAML_DEFAULT_SEQUENCE_TAG,
+            strlen(YAML_DEFAULT_SEQUENCE_TAG), 1);
+    }
+    else
+    {
+        tag = yaml_parser_adopt_string(parser, tag, strlen((char*)tag), 0);
     }
+    if (!tag)
+        goto node_error;
 
-    if (!STACK_INIT(parser, items, INITIAL_STACK_SIZE))
-        goto error;
+    if (!DOCUMENT_STACK_INIT(parser, parser->document, items,
+                             INITIAL_STACK_SIZE))
+        goto node_error;
 
     SEQUENCE_NODE_INIT(node, tag, items.start, items.end,
                        first_event->data.sequence_start.style,
                        first_event->start_mark, first_event->end_mark);
 
-    if (!PUSH(parser, parser->document->nodes, node))
-        goto error;
+    if (!DOCUMENT_PUSH(parser, parser->document, parser->document->nodes,
+                       node))
+        goto node_error;
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -395,9 +546,10 @@ static int yaml_parser_load_sequence(yaml_parser_t* parser,
         item_index = yaml_parser_load_node(parser, &event);
         if (!item_index)
             return 0;
-        if (!PUSH(parser,
-                  parser->document->nodes.start[index - 1].data.sequence.items,
-                  item_index))
+        if (!DOCUMENT_PUSH(
+                parser, parser->document,
+                parser->document->nodes.start[index - 1].data.sequence.items,
+                item_index))
             return 0;
         if (!yaml_parser_parse(parser, &event))
             return 0;
@@ -407,6 +559,12 @@ static int yaml_parser_load_sequence(yaml_parser_t* parser,
 
     return index;
 
+node_error:
+    DOCUMENT_STACK_DEL(parser->document, items);
+    yaml_document_free(parser->document, tag);
+    yaml_free(first_event->data.sequence_start.anchor);
+    return 0;
+
 error:
     yaml_free(tag);
     yaml_free(first_event->data.sequence_start.anchor);
@@ -440,20 +598,28 @@ static int yaml_parser_load_mapping(yaml_parser_t* parser,
     if (!tag || strcmp((char*)tag, "!") == 0)
     {
         yaml_free(tag);
-        tag = yaml_strdup((yaml_char_t*)YAML_DEFAULT_MAPPING_TAG);
-        if (!tag)
-            goto error;
+        tag = yaml_parser_adopt_string(
+            parser, (yaml_char_t*)YAML_DEFAULT_MAPPING_TAG,
+            strlen(YAML_DEFAULT_MAPPING_TAG), 1);
+    }
+    else
+    {
+        tag = yaml_parser_adopt_string(parser, tag, strlen((char*)tag), 0);
     }
+    if (!tag)
+        goto node_error;
 
-    if (!STACK_INIT(parser, pairs, INITIAL_STACK_SIZE))
-        goto error;
+    if (!DOCUMENT_STACK_INIT(parser, parser->document, pairs,
+                             INITIAL_STACK_SIZE))
+        goto node_error;
 
     MAPPING_NODE_INIT(node, tag, pairs.start, pairs.end,
                       first_event->data.mapping_start.style,
                       first_event->start_mark, first_event->end_mark);
 
-    if (!PUSH(parser, parser->document->nodes, node))
-        goto error;
+    if (!DOCUMENT_PUSH(parser, parser->document, parser->document->nodes,
+                       node))
+        goto node_error;
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -479,9 +645,10 @@ static int yaml_parser_load_mapping(yaml_parser_t* parser,
         pair.value = yaml_parser_load_node(parser, &event);
         if (!pair.value)
             return 0;
-        if (!PUSH(parser,
-                  parser->document->nodes.start[index - 1].data.mapping.pairs,
-                  pair))
+        if (!DOCUMENT_PUSH(
+                parser, parser->document,
+                parser->document->nodes.start[index - 1].data.mapping.pairs,
+                pair))
             return 0;
         if (!yaml_parser_parse(parser, &event))
             return 0;
@@ -491,6 +658,12 @@ static int yaml_parser_load_mapping(yaml_parser_t* parser,
 
     return index;
 
+node_error:
+    DOCUMENT_STACK_DEL(parser->document, pairs);
+    yaml_document_free(parser->document, tag);
+    yaml_free(first_event->data.mapping_start.anchor);
+    return 0;
+
 error:
     yaml_free(tag);
     yaml_free(first_event->data.mapping_start.anchor);
@@ -688,6 +688,7 @@ static int yaml_parser_parse_node(yaml_parser_t* parser, yaml_event_t* event,
                                   token->data.scalar.length, plain_implicit,
                                   quoted_implicit, token->data.scalar.style,
                                   start_mark, end_mark);
+                event->data.scalar.view = token->data.scalar.view;
                 SKIP_TOKEN(parser);
                 return 1;
             }
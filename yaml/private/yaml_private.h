@@ -35,6 +35,31 @@ yaml_free(void* ptr);
 YAML_DECLARE(yaml_char_t*)
 yaml_strdup(const yaml_char_t*);
 
+/*
+ * Document memory management.
+ */
+
+YAML_DECLARE(void*)
+yaml_document_malloc(yaml_document_t* document, size_t size);
+
+YAML_DECLARE(void)
+yaml_document_free(yaml_document_t* document, void* ptr);
+
+YAML_DECLARE(yaml_char_t*)
+yaml_document_strndup(yaml_document_t* document, const yaml_char_t* str,
+                      size_t length);
+
+YAML_DECLARE(int)
+yaml_document_stack_extend(yaml_document_t* document, void** start,
+                           void** top, void** end);
+
+/*
+ * Does the document use malloc() for its nodes?
+ */
+
+#define DOCUMENT_MALLOC(document) \
+    (!(document)->memory.malloc_handler && !(document)->memory.arena)
+
 /*
  * Reader: Ensure that the buffer contains at least `length` characters.
  */
@@ -439,6 +464,29 @@ yaml_queue_extend(void** start, void** head, void** tail, void** end);
 
 #define POP(context, stack) (*(--(stack).top))
 
+/*
+ * The stacks that belong to a document live in the document memory.
+ */
+
+#define DOCUMENT_STACK_INIT(context, document, stack, size)                    \
+    (((stack).start = yaml_document_malloc((document),                         \
+                                           (size) * sizeof(*(stack).start)))   \
+         ? ((stack).top = (stack).start, (stack).end = (stack).start + (size), \
+            1)                                                                 \
+         : ((context)->error = YAML_MEMORY_ERROR, 0))
+
+#define DOCUMENT_STACK_DEL(document, stack)         \
+    (yaml_document_free((document), (stack).start), \
+     (stack).start = (stack).top = (stack).end = 0)
+
+#define DOCUMENT_PUSH(context, document, stack, value)                       \
+    (((stack).top != (stack).end                                             \
+      || yaml_document_stack_extend((document), (void**)&(stack).start,      \
+                                    (void**)&(stack).top,                    \
+                                    (void**)&(stack).end))                   \
+         ? (*((stack).top++) = value, 1)                                     \
+         : ((context)->error = YAML_MEMORY_ERROR, 0))
+
 #define QUEUE_INIT(context, queue, size)                            \
     (((queue).start = yaml_malloc((size) * sizeof(*(queue).start))) \
          ? ((queue).head = (queue).tail = (queue).start,            \
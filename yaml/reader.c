@@ -1,6 +1,12 @@
 
 #include "yaml_private.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /*
  * Declarations.
  */
@@ -13,6 +19,9 @@ static int yaml_parser_update_raw_buffer(yaml_parser_t* parser);
 
 static int yaml_parser_determine_encoding(yaml_parser_t* parser);
 
+static size_t yaml_parser_plain_run(const unsigned char* pointer,
+                                    size_t size);
+
 YAML_DECLARE(int)
 yaml_parser_update_buffer(yaml_parser_t* parser, size_t length);
 
@@ -89,6 +98,70 @@ static int yaml_parser_determine_encoding(yaml_parser_t* parser)
     return 1;
 }
 
+/*
+ * Return the length of the leading run of octets that are printable ASCII
+ * characters, tabs or line breaks.  Such octets are valid UTF-8 and can be
+ * copied to the buffer as is.
+ */
+
+#define IS_PLAIN_OCTET(octet)                                                  \
+    (((octet) >= 0x20 && (octet) <= 0x7E) || (octet) == 0x09                   \
+     || (octet) == 0x0A || (octet) == 0x0D)
+
+static size_t yaml_parser_plain_run(const unsigned char* pointer, size_t size)
+{
+    size_t length = 0;
+
+#if defined(__SSE2__)
+    const __m128i below = _mm_set1_epi8(0x1F);
+    const __m128i above = _mm_set1_epi8(0x7F);
+    const __m128i tab = _mm_set1_epi8(0x09);
+    const __m128i lf = _mm_set1_epi8(0x0A);
+    const __m128i cr = _mm_set1_epi8(0x0D);
+
+    /* Octets above 0x7F are negative as signed chars and fail both tests. */
+
+    while (length + 16 <= size)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(pointer + length));
+        __m128i plain = _mm_and_si128(_mm_cmpgt_epi8(chunk, below),
+                                      _mm_cmplt_epi8(chunk, above));
+        plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, tab));
+        plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, lf));
+        plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, cr));
+        if (_mm_movemask_epi8(plain) != 0xFFFF)
+            break;
+        length += 16;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t below = vdupq_n_u8(0x1F);
+    const uint8x16_t above = vdupq_n_u8(0x7F);
+    const uint8x16_t tab = vdupq_n_u8(0x09);
+    const uint8x16_t lf = vdupq_n_u8(0x0A);
+    const uint8x16_t cr = vdupq_n_u8(0x0D);
+
+    while (length + 16 <= size)
+    {
+        uint8x16_t chunk = vld1q_u8(pointer + length);
+        uint8x16_t plain =
+            vandq_u8(vcgtq_u8(chunk, below), vcltq_u8(chunk, above));
+        plain = vorrq_u8(plain, vceqq_u8(chunk, tab));
+        plain = vorrq_u8(plain, vceqq_u8(chunk, lf));
+        plain = vorrq_u8(plain, vceqq_u8(chunk, cr));
+        if (vminvq_u8(plain) != 0xFF)
+            break;
+        length += 16;
+    }
+#endif
+
+    /* Finish the tail (and the first non-plain chunk) one octet at a time. */
+
+    while (length < size && IS_PLAIN_OCTET(pointer[length]))
+        length++;
+
+    return length;
+}
+
 /*
  * Update the raw buffer.
  */
@@ -213,6 +286,28 @@ yaml_parser_update_buffer(yaml_parser_t* parser, size_t length)
             size_t raw_unread =
                 parser->raw_buffer.last - parser->raw_buffer.pointer;
 
+            /*
+             * UTF-8 input is copied through in bulk as long as it consists
+             * of plain ASCII, which needs no decoding.
+             */
+
+            if (parser->encoding == YAML_UTF8_ENCODING)
+            {
+                size_t run = yaml_parser_plain_run(parser->raw_buffer.pointer,
+                                                   raw_unread);
+
+                if (run)
+                {
+                    memcpy(parser->buffer.last, parser->raw_buffer.pointer,
+                           run);
+                    parser->buffer.last += run;
+                    parser->raw_buffer.pointer += run;
+                    parser->offset += run;
+                    parser->unread += run;
+                    continue;
+                }
+            }
+
             /* Decode the next character. */
 
             switch (parser->encoding)
@@ -450,8 +545,15 @@ yaml_parser_update_buffer(yaml_parser_t* parser, size_t length)
 
             /* Finally put the character into the buffer. */
 
+            /* A validated UTF-8 sequence is already in canonical form. */
+            if (parser->encoding == YAML_UTF8_ENCODING)
+            {
+                memcpy(parser->buffer.last, parser->raw_buffer.pointer - width,
+                       width);
+                parser->buffer.last += width;
+            }
             /* 0000 0000-0000 007F -> 0xxxxxxx */
-            if (value <= 0x7F)
+            else if (value <= 0x7F)
             {
                 *(parser->buffer.last++) = value;
             }
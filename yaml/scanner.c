@@ -705,6 +705,8 @@ static int yaml_parser_scan_flow_scalar(yaml_parser_t* parser,
 static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
                                          yaml_token_t* token);
 
+static const unsigned char* yaml_parser_input_pointer(yaml_parser_t* parser);
+
 /*
  * Get the next token.
  */
@@ -3562,6 +3564,24 @@ error:
     return 0;
 }
 
+/*
+ * Return the position in the input string of the current buffer character.
+ * Valid for UTF-8 string input only, where the buffer holds the input octets
+ * unchanged (plus the terminating NUL at the end of the stream).
+ */
+
+static const unsigned char* yaml_parser_input_pointer(yaml_parser_t* parser)
+{
+    size_t offset =
+        parser->offset - (parser->buffer.last - parser->buffer.pointer);
+
+    if (parser->eof && parser->buffer.last != parser->buffer.start
+        && parser->buffer.last[-1] == '\0')
+        offset++;
+
+    return parser->input.string.start + offset;
+}
+
 /*
  * Scan a plain scalar.
  */
@@ -3578,7 +3598,16 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
     int leading_blanks = 0;
     int indent = parser->indent + 1;
 
-    if (!STRING_INIT(parser, string, INITIAL_STRING_SIZE))
+    /*
+     * In the view mode the scalar is not copied as long as it stays on one
+     * line: its characters are contiguous in the input string then.
+     */
+
+    int view = parser->scalar_views && parser->encoding == YAML_UTF8_ENCODING;
+    const unsigned char* view_start = NULL;
+    size_t view_length = 0;
+
+    if (!view && !STRING_INIT(parser, string, INITIAL_STRING_SIZE))
         goto error;
     if (!STRING_INIT(parser, leading_break, INITIAL_STRING_SIZE))
         goto error;
@@ -3589,6 +3618,11 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
 
     start_mark = end_mark = parser->mark;
 
+    if (view)
+    {
+        view_start = yaml_parser_input_pointer(parser);
+    }
+
     /* Consume the content of the plain scalar. */
 
     while (1)
@@ -3647,6 +3681,18 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
             {
                 if (leading_blanks)
                 {
+                    /* Folding needs a copy of the scalar. */
+
+                    if (view)
+                    {
+                        if (!STRING_INIT(parser, string,
+                                         view_length + INITIAL_STRING_SIZE))
+                            goto error;
+                        memcpy(string.pointer, view_start, view_length);
+                        string.pointer += view_length;
+                        view = 0;
+                    }
+
                     /* Do we need to fold line breaks? */
 
                     if (leading_break.start[0] == '\n')
@@ -3677,6 +3723,11 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
 
                     leading_blanks = 0;
                 }
+                else if (view)
+                {
+                    view_length += whitespaces.pointer - whitespaces.start;
+                    CLEAR(parser, whitespaces);
+                }
                 else
                 {
                     if (!JOIN(parser, string, whitespaces))
@@ -3687,7 +3738,12 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
 
             /* Copy the character. */
 
-            if (!READ(parser, string))
+            if (view)
+            {
+                view_length += WIDTH(parser->buffer);
+                SKIP(parser);
+            }
+            else if (!READ(parser, string))
                 goto error;
 
             end_mark = parser->mark;
@@ -3765,8 +3821,17 @@ static int yaml_parser_scan_plain_scalar(yaml_parser_t* parser,
 
     /* Create a token. */
 
-    SCALAR_TOKEN_INIT(*token, string.start, string.pointer - string.start,
-                      YAML_PLAIN_SCALAR_STYLE, start_mark, end_mark);
+    if (view)
+    {
+        SCALAR_TOKEN_INIT(*token, (yaml_char_t*)view_start, view_length,
+                          YAML_PLAIN_SCALAR_STYLE, start_mark, end_mark);
+        token->data.scalar.view = 1;
+    }
+    else
+    {
+        SCALAR_TOKEN_INIT(*token, string.start, string.pointer - string.start,
+                          YAML_PLAIN_SCALAR_STYLE, start_mark, end_mark);
+    }
 
     /* Note that we change the 'simple_key_allowed' flag. */
 
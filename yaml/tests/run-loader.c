@@ -2,19 +2,297 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #ifdef NDEBUG
 #undef NDEBUG
 #endif
 #include <assert.h>
 
+/*
+ * Build a sequence of `count` anchored scalars followed by an alias to each
+ * of them, in reverse order.
+ */
+
+static char* make_anchors_document(int count, size_t* length)
+{
+    char* buffer = malloc((size_t)count * 48 + 16);
+    char* p = buffer;
+    int k;
+
+    assert(buffer);
+    for (k = 0; k < count; k++)
+        p += sprintf(p, "- &shot%d value%d\n", k, k);
+    for (k = count - 1; k >= 0; k--)
+        p += sprintf(p, "- *shot%d\n", k);
+
+    *length = (size_t)(p - buffer);
+    return buffer;
+}
+
+static int load_string(const char* input, size_t length,
+                       yaml_document_t* document)
+{
+    yaml_parser_t parser;
+    int result;
+
+    assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, (const unsigned char*)input,
+                                 length);
+    result = yaml_parser_load(&parser, document);
+    yaml_parser_delete(&parser);
+
+    return result;
+}
+
+/*
+ * Check that aliases resolve to their anchors and that the load time grows
+ * linearly with the number of anchors.
+ */
+
+static void bench_anchors(void)
+{
+    int count;
+
+    printf("%8s %10s %12s\n", "anchors", "ms", "ns/anchor");
+
+    for (count = 2500; count <= 80000; count *= 2)
+    {
+        yaml_document_t document;
+        yaml_node_t* root;
+        size_t length;
+        char* input = make_anchors_document(count, &length);
+        clock_t start = clock();
+        double ms;
+        int k;
+
+        assert(load_string(input, length, &document));
+        ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+        root = yaml_document_get_root_node(&document);
+        assert(root && root->type == YAML_SEQUENCE_NODE);
+        assert(root->data.sequence.items.top - root->data.sequence.items.start
+               == 2 * count);
+        for (k = 0; k < count; k++)
+        {
+            assert(root->data.sequence.items.start[k]
+                   == root->data.sequence.items.start[2 * count - 1 - k]);
+        }
+
+        printf("%8d %10.2f %12.1f\n", count, ms, ms * 1e6 / count);
+
+        yaml_document_delete(&document);
+        free(input);
+    }
+}
+
+/*
+ * An allocator that counts the allocations of the document nodes.
+ */
+
+typedef struct
+{
+    size_t allocations;
+    size_t frees;
+} allocation_counts_t;
+
+static void* counting_malloc(void* data, size_t size)
+{
+    ((allocation_counts_t*)data)->allocations++;
+    return malloc(size);
+}
+
+static void counting_free(void* data, void* ptr)
+{
+    ((allocation_counts_t*)data)->frees++;
+    free(ptr);
+}
+
+enum
+{
+    MEMORY_MALLOC,
+    MEMORY_HANDLER,
+    MEMORY_ARENA
+};
+
+static const char* memory_names[] = {"malloc", "handler", "arena"};
+
+static int load_string_with(const char* input, size_t length,
+                            yaml_document_t* document, int memory,
+                            allocation_counts_t* counts)
+{
+    yaml_parser_t parser;
+    int result;
+
+    assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, (const unsigned char*)input,
+                                 length);
+    yaml_parser_set_scalar_views(&parser, 1);
+    if (memory != MEMORY_MALLOC)
+    {
+        yaml_parser_set_document_allocator(&parser, counting_malloc,
+                                           counting_free, counts);
+    }
+    yaml_parser_set_document_arena(&parser, memory == MEMORY_ARENA);
+    result = yaml_parser_load(&parser, document);
+    yaml_parser_delete(&parser);
+
+    return result;
+}
+
+typedef struct
+{
+    char buffer[4096];
+    size_t size;
+} output_t;
+
+static int write_output(void* data, unsigned char* buffer, size_t size)
+{
+    output_t* output = data;
+
+    assert(output->size + size < sizeof(output->buffer));
+    memcpy(output->buffer + output->size, buffer, size);
+    output->size += size;
+    output->buffer[output->size] = '\0';
+
+    return 1;
+}
+
+static void dump_document(yaml_document_t* document, output_t* output)
+{
+    yaml_emitter_t emitter;
+
+    output->size = 0;
+    assert(yaml_emitter_initialize(&emitter));
+    yaml_emitter_set_output(&emitter, write_output, output);
+    assert(yaml_emitter_open(&emitter));
+    assert(yaml_emitter_dump(&emitter, document));
+    assert(yaml_emitter_close(&emitter));
+    yaml_emitter_delete(&emitter);
+}
+
+/*
+ * Check that documents in their own memory load, grow and dump like the
+ * malloc() ones, and that they release every allocation.
+ */
+
+static void test_document_memory(void)
+{
+    const char* input = "%TAG !e! tag:example.com,2000:\n"
+                        "--- !e!root\n"
+                        "plain: &a value\n"
+                        "folded: first\n  second\n"
+                        "seq: [*a, 'quoted', !!int 3]\n"
+                        "map: {k: v}\n";
+    output_t expected;
+    int memory;
+
+    for (memory = MEMORY_MALLOC; memory <= MEMORY_ARENA; memory++)
+    {
+        yaml_document_t document;
+        allocation_counts_t counts = {0, 0};
+        output_t output;
+        int item, root;
+
+        assert(load_string_with(input, strlen(input), &document, memory,
+                                &counts));
+
+        root = 1;
+        item = yaml_document_add_scalar(&document, NULL,
+                                        (yaml_char_t*)"added", -1,
+                                        YAML_ANY_SCALAR_STYLE);
+        assert(item);
+        assert(yaml_document_append_mapping_pair(&document, root, item, item));
+
+        if (memory == MEMORY_MALLOC)
+        {
+            dump_document(&document, &expected);
+        }
+        else
+        {
+            dump_document(&document, &output);
+            if (strcmp(output.buffer, expected.buffer))
+            {
+                printf("%s dump:\n%s\nexpected:\n%s\n",
+                       memory_names[memory], output.buffer, expected.buffer);
+                assert(0);
+            }
+            assert(counts.allocations > 0);
+            assert(counts.allocations == counts.frees);
+        }
+    }
+}
+
+/*
+ * Report the load and delete throughput and the number of allocations made
+ * for the document nodes.
+ */
+
+static void bench_document_memory(void)
+{
+    char* input = malloc(200000 * 96 + 16);
+    char* p = input;
+    size_t length;
+    int memory, k;
+
+    assert(input);
+    for (k = 0; k < 200000; k++)
+    {
+        p += sprintf(p, "- {id: %d, name: record %d, tags: [a, b, c]}\n", k,
+                     k);
+    }
+    length = (size_t)(p - input);
+
+    printf("%8s %10s %10s %14s\n", "memory", "MB", "ms", "allocations");
+
+    for (memory = MEMORY_MALLOC; memory <= MEMORY_ARENA; memory++)
+    {
+        yaml_document_t document;
+        allocation_counts_t counts = {0, 0};
+        clock_t start = clock();
+        double ms;
+
+        assert(load_string_with(input, length, &document, memory, &counts));
+        yaml_document_delete(&document);
+        ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+        assert(counts.allocations == counts.frees);
+        if (memory == MEMORY_MALLOC)
+        {
+            printf("%8s %10.1f %10.1f %14s\n", memory_names[memory],
+                   length / 1e6, ms, "-");
+        }
+        else
+        {
+            printf("%8s %10.1f %10.1f %14lu\n", memory_names[memory],
+                   length / 1e6, ms, (unsigned long)counts.allocations);
+        }
+    }
+
+    free(input);
+}
+
+static void test_anchor_errors(void)
+{
+    yaml_document_t document;
+    const char* duplicate = "- &a 1\n- &b 2\n- &a 3\n";
+    const char* undefined = "- &a 1\n- *b\n";
+
+    assert(!load_string(duplicate, strlen(duplicate), &document));
+    assert(!load_string(undefined, strlen(undefined), &document));
+}
+
 int main(int argc, char* argv[])
 {
     int number;
 
     if (argc < 2)
     {
-        printf("Usage: %s file1.yaml ...\n", argv[0]);
+        test_anchor_errors();
+        test_document_memory();
+        bench_anchors();
+        bench_document_memory();
         return 0;
     }
 
@@ -2,19 +2,177 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #ifdef NDEBUG
 #undef NDEBUG
 #endif
 #include <assert.h>
 
+/*
+ * Parse `input` and return the concatenation of its scalar values, each one
+ * followed by '|'.  The caller frees the result.
+ */
+
+static char* parse_scalars(const char* input, size_t length, int views,
+                           int* view_count)
+{
+    yaml_parser_t parser;
+    yaml_event_t event;
+    size_t size = length * 2 + 16;
+    char* result = malloc(size);
+    size_t used = 0;
+    int done = 0;
+
+    assert(result);
+    *view_count = 0;
+
+    assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, (const unsigned char*)input,
+                                 length);
+    yaml_parser_set_scalar_views(&parser, views);
+
+    while (!done)
+    {
+        assert(yaml_parser_parse(&parser, &event));
+
+        if (event.type == YAML_SCALAR_EVENT)
+        {
+            assert(used + event.data.scalar.length + 1 < size);
+            memcpy(result + used, event.data.scalar.value,
+                   event.data.scalar.length);
+            used += event.data.scalar.length;
+            result[used++] = '|';
+            *view_count += event.data.scalar.view;
+        }
+
+        done = (event.type == YAML_STREAM_END_EVENT);
+        yaml_event_delete(&event);
+    }
+
+    yaml_parser_delete(&parser);
+    result[used] = '\0';
+
+    return result;
+}
+
+/*
+ * Check that scalar views carry the same values as copied scalars.
+ */
+
+static void test_scalar_views(void)
+{
+    const char* inputs[] = {
+        "plain\n",
+        "key: value with  inner   spaces   \n"
+        "folded: first line\n  second line\n\n  third\n",
+        "\xef\xbb\xbf- caf\xc3\xa9 \xe2\x82\xac\n- \xf0\x9f\x98\x80 x\n",
+        "{a: b, c d: [e f, g]}\n",
+        "- crlf line\r\n- next\r\n  fold\r\n",
+        "'quoted': \"double\\tx\"\n? |\n  block\n: end # comment\n",
+        "--- doc one\n--- doc two\n...\n",
+        "no newline at end",
+    };
+    size_t k;
+
+    for (k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++)
+    {
+        size_t length = strlen(inputs[k]);
+        int copied_views, views;
+        char* copied = parse_scalars(inputs[k], length, 0, &copied_views);
+        char* viewed = parse_scalars(inputs[k], length, 1, &views);
+
+        assert(!copied_views);
+        assert(views > 0);
+        if (strcmp(copied, viewed))
+        {
+            printf("view mismatch: '%s' != '%s'\n", viewed, copied);
+            assert(0);
+        }
+
+        free(copied);
+        free(viewed);
+    }
+}
+
+/*
+ * Build a document of `count` small mappings with plain, quoted and folded
+ * scalars.
+ */
+
+static char* make_records_document(int count, size_t* length)
+{
+    char* buffer = malloc((size_t)count * 160 + 16);
+    char* p = buffer;
+    int k;
+
+    assert(buffer);
+    for (k = 0; k < count; k++)
+    {
+        p += sprintf(p,
+                     "- id: %d\n"
+                     "  name: record number %d\n"
+                     "  tags: [alpha, beta, gamma]\n"
+                     "  note: \"quoted \\u00e9\"\n"
+                     "  text: caf\xc3\xa9 line\n    continued\n",
+                     k, k);
+    }
+
+    *length = (size_t)(p - buffer);
+    return buffer;
+}
+
+/*
+ * Report the event throughput in copy and in view mode.
+ */
+
+static void bench_parse(void)
+{
+    size_t length;
+    char* input = make_records_document(200000, &length);
+    int views;
+
+    printf("%8s %10s %10s %10s\n", "mode", "MB", "ms", "MB/s");
+
+    for (views = 0; views <= 1; views++)
+    {
+        yaml_parser_t parser;
+        yaml_event_t event;
+        clock_t start = clock();
+        double ms;
+        int done = 0;
+
+        assert(yaml_parser_initialize(&parser));
+        yaml_parser_set_input_string(&parser, (const unsigned char*)input,
+                                     length);
+        yaml_parser_set_scalar_views(&parser, views);
+
+        while (!done)
+        {
+            assert(yaml_parser_parse(&parser, &event));
+            done = (event.type == YAML_STREAM_END_EVENT);
+            yaml_event_delete(&event);
+        }
+
+        yaml_parser_delete(&parser);
+        ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+        printf("%8s %10.1f %10.1f %10.1f\n", views ? "view" : "copy",
+               length / 1e6, ms, length / 1e3 / ms);
+    }
+
+    free(input);
+}
+
 int main(int argc, char* argv[])
 {
     int number;
 
     if (argc < 2)
     {
-        printf("Usage: %s file1.yaml ...\n", argv[0]);
+        test_scalar_views();
+        bench_parse();
         return 0;
     }
 
@@ -324,6 +324,8 @@ extern "C"
                 size_t length;
                 /** The scalar style. */
                 yaml_scalar_style_t style;
+                /** Does the value point into the input string? */
+                int view;
             } scalar;
 
             /** The version directive (for @c YAML_VERSION_DIRECTIVE_TOKEN). */
@@ -469,6 +471,11 @@ extern "C"
                 int quoted_implicit;
                 /** The scalar style. */
                 yaml_scalar_style_t style;
+                /**
+                 * Does the value point into the input string?  Such a value
+                 * is not NUL-terminated and is not freed with the event.
+                 */
+                int view;
             } scalar;
 
             /** The sequence parameters (for @c YAML_SEQUENCE_START_EVENT). */
@@ -816,6 +823,45 @@ extern "C"
         yaml_mark_t end_mark;
     };
 
+    /**
+     * The prototype of a memory allocation handler.
+     *
+     * @param[in,out]   data        A pointer to an application data specified
+     * by yaml_parser_set_document_allocator().
+     * @param[in]       size        The number of bytes to allocate.
+     *
+     * @returns A block of at least @a size bytes suitably aligned for any
+     * type, or @c NULL on failure.
+     */
+
+    typedef void* yaml_malloc_handler_t(void* data, size_t size);
+
+    /**
+     * The prototype of a memory deallocation handler.
+     *
+     * @param[in,out]   data        A pointer to an application data specified
+     * by yaml_parser_set_document_allocator().
+     * @param[in]       ptr         A block returned by the allocation handler.
+     */
+
+    typedef void yaml_free_handler_t(void* data, void* ptr);
+
+    /** The memory of the document nodes. */
+    typedef struct yaml_document_memory_s
+    {
+        /** The allocation handler or @c NULL to use malloc(). */
+        yaml_malloc_handler_t* malloc_handler;
+        /** The deallocation handler. */
+        yaml_free_handler_t* free_handler;
+        /** A pointer for the handlers. */
+        void* data;
+
+        /** Are the nodes allocated from an arena? */
+        int arena;
+        /** The arena blocks, the most recent first. */
+        struct yaml_arena_block_s* blocks;
+    } yaml_document_memory_t;
+
     /** The document structure. */
     typedef struct yaml_document_s
     {
@@ -853,6 +899,12 @@ extern "C"
         /** The end of the document. */
         yaml_mark_t end_mark;
 
+        /**
+         * The memory of the node tags, values, items and pairs, and of the
+         * nodes stack.
+         */
+        yaml_document_memory_t memory;
+
     } yaml_document_t;
 
     /**
@@ -1245,6 +1297,9 @@ extern "C"
         /** The number of unclosed '[' and '{' indicators. */
         int flow_level;
 
+        /** Are plain scalars returned as views into the input string? */
+        int scalar_views;
+
         /** The tokens queue. */
         struct
         {
@@ -1357,9 +1412,21 @@ extern "C"
             yaml_alias_data_t* top;
         } aliases;
 
+        /** The hash index of the alias data by anchor. */
+        struct
+        {
+            /** The slots (alias data position + 1, or 0 if free). */
+            int* slots;
+            /** The number of slots (a power of two). */
+            size_t size;
+        } anchors;
+
         /** The currently parsed document. */
         yaml_document_t* document;
 
+        /** The memory settings of the loaded documents. */
+        yaml_document_memory_t document_memory;
+
         /**
          * @}
          */
@@ -1441,6 +1508,26 @@ extern "C"
     YAML_DECLARE(void)
     yaml_parser_set_encoding(yaml_parser_t* parser, yaml_encoding_t encoding);
 
+    /**
+     * Return plain scalars as views into the input string.
+     *
+     * When enabled, the value of a single-line plain scalar is not copied:
+     * the token or event points at the scalar in the input string, and its
+     * @c view flag is set.  Such values are not NUL-terminated, stay valid for
+     * as long as the input string does, and are not freed by
+     * yaml_token_delete() or yaml_event_delete().  Other scalars, and all
+     * scalars of a UTF-16 input, are copied as usual.  Documents built by
+     * yaml_parser_load() always own their values.
+     *
+     * Must be called after yaml_parser_set_input_string().
+     *
+     * @param[in,out]   parser      A parser object.
+     * @param[in]       enable      Non-zero to enable the views.
+     */
+
+    YAML_DECLARE(void)
+    yaml_parser_set_scalar_views(yaml_parser_t* parser, int enable);
+
     /**
      * Scan the input stream and produce the next token.
      *
@@ -1514,6 +1601,42 @@ extern "C"
     YAML_DECLARE(int)
     yaml_parser_load(yaml_parser_t* parser, yaml_document_t* document);
 
+    /**
+     * Set the allocator of the documents produced by yaml_parser_load().
+     *
+     * The node tags, scalar values, sequence items, mapping pairs and the
+     * nodes stack of every loaded document are allocated with @a
+     * malloc_handler and released with @a free_handler by
+     * yaml_document_delete().  A @c NULL @a free_handler leaves the release to
+     * the application.  Pass @c NULL handlers to restore malloc().
+     *
+     * @param[in,out]   parser          A parser object.
+     * @param[in]       malloc_handler  An allocation handler or @c NULL.
+     * @param[in]       free_handler    A deallocation handler or @c NULL.
+     * @param[in]       data            Any application data for passing to
+     *                                  the handlers.
+     */
+
+    YAML_DECLARE(void)
+    yaml_parser_set_document_allocator(yaml_parser_t* parser,
+                                       yaml_malloc_handler_t* malloc_handler,
+                                       yaml_free_handler_t* free_handler,
+                                       void* data);
+
+    /**
+     * Allocate the nodes of the loaded documents from an arena.
+     *
+     * In the arena mode the memory of a document is carved from a few large
+     * blocks, obtained from the document allocator, and yaml_document_delete()
+     * releases the blocks at once instead of freeing every node.
+     *
+     * @param[in,out]   parser      A parser object.
+     * @param[in]       enable      Non-zero to enable the arena mode.
+     */
+
+    YAML_DECLARE(void)
+    yaml_parser_set_document_arena(yaml_parser_t* parser, int enable);
+
     /** @} */
 
     /**